@@ -19,6 +19,7 @@
  */
 
 #include <assert.h>
+#include <atomic>
 #include <boost/filesystem/convenience.hpp>
 #include <boost/program_options.hpp>
 #include <iostream>
@@ -28,6 +29,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <string>
+#include <thread>
 #include <vector>
 
 enum TokenType : int8_t
@@ -257,7 +259,9 @@ int main(int argc, char **argv)
     streams.back().tokenComments.swap(stringStream.tokenComments);
 
     int cursor = 0;
+    std::vector<int> streamStarts;
     for (auto &s : streams) {
+        streamStarts.push_back(cursor);
         for (int i = 0; i < int(s.tokenTypes.size()); i++) {
             switch (s.tokenTypes[i]) {
             case TOK_LABEL:
@@ -290,8 +294,10 @@ int main(int argc, char **argv)
 
     std::vector<uint8_t> data(cursor);
 
-    cursor = 0;
-    for (auto &s : streams) {
+    // With label positions and per-stream start offsets resolved, each
+    // stream's byte emission (including relative ref fixups) only touches its
+    // own slice of the output, so streams can be encoded in parallel
+    auto emitStream = [&](const Stream &s, int cursor) {
         if (debug)
             printf("-- %s --\n", s.name.c_str());
 
@@ -401,10 +407,34 @@ int main(int argc, char **argv)
                 }
             }
         }
+        return cursor;
+    };
+
+    // Debug mode keeps the serial order so the trace prints stay readable
+    unsigned numThreads = debug ? 1u : unsigned(std::min<size_t>(std::thread::hardware_concurrency(), streams.size()));
+    if (numThreads > 1) {
+        std::atomic<size_t> nextStream(0);
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < numThreads; t++)
+            workers.emplace_back([&]() {
+                while (true) {
+                    size_t idx = nextStream.fetch_add(1);
+                    if (idx >= streams.size())
+                        break;
+                    int end = emitStream(streams[idx], streamStarts[idx]);
+                    assert(end == (idx + 1 < streams.size() ? streamStarts[idx + 1] : int(data.size())));
+                    (void)end;
+                }
+            });
+        for (auto &w : workers)
+            w.join();
+    } else {
+        cursor = 0;
+        for (auto &s : streams)
+            cursor = emitStream(s, cursor);
+        assert(cursor == int(data.size()));
     }
 
-    assert(cursor == int(data.size()));
-
     if (writeC) {
         for (auto &s : preText)
             fprintf(fileOut, "%s\n", s.c_str());
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+# Regression benchmark harness for nextpnr.
+#
+# Generalises ice40/picorv32_benchmark.py to a corpus of synthesized netlists
+# described by a JSON manifest (benchmarks.json by default). Each benchmark is
+# run for a number of seeds against the nextpnr binary for its arch, and the
+# per-run JSON report (--report) is mined for achieved Fmax, per-pass runtime
+# and peak RSS. Aggregated results (seed spread, per-pass means) are written
+# as JSON for trend tracking.
+#
+# Typically invoked via the `benchmark` CMake target, which points --bindir at
+# the build directory; netlists are synthesized on first use with yosys if a
+# synth recipe is given in the manifest.
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import threading
+import time
+from os import path
+
+npnr_dir = path.dirname(path.dirname(path.abspath(__file__)))
+
+
+def synth_netlist(bench, netlist, workdir):
+    synth = bench["synth"]
+    sources = []
+    for src in synth["sources"]:
+        src = src.replace("${NPNR}", npnr_dir)
+        if src.startswith("http://") or src.startswith("https://"):
+            local = path.join(workdir, path.basename(src))
+            if not path.exists(local):
+                subprocess.run(["wget", "-O", local, src], check=True)
+            src = local
+        sources.append(src)
+    script = "{} -json {} -top {}".format(synth["yosys_synth"], netlist, synth["top"])
+    subprocess.run(["yosys", "-q", "-p", script] + sources, check=True)
+
+
+def run_seed(binary, bench, netlist, workdir, seed, results):
+    report = path.join(workdir, "{}_s{}_report.json".format(bench["name"], seed))
+    if path.exists(report):
+        os.remove(report)
+    cmd = [binary] + bench["args"] + ["--seed", str(seed), "--json", netlist, "--report", report]
+    start = time.monotonic()
+    result = subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    wall = time.monotonic() - start
+    if result.returncode != 0 or not path.exists(report):
+        print("{}: seed {} failed!".format(bench["name"], seed))
+        return
+    with open(report) as f:
+        rep = json.load(f)
+    run = {"seed": seed, "wall_s": wall}
+    if "fmax" in rep and len(rep["fmax"]) > 0:
+        # The QoR scalar is the worst achieved Fmax over all clock domains
+        run["fmax"] = min(clk["achieved"] for clk in rep["fmax"].values())
+    if "profile" in rep:
+        run["passes"] = {p["pass"]: p["seconds"] for p in rep["profile"]}
+        run["peak_rss_kib"] = max(p["peak_rss_kib"] for p in rep["profile"])
+    results[seed] = run
+
+
+def spread(values):
+    return {
+        "min": min(values),
+        "max": max(values),
+        "mean": statistics.mean(values),
+        "stdev": statistics.stdev(values) if len(values) > 1 else 0,
+    }
+
+
+def run_benchmark(bench, args):
+    binary = path.join(args.bindir, "nextpnr-{}".format(bench["arch"]))
+    if not path.exists(binary):
+        print("{}: skipped, {} not built".format(bench["name"], binary))
+        return None
+    netlist = path.join(args.workdir, bench["netlist"])
+    if not path.exists(netlist):
+        synth_netlist(bench, netlist, args.workdir)
+
+    results = {}
+    threads = []
+    for seed in range(1, args.seeds + 1):
+        t = threading.Thread(target=run_seed, args=(binary, bench, netlist, args.workdir, seed, results))
+        threads.append(t)
+        if not args.parallel:
+            t.start()
+            t.join()
+    if args.parallel:
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+    entry = {
+        "arch": bench["arch"],
+        "seeds_passed": len(results),
+        "seeds_total": args.seeds,
+        "runs": [results[s] for s in sorted(results.keys())],
+    }
+    if len(results) > 0:
+        entry["wall_s"] = spread([r["wall_s"] for r in results.values()])
+        fmax = [r["fmax"] for r in results.values() if "fmax" in r]
+        if len(fmax) > 0:
+            entry["fmax"] = spread(fmax)
+        pass_names = set()
+        for r in results.values():
+            pass_names |= set(r.get("passes", {}).keys())
+        if len(pass_names) > 0:
+            entry["passes"] = {
+                p: spread([r["passes"][p] for r in results.values() if p in r.get("passes", {})])
+                for p in sorted(pass_names)
+            }
+        rss = [r["peak_rss_kib"] for r in results.values() if "peak_rss_kib" in r]
+        if len(rss) > 0:
+            entry["peak_rss_kib"] = max(rss)
+    return entry
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--bindir", default=os.getcwd(), help="directory containing the nextpnr binaries")
+    parser.add_argument("--corpus", default=path.join(npnr_dir, "bench", "benchmarks.json"), help="benchmark manifest")
+    parser.add_argument("--workdir", default="benchmark_work", help="directory for netlists and reports")
+    parser.add_argument("--out", default="benchmark_results.json", help="output JSON file")
+    parser.add_argument("--seeds", type=int, default=None, help="seeds per benchmark (overrides manifest)")
+    parser.add_argument("--only", default=None, help="comma-separated list of benchmark names to run")
+    parser.add_argument("--serial", dest="parallel", action="store_false", help="run seeds one at a time")
+    args = parser.parse_args()
+
+    with open(args.corpus) as f:
+        corpus = json.load(f)
+    if args.seeds is None:
+        args.seeds = corpus.get("seeds", 8)
+    if not path.exists(args.workdir):
+        os.makedirs(args.workdir)
+
+    only = args.only.split(",") if args.only is not None else None
+    output = {"date": time.strftime("%Y-%m-%dT%H:%M:%S"), "benchmarks": {}}
+    failed = False
+    for bench in corpus["benchmarks"]:
+        if only is not None and bench["name"] not in only:
+            continue
+        entry = run_benchmark(bench, args)
+        if entry is None:
+            continue
+        output["benchmarks"][bench["name"]] = entry
+        if entry["seeds_passed"] < entry["seeds_total"]:
+            failed = True
+        if "fmax" in entry:
+            print("{}: {}/{} seeds, fmax min = {:.2f} MHz, mean = {:.2f} MHz, max = {:.2f} MHz".format(
+                bench["name"], entry["seeds_passed"], entry["seeds_total"], entry["fmax"]["min"],
+                entry["fmax"]["mean"], entry["fmax"]["max"]))
+        else:
+            print("{}: {}/{} seeds".format(bench["name"], entry["seeds_passed"], entry["seeds_total"]))
+
+    with open(args.out, "w") as f:
+        json.dump(output, f, indent=4, sort_keys=True)
+        f.write("\n")
+    print("results written to {}".format(args.out))
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
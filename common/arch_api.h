@@ -32,9 +32,46 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
+// Batched downhill pip info for router hot loops: one virtual call fills
+// pip, destination wire, delay and location for every downhill pip of a
+// wire, so the expansion loop iterates a contiguous array instead of making
+// several virtual calls per pip
+struct PipDownhillInfo
+{
+    PipId pip;
+    WireId dst;
+    DelayQuad delay;
+    Loc loc;
+    // True when the arch's net-independent dynamic pip rules (e.g. ECP5 LUT
+    // permutation restrictions) currently forbid this pip for every net, so
+    // the router can skip it without a further arch query. False makes no
+    // claim; net-dependent availability still goes through
+    // checkPipAvailForNet
+    bool blocked = false;
+};
+
 // The specification of the Arch API (pure virtual)
 template <typename R> struct ArchAPI : BaseCtx
 {
+    // Compile-time capability flags. Each binary builds common pass code
+    // against exactly one concrete Arch, so a plain 'if' keyed on these is
+    // constant-folded away when an arch leaves a flag at its default here
+    // (both branches must stay well-formed for every arch - this is C++14,
+    // no 'if constexpr'); an arch advertises a capability (or opts out of a
+    // behaviour) by shadowing the flag in its own struct. Prefer these over
+    // #ifdef ARCH_* in common code, so the dependency is visible at the
+    // arch definition.
+
+    // Global nets (NetInfo::is_global) carry dedicated routing that the
+    // general routers, timing walks and routed-design checks must skip
+    static constexpr bool capGlobalsRoutedSeparately = false;
+    // Growing the bounding box of repeatedly-failing nets helps resolve
+    // congestion; arches where it is counterproductive opt out
+    static constexpr bool capExpandBBOnRouteFail = true;
+    // getPipName/getPipByName round-trip for every pip, so archcheck can
+    // verify them
+    static constexpr bool capPipNameRoundtrip = true;
+
     // Basic config
     virtual IdString archId() const = 0;
     virtual std::string getChipName() const = 0;
@@ -73,6 +110,7 @@ template <typename R> struct ArchAPI : BaseCtx
     virtual IdString getWireType(WireId wire) const = 0;
     virtual typename R::WireAttrsRangeT getWireAttrs(WireId) const = 0;
     virtual typename R::DownhillPipRangeT getPipsDownhill(WireId wire) const = 0;
+    virtual void getPipsDownhillInfo(WireId wire, std::vector<PipDownhillInfo> &out) const = 0;
     virtual typename R::UphillPipRangeT getPipsUphill(WireId wire) const = 0;
     virtual typename R::WireBelPinRangeT getWireBelPins(WireId wire) const = 0;
     virtual uint32_t getWireChecksum(WireId wire) const = 0;
@@ -91,6 +129,9 @@ template <typename R> struct ArchAPI : BaseCtx
     virtual typename R::PipAttrsRangeT getPipAttrs(PipId) const = 0;
     virtual uint32_t getPipChecksum(PipId pip) const = 0;
     virtual void bindPip(PipId pip, NetInfo *net, PlaceStrength strength) = 0;
+    // Commit a whole routed arc in one call, amortising the per-pip virtual
+    // dispatch and reserving the net's wire map once up front
+    virtual void bindPips(const std::vector<PipId> &pips, NetInfo *net, PlaceStrength strength) = 0;
     virtual void unbindPip(PipId pip) = 0;
     virtual bool checkPipAvail(PipId pip) const = 0;
     virtual bool checkPipAvailForNet(PipId pip, NetInfo *net) const = 0;
@@ -136,6 +177,12 @@ template <typename R> struct ArchAPI : BaseCtx
     virtual BelBucketId getBelBucketForBel(BelId bel) const = 0;
     virtual BelBucketId getBelBucketForCellType(IdString cell_type) const = 0;
     virtual bool isBelLocationValid(BelId bel) const = 0;
+    // Probe whether moving 'cell' (currently bound at oldBel) onto newBel,
+    // with 'other_cell' (the current occupant of newBel, may be null) moving
+    // onto oldBel in exchange, would leave both locations valid. Must leave
+    // all bind state exactly as it found it; archs with structural checks
+    // can answer without mutating anything, so rejected placer moves are free
+    virtual bool isSwapLocationValid(CellInfo *cell, BelId newBel, CellInfo *other_cell, BelId oldBel) = 0;
     virtual typename R::CellTypeRangeT getCellTypes() const = 0;
     virtual typename R::BelBucketRangeT getBelBuckets() const = 0;
     virtual typename R::BucketBelRangeT getBelsInBucket(BelBucketId bucket) const = 0;
@@ -151,6 +198,10 @@ template <typename R> struct ArchAPI : BaseCtx
     virtual bool place() = 0;
     virtual bool route() = 0;
     virtual void assignArchInfo() = 0;
+    // Re-applies any netlist rewiring place() performs after the placer
+    // proper (e.g. timing-driven LUT input permutation), for flows that
+    // restore a saved placement without running place() again
+    virtual void postPlaceFixup() = 0;
 };
 
 NEXTPNR_NAMESPACE_END
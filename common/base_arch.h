@@ -155,6 +155,7 @@ template <typename R> struct BaseArch : ArchAPI<R>
         auto &entry = base_bel2cell[bel];
         NPNR_ASSERT(entry == nullptr);
         cell->bel = bel;
+        cell->loc = this->getBelLocation(bel);
         cell->belStrength = strength;
         entry = cell;
         this->refreshUiBel(bel);
@@ -205,6 +206,7 @@ template <typename R> struct BaseArch : ArchAPI<R>
         NPNR_ASSERT(w2n_entry == nullptr);
         net->wires[wire].pip = PipId();
         net->wires[wire].strength = strength;
+        ++net->route_version;
         w2n_entry = net;
         this->refreshUiWire(wire);
     }
@@ -224,6 +226,7 @@ template <typename R> struct BaseArch : ArchAPI<R>
         }
 
         net_wires.erase(it);
+        ++w2n_entry->route_version;
         base_wire2net[wire] = nullptr;
 
         w2n_entry = nullptr;
@@ -258,6 +261,16 @@ template <typename R> struct BaseArch : ArchAPI<R>
         w2n_entry = net;
         net->wires[dst].pip = pip;
         net->wires[dst].strength = strength;
+        ++net->route_version;
+    }
+    virtual void bindPips(const std::vector<PipId> &pips, NetInfo *net, PlaceStrength strength) override
+    {
+        // Applied through the bindPip virtual so arch-specific bookkeeping
+        // (switch locking, fanout counts, ...) is preserved; archs where
+        // that bookkeeping is cheap can override this with an inline loop
+        net->wires.reserve(net->wires.size() + pips.size());
+        for (auto pip : pips)
+            this->bindPip(pip, net, strength);
     }
     virtual void unbindPip(PipId pip) override
     {
@@ -271,6 +284,7 @@ template <typename R> struct BaseArch : ArchAPI<R>
         w2n_entry = nullptr;
 
         p2n_entry->wires.erase(dst);
+        ++p2n_entry->route_version;
         p2n_entry = nullptr;
     }
     virtual bool checkPipAvail(PipId pip) const override { return getBoundPipNet(pip) == nullptr; }
@@ -286,6 +300,21 @@ template <typename R> struct BaseArch : ArchAPI<R>
     }
     virtual WireId getConflictingPipWire(PipId pip) const override { return WireId(); }
     virtual NetInfo *getConflictingPipNet(PipId pip) const override { return getBoundPipNet(pip); }
+    virtual void getPipsDownhillInfo(WireId wire, std::vector<PipDownhillInfo> &out) const override
+    {
+        // Generic fallback assembled from the per-pip accessors; archs where
+        // this data comes straight from chipdb arrays should override it
+        // with a direct loop to avoid the per-pip virtual dispatch
+        out.clear();
+        for (auto pip : this->getPipsDownhill(wire)) {
+            PipDownhillInfo info;
+            info.pip = pip;
+            info.dst = this->getPipDstWire(pip);
+            info.delay = this->getPipDelay(pip);
+            info.loc = this->getPipLocation(pip);
+            out.push_back(info);
+        }
+    }
 
     // Group methods
     virtual GroupId getGroupByName(IdStringList name) const override { return GroupId(); };
@@ -358,6 +387,28 @@ template <typename R> struct BaseArch : ArchAPI<R>
         return getBelBucketByName(cell_type);
     };
     virtual bool isBelLocationValid(BelId bel) const override { return true; }
+    virtual bool isSwapLocationValid(CellInfo *cell, BelId newBel, CellInfo *other_cell, BelId oldBel) override
+    {
+        // Generic fallback: apply the swap, query both locations, revert.
+        // Archs whose validity rules are cheap structural checks should
+        // override this with a mutation-free probe
+        PlaceStrength cell_str = cell->belStrength;
+        PlaceStrength other_str = (other_cell != nullptr) ? other_cell->belStrength : STRENGTH_WEAK;
+        this->unbindBel(oldBel);
+        if (other_cell != nullptr)
+            this->unbindBel(newBel);
+        this->bindBel(newBel, cell, cell_str);
+        if (other_cell != nullptr)
+            this->bindBel(oldBel, other_cell, other_str);
+        bool valid = this->isBelLocationValid(newBel) && this->isBelLocationValid(oldBel);
+        this->unbindBel(newBel);
+        if (other_cell != nullptr)
+            this->unbindBel(oldBel);
+        this->bindBel(oldBel, cell, cell_str);
+        if (other_cell != nullptr)
+            this->bindBel(newBel, other_cell, other_str);
+        return valid;
+    }
     virtual typename R::CellTypeRangeT getCellTypes() const override
     {
         NPNR_ASSERT(cell_types_initialised);
@@ -438,6 +489,7 @@ template <typename R> struct BaseArch : ArchAPI<R>
 
     // Flow methods
     virtual void assignArchInfo() override{};
+    virtual void postPlaceFixup() override{};
 
     // --------------------------------------------------------------
     // These structures are used to provide default implementations of bel/wire/pip binding. Arches might want to
@@ -207,6 +207,26 @@ void BaseCtx::attributesToArchInfo()
     getCtx()->assignArchInfo();
 }
 
+void BaseCtx::refreshNetUdata()
+{
+    net_by_udata.clear();
+    net_by_udata.reserve(nets.size());
+    for (auto &net : nets) {
+        net.second->udata = int32_t(net_by_udata.size());
+        net_by_udata.push_back(net.second.get());
+    }
+}
+
+void BaseCtx::refreshCellUdata()
+{
+    cell_by_udata.clear();
+    cell_by_udata.reserve(cells.size());
+    for (auto &cell : cells) {
+        cell.second->udata = int32_t(cell_by_udata.size());
+        cell_by_udata.push_back(cell.second.get());
+    }
+}
+
 NetInfo *BaseCtx::createNet(IdString name)
 {
     NPNR_ASSERT(!nets.count(name));
@@ -257,10 +277,62 @@ CellInfo *BaseCtx::createCell(IdString name, IdString type)
     cell->type = type;
     CellInfo *ptr = cell.get();
     cells[name] = std::move(cell);
+    if (cell_type_index_valid)
+        cell_type_index[type].insert(name);
     refreshUi();
     return ptr;
 }
 
+std::vector<CellInfo *> BaseCtx::cellsOfType(IdString type)
+{
+    if (!cell_type_index_valid) {
+        cell_type_index.clear();
+        for (auto &cell : cells)
+            cell_type_index[cell.second->type].insert(cell.first);
+        cell_type_index_valid = true;
+    }
+    std::vector<CellInfo *> result;
+    auto fnd = cell_type_index.find(type);
+    if (fnd == cell_type_index.end())
+        return result;
+    result.reserve(fnd->second.size());
+    for (IdString name : fnd->second) {
+        auto fnd_cell = cells.find(name);
+        // Skip cells erased or retyped since they were indexed
+        if (fnd_cell == cells.end() || fnd_cell->second->type != type)
+            continue;
+        result.push_back(fnd_cell->second.get());
+    }
+    return result;
+}
+
+void BaseCtx::retypeCell(CellInfo &cell, IdString new_type)
+{
+    if (cell_type_index_valid) {
+        auto fnd = cell_type_index.find(cell.type);
+        if (fnd != cell_type_index.end())
+            fnd->second.erase(cell.name);
+        cell_type_index[new_type].insert(cell.name);
+    }
+    cell.type = new_type;
+}
+
+void BaseCtx::compactCells()
+{
+    for (auto &cell : cells) {
+        CellInfo *ci = cell.second.get();
+        ci->ports.shrink_to_fit();
+        ci->attrs.shrink_to_fit();
+        ci->params.shrink_to_fit();
+    }
+}
+
+void BaseCtx::compactRouting()
+{
+    for (auto &net : nets)
+        net.second->wires.shrink_to_fit();
+}
+
 void BaseCtx::copyBelPorts(IdString cell, BelId bel)
 {
     CellInfo *cell_info = cells.at(cell).get();
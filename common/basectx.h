@@ -30,6 +30,7 @@
 
 #include "hashlib.h"
 #include "idstring.h"
+#include "idstringdb.h"
 #include "nextpnr_namespaces.h"
 #include "nextpnr_types.h"
 #include "property.h"
@@ -52,9 +53,9 @@ struct BaseCtx
     std::mutex ui_mutex;
 #endif
 
-    // ID String database.
-    mutable std::unordered_map<std::string, int> *idstring_str_to_idx;
-    mutable std::vector<const std::string *> *idstring_idx_to_str;
+    // ID String database. Safe for concurrent lookups; see idstringdb.h for
+    // the caveat on interning new names from parallel passes
+    mutable IdStringDB *idstring_db;
 
     // Temporary string backing store for logging
     mutable StrRingBuffer log_strs;
@@ -66,6 +67,19 @@ struct BaseCtx
     dict<IdString, std::unique_ptr<NetInfo>> nets;
     dict<IdString, std::unique_ptr<CellInfo>> cells;
 
+    // Dense iteration views over the dicts above. refreshNetUdata() /
+    // refreshCellUdata() assign each object's 'udata' its index in dict
+    // order and fill these arrays, so pass hot loops iterate a contiguous
+    // pointer array instead of walking hash buckets, and passes share one
+    // canonical udata assignment instead of each rolling their own.
+    // Rebuild on demand at pass boundaries once the netlist is stable;
+    // a pass that repurposes udata for private bookkeeping (e.g. the HeAP
+    // solver's row numbers) just refreshes before the next user.
+    std::vector<NetInfo *> net_by_udata;
+    std::vector<CellInfo *> cell_by_udata;
+    void refreshNetUdata();
+    void refreshCellUdata();
+
     // Hierarchical (non-leaf) cells by full path
     dict<IdString, HierarchicalCell> hierarchy;
     // This is the root of the above structure
@@ -94,19 +108,14 @@ struct BaseCtx
 
     BaseCtx()
     {
-        idstring_str_to_idx = new std::unordered_map<std::string, int>;
-        idstring_idx_to_str = new std::vector<const std::string *>;
+        idstring_db = new IdStringDB;
         IdString::initialize_add(this, "", 0);
         IdString::initialize_arch(this);
 
         design_loaded = false;
     }
 
-    virtual ~BaseCtx()
-    {
-        delete idstring_str_to_idx;
-        delete idstring_idx_to_str;
-    }
+    virtual ~BaseCtx() { delete idstring_db; }
 
     // Must be called before performing any mutating changes on the Ctx/Arch.
     void lock(void)
@@ -230,6 +239,31 @@ struct BaseCtx
     CellInfo *createCell(IdString name, IdString type);
     void copyBelPorts(IdString cell, BelId bel);
 
+    // Type -> cell name index so pack passes that only touch a handful of
+    // cell types don't rescan the whole netlist per pass. Built lazily on
+    // the first cellsOfType call and kept current by createCell and
+    // retypeCell; lookups skip entries whose cell has since been erased or
+    // retyped, so erasing cells and rewriting CellInfo::type directly stay
+    // safe. The one stale case is a cell whose type was rewritten directly
+    // *into* the queried type - use retypeCell for that, or call
+    // invalidateCellTypeIndex to force a rebuild
+    std::vector<CellInfo *> cellsOfType(IdString type);
+    void retypeCell(CellInfo &cell, IdString new_type);
+    void invalidateCellTypeIndex() { cell_type_index_valid = false; }
+    dict<IdString, pool<IdString>> cell_type_index;
+    bool cell_type_index_valid = false;
+
+    // Compact per-cell storage once packing has frozen the netlist: ports,
+    // attributes and parameters no longer change during place and route, so
+    // their tables are trimmed to exact size to shrink the hot working set
+    void compactCells();
+
+    // Compact per-net routing storage once routing is done: the wires maps
+    // churn during rip-up and retain their growth slack, which across tens
+    // of millions of bound wires on a large routed design is a significant
+    // share of post-route memory
+    void compactRouting();
+
     // Workaround for lack of wrappable constructors
     DecalXY constructDecalXY(DecalId decal, float x, float y);
 
@@ -53,4 +53,30 @@ int Bits::generic_ctz(unsigned int x)
     log_error("Unreachable!");
 }
 
+int Bits::generic_popcount64(uint64_t v)
+{
+    int c; // c accumulates the total bits set in v
+    for (c = 0; v; c++) {
+        v &= v - 1; // clear the least significant bit set
+    }
+
+    return c;
+}
+
+int Bits::generic_ctz64(uint64_t x)
+{
+    if (x == 0) {
+        log_error("Cannot call ctz64 with arg = 0");
+    }
+
+    for (size_t i = 0; i < std::numeric_limits<uint64_t>::digits; ++i) {
+        if ((x & (uint64_t(1) << i)) != 0) {
+            return i;
+        }
+    }
+
+    // Unreachable!
+    log_error("Unreachable!");
+}
+
 NEXTPNR_NAMESPACE_END
@@ -25,6 +25,9 @@
 //  - ctz : The number of trailing zero bits in an unsigned int.
 //          Must be called with a value that has at least 1 bit set.
 //
+// 64-bit variants (popcount64/ctz64) are provided for callers working on
+// uint64_t masks.
+//
 // These methods will typically use instrinics when available, and have a
 // generic fallback in the event that the instrinic is not available.
 //
@@ -35,8 +38,13 @@
 #if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
 #include <intrin.h>
 #pragma intrinsic(_BitScanForward, _BitScanReverse, __popcnt)
+#if defined(_M_X64)
+#pragma intrinsic(_BitScanForward64, __popcnt64)
+#endif
 #endif
 
+#include <cstdint>
+
 #include "nextpnr_namespaces.h"
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -45,6 +53,8 @@ struct Bits
 {
     static int generic_popcount(unsigned int x);
     static int generic_ctz(unsigned int x);
+    static int generic_popcount64(uint64_t x);
+    static int generic_ctz64(uint64_t x);
 
     static int popcount(unsigned int x)
     {
@@ -67,6 +77,30 @@ struct Bits
         return result;
 #else
         return generic_ctz(x);
+#endif
+    }
+
+    static int popcount64(uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        return int(__popcnt64(x));
+#else
+        return generic_popcount64(x);
+#endif
+    }
+
+    static int ctz64(uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long result;
+        _BitScanForward64(&result, x);
+        return result;
+#else
+        return generic_ctz64(x);
 #endif
     }
 };
@@ -0,0 +1,90 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef BUFFERED_TEXT_WRITER_H
+#define BUFFERED_TEXT_WRITER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Lightweight append-only text buffer for writers that emit millions of short
+// lines (FASM, textual bitstreams). Output is batched into a large in-memory
+// buffer written to the underlying stream in bulk, rather than a formatted
+// write and flush per line, with a fast path for unsigned integer formatting.
+struct BufferedTextWriter
+{
+    explicit BufferedTextWriter(std::ostream &out) : out(out) { buf.reserve(buf_target); }
+    ~BufferedTextWriter() { flush(); }
+
+    void put(char c)
+    {
+        buf += c;
+        maybe_flush();
+    }
+    void put(const char *s)
+    {
+        buf += s;
+        maybe_flush();
+    }
+    void put(const std::string &s)
+    {
+        buf += s;
+        maybe_flush();
+    }
+    void put_uint(uint64_t v)
+    {
+        char tmp[20];
+        int n = 0;
+        do {
+            tmp[n++] = char('0' + (v % 10));
+            v /= 10;
+        } while (v != 0);
+        while (n > 0)
+            buf += tmp[--n];
+        maybe_flush();
+    }
+    void newline() { put('\n'); }
+
+    void flush()
+    {
+        if (!buf.empty()) {
+            out.write(buf.data(), std::streamsize(buf.size()));
+            buf.clear();
+        }
+    }
+
+  private:
+    static const size_t buf_target = 1 << 20;
+    void maybe_flush()
+    {
+        if (buf.size() >= buf_target)
+            flush();
+    }
+    std::ostream &out;
+    std::string buf;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
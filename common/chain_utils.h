@@ -65,5 +65,51 @@ std::vector<CellChain> find_chains(const Context *ctx, F1 cell_type_predicate, F
     return chains;
 }
 
+// Indexed chain finder: builds the driver->sink adjacency for the chain
+// ports in one pass (get_next is called exactly once per candidate cell),
+// then extracts every chain in O(length) by walking forward from the cells
+// that no other candidate chains into. Unlike find_chains this needs no
+// get_previous, as heads are found from the adjacency itself
+template <typename F1, typename F2>
+std::vector<CellChain> find_chains_indexed(const Context *ctx, F1 cell_type_predicate, F2 get_next,
+                                           size_t min_length = 2)
+{
+    std::vector<CellInfo *> candidates;
+    for (auto &cell : ctx->cells) {
+        CellInfo *ci = cell.second.get();
+        if (cell_type_predicate(ctx, ci))
+            candidates.push_back(ci);
+    }
+    dict<IdString, CellInfo *> next_cell;
+    pool<IdString> has_prev;
+    next_cell.reserve(candidates.size());
+    for (CellInfo *ci : candidates) {
+        CellInfo *next = get_next(ctx, ci);
+        if (next != nullptr && cell_type_predicate(ctx, next)) {
+            next_cell[ci->name] = next;
+            has_prev.insert(next->name);
+        }
+    }
+    std::vector<CellChain> chains;
+    pool<IdString> chained;
+    for (CellInfo *ci : candidates) {
+        if (has_prev.count(ci->name))
+            continue;
+        CellChain chain;
+        CellInfo *cursor = ci;
+        // The chained guard stops the walk if two heads converge on the same
+        // tail (a carry net feeding multiple chains); the first head in cell
+        // order claims the shared cells
+        while (cursor != nullptr && chained.insert(cursor->name).second) {
+            chain.cells.push_back(cursor);
+            auto fnd = next_cell.find(cursor->name);
+            cursor = (fnd != next_cell.end()) ? fnd->second : nullptr;
+        }
+        if (chain.cells.size() >= min_length)
+            chains.push_back(chain);
+    }
+    return chains;
+}
+
 NEXTPNR_NAMESPACE_END
 #endif
@@ -0,0 +1,270 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "checkpoint.h"
+#include <sstream>
+#include <unordered_map>
+#include "log.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+
+// Same layout scheme as the binary netlist: header (magic, version), string
+// table, body, all little-endian, with every name in the body a 32-bit index
+// into the string table
+static const uint32_t chk_magic = 0x4B435042; // "BPCK"
+static const uint32_t chk_version = 1;
+
+struct CheckpointWriter
+{
+    CheckpointWriter(Context *ctx) : ctx(ctx){};
+    Context *ctx;
+
+    std::ostringstream body;
+    std::vector<const std::string *> strings;
+    std::unordered_map<std::string, uint32_t> string_idx;
+
+    void put_u8(std::ostream &out, uint8_t value) { out.put(char(value)); }
+    void put_u32(std::ostream &out, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            out.put(char((value >> (8 * i)) & 0xFF));
+    }
+
+    void put_str(const std::string &value)
+    {
+        auto fnd = string_idx.find(value);
+        if (fnd == string_idx.end()) {
+            fnd = string_idx.emplace(value, uint32_t(strings.size())).first;
+            strings.push_back(&fnd->first);
+        }
+        put_u32(body, fnd->second);
+    }
+
+    void write_body()
+    {
+        uint32_t nplaced = 0;
+        for (auto &cell : ctx->cells)
+            if (cell.second->bel != BelId())
+                nplaced++;
+        put_u32(body, nplaced);
+        for (auto &cell : ctx->cells) {
+            CellInfo *ci = cell.second.get();
+            if (ci->bel == BelId())
+                continue;
+            put_str(ci->name.str(ctx));
+            put_str(ctx->getBelName(ci->bel).str(ctx));
+            put_u8(body, uint8_t(ci->belStrength));
+        }
+
+        put_u32(body, uint32_t(ctx->nets.size()));
+        for (auto &net : ctx->nets) {
+            NetInfo *ni = net.second.get();
+            put_str(ni->name.str(ctx));
+            put_u32(body, uint32_t(ni->wires.size()));
+            for (auto &wire : ni->wires) {
+                // Wires driven through a pip are identified by the pip name
+                // alone; the destination wire is rederived on load. Root
+                // wires (bound directly to the net source) have no pip
+                put_u8(body, wire.second.pip != PipId() ? 1 : 0);
+                if (wire.second.pip != PipId())
+                    put_str(ctx->getPipName(wire.second.pip).str(ctx));
+                else
+                    put_str(ctx->getWireName(wire.first).str(ctx));
+                put_u8(body, uint8_t(wire.second.strength));
+            }
+        }
+    }
+
+    void operator()(std::ostream &out)
+    {
+        write_body();
+        put_u32(out, chk_magic);
+        put_u32(out, chk_version);
+        put_u32(out, uint32_t(strings.size()));
+        for (auto str : strings) {
+            put_u32(out, uint32_t(str->size()));
+            out.write(str->data(), str->size());
+        }
+        std::string body_str = body.str();
+        out.write(body_str.data(), body_str.size());
+    }
+};
+
+struct CheckpointReader
+{
+    CheckpointReader(std::istream &in, const std::string &filename, Context *ctx)
+            : in(in), filename(filename), ctx(ctx){};
+    std::istream &in;
+    std::string filename;
+    Context *ctx;
+
+    std::vector<std::string> strings;
+
+    uint8_t get_u8()
+    {
+        int c = in.get();
+        if (c == EOF)
+            log_error("unexpected end of file parsing checkpoint '%s'\n", filename.c_str());
+        return uint8_t(c);
+    }
+    uint32_t get_u32()
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++)
+            value |= uint32_t(get_u8()) << (8 * i);
+        return value;
+    }
+    const std::string &get_str()
+    {
+        uint32_t idx = get_u32();
+        if (idx >= strings.size())
+            log_error("invalid string reference parsing checkpoint '%s'\n", filename.c_str());
+        return strings.at(idx);
+    }
+
+    void operator()()
+    {
+        if (get_u32() != chk_magic)
+            log_error("'%s' is not a checkpoint file\n", filename.c_str());
+        uint32_t version = get_u32();
+        if (version != chk_version)
+            log_error("checkpoint '%s' has version %u, expected %u (regenerate it with this nextpnr build)\n",
+                      filename.c_str(), unsigned(version), unsigned(chk_version));
+        uint32_t nstrings = get_u32();
+        strings.resize(nstrings);
+        for (uint32_t i = 0; i < nstrings; i++) {
+            uint32_t len = get_u32();
+            strings.at(i).resize(len);
+            in.read(&strings.at(i)[0], len);
+            if (!in)
+                log_error("unexpected end of file parsing checkpoint '%s'\n", filename.c_str());
+        }
+
+        int placed = 0, placed_skipped = 0;
+        uint32_t ncells = get_u32();
+        for (uint32_t i = 0; i < ncells; i++) {
+            const std::string &cell_name = get_str();
+            const std::string &bel_name = get_str();
+            PlaceStrength strength = PlaceStrength(get_u8());
+            auto fnd_cell = ctx->cells.find(ctx->id(cell_name));
+            if (fnd_cell == ctx->cells.end()) {
+                log_warning("checkpoint cell '%s' not found in design, skipping\n", cell_name.c_str());
+                placed_skipped++;
+                continue;
+            }
+            CellInfo *ci = fnd_cell->second.get();
+            BelId bel = ctx->getBelByNameStr(bel_name);
+            if (bel == BelId() || !ctx->checkBelAvail(bel) || ci->bel != BelId()) {
+                log_warning("cannot restore cell '%s' to bel '%s', skipping\n", cell_name.c_str(), bel_name.c_str());
+                placed_skipped++;
+                continue;
+            }
+            ctx->bindBel(bel, ci, strength);
+            placed++;
+        }
+
+        int routed = 0, routed_skipped = 0;
+        uint32_t nnets = get_u32();
+        for (uint32_t i = 0; i < nnets; i++) {
+            const std::string &net_name = get_str();
+            auto fnd_net = ctx->nets.find(ctx->id(net_name));
+            NetInfo *ni = (fnd_net != ctx->nets.end()) ? fnd_net->second.get() : nullptr;
+            // Applied bindings, so a net that fails partway can be ripped up
+            // and left entirely to the router
+            std::vector<std::pair<WireId, PipId>> bound;
+            bool failed = (ni == nullptr);
+            uint32_t nwires = get_u32();
+            for (uint32_t j = 0; j < nwires; j++) {
+                bool has_pip = (get_u8() != 0);
+                const std::string &name = get_str();
+                PlaceStrength strength = PlaceStrength(get_u8());
+                if (failed)
+                    continue;
+                if (has_pip) {
+                    PipId pip = ctx->getPipByNameStr(name);
+                    if (pip == PipId() || !ctx->checkPipAvail(pip) ||
+                        !ctx->checkWireAvail(ctx->getPipDstWire(pip))) {
+                        failed = true;
+                        continue;
+                    }
+                    ctx->bindPip(pip, ni, strength);
+                    bound.emplace_back(ctx->getPipDstWire(pip), pip);
+                } else {
+                    WireId wire = ctx->getWireByNameStr(name);
+                    if (wire == WireId() || !ctx->checkWireAvail(wire)) {
+                        failed = true;
+                        continue;
+                    }
+                    ctx->bindWire(wire, ni, strength);
+                    bound.emplace_back(wire, PipId());
+                }
+            }
+            if (failed) {
+                for (auto &b : bound) {
+                    if (b.second != PipId())
+                        ctx->unbindPip(b.second);
+                    else
+                        ctx->unbindWire(b.first);
+                }
+                if (ni != nullptr || nwires > 0) {
+                    log_warning("cannot restore routing of net '%s', leaving it for the router\n", net_name.c_str());
+                    routed_skipped++;
+                }
+            } else if (!bound.empty()) {
+                routed++;
+            }
+        }
+
+        log_info("Restored checkpoint '%s': %d cell placements (%d skipped), %d routed nets (%d skipped)\n",
+                 filename.c_str(), placed, placed_skipped, routed, routed_skipped);
+    }
+};
+
+} // namespace
+
+bool write_checkpoint(std::ostream &out, const std::string &filename, Context *ctx)
+{
+    try {
+        if (!out)
+            log_error("failed to open checkpoint file '%s' for writing\n", filename.c_str());
+        CheckpointWriter writer(ctx);
+        writer(out);
+        log_info("Wrote checkpoint '%s'\n", filename.c_str());
+        return true;
+    } catch (log_execution_error_exception) {
+        return false;
+    }
+}
+
+bool read_checkpoint(std::istream &in, const std::string &filename, Context *ctx)
+{
+    try {
+        if (!in)
+            log_error("failed to open checkpoint file '%s'\n", filename.c_str());
+        CheckpointReader reader(in, filename, ctx);
+        reader();
+        return true;
+    } catch (log_execution_error_exception) {
+        return false;
+    }
+}
+
+NEXTPNR_NAMESPACE_END
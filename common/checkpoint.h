@@ -0,0 +1,39 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <iostream>
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Binary snapshot of placement and routing state: cell->bel bindings and
+// per-net wire/pip trees, keyed by name so a checkpoint written by one run
+// can be reapplied to a freshly packed design in another. Bindings whose
+// cell, net, bel, wire or pip no longer exists (or is no longer available)
+// are skipped with a warning, so after an ECO netlist change the changed
+// portion is simply left for the placer/router to redo.
+bool write_checkpoint(std::ostream &out, const std::string &filename, Context *ctx);
+bool read_checkpoint(std::istream &in, const std::string &filename, Context *ctx);
+
+NEXTPNR_NAMESPACE_END
+
+#endif /* CHECKPOINT_H */
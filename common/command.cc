@@ -30,15 +30,29 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/join.hpp>
 #include <boost/filesystem/convenience.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 #include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <random>
+#include <sstream>
+#include "binary_frontend.h"
+#include "checkpoint.h"
+#include "route_hints.h"
 #include "command.h"
 #include "design_utils.h"
 #include "json_frontend.h"
 #include "jsonwrite.h"
 #include "log.h"
+#include "netlist_fold.h"
+#include "profiler.h"
+#include "router2.h"
+#include "telemetry.h"
+#include "threadpool.h"
 #include "timing.h"
 #include "util.h"
 #include "version.h"
@@ -129,9 +143,34 @@ po::options_description CommandHandler::getGeneralOptions()
 #endif
     general.add_options()("json", po::value<std::string>(), "JSON design file to ingest");
     general.add_options()("write", po::value<std::string>(), "JSON design file to write");
+    general.add_options()("bnl", po::value<std::string>(), "pre-parsed binary netlist file to ingest (see --write-bnl)");
+    general.add_options()("write-bnl", po::value<std::string>(),
+                          "binary netlist file to write after design load, for fast re-loading with --bnl");
+    general.add_options()("pack-cache", po::value<std::string>(),
+                          "directory of cached post-pack snapshots: when the input netlist and settings are "
+                          "unchanged, packing is skipped and the cached snapshot is loaded instead");
+    general.add_options()("read-checkpoint", po::value<std::string>(),
+                          "restore placement/routing state from a checkpoint file after packing");
+    general.add_options()("write-checkpoint", po::value<std::string>(),
+                          "write placement/routing state to a checkpoint file after place and route");
+    general.add_options()("read-route-hints", po::value<std::string>(),
+                          "seed the router with per-net routes from a hints file written by a previous run");
+    general.add_options()("write-route-hints", po::value<std::string>(),
+                          "write final per-net routes as a hints file for future incremental runs");
     general.add_options()("top", po::value<std::string>(), "name of top module");
     general.add_options()("seed", po::value<int>(), "seed value for random number generator");
     general.add_options()("randomize-seed,r", "randomize seed value for random number generator");
+    general.add_options()("seeds", po::value<int>(),
+                          "run placement this many times with different seeds, keeping the best result for routing");
+    general.add_options()("place-quality-cmd", po::value<std::string>(),
+                          "run this command after placement with quality features as key=value arguments; a nonzero "
+                          "exit status rejects the placement and placement is retried with a new seed");
+    general.add_options()("place-quality-retries", po::value<int>(),
+                          "placements tried under --place-quality-cmd before keeping the last one (default: 3)");
+    general.add_options()("threads", po::value<int>(),
+                          "number of threads for parallel passes (default: number of CPU cores)");
+    general.add_options()("pin-threads",
+                          "pin worker threads to CPUs, keeping their state on the local memory node (Linux only)");
 
     general.add_options()(
             "placer", po::value<std::string>(),
@@ -148,11 +187,19 @@ po::options_description CommandHandler::getGeneralOptions()
     general.add_options()("slack_redist_iter", po::value<int>(), "number of iterations between slack redistribution");
     general.add_options()("cstrweight", po::value<float>(), "placer weighting for relative constraint satisfaction");
     general.add_options()("starttemp", po::value<float>(), "placer SA start temperature");
+    general.add_options()("placer-adaptive",
+                          "use a self-tuning SA schedule (acceptance and cost-variance driven) instead of "
+                          "fixed cooling multipliers");
     general.add_options()("placer-budgets", "use budget rather than criticality in placer timing weights");
 
+    general.add_options()("no-fold", "disable pre-pack netlist folding (constant sweep and duplicate cell merging)");
+
     general.add_options()("pack-only", "pack design only without placement or routing");
     general.add_options()("no-route", "process design without routing");
     general.add_options()("no-place", "process design without placement");
+    general.add_options()("estimate-only",
+                          "skip detailed routing: estimate routability and timing after placement (for "
+                          "parameter sweeps with --report)");
     general.add_options()("no-pack", "process design without packing");
 
     general.add_options()("ignore-loops", "ignore combinational loops in timing analysis");
@@ -162,7 +209,8 @@ po::options_description CommandHandler::getGeneralOptions()
     general.add_options()("freq", po::value<double>(), "set target frequency for design in MHz");
     general.add_options()("timing-allow-fail", "allow timing to fail in design");
     general.add_options()("no-tmdriv", "disable timing-driven placement");
-    general.add_options()("sdf", po::value<std::string>(), "SDF delay back-annotation file to write");
+    general.add_options()("sdf", po::value<std::string>(),
+                          "SDF delay back-annotation file to write (gzip-compressed if the name ends in .gz)");
     general.add_options()("sdf-cvc", "enable tweaks for SDF file compatibility with the CVC simulator");
     general.add_options()("no-print-critical-path-source",
                           "disable printing of the line numbers associated with each net in the critical path");
@@ -176,6 +224,10 @@ po::options_description CommandHandler::getGeneralOptions()
     general.add_options()("router2-heatmap", po::value<std::string>(),
                           "prefix for router2 resource congestion heatmaps");
 
+    general.add_options()("telemetry", po::value<std::string>(),
+                          "stream per-iteration pass statistics to this file as JSON lines, for live monitoring of "
+                          "headless runs");
+
     general.add_options()("tmg-ripup", "enable experimental timing-driven ripup in router");
     general.add_options()("router2-tmg-ripup",
                           "enable experimental timing-driven ripup in router (deprecated; use --tmg-ripup instead)");
@@ -183,6 +235,8 @@ po::options_description CommandHandler::getGeneralOptions()
     general.add_options()("report", po::value<std::string>(),
                           "write timing and utilization report in JSON format to file");
     general.add_options()("detailed-timing-report", "Append detailed net timing data to the JSON report");
+    general.add_options()("report-timing-paths", po::value<int>(),
+                          "Append the N worst timing paths across all clock domains to the JSON report");
 
     general.add_options()("placed-svg", po::value<std::string>(), "write render of placement to SVG file");
     general.add_options()("routed-svg", po::value<std::string>(), "write render of routing to SVG file");
@@ -231,6 +285,14 @@ void CommandHandler::setupContext(Context *ctx)
         ctx->rngseed(distrib(randDev));
     }
 
+    if (vm.count("threads")) {
+        ThreadPool::configure(vm["threads"].as<int>());
+    }
+
+    if (vm.count("pin-threads")) {
+        ThreadPool::configure_pinning(true);
+    }
+
     if (vm.count("slack_redist_iter")) {
         ctx->settings[ctx->id("slack_redist_iter")] = vm["slack_redist_iter"].as<int>();
         if (vm.count("freq") && vm["freq"].as<double>() == 0) {
@@ -275,6 +337,9 @@ void CommandHandler::setupContext(Context *ctx)
         ctx->settings[ctx->id("placer1/startTemp")] = std::to_string(vm["starttemp"].as<float>());
     }
 
+    if (vm.count("placer-adaptive")) {
+        ctx->settings[ctx->id("placer1/adaptiveSchedule")] = true;
+    }
     if (vm.count("placer-budgets")) {
         ctx->settings[ctx->id("placer1/budgetBased")] = true;
     }
@@ -300,6 +365,9 @@ void CommandHandler::setupContext(Context *ctx)
         ctx->settings[ctx->id("placerHeap/timingWeight")] = std::to_string(vm["placer-heap-timingweight"].as<int>());
     if (vm.count("router2-heatmap"))
         ctx->settings[ctx->id("router2/heatmap")] = vm["router2-heatmap"].as<std::string>();
+
+    if (vm.count("telemetry"))
+        ctx->settings[ctx->id("telemetry")] = vm["telemetry"].as<std::string>();
     if (vm.count("tmg-ripup") || vm.count("router2-tmg-ripup"))
         ctx->settings[ctx->id("router/tmg_ripup")] = true;
 
@@ -333,6 +401,220 @@ void CommandHandler::setupContext(Context *ctx)
     if (vm.count("detailed-timing-report")) {
         ctx->detailed_timing_report = true;
     }
+
+    if (vm.count("report-timing-paths")) {
+        ctx->report_timing_paths = vm["report-timing-paths"].as<int>();
+    }
+}
+
+// Placement snapshot/restore helpers shared by the --seeds multi-start loop
+// and the --place-quality-cmd reseed loop
+namespace {
+struct CellPlacement
+{
+    IdString cell;
+    BelId bel;
+    PlaceStrength strength;
+};
+
+std::vector<CellPlacement> snapshot_placement(Context *ctx)
+{
+    std::vector<CellPlacement> placement;
+    for (auto &cell : ctx->cells)
+        if (cell.second->bel != BelId())
+            placement.push_back(CellPlacement{cell.first, cell.second->bel, cell.second->belStrength});
+    return placement;
+}
+
+void strip_placement(Context *ctx)
+{
+    for (auto &cell : ctx->cells)
+        if (cell.second->bel != BelId())
+            ctx->unbindBel(cell.second->bel);
+}
+
+void apply_placement(Context *ctx, const std::vector<CellPlacement> &placement)
+{
+    for (auto &entry : placement)
+        ctx->bindBel(entry.bel, ctx->cells.at(entry.cell).get(), entry.strength);
+}
+} // namespace
+
+// Multi-start placement for --seeds: run the placer num_seeds times from the
+// shared packed design, score each candidate with the estimated-delay timing
+// analysis, and leave only the best placement bound for routing. This
+// replaces external scripts that run the whole flow once per seed, each time
+// paying for the netlist parse and chipdb load again and routing candidates
+// that were never going to win
+void CommandHandler::placeMultipleSeeds(Context *ctx, int num_seeds)
+{
+    // Bels bound before placement (e.g. user-constrained IO) are part of the
+    // shared starting point and are restored before each candidate run
+    std::vector<CellPlacement> preplace = snapshot_placement(ctx);
+
+    const uint64_t base_rngstate = ctx->rngstate;
+    int best_seed = -1;
+    uint64_t best_rngstate = 0;
+    float best_fmax = 0;
+    std::vector<CellPlacement> best_placement;
+    bool warned_no_clocks = false;
+    for (int i = 0; i < num_seeds; i++) {
+        // The first candidate uses the unmodified --seed state, so its
+        // placement is identical to a plain single-seed run; later candidates
+        // derive their seed from the base state and their index, making the
+        // whole sweep reproducible from one --seed value
+        if (i > 0) {
+            strip_placement(ctx);
+            apply_placement(ctx, preplace);
+            ctx->rngseed(base_rngstate + uint64_t(i));
+        }
+        log_info("Placing with seed %d of %d...\n", i + 1, num_seeds);
+        if (!ctx->place() && !ctx->force) {
+            log_warning("Placement failed for seed %d of %d, skipping candidate.\n", i + 1, num_seeds);
+            continue;
+        }
+        ctx->check();
+        // Cheap candidate score: estimated-delay static timing, no report
+        timing_analysis(ctx, /*slack_histogram=*/false, /*print_fmax=*/false, /*print_path=*/false,
+                        /*warn_on_failure=*/false, /*update_results=*/true);
+        float fmax = 0;
+        bool first_clock = true;
+        for (auto &clock : ctx->timing_result.clock_fmax) {
+            fmax = first_clock ? clock.second.achieved : std::min(fmax, clock.second.achieved);
+            first_clock = false;
+        }
+        if (first_clock && !warned_no_clocks) {
+            log_warning("No clock domains to score placements by; keeping the first seed that places.\n");
+            warned_no_clocks = true;
+        }
+        log_info("Seed %d of %d: estimated Fmax %.2f MHz\n", i + 1, num_seeds, fmax);
+        // Strictly-better comparison keeps the earliest seed on ties, so the
+        // choice of winner is deterministic
+        if (best_seed == -1 || fmax > best_fmax) {
+            best_seed = i;
+            best_rngstate = ctx->rngstate;
+            best_fmax = fmax;
+            best_placement = snapshot_placement(ctx);
+        }
+    }
+    if (best_seed == -1)
+        log_error("Placing design failed for all %d seeds.\n", num_seeds);
+    log_info("Keeping seed %d of %d (estimated Fmax %.2f MHz) for routing.\n", best_seed + 1, num_seeds, best_fmax);
+    if (best_seed != num_seeds - 1) {
+        strip_placement(ctx);
+        apply_placement(ctx, best_placement);
+        // place() can rewire the netlist after the placer proper (LUT input
+        // permutation on ice40/ecp5 rewires pins and rewrites INIT), and
+        // those edits belong to whichever candidate ran last. Re-run the
+        // arch's post-place fixup so connectivity and params match the
+        // restored winner, then refresh the serialised placement attributes
+        ctx->postPlaceFixup();
+        ctx->archInfoToAttributes();
+    }
+    // Budgets are left over from the last candidate's run; recompute them for
+    // the restored placement so routing sees a consistent state. The RNG also
+    // continues from the winning candidate, so routing behaves as it would
+    // after a single-seed run that happened to produce this placement
+    assign_budget(ctx, /*quiet=*/true);
+    ctx->rngstate = best_rngstate;
+}
+
+// Early placement-quality features for --place-quality-cmd and telemetry:
+// cheap post-placement statistics that predict routability long before the
+// router has spent its time budget. Wirelengths are half-perimeter in grid
+// units; the congestion estimate is the sum of net bounding-box areas over
+// the device area, so values well above the design's usual range mean nets
+// are being stretched across each other. The Fmax figure comes from the
+// same estimated-delay STA that scores --seeds candidates
+static std::vector<std::pair<const char *, double>> placement_quality_features(Context *ctx)
+{
+    std::vector<double> lens;
+    double total = 0, bb_area = 0;
+    for (auto &net : ctx->nets) {
+        NetInfo *ni = net.second.get();
+        if (ni->driver.cell == nullptr || ni->driver.cell->bel == BelId())
+            continue;
+        Loc drv = ctx->getBelLocation(ni->driver.cell->bel);
+        int x0 = drv.x, x1 = drv.x, y0 = drv.y, y1 = drv.y;
+        for (auto &usr : ni->users) {
+            if (usr.cell->bel == BelId())
+                continue;
+            Loc loc = ctx->getBelLocation(usr.cell->bel);
+            x0 = std::min(x0, loc.x);
+            x1 = std::max(x1, loc.x);
+            y0 = std::min(y0, loc.y);
+            y1 = std::max(y1, loc.y);
+        }
+        double hpwl = double(x1 - x0) + double(y1 - y0);
+        lens.push_back(hpwl);
+        total += hpwl;
+        bb_area += double(x1 - x0 + 1) * double(y1 - y0 + 1);
+    }
+    std::sort(lens.begin(), lens.end());
+    double mean = lens.empty() ? 0 : total / double(lens.size());
+    double p90 = lens.empty() ? 0 : lens.at(std::min(lens.size() - 1, lens.size() * 9 / 10));
+    double wl_max = lens.empty() ? 0 : lens.back();
+    double grid = double(ctx->getGridDimX()) * double(ctx->getGridDimY());
+    timing_analysis(ctx, /*slack_histogram=*/false, /*print_fmax=*/false, /*print_path=*/false,
+                    /*warn_on_failure=*/false, /*update_results=*/true);
+    double fmax = 0;
+    bool first_clock = true;
+    for (auto &clock : ctx->timing_result.clock_fmax) {
+        fmax = first_clock ? clock.second.achieved : std::min<double>(fmax, clock.second.achieved);
+        first_clock = false;
+    }
+    return {{"est_fmax_mhz", fmax},
+            {"wirelen_total", total},
+            {"wirelen_mean", mean},
+            {"wirelen_p90", p90},
+            {"wirelen_max", wl_max},
+            {"congestion_est", grid > 0 ? bb_area / grid : 0},
+            {"nets", double(ctx->nets.size())},
+            {"cells", double(ctx->cells.size())}};
+}
+
+// Runs the user's quality command with every feature appended as a
+// key=value argument; exit status zero accepts the placement, anything else
+// (including a command that fails to run) rejects it
+static bool placement_quality_accept(const std::string &cmd, const std::vector<std::pair<const char *, double>> &features)
+{
+    std::string full = cmd;
+    for (auto &feature : features) {
+        char buf[80];
+        std::snprintf(buf, sizeof(buf), " %s=%.10g", feature.first, feature.second);
+        full += buf;
+    }
+    return std::system(full.c_str()) == 0;
+}
+
+// Cache key for --pack-cache: a hash over the raw netlist bytes and every
+// setting in force before the flow starts (seed, arch identifiers, pass
+// options). Over-approximating the inputs only costs cache hits, never
+// correctness. Returns an empty string if the netlist can't be read
+static std::string pack_cache_key(Context *ctx, const std::string &netlist_file)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    auto mix = [&](const char *data, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            h ^= uint8_t(data[i]);
+            h *= 0x100000001b3ULL;
+        }
+    };
+    std::ifstream f(netlist_file, std::ios::binary);
+    if (!f)
+        return "";
+    char buf[65536];
+    while (f) {
+        f.read(buf, sizeof(buf));
+        mix(buf, size_t(f.gcount()));
+    }
+    for (auto &setting : ctx->settings) {
+        std::string entry = setting.first.str(ctx) + "=" + setting.second.to_string() + ";";
+        mix(entry.c_str(), entry.size());
+    }
+    char key[20];
+    snprintf(key, sizeof(key), "%016llx", (unsigned long long)h);
+    return key;
 }
 
 int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
@@ -350,6 +632,19 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         ctx->settings[ctx->id("frontend/top")] = vm["top"].as<std::string>();
     }
 
+#ifndef NPNR_DISABLE_THREADS
+    // Report content rendered by a background thread overlapped with the
+    // bitstream write; consumed by the --report handling below
+    std::ostringstream report_str;
+    bool report_in_background = false;
+    // JSON netlist and SDF writers launched by the overlapped output pipeline
+    // in the design flow below. They are joined just before exit, so they also
+    // overlap python teardown; joinable() doubles as the "already handled by
+    // the pipeline" check for the sequential fallbacks.
+    boost::thread json_thread, sdf_thread;
+    bool json_failed = false, sdf_failed = false;
+#endif
+
 #ifndef NO_GUI
     if (vm.count("gui")) {
         Application a(argc, argv, (vm.count("gui-no-aa") > 0));
@@ -373,15 +668,88 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         return a.exec();
     }
 #endif
+    // Pack-result cache: when the input netlist bytes and the settings in
+    // force are unchanged from a previous run, load that run's post-pack
+    // snapshot instead of the netlist and skip folding and packing below
+    bool pack_cache_hit = false;
+    std::string pack_cache_file;
     if (vm.count("json")) {
+        ScopedPassProfile profile("read_netlist");
         std::string filename = vm["json"].as<std::string>();
-        std::ifstream f(filename);
-        if (!parse_json(f, filename, ctx.get()))
+        if (vm.count("pack-cache") && !vm.count("no-pack")) {
+            std::string key = pack_cache_key(ctx.get(), filename);
+            if (!key.empty())
+                pack_cache_file = vm["pack-cache"].as<std::string>() + "/pack-" + key + ".bnl";
+        }
+        std::ifstream cached;
+        if (!pack_cache_file.empty())
+            cached.open(pack_cache_file, std::ios::binary);
+        if (cached.is_open() && !binary_netlist_version_ok(cached)) {
+            // A snapshot left behind by an older build is a miss, not an
+            // error; re-packing below overwrites it with the current format
+            log_info("Ignoring pack cache snapshot '%s' with a stale format.\n", pack_cache_file.c_str());
+            cached.close();
+        }
+        if (cached.is_open()) {
+            log_info("Loading cached post-pack snapshot '%s'.\n", pack_cache_file.c_str());
+            if (!parse_binary_netlist(cached, pack_cache_file, ctx.get()))
+                log_error("Loading cached snapshot failed; remove '%s' to re-pack.\n", pack_cache_file.c_str());
+            pack_cache_hit = true;
+        } else {
+            std::ifstream f(filename);
+            if (!parse_json(f, filename, ctx.get()))
+                log_error("Loading design failed.\n");
+        }
+
+        customAfterLoad(ctx.get());
+    } else if (vm.count("bnl")) {
+        ScopedPassProfile profile("read_netlist");
+        std::string filename = vm["bnl"].as<std::string>();
+        std::ifstream f(filename, std::ios::binary);
+        if (!parse_binary_netlist(f, filename, ctx.get()))
             log_error("Loading design failed.\n");
 
         customAfterLoad(ctx.get());
     }
 
+    if (vm.count("write-bnl") && ctx->design_loaded) {
+        std::string filename = vm["write-bnl"].as<std::string>();
+        std::ofstream f(filename, std::ios::binary);
+        if (!write_binary_netlist(f, filename, ctx.get()))
+            log_error("Saving binary netlist failed.\n");
+    }
+
+    // Output writers shared between the overlapped pipeline in the design
+    // flow and the sequential fallbacks below. Each one opens its own file and
+    // only reads design state, so once routing is finished they are safe to
+    // run on background threads.
+    auto write_json_output = [&]() {
+        std::string filename = vm["write"].as<std::string>();
+        std::ofstream f(filename);
+        if (!write_json_file(f, filename, ctx.get()))
+            log_error("Saving design failed.\n");
+    };
+    auto write_sdf_output = [&]() {
+        std::string filename = vm["sdf"].as<std::string>();
+        if (boost::algorithm::ends_with(filename, ".gz")) {
+            // Stream through the gzip compressor rather than writing
+            // uncompressed: SDF is highly redundant text and for large
+            // designs the raw file is gigabytes of write bandwidth
+            std::ofstream f(filename, std::ios::binary);
+            if (!f)
+                log_error("Failed to open SDF file '%s' for writing.\n", filename.c_str());
+            boost::iostreams::filtering_ostream gz;
+            gz.push(boost::iostreams::gzip_compressor());
+            gz.push(f);
+            ctx->writeSDF(gz, vm.count("sdf-cvc"));
+        } else {
+            std::ofstream f(filename);
+            if (!f)
+                log_error("Failed to open SDF file '%s' for writing.\n", filename.c_str());
+            ctx->writeSDF(f, vm.count("sdf-cvc"));
+        }
+    };
+
 #ifndef NO_PYTHON
     init_python(argv[0]);
     python_export_global("ctx", *ctx);
@@ -396,59 +764,234 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
             if (ctx->design_loaded) {
         bool do_pack = vm.count("pack-only") != 0 || vm.count("no-pack") == 0;
         bool do_place = vm.count("pack-only") == 0 && vm.count("no-place") == 0;
-        bool do_route = vm.count("pack-only") == 0 && vm.count("no-route") == 0;
+        bool estimate_only = vm.count("estimate-only") != 0;
+        bool do_route = vm.count("pack-only") == 0 && vm.count("no-route") == 0 && !estimate_only;
+
+#ifndef NPNR_DISABLE_THREADS
+        // SVG and report generation only read the design, which is frozen
+        // once routing and the post-route hook are done, so they are run on
+        // background threads overlapped with the bitstream write rather than
+        // paid for serially at the end of the flow. The report is rendered
+        // to a string here and written to its file at the usual point below.
+        boost::thread svg_thread, report_thread;
+        bool svg_failed = false, report_failed = false;
+#endif
 
-        if (do_pack) {
+        if (!vm.count("no-fold") && !pack_cache_hit) {
+            ScopedPassProfile profile("fold");
+            fold_netlist(ctx.get());
+        }
+
+        if (do_pack && !pack_cache_hit) {
+            ScopedPassProfile profile("pack");
             run_script_hook("pre-pack");
             if (!ctx->pack() && !ctx->force)
                 log_error("Packing design failed.\n");
+            // the cell interface is frozen from here on; trim the port and
+            // attribute tables before the placer starts hammering them
+            ctx->compactCells();
+            if (!pack_cache_file.empty()) {
+                // Written to a unique temp name then renamed, so concurrent
+                // CI jobs racing on the same key can't see a partial file
+                std::string tmp = pack_cache_file + ".tmp." +
+                                  std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+                std::ofstream f(tmp, std::ios::binary);
+                bool written = write_binary_netlist(f, tmp, ctx.get()) && f.good();
+                f.close();
+                if (!written || std::rename(tmp.c_str(), pack_cache_file.c_str()) != 0) {
+                    std::remove(tmp.c_str());
+                    log_warning("failed to write pack cache snapshot '%s'\n", pack_cache_file.c_str());
+                }
+            }
         }
         assign_budget(ctx.get());
         ctx->check();
         print_utilisation(ctx.get());
 
+        if (vm.count("read-checkpoint")) {
+            std::string filename = vm["read-checkpoint"].as<std::string>();
+            std::ifstream f(filename, std::ios::binary);
+            if (!read_checkpoint(f, filename, ctx.get()))
+                log_error("Restoring checkpoint failed.\n");
+            ctx->check();
+        }
+
         if (do_place) {
+            ScopedPassProfile profile("place");
             run_script_hook("pre-place");
             bool saved_debug = ctx->debug;
             if (vm.count("debug-placer"))
                 ctx->debug = true;
-            if (!ctx->place() && !ctx->force)
-                log_error("Placing design failed.\n");
+            int num_seeds = vm.count("seeds") ? vm["seeds"].as<int>() : 1;
+            if (num_seeds < 1)
+                log_error("number of placement seeds must be at least 1.\n");
+            std::string quality_cmd =
+                    vm.count("place-quality-cmd") ? vm["place-quality-cmd"].as<std::string>() : "";
+            int quality_tries = vm.count("place-quality-retries") ? vm["place-quality-retries"].as<int>() : 3;
+            if (quality_tries < 1)
+                log_error("number of placement quality retries must be at least 1.\n");
+            // Bels bound before placement are part of the shared starting
+            // point and are restored before a reseeded retry
+            std::vector<CellPlacement> preplace;
+            if (!quality_cmd.empty())
+                preplace = snapshot_placement(ctx.get());
+            const uint64_t place_base_rngstate = ctx->rngstate;
+            for (int attempt = 1;; attempt++) {
+                if (num_seeds > 1) {
+                    placeMultipleSeeds(ctx.get(), num_seeds);
+                } else if (!ctx->place() && !ctx->force) {
+                    log_error("Placing design failed.\n");
+                }
+                if (quality_cmd.empty() && !telemetry_enabled(ctx.get()))
+                    break;
+                auto features = placement_quality_features(ctx.get());
+                if (telemetry_enabled(ctx.get()))
+                    telemetry_record(ctx.get(), "placement_features", features);
+                if (quality_cmd.empty() || placement_quality_accept(quality_cmd, features))
+                    break;
+                if (attempt >= quality_tries) {
+                    log_warning("placement still rejected by the quality command after %d attempts; "
+                                "keeping the last one\n",
+                                quality_tries);
+                    break;
+                }
+                log_info("Placement rejected by the quality command; reseeding (attempt %d of %d)\n", attempt + 1,
+                         quality_tries);
+                strip_placement(ctx.get());
+                apply_placement(ctx.get(), preplace);
+                // The high shift keeps retry seeds disjoint from the
+                // candidate seeds --seeds derives from the same base state
+                ctx->rngseed(place_base_rngstate + (uint64_t(attempt) << 32));
+            }
             ctx->debug = saved_debug;
             ctx->check();
             if (vm.count("placed-svg"))
                 ctx->writeSVG(vm["placed-svg"].as<std::string>(), "scale=50 hide_routing");
         }
 
+        if (estimate_only && do_place) {
+            ScopedPassProfile profile("estimate");
+            // Congestion estimate from the router's own setup, then
+            // estimated-delay STA to fill timing_result so the JSON report
+            // carries Fmax figures as it would after a real route
+            router2_estimate(ctx.get(), Router2Cfg(ctx.get()));
+            timing_analysis(ctx.get(), /*slack_histogram=*/true, /*print_fmax=*/true, /*print_path=*/false,
+                            /*warn_on_failure=*/false, /*update_results=*/true);
+        }
+
         if (do_route) {
+            ScopedPassProfile profile("route");
             run_script_hook("pre-route");
+            if (vm.count("read-route-hints")) {
+                std::string filename = vm["read-route-hints"].as<std::string>();
+                std::ifstream f(filename, std::ios::binary);
+                if (!read_route_hints(f, filename, ctx.get()))
+                    log_error("Applying route hints failed.\n");
+                ctx->check();
+            }
             bool saved_debug = ctx->debug;
             if (vm.count("debug-router"))
                 ctx->debug = true;
             if (!ctx->route() && !ctx->force)
                 log_error("Routing design failed.\n");
+            // the routing trees are final from here on; trim their wire maps
+            // before the output writers inflate the peak further
+            ctx->compactRouting();
             ctx->debug = saved_debug;
             run_script_hook("post-route");
-            if (vm.count("routed-svg"))
+            if (vm.count("routed-svg")) {
+#ifndef NPNR_DISABLE_THREADS
+                svg_thread = boost::thread([&]() {
+                    try {
+                        ctx->writeSVG(vm["routed-svg"].as<std::string>(), "scale=500");
+                    } catch (log_execution_error_exception) {
+                        svg_failed = true;
+                    }
+                });
+#else
                 ctx->writeSVG(vm["routed-svg"].as<std::string>(), "scale=500");
+#endif
+            }
+        }
+
+#ifndef NPNR_DISABLE_THREADS
+        if (vm.count("report")) {
+            report_in_background = true;
+            report_thread = boost::thread([&]() {
+                try {
+                    ctx->writeReport(report_str);
+                } catch (log_execution_error_exception) {
+                    report_failed = true;
+                }
+            });
+        }
+#endif
+
+        if (vm.count("write-checkpoint")) {
+            std::string filename = vm["write-checkpoint"].as<std::string>();
+            std::ofstream f(filename, std::ios::binary);
+            if (!write_checkpoint(f, filename, ctx.get()))
+                log_error("Saving checkpoint failed.\n");
         }
 
+        if (vm.count("write-route-hints")) {
+            std::string filename = vm["write-route-hints"].as<std::string>();
+            std::ofstream f(filename, std::ios::binary);
+            if (!write_route_hints(f, filename, ctx.get()))
+                log_error("Saving route hints failed.\n");
+        }
+
+#ifndef NPNR_DISABLE_THREADS
+        // The netlist and timing results are frozen at this point, so the
+        // JSON netlist and SDF writers can run concurrently with the
+        // (typically slower) bitstream generation below instead of adding
+        // their I/O time serially at the end of the flow.
+        if (vm.count("write")) {
+            json_thread = boost::thread([&]() {
+                try {
+                    write_json_output();
+                } catch (log_execution_error_exception) {
+                    json_failed = true;
+                }
+            });
+        }
+        if (vm.count("sdf")) {
+            sdf_thread = boost::thread([&]() {
+                try {
+                    write_sdf_output();
+                } catch (log_execution_error_exception) {
+                    sdf_failed = true;
+                }
+            });
+        }
+#endif
+
         customBitstream(ctx.get());
+
+#ifndef NPNR_DISABLE_THREADS
+        if (svg_thread.joinable())
+            svg_thread.join();
+        if (report_thread.joinable())
+            report_thread.join();
+        if (svg_failed)
+            log_error("Writing routed SVG failed.\n");
+        if (report_failed)
+            log_error("Generating report failed.\n");
+#endif
     }
 
     if (vm.count("write")) {
-        std::string filename = vm["write"].as<std::string>();
-        std::ofstream f(filename);
-        if (!write_json_file(f, filename, ctx.get()))
-            log_error("Saving design failed.\n");
+#ifndef NPNR_DISABLE_THREADS
+        if (!json_thread.joinable())
+#endif
+            write_json_output();
     }
 
     if (vm.count("sdf")) {
-        std::string filename = vm["sdf"].as<std::string>();
-        std::ofstream f(filename);
-        if (!f)
-            log_error("Failed to open SDF file '%s' for writing.\n", filename.c_str());
-        ctx->writeSDF(f, vm.count("sdf-cvc"));
+#ifndef NPNR_DISABLE_THREADS
+        if (!sdf_thread.joinable())
+#endif
+            write_sdf_output();
     }
 
     if (vm.count("report")) {
@@ -456,13 +999,33 @@ int CommandHandler::executeMain(std::unique_ptr<Context> ctx)
         std::ofstream f(filename);
         if (!f)
             log_error("Failed to open report file '%s' for writing.\n", filename.c_str());
+#ifndef NPNR_DISABLE_THREADS
+        if (report_in_background)
+            f << report_str.str();
+        else
+            ctx->writeReport(f);
+#else
         ctx->writeReport(f);
+#endif
     }
 
 #ifndef NO_PYTHON
     deinit_python();
 #endif
 
+#ifndef NPNR_DISABLE_THREADS
+    // Writers launched by the output pipeline have been overlapping the
+    // bitstream write and the teardown above; collect them before exit
+    if (json_thread.joinable())
+        json_thread.join();
+    if (sdf_thread.joinable())
+        sdf_thread.join();
+    if (json_failed)
+        log_error("Saving design failed.\n");
+    if (sdf_failed)
+        log_error("Writing SDF failed.\n");
+#endif
+
     return had_nonfatal_error ? 1 : 0;
 }
 
@@ -499,6 +1062,9 @@ int CommandHandler::exec()
         setupArchContext(ctx.get());
         int rc = executeMain(std::move(ctx));
         printFooter();
+#ifdef NPNR_AUDIT_NETLIST_COPIES
+        property_copy_audit_report();
+#endif
         log_break();
         log_info("Program finished normally.\n");
         return rc;
@@ -55,6 +55,7 @@ class CommandHandler
     bool executeBeforeContext();
     void setupContext(Context *ctx);
     int executeMain(std::unique_ptr<Context> ctx);
+    void placeMultipleSeeds(Context *ctx, int num_seeds);
     po::options_description getGeneralOptions();
     void printFooter();
 
@@ -91,12 +91,28 @@ WireId Context::getNetinfoSinkWire(const NetInfo *net_info, const PortRef &sink,
 }
 
 delay_t Context::predictArcDelay(const NetInfo *net_info, const PortRef &sink) const
+{
+    return predictArcDelay(net_info, sink, /*update_cache=*/true);
+}
+
+delay_t Context::predictArcDelay(const NetInfo *net_info, const PortRef &sink, bool update_cache) const
 {
     if (net_info->driver.cell == nullptr || net_info->driver.cell->bel == BelId() || sink.cell->bel == BelId())
         return 0;
+
+    const CellInfo *driver_cell = net_info->driver.cell;
+    size_t index = mkhash(mkhash(hash_ptr_ops::hash(sink.cell), sink.port.hash()),
+                          mkhash(driver_cell->bel.hash(), sink.cell->bel.hash())) &
+                   (arc_prediction_cache.size() - 1);
+    ArcPredictionCacheEntry &entry = arc_prediction_cache.at(index);
+    if (entry.net == net_info && entry.driver_cell == driver_cell && entry.driver_port == net_info->driver.port &&
+        entry.sink_cell == sink.cell && entry.sink_port == sink.port && entry.src_bel == driver_cell->bel &&
+        entry.dst_bel == sink.cell->bel)
+        return entry.delay;
+
     IdString driver_pin, sink_pin;
     // Pick the first pin for a prediction; assume all will be similar enouhg
-    for (auto pin : getBelPinsForCellPin(net_info->driver.cell, net_info->driver.port)) {
+    for (auto pin : getBelPinsForCellPin(driver_cell, net_info->driver.port)) {
         driver_pin = pin;
         break;
     }
@@ -104,20 +120,28 @@ delay_t Context::predictArcDelay(const NetInfo *net_info, const PortRef &sink) c
         sink_pin = pin;
         break;
     }
-    if (driver_pin == IdString() || sink_pin == IdString())
-        return 0;
-    return predictDelay(net_info->driver.cell->bel, driver_pin, sink.cell->bel, sink_pin);
+    delay_t delay = 0;
+    if (driver_pin != IdString() && sink_pin != IdString())
+        delay = predictDelay(driver_cell->bel, driver_pin, sink.cell->bel, sink_pin);
+    if (update_cache)
+        entry = ArcPredictionCacheEntry{net_info,  driver_cell,      net_info->driver.port, sink.cell,
+                                        sink.port, driver_cell->bel, sink.cell->bel,        delay};
+    return delay;
 }
 
 delay_t Context::getNetinfoRouteDelay(const NetInfo *net_info, const PortRef &user_info) const
 {
-#ifdef ARCH_ECP5
-    if (net_info->is_global)
-        return 0;
-#endif
+    return getNetinfoRouteDelay(net_info, user_info, /*update_cache=*/true);
+}
+
+delay_t Context::getNetinfoRouteDelay(const NetInfo *net_info, const PortRef &user_info, bool update_cache) const
+{
+    if (Arch::capGlobalsRoutedSeparately)
+        if (net_info->is_global)
+            return 0;
 
     if (net_info->wires.empty())
-        return predictArcDelay(net_info, user_info);
+        return predictArcDelay(net_info, user_info, update_cache);
 
     WireId src_wire = getNetinfoSourceWire(net_info);
     if (src_wire == WireId())
@@ -126,6 +150,14 @@ delay_t Context::getNetinfoRouteDelay(const NetInfo *net_info, const PortRef &us
     delay_t max_delay = 0;
 
     for (auto dst_wire : getNetinfoSinkWires(net_info, user_info)) {
+        auto cache_key = std::make_pair(src_wire, dst_wire);
+        auto cached = route_delay_cache.find(cache_key);
+        if (cached != route_delay_cache.end() && cached->second.net == net_info &&
+            cached->second.route_version == net_info->route_version) {
+            max_delay = std::max(max_delay, cached->second.delay);
+            continue;
+        }
+
         WireId cursor = dst_wire;
         delay_t delay = 0;
 
@@ -144,10 +176,16 @@ delay_t Context::getNetinfoRouteDelay(const NetInfo *net_info, const PortRef &us
             cursor = getPipSrcWire(pip);
         }
 
-        if (cursor == src_wire)
-            max_delay = std::max(max_delay, delay + getWireDelay(src_wire).maxDelay()); // routed
-        else
-            max_delay = std::max(max_delay, predictArcDelay(net_info, user_info)); // unrouted
+        if (cursor == src_wire) {
+            // routed; only fully-routed arcs are cached as the prediction
+            // fallback below depends on placement, not routing
+            delay += getWireDelay(src_wire).maxDelay();
+            if (update_cache)
+                route_delay_cache[cache_key] = RouteDelayCacheEntry{net_info, net_info->route_version, delay};
+            max_delay = std::max(max_delay, delay);
+        } else {
+            max_delay = std::max(max_delay, predictArcDelay(net_info, user_info, update_cache)); // unrouted
+        }
     }
     return max_delay;
 }
@@ -256,6 +294,49 @@ uint32_t Context::checksum() const
     return cksum;
 }
 
+uint32_t Context::fingerprint() const
+{
+    // Per-net routing hashes are cached against route_version so that between
+    // passes only the nets the router actually touched are re-hashed; the
+    // XOR fold over nets and cells is order-independent, so the result does
+    // not depend on container iteration order
+    uint32_t nets_xor = 0;
+    for (auto &it : nets) {
+        auto &ni = *it.second;
+        auto cached = fingerprint_cache.find(&ni);
+        if (cached != fingerprint_cache.end() && cached->second.name == ni.name &&
+            cached->second.route_version == ni.route_version) {
+            nets_xor ^= cached->second.hash;
+            continue;
+        }
+        uint32_t x = 123456789;
+        x = xorshift32(x + xorshift32(ni.name.index));
+        uint32_t wire_x_sum = 0;
+        for (auto &w : ni.wires) {
+            uint32_t wire_x = 123456789;
+            wire_x = xorshift32(wire_x + xorshift32(getWireChecksum(w.first)));
+            wire_x = xorshift32(wire_x + xorshift32(getPipChecksum(w.second.pip)));
+            wire_x = xorshift32(wire_x + xorshift32(int(w.second.strength)));
+            wire_x_sum += wire_x;
+        }
+        x = xorshift32(x + xorshift32(wire_x_sum));
+        fingerprint_cache[&ni] = FingerprintCacheEntry{ni.name, ni.route_version, x};
+        nets_xor ^= x;
+    }
+
+    uint32_t cells_xor = 0;
+    for (auto &it : cells) {
+        auto &ci = *it.second;
+        uint32_t x = 123456789;
+        x = xorshift32(x + xorshift32(ci.name.index));
+        x = xorshift32(x + xorshift32(getBelChecksum(ci.bel)));
+        x = xorshift32(x + xorshift32(ci.belStrength));
+        cells_xor ^= x;
+    }
+
+    return xorshift32(xorshift32(123456789 + xorshift32(nets_xor)) + xorshift32(cells_xor));
+}
+
 void Context::check() const
 {
     bool check_failed = false;
@@ -28,7 +28,11 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
-struct Context : Arch, DeterministicRNG
+// 'final' so that arch API calls made through a Context pointer — in
+// particular the getPipsDownhill/getPipDelay calls in the router expansion
+// loops — can be devirtualized and inlined: each nextpnr binary is built
+// against exactly one concrete Arch, and nothing derives from Context
+struct Context final : Arch, DeterministicRNG
 {
     bool verbose = false;
     bool debug = false;
@@ -38,6 +42,9 @@ struct Context : Arch, DeterministicRNG
     bool disable_critical_path_source_print = false;
     // True when detailed per-net timing is to be stored / reported
     bool detailed_timing_report = false;
+    // Number of worst timing paths to enumerate into the JSON report (0
+    // disables path enumeration)
+    int report_timing_paths = 0;
 
     ArchArgs arch_args;
 
@@ -45,6 +52,8 @@ struct Context : Arch, DeterministicRNG
     {
         BaseCtx::as_ctx = this;
         arch_args = args;
+        // Must stay a power of two; see predictArcDelay
+        arc_prediction_cache.resize(8192);
     }
 
     ArchArgs getArchArgs() { return arch_args; }
@@ -52,12 +61,50 @@ struct Context : Arch, DeterministicRNG
     // --------------------------------------------------------------
 
     delay_t predictArcDelay(const NetInfo *net_info, const PortRef &sink) const;
+    // With update_cache false the prediction cache is only probed, never
+    // written, making concurrent calls from multiple threads safe
+    delay_t predictArcDelay(const NetInfo *net_info, const PortRef &sink, bool update_cache) const;
+
+    // Direct-mapped cache for predictArcDelay. Timing-driven placement asks
+    // for the same arc predictions over and over (every move attempt re-costs
+    // the arcs of the nets it touches), and most of the per-call work is
+    // resolving the prediction bel pins rather than the arch's delay model.
+    // The entry records everything the prediction depends on, so a hit can
+    // never be stale, and the fixed-size table keeps memory bounded as
+    // placement churns through bel combinations. Written from
+    // single-threaded code only
+    struct ArcPredictionCacheEntry
+    {
+        const NetInfo *net;
+        const CellInfo *driver_cell;
+        IdString driver_port;
+        const CellInfo *sink_cell;
+        IdString sink_port;
+        BelId src_bel, dst_bel;
+        delay_t delay;
+    };
+    mutable std::vector<ArcPredictionCacheEntry> arc_prediction_cache;
 
     WireId getNetinfoSourceWire(const NetInfo *net_info) const;
     SSOArray<WireId, 2> getNetinfoSinkWires(const NetInfo *net_info, const PortRef &sink) const;
     size_t getNetinfoSinkWireCount(const NetInfo *net_info, const PortRef &sink) const;
     WireId getNetinfoSinkWire(const NetInfo *net_info, const PortRef &sink, size_t phys_idx) const;
     delay_t getNetinfoRouteDelay(const NetInfo *net_info, const PortRef &sink) const;
+    // With update_cache false the route delay cache is only probed, never
+    // written, making concurrent calls from multiple threads safe
+    delay_t getNetinfoRouteDelay(const NetInfo *net_info, const PortRef &sink, bool update_cache) const;
+
+    // Cache of routed-path delays for getNetinfoRouteDelay, keyed by
+    // (source wire, sink wire) and validated against the owning net's
+    // route_version so entries for untouched nets survive across routing
+    // iterations. Only used from single-threaded analysis code.
+    struct RouteDelayCacheEntry
+    {
+        const NetInfo *net;
+        uint64_t route_version;
+        delay_t delay;
+    };
+    mutable dict<std::pair<WireId, WireId>, RouteDelayCacheEntry> route_delay_cache;
 
     // provided by router1.cc
     bool checkRoutedDesign() const;
@@ -86,6 +133,26 @@ struct Context : Arch, DeterministicRNG
 
     uint32_t checksum() const;
 
+    // Cheap design fingerprint covering net identity, placement and routing,
+    // for per-pass determinism checks and stale-checkpoint detection. Unlike
+    // checksum() (a full structural hash, too slow to call per pass on big
+    // designs) this only re-hashes the wires of nets whose route_version
+    // changed since the previous call; placement is O(cells) per call.
+    // Connectivity (users/drivers) is deliberately not covered — use
+    // checksum() when the netlist itself may have changed
+    uint32_t fingerprint() const;
+
+    // Per-net routing hash cache for fingerprint(), validated against
+    // route_version like route_delay_cache. Single-threaded use only
+    struct FingerprintCacheEntry
+    {
+        // Guards against a new net reusing a deleted net's allocation
+        IdString name;
+        uint64_t route_version;
+        uint32_t hash;
+    };
+    mutable dict<const NetInfo *, FingerprintCacheEntry, hash_ptr_ops> fingerprint_cache;
+
     void check() const;
     void archcheck() const;
 
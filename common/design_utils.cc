@@ -53,6 +53,7 @@ void replace_port(CellInfo *old_cell, IdString old_name, CellInfo *rep_cell, IdS
                 if (load.cell == old_cell && load.port == old_name) {
                     load.cell = rep_cell;
                     load.port = rep_name;
+                    break;
                 }
             }
         }
@@ -113,17 +114,76 @@ void disconnect_port(const Context *ctx, CellInfo *cell, IdString port_name)
         return;
     PortInfo &port = cell->ports.at(port_name);
     if (port.net != nullptr) {
-        port.net->users.erase(std::remove_if(port.net->users.begin(), port.net->users.end(),
-                                             [cell, port_name](const PortRef &user) {
-                                                 return user.cell == cell && user.port == port_name;
-                                             }),
-                              port.net->users.end());
+        // A port appears at most once in a net's user list (connect_port
+        // asserts the port is free first), so stop at the first match and
+        // swap-and-pop instead of shifting the tail of what may be a very
+        // high-fanout list
+        auto &users = port.net->users;
+        auto it = std::find_if(users.begin(), users.end(), [cell, port_name](const PortRef &user) {
+            return user.cell == cell && user.port == port_name;
+        });
+        if (it != users.end()) {
+            *it = users.back();
+            users.pop_back();
+        }
         if (port.net->driver.cell == cell && port.net->driver.port == port_name)
             port.net->driver.cell = nullptr;
         port.net = nullptr;
     }
 }
 
+void PortRewireBatch::disconnect(CellInfo *cell, IdString port) { reconnect(cell, port, nullptr); }
+
+void PortRewireBatch::reconnect(CellInfo *cell, IdString port, NetInfo *new_net)
+{
+    moves[std::make_pair(cell, port)] = new_net;
+}
+
+void PortRewireBatch::commit()
+{
+    pool<NetInfo *, hash_ptr_ops> dirty;
+    for (auto &move : moves) {
+        CellInfo *cell = move.first.first;
+        IdString port_name = move.first.second;
+        if (!cell->ports.count(port_name))
+            continue;
+        PortInfo &port = cell->ports.at(port_name);
+        NetInfo *new_net = move.second;
+        if (port.net == new_net)
+            continue;
+        if (port.net != nullptr) {
+            if (port.net->driver.cell == cell && port.net->driver.port == port_name)
+                port.net->driver.cell = nullptr;
+            if (port.type != PORT_OUT) {
+                // Stale user entries are swept out in one pass per net below
+                dirty.insert(port.net);
+            }
+        }
+        port.net = new_net;
+        if (new_net != nullptr) {
+            if (port.type == PORT_OUT) {
+                NPNR_ASSERT(new_net->driver.cell == nullptr);
+                new_net->driver.cell = cell;
+                new_net->driver.port = port_name;
+            } else {
+                PortRef user;
+                user.cell = cell;
+                user.port = port_name;
+                new_net->users.push_back(user);
+            }
+        }
+    }
+    // Keep only the user entries whose cell port still points back at the net
+    for (NetInfo *net : dirty) {
+        net->users.erase(std::remove_if(net->users.begin(), net->users.end(),
+                                        [net](const PortRef &user) {
+                                            return user.cell->ports.at(user.port).net != net;
+                                        }),
+                         net->users.end());
+    }
+    moves.clear();
+}
+
 void connect_ports(Context *ctx, CellInfo *cell1, IdString port1_name, CellInfo *cell2, IdString port2_name)
 {
     PortInfo &port1 = cell1->ports.at(port1_name);
@@ -148,8 +208,10 @@ void rename_port(Context *ctx, CellInfo *cell, IdString old_name, IdString new_n
         if (pi.net->driver.cell == cell && pi.net->driver.port == old_name)
             pi.net->driver.port = new_name;
         for (auto &usr : pi.net->users)
-            if (usr.cell == cell && usr.port == old_name)
+            if (usr.cell == cell && usr.port == old_name) {
                 usr.port = new_name;
+                break;
+            }
     }
     cell->ports.erase(old_name);
     pi.name = new_name;
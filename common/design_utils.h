@@ -95,6 +95,60 @@ void connect_port(const Context *ctx, NetInfo *net, CellInfo *cell, IdString por
 // Disconnect a net from a port
 void disconnect_port(const Context *ctx, CellInfo *cell, IdString port_name);
 
+// Move the users of old_net satisfying a predicate onto new_net, rebuilding
+// old_net's user list in a single pass. Equivalent to disconnect_port plus
+// connect_port per load, but without the O(fanout) users scan each call
+template <typename F1> void move_net_users(NetInfo *old_net, NetInfo *new_net, F1 should_move)
+{
+    std::vector<PortRef> keep_users;
+    keep_users.reserve(old_net->users.size());
+    for (auto &user : old_net->users) {
+        if (should_move(user)) {
+            user.cell->ports.at(user.port).net = new_net;
+            new_net->users.push_back(user);
+        } else {
+            keep_users.push_back(user);
+        }
+    }
+    std::swap(old_net->users, keep_users);
+}
+
+// Batches up port disconnects and reconnects so that each affected net's
+// user list is rebuilt once on commit(), rather than scanned per port as
+// disconnect_port does. Use this for bulk rewrites that repeatedly touch
+// high-fanout nets (e.g. tying many pins off a constant net); nothing is
+// modified until commit() is called
+struct PortRewireBatch
+{
+    explicit PortRewireBatch(Context *ctx) : ctx(ctx){};
+
+    // Queue disconnecting 'port' on 'cell' from its current net, if any
+    void disconnect(CellInfo *cell, IdString port);
+    // Queue moving 'port' on 'cell' from its current net to 'new_net'
+    // (which may be nullptr for a plain disconnect). A later call for the
+    // same (cell, port) overrides an earlier one
+    void reconnect(CellInfo *cell, IdString port, NetInfo *new_net);
+    // Apply all queued moves and reset the batch for reuse
+    void commit();
+
+  private:
+    struct move_key_ops
+    {
+        static inline bool cmp(const std::pair<CellInfo *, IdString> &a, const std::pair<CellInfo *, IdString> &b)
+        {
+            return a == b;
+        }
+        static inline unsigned int hash(const std::pair<CellInfo *, IdString> &a)
+        {
+            return mkhash(hash_ptr_ops::hash(a.first), a.second.hash());
+        }
+    };
+
+    Context *ctx;
+    // Target net per (cell, port); insertion order is the apply order
+    dict<std::pair<CellInfo *, IdString>, NetInfo *, move_key_ops> moves;
+};
+
 // Connect two ports together
 void connect_ports(Context *ctx, CellInfo *cell1, IdString port1_name, CellInfo *cell2, IdString port2_name);
 
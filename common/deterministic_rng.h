@@ -98,6 +98,57 @@ struct DeterministicRNG
     }
 };
 
+// Counter-based RNG for deterministic parallelism. Every output is a pure
+// function of (seed, counter): unlike DeterministicRNG, whose shared
+// rngstate serialises all consumers, parallel workers can each derive the
+// randomness for their (iteration, move index) independently, and two runs
+// with the same seed agree regardless of thread count or scheduling.
+struct CounterRNG
+{
+    uint64_t key;
+
+    CounterRNG() : key(0x3141592653589793) {}
+    explicit CounterRNG(uint64_t seed) : key(seed ? seed : 0x3141592653589793) {}
+
+    // splitmix64 finalizer; bijective, so distinct inputs never collide
+    static uint64_t mix64(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EB;
+        x ^= x >> 31;
+        return x;
+    }
+
+    // counter'th output of this key's stream (splitmix64 sequence)
+    uint64_t rng64(uint64_t counter) const { return mix64(key + (counter + 1) * 0x9E3779B97F4A7C15); }
+
+    // Bounded draw without a rejection loop (fixed-point multiply); the
+    // result distribution differs from DeterministicRNG::rng(n) but is
+    // equally deterministic
+    int rng(uint64_t counter, int n) const
+    {
+        assert(n > 0);
+        return int((uint64_t(uint32_t(rng64(counter))) * uint64_t(n)) >> 32);
+    }
+
+    // Derive an independent sub-generator, e.g. one per SA iteration; chain
+    // with rng64/stream for per-move randomness that is a pure function of
+    // (seed, iteration, move index)
+    CounterRNG fork(uint64_t index) const { return CounterRNG(rng64(index)); }
+
+    // Full DeterministicRNG view of one counter's stream, for consumers that
+    // need an unbounded number of draws per move (shuffle, rejection
+    // sampling)
+    DeterministicRNG stream(uint64_t counter) const
+    {
+        DeterministicRNG rng;
+        rng.rngseed(rng64(counter));
+        return rng;
+    }
+};
+
 NEXTPNR_NAMESPACE_END
 
 #endif
@@ -38,6 +38,23 @@ EmbeddedFile *EmbeddedFile::head = nullptr;
 
 const void *get_chipdb(const std::string &filename)
 {
+    // Optional runtime override: memory-map the chipdb from the directory
+    // named by NEXTPNR_CHIPDB_DIR instead of using the linked-in copy. The
+    // database is then paged in on demand, startup doesn't touch the parts
+    // of it that are never used, and concurrent processes share one
+    // physical copy via the page cache.
+    static std::map<std::string, boost::iostreams::mapped_file> mapped_files;
+    const char *chipdb_dir = ::getenv("NEXTPNR_CHIPDB_DIR");
+    if (chipdb_dir != nullptr) {
+        if (!mapped_files.count(filename)) {
+            std::string full_filename = std::string(chipdb_dir) + "/" + filename;
+            if (boost::filesystem::exists(full_filename))
+                mapped_files[filename].open(full_filename, boost::iostreams::mapped_file::priv);
+        }
+        auto fnd = mapped_files.find(filename);
+        if (fnd != mapped_files.end() && fnd->second.is_open())
+            return fnd->second.data();
+    }
     for (EmbeddedFile *file = EmbeddedFile::head; file; file = file->next)
         if (file->filename == filename)
             return file->content;
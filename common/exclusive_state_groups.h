@@ -34,6 +34,46 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
+// Set of currently-selected states within a group. Every current
+// architecture uses only a handful of states per group (the interchange
+// arch caps at 8), so groups of up to 64 states store a plain one-hot
+// uint64_t mask where membership tests, population count and
+// find-first-set compile to single instructions; these operations sit on
+// the placer's per-probe validity check path. Larger groups fall back to
+// std::bitset.
+template <size_t StateCount, bool kFitsInWord = (StateCount <= 64)> struct SelectedStateSet;
+
+template <size_t StateCount> struct SelectedStateSet<StateCount, true>
+{
+    uint64_t mask = 0;
+
+    bool operator[](size_t i) const { return (mask >> i) & 1; }
+    void set(size_t i) { mask |= uint64_t(1) << i; }
+    void reset(size_t i) { mask &= ~(uint64_t(1) << i); }
+    int count() const { return Bits::popcount64(mask); }
+    // First selected state; the set must be non-empty
+    int first() const { return Bits::ctz64(mask); }
+};
+
+template <size_t StateCount> struct SelectedStateSet<StateCount, false>
+{
+    std::bitset<StateCount> bits;
+
+    bool operator[](size_t i) const { return bits[i]; }
+    void set(size_t i) { bits[i] = true; }
+    void reset(size_t i) { bits[i] = false; }
+    int count() const { return int(bits.count()); }
+    int first() const
+    {
+        for (size_t i = 0; i < StateCount; ++i) {
+            if (bits[i]) {
+                return int(i);
+            }
+        }
+        NPNR_ASSERT_FALSE("first() called on empty state set");
+    }
+};
+
 // Implementation for exclusive state groups, used to implement generic
 // constraint system.
 template <size_t StateCount, typename StateType = int8_t, typename CountType = uint8_t> struct ExclusiveStateGroup
@@ -49,7 +89,7 @@ template <size_t StateCount, typename StateType = int8_t, typename CountType = u
     static_assert(StateCount < std::numeric_limits<StateType>::max(), "StateType cannot store max StateType");
     static_assert(std::numeric_limits<StateType>::is_signed, "StateType must be signed");
 
-    std::bitset<StateCount> selected_states;
+    SelectedStateSet<StateCount> selected_states;
     StateType state;
     std::array<CountType, StateCount> count;
 
@@ -79,7 +119,7 @@ template <size_t StateCount, typename StateType = int8_t, typename CountType = u
 
         // Increment and mark the state as selected.
         count[next_state] += 1;
-        selected_states[next_state] = true;
+        selected_states.set(next_state);
 
         if (state == next_state) {
             // State was already selected, state group is still satified.
@@ -107,14 +147,13 @@ template <size_t StateCount, typename StateType = int8_t, typename CountType = u
         // Check if next_state is now unselected.
         if (count[next_state] == 0) {
             // next_state is not longer selected
-            selected_states[next_state] = false;
+            selected_states.reset(next_state);
 
             // Check whether the state group is now unselected or satified.
-            auto value = selected_states.to_ulong();
-            auto number_selected = Bits::popcount(value);
+            int number_selected = selected_states.count();
             if (number_selected == 1) {
                 // Group is no longer overconstrained.
-                state = Bits::ctz(value);
+                state = selected_states.first();
                 NPNR_ASSERT(selected_states[state]);
             } else if (number_selected == 0) {
                 // Group is unselected.
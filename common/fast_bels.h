@@ -20,8 +20,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <functional>
 #include "nextpnr.h"
+#include "quadtree.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
@@ -40,108 +43,182 @@ struct FastBels
     {
     }
 
-    void addCellType(IdString cell_type)
+    // Index a batch of cell types with a single scan of the device. Startup
+    // classification used to cost one full bel walk (with its location and
+    // availability lookups) per type; batching amortises the walk so only
+    // the per-(bel, type) validity checks scale with the number of types.
+    // Types already indexed are skipped, and the per-type bel order matches
+    // what repeated addCellType calls would have produced.
+    void addCellTypes(const pool<IdString> &req_types)
     {
-        auto iter = cell_types.find(cell_type);
-        if (iter != cell_types.end()) {
-            // This cell type has already been added to the fast BEL lookup.
+        std::vector<IdString> types;
+        for (IdString cell_type : req_types)
+            if (!cell_types.count(cell_type))
+                types.push_back(cell_type);
+        if (types.empty())
             return;
-        }
-
-        size_t type_idx = cell_types.size();
-        auto &cell_type_data = cell_types[cell_type];
-        cell_type_data.type_index = type_idx;
-
-        fast_bels_by_cell_type.resize(type_idx + 1);
-        auto &bel_data = fast_bels_by_cell_type.at(type_idx);
-        NPNR_ASSERT(bel_data.get() == nullptr);
-        bel_data = std::make_unique<FastBelsData>();
 
+        std::vector<int> possible(types.size(), 0);
+        std::vector<int> max_x(types.size(), 0), max_y(types.size(), 0);
+        std::vector<std::vector<std::pair<BelId, Loc>>> usable(types.size());
         for (auto bel : ctx->getBels()) {
-            if (!ctx->isValidBelForCellType(cell_type, bel)) {
-                continue;
+            bool have_loc = false, have_avail = false, avail = true;
+            Loc loc;
+            for (size_t t = 0; t < types.size(); t++) {
+                if (!ctx->isValidBelForCellType(types.at(t), bel))
+                    continue;
+                if (!have_loc) {
+                    loc = ctx->getBelLocation(bel);
+                    have_loc = true;
+                }
+                possible.at(t) += 1;
+                max_x.at(t) = std::max(max_x.at(t), loc.x);
+                max_y.at(t) = std::max(max_y.at(t), loc.y);
+                if (!have_avail) {
+                    avail = !check_bel_available || ctx->checkBelAvail(bel);
+                    have_avail = true;
+                }
+                if (avail)
+                    usable.at(t).emplace_back(bel, loc);
             }
-
-            cell_type_data.number_of_possible_bels += 1;
         }
 
-        for (auto bel : ctx->getBels()) {
-            if (check_bel_available && !ctx->checkBelAvail(bel)) {
-                continue;
-            }
-
-            if (!ctx->isValidBelForCellType(cell_type, bel)) {
-                continue;
-            }
-
-            Loc loc = ctx->getBelLocation(bel);
-            if (minBelsForGridPick >= 0 && cell_type_data.number_of_possible_bels < minBelsForGridPick) {
-                loc.x = loc.y = 0;
-            }
-
-            if (int(bel_data->size()) < (loc.x + 1)) {
-                bel_data->resize(loc.x + 1);
+        for (size_t t = 0; t < types.size(); t++) {
+            size_t type_idx = cell_types.size();
+            auto &cell_type_data = cell_types[types.at(t)];
+            cell_type_data.type_index = type_idx;
+            cell_type_data.number_of_possible_bels = possible.at(t);
+
+            fast_bels_by_cell_type.resize(type_idx + 1);
+            auto &bel_data = fast_bels_by_cell_type.at(type_idx);
+            NPNR_ASSERT(bel_data.get() == nullptr);
+            bel_data = std::make_unique<FastBelsData>();
+
+            // Spatial index over the same bel set as the grid, but always at
+            // the bels' true locations (the grid may collapse scarce types
+            // to (0, 0))
+            bel_qt_by_cell_type.resize(type_idx + 1);
+            auto &bel_qt = bel_qt_by_cell_type.at(type_idx);
+            if (cell_type_data.number_of_possible_bels > 0)
+                bel_qt = std::make_unique<BelQuadTree>(BelQuadTree::BoundingBox(0, 0, max_x.at(t), max_y.at(t)));
+
+            for (auto &entry : usable.at(t)) {
+                Loc loc = entry.second;
+                NPNR_ASSERT(bel_qt->insert(BelQuadTree::BoundingBox(loc.x, loc.y, loc.x, loc.y), entry.first));
+                if (minBelsForGridPick >= 0 && cell_type_data.number_of_possible_bels < minBelsForGridPick) {
+                    loc.x = loc.y = 0;
+                }
+
+                if (int(bel_data->size()) < (loc.x + 1)) {
+                    bel_data->resize(loc.x + 1);
+                }
+
+                if (int(bel_data->at(loc.x).size()) < (loc.y + 1)) {
+                    bel_data->at(loc.x).resize(loc.y + 1);
+                }
+
+                bel_data->at(loc.x).at(loc.y).push_back(entry.first);
             }
-
-            if (int(bel_data->at(loc.x).size()) < (loc.y + 1)) {
-                bel_data->at(loc.x).resize(loc.y + 1);
-            }
-
-            bel_data->at(loc.x).at(loc.y).push_back(bel);
         }
     }
 
-    void addBelBucket(BelBucketId partition)
+    void addCellType(IdString cell_type)
     {
-        auto iter = partition_types.find(partition);
-        if (iter != partition_types.end()) {
-            // This partition has already been added to the fast BEL lookup.
-            return;
-        }
-
-        size_t type_idx = partition_types.size();
-        auto &type_data = partition_types[partition];
-        type_data.type_index = type_idx;
+        pool<IdString> types;
+        types.insert(cell_type);
+        addCellTypes(types);
+    }
 
-        fast_bels_by_partition_type.resize(type_idx + 1);
-        auto &bel_data = fast_bels_by_partition_type.at(type_idx);
-        NPNR_ASSERT(bel_data.get() == nullptr);
-        bel_data = std::make_unique<FastBelsData>();
+    // As addCellTypes, for bel buckets: one scan, with getBelBucketForBel
+    // asked once per bel rather than once per (bel, bucket)
+    void addBelBuckets(const pool<BelBucketId> &req_buckets)
+    {
+        std::vector<BelBucketId> buckets;
+        dict<BelBucketId, size_t> bucket_pos;
+        for (BelBucketId bucket : req_buckets)
+            if (!partition_types.count(bucket) && !bucket_pos.count(bucket)) {
+                bucket_pos[bucket] = buckets.size();
+                buckets.push_back(bucket);
+            }
+        if (buckets.empty())
+            return;
 
+        std::vector<int> possible(buckets.size(), 0);
+        std::vector<std::vector<std::pair<BelId, Loc>>> usable(buckets.size());
         for (auto bel : ctx->getBels()) {
-            if (ctx->getBelBucketForBel(bel) != partition) {
+            auto fnd = bucket_pos.find(ctx->getBelBucketForBel(bel));
+            if (fnd == bucket_pos.end())
                 continue;
-            }
-
-            type_data.number_of_possible_bels += 1;
+            possible.at(fnd->second) += 1;
+            if (check_bel_available && !ctx->checkBelAvail(bel))
+                continue;
+            usable.at(fnd->second).emplace_back(bel, ctx->getBelLocation(bel));
         }
 
-        for (auto bel : ctx->getBels()) {
-            if (check_bel_available && !ctx->checkBelAvail(bel)) {
-                continue;
-            }
+        for (size_t t = 0; t < buckets.size(); t++) {
+            size_t type_idx = partition_types.size();
+            auto &type_data = partition_types[buckets.at(t)];
+            type_data.type_index = type_idx;
+            type_data.number_of_possible_bels = possible.at(t);
 
-            if (ctx->getBelBucketForBel(bel) != partition) {
-                continue;
-            }
+            fast_bels_by_partition_type.resize(type_idx + 1);
+            auto &bel_data = fast_bels_by_partition_type.at(type_idx);
+            NPNR_ASSERT(bel_data.get() == nullptr);
+            bel_data = std::make_unique<FastBelsData>();
 
-            Loc loc = ctx->getBelLocation(bel);
-            if (minBelsForGridPick >= 0 && type_data.number_of_possible_bels < minBelsForGridPick) {
-                loc.x = loc.y = 0;
-            }
+            for (auto &entry : usable.at(t)) {
+                Loc loc = entry.second;
+                if (minBelsForGridPick >= 0 && type_data.number_of_possible_bels < minBelsForGridPick) {
+                    loc.x = loc.y = 0;
+                }
 
-            if (int(bel_data->size()) < (loc.x + 1)) {
-                bel_data->resize(loc.x + 1);
-            }
+                if (int(bel_data->size()) < (loc.x + 1)) {
+                    bel_data->resize(loc.x + 1);
+                }
 
-            if (int(bel_data->at(loc.x).size()) < (loc.y + 1)) {
-                bel_data->at(loc.x).resize(loc.y + 1);
+                if (int(bel_data->at(loc.x).size()) < (loc.y + 1)) {
+                    bel_data->at(loc.x).resize(loc.y + 1);
+                }
+
+                bel_data->at(loc.x).at(loc.y).push_back(entry.first);
             }
+        }
+    }
+
+    void addBelBucket(BelBucketId partition)
+    {
+        pool<BelBucketId> buckets;
+        buckets.insert(partition);
+        addBelBuckets(buckets);
+    }
 
-            bel_data->at(loc.x).at(loc.y).push_back(bel);
+    // Register the subset of a region's bels usable by a cell type, so that
+    // cells constrained to the region can draw placement candidates directly
+    // from the precomputed list instead of rejection-sampling region
+    // membership out of the whole-device grid (which rejects nearly every
+    // pick for regions that are sparse or non-rectangular). Register all
+    // (region, type) pairs up front at placer setup; lookups afterwards are
+    // read-only and safe from worker threads.
+    void addRegionCellType(const Region *region, IdString cell_type)
+    {
+        auto key = std::make_pair(region->name, cell_type);
+        if (region_bels_by_type.count(key))
+            return;
+        auto &bels = region_bels_by_type[key];
+        for (auto bel : region->bels) {
+            if (check_bel_available && !ctx->checkBelAvail(bel))
+                continue;
+            if (!ctx->isValidBelForCellType(cell_type, bel))
+                continue;
+            bels.push_back(bel);
         }
     }
 
+    const std::vector<BelId> &getRegionBels(const Region *region, IdString cell_type) const
+    {
+        return region_bels_by_type.at(std::make_pair(region->name, cell_type));
+    }
+
     typedef std::vector<std::vector<std::vector<BelId>>> FastBelsData;
 
     int getBelsForCellType(IdString cell_type, FastBelsData **data)
@@ -174,15 +251,56 @@ struct FastBels
         return type_data.number_of_possible_bels;
     }
 
+    // Collect all bels of the given cell type in the inclusive rectangle
+    // (x0, y0)-(x1, y1), appending them to 'out'. Backed by the per-type
+    // quadtree, so the cost scales with the number of matching bels rather
+    // than the area of the rectangle.
+    void getBelsInBox(IdString cell_type, int x0, int y0, int x1, int y1, std::vector<BelId> &out)
+    {
+        FastBelsData *data;
+        getBelsForCellType(cell_type, &data);
+        auto &bel_qt = bel_qt_by_cell_type.at(cell_types.at(cell_type).type_index);
+        if (!bel_qt)
+            return;
+        bel_qt->get_in_box(BelQuadTree::BoundingBox(x0, y0, x1, y1), out);
+    }
+
+    // Find the free bel of the given cell type nearest to 'origin', using a
+    // branch-and-bound quadtree search. Availability comes straight from the
+    // arch's bound-bel bookkeeping (checkBelAvail), which bindBel/unbindBel
+    // already keep up to date, so no separate free list has to be maintained
+    // in sync with the placer. An optional predicate further filters
+    // candidates (e.g. region constraints). Returns BelId() if no acceptable
+    // free bel exists. Search order is deterministic.
+    BelId findNearestFreeBel(IdString cell_type, Loc origin, const std::function<bool(BelId)> &accept = {})
+    {
+        FastBelsData *data;
+        getBelsForCellType(cell_type, &data);
+        auto &bel_qt = bel_qt_by_cell_type.at(cell_types.at(cell_type).type_index);
+        if (!bel_qt)
+            return BelId();
+        BelId result;
+        if (!bel_qt->nearest(origin.x, origin.y, result, [&](const BelId &bel) {
+                return ctx->checkBelAvail(bel) && (!accept || accept(bel));
+            }))
+            return BelId();
+        return result;
+    }
+
     Context *ctx;
     const bool check_bel_available;
     const int minBelsForGridPick;
 
+    typedef QuadTree<int, BelId> BelQuadTree;
+
     dict<IdString, TypeData> cell_types;
     std::vector<std::unique_ptr<FastBelsData>> fast_bels_by_cell_type;
+    std::vector<std::unique_ptr<BelQuadTree>> bel_qt_by_cell_type;
 
     dict<BelBucketId, TypeData> partition_types;
     std::vector<std::unique_ptr<FastBelsData>> fast_bels_by_partition_type;
+
+    dict<std::pair<IdString, IdString>, std::vector<BelId>> region_bels_by_type;
 };
 
 NEXTPNR_NAMESPACE_END
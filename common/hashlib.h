@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -23,6 +24,11 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
+// Implemented in profiler.cc; credits container storage growth to the
+// per-pass memory attribution in the JSON report (declared here rather
+// than via profiler.h to keep this widely-included header light)
+void profiler_note_hashlib_bytes(uint64_t bytes);
+
 const int hashtable_size_trigger = 2;
 const int hashtable_size_factor = 3;
 
@@ -206,10 +212,14 @@ inline int hashtable_size(int min_size)
 template <typename K, typename T, typename OPS = hash_ops<K>> class dict;
 template <typename K, int offset = 0, typename OPS = hash_ops<K>> class idict;
 template <typename K, typename OPS = hash_ops<K>> class pool;
+template <typename K, typename T, int N = 4, typename OPS = hash_ops<K>> class small_dict;
+template <typename K, int N = 4, typename OPS = hash_ops<K>> class small_pool;
 template <typename K, typename OPS = hash_ops<K>> class mfp;
 
 template <typename K, typename T, typename OPS> class dict
 {
+    template <typename, typename, int, typename> friend class small_dict;
+
     struct entry_t
     {
         std::pair<K, T> udata;
@@ -239,10 +249,23 @@ template <typename K, typename T, typename OPS> class dict
         return hash;
     }
 
+    // entries.emplace_back with growth accounting for the per-pass memory
+    // attribution; capacity only ever grows, so the delta is the new storage
+    template <typename... Args> void do_emplace_entry(Args &&...args)
+    {
+        size_t cap = entries.capacity();
+        entries.emplace_back(std::forward<Args>(args)...);
+        if (entries.capacity() != cap)
+            profiler_note_hashlib_bytes(uint64_t(entries.capacity() - cap) * sizeof(entry_t));
+    }
+
     void do_rehash()
     {
+        size_t old_cap = hashtable.capacity();
         hashtable.clear();
         hashtable.resize(hashtable_size(entries.capacity() * hashtable_size_factor), -1);
+        if (hashtable.capacity() > old_cap)
+            profiler_note_hashlib_bytes(uint64_t(hashtable.capacity() - old_cap) * sizeof(int));
 
         for (int i = 0; i < int(entries.size()); i++) {
             do_assert(-1 <= entries[i].next && entries[i].next < int(entries.size()));
@@ -323,11 +346,11 @@ template <typename K, typename T, typename OPS> class dict
     int do_insert(const K &key, int &hash)
     {
         if (hashtable.empty()) {
-            entries.emplace_back(std::pair<K, T>(key, T()), -1);
+            do_emplace_entry(std::pair<K, T>(key, T()), -1);
             do_rehash();
             hash = do_hash(key);
         } else {
-            entries.emplace_back(std::pair<K, T>(key, T()), hashtable[hash]);
+            do_emplace_entry(std::pair<K, T>(key, T()), hashtable[hash]);
             hashtable[hash] = entries.size() - 1;
         }
         return entries.size() - 1;
@@ -336,11 +359,11 @@ template <typename K, typename T, typename OPS> class dict
     int do_insert(const std::pair<K, T> &value, int &hash)
     {
         if (hashtable.empty()) {
-            entries.emplace_back(value, -1);
+            do_emplace_entry(value, -1);
             do_rehash();
             hash = do_hash(value.first);
         } else {
-            entries.emplace_back(value, hashtable[hash]);
+            do_emplace_entry(value, hashtable[hash]);
             hashtable[hash] = entries.size() - 1;
         }
         return entries.size() - 1;
@@ -350,11 +373,11 @@ template <typename K, typename T, typename OPS> class dict
     {
         if (hashtable.empty()) {
             auto key = rvalue.first;
-            entries.emplace_back(std::forward<std::pair<K, T>>(rvalue), -1);
+            do_emplace_entry(std::forward<std::pair<K, T>>(rvalue), -1);
             do_rehash();
             hash = do_hash(key);
         } else {
-            entries.emplace_back(std::forward<std::pair<K, T>>(rvalue), hashtable[hash]);
+            do_emplace_entry(std::forward<std::pair<K, T>>(rvalue), hashtable[hash]);
             hashtable[hash] = entries.size() - 1;
         }
         return entries.size() - 1;
@@ -368,6 +391,7 @@ template <typename K, typename T, typename OPS> class dict
     class const_iterator : public std::iterator<std::forward_iterator_tag, std::pair<K, T>>
     {
         friend class dict;
+        template <typename, typename, int, typename> friend class small_dict;
 
       protected:
         const dict *ptr;
@@ -396,6 +420,7 @@ template <typename K, typename T, typename OPS> class dict
     class iterator : public std::iterator<std::forward_iterator_tag, std::pair<K, T>>
     {
         friend class dict;
+        template <typename, typename, int, typename> friend class small_dict;
 
       protected:
         dict *ptr;
@@ -652,6 +677,14 @@ template <typename K, typename T, typename OPS> class dict
     }
 
     void reserve(size_t n) { entries.reserve(n); }
+    // Drop the growth slack: entry storage is trimmed to the live element
+    // count and the hash table rebuilt to match. Useful once a dict is known
+    // to have stopped changing (e.g. cell ports after packing)
+    void shrink_to_fit()
+    {
+        entries.shrink_to_fit();
+        do_rehash();
+    }
     size_t size() const { return entries.size(); }
     bool empty() const { return entries.empty(); }
     void clear()
@@ -672,6 +705,7 @@ template <typename K, typename T, typename OPS> class dict
 template <typename K, typename OPS> class pool
 {
     template <typename, int, typename> friend class idict;
+    template <typename, int, typename> friend class small_pool;
 
   protected:
     struct entry_t
@@ -702,10 +736,23 @@ template <typename K, typename OPS> class pool
         return hash;
     }
 
+    // entries.emplace_back with growth accounting for the per-pass memory
+    // attribution; capacity only ever grows, so the delta is the new storage
+    template <typename... Args> void do_emplace_entry(Args &&...args)
+    {
+        size_t cap = entries.capacity();
+        entries.emplace_back(std::forward<Args>(args)...);
+        if (entries.capacity() != cap)
+            profiler_note_hashlib_bytes(uint64_t(entries.capacity() - cap) * sizeof(entry_t));
+    }
+
     void do_rehash()
     {
+        size_t old_cap = hashtable.capacity();
         hashtable.clear();
         hashtable.resize(hashtable_size(entries.capacity() * hashtable_size_factor), -1);
+        if (hashtable.capacity() > old_cap)
+            profiler_note_hashlib_bytes(uint64_t(hashtable.capacity() - old_cap) * sizeof(int));
 
         for (int i = 0; i < int(entries.size()); i++) {
             do_assert(-1 <= entries[i].next && entries[i].next < int(entries.size()));
@@ -782,11 +829,11 @@ template <typename K, typename OPS> class pool
     int do_insert(const K &value, int &hash)
     {
         if (hashtable.empty()) {
-            entries.emplace_back(value, -1);
+            do_emplace_entry(value, -1);
             do_rehash();
             hash = do_hash(value);
         } else {
-            entries.emplace_back(value, hashtable[hash]);
+            do_emplace_entry(value, hashtable[hash]);
             hashtable[hash] = entries.size() - 1;
         }
         return entries.size() - 1;
@@ -795,11 +842,11 @@ template <typename K, typename OPS> class pool
     int do_insert(K &&rvalue, int &hash)
     {
         if (hashtable.empty()) {
-            entries.emplace_back(std::forward<K>(rvalue), -1);
+            do_emplace_entry(std::forward<K>(rvalue), -1);
             do_rehash();
             hash = do_hash(rvalue);
         } else {
-            entries.emplace_back(std::forward<K>(rvalue), hashtable[hash]);
+            do_emplace_entry(std::forward<K>(rvalue), hashtable[hash]);
             hashtable[hash] = entries.size() - 1;
         }
         return entries.size() - 1;
@@ -809,6 +856,7 @@ template <typename K, typename OPS> class pool
     class const_iterator : public std::iterator<std::forward_iterator_tag, K>
     {
         friend class pool;
+        template <typename, int, typename> friend class small_pool;
 
       protected:
         const pool *ptr;
@@ -831,6 +879,7 @@ template <typename K, typename OPS> class pool
     class iterator : public std::iterator<std::forward_iterator_tag, K>
     {
         friend class pool;
+        template <typename, int, typename> friend class small_pool;
 
       protected:
         pool *ptr;
@@ -1028,6 +1077,359 @@ template <typename K, typename OPS> class pool
     const_iterator end() const { return const_iterator(nullptr, -1); }
 };
 
+// Small-table variants of dict/pool: the first N entries are stored in-place
+// and searched linearly, which beats hashing at these sizes and avoids the
+// heap entirely; tables that outgrow N spill all entries into the regular
+// heap-backed container and stay there. Intended for hot paths (router,
+// timing) that churn through millions of tables holding only a few entries.
+template <typename K, typename T, int N, typename OPS> class small_dict
+{
+    static_assert(N > 0, "small_dict inline capacity must be positive");
+
+    std::array<std::pair<K, T>, N> inline_data;
+    int inline_size = 0; // -1 once spilled to the heap dict
+    dict<K, T, OPS> spill;
+    OPS ops;
+
+    bool spilled() const { return inline_size < 0; }
+
+    void do_spill()
+    {
+        for (int i = 0; i < inline_size; i++)
+            spill.insert(std::move(inline_data[i]));
+        inline_size = -1;
+    }
+
+    int do_find(const K &key) const
+    {
+        for (int i = 0; i < inline_size; i++)
+            if (ops.cmp(inline_data[i].first, key))
+                return i;
+        return -1;
+    }
+
+  public:
+    using key_type = K;
+    using mapped_type = T;
+    using value_type = std::pair<K, T>;
+
+    class const_iterator : public std::iterator<std::forward_iterator_tag, std::pair<K, T>>
+    {
+        friend class small_dict;
+
+      protected:
+        const small_dict *ptr;
+        int index;
+        const_iterator(const small_dict *ptr, int index) : ptr(ptr), index(index) {}
+
+      public:
+        const_iterator() {}
+        const_iterator operator++()
+        {
+            index++;
+            return *this;
+        }
+        bool operator==(const const_iterator &other) const { return index == other.index; }
+        bool operator!=(const const_iterator &other) const { return index != other.index; }
+        const std::pair<K, T> &operator*() const
+        {
+            return ptr->spilled() ? *ptr->spill.element(index) : ptr->inline_data[index];
+        }
+        const std::pair<K, T> *operator->() const { return &operator*(); }
+    };
+
+    class iterator : public std::iterator<std::forward_iterator_tag, std::pair<K, T>>
+    {
+        friend class small_dict;
+
+      protected:
+        small_dict *ptr;
+        int index;
+        iterator(small_dict *ptr, int index) : ptr(ptr), index(index) {}
+
+      public:
+        iterator() {}
+        iterator operator++()
+        {
+            index++;
+            return *this;
+        }
+        bool operator==(const iterator &other) const { return index == other.index; }
+        bool operator!=(const iterator &other) const { return index != other.index; }
+        std::pair<K, T> &operator*() { return ptr->spilled() ? *ptr->spill.element(index) : ptr->inline_data[index]; }
+        std::pair<K, T> *operator->() { return &operator*(); }
+        const std::pair<K, T> &operator*() const
+        {
+            return ptr->spilled() ? *ptr->spill.element(index) : ptr->inline_data[index];
+        }
+        const std::pair<K, T> *operator->() const { return &operator*(); }
+        operator const_iterator() const { return const_iterator(ptr, index); }
+    };
+
+    small_dict() {}
+
+    std::pair<iterator, bool> insert(const std::pair<K, T> &value)
+    {
+        if (!spilled()) {
+            int i = do_find(value.first);
+            if (i >= 0)
+                return std::pair<iterator, bool>(iterator(this, i), false);
+            if (inline_size < N) {
+                inline_data[inline_size] = value;
+                return std::pair<iterator, bool>(iterator(this, inline_size++), true);
+            }
+            do_spill();
+        }
+        auto r = spill.insert(value);
+        return std::pair<iterator, bool>(iterator(this, int(spill.size()) - 1 - r.first.index), r.second);
+    }
+
+    std::pair<iterator, bool> emplace(K const &key, T const &value) { return insert(std::make_pair(key, value)); }
+
+    int erase(const K &key)
+    {
+        if (spilled())
+            return spill.erase(key);
+        int i = do_find(key);
+        if (i < 0)
+            return 0;
+        // Same swap-with-back scheme the heap containers use
+        if (i != inline_size - 1)
+            inline_data[i] = std::move(inline_data[inline_size - 1]);
+        inline_size--;
+        return 1;
+    }
+
+    int count(const K &key) const
+    {
+        if (spilled())
+            return spill.count(key);
+        return do_find(key) < 0 ? 0 : 1;
+    }
+
+    iterator find(const K &key)
+    {
+        if (spilled()) {
+            auto it = spill.find(key);
+            if (it == spill.end())
+                return end();
+            return iterator(this, int(spill.size()) - 1 - it.index);
+        }
+        int i = do_find(key);
+        if (i < 0)
+            return end();
+        return iterator(this, i);
+    }
+
+    const_iterator find(const K &key) const
+    {
+        if (spilled()) {
+            auto it = spill.find(key);
+            if (it == spill.end())
+                return end();
+            return const_iterator(this, int(spill.size()) - 1 - it.index);
+        }
+        int i = do_find(key);
+        if (i < 0)
+            return end();
+        return const_iterator(this, i);
+    }
+
+    T &at(const K &key)
+    {
+        if (spilled())
+            return spill.at(key);
+        int i = do_find(key);
+        if (i < 0)
+            throw std::out_of_range("small_dict::at()");
+        return inline_data[i].second;
+    }
+
+    const T &at(const K &key) const
+    {
+        if (spilled())
+            return spill.at(key);
+        int i = do_find(key);
+        if (i < 0)
+            throw std::out_of_range("small_dict::at()");
+        return inline_data[i].second;
+    }
+
+    const T &at(const K &key, const T &defval) const
+    {
+        if (spilled())
+            return spill.at(key, defval);
+        int i = do_find(key);
+        if (i < 0)
+            return defval;
+        return inline_data[i].second;
+    }
+
+    T &operator[](const K &key)
+    {
+        if (!spilled()) {
+            int i = do_find(key);
+            if (i >= 0)
+                return inline_data[i].second;
+            if (inline_size < N) {
+                inline_data[inline_size] = std::pair<K, T>(key, T());
+                return inline_data[inline_size++].second;
+            }
+            do_spill();
+        }
+        return spill[key];
+    }
+
+    void swap(small_dict &other)
+    {
+        std::swap(inline_data, other.inline_data);
+        std::swap(inline_size, other.inline_size);
+        spill.swap(other.spill);
+    }
+
+    size_t size() const { return spilled() ? spill.size() : size_t(inline_size); }
+    bool empty() const { return size() == 0; }
+    void clear()
+    {
+        inline_size = 0;
+        spill.clear();
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, int(size())); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, int(size())); }
+};
+
+template <typename K, int N, typename OPS> class small_pool
+{
+    static_assert(N > 0, "small_pool inline capacity must be positive");
+
+    std::array<K, N> inline_data;
+    int inline_size = 0; // -1 once spilled to the heap pool
+    pool<K, OPS> spill;
+    OPS ops;
+
+    bool spilled() const { return inline_size < 0; }
+
+    void do_spill()
+    {
+        for (int i = 0; i < inline_size; i++)
+            spill.insert(std::move(inline_data[i]));
+        inline_size = -1;
+    }
+
+    int do_find(const K &key) const
+    {
+        for (int i = 0; i < inline_size; i++)
+            if (ops.cmp(inline_data[i], key))
+                return i;
+        return -1;
+    }
+
+  public:
+    class const_iterator : public std::iterator<std::forward_iterator_tag, K>
+    {
+        friend class small_pool;
+
+      protected:
+        const small_pool *ptr;
+        int index;
+        const_iterator(const small_pool *ptr, int index) : ptr(ptr), index(index) {}
+
+      public:
+        const_iterator() {}
+        const_iterator operator++()
+        {
+            index++;
+            return *this;
+        }
+        bool operator==(const const_iterator &other) const { return index == other.index; }
+        bool operator!=(const const_iterator &other) const { return index != other.index; }
+        const K &operator*() const { return ptr->spilled() ? *ptr->spill.element(index) : ptr->inline_data[index]; }
+        const K *operator->() const { return &operator*(); }
+    };
+
+    small_pool() {}
+
+    std::pair<const_iterator, bool> insert(const K &value)
+    {
+        if (!spilled()) {
+            int i = do_find(value);
+            if (i >= 0)
+                return std::pair<const_iterator, bool>(const_iterator(this, i), false);
+            if (inline_size < N) {
+                inline_data[inline_size] = value;
+                return std::pair<const_iterator, bool>(const_iterator(this, inline_size++), true);
+            }
+            do_spill();
+        }
+        auto r = spill.insert(value);
+        return std::pair<const_iterator, bool>(const_iterator(this, int(spill.size()) - 1 - r.first.index), r.second);
+    }
+
+    template <typename... Args> std::pair<const_iterator, bool> emplace(Args &&...args)
+    {
+        return insert(K(std::forward<Args>(args)...));
+    }
+
+    int erase(const K &key)
+    {
+        if (spilled())
+            return spill.erase(key);
+        int i = do_find(key);
+        if (i < 0)
+            return 0;
+        // Same swap-with-back scheme the heap containers use
+        if (i != inline_size - 1)
+            inline_data[i] = std::move(inline_data[inline_size - 1]);
+        inline_size--;
+        return 1;
+    }
+
+    int count(const K &key) const
+    {
+        if (spilled())
+            return spill.count(key);
+        return do_find(key) < 0 ? 0 : 1;
+    }
+
+    const_iterator find(const K &key) const
+    {
+        if (spilled()) {
+            auto it = spill.find(key);
+            if (it == spill.end())
+                return end();
+            return const_iterator(this, int(spill.size()) - 1 - it.index);
+        }
+        int i = do_find(key);
+        if (i < 0)
+            return end();
+        return const_iterator(this, i);
+    }
+
+    bool operator[](const K &key) const { return count(key) > 0; }
+
+    void swap(small_pool &other)
+    {
+        std::swap(inline_data, other.inline_data);
+        std::swap(inline_size, other.inline_size);
+        spill.swap(other.spill);
+    }
+
+    size_t size() const { return spilled() ? spill.size() : size_t(inline_size); }
+    bool empty() const { return size() == 0; }
+    void clear()
+    {
+        inline_size = 0;
+        spill.clear();
+    }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, int(size())); }
+};
+
 template <typename K, int offset, typename OPS> class idict
 {
     pool<K, OPS> database;
@@ -24,28 +24,80 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
-void IdString::set(const BaseCtx *ctx, const std::string &s)
+IdStringDB::IdStringDB() : next_index(0)
 {
-    auto it = ctx->idstring_str_to_idx->find(s);
-    if (it == ctx->idstring_str_to_idx->end()) {
-        index = ctx->idstring_idx_to_str->size();
-        auto insert_rc = ctx->idstring_str_to_idx->insert({s, index});
-        ctx->idstring_idx_to_str->push_back(&insert_rc.first->first);
-    } else {
-        index = it->second;
-    }
+    for (auto &chunk : chunks)
+        chunk.store(nullptr, std::memory_order_relaxed);
 }
 
-const std::string &IdString::str(const BaseCtx *ctx) const { return *ctx->idstring_idx_to_str->at(index); }
+IdStringDB::~IdStringDB()
+{
+    for (auto &chunk : chunks)
+        delete[] chunk.load(std::memory_order_relaxed);
+}
 
-const char *IdString::c_str(const BaseCtx *ctx) const { return str(ctx).c_str(); }
+int IdStringDB::intern(const std::string &s)
+{
+    Shard &shard = shard_for(s);
+    // Fast path: the name is already interned, so a shared lock suffices and
+    // lookups on different shards (or concurrent lookups on the same shard)
+    // do not serialize
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+        auto it = shard.str_to_idx.find(s);
+        if (it != shard.str_to_idx.end())
+            return it->second;
+    }
+    std::unique_lock<std::shared_timed_mutex> lock(shard.mutex);
+    // Re-check; another thread may have interned the name between the locks
+    auto it = shard.str_to_idx.find(s);
+    if (it != shard.str_to_idx.end())
+        return it->second;
+    auto insert_rc = shard.str_to_idx.emplace(s, 0);
+    int index;
+    {
+        std::lock_guard<std::mutex> append_lock(append_mutex);
+        index = next_index.load(std::memory_order_relaxed);
+        NPNR_ASSERT(index < (num_chunks << chunk_bits));
+        auto *chunk = chunks.at(index >> chunk_bits).load(std::memory_order_relaxed);
+        if (chunk == nullptr) {
+            chunk = new std::atomic<const std::string *>[size_t(1) << chunk_bits];
+            chunks.at(index >> chunk_bits).store(chunk, std::memory_order_release);
+        }
+        chunk[index & chunk_mask].store(&insert_rc.first->first, std::memory_order_release);
+        next_index.store(index + 1, std::memory_order_release);
+    }
+    insert_rc.first->second = index;
+    return index;
+}
 
-void IdString::initialize_add(const BaseCtx *ctx, const char *s, int idx)
+void IdStringDB::reserve(int expected_new_names)
 {
-    NPNR_ASSERT(ctx->idstring_str_to_idx->count(s) == 0);
-    NPNR_ASSERT(int(ctx->idstring_idx_to_str->size()) == idx);
-    auto insert_rc = ctx->idstring_str_to_idx->insert({s, idx});
-    ctx->idstring_idx_to_str->push_back(&insert_rc.first->first);
+    if (expected_new_names <= 0)
+        return;
+    // Names hash roughly uniformly across the shards; reserve a little extra
+    // per shard so an uneven split still avoids rehashing
+    size_t per_shard = size_t(expected_new_names) / num_shards;
+    per_shard += per_shard / 4 + 1;
+    for (auto &shard : shards) {
+        std::unique_lock<std::shared_timed_mutex> lock(shard.mutex);
+        shard.str_to_idx.reserve(shard.str_to_idx.size() + per_shard);
+    }
 }
 
+void IdStringDB::initialize_add(const char *s, int idx)
+{
+    NPNR_ASSERT(idx == size());
+    int got = intern(s);
+    NPNR_ASSERT(got == idx);
+}
+
+void IdString::set(const BaseCtx *ctx, const std::string &s) { index = ctx->idstring_db->intern(s); }
+
+const std::string &IdString::str(const BaseCtx *ctx) const { return ctx->idstring_db->str(index); }
+
+const char *IdString::c_str(const BaseCtx *ctx) const { return str(ctx).c_str(); }
+
+void IdString::initialize_add(const BaseCtx *ctx, const char *s, int idx) { ctx->idstring_db->initialize_add(s, idx); }
+
 NEXTPNR_NAMESPACE_END
@@ -0,0 +1,96 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2018  Claire Xenia Wolf <claire@yosyshq.com>
+ *  Copyright (C) 2018  Serge Bazanski <q3k@q3k.org>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef IDSTRINGDB_H
+#define IDSTRINGDB_H
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Interning database behind IdString. Resolving an index back to its string
+// is lock-free, and looking up an already-interned name only takes a shared
+// lock on one of 16 shards, so parallel passes can call ctx->id() without
+// serializing against each other; only the insertion of a new name takes an
+// exclusive lock. Note that the order in which *new* names receive indices
+// depends on thread interleaving, so passes that rely on deterministic index
+// comparisons must intern any names they create serially (as the
+// single-threaded frontends do), typically by pre-interning before fanning
+// out work.
+struct IdStringDB
+{
+    IdStringDB();
+    ~IdStringDB();
+    IdStringDB(const IdStringDB &) = delete;
+    IdStringDB &operator=(const IdStringDB &) = delete;
+
+    // Return the index for a name, interning it if not already present
+    int intern(const std::string &s);
+    // Add a string with a fixed index at setup time (constids); indices must
+    // be added in order
+    void initialize_add(const char *s, int idx);
+    // Pre-size the intern tables for an expected number of new names, so a
+    // bulk import (e.g. a frontend that knows its symbol count up front)
+    // inserts without intermediate rehashing
+    void reserve(int expected_new_names);
+
+    const std::string &str(int idx) const
+    {
+        auto *chunk = chunks.at(idx >> chunk_bits).load(std::memory_order_acquire);
+        return *chunk[idx & chunk_mask].load(std::memory_order_acquire);
+    }
+
+    int size() const { return next_index.load(std::memory_order_acquire); }
+
+  private:
+    // Index-to-string lookup is a two-level table of fixed-size chunks so
+    // that concurrent readers never observe a reallocation
+    static constexpr int chunk_bits = 16;
+    static constexpr int chunk_mask = (1 << chunk_bits) - 1;
+    static constexpr int num_chunks = 4096;
+    static constexpr int num_shards = 16;
+
+    struct Shard
+    {
+        std::shared_timed_mutex mutex;
+        // Map values own the string storage; the chunk table points at the
+        // keys, which are stable across rehashing
+        std::unordered_map<std::string, int> str_to_idx;
+    };
+
+    Shard &shard_for(const std::string &s) { return shards[std::hash<std::string>()(s) & (num_shards - 1)]; }
+
+    std::array<std::atomic<std::atomic<const std::string *> *>, num_chunks> chunks;
+    std::atomic<int> next_index;
+    // Serialises index allocation and chunk table appends across shards
+    std::mutex append_mutex;
+    std::array<Shard, num_shards> shards;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif /* IDSTRINGDB_H */
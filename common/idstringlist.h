@@ -33,7 +33,11 @@ struct Context;
 
 struct IdStringList
 {
-    SSOArray<IdString, 4> ids;
+    // Inline capacity covers the longest hierarchical names the arches build
+    // per query (5 components for Nexus pips), so name construction and
+    // by-name lookups don't touch the heap. 6 rather than 5 because the
+    // size field's alignment pads the union to the same footprint either way
+    SSOArray<IdString, 6> ids;
 
     IdStringList() : ids(1, IdString()){};
     explicit IdStringList(size_t n) : ids(n, IdString()){};
@@ -84,8 +84,26 @@ std::string vstringf(const char *fmt, va_list ap)
     return string;
 }
 
+// True when no stream and no write callback would consume a message of this
+// level; lets the callers skip the vsnprintf entirely. Quiet batch runs
+// route everything below the warning level nowhere, so without this check
+// the hot placer and router progress messages are formatted just to be
+// thrown away
+static bool log_discarded(LogLevel level)
+{
+    if (log_write_function)
+        return false;
+    for (auto f : log_streams)
+        if (f.second <= level)
+            return false;
+    return true;
+}
+
 void logv(const char *format, va_list ap, LogLevel level = LogLevel::LOG_MSG)
 {
+    if (log_discarded(level))
+        return;
+
     //
     // Trim newlines from the beginning
     while (format[0] == '\n' && format[1] != 0) {
@@ -122,6 +140,12 @@ void log_with_level(LogLevel level, const char *format, ...)
 
 void logv_prefixed(const char *prefix, const char *format, va_list ap, LogLevel level)
 {
+    if (log_discarded(level)) {
+        // Keep the per-level counts the footer reports accurate
+        message_count_by_level[level]++;
+        return;
+    }
+
     std::string message = vstringf(format, ap);
 
     log_with_level(level, "%s%s", prefix, message.c_str());
@@ -138,26 +162,40 @@ void log_always(const char *format, ...)
 
 void log(const char *format, ...)
 {
+#if NPNR_MIN_LOGLEVEL > 0
+    (void)format;
+#else
     va_list ap;
     va_start(ap, format);
     logv(format, ap, LogLevel::LOG_MSG);
     va_end(ap);
+#endif
 }
 
 void log_info(const char *format, ...)
 {
+#if NPNR_MIN_LOGLEVEL > 1
+    (void)format;
+    message_count_by_level[LogLevel::INFO_MSG]++;
+#else
     va_list ap;
     va_start(ap, format);
     logv_prefixed("Info: ", format, ap, LogLevel::INFO_MSG);
     va_end(ap);
+#endif
 }
 
 void log_warning(const char *format, ...)
 {
+#if NPNR_MIN_LOGLEVEL > 2
+    (void)format;
+    message_count_by_level[LogLevel::WARNING_MSG]++;
+#else
     va_list ap;
     va_start(ap, format);
     logv_prefixed("Warning: ", format, ap, LogLevel::WARNING_MSG);
     va_end(ap);
+#endif
 }
 
 void log_error(const char *format, ...)
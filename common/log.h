@@ -51,6 +51,14 @@ enum class LogLevel
     ALWAYS_MSG
 };
 
+// Compile-time log floor: building with -DNPNR_MIN_LOGLEVEL=n (or the
+// MIN_LOGLEVEL cmake setting) strips messages below that level (0 log,
+// 1 info, 2 warning) before any formatting happens, for batch environments
+// where even the discarded-message check is unwanted overhead
+#ifndef NPNR_MIN_LOGLEVEL
+#define NPNR_MIN_LOGLEVEL 0
+#endif
+
 struct loglevel_hash_ops
 {
     static inline bool cmp(LogLevel a, LogLevel b) { return a == b; }
@@ -0,0 +1,88 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef LUT_MAPPING_CACHE_H
+#define LUT_MAPPING_CACHE_H
+
+#include <array>
+#include "hashlib.h"
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Memoized LUT init-value rewrites. Synthesized netlists repeat a small
+// number of distinct (init, input mapping) combinations across thousands of
+// LUT cells, so after the first few cells the rewrites below become lookups
+// rather than 2^k-entry truth table walks. One instance is intended to live
+// for the duration of a pass such as packing or bitstream generation.
+struct LutMappingCache
+{
+    // Init value after rewiring the inputs of a LUT of 'width' inputs, where
+    // phys_to_log[i] is the bitmask of logical inputs driven by physical
+    // input i. Bit p of the result is the init bit at the logical address
+    // formed by OR-ing the masks of the physical inputs set in p; for a
+    // plain permutation every mask has exactly one bit set
+    uint64_t permuted_init(int width, uint64_t init, const std::array<uint8_t, 8> &phys_to_log)
+    {
+        uint64_t packed_map = 0;
+        for (int i = 0; i < width; i++)
+            packed_map |= uint64_t(phys_to_log[i]) << (8 * i);
+        std::tuple<int, uint64_t, uint64_t> key(width, init, packed_map);
+        auto fnd = permuted.find(key);
+        if (fnd != permuted.end())
+            return fnd->second;
+        uint64_t result = 0;
+        for (int i = 0; i < (1 << width); i++) {
+            int log_idx = 0;
+            for (int j = 0; j < width; j++)
+                if ((i >> j) & 0x1)
+                    log_idx |= phys_to_log[j];
+            if ((init >> log_idx) & 0x1)
+                result |= uint64_t(1) << i;
+        }
+        permuted.emplace(key, result);
+        return result;
+    }
+
+    // Init value after tying logical input 'input' to a constant. The input
+    // stays in place so the truth table keeps its width, matching the
+    // packers' in-place INIT rewrites for constant-driven pins
+    uint64_t constant_input_init(int width, uint64_t init, int input, bool value)
+    {
+        std::tuple<int, uint64_t, int> key(width, init, input * 2 + int(value));
+        auto fnd = constant_folded.find(key);
+        if (fnd != constant_folded.end())
+            return fnd->second;
+        uint64_t result = 0;
+        for (int i = 0; i < (1 << width); i++) {
+            int src = (i & ~(1 << input)) | ((value ? 1 : 0) << input);
+            if ((init >> src) & 0x1)
+                result |= uint64_t(1) << i;
+        }
+        constant_folded.emplace(key, result);
+        return result;
+    }
+
+    dict<std::tuple<int, uint64_t, uint64_t>, uint64_t> permuted;
+    dict<std::tuple<int, uint64_t, int>, uint64_t> constant_folded;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
@@ -0,0 +1,260 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "netlist_fold.h"
+#include <algorithm>
+#include <tuple>
+#include <vector>
+#include "design_utils.h"
+#include "log.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+
+struct NetlistFolder
+{
+    Context *ctx;
+    // Nets attached to top-level ports; they can never be deleted
+    pool<IdString> port_nets;
+    // The $nextpnr_ibuf/obuf/iobuf cells behind top-level ports; they carry
+    // the port itself and are never folded
+    pool<IdString> port_cells;
+    // Removals are queued while iterating ctx->cells and applied per round
+    std::vector<IdString> remove_cells, remove_nets;
+
+    explicit NetlistFolder(Context *ctx) : ctx(ctx)
+    {
+        for (auto &port : ctx->ports)
+            if (port.second.net != nullptr)
+                port_nets.insert(port.second.net->name);
+        for (auto &pc : ctx->port_cells)
+            port_cells.insert(pc.second->name);
+    }
+
+    bool cell_foldable(const CellInfo *ci) const
+    {
+        if (ci->bel != BelId() || ci->cluster != ClusterId())
+            return false;
+        if (port_cells.count(ci->name))
+            return false;
+        // Respect synthesis-level preservation attributes
+        if (ci->attrs.count(ctx->id("keep")) || ci->attrs.count(ctx->id("dont_touch")))
+            return false;
+        return true;
+    }
+
+    // The single connected output of a cell, or nullptr if the cell doesn't
+    // have exactly one (or has a connected inout)
+    const PortInfo *single_output(const CellInfo *ci) const
+    {
+        const PortInfo *out = nullptr;
+        for (auto &port : ci->ports) {
+            if (port.second.net == nullptr)
+                continue;
+            if (port.second.type == PORT_INOUT)
+                return nullptr;
+            if (port.second.type != PORT_OUT)
+                continue;
+            if (out != nullptr)
+                return nullptr;
+            out = &port.second;
+        }
+        return out;
+    }
+
+    bool has_connected_input(const CellInfo *ci) const
+    {
+        for (auto &port : ci->ports)
+            if (port.second.type == PORT_IN && port.second.net != nullptr)
+                return true;
+        return false;
+    }
+
+    // Whether 'net' may be folded away into another net. Port nets can't be
+    // removed, and nets carrying a clock constraint or region assignment
+    // encode user intent the pass doesn't second-guess
+    bool net_mergeable(const NetInfo *net) const
+    {
+        return !port_nets.count(net->name) && net->clkconstr == nullptr && net->region == nullptr;
+    }
+
+    // Move everything hanging off 'from' onto 'to' and queue 'from' for
+    // removal. The removed net's name and aliases are repointed at the
+    // survivor, so getNetByAlias (and constraints applied by name) keep
+    // resolving after the fold
+    void merge_nets(NetInfo *to, NetInfo *from)
+    {
+        move_net_users(from, to, [](const PortRef &) { return true; });
+        for (auto &attr : from->attrs)
+            if (!to->attrs.count(attr.first))
+                to->attrs[attr.first] = attr.second;
+        for (auto alias : from->aliases) {
+            ctx->net_aliases[alias] = to->name;
+            to->aliases.push_back(alias);
+        }
+        ctx->net_aliases[from->name] = to->name;
+        to->aliases.push_back(from->name);
+        remove_nets.push_back(from->name);
+    }
+
+    void flush_removals()
+    {
+        for (auto cell : remove_cells)
+            ctx->cells.erase(cell);
+        for (auto net : remove_nets)
+            ctx->nets.erase(net);
+        remove_cells.clear();
+        remove_nets.clear();
+    }
+
+    // The frontend creates one VCC/GND driver cell per constant bit use, so
+    // constant trees arrive as many single-user nets; collapse each polarity
+    // onto the first driver's net
+    int sweep_constants()
+    {
+        int merged = 0;
+        for (IdString ctype : {ctx->id("VCC"), ctx->id("GND")}) {
+            NetInfo *canonical = nullptr;
+            for (auto &cell : ctx->cells) {
+                CellInfo *ci = cell.second.get();
+                if (ci->type != ctype || !cell_foldable(ci))
+                    continue;
+                const PortInfo *out = single_output(ci);
+                // Only the canonical output-only constant driver shape
+                if (out == nullptr || out->net == nullptr || has_connected_input(ci))
+                    continue;
+                if (canonical == nullptr) {
+                    canonical = out->net;
+                    continue;
+                }
+                if (!net_mergeable(out->net))
+                    continue;
+                merge_nets(canonical, out->net);
+                remove_cells.push_back(ci->name);
+                ++merged;
+            }
+            flush_removals();
+        }
+        return merged;
+    }
+
+    // Connectivity signature of a cell: every port with its direction and
+    // net, the identity of the single output's net masked out so duplicates
+    // driving different nets compare equal
+    using PortSig = std::vector<std::tuple<int, int, int>>;
+    PortSig port_signature(const CellInfo *ci, const PortInfo *out) const
+    {
+        PortSig sig;
+        sig.reserve(ci->ports.size());
+        for (auto &port : ci->ports)
+            sig.emplace_back(port.first.index, int(port.second.type),
+                             &port.second == out ? -2 : (port.second.net ? port.second.net->name.index : -1));
+        std::sort(sig.begin(), sig.end());
+        return sig;
+    }
+
+    // One round of structural deduplication: cells of the same type with the
+    // same parameters and all ports tied to the same nets compute the same
+    // value, so all but one can be removed and their fanout merged. Cells
+    // with no connected input are never merged here: without knowing the
+    // cell's function we can't tell a redundant constant from e.g. two
+    // oscillator instances (constants are handled by sweep_constants)
+    int dedup_round()
+    {
+        int merged = 0;
+        struct Candidate
+        {
+            CellInfo *cell;
+            const PortInfo *out;
+            PortSig sig;
+        };
+        dict<unsigned, std::vector<Candidate>> buckets;
+        PortRewireBatch rewire(ctx);
+        for (auto &cell : ctx->cells) {
+            CellInfo *ci = cell.second.get();
+            if (!cell_foldable(ci) || !has_connected_input(ci))
+                continue;
+            const PortInfo *out = single_output(ci);
+            if (out == nullptr || out->net == nullptr || out->net->driver.cell != ci)
+                continue;
+            PortSig sig = port_signature(ci, out);
+            unsigned h = mkhash(mkhash_init, unsigned(ci->type.index));
+            for (auto &entry : sig) {
+                h = mkhash(h, unsigned(std::get<0>(entry)));
+                h = mkhash(h, unsigned(std::get<1>(entry)));
+                h = mkhash(h, unsigned(std::get<2>(entry)));
+            }
+            auto &bucket = buckets[h];
+            const Candidate *rep = nullptr;
+            for (auto &cand : bucket) {
+                if (cand.cell->type != ci->type || cand.sig != sig || cand.cell->params != ci->params)
+                    continue;
+                rep = &cand;
+                break;
+            }
+            if (rep == nullptr || !net_mergeable(out->net)) {
+                // First of its kind, or a duplicate whose net must survive:
+                // keep it as (a) representative
+                bucket.push_back(Candidate{ci, out, std::move(sig)});
+                continue;
+            }
+            merge_nets(rep->out->net, out->net);
+            for (auto &port : ci->ports)
+                if (port.second.type == PORT_IN && port.second.net != nullptr)
+                    rewire.disconnect(ci, port.first);
+            remove_cells.push_back(ci->name);
+            ++merged;
+        }
+        rewire.commit();
+        flush_removals();
+        return merged;
+    }
+
+    void run()
+    {
+        int start_cells = int(ctx->cells.size()), start_nets = int(ctx->nets.size());
+        int const_merged = sweep_constants();
+        // Merging two cells makes their fanouts identical, which can expose
+        // further duplicates, so iterate to a fixed point
+        int deduped = 0;
+        while (true) {
+            int round = dedup_round();
+            if (round == 0)
+                break;
+            deduped += round;
+        }
+        log_info("Folded netlist: merged %d constant driver%s, deduplicated %d cell%s (%d cells, %d nets remain).\n",
+                 const_merged, const_merged == 1 ? "" : "s", deduped, deduped == 1 ? "" : "s", int(ctx->cells.size()),
+                 int(ctx->nets.size()));
+        NPNR_ASSERT(start_cells - int(ctx->cells.size()) == const_merged + deduped);
+        NPNR_ASSERT(start_nets - int(ctx->nets.size()) == const_merged + deduped);
+    }
+};
+
+} // namespace
+
+void fold_netlist(Context *ctx)
+{
+    log_info("Folding netlist...\n");
+    NetlistFolder folder(ctx);
+    folder.run();
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,40 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef NETLIST_FOLD_H
+#define NETLIST_FOLD_H
+
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Arch-independent netlist folding, run after the frontend and before
+// packing. Collapses the per-use VCC/GND driver cells the frontend creates
+// into one net per constant polarity, and structurally deduplicates cells
+// that compute the same function of the same nets (same type, same
+// parameters, all inputs tied to the same nets, single output) - covering
+// duplicated LUTs and parallel buffers from synthesis. Everything downstream
+// (packing, placement, routing, timing) scales with the cells and nets this
+// removes. Cells that are placed, clustered, keep-attributed or behind
+// top-level ports are never touched.
+void fold_netlist(Context *ctx);
+
+NEXTPNR_NAMESPACE_END
+
+#endif /* NETLIST_FOLD_H */
@@ -19,10 +19,42 @@
 
 #include "nextpnr_types.h"
 
+#include "nextpnr_assertions.h"
 #include "nextpnr_namespaces.h"
+#include "object_arena.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
+namespace {
+// Arenas for the high-churn netlist graph objects. PortRef/PortInfo are
+// stored by value inside their owning net/cell so they need no arena of
+// their own.
+ObjectArena<NetInfo> net_arena;
+ObjectArena<CellInfo> cell_arena;
+ObjectArena<CellColdData> cell_cold_arena;
+} // namespace
+
+void *NetInfo::operator new(std::size_t size)
+{
+    NPNR_ASSERT(size == sizeof(NetInfo));
+    return net_arena.alloc();
+}
+void NetInfo::operator delete(void *ptr) noexcept { net_arena.free(ptr); }
+
+void *CellInfo::operator new(std::size_t size)
+{
+    NPNR_ASSERT(size == sizeof(CellInfo));
+    return cell_arena.alloc();
+}
+void CellInfo::operator delete(void *ptr) noexcept { cell_arena.free(ptr); }
+
+void *CellColdData::operator new(std::size_t size)
+{
+    NPNR_ASSERT(size == sizeof(CellColdData));
+    return cell_cold_arena.alloc();
+}
+void CellColdData::operator delete(void *ptr) noexcept { cell_cold_arena.free(ptr); }
+
 void CellInfo::addInput(IdString name)
 {
     ports[name].name = name;
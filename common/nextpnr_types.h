@@ -94,6 +94,26 @@ struct DelayPair
     {
         return {min_delay - other.min_delay, max_delay - other.max_delay};
     }
+    DelayPair &operator+=(const DelayPair &other)
+    {
+        min_delay += other.min_delay;
+        max_delay += other.max_delay;
+        return *this;
+    }
+    DelayPair &operator-=(const DelayPair &other)
+    {
+        min_delay -= other.min_delay;
+        max_delay -= other.max_delay;
+        return *this;
+    }
+    // Shift both bounds by a scalar delay
+    DelayPair operator+(delay_t other) const { return {min_delay + other, max_delay + other}; }
+    DelayPair operator-(delay_t other) const { return {min_delay - other, max_delay - other}; }
+    bool operator==(const DelayPair &other) const
+    {
+        return min_delay == other.min_delay && max_delay == other.max_delay;
+    }
+    bool operator!=(const DelayPair &other) const { return !(*this == other); }
 };
 
 // four-quadrant, min and max rise and fall delay
@@ -118,6 +138,18 @@ struct DelayQuad
 
     DelayQuad operator+(const DelayQuad &other) const { return {rise + other.rise, fall + other.fall}; }
     DelayQuad operator-(const DelayQuad &other) const { return {rise - other.rise, fall - other.fall}; }
+    DelayQuad &operator+=(const DelayQuad &other)
+    {
+        rise += other.rise;
+        fall += other.fall;
+        return *this;
+    }
+    DelayQuad &operator-=(const DelayQuad &other)
+    {
+        rise -= other.rise;
+        fall -= other.fall;
+        return *this;
+    }
 };
 
 struct ClockConstraint;
@@ -133,12 +165,23 @@ struct NetInfo : ArchNetInfo
 
     // wire -> uphill_pip
     dict<WireId, PipMap> wires;
+    // Incremented whenever 'wires' is modified by a wire/pip (un)bind; used
+    // to validate cached routing-derived data such as route delays
+    uint64_t route_version = 0;
+
+    // Base index of this net's arcs (one per user) in TimingAnalyser's flat
+    // annotation arrays; assigned by TimingAnalyser::setup()
+    int32_t tmg_arc_base = -1;
 
     std::vector<IdString> aliases; // entries in net_aliases that point to this net
 
     std::unique_ptr<ClockConstraint> clkconstr;
 
     Region *region = nullptr;
+
+    // Nets are allocated from a type-specific arena (see object_arena.h)
+    static void *operator new(std::size_t size);
+    static void operator delete(void *ptr) noexcept;
 };
 
 enum PortType
@@ -155,22 +198,47 @@ struct PortInfo
     PortType type;
 };
 
+// Cold per-cell data, only touched by the frontend, packer and bitstream
+// backend; see the CellInfo 'cold' member below
+struct CellColdData
+{
+    dict<IdString, Property> attrs, params;
+
+    // Allocated from a type-specific arena alongside its cell (see
+    // object_arena.h)
+    static void *operator new(std::size_t size);
+    static void operator delete(void *ptr) noexcept;
+};
+
 struct CellInfo : ArchCellInfo
 {
     IdString name, type, hierpath;
     int32_t udata;
 
     dict<IdString, PortInfo> ports;
-    dict<IdString, Property> attrs, params;
 
     BelId bel;
     PlaceStrength belStrength = STRENGTH_NONE;
+    // Mirror of getBelLocation(bel), updated by the arch in bindBel. Bel
+    // locations are static, so this turns the most frequent virtual call in
+    // placement cost functions into a member read. Stale once the cell is
+    // unbound; check bel != BelId() before use
+    Loc loc;
 
     // cell is part of a cluster if != ClusterId
     ClusterId cluster;
 
     Region *region = nullptr;
 
+    // Attribute/parameter storage is split behind a pointer so that the hot
+    // fields above pack into as few cache lines as possible for the placer
+    // and router; the references keep the cell->attrs/cell->params spelling
+    // working everywhere else
+    std::unique_ptr<CellColdData> cold;
+    dict<IdString, Property> &attrs, &params;
+
+    CellInfo() : cold(new CellColdData), attrs(cold->attrs), params(cold->params){};
+
     void addInput(IdString name);
     void addOutput(IdString name);
     void addInout(IdString name);
@@ -181,6 +249,10 @@ struct CellInfo : ArchCellInfo
     void unsetAttr(IdString name);
     // check whether a bel complies with the cell's region constraint
     bool testRegion(BelId bel) const;
+
+    // Cells are allocated from a type-specific arena (see object_arena.h)
+    static void *operator new(std::size_t size);
+    static void operator delete(void *ptr) noexcept;
 };
 
 enum TimingPortClass
@@ -301,6 +373,10 @@ struct TimingResult
     // Cross-domain critical paths
     std::vector<CriticalPath> xclock_paths;
 
+    // N worst paths across all domain pairs, ordered by ascending slack
+    // (only filled when path enumeration is requested)
+    std::vector<CriticalPath> worst_paths;
+
     // Detailed net timing data
     dict<IdString, std::vector<NetSinkTiming>> detailed_net_timings;
 };
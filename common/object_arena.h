@@ -0,0 +1,88 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef OBJECT_ARENA_H
+#define OBJECT_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Implemented in profiler.cc; credits arena chunk growth to the per-pass
+// memory attribution in the JSON report
+void profiler_note_arena_bytes(uint64_t bytes);
+
+// A simple type-specific arena allocator for the netlist graph objects that
+// are created in large numbers (nets, cells). Objects are carved out of
+// fixed-size chunks for allocation locality and to avoid per-object heap
+// overhead; destroyed objects are recycled through a free list, so churn
+// during packing does not grow the arena. Chunks are only returned to the
+// system when the arena itself is destroyed.
+template <typename T> class ObjectArena
+{
+  public:
+    void *alloc()
+    {
+        std::lock_guard<std::mutex> guard(mut);
+        if (free_list != nullptr) {
+            Slot *slot = free_list;
+            free_list = slot->next;
+            return slot;
+        }
+        if (cursor == chunk_size) {
+            chunks.emplace_back(new Slot[chunk_size]);
+            profiler_note_arena_bytes(uint64_t(chunk_size) * sizeof(Slot));
+            cursor = 0;
+        }
+        return &chunks.back()[cursor++];
+    }
+
+    void free(void *ptr)
+    {
+        std::lock_guard<std::mutex> guard(mut);
+        Slot *slot = static_cast<Slot *>(ptr);
+        slot->next = free_list;
+        free_list = slot;
+    }
+
+  private:
+    union Slot {
+        Slot() {}
+        ~Slot() {}
+        alignas(T) unsigned char storage[sizeof(T)];
+        Slot *next;
+    };
+
+    static const size_t chunk_size = 1024;
+
+    std::mutex mut;
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    size_t cursor = chunk_size;
+    Slot *free_list = nullptr;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif // OBJECT_ARENA_H
@@ -41,8 +41,32 @@ wirelen_t get_net_metric(const Context *ctx, const NetInfo *net, MetricType type
                          ctx->getPortTimingClass(driver_cell, net->driver.port, clock_count) != TMG_IGNORE;
     delay_t negative_slack = 0;
     delay_t worst_slack = std::numeric_limits<delay_t>::max();
-    Loc driver_loc = ctx->getBelLocation(driver_cell->bel);
+    Loc driver_loc = driver_cell->loc;
     int xmin = driver_loc.x, xmax = driver_loc.x, ymin = driver_loc.y, ymax = driver_loc.y;
+    // Load coordinates are gathered into small packed buffers and reduced in
+    // a separate pass: the reduction is then a straight-line int16 min/max
+    // loop the compiler can vectorize with whatever SIMD the target has,
+    // with the (unvectorizable) virtual bel location lookups kept out of the
+    // arithmetic. Grid coordinates always fit int16
+    constexpr size_t chunk_size = 64;
+    int16_t xs[chunk_size], ys[chunk_size];
+    size_t chunk_fill = 0;
+    auto reduce_chunk = [&]() {
+        int16_t xlo = std::numeric_limits<int16_t>::max(), xhi = std::numeric_limits<int16_t>::min();
+        int16_t ylo = std::numeric_limits<int16_t>::max(), yhi = std::numeric_limits<int16_t>::min();
+        for (size_t i = 0; i < chunk_fill; i++) {
+            xlo = std::min(xlo, xs[i]);
+            xhi = std::max(xhi, xs[i]);
+            ylo = std::min(ylo, ys[i]);
+            yhi = std::max(yhi, ys[i]);
+        }
+        // Empty chunks leave the box untouched (the sentinels are no-ops)
+        xmin = std::min(xmin, int(xlo));
+        xmax = std::max(xmax, int(xhi));
+        ymin = std::min(ymin, int(ylo));
+        ymax = std::max(ymax, int(yhi));
+        chunk_fill = 0;
+    };
     for (auto load : net->users) {
         if (load.cell == nullptr)
             continue;
@@ -59,13 +83,14 @@ wirelen_t get_net_metric(const Context *ctx, const NetInfo *net, MetricType type
 
         if (ctx->getBelGlobalBuf(load_cell->bel))
             continue;
-        Loc load_loc = ctx->getBelLocation(load_cell->bel);
+        Loc load_loc = load_cell->loc;
 
-        xmin = std::min(xmin, load_loc.x);
-        ymin = std::min(ymin, load_loc.y);
-        xmax = std::max(xmax, load_loc.x);
-        ymax = std::max(ymax, load_loc.y);
+        xs[chunk_fill] = int16_t(load_loc.x);
+        ys[chunk_fill] = int16_t(load_loc.y);
+        if (++chunk_fill == chunk_size)
+            reduce_chunk();
     }
+    reduce_chunk();
     if (timing_driven) {
         wirelength = wirelen_t(
                 (((ymax - ymin) + (xmax - xmin)) * std::min(5.0, (1.0 + std::exp(-ctx->getDelayNS(worst_slack) / 5)))));
@@ -96,9 +121,14 @@ wirelen_t get_cell_metric(const Context *ctx, const CellInfo *cell, MetricType t
 wirelen_t get_cell_metric_at_bel(const Context *ctx, CellInfo *cell, BelId bel, MetricType type)
 {
     BelId oldBel = cell->bel;
+    Loc oldLoc = cell->loc;
+    // This bypasses bindBel, so the location mirror has to be kept in step
+    // by hand
     cell->bel = bel;
+    cell->loc = ctx->getBelLocation(bel);
     wirelen_t wirelen = get_cell_metric(ctx, cell, type);
     cell->bel = oldBel;
+    cell->loc = oldLoc;
     return wirelen;
 }
 
@@ -300,7 +330,7 @@ class ConstraintLegaliseWorker
             IncreasingDiameterSearch xRootSearch, yRootSearch, zRootSearch;
             Loc currentLoc;
             if (cell->bel != BelId())
-                currentLoc = ctx->getBelLocation(cell->bel);
+                currentLoc = cell->loc;
             else
                 currentLoc = oldLocations[cell->name];
             xRootSearch = IncreasingDiameterSearch(currentLoc.x, 0, ctx->getGridDimX() - 1);
@@ -450,7 +480,7 @@ int get_constraints_distance(const Context *ctx, const CellInfo *cell)
     int dist = 0;
     if (cell->bel == BelId())
         return 100000;
-    Loc loc = ctx->getBelLocation(cell->bel);
+    Loc loc = cell->loc;
 
     if (cell->cluster != ClusterId()) {
         CellInfo *root = ctx->getClusterRootCell(cell->cluster);
@@ -474,7 +504,7 @@ int get_constraints_distance(const Context *ctx, const CellInfo *cell)
             // child
             if (root->bel == BelId())
                 return 100000;
-            Loc root_loc = ctx->getBelLocation(root->bel);
+            Loc root_loc = root->loc;
             Loc offset = ctx->getClusterOffset(cell);
             dist += std::abs((root_loc.x + offset.x) - loc.x);
             dist += std::abs((root_loc.y + offset.y) - loc.y);
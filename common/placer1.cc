@@ -43,6 +43,8 @@
 #include "log.h"
 #include "place_common.h"
 #include "scope_lock.h"
+#include "telemetry.h"
+#include "threadpool.h"
 #include "timing.h"
 #include "util.h"
 
@@ -80,21 +82,17 @@ class SAPlacer
             cell_types_in_use.insert(cell_type);
         }
 
-        for (auto cell_type : cell_types_in_use) {
-            fast_bels.addCellType(cell_type);
-        }
+        fast_bels.addCellTypes(cell_types_in_use);
 
         net_bounds.resize(ctx->nets.size());
         net_arc_tcost.resize(ctx->nets.size());
         old_udata.reserve(ctx->nets.size());
-        net_by_udata.reserve(ctx->nets.size());
-        decltype(NetInfo::udata) n = 0;
-        for (auto &net : ctx->nets) {
+        for (auto &net : ctx->nets)
             old_udata.emplace_back(net.second->udata);
-            net_arc_tcost.at(n).resize(net.second->users.size());
-            net.second->udata = n++;
-            net_by_udata.push_back(net.second.get());
-        }
+        ctx->refreshNetUdata();
+        net_by_udata = ctx->net_by_udata;
+        for (size_t n = 0; n < net_by_udata.size(); n++)
+            net_arc_tcost.at(n).resize(net_by_udata.at(n)->users.size());
         for (auto &region : ctx->region) {
             Region *r = region.second.get();
             BoundingBox bb;
@@ -118,6 +116,13 @@ class SAPlacer
             }
             region_bounds[r->name] = bb;
         }
+        // Precompute per-region candidate lists so region-constrained cells
+        // never have to rejection-sample region membership in the move loop
+        for (auto &cell : ctx->cells) {
+            CellInfo *ci = cell.second.get();
+            if (ci->region != nullptr && ci->region->constr_bels)
+                fast_bels.addRegionCellType(ci->region, ci->type);
+        }
         build_port_index();
         for (auto &cell : ctx->cells) {
             CellInfo *ci = cell.second.get();
@@ -198,16 +203,10 @@ class SAPlacer
             // Place cells randomly initially
             log_info("Creating initial placement for remaining %d cells.\n", int(autoplaced.size()));
 
-            for (auto cell : autoplaced) {
-                place_initial(cell);
-                placed_cells++;
-                if ((placed_cells - constr_placed_cells) % 500 == 0)
-                    log_info("  initial placement placed %d/%d cells\n", int(placed_cells - constr_placed_cells),
-                             int(autoplaced.size()));
-            }
-            if ((placed_cells - constr_placed_cells) % 500 != 0)
-                log_info("  initial placement placed %d/%d cells\n", int(placed_cells - constr_placed_cells),
-                         int(autoplaced.size()));
+            place_initial_all(autoplaced);
+            placed_cells += int(autoplaced.size());
+            log_info("  initial placement placed %d/%d cells\n", int(placed_cells - constr_placed_cells),
+                     int(autoplaced.size()));
             if (cfg.budgetBased && cfg.slack_redist_iter > 0)
                 assign_budget(ctx);
             ctx->yield();
@@ -237,8 +236,10 @@ class SAPlacer
 
         // Invoke timing analysis to obtain criticalities
         tmg.setup_only = true;
-        if (!cfg.budgetBased)
+        if (!cfg.budgetBased) {
             tmg.setup();
+            refresh_crit_cache();
+        }
 
         // Calculate costs after initial placement
         setup_costs();
@@ -260,6 +261,7 @@ class SAPlacer
         // Main simulated annealing loop
         for (int iter = 1;; iter++) {
             n_move = n_accept = 0;
+            delta_sum = delta_sq_sum = 0;
             improved = false;
 
             if (iter % 5 == 0 || iter == 1)
@@ -268,18 +270,29 @@ class SAPlacer
                          iter, temp, double(curr_timing_cost), double(curr_wirelen_cost));
 
             for (int m = 0; m < 15; ++m) {
-                // Loop through all automatically placed cells
-                for (auto cell : autoplaced) {
-                    // Find another random Bel for this cell
-                    BelId try_bel = random_bel_for_cell(cell);
-                    // If valid, try and swap to a new position and see if
-                    // the new position is valid/worthwhile
-                    if (try_bel != BelId() && try_bel != cell->bel)
-                        try_swap_position(cell, try_bel);
+                if (cfg.parallelThreads > 1) {
+                    // Propose and pre-screen moves on worker threads, then
+                    // evaluate and commit the survivors serially; in
+                    // refinement mode the workers also filter out moves
+                    // whose estimated wirelength delta is worsening
+                    if (refine)
+                        parallel_refine_sweep(autoplaced);
+                    else
+                        parallel_sweep(autoplaced);
+                } else {
+                    // Loop through all automatically placed cells
+                    for (auto cell : autoplaced) {
+                        // Find another random Bel for this cell
+                        BelId try_bel = random_bel_for_cell(cell);
+                        // If valid, try and swap to a new position and see if
+                        // the new position is valid/worthwhile
+                        if (try_bel != BelId() && try_bel != cell->bel)
+                            try_swap_position(cell, try_bel);
+                    }
                 }
                 // Also try swapping chains, if applicable
                 for (auto cb : chain_basis) {
-                    Loc chain_base_loc = ctx->getBelLocation(cb->bel);
+                    Loc chain_base_loc = cb->loc;
                     BelId try_base = random_bel_for_cell(cb, chain_base_loc.z);
                     if (try_base != BelId() && try_base != cb->bel)
                         try_swap_chain(cb, try_base);
@@ -304,6 +317,23 @@ class SAPlacer
                 }
             }
 
+            double Raccept = double(n_accept) / std::max(1, n_move);
+            // Spread of this iteration's move deltas: the cost-variance
+            // signal the adaptive schedule cools by, and part of the
+            // schedule trace either way
+            double delta_mean = delta_sum / std::max(1, n_move);
+            double delta_sigma = std::sqrt(std::max(0.0, delta_sq_sum / std::max(1, n_move) - delta_mean * delta_mean));
+
+            if (telemetry_enabled(ctx))
+                telemetry_record(ctx, "placer1",
+                                 {{"iter", double(iter)},
+                                  {"temp", temp},
+                                  {"timing_cost", double(curr_timing_cost)},
+                                  {"wirelen", double(curr_wirelen_cost)},
+                                  {"Raccept", Raccept},
+                                  {"delta_sigma", delta_sigma},
+                                  {"diameter", double(diameter)}});
+
             if (curr_wirelen_cost < min_wirelen) {
                 min_wirelen = curr_wirelen_cost;
                 improved = true;
@@ -322,8 +352,6 @@ class SAPlacer
                 break;
             }
 
-            double Raccept = double(n_accept) / double(n_move);
-
             int M = std::max(max_x, max_y) + 1;
 
             if (ctx->verbose)
@@ -331,8 +359,38 @@ class SAPlacer
                     "%.0f, wirelen = %.0f, dia = %d, Ra = %.02f \n",
                     iter, temp, double(curr_timing_cost), double(curr_wirelen_cost), diameter, Raccept);
 
+            if (cfg.adaptiveSchedule && !refine && iter == 1 && delta_sigma > 0) {
+                // Measured start temperature (White's rule of thumb): the
+                // spread of the first iteration's move deltas accepts most
+                // uphill moves without the deep melt an over-estimated
+                // --starttemp produces, so no per-design tuning is needed
+                temp = float(delta_sigma);
+                if (ctx->verbose)
+                    log("iter #1: adaptive schedule measured start temp = %f\n", temp);
+            }
+
             if (curr_wirelen_cost < 0.95 * avg_wirelen && curr_wirelen_cost > 0) {
                 avg_wirelen = 0.8 * avg_wirelen + 0.2 * curr_wirelen_cost;
+            } else if (cfg.adaptiveSchedule && !refine) {
+                // Self-tuning cooling: step the temperature with the
+                // Aarts/van Laarhoven variance rule
+                //     T' = T / (1 + T * ln(1 + d) / (3 * sigma))
+                // so cooling slows while the cost landscape is rough (large
+                // spread of move deltas) and speeds up as it smooths out.
+                // The per-iteration step is clamped to [0.5, 0.95]: the
+                // upper bound guarantees termination no slower than the
+                // gentlest fixed multiplier, the lower one matches the
+                // quench the fixed schedule applies when nearly every move
+                // is accepted. Diameter keeps the same acceptance-ratio
+                // feedback as the fixed schedule. Refinement runs stay on
+                // the fixed schedule: they start effectively frozen and
+                // re-measuring a start temperature would melt them
+                double diam_next = diameter * (1.0 - 0.44 + Raccept);
+                diameter = std::max<int>(1, std::min<int>(M, int(diam_next + 0.5)));
+                constexpr double dist_param = 0.9;
+                double sigma = std::max(1e-9, delta_sigma);
+                double var_temp = temp / (1.0 + temp * std::log(1.0 + dist_param) / (3.0 * sigma));
+                temp = float(std::min(0.95 * temp, std::max(0.5 * temp, var_temp)));
             } else {
                 double diam_next = diameter * (1.0 - 0.44 + Raccept);
                 diameter = std::max<int>(1, std::min<int>(M, int(diam_next + 0.5)));
@@ -374,8 +432,10 @@ class SAPlacer
             }
 
             // Invoke timing analysis to obtain criticalities
-            if (!cfg.budgetBased && cfg.timing_driven)
+            if (!cfg.budgetBased && cfg.timing_driven) {
                 tmg.run();
+                refresh_crit_cache();
+            }
             // Need to rebuild costs after criticalities change
             setup_costs();
             // Reset incremental bounds
@@ -420,6 +480,96 @@ class SAPlacer
     }
 
   private:
+    // Initial placement of all unconstrained cells. The serial ripup search
+    // in place_initial scans every bel of the device per cell, which is
+    // O(cells * bels) and dominates placer startup on large designs; here
+    // the bulk of cells instead get a candidate assignment computed in
+    // parallel and committed serially. Cells are bucketed by type and each
+    // bucket randomly matched against the free bels of that type from
+    // fast_bels (equivalent in distribution to the serial placer's random
+    // scoring, without the per-cell scan). Buckets use forked per-chunk
+    // RNGs, so the assignment is independent of thread count. The serial
+    // search remains as the fallback for region-constrained cells, buckets
+    // with more cells than free bels, and candidates that fail arch
+    // validity checks once bound; on most designs that's a small tail
+    void place_initial_all(const std::vector<CellInfo *> &autoplaced)
+    {
+        // Bucket by type, preserving the shuffled cell order within buckets
+        std::vector<std::vector<CellInfo *>> buckets;
+        dict<IdString, size_t> bucket_idx;
+        std::vector<CellInfo *> fallback;
+        for (auto cell : autoplaced) {
+            if (cell->region != nullptr && cell->region->constr_bels) {
+                // The serial search already draws candidates from the
+                // per-region lists; region cells are rarely numerous
+                fallback.push_back(cell);
+                continue;
+            }
+            auto fnd = bucket_idx.find(cell->type);
+            if (fnd == bucket_idx.end()) {
+                fnd = bucket_idx.emplace(cell->type, buckets.size()).first;
+                buckets.emplace_back();
+            }
+            buckets.at(fnd->second).push_back(cell);
+        }
+        // Free-bel lists must be gathered before the parallel phase, as
+        // getBelsForCellType lazily builds its index on first use
+        std::vector<std::vector<BelId>> bucket_bels(buckets.size());
+        for (auto &entry : bucket_idx) {
+            FastBels::FastBelsData *bel_data;
+            fast_bels.getBelsForCellType(entry.first, &bel_data);
+            auto &bels = bucket_bels.at(entry.second);
+            for (auto &col : *bel_data)
+                for (auto &loc : col)
+                    for (auto bel : loc)
+                        if (ctx->checkBelAvail(bel))
+                            bels.push_back(bel);
+        }
+        // Parallel phase: per bucket, shuffle the free bels and pair them
+        // off against the cells in order. No Context state is mutated here
+        std::vector<std::vector<BelId>> proposed(buckets.size());
+        ThreadPool::get().run_chunks_rng(buckets.size(), 1, *ctx, [&](size_t begin, size_t end, DeterministicRNG &rng) {
+            for (size_t b = begin; b < end; b++) {
+                auto &cells = buckets.at(b);
+                auto &bels = bucket_bels.at(b);
+                rng.shuffle(bels);
+                // If the type is oversubscribed, the unmatched tail of the
+                // bucket goes through the ripup search instead
+                proposed.at(b).assign(cells.size(), BelId());
+                for (size_t i = 0; i < std::min(cells.size(), bels.size()); i++)
+                    proposed.at(b).at(i) = bels.at(i);
+            }
+        });
+        // Serial commit, in deterministic bucket-then-cell order. Different
+        // cell types can accept overlapping bel sets on some archs, so
+        // availability is re-checked against earlier commits
+        for (size_t b = 0; b < buckets.size(); b++) {
+            auto &cells = buckets.at(b);
+            auto &prop = proposed.at(b);
+            for (size_t i = 0; i < cells.size(); i++) {
+                CellInfo *cell = cells.at(i);
+                BelId bel = prop.at(i);
+                if (bel == BelId() || !ctx->checkBelAvail(bel)) {
+                    fallback.push_back(cell);
+                    continue;
+                }
+                ctx->bindBel(bel, cell, STRENGTH_WEAK);
+                if (!ctx->isBelLocationValid(bel)) {
+                    ctx->unbindBel(bel);
+                    fallback.push_back(cell);
+                    continue;
+                }
+                // Back annotate location
+                cell->attrs[ctx->id("BEL")] = ctx->getBelName(cell->bel).str(ctx);
+            }
+        }
+        if (!fallback.empty())
+            log_info("  initial placement assigned %d cells in parallel, %d via the serial search\n",
+                     int(autoplaced.size() - fallback.size()), int(fallback.size()));
+        for (auto cell : fallback)
+            place_initial(cell);
+    }
+
     // Initial random placement
     void place_initial(CellInfo *cell)
     {
@@ -457,7 +607,7 @@ class SAPlacer
             };
 
             if (cell->region != nullptr && cell->region->constr_bels) {
-                for (auto bel : cell->region->bels) {
+                for (auto bel : fast_bels.getRegionBels(cell->region, cell->type)) {
                     proc_bel(bel);
                 }
             } else {
@@ -519,39 +669,38 @@ class SAPlacer
             return false;
         }
 
-        int net_delta_score = 0;
-        if (cfg.netShareWeight > 0)
-            net_delta_score += update_nets_by_tile(cell, ctx->getBelLocation(cell->bel), ctx->getBelLocation(newBel));
-
-        ctx->unbindBel(oldBel);
-        if (other_cell != nullptr) {
-            ctx->unbindBel(newBel);
+        // Probe legality (of both the new and old locations; as in some cases of dedicated routing ripping up a cell
+        // can deny use of a dedicated path and thus make a site illegal) before touching any state; on archs with
+        // structural validity rules an illegal move is rejected without a single (un)bind
+        if (!ctx->isSwapLocationValid(cell, newBel, other_cell, oldBel)) {
+            return false;
         }
 
-        ctx->bindBel(newBel, cell, STRENGTH_WEAK);
-
-        if (other_cell != nullptr) {
-            ctx->bindBel(oldBel, other_cell, STRENGTH_WEAK);
-            if (cfg.netShareWeight > 0)
+        int net_delta_score = 0;
+        if (cfg.netShareWeight > 0) {
+            net_delta_score += update_nets_by_tile(cell, ctx->getBelLocation(oldBel), ctx->getBelLocation(newBel));
+            if (other_cell != nullptr)
                 net_delta_score +=
                         update_nets_by_tile(other_cell, ctx->getBelLocation(newBel), ctx->getBelLocation(oldBel));
         }
 
+        // Cost evaluation only reads the cells' bel fields and location mirrors, so move the cells speculatively
+        // and defer the real (un)bind calls until the move is accepted - at low temperature rejections outnumber
+        // acceptances by an order of magnitude, and this makes them not churn arch bind state at all
+        Loc old_bel_loc = ctx->getBelLocation(oldBel), new_bel_loc = ctx->getBelLocation(newBel);
+        cell->bel = newBel;
+        cell->loc = new_bel_loc;
+        if (other_cell != nullptr) {
+            other_cell->bel = oldBel;
+            other_cell->loc = old_bel_loc;
+        }
+
         add_move_cell(moveChange, cell, oldBel);
 
         if (other_cell != nullptr) {
             add_move_cell(moveChange, other_cell, newBel);
         }
 
-        // Always check both the new and old locations; as in some cases of dedicated routing ripping up a cell can deny
-        // use of a dedicated path and thus make a site illegal
-        if (!ctx->isBelLocationValid(newBel) || !ctx->isBelLocationValid(oldBel)) {
-            ctx->unbindBel(newBel);
-            if (other_cell != nullptr)
-                ctx->unbindBel(oldBel);
-            goto swap_fail;
-        }
-
         // Recalculate metrics for all nets touched by the perturbation
         compute_cost_changes(moveChange);
 
@@ -564,15 +713,24 @@ class SAPlacer
         if (cfg.netShareWeight > 0)
             delta += -cfg.netShareWeight * (net_delta_score / std::max<double>(total_net_share, epsilon));
         n_move++;
+        delta_sum += delta;
+        delta_sq_sum += delta * delta;
         // SA acceptance criteria
         if (delta < 0 || (temp > 1e-8 && (ctx->rng() / float(0x3fffffff)) <= std::exp(-delta / temp))) {
             n_accept++;
         } else {
-            if (other_cell != nullptr)
-                ctx->unbindBel(oldBel);
-            ctx->unbindBel(newBel);
             goto swap_fail;
         }
+        // Apply the accepted move to the arch for real; the probe has already established legality
+        cell->bel = oldBel;
+        if (other_cell != nullptr)
+            other_cell->bel = newBel;
+        ctx->unbindBel(oldBel);
+        if (other_cell != nullptr)
+            ctx->unbindBel(newBel);
+        ctx->bindBel(newBel, cell, STRENGTH_WEAK);
+        if (other_cell != nullptr)
+            ctx->bindBel(oldBel, other_cell, STRENGTH_WEAK);
         commit_cost_changes(moveChange);
 #if 0
         log_info("swap %s -> %s\n", cell->name.c_str(ctx), ctx->nameOfBel(newBel));
@@ -581,9 +739,11 @@ class SAPlacer
 #endif
         return true;
     swap_fail:
-        ctx->bindBel(oldBel, cell, STRENGTH_WEAK);
+        cell->bel = oldBel;
+        cell->loc = old_bel_loc;
         if (other_cell != nullptr) {
-            ctx->bindBel(newBel, other_cell, STRENGTH_WEAK);
+            other_cell->bel = newBel;
+            other_cell->loc = new_bel_loc;
             if (cfg.netShareWeight > 0)
                 update_nets_by_tile(other_cell, ctx->getBelLocation(oldBel), ctx->getBelLocation(newBel));
         }
@@ -662,7 +822,7 @@ class SAPlacer
                     } else if (bound->cluster != ClusterId()) {
                         // Displace the entire cluster
                         Loc old_loc = ctx->getBelLocation(old_bel);
-                        Loc bound_loc = ctx->getBelLocation(bound->bel);
+                        Loc bound_loc = bound->loc;
                         Loc root_loc = ctx->getBelLocation(ctx->getClusterRootCell(bound->cluster)->bel);
                         BelId new_root = ctx->getBelByLocation(Loc(old_loc.x + (root_loc.x - bound_loc.x),
                                                                    old_loc.y + (root_loc.y - bound_loc.y),
@@ -703,7 +863,7 @@ class SAPlacer
             add_move_cell(moveChange, cell, moved_cells.at(cell->name));
             if (cfg.netShareWeight > 0)
                 update_nets_by_tile(cell, ctx->getBelLocation(moved_cells.at(cell->name)),
-                                    ctx->getBelLocation(cell->bel));
+                                    cell->loc);
             if (!ctx->isBelLocationValid(cell->bel) || !cell->testRegion(cell->bel))
                 goto swap_fail;
         }
@@ -718,6 +878,8 @@ class SAPlacer
                     cfg.netShareWeight * (orig_share_cost - total_net_share) / std::max<double>(total_net_share, 1e-20);
         }
         n_move++;
+        delta_sum += delta;
+        delta_sq_sum += delta * delta;
         // SA acceptance criteria
         if (delta < 0 || (temp > 1e-8 && (ctx->rng() / float(0x3fffffff)) <= std::exp(-delta / temp))) {
             n_accept++;
@@ -757,7 +919,7 @@ class SAPlacer
     BelId random_bel_for_cell(CellInfo *cell, int force_z = -1)
     {
         IdString targetType = cell->type;
-        Loc curr_loc = ctx->getBelLocation(cell->bel);
+        Loc curr_loc = cell->loc;
         int count = 0;
 
         int dx = diameter, dy = diameter;
@@ -771,11 +933,62 @@ class SAPlacer
             curr_loc.x = std::min(region_bounds[cell->region->name].x1, curr_loc.x);
             curr_loc.y = std::max(region_bounds[cell->region->name].y0, curr_loc.y);
             curr_loc.y = std::min(region_bounds[cell->region->name].y1, curr_loc.y);
+
+            // Draw straight from the precomputed region candidate list; the
+            // grid pick below samples the region's bounding box and then
+            // rejects non-members, which throws away nearly every pick for
+            // sparse or non-rectangular regions
+            const auto &region_bels = fast_bels.getRegionBels(cell->region, targetType);
+            if (!region_bels.empty()) {
+                int attempts = 0;
+                while (true) {
+                    BelId bel = region_bels.at(ctx->rng(int(region_bels.size())));
+                    // Keep the usual diameter window for SA locality, but
+                    // give up on the window (never the region) if it keeps
+                    // missing the region's bels
+                    if (attempts++ < 16) {
+                        Loc loc = ctx->getBelLocation(bel);
+                        if (std::abs(loc.x - curr_loc.x) > dx || std::abs(loc.y - curr_loc.y) > dy)
+                            continue;
+                    }
+                    if (force_z != -1 && ctx->getBelLocation(bel).z != force_z)
+                        continue;
+                    if (locked_bels.find(bel) != locked_bels.end())
+                        continue;
+                    return bel;
+                }
+            }
         }
 
         FastBels::FastBelsData *bel_data;
         auto type_cnt = fast_bels.getBelsForCellType(targetType, &bel_data);
 
+        // Scarce types (DSPs, BRAMs, ...) are collapsed into a single grid
+        // bucket, which would make the pick below uniform over the whole
+        // device and throw away SA locality - nearly every such move is a
+        // long-range one that gets rejected. Instead query the per-type
+        // quadtree for the actual candidates within the diameter window and
+        // pick among those, widening to the full list only when the window
+        // holds no acceptable bel.
+        if (cfg.minBelsForGridPick >= 0 && type_cnt < cfg.minBelsForGridPick) {
+            scarce_candidates.clear();
+            fast_bels.getBelsInBox(targetType, curr_loc.x - dx, curr_loc.y - dy, curr_loc.x + dx, curr_loc.y + dy,
+                                   scarce_candidates);
+            while (!scarce_candidates.empty()) {
+                int idx = ctx->rng(int(scarce_candidates.size()));
+                BelId bel = scarce_candidates.at(idx);
+                std::swap(scarce_candidates.at(idx), scarce_candidates.back());
+                scarce_candidates.pop_back();
+                if (force_z != -1 && ctx->getBelLocation(bel).z != force_z)
+                    continue;
+                if (!cell->testRegion(bel))
+                    continue;
+                if (locked_bels.find(bel) != locked_bels.end())
+                    continue;
+                return bel;
+            }
+        }
+
         while (true) {
             int nx = ctx->rng(2 * dx + 1) + std::max(curr_loc.x - dx, 0);
             int ny = ctx->rng(2 * dy + 1) + std::max(curr_loc.y - dy, 0);
@@ -803,6 +1016,252 @@ class SAPlacer
         }
     }
 
+    // Find and pre-screen a candidate Bel for a cell on a worker thread. This
+    // only performs read-only queries against the placement state, so it is
+    // safe to run for spatially-disjoint slabs of cells concurrently. Unlike
+    // random_bel_for_cell the number of attempts is bounded, as a slab might
+    // not contain any suitable candidate at all.
+    BelId propose_bel_for_cell(CellInfo *cell, DeterministicRNG &rng)
+    {
+        Loc curr_loc = cell->loc;
+        int dx = diameter, dy = diameter;
+        if (cell->region != nullptr && cell->region->constr_bels) {
+            auto &bb = region_bounds[cell->region->name];
+            dx = std::min(cfg.hpwl_scale_x * diameter, (bb.x1 - bb.x0) + 1);
+            dy = std::min(cfg.hpwl_scale_y * diameter, (bb.y1 - bb.y0) + 1);
+            curr_loc.x = std::min(bb.x1, std::max(bb.x0, curr_loc.x));
+            curr_loc.y = std::min(bb.y1, std::max(bb.y0, curr_loc.y));
+
+            // Same direct region-list sampling as the serial generator; the
+            // lists are built at setup so this lookup is read-only
+            const auto &region_bels = fast_bels.getRegionBels(cell->region, cell->type);
+            if (region_bels.empty())
+                return BelId();
+            for (int attempt = 0; attempt < 32; attempt++) {
+                BelId bel = region_bels.at(rng.rng(int(region_bels.size())));
+                if (attempt < 16) {
+                    Loc loc = ctx->getBelLocation(bel);
+                    if (std::abs(loc.x - curr_loc.x) > dx || std::abs(loc.y - curr_loc.y) > dy)
+                        continue;
+                }
+                if (bel == cell->bel)
+                    continue;
+                if (locked_bels.find(bel) != locked_bels.end())
+                    continue;
+                // Type validity is guaranteed by the list's construction
+                CellInfo *other_cell = ctx->getBoundBelCell(bel);
+                if (other_cell != nullptr) {
+                    if (other_cell->cluster != ClusterId() || other_cell->belStrength > STRENGTH_WEAK)
+                        continue;
+                    if (!ctx->isValidBelForCellType(other_cell->type, cell->bel))
+                        continue;
+                }
+                return bel;
+            }
+            return BelId();
+        }
+        FastBels::FastBelsData *bel_data;
+        auto type_cnt = fast_bels.getBelsForCellType(cell->type, &bel_data);
+        // Scarce types get the same windowed candidate-list pick as the
+        // serial generator (see random_bel_for_cell); the quadtree query is
+        // read-only so it is safe from a worker thread
+        if (cfg.minBelsForGridPick >= 0 && type_cnt < cfg.minBelsForGridPick) {
+            std::vector<BelId> candidates;
+            fast_bels.getBelsInBox(cell->type, curr_loc.x - dx, curr_loc.y - dy, curr_loc.x + dx, curr_loc.y + dy,
+                                   candidates);
+            while (!candidates.empty()) {
+                int idx = rng.rng(int(candidates.size()));
+                BelId bel = candidates.at(idx);
+                std::swap(candidates.at(idx), candidates.back());
+                candidates.pop_back();
+                if (bel == cell->bel)
+                    continue;
+                if (!cell->testRegion(bel))
+                    continue;
+                if (locked_bels.find(bel) != locked_bels.end())
+                    continue;
+                if (!ctx->isValidBelForCellType(cell->type, bel))
+                    continue;
+                CellInfo *other_cell = ctx->getBoundBelCell(bel);
+                if (other_cell != nullptr) {
+                    if (other_cell->cluster != ClusterId() || other_cell->belStrength > STRENGTH_WEAK)
+                        continue;
+                    if (!ctx->isValidBelForCellType(other_cell->type, cell->bel))
+                        continue;
+                }
+                return bel;
+            }
+            return BelId();
+        }
+        for (int attempt = 0; attempt < 32; attempt++) {
+            int nx = rng.rng(2 * dx + 1) + std::max(curr_loc.x - dx, 0);
+            int ny = rng.rng(2 * dy + 1) + std::max(curr_loc.y - dy, 0);
+            if (cfg.minBelsForGridPick >= 0 && type_cnt < cfg.minBelsForGridPick)
+                nx = ny = 0;
+            if (nx >= int(bel_data->size()))
+                continue;
+            if (ny >= int(bel_data->at(nx).size()))
+                continue;
+            const auto &fb = bel_data->at(nx).at(ny);
+            if (fb.size() == 0)
+                continue;
+            BelId bel = fb.at(rng.rng(int(fb.size())));
+            if (bel == cell->bel)
+                continue;
+            if (!cell->testRegion(bel))
+                continue;
+            if (locked_bels.find(bel) != locked_bels.end())
+                continue;
+            // Cheap legality pre-screen; try_swap_position re-checks this on
+            // the main thread before anything is committed
+            if (!ctx->isValidBelForCellType(cell->type, bel))
+                continue;
+            CellInfo *other_cell = ctx->getBoundBelCell(bel);
+            if (other_cell != nullptr) {
+                if (other_cell->cluster != ClusterId() || other_cell->belStrength > STRENGTH_WEAK)
+                    continue;
+                if (!ctx->isValidBelForCellType(other_cell->type, cell->bel))
+                    continue;
+            }
+            return bel;
+        }
+        return BelId();
+    }
+
+    // One sweep of parallel move generation. Cells are bucketed by their
+    // current x position into one vertical slab per thread so that the
+    // pre-screening queries are spatially disjoint; the exact cost evaluation
+    // and the SA accept/commit step stay on the main thread, keeping the
+    // placement state single-writer. Per-thread RNGs are seeded serially and
+    // proposals are committed in slab order, so results are reproducible for
+    // a given seed and thread count.
+    void parallel_sweep(std::vector<CellInfo *> &cells)
+    {
+        int nthreads = std::max(1, std::min(cfg.parallelThreads, (max_x + 1) / 4));
+        int slab_w = (max_x / nthreads) + 1;
+        std::vector<std::vector<CellInfo *>> slab_cells(nthreads);
+        std::vector<std::vector<std::pair<CellInfo *, BelId>>> proposals(nthreads);
+        for (auto cell : cells) {
+            // Cells with no swap freedom are handled by the serial path only
+            if (cell->cluster != ClusterId())
+                continue;
+            int slab = cell->loc.x / slab_w;
+            slab_cells.at(slab).push_back(cell);
+        }
+        std::vector<DeterministicRNG> rngs(nthreads);
+        for (auto &rng : rngs)
+            rng.rngseed(ctx->rng64());
+        ThreadPool::get().run_chunks(size_t(nthreads), 1, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) {
+                for (auto cell : slab_cells.at(t)) {
+                    BelId try_bel = propose_bel_for_cell(cell, rngs.at(t));
+                    if (try_bel != BelId())
+                        proposals.at(t).emplace_back(cell, try_bel);
+                }
+            }
+        });
+        for (auto &slab : proposals)
+            for (auto &p : slab)
+                if (p.second != p.first->bel)
+                    try_swap_position(p.first, p.second);
+    }
+
+    // Refinement-mode variant of parallel_sweep, for the low-temperature
+    // tail after HeAP. At refinement temperature almost no worsening move is
+    // accepted, so on top of the legality pre-screen the workers estimate
+    // each proposal's wirelength delta against the frozen pre-sweep bounds
+    // (the parallel phase performs no writes) and drop clearly worsening
+    // moves before they reach the main thread. The estimate is only a
+    // filter — survivors still go through the full cost model and legality
+    // checks of try_swap_position, committed serially in slab order, so the
+    // result stays reproducible for a given seed and thread count.
+    void parallel_refine_sweep(std::vector<CellInfo *> &cells)
+    {
+        int nthreads = std::max(1, std::min(cfg.parallelThreads, (max_x + 1) / 4));
+        int slab_w = (max_x / nthreads) + 1;
+        std::vector<std::vector<CellInfo *>> slab_cells(nthreads);
+        std::vector<std::vector<std::pair<CellInfo *, BelId>>> proposals(nthreads);
+        for (auto cell : cells) {
+            if (cell->cluster != ClusterId())
+                continue;
+            int slab = cell->loc.x / slab_w;
+            slab_cells.at(slab).push_back(cell);
+        }
+        std::vector<DeterministicRNG> rngs(nthreads);
+        for (auto &rng : rngs)
+            rng.rngseed(ctx->rng64());
+        ThreadPool::get().run_chunks(size_t(nthreads), 1, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) {
+                for (auto cell : slab_cells.at(t)) {
+                    BelId try_bel = propose_bel_for_cell(cell, rngs.at(t));
+                    if (try_bel == BelId())
+                        continue;
+                    if (estimate_swap_wirelen_delta(cell, try_bel) > 0)
+                        continue;
+                    proposals.at(t).emplace_back(cell, try_bel);
+                }
+            }
+        });
+        for (auto &slab : proposals)
+            for (auto &p : slab)
+                if (p.second != p.first->bel)
+                    try_swap_position(p.first, p.second);
+    }
+
+    // Estimate the wirelength delta of swapping `cell` onto `bel` (and the
+    // cell currently bound there, if any, onto cell's bel) without touching
+    // any placer state. High-fanout nets are treated as unchanged: a local
+    // refinement move barely shifts their bounds, and the exact evaluation
+    // at commit time has the final say either way.
+    wirelen_t estimate_swap_wirelen_delta(CellInfo *cell, BelId bel)
+    {
+        CellInfo *other_cell = ctx->getBoundBelCell(bel);
+        Loc new_loc = ctx->getBelLocation(bel);
+        Loc old_loc = cell->loc;
+
+        std::vector<NetInfo *> nets;
+        auto collect_nets = [&](CellInfo *c) {
+            for (auto &port : c->ports) {
+                NetInfo *net = port.second.net;
+                if (net == nullptr || ignore_net(net))
+                    continue;
+                if (net->users.size() > 100)
+                    continue;
+                if (std::find(nets.begin(), nets.end(), net) == nets.end())
+                    nets.push_back(net);
+            }
+        };
+        collect_nets(cell);
+        if (other_cell != nullptr)
+            collect_nets(other_cell);
+
+        auto loc_of = [&](const CellInfo *c) {
+            if (c == cell)
+                return new_loc;
+            if (c == other_cell)
+                return old_loc;
+            return c->loc;
+        };
+
+        wirelen_t delta = 0;
+        for (NetInfo *net : nets) {
+            Loc dloc = loc_of(net->driver.cell);
+            int x0 = dloc.x, x1 = dloc.x, y0 = dloc.y, y1 = dloc.y;
+            for (auto &user : net->users) {
+                if (user.cell->bel == BelId())
+                    continue;
+                Loc uloc = loc_of(user.cell);
+                x0 = std::min(x0, uloc.x);
+                x1 = std::max(x1, uloc.x);
+                y0 = std::min(y0, uloc.y);
+                y1 = std::max(y1, uloc.y);
+            }
+            wirelen_t new_hpwl = wirelen_t(cfg.hpwl_scale_x * (x1 - x0) + cfg.hpwl_scale_y * (y1 - y0));
+            delta += new_hpwl - net_bounds.at(net->udata).hpwl(cfg);
+        }
+        return delta;
+    }
+
     // Return true if a net is to be entirely ignored
     inline bool ignore_net(NetInfo *net)
     {
@@ -815,7 +1274,7 @@ class SAPlacer
     {
         BoundingBox bb;
         NPNR_ASSERT(net->driver.cell != nullptr);
-        Loc dloc = ctx->getBelLocation(net->driver.cell->bel);
+        Loc dloc = net->driver.cell->loc;
         bb.x0 = dloc.x;
         bb.x1 = dloc.x;
         bb.y0 = dloc.y;
@@ -827,7 +1286,7 @@ class SAPlacer
         for (auto user : net->users) {
             if (user.cell->bel == BelId())
                 continue;
-            Loc uloc = ctx->getBelLocation(user.cell->bel);
+            Loc uloc = user.cell->loc;
             if (bb.x0 == uloc.x)
                 ++bb.nx0;
             else if (uloc.x < bb.x0) {
@@ -857,21 +1316,103 @@ class SAPlacer
         return bb;
     }
 
+    // Recompute only one axis of a net's bounding box. Used when an edge of
+    // the box collapses (its membership count hits zero): only the collapsing
+    // axis needs an O(pins) rescan, the incrementally-updated other axis is
+    // left untouched.
+    inline void recompute_net_bounds_x(NetInfo *net, BoundingBox &bb)
+    {
+        NPNR_ASSERT(net->driver.cell != nullptr);
+        Loc dloc = net->driver.cell->loc;
+        bb.x0 = bb.x1 = dloc.x;
+        bb.nx0 = bb.nx1 = 1;
+        for (auto user : net->users) {
+            if (user.cell->bel == BelId())
+                continue;
+            Loc uloc = user.cell->loc;
+            if (bb.x0 == uloc.x)
+                ++bb.nx0;
+            else if (uloc.x < bb.x0) {
+                bb.x0 = uloc.x;
+                bb.nx0 = 1;
+            }
+            if (bb.x1 == uloc.x)
+                ++bb.nx1;
+            else if (uloc.x > bb.x1) {
+                bb.x1 = uloc.x;
+                bb.nx1 = 1;
+            }
+        }
+    }
+
+    inline void recompute_net_bounds_y(NetInfo *net, BoundingBox &bb)
+    {
+        NPNR_ASSERT(net->driver.cell != nullptr);
+        Loc dloc = net->driver.cell->loc;
+        bb.y0 = bb.y1 = dloc.y;
+        bb.ny0 = bb.ny1 = 1;
+        for (auto user : net->users) {
+            if (user.cell->bel == BelId())
+                continue;
+            Loc uloc = user.cell->loc;
+            if (bb.y0 == uloc.y)
+                ++bb.ny0;
+            else if (uloc.y < bb.y0) {
+                bb.y0 = uloc.y;
+                bb.ny0 = 1;
+            }
+            if (bb.y1 == uloc.y)
+                ++bb.ny1;
+            else if (uloc.y > bb.y1) {
+                bb.y1 = uloc.y;
+                bb.ny1 = 1;
+            }
+        }
+    }
+
     // Get the timing cost for an arc of a net
     inline double get_timing_cost(NetInfo *net, size_t user)
     {
         int cc;
         if (net->driver.cell == nullptr)
             return 0;
-        if (ctx->getPortTimingClass(net->driver.cell, net->driver.port, cc) == TMG_IGNORE)
-            return 0;
         if (cfg.budgetBased) {
+            if (ctx->getPortTimingClass(net->driver.cell, net->driver.port, cc) == TMG_IGNORE)
+                return 0;
             double delay = ctx->getDelayNS(ctx->predictArcDelay(net, net->users.at(user)));
             return std::min(10.0, std::exp(delay - ctx->getDelayNS(net->users.at(user).budget) / 10));
         } else {
-            float crit = tmg.get_criticality(CellPortKey(net->users.at(user)));
+            // Zero covers both uncritical arcs and TMG_IGNORE drivers, both
+            // folded into the cache on refresh
+            float crit_factor = net_crit.at(net->udata).at(user);
+            if (crit_factor == 0)
+                return 0;
             double delay = ctx->getDelayNS(ctx->predictArcDelay(net, net->users.at(user)));
-            return delay * std::pow(crit, crit_exp);
+            return delay * crit_factor;
+        }
+    }
+
+    // Refresh the flat per-arc criticality cache from the last timing
+    // analysis. get_timing_cost runs on every move attempt, so it reads this
+    // array rather than querying the analyser's port hash maps; the cache is
+    // refreshed on the same cadence as the analyser itself (once per outer
+    // iteration), during which criticalities are held constant anyway. The
+    // criticality exponent is folded in here so the per-move cost is just a
+    // delay prediction and a multiply
+    void refresh_crit_cache()
+    {
+        net_crit.resize(ctx->nets.size());
+        for (auto &net : ctx->nets) {
+            NetInfo *ni = net.second.get();
+            auto &crit = net_crit.at(ni->udata);
+            crit.assign(ni->users.size(), 0.0f);
+            if (ignore_net(ni) || ni->driver.cell == nullptr)
+                continue;
+            int cc;
+            if (ctx->getPortTimingClass(ni->driver.cell, ni->driver.port, cc) == TMG_IGNORE)
+                continue;
+            for (size_t i = 0; i < ni->users.size(); i++)
+                crit.at(i) = float(std::pow(tmg.get_criticality(CellPortKey(ni->users.at(i))), crit_exp));
         }
     }
 
@@ -969,7 +1510,7 @@ class SAPlacer
 
     void add_move_cell(MoveChangeData &mc, CellInfo *cell, BelId old_bel)
     {
-        Loc curr_loc = ctx->getBelLocation(cell->bel);
+        Loc curr_loc = cell->loc;
         Loc old_loc = ctx->getBelLocation(old_bel);
         // Check net bounds
         for (const auto &port : cell->ports) {
@@ -1126,12 +1667,11 @@ class SAPlacer
     {
         for (const auto &bc : md.bounds_changed_nets_x) {
             if (md.already_bounds_changed_x[bc] == MoveChangeData::FULL_RECOMPUTE)
-                md.new_net_bounds[bc] = get_net_bounds(net_by_udata[bc]);
+                recompute_net_bounds_x(net_by_udata[bc], md.new_net_bounds[bc]);
         }
         for (const auto &bc : md.bounds_changed_nets_y) {
-            if (md.already_bounds_changed_x[bc] != MoveChangeData::FULL_RECOMPUTE &&
-                md.already_bounds_changed_y[bc] == MoveChangeData::FULL_RECOMPUTE)
-                md.new_net_bounds[bc] = get_net_bounds(net_by_udata[bc]);
+            if (md.already_bounds_changed_y[bc] == MoveChangeData::FULL_RECOMPUTE)
+                recompute_net_bounds_y(net_by_udata[bc], md.new_net_bounds[bc]);
         }
 
         for (const auto &bc : md.bounds_changed_nets_x)
@@ -1186,7 +1726,7 @@ class SAPlacer
             CellInfo *ci = cell.second.get();
             if (int(ci->ports.size()) > large_cell_thresh)
                 continue;
-            Loc loc = ctx->getBelLocation(ci->bel);
+            Loc loc = ci->loc;
             auto &nbt = nets_by_tile.at(loc.x).at(loc.y);
             for (const auto &port : ci->ports) {
                 if (port.second.net == nullptr)
@@ -1239,6 +1779,9 @@ class SAPlacer
     std::vector<BoundingBox> net_bounds;
     // Map net arcs to their timing cost (criticality * delay ns)
     std::vector<std::vector<double>> net_arc_tcost;
+    // Per-arc criticality (raised to crit_exp) from the last timing analysis,
+    // indexed by net udata then user index; see refresh_crit_cache()
+    std::vector<std::vector<float>> net_crit;
 
     // Fast lookup for cell port to net user index
     dict<std::pair<IdString, IdString>, size_t> fast_port_to_user;
@@ -1256,10 +1799,16 @@ class SAPlacer
     float lambda = 0.5;
     bool improved = false;
     int n_move, n_accept;
+    // Sum and sum-of-squares of the move deltas proposed this iteration;
+    // their spread drives the adaptive schedule's cooling and start
+    // temperature and is exported in the telemetry schedule trace
+    double delta_sum = 0, delta_sq_sum = 0;
     int diameter = 35, max_x = 1, max_y = 1;
     dict<IdString, std::tuple<int, int>> bel_types;
     dict<IdString, BoundingBox> region_bounds;
     FastBels fast_bels;
+    // Scratch for the scarce-type candidate pick in random_bel_for_cell
+    std::vector<BelId> scarce_candidates;
     pool<BelId> locked_bels;
     std::vector<NetInfo *> net_by_udata;
     std::vector<decltype(NetInfo::udata)> old_udata;
@@ -1277,6 +1826,8 @@ Placer1Cfg::Placer1Cfg(Context *ctx)
     minBelsForGridPick = ctx->setting<int>("placer1/minBelsForGridPick", 64);
     budgetBased = ctx->setting<bool>("placer1/budgetBased", false);
     startTemp = ctx->setting<float>("placer1/startTemp", 1);
+    adaptiveSchedule = ctx->setting<bool>("placer1/adaptiveSchedule", false);
+    parallelThreads = ctx->setting<int>("placer1/parallelThreads", 0);
     timingFanoutThresh = std::numeric_limits<int>::max();
     timing_driven = ctx->setting<bool>("timing_driven");
     slack_redist_iter = ctx->setting<int>("slack_redist_iter");
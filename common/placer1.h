@@ -31,10 +31,15 @@ struct Placer1Cfg
     int minBelsForGridPick;
     bool budgetBased;
     float startTemp;
+    // Self-tuning annealing schedule: measure the start temperature and
+    // drive cooling from the spread of move deltas instead of the fixed
+    // multipliers, so --starttemp needs no per-design tuning
+    bool adaptiveSchedule;
     int timingFanoutThresh;
     bool timing_driven;
     int slack_redist_iter;
     int hpwl_scale_x, hpwl_scale_y;
+    int parallelThreads;
 };
 
 extern bool placer1(Context *ctx, Placer1Cfg cfg);
@@ -38,8 +38,10 @@
 #include <Eigen/IterativeLinearSolvers>
 #include <boost/optional.hpp>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <fstream>
+#include <mutex>
 #include <numeric>
 #include <queue>
 #include <tuple>
@@ -49,6 +51,7 @@
 #include "place_common.h"
 #include "placer1.h"
 #include "scope_lock.h"
+#include "threadpool.h"
 #include "timing.h"
 #include "util.h"
 
@@ -77,6 +80,19 @@ template <typename T> struct EquationSystem
         std::fill(rhs.begin(), rhs.end(), T());
     }
 
+    // Zero the coefficients but keep the sparsity structure: the next
+    // build's add_coeff calls then hit existing entries instead of
+    // re-inserting, and entries the build doesn't touch stay as explicit
+    // zeros. Keeping the pattern stable this way is what lets solve()
+    // refresh the compressed Eigen matrix in place rather than rebuild it
+    void reset_values()
+    {
+        for (auto &col : A)
+            for (auto &el : col)
+                el.second = T();
+        std::fill(rhs.begin(), rhs.end(), T());
+    }
+
     void add_coeff(int row, int col, T val)
     {
         auto &Ac = A.at(col);
@@ -98,6 +114,30 @@ template <typename T> struct EquationSystem
 
     void add_rhs(int row, T val) { rhs[row] += val; }
 
+    // Cached Eigen matrix so the compressed sparsity structure can be reused
+    // across solves; the pattern only depends on design connectivity and is
+    // identical every HeAP iteration on the same solve cell set
+    Eigen::SparseMatrix<T> mat;
+
+    // True if the cached matrix has the same sparsity pattern as A, so only
+    // the coefficient values need refreshing
+    bool structure_unchanged() const
+    {
+        if (mat.cols() != int(A.size()) || mat.rows() != int(A.size()) || !mat.isCompressed())
+            return false;
+        const auto *outer = mat.outerIndexPtr();
+        const auto *inner = mat.innerIndexPtr();
+        for (int col = 0; col < int(A.size()); col++) {
+            auto &Ac = A.at(col);
+            if ((outer[col + 1] - outer[col]) != int(Ac.size()))
+                return false;
+            for (int i = 0; i < int(Ac.size()); i++)
+                if (inner[outer[col] + i] != Ac.at(i).first)
+                    return false;
+        }
+        return true;
+    }
+
     void solve(std::vector<T> &x, float tolerance)
     {
         using namespace Eigen;
@@ -106,16 +146,28 @@ template <typename T> struct EquationSystem
         NPNR_ASSERT(x.size() == A.size());
 
         VectorXd vx(x.size()), vb(rhs.size());
-        SparseMatrix<T> mat(A.size(), A.size());
 
-        std::vector<int> colnnz;
-        for (auto &Ac : A)
-            colnnz.push_back(int(Ac.size()));
-        mat.reserve(colnnz);
-        for (int col = 0; col < int(A.size()); col++) {
-            auto &Ac = A.at(col);
-            for (auto &el : Ac)
-                mat.insert(el.first, col) = el.second;
+        if (structure_unchanged()) {
+            // Fast path: rows within a column are stored in ascending order,
+            // matching the sort order of A, so values can be copied straight
+            // into the compressed storage
+            T *vals = mat.valuePtr();
+            size_t k = 0;
+            for (auto &Ac : A)
+                for (auto &el : Ac)
+                    vals[k++] = el.second;
+        } else {
+            mat = SparseMatrix<T>(A.size(), A.size());
+            std::vector<int> colnnz;
+            for (auto &Ac : A)
+                colnnz.push_back(int(Ac.size()));
+            mat.reserve(colnnz);
+            for (int col = 0; col < int(A.size()); col++) {
+                auto &Ac = A.at(col);
+                for (auto &el : Ac)
+                    mat.insert(el.first, col) = el.second;
+            }
+            mat.makeCompressed();
         }
 
         for (int i = 0; i < int(x.size()); i++)
@@ -146,8 +198,10 @@ class HeAPPlacer
         tmg.setup();
 
         for (auto &cell : ctx->cells)
-            if (cell.second->cluster != ClusterId())
+            if (cell.second->cluster != ClusterId()) {
                 cluster2cells[cell.second->cluster].push_back(cell.second.get());
+                cluster_offsets[cell.second->name] = ctx->getClusterOffset(cell.second.get());
+            }
     }
 
     bool place()
@@ -390,6 +444,10 @@ class HeAPPlacer
     std::vector<CellInfo *> solve_cells;
 
     dict<ClusterId, std::vector<CellInfo *>> cluster2cells;
+    // Offsets within a cluster are fixed for the whole placement; cache them
+    // here so the equation setup doesn't make a virtual getClusterOffset call
+    // for every stamped matrix entry of a chain cell
+    dict<IdString, Loc> cluster_offsets;
     dict<ClusterId, int> chain_size;
     // Performance counting
     double solve_time = 0, cl_time = 0, sl_time = 0;
@@ -457,11 +515,14 @@ class HeAPPlacer
             buckets_in_use.insert(bucket);
         }
 
-        for (auto cell_type : cell_types_in_use) {
-            fast_bels.addCellType(cell_type);
-        }
-        for (auto bucket : buckets_in_use) {
-            fast_bels.addBelBucket(bucket);
+        fast_bels.addCellTypes(cell_types_in_use);
+        fast_bels.addBelBuckets(buckets_in_use);
+        // Candidate lists for region-constrained cells, used by the
+        // legaliser so probes always land on tiles that hold region bels
+        for (auto &cell : ctx->cells) {
+            CellInfo *ci = cell.second.get();
+            if (ci->region != nullptr && ci->region->constr_bels)
+                fast_bels.addRegionCellType(ci->region, ci->type);
         }
 
         // Determine bounding boxes of region constraints
@@ -490,13 +551,28 @@ class HeAPPlacer
         }
     }
 
+    // Persistent per-axis equation systems, so the sparse matrix structure
+    // and per-column allocations survive across solver iterations instead of
+    // being rebuilt from scratch each time
+    std::unique_ptr<EquationSystem<double>> eqs_x, eqs_y;
+
     // Build and solve in one direction
     void build_solve_direction(bool yaxis, int iter)
     {
+        auto &es = yaxis ? eqs_y : eqs_x;
+        if (!es || es->A.size() != solve_cells.size())
+            es = std::unique_ptr<EquationSystem<double>>(
+                    new EquationSystem<double>(solve_cells.size(), solve_cells.size()));
+        // Structure is dropped once per outer iteration: cells have been
+        // spread and legalised since the last call, so the bound-port pattern
+        // has moved too much to be worth carrying (and carrying it forever
+        // would let the stored pattern grow without bound). Between the inner
+        // solves below only the values are cleared, so the pattern stays
+        // stable and assembly is a value refresh
+        es->reset();
         for (int i = 0; i < 5; i++) {
-            EquationSystem<double> esx(solve_cells.size(), solve_cells.size());
-            build_equations(esx, yaxis, iter);
-            solve_equations(esx, yaxis);
+            build_equations(*es, yaxis, iter);
+            solve_equations(*es, yaxis);
         }
     }
 
@@ -643,7 +719,7 @@ class HeAPPlacer
                 for (auto child : cluster2cells.at(cell->cluster)) {
                     if (child->type == cell->type && child != cell)
                         chain_size[cell->name]++;
-                    Loc offset = ctx->getClusterOffset(child);
+                    const Loc &offset = cluster_offsets.at(child->name);
                     cell_locs[child->name].x = std::max(0, std::min(max_x, base.x + offset.x));
                     cell_locs[child->name].y = std::max(0, std::min(max_y, base.y + offset.y));
                 }
@@ -669,7 +745,7 @@ class HeAPPlacer
             return yaxis ? cell_locs.at(cell->name).legal_y : cell_locs.at(cell->name).legal_x;
         };
 
-        es.reset();
+        es.reset_values();
 
         for (auto &net : ctx->nets) {
             NetInfo *ni = net.second.get();
@@ -707,7 +783,7 @@ class HeAPPlacer
                     es.add_rhs(row, -v_pos * weight);
                 }
                 if (var.cell->cluster != ClusterId()) {
-                    Loc offset = ctx->getClusterOffset(var.cell);
+                    const Loc &offset = cluster_offsets.at(var.cell->name);
                     es.add_rhs(row, -(yaxis ? offset.y : offset.x) * weight);
                 }
             };
@@ -840,6 +916,7 @@ class HeAPPlacer
             int radius = 0;
             int iter = 0;
             int iter_at_radius = 0;
+            int total_cell_iters = 0;
             bool placed = false;
             BelId bestBel;
             int best_inp_len = std::numeric_limits<int>::max();
@@ -862,6 +939,26 @@ class HeAPPlacer
                     log_error("Unable to find legal placement for cell '%s', check constraints and utilisation.\n",
                               ctx->nameOf(ci));
 
+                // If random probing has made no progress after many tries (a symptom of a nearly-full device where
+                // most tiles are occupied), fall back to a deterministic spiral search for the nearest free bel
+                // instead of continuing to sample mostly-occupied tiles
+                if (++total_cell_iters == 1000 && bestBel == BelId() && ci->cluster == ClusterId()) {
+                    Loc origin(cell_locs.at(ci->name).x, cell_locs.at(ci->name).y, 0);
+                    BelId spiral_bel = fast_bels.findNearestFreeBel(ci->type, origin,
+                                                                    [&](BelId bel) { return ci->testRegion(bel); });
+                    if (spiral_bel != BelId()) {
+                        ctx->bindBel(spiral_bel, ci, STRENGTH_WEAK);
+                        if (!require_validity || ctx->isBelLocationValid(spiral_bel)) {
+                            placed = true;
+                            Loc loc = ctx->getBelLocation(spiral_bel);
+                            cell_locs[ci->name].x = loc.x;
+                            cell_locs[ci->name].y = loc.y;
+                            break;
+                        }
+                        ctx->unbindBel(spiral_bel);
+                    }
+                }
+
                 // Determine a search radius around the solver location (which increases over time) that is clamped to
                 // the region constraint for the cell (if applicable)
                 int rx = radius, ry = radius;
@@ -881,6 +978,23 @@ class HeAPPlacer
                 int nx = ctx->rng(2 * rx + 1) + std::max(cell_locs.at(ci->name).x - rx, 0);
                 int ny = ctx->rng(2 * ry + 1) + std::max(cell_locs.at(ci->name).y - ry, 0);
 
+                // For region-constrained cells, snap the probe to the tile of
+                // a random region member of the right type when one lies in
+                // the search window: a random tile in the clamped window
+                // mostly holds no region bels at all when the region is
+                // sparse within its bounding box
+                if (ci->region != nullptr && ci->region->constr_bels) {
+                    const auto &region_bels = fast_bels.getRegionBels(ci->region, ci->type);
+                    if (!region_bels.empty()) {
+                        Loc loc = ctx->getBelLocation(region_bels.at(ctx->rng(int(region_bels.size()))));
+                        if (std::abs(loc.x - cell_locs.at(ci->name).x) <= rx &&
+                            std::abs(loc.y - cell_locs.at(ci->name).y) <= ry) {
+                            nx = loc.x;
+                            ny = loc.y;
+                        }
+                    }
+                }
+
                 iter++;
                 iter_at_radius++;
                 if (iter >= (10 * (radius + 1))) {
@@ -1083,6 +1197,26 @@ class HeAPPlacer
         int x0, y0, x1, y1;
     };
 
+    // Per-tile grids used by CutSpreader, hoisted out of the spreader so
+    // they survive between its ~dozens of runs per placement: each run then
+    // clears in-place instead of reallocating W*H nested vectors, and the
+    // occupancy/cells grids are cleared and scanned sparsely via the dirty
+    // tile list rather than walking the full grid. The occupancy type
+    // dimension is sized to the largest bucket set seen so runs with fewer
+    // buckets reuse the same rows
+    struct SpreaderGrids
+    {
+        std::vector<std::vector<std::vector<int>>> occupancy;
+        std::vector<std::vector<int>> groups;
+        std::vector<std::vector<ChainExtent>> chaines;
+        // Cells at a location, sorted by real (not integer) x and y
+        std::vector<std::vector<std::vector<CellInfo *>>> cells_at_location;
+        // Tiles whose occupancy/cells rows are nonzero and need clearing
+        // before the next run; flags deduplicate the list
+        std::vector<std::vector<uint8_t>> tile_dirty;
+        std::vector<std::pair<int, int>> dirty_tiles;
+    } spreader_grids;
+
     struct SpreaderRegion
     {
         int id;
@@ -1106,7 +1240,10 @@ class HeAPPlacer
     class CutSpreader
     {
       public:
-        CutSpreader(HeAPPlacer *p, const pool<BelBucketId> &buckets) : p(p), ctx(p->ctx), buckets(buckets)
+        CutSpreader(HeAPPlacer *p, const pool<BelBucketId> &buckets)
+                : p(p), ctx(p->ctx), buckets(buckets), occupancy(p->spreader_grids.occupancy),
+                  groups(p->spreader_grids.groups), chaines(p->spreader_grids.chaines),
+                  cells_at_location(p->spreader_grids.cells_at_location)
         {
             // Get fast BELs data for all buckets being Cut/Spread.
             size_t idx = 0;
@@ -1153,24 +1290,70 @@ class HeAPPlacer
 #endif
                 workqueue.emplace(r.id, false);
             }
-            while (!workqueue.empty()) {
-                auto front = workqueue.front();
-                workqueue.pop();
-                auto &r = regions.at(front.first);
+            // Cut a region and return the child regions to enqueue, if any
+            auto process_region = [&](const std::pair<int, bool> &item, SpreaderRegion &r,
+                                      std::vector<CellInfo *> &scratch) {
+                std::vector<std::pair<int, bool>> children;
                 if (std::all_of(r.cells.begin(), r.cells.end(), [](int x) { return x == 0; }))
-                    continue;
-                auto res = cut_region(r, front.second);
+                    return children;
+                auto res = cut_region(r, item.second, scratch);
                 if (res) {
-                    workqueue.emplace(res->first, !front.second);
-                    workqueue.emplace(res->second, !front.second);
+                    children.emplace_back(res->first, !item.second);
+                    children.emplace_back(res->second, !item.second);
                 } else {
                     // Try the other dir, in case stuck in one direction only
-                    auto res2 = cut_region(r, !front.second);
+                    auto res2 = cut_region(r, !item.second, scratch);
                     if (res2) {
-                        workqueue.emplace(res2->first, front.second);
-                        workqueue.emplace(res2->second, front.second);
+                        children.emplace_back(res2->first, item.second);
+                        children.emplace_back(res2->second, item.second);
                     }
                 }
+                return children;
+            };
+            int num_workers = ThreadPool::get().num_workers();
+            if (num_workers > 1 && int(p->solve_cells.size()) >= 1000) {
+                // The two regions produced by a cut are disjoint, so they can be processed
+                // concurrently once the first cuts are made. Workers take a copy of their
+                // region under the lock so that cut_region may append to the shared region
+                // list; everything else a cut touches (cell_locs, cells_at_location, groups)
+                // stays inside its own region's bounds. Each cut depends only on its own
+                // region's cells, so the result is identical to the serial order.
+                std::condition_variable queue_cv;
+                int pending = int(workqueue.size());
+                auto worker = [&]() {
+                    std::vector<CellInfo *> scratch;
+                    std::unique_lock<std::mutex> lk(regions_mutex);
+                    while (pending > 0) {
+                        if (workqueue.empty()) {
+                            queue_cv.wait(lk);
+                            continue;
+                        }
+                        auto item = workqueue.front();
+                        workqueue.pop();
+                        SpreaderRegion r = regions.at(item.first);
+                        lk.unlock();
+                        auto children = process_region(item, r, scratch);
+                        lk.lock();
+                        for (auto &c : children) {
+                            workqueue.push(c);
+                            pending++;
+                        }
+                        pending--;
+                        if (!children.empty() || pending == 0)
+                            queue_cv.notify_all();
+                    }
+                    queue_cv.notify_all();
+                };
+                ThreadPool::get().execute([&](int) { worker(); });
+            } else {
+                std::vector<CellInfo *> scratch;
+                while (!workqueue.empty()) {
+                    auto front = workqueue.front();
+                    workqueue.pop();
+                    auto &r = regions.at(front.first);
+                    for (auto &c : process_region(front, r, scratch))
+                        workqueue.push(c);
+                }
             }
 #if 0
             if (ctx->debug) {
@@ -1191,6 +1374,12 @@ class HeAPPlacer
                 ++seq;
             }
 #endif
+            // Cutting moves cells around within region rects; mark those
+            // tiles so the next run's init() clears their cell rows
+            for (auto &r : regions)
+                for (int x = r.x0; x <= r.x1; x++)
+                    for (int y = r.y0; y <= r.y1; y++)
+                        mark_tile_dirty(x, y);
             auto endt = std::chrono::high_resolution_clock::now();
             p->cl_time += std::chrono::duration<float>(endt - startt).count();
         }
@@ -1200,17 +1389,18 @@ class HeAPPlacer
         Context *ctx;
         pool<BelBucketId> buckets;
         dict<BelBucketId, size_t> type_index;
-        std::vector<std::vector<std::vector<int>>> occupancy;
-        std::vector<std::vector<int>> groups;
-        std::vector<std::vector<ChainExtent>> chaines;
+        // Per-tile grids live on the placer (see SpreaderGrids) so they
+        // persist between runs; these are aliases for brevity
+        std::vector<std::vector<std::vector<int>>> &occupancy;
+        std::vector<std::vector<int>> &groups;
+        std::vector<std::vector<ChainExtent>> &chaines;
         std::map<IdString, ChainExtent> cell_extents;
 
         std::vector<std::vector<std::vector<std::vector<BelId>>> *> fb;
 
         std::vector<SpreaderRegion> regions;
         pool<int> merged_regions;
-        // Cells at a location, sorted by real (not integer) x and y
-        std::vector<std::vector<std::vector<CellInfo *>>> cells_at_location;
+        std::vector<std::vector<std::vector<CellInfo *>>> &cells_at_location;
 
         int occ_at(int x, int y, int type) { return occupancy.at(x).at(y).at(type); }
 
@@ -1230,16 +1420,36 @@ class HeAPPlacer
 
         void init()
         {
-            occupancy.resize(p->max_x + 1,
-                             std::vector<std::vector<int>>(p->max_y + 1, std::vector<int>(buckets.size(), 0)));
-            groups.resize(p->max_x + 1, std::vector<int>(p->max_y + 1, -1));
-            chaines.resize(p->max_x + 1, std::vector<ChainExtent>(p->max_y + 1));
-            cells_at_location.resize(p->max_x + 1, std::vector<std::vector<CellInfo *>>(p->max_y + 1));
+            auto &g = p->spreader_grids;
+            if (occupancy.empty()) {
+                // First run: size everything once; later runs reuse it
+                occupancy.resize(p->max_x + 1,
+                                 std::vector<std::vector<int>>(p->max_y + 1, std::vector<int>(buckets.size(), 0)));
+                groups.resize(p->max_x + 1, std::vector<int>(p->max_y + 1, -1));
+                chaines.resize(p->max_x + 1, std::vector<ChainExtent>(p->max_y + 1));
+                cells_at_location.resize(p->max_x + 1, std::vector<std::vector<CellInfo *>>(p->max_y + 1));
+                g.tile_dirty.resize(p->max_x + 1, std::vector<uint8_t>(p->max_y + 1, 0));
+            } else if (occupancy.at(0).at(0).size() < buckets.size()) {
+                // A larger bucket set than any seen so far; grow the type
+                // dimension (zeros appended, existing entries are cleared
+                // through the dirty list below)
+                for (auto &col : occupancy)
+                    for (auto &row : col)
+                        row.resize(buckets.size(), 0);
+            }
+            // Only tiles touched by the previous run need their occupancy
+            // and cell rows cleared
+            for (auto &loc : g.dirty_tiles) {
+                std::fill(occupancy.at(loc.first).at(loc.second).begin(), occupancy.at(loc.first).at(loc.second).end(),
+                          0);
+                cells_at_location.at(loc.first).at(loc.second).clear();
+                g.tile_dirty.at(loc.first).at(loc.second) = 0;
+            }
+            g.dirty_tiles.clear();
+            // Region growth writes groups/chaines across whole rects, so
+            // these are reset densely; plain stores, no reallocation
             for (int x = 0; x <= p->max_x; x++)
                 for (int y = 0; y <= p->max_y; y++) {
-                    for (int t = 0; t < int(buckets.size()); t++) {
-                        occupancy.at(x).at(y).at(t) = 0;
-                    }
                     groups.at(x).at(y) = -1;
                     chaines.at(x).at(y) = {x, y, x, y};
                 }
@@ -1268,6 +1478,7 @@ class HeAPPlacer
                 }
 
                 occupancy.at(cell_loc.second.x).at(cell_loc.second.y).at(cell_index(cell))++;
+                mark_tile_dirty(loc.x, loc.y);
 
                 // Compute ultimate extent of each chain root
                 if (cell.cluster != ClusterId()) {
@@ -1308,6 +1519,16 @@ class HeAPPlacer
                 }
 
                 cells_at_location.at(p->cell_locs.at(cell->name).x).at(p->cell_locs.at(cell->name).y).push_back(cell);
+                mark_tile_dirty(p->cell_locs.at(cell->name).x, p->cell_locs.at(cell->name).y);
+            }
+        }
+
+        void mark_tile_dirty(int x, int y)
+        {
+            auto &g = p->spreader_grids;
+            if (!g.tile_dirty.at(x).at(y)) {
+                g.tile_dirty.at(x).at(y) = 1;
+                g.dirty_tiles.emplace_back(x, y);
             }
         }
 
@@ -1373,8 +1594,14 @@ class HeAPPlacer
 
         void find_overused_regions()
         {
-            for (int x = 0; x <= p->max_x; x++)
-                for (int y = 0; y <= p->max_y; y++) {
+            // Only tiles with nonzero occupancy can be overutilised, so scan
+            // the dirty tile list instead of the whole grid; sorted so region
+            // ids and merges come out identical to an x-major grid walk
+            auto &dirty = p->spreader_grids.dirty_tiles;
+            std::sort(dirty.begin(), dirty.end());
+            for (auto &loc : dirty) {
+                int x = loc.first, y = loc.second;
+                {
                     // Either already in a group, or not overutilised. Ignore
                     if (groups.at(x).at(y) != -1)
                         continue;
@@ -1443,6 +1670,7 @@ class HeAPPlacer
                     }
                     regions.push_back(reg);
                 }
+            }
         }
 
         void expand_regions()
@@ -1506,9 +1734,11 @@ class HeAPPlacer
         // Implementation of the recursive cut-based spreading as described in the HeAP paper
         // Note we use "left" to mean "-x/-y" depending on dir and "right" to mean "+x/+y" depending on dir
 
-        std::vector<CellInfo *> cut_cells;
+        // Guards the shared region list (and the work queue) when cut tasks
+        // run in parallel
+        std::mutex regions_mutex;
 
-        boost::optional<std::pair<int, int>> cut_region(SpreaderRegion &r, bool dir)
+        boost::optional<std::pair<int, int>> cut_region(SpreaderRegion &r, bool dir, std::vector<CellInfo *> &cut_cells)
         {
             cut_cells.clear();
             auto &cal = cells_at_location;
@@ -1748,22 +1978,25 @@ class HeAPPlacer
                 cells_at_location.at(cl.x).at(cl.y).push_back(cell);
             }
             SpreaderRegion rl, rr;
-            rl.id = int(regions.size());
             rl.x0 = r.x0;
             rl.y0 = r.y0;
             rl.x1 = dir ? r.x1 : best_tgt_cut;
             rl.y1 = dir ? best_tgt_cut : r.y1;
             rl.cells = left_cells_v;
             rl.bels = left_bels_v;
-            rr.id = int(regions.size()) + 1;
             rr.x0 = dir ? r.x0 : (best_tgt_cut + 1);
             rr.y0 = dir ? (best_tgt_cut + 1) : r.y0;
             rr.x1 = r.x1;
             rr.y1 = r.y1;
             rr.cells = right_cells_v;
             rr.bels = right_bels_v;
-            regions.push_back(rl);
-            regions.push_back(rr);
+            {
+                std::lock_guard<std::mutex> lk(regions_mutex);
+                rl.id = int(regions.size());
+                rr.id = int(regions.size()) + 1;
+                regions.push_back(rl);
+                regions.push_back(rr);
+            }
             for (int x = rl.x0; x <= rl.x1; x++)
                 for (int y = rl.y0; y <= rl.y1; y++)
                     groups.at(x).at(y) = rl.id;
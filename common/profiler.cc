@@ -0,0 +1,167 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "profiler.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// Per-thread allocation counters, maintained by the operator new
+// replacements and the container/arena hooks below. These live outside the
+// nextpnr namespace because the allocation functions they serve must be at
+// global scope. Each thread gets its own counter node on its first counted
+// allocation, pushed onto a process-wide list that is never freed (so
+// totals survive short-lived threads); the hot path is then plain
+// load/store pairs on cache lines only the owning thread writes, rather
+// than contended atomic increments. The counters are instrumentation only
+// and never feed any algorithm.
+namespace {
+struct ThreadCounters
+{
+    std::atomic<uint64_t> count{0}, bytes{0}, hashlib_bytes{0}, arena_bytes{0};
+    ThreadCounters *next = nullptr;
+};
+std::atomic<ThreadCounters *> counters_head{nullptr};
+
+// Single-writer increment: only the owning thread writes its counters, so
+// a relaxed load/store pair avoids an atomic RMW on every allocation
+inline void bump(std::atomic<uint64_t> &ctr, uint64_t delta)
+{
+    ctr.store(ctr.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+ThreadCounters &thread_counters()
+{
+    thread_local ThreadCounters *tc = nullptr;
+    if (tc == nullptr) {
+        // malloc rather than operator new (which would recurse), and
+        // intentionally never freed so counts outlive the thread
+        void *mem = std::malloc(sizeof(ThreadCounters));
+        tc = new (mem) ThreadCounters();
+        ThreadCounters *head = counters_head.load(std::memory_order_relaxed);
+        do {
+            tc->next = head;
+        } while (!counters_head.compare_exchange_weak(head, tc, std::memory_order_release, std::memory_order_relaxed));
+    }
+    return *tc;
+}
+
+uint64_t sum_counters(std::atomic<uint64_t> ThreadCounters::*member)
+{
+    uint64_t total = 0;
+    for (ThreadCounters *tc = counters_head.load(std::memory_order_acquire); tc != nullptr; tc = tc->next)
+        total += (tc->*member).load(std::memory_order_relaxed);
+    return total;
+}
+
+void *counted_alloc(std::size_t size)
+{
+    ThreadCounters &tc = thread_counters();
+    bump(tc.count, 1);
+    bump(tc.bytes, size);
+    return std::malloc(size);
+}
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    void *ptr = counted_alloc(size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+    void *ptr = counted_alloc(size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return counted_alloc(size); }
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return counted_alloc(size); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+
+NEXTPNR_NAMESPACE_BEGIN
+
+PassProfiler &PassProfiler::get()
+{
+    static PassProfiler profiler;
+    return profiler;
+}
+
+void PassProfiler::add_pass(PassProfile &&pass)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    results.push_back(std::move(pass));
+}
+
+std::vector<PassProfile> PassProfiler::passes() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return results;
+}
+
+uint64_t profiler_alloc_count() { return sum_counters(&ThreadCounters::count); }
+
+uint64_t profiler_alloc_bytes() { return sum_counters(&ThreadCounters::bytes); }
+
+uint64_t profiler_hashlib_bytes() { return sum_counters(&ThreadCounters::hashlib_bytes); }
+
+uint64_t profiler_arena_bytes() { return sum_counters(&ThreadCounters::arena_bytes); }
+
+void profiler_note_hashlib_bytes(uint64_t bytes) { bump(thread_counters().hashlib_bytes, bytes); }
+
+void profiler_note_arena_bytes(uint64_t bytes) { bump(thread_counters().arena_bytes, bytes); }
+
+uint64_t profiler_peak_rss_kib()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(__APPLE__)
+    return uint64_t(usage.ru_maxrss) / 1024; // ru_maxrss is in bytes on macOS
+#else
+    return uint64_t(usage.ru_maxrss); // ru_maxrss is in KiB on Linux
+#endif
+#else
+    return 0;
+#endif
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,111 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Lightweight per-pass profiling. Each top-level flow stage in
+// Command::executeMain is wrapped in a ScopedPassProfile, which records its
+// wall-clock time, the number and total size of heap allocations made while
+// it ran (counted per thread by the global operator new replacements in
+// profiler.cc), and the process peak RSS when it finished. The hashlib
+// containers and the netlist object arena additionally report their growth
+// through the note hooks below, so a pass's bytes can be split into
+// container storage, arena chunks and everything else. The collected
+// records are appended to the JSON report (--report) so regressions can be
+// attributed to a specific pass without wrapping nextpnr in external tools.
+
+struct PassProfile
+{
+    std::string name;
+    double seconds;
+    uint64_t alloc_count;
+    uint64_t alloc_bytes;
+    uint64_t hashlib_bytes; // share of alloc_bytes that grew hashlib containers
+    uint64_t arena_bytes;   // share of alloc_bytes that grew object arenas
+    uint64_t peak_rss_kib;  // 0 if not available on this platform
+};
+
+struct PassProfiler
+{
+    static PassProfiler &get();
+    void add_pass(PassProfile &&pass);
+    // Snapshot of the completed passes; safe to call from the background
+    // report thread as all flow-stage guards are closed by then
+    std::vector<PassProfile> passes() const;
+
+  private:
+    mutable std::mutex lock;
+    std::vector<PassProfile> results;
+};
+
+// Cumulative process-wide allocation counters (monotonic; sample before and
+// after a region of interest and take the difference). The totals are
+// summed over per-thread counters, so they are exact whenever all worker
+// threads are quiescent - which is the case at the pass boundaries where
+// they are sampled
+uint64_t profiler_alloc_count();
+uint64_t profiler_alloc_bytes();
+uint64_t profiler_hashlib_bytes();
+uint64_t profiler_arena_bytes();
+// Category attribution hooks, called by the hashlib containers and
+// ObjectArena when their backing storage grows. Monotonic like the
+// counters above; bytes are never subtracted when storage is freed
+void profiler_note_hashlib_bytes(uint64_t bytes);
+void profiler_note_arena_bytes(uint64_t bytes);
+// Peak resident set size of the process in KiB, or 0 where unsupported
+uint64_t profiler_peak_rss_kib();
+
+struct ScopedPassProfile
+{
+    ScopedPassProfile(const std::string &name)
+            : name(name), start(std::chrono::steady_clock::now()), start_allocs(profiler_alloc_count()),
+              start_bytes(profiler_alloc_bytes()), start_hashlib(profiler_hashlib_bytes()),
+              start_arena(profiler_arena_bytes())
+    {
+    }
+    ~ScopedPassProfile()
+    {
+        PassProfile pass;
+        pass.name = name;
+        pass.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        pass.alloc_count = profiler_alloc_count() - start_allocs;
+        pass.alloc_bytes = profiler_alloc_bytes() - start_bytes;
+        pass.hashlib_bytes = profiler_hashlib_bytes() - start_hashlib;
+        pass.arena_bytes = profiler_arena_bytes() - start_arena;
+        pass.peak_rss_kib = profiler_peak_rss_kib();
+        PassProfiler::get().add_pass(std::move(pass));
+    }
+    std::string name;
+    std::chrono::steady_clock::time_point start;
+    uint64_t start_allocs, start_bytes, start_hashlib, start_arena;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
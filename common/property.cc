@@ -19,17 +19,82 @@
 
 #include "property.h"
 
+#include <mutex>
+#include <unordered_set>
+
 #include "nextpnr_namespaces.h"
 
+#ifdef NPNR_AUDIT_NETLIST_COPIES
+#include <cinttypes>
+#include "log.h"
+#endif
+
 NEXTPNR_NAMESPACE_BEGIN
 
-Property::Property() : is_string(false), str(""), intval(0) {}
+namespace {
+// Values longer than this are not pooled: they are unlikely to repeat (e.g.
+// distinct BRAM initialisation contents) and pool entries live for the
+// process lifetime. Copy-on-write sharing between Property copies still
+// applies to them
+constexpr size_t pool_max_length = 1024;
+
+struct PoolHash
+{
+    size_t operator()(const std::shared_ptr<std::string> &p) const { return std::hash<std::string>()(*p); }
+};
+struct PoolEqual
+{
+    bool operator()(const std::shared_ptr<std::string> &a, const std::shared_ptr<std::string> &b) const
+    {
+        return *a == *b;
+    }
+};
+} // namespace
+
+std::shared_ptr<std::string> PropertyStr::intern(const std::string &value)
+{
+    auto entry = std::make_shared<std::string>(value);
+    if (value.size() > pool_max_length)
+        return entry;
+    // Like the IdString database, pool entries are never freed. Guarded by a
+    // mutex so parallel passes may construct Properties
+    static std::mutex pool_mutex;
+    static std::unordered_set<std::shared_ptr<std::string>, PoolHash, PoolEqual> pool;
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    auto fnd = pool.find(entry);
+    if (fnd != pool.end())
+        return *fnd;
+    pool.insert(entry);
+    return entry;
+}
+
+const std::shared_ptr<std::string> &PropertyStr::empty_interned()
+{
+    static const std::shared_ptr<std::string> empty = intern(std::string());
+    return empty;
+}
+
+#ifdef NPNR_AUDIT_NETLIST_COPIES
+std::atomic<uint64_t> PropertyCopyAudit::copies{0};
+std::atomic<uint64_t> PropertyCopyAudit::moves{0};
+
+void property_copy_audit_report()
+{
+    log_info("Property copy audit: %" PRIu64 " copies, %" PRIu64 " moves\n",
+             PropertyCopyAudit::copies.load(std::memory_order_relaxed),
+             PropertyCopyAudit::moves.load(std::memory_order_relaxed));
+}
+#endif
+
+Property::Property() : is_string(false), str(), intval(0) {}
 
 Property::Property(int64_t intval, int width) : is_string(false), intval(intval)
 {
-    str.reserve(width);
+    std::string bits;
+    bits.reserve(width);
     for (int i = 0; i < width; i++)
-        str.push_back((intval & (1ULL << i)) ? S1 : S0);
+        bits.push_back((intval & (1ULL << i)) ? S1 : S0);
+    str = bits;
 }
 
 Property::Property(const std::string &strval) : is_string(true), str(strval), intval(0xDEADBEEF) {}
@@ -23,14 +23,115 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
+#ifdef NPNR_AUDIT_NETLIST_COPIES
+#include <atomic>
+#endif
+
 #include "nextpnr_assertions.h"
 #include "nextpnr_namespaces.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
+#ifdef NPNR_AUDIT_NETLIST_COPIES
+// Process-wide tallies of Property copies and moves, for catching
+// by-value regressions in hot construction paths (frontends, packers).
+// Off by default; enable with -DNPNR_AUDIT_NETLIST_COPIES and the totals
+// are logged at the end of the flow via property_copy_audit_report()
+struct PropertyCopyAudit
+{
+    static std::atomic<uint64_t> copies;
+    static std::atomic<uint64_t> moves;
+};
+void property_copy_audit_report();
+#endif
+
+// Interned, copy-on-write storage for Property values. Netlists from Yosys
+// carry millions of repeated attribute and parameter strings ("1", "0",
+// replicated INIT vectors); values constructed or assigned from a string are
+// deduplicated through a process-wide pool so identical values share one heap
+// allocation, in the same spirit as IdString for names (pool entries live for
+// the process lifetime). Mutation detaches to a private copy first, so
+// holders never observe writes made through another cell's attributes.
+class PropertyStr
+{
+  public:
+    PropertyStr() : s(empty_interned()) {}
+    PropertyStr(const std::string &value) : s(intern(value)) {}
+    PropertyStr(const char *value) : s(intern(std::string(value))) {}
+
+    PropertyStr(const PropertyStr &other) = default;
+    PropertyStr &operator=(const PropertyStr &other) = default;
+    // Moves steal the pointer without touching the shared refcount; the
+    // moved-from value is reset to the interned empty string rather than
+    // left null, so it stays usable like any default-constructed value
+    PropertyStr(PropertyStr &&other) noexcept : s(std::move(other.s)) { other.s = empty_interned(); }
+    PropertyStr &operator=(PropertyStr &&other) noexcept
+    {
+        s = std::move(other.s);
+        other.s = empty_interned();
+        return *this;
+    }
+
+    PropertyStr &operator=(const std::string &value)
+    {
+        s = intern(value);
+        return *this;
+    }
+    PropertyStr &operator=(const char *value)
+    {
+        s = intern(std::string(value));
+        return *this;
+    }
+
+    operator const std::string &() const { return *s; }
+    const std::string &get() const { return *s; }
+
+    const char *c_str() const { return s->c_str(); }
+    size_t size() const { return s->size(); }
+    bool empty() const { return s->empty(); }
+    char operator[](size_t i) const { return (*s)[i]; }
+    char at(size_t i) const { return s->at(i); }
+    std::string substr(size_t pos = 0, size_t len = std::string::npos) const { return s->substr(pos, len); }
+    size_t find_first_not_of(const char *chars, size_t pos = 0) const { return s->find_first_not_of(chars, pos); }
+    size_t find_last_not_of(const char *chars) const { return s->find_last_not_of(chars); }
+    std::string::const_iterator begin() const { return s->begin(); }
+    std::string::const_iterator end() const { return s->end(); }
+    std::string::const_reverse_iterator rbegin() const { return s->rbegin(); }
+    std::string::const_reverse_iterator rend() const { return s->rend(); }
+
+    // Mutable access, detaching from any shared storage first. Strings built
+    // through this are not re-interned until assigned to another PropertyStr
+    std::string &rw()
+    {
+        if (s.use_count() > 1)
+            s = std::make_shared<std::string>(*s);
+        return *s;
+    }
+    void reserve(size_t n) { rw().reserve(n); }
+    void push_back(char c) { rw().push_back(c); }
+
+    bool operator==(const PropertyStr &other) const { return s == other.s || *s == *other.s; }
+    bool operator!=(const PropertyStr &other) const { return !(*this == other); }
+    friend bool operator==(const PropertyStr &a, const std::string &b) { return *a.s == b; }
+    friend bool operator!=(const PropertyStr &a, const std::string &b) { return *a.s != b; }
+    friend bool operator==(const PropertyStr &a, const char *b) { return *a.s == b; }
+    friend bool operator!=(const PropertyStr &a, const char *b) { return *a.s != b; }
+
+  private:
+    // Implemented in property.cc; looks the value up in (or adds it to) the
+    // process-wide pool
+    static std::shared_ptr<std::string> intern(const std::string &value);
+    // The pool entry for the empty string, cached so default construction
+    // and move hand-off skip the pool lookup
+    static const std::shared_ptr<std::string> &empty_interned();
+
+    std::shared_ptr<std::string> s;
+};
+
 struct Property
 {
     enum State : char
@@ -45,12 +146,48 @@ struct Property
     Property(int64_t intval, int width = 32);
     Property(const std::string &strval);
     Property(State bit);
+
+    // Copy and move operations are all spelled out: the copy assignment used
+    // to be the only user-declared one, which suppressed the implicit moves
+    // and silently turned every move into a refcount-bumping copy. Moves
+    // matter on the netlist construction path, where values are built as
+    // temporaries and handed straight into the attrs/params dicts
+#ifdef NPNR_AUDIT_NETLIST_COPIES
+    Property(const Property &other) : is_string(other.is_string), str(other.str), intval(other.intval)
+    {
+        ++PropertyCopyAudit::copies;
+    }
+    Property(Property &&other) noexcept : is_string(other.is_string), str(std::move(other.str)), intval(other.intval)
+    {
+        ++PropertyCopyAudit::moves;
+    }
+    Property &operator=(const Property &other)
+    {
+        is_string = other.is_string;
+        str = other.str;
+        intval = other.intval;
+        ++PropertyCopyAudit::copies;
+        return *this;
+    }
+    Property &operator=(Property &&other) noexcept
+    {
+        is_string = other.is_string;
+        str = std::move(other.str);
+        intval = other.intval;
+        ++PropertyCopyAudit::moves;
+        return *this;
+    }
+#else
+    Property(const Property &other) = default;
+    Property(Property &&other) = default;
     Property &operator=(const Property &other) = default;
+    Property &operator=(Property &&other) = default;
+#endif
 
     bool is_string;
 
     // The string literal (for string values), or a string of [01xz] (for numeric values)
-    std::string str;
+    PropertyStr str;
     // The lower 64 bits (for numeric values), unused for string values
     int64_t intval;
 
@@ -78,6 +215,19 @@ struct Property
             result.push_back(c == S1);
         return result;
     }
+    // The bits of a numeric value packed into little-endian 64-bit words
+    // (bit i of the value lands in word i / 64). x and z bits pack as 0.
+    // Lets bitstream writers consume wide INIT-style values without a
+    // per-bit vector<bool> intermediate
+    std::vector<uint64_t> as_words64() const
+    {
+        NPNR_ASSERT(!is_string);
+        std::vector<uint64_t> result((str.size() + 63) / 64, 0);
+        for (size_t i = 0; i < str.size(); i++)
+            if (str[i] == S1)
+                result[i / 64] |= uint64_t(1) << (i % 64);
+        return result;
+    }
     const std::string &as_string() const
     {
         NPNR_ASSERT(is_string);
@@ -25,9 +25,12 @@
 #include "json_frontend.h"
 #include "log.h"
 #include "nextpnr.h"
+#include "router2.h"
+#include "timing.h"
 
 #include <fstream>
 #include <memory>
+#include <pybind11/numpy.h>
 #include <signal.h>
 NEXTPNR_NAMESPACE_BEGIN
 
@@ -81,10 +84,162 @@ template <> struct string_converter<Property>
     inline std::string to_str(Context *ctx, Property p) { return p.to_string(); }
 };
 
+template <> struct string_converter<std::pair<IdString, IdString>>
+{
+    inline std::pair<IdString, IdString> from_str(Context *ctx, std::string name)
+    {
+        NPNR_ASSERT_FALSE("cell.port pair from_str not implemented");
+    }
+
+    inline std::string to_str(Context *ctx, const std::pair<IdString, IdString> &p)
+    {
+        return p.first.str(ctx) + "." + p.second.str(ctx);
+    }
+};
+
+template <> struct string_converter<ClockPair>
+{
+    inline ClockPair from_str(Context *ctx, std::string name)
+    {
+        NPNR_ASSERT_FALSE("ClockPair from_str not implemented");
+    }
+
+    inline std::string to_str(Context *ctx, const ClockPair &p)
+    {
+        auto ev = [&](const ClockEvent &e) {
+            return (e.edge == FALLING_EDGE ? std::string("negedge ") : std::string("posedge ")) + e.clock.str(ctx);
+        };
+        return ev(p.start) + " -> " + ev(p.end);
+    }
+};
+
+template <> struct string_converter<CriticalPath::Segment &>
+{
+    inline CriticalPath::Segment from_str(Context *ctx, std::string name)
+    {
+        NPNR_ASSERT_FALSE("PathSegment from_str not implemented");
+    }
+
+    inline std::string to_str(Context *ctx, const CriticalPath::Segment &seg)
+    {
+        return string_converter<std::pair<IdString, IdString>>().to_str(ctx, seg.from) + " -> " +
+               string_converter<std::pair<IdString, IdString>>().to_str(ctx, seg.to);
+    }
+};
+
+template <> struct string_converter<CriticalPath &>
+{
+    inline CriticalPath from_str(Context *ctx, std::string name)
+    {
+        NPNR_ASSERT_FALSE("CriticalPath from_str not implemented");
+    }
+
+    inline std::string to_str(Context *ctx, const CriticalPath &path)
+    {
+        return string_converter<ClockPair>().to_str(ctx, path.clock_pair);
+    }
+};
+
 } // namespace PythonConversion
 
 std::string loc_repr_py(Loc loc) { return stringf("Loc(%d, %d, %d)", loc.x, loc.y, loc.z); }
 
+// Bulk NumPy exports for QoR analysis scripts. Iterating ctx.cells/ctx.nets
+// from Python creates a pybind11 proxy object per element, which dominates
+// runtime for whole-design analytics; these return the design view as flat
+// arrays in a single call, so analysis over millions of arcs is one copy
+// rather than millions of binding round-trips.
+
+// Returns {"cell": [names...], "x"/"y"/"z": int32 arrays}; unplaced cells
+// get coordinates of -1. Array order matches the "cell" name list.
+py::dict export_placements_py(Context &ctx)
+{
+    size_t n = ctx.cells.size();
+    py::list cell_names;
+    py::array_t<int32_t> x(n), y(n), z(n);
+    auto xa = x.mutable_unchecked<1>();
+    auto ya = y.mutable_unchecked<1>();
+    auto za = z.mutable_unchecked<1>();
+    size_t i = 0;
+    for (auto &cell : ctx.cells) {
+        cell_names.append(cell.first.str(&ctx));
+        Loc loc{-1, -1, -1};
+        if (cell.second->bel != BelId())
+            loc = ctx.getBelLocation(cell.second->bel);
+        xa(i) = loc.x;
+        ya(i) = loc.y;
+        za(i) = loc.z;
+        i++;
+    }
+    py::dict result;
+    result["cell"] = cell_names;
+    result["x"] = x;
+    result["y"] = y;
+    result["z"] = z;
+    return result;
+}
+
+// Returns one entry per net user arc: {"net": [names...], "net_index"/
+// "user_index": int32 arrays, "delay_ns"/"budget_ns": float64 arrays,
+// "criticality": float32 array}. "net_index" indexes into the "net" name
+// list. Delays are routed delays where routing exists, else predictions;
+// arcs with an unplaced endpoint get 0. Criticality requires a full timing
+// analysis over the placed design, so it is only computed when
+// with_criticality is set (the other columns are cheap).
+py::dict export_arc_delays_py(Context &ctx, bool with_criticality)
+{
+    size_t n = 0;
+    for (auto &net : ctx.nets)
+        if (net.second->driver.cell != nullptr)
+            n += net.second->users.size();
+
+    std::unique_ptr<TimingAnalyser> tmg;
+    if (with_criticality) {
+        tmg.reset(new TimingAnalyser(&ctx));
+        tmg->setup();
+        tmg->run();
+    }
+
+    py::list net_names;
+    py::array_t<int32_t> net_index(n), user_index(n);
+    py::array_t<double> delay_ns(n), budget_ns(n);
+    py::array_t<float> criticality(n);
+    auto nia = net_index.mutable_unchecked<1>();
+    auto uia = user_index.mutable_unchecked<1>();
+    auto da = delay_ns.mutable_unchecked<1>();
+    auto ba = budget_ns.mutable_unchecked<1>();
+    auto ca = criticality.mutable_unchecked<1>();
+    size_t i = 0;
+    int32_t net_idx = 0;
+    for (auto &net : ctx.nets) {
+        NetInfo *ni = net.second.get();
+        if (ni->driver.cell == nullptr)
+            continue;
+        net_names.append(net.first.str(&ctx));
+        for (size_t usr = 0; usr < ni->users.size(); usr++) {
+            const PortRef &sink = ni->users.at(usr);
+            nia(i) = net_idx;
+            uia(i) = int32_t(usr);
+            if (ni->driver.cell->bel != BelId() && sink.cell->bel != BelId())
+                da(i) = ctx.getDelayNS(ctx.getNetinfoRouteDelay(ni, sink));
+            else
+                da(i) = 0.0;
+            ba(i) = ctx.getDelayNS(sink.budget);
+            ca(i) = with_criticality ? tmg->get_criticality(CellPortKey(sink)) : 0.0f;
+            i++;
+        }
+        net_idx++;
+    }
+    py::dict result;
+    result["net"] = net_names;
+    result["net_index"] = net_index;
+    result["user_index"] = user_index;
+    result["delay_ns"] = delay_ns;
+    result["budget_ns"] = budget_ns;
+    result["criticality"] = criticality;
+    return result;
+}
+
 PYBIND11_EMBEDDED_MODULE(MODULE_NAME, m)
 {
     py::register_exception_translator([](std::exception_ptr p) {
@@ -185,10 +340,14 @@ PYBIND11_EMBEDDED_MODULE(MODULE_NAME, m)
                       conv_from_str<IdString>>::def_wrap(ci_cls, "name");
     readwrite_wrapper<CellInfo &, decltype(&CellInfo::type), &CellInfo::type, conv_to_str<IdString>,
                       conv_from_str<IdString>>::def_wrap(ci_cls, "type");
-    readonly_wrapper<CellInfo &, decltype(&CellInfo::attrs), &CellInfo::attrs, wrap_context<AttrMap &>>::def_wrap(
-            ci_cls, "attrs");
-    readonly_wrapper<CellInfo &, decltype(&CellInfo::params), &CellInfo::params, wrap_context<AttrMap &>>::def_wrap(
-            ci_cls, "params");
+    // attrs/params are reference members aliasing the cold data split, so
+    // they cannot go through the member-pointer wrappers
+    ci_cls.def_property_readonly("attrs", [](ContextualWrapper<CellInfo &> &wrapper) {
+        return ContextualWrapper<AttrMap &>(wrapper.ctx, wrapper.base.attrs);
+    });
+    ci_cls.def_property_readonly("params", [](ContextualWrapper<CellInfo &> &wrapper) {
+        return ContextualWrapper<AttrMap &>(wrapper.ctx, wrapper.base.params);
+    });
     readonly_wrapper<CellInfo &, decltype(&CellInfo::ports), &CellInfo::ports, wrap_context<PortMap &>>::def_wrap(
             ci_cls, "ports");
     readwrite_wrapper<CellInfo &, decltype(&CellInfo::bel), &CellInfo::bel, conv_to_str<BelId>,
@@ -251,6 +410,22 @@ PYBIND11_EMBEDDED_MODULE(MODULE_NAME, m)
 
     m.def("parse_json", parse_json_shim);
     m.def("load_design", load_design_shim, py::return_value_policy::take_ownership);
+    m.def("export_placements", export_placements_py, py::arg("ctx"));
+    m.def("export_arc_delays", export_arc_delays_py, py::arg("ctx"), py::arg("with_criticality") = false);
+
+    // Iteration-granular router2 driver for orchestrated flows: step() runs
+    // one iteration of the congestion loop and returns True while unrouted
+    // arcs remain, so scripts can inspect congestion between iterations and
+    // resume (or finish()) without re-paying chipdb load or routing setup
+    py::class_<Router2Stepper>(m, "RouterStepper")
+            .def(py::init([](Context &ctx) { return new Router2Stepper(&ctx, Router2Cfg(&ctx)); }), py::arg("ctx"),
+                 py::keep_alive<1, 2>())
+            .def("step", &Router2Stepper::step)
+            .def("finish", &Router2Stepper::finish)
+            .def("iteration", &Router2Stepper::iteration)
+            .def("overused_wires", &Router2Stepper::overused_wires)
+            .def("total_overuse", &Router2Stepper::total_overuse)
+            .def("write_tile_heatmap", &Router2Stepper::write_tile_heatmap, py::arg("filename"));
 
     auto region_cls = py::class_<ContextualWrapper<Region &>>(m, "Region");
     readwrite_wrapper<Region &, decltype(&Region::name), &Region::name, conv_to_str<IdString>,
@@ -297,9 +472,50 @@ PYBIND11_EMBEDDED_MODULE(MODULE_NAME, m)
                                 .def_readonly("achieved", &ClockFmax::achieved)
                                 .def_readonly("constraint", &ClockFmax::constraint);
 
+    py::enum_<CriticalPath::Segment::Type>(m, "PathSegmentType")
+            .value("CLK_TO_Q", CriticalPath::Segment::Type::CLK_TO_Q)
+            .value("SOURCE", CriticalPath::Segment::Type::SOURCE)
+            .value("LOGIC", CriticalPath::Segment::Type::LOGIC)
+            .value("ROUTING", CriticalPath::Segment::Type::ROUTING)
+            .value("SETUP", CriticalPath::Segment::Type::SETUP);
+
+    auto path_seg_cls = py::class_<ContextualWrapper<CriticalPath::Segment &>>(m, "PathSegment");
+    readonly_wrapper<CriticalPath::Segment &, decltype(&CriticalPath::Segment::type), &CriticalPath::Segment::type,
+                     pass_through<CriticalPath::Segment::Type>>::def_wrap(path_seg_cls, "type");
+    readonly_wrapper<CriticalPath::Segment &, decltype(&CriticalPath::Segment::net), &CriticalPath::Segment::net,
+                     conv_to_str<IdString>>::def_wrap(path_seg_cls, "net");
+    readonly_wrapper<CriticalPath::Segment &, decltype(&CriticalPath::Segment::from), &CriticalPath::Segment::from,
+                     conv_to_str<std::pair<IdString, IdString>>>::def_wrap(path_seg_cls, "from_port");
+    readonly_wrapper<CriticalPath::Segment &, decltype(&CriticalPath::Segment::to), &CriticalPath::Segment::to,
+                     conv_to_str<std::pair<IdString, IdString>>>::def_wrap(path_seg_cls, "to_port");
+    readonly_wrapper<CriticalPath::Segment &, decltype(&CriticalPath::Segment::delay), &CriticalPath::Segment::delay,
+                     pass_through<delay_t>>::def_wrap(path_seg_cls, "delay");
+    readonly_wrapper<CriticalPath::Segment &, decltype(&CriticalPath::Segment::budget), &CriticalPath::Segment::budget,
+                     pass_through<delay_t>>::def_wrap(path_seg_cls, "budget");
+
+    typedef std::vector<CriticalPath::Segment> PathSegmentVector;
+    WRAP_VECTOR(m, PathSegmentVector, wrap_context<CriticalPath::Segment &>);
+
+    auto crit_path_cls = py::class_<ContextualWrapper<CriticalPath &>>(m, "CriticalPath");
+    readonly_wrapper<CriticalPath &, decltype(&CriticalPath::clock_pair), &CriticalPath::clock_pair,
+                     conv_to_str<ClockPair>>::def_wrap(crit_path_cls, "clock_pair");
+    readonly_wrapper<CriticalPath &, decltype(&CriticalPath::delay), &CriticalPath::delay,
+                     pass_through<delay_t>>::def_wrap(crit_path_cls, "delay");
+    readonly_wrapper<CriticalPath &, decltype(&CriticalPath::period), &CriticalPath::period,
+                     pass_through<delay_t>>::def_wrap(crit_path_cls, "period");
+    readonly_wrapper<CriticalPath &, decltype(&CriticalPath::segments), &CriticalPath::segments,
+                     wrap_context<PathSegmentVector &>>::def_wrap(crit_path_cls, "segments");
+
+    typedef std::vector<CriticalPath> CriticalPathVector;
+    WRAP_VECTOR(m, CriticalPathVector, wrap_context<CriticalPath &>);
+
     auto tmg_result_cls = py::class_<ContextualWrapper<TimingResult &>>(m, "TimingResult");
     readonly_wrapper<TimingResult &, decltype(&TimingResult::clock_fmax), &TimingResult::clock_fmax,
                      wrap_context<ClockFmaxMap &>>::def_wrap(tmg_result_cls, "clock_fmax");
+    readonly_wrapper<TimingResult &, decltype(&TimingResult::xclock_paths), &TimingResult::xclock_paths,
+                     wrap_context<CriticalPathVector &>>::def_wrap(tmg_result_cls, "xclock_paths");
+    readonly_wrapper<TimingResult &, decltype(&TimingResult::worst_paths), &TimingResult::worst_paths,
+                     wrap_context<CriticalPathVector &>>::def_wrap(tmg_result_cls, "worst_paths");
     arch_wrap_python(m);
 }
 
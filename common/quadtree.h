@@ -21,7 +21,17 @@
 #define QUADTREE_H
 
 // This file implements a quad tree used for committing 2D axis aligned
-// bounding boxes and then retrieving them by 2D point.
+// bounding boxes and then retrieving them by 2D point, by intersecting
+// rectangle, or by distance to a query point.
+
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "nextpnr_namespaces.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
@@ -96,6 +106,28 @@ template <typename CoordinateT, typename ElementT> class QuadTreeNode
 
         CoordinateT w() const { return x1_ - x0_; }
         CoordinateT h() const { return y1_ - y0_; }
+
+        // Whether two bounding boxes overlap (inclusive of edges).
+        inline bool intersects(const BoundingBox &other) const
+        {
+            return !(other.x1_ < x0_ || other.x0_ > x1_ || other.y1_ < y0_ || other.y0_ > y1_);
+        }
+
+        // Squared distance from a point to this bounding box; zero if the
+        // point lies within it.
+        inline double dist2(CoordinateT x, CoordinateT y) const
+        {
+            double dx = 0, dy = 0;
+            if (x < x0_)
+                dx = double(x0_) - double(x);
+            else if (x > x1_)
+                dx = double(x) - double(x1_);
+            if (y < y0_)
+                dy = double(y0_) - double(y);
+            else if (y > y1_)
+                dy = double(y) - double(y1_);
+            return dx * dx + dy * dy;
+        }
     };
 
   private:
@@ -226,8 +258,7 @@ template <typename CoordinateT, typename ElementT> class QuadTreeNode
             return *this;
         bound_ = other.bound_;
         max_elems_ = other.max_elems_;
-        children_ = other.max_children_;
-        children_ = other.children_;
+        children_ = std::move(other.children_);
         splitx_ = other.splitx_;
         splity_ = other.splity_;
         elems_ = std::move(other.elems_);
@@ -360,6 +391,60 @@ template <typename CoordinateT, typename ElementT> class QuadTreeNode
             children_[SE].get(x, y, res);
         }
     }
+
+    // Retrieve elements whose bounding boxes intersect the given box.
+    //
+    // @param box query box
+    // @param res vector to append found elements to
+    void get_in_box(const BoundingBox &box, std::vector<ElementT> &res) const
+    {
+        if (!bound_.intersects(box))
+            return;
+
+        for (const auto &elem : elems_) {
+            if (elem.bb_.intersects(box)) {
+                res.push_back(elem.elem_);
+            }
+        }
+        if (children_ != nullptr) {
+            children_[NW].get_in_box(box, res);
+            children_[NE].get_in_box(box, res);
+            children_[SW].get_in_box(box, res);
+            children_[SE].get_in_box(box, res);
+        }
+    }
+
+    // Branch-and-bound search for the element nearest (by squared distance
+    // from its bounding box) to the given point, optionally restricted to
+    // elements satisfying a predicate. Subtrees whose bounds are further away
+    // than the best element found so far are pruned; ties keep the first
+    // element found in traversal order, so results are deterministic.
+    //
+    // @param x X coordinate of query point
+    // @param y Y coordinate of query point
+    // @param accept optional predicate an element must satisfy
+    // @param best_dist in/out: squared distance of best element so far
+    // @param best in/out: best element so far, or nullptr
+    void nearest(CoordinateT x, CoordinateT y, const std::function<bool(const ElementT &)> &accept, double &best_dist,
+                 const ElementT *&best) const
+    {
+        if (bound_.dist2(x, y) > best_dist)
+            return;
+
+        for (const auto &elem : elems_) {
+            double d = elem.bb_.dist2(x, y);
+            if (d < best_dist && (!accept || accept(elem.elem_))) {
+                best = &elem.elem_;
+                best_dist = d;
+            }
+        }
+        if (children_ != nullptr) {
+            children_[NW].nearest(x, y, accept, best_dist, best);
+            children_[NE].nearest(x, y, accept, best_dist, best);
+            children_[SW].nearest(x, y, accept, best_dist, best);
+            children_[SE].nearest(x, y, accept, best_dist, best);
+        }
+    }
 };
 
 // User facing method to manage a quad tree.
@@ -415,6 +500,40 @@ template <typename CoordinateT, typename ElementT> class QuadTree
         root_.get(x, y, res);
         return res;
     }
+
+    // Retrieve all elements whose bounding boxes intersect the given box
+    // (inclusive of edges), appending them to 'res'.
+    //
+    // @param b query box
+    // @param res vector to append found elements to
+    void get_in_box(BoundingBox b, std::vector<ElementT> &res) const
+    {
+        b.fixup();
+        root_.get_in_box(b, res);
+    }
+
+    // Find the element nearest to the given point, optionally restricted to
+    // elements satisfying a predicate. Distance is the squared Euclidean
+    // distance from the point to the element's bounding box (zero if the
+    // point lies within it). Ties are broken by traversal order, so the
+    // result is deterministic for a given insertion order.
+    //
+    // @param x X coordinate of query point
+    // @param y Y coordinate of query point
+    // @param out set to the nearest element, if any
+    // @param accept optional predicate an element must satisfy
+    // @returns whether an element was found
+    bool nearest(CoordinateT x, CoordinateT y, ElementT &out,
+                 const std::function<bool(const ElementT &)> &accept = {}) const
+    {
+        double best_dist = std::numeric_limits<double>::infinity();
+        const ElementT *best = nullptr;
+        root_.nearest(x, y, accept, best_dist, best);
+        if (best == nullptr)
+            return false;
+        out = *best;
+        return true;
+    }
 };
 
 NEXTPNR_NAMESPACE_END
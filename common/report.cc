@@ -19,6 +19,7 @@
 
 #include "json11.hpp"
 #include "nextpnr.h"
+#include "profiler.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
@@ -51,53 +52,54 @@ static std::string clock_event_name(const Context *ctx, const ClockEvent &e)
     return value;
 };
 
-static Json::array report_critical_paths(const Context *ctx)
+static Json::array report_path_segments(const Context *ctx, const CriticalPath &report)
 {
-
-    auto report_critical_path = [ctx](const CriticalPath &report) {
-        Json::array pathJson;
-
-        for (const auto &segment : report.segments) {
-
-            const auto &driver = ctx->cells.at(segment.from.first);
-            const auto &sink = ctx->cells.at(segment.to.first);
-
-            auto fromLoc = ctx->getBelLocation(driver->bel);
-            auto toLoc = ctx->getBelLocation(sink->bel);
-
-            auto fromJson = Json::object({{"cell", segment.from.first.c_str(ctx)},
-                                          {"port", segment.from.second.c_str(ctx)},
-                                          {"loc", Json::array({fromLoc.x, fromLoc.y})}});
-
-            auto toJson = Json::object({{"cell", segment.to.first.c_str(ctx)},
-                                        {"port", segment.to.second.c_str(ctx)},
-                                        {"loc", Json::array({toLoc.x, toLoc.y})}});
-
-            auto segmentJson = Json::object({
-                    {"delay", ctx->getDelayNS(segment.delay)},
-                    {"from", fromJson},
-                    {"to", toJson},
-            });
-
-            if (segment.type == CriticalPath::Segment::Type::CLK_TO_Q) {
-                segmentJson["type"] = "clk-to-q";
-            } else if (segment.type == CriticalPath::Segment::Type::SOURCE) {
-                segmentJson["type"] = "source";
-            } else if (segment.type == CriticalPath::Segment::Type::LOGIC) {
-                segmentJson["type"] = "logic";
-            } else if (segment.type == CriticalPath::Segment::Type::SETUP) {
-                segmentJson["type"] = "setup";
-            } else if (segment.type == CriticalPath::Segment::Type::ROUTING) {
-                segmentJson["type"] = "routing";
-                segmentJson["net"] = segment.net.c_str(ctx);
-                segmentJson["budget"] = ctx->getDelayNS(segment.budget);
-            }
-
-            pathJson.push_back(segmentJson);
+    Json::array pathJson;
+
+    for (const auto &segment : report.segments) {
+
+        const auto &driver = ctx->cells.at(segment.from.first);
+        const auto &sink = ctx->cells.at(segment.to.first);
+
+        auto fromLoc = ctx->getBelLocation(driver->bel);
+        auto toLoc = ctx->getBelLocation(sink->bel);
+
+        auto fromJson = Json::object({{"cell", segment.from.first.c_str(ctx)},
+                                      {"port", segment.from.second.c_str(ctx)},
+                                      {"loc", Json::array({fromLoc.x, fromLoc.y})}});
+
+        auto toJson = Json::object({{"cell", segment.to.first.c_str(ctx)},
+                                    {"port", segment.to.second.c_str(ctx)},
+                                    {"loc", Json::array({toLoc.x, toLoc.y})}});
+
+        auto segmentJson = Json::object({
+                {"delay", ctx->getDelayNS(segment.delay)},
+                {"from", fromJson},
+                {"to", toJson},
+        });
+
+        if (segment.type == CriticalPath::Segment::Type::CLK_TO_Q) {
+            segmentJson["type"] = "clk-to-q";
+        } else if (segment.type == CriticalPath::Segment::Type::SOURCE) {
+            segmentJson["type"] = "source";
+        } else if (segment.type == CriticalPath::Segment::Type::LOGIC) {
+            segmentJson["type"] = "logic";
+        } else if (segment.type == CriticalPath::Segment::Type::SETUP) {
+            segmentJson["type"] = "setup";
+        } else if (segment.type == CriticalPath::Segment::Type::ROUTING) {
+            segmentJson["type"] = "routing";
+            segmentJson["net"] = segment.net.c_str(ctx);
+            segmentJson["budget"] = ctx->getDelayNS(segment.budget);
         }
 
-        return pathJson;
-    };
+        pathJson.push_back(segmentJson);
+    }
+
+    return pathJson;
+}
+
+static Json::array report_critical_paths(const Context *ctx)
+{
 
     auto critPathsJson = Json::array();
 
@@ -106,19 +108,35 @@ static Json::array report_critical_paths(const Context *ctx)
 
         critPathsJson.push_back(Json::object({{"from", clock_event_name(ctx, report.second.clock_pair.start)},
                                               {"to", clock_event_name(ctx, report.second.clock_pair.end)},
-                                              {"path", report_critical_path(report.second)}}));
+                                              {"path", report_path_segments(ctx, report.second)}}));
     }
 
     // Cross-domain paths
     for (auto &report : ctx->timing_result.xclock_paths) {
         critPathsJson.push_back(Json::object({{"from", clock_event_name(ctx, report.clock_pair.start)},
                                               {"to", clock_event_name(ctx, report.clock_pair.end)},
-                                              {"path", report_critical_path(report)}}));
+                                              {"path", report_path_segments(ctx, report)}}));
     }
 
     return critPathsJson;
 }
 
+static Json::array report_worst_paths(const Context *ctx)
+{
+    auto worstPathsJson = Json::array();
+
+    for (auto &report : ctx->timing_result.worst_paths) {
+        worstPathsJson.push_back(Json::object({{"from", clock_event_name(ctx, report.clock_pair.start)},
+                                               {"to", clock_event_name(ctx, report.clock_pair.end)},
+                                               {"delay", ctx->getDelayNS(report.delay)},
+                                               {"period", ctx->getDelayNS(report.period)},
+                                               {"slack", ctx->getDelayNS(report.period - report.delay)},
+                                               {"path", report_path_segments(ctx, report)}}));
+    }
+
+    return worstPathsJson;
+}
+
 static Json::array report_detailed_net_timings(const Context *ctx)
 {
     auto detailedNetTimingsJson = Json::array();
@@ -206,6 +224,17 @@ Report JSON structure:
     },
     ...
   ],
+  "worst_paths": [
+    {
+      "from": <clock event edge and name>,
+      "to": <clock event edge and name>,
+      "delay": <path delay [ns]>,
+      "period": <maximum allowed delay [ns]>,
+      "slack": <path slack [ns]>,
+      "path": [ <same segment structure as critical_paths> ]
+    },
+    ...
+  ],
   "detailed_net_timings": [
     {
       "driver": <driving cell name>,
@@ -224,6 +253,18 @@ Report JSON structure:
       ]
     }
     ...
+  ],
+  "profile": [
+    {
+      "pass": <flow stage name>,
+      "seconds": <wall-clock time [s]>,
+      "alloc_count": <heap allocations made during the pass>,
+      "alloc_bytes": <total bytes requested from the heap during the pass>,
+      "hashlib_bytes": <share of alloc_bytes that grew hashlib containers>,
+      "arena_bytes": <share of alloc_bytes that grew netlist object arenas>,
+      "peak_rss_kib": <process peak RSS when the pass finished [KiB], 0 if unknown>
+    }
+    ...
   ]
 }
 */
@@ -249,10 +290,29 @@ void Context::writeReport(std::ostream &out) const
     Json::object jsonRoot{
             {"utilization", util_json}, {"fmax", fmax_json}, {"critical_paths", report_critical_paths(this)}};
 
+    if (!timing_result.worst_paths.empty()) {
+        jsonRoot["worst_paths"] = report_worst_paths(this);
+    }
+
     if (detailed_timing_report) {
         jsonRoot["detailed_net_timings"] = report_detailed_net_timings(this);
     }
 
+    auto passes = PassProfiler::get().passes();
+    if (!passes.empty()) {
+        Json::array profileJson;
+        for (const auto &pass : passes) {
+            profileJson.push_back(Json::object{{"pass", pass.name},
+                                               {"seconds", pass.seconds},
+                                               {"alloc_count", double(pass.alloc_count)},
+                                               {"alloc_bytes", double(pass.alloc_bytes)},
+                                               {"hashlib_bytes", double(pass.hashlib_bytes)},
+                                               {"arena_bytes", double(pass.arena_bytes)},
+                                               {"peak_rss_kib", double(pass.peak_rss_kib)}});
+        }
+        jsonRoot["profile"] = profileJson;
+    }
+
     out << Json(jsonRoot).dump() << std::endl;
 }
 
@@ -0,0 +1,238 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "route_hints.h"
+#include <sstream>
+#include <unordered_map>
+#include "log.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+
+// Same layout scheme as the checkpoint format: header (magic, version),
+// string table, body, all little-endian, with every name in the body a
+// 32-bit index into the string table
+static const uint32_t hints_magic = 0x544E4852; // "RHNT"
+static const uint32_t hints_version = 1;
+
+struct HintsWriter
+{
+    HintsWriter(Context *ctx) : ctx(ctx){};
+    Context *ctx;
+
+    std::ostringstream body;
+    std::vector<const std::string *> strings;
+    std::unordered_map<std::string, uint32_t> string_idx;
+
+    void put_u8(std::ostream &out, uint8_t value) { out.put(char(value)); }
+    void put_u32(std::ostream &out, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            out.put(char((value >> (8 * i)) & 0xFF));
+    }
+
+    void put_str(const std::string &value)
+    {
+        auto fnd = string_idx.find(value);
+        if (fnd == string_idx.end()) {
+            fnd = string_idx.emplace(value, uint32_t(strings.size())).first;
+            strings.push_back(&fnd->first);
+        }
+        put_u32(body, fnd->second);
+    }
+
+    void write_body()
+    {
+        uint32_t nrouted = 0;
+        for (auto &net : ctx->nets)
+            if (!net.second->wires.empty())
+                nrouted++;
+        put_u32(body, nrouted);
+        for (auto &net : ctx->nets) {
+            NetInfo *ni = net.second.get();
+            if (ni->wires.empty())
+                continue;
+            put_str(ni->name.str(ctx));
+            put_u32(body, uint32_t(ni->wires.size()));
+            for (auto &wire : ni->wires) {
+                // Wires driven through a pip are identified by the pip name
+                // alone; the destination wire is rederived on load. Root
+                // wires (bound directly to the net source) have no pip
+                put_u8(body, wire.second.pip != PipId() ? 1 : 0);
+                if (wire.second.pip != PipId())
+                    put_str(ctx->getPipName(wire.second.pip).str(ctx));
+                else
+                    put_str(ctx->getWireName(wire.first).str(ctx));
+            }
+        }
+    }
+
+    void operator()(std::ostream &out)
+    {
+        write_body();
+        put_u32(out, hints_magic);
+        put_u32(out, hints_version);
+        put_u32(out, uint32_t(strings.size()));
+        for (auto str : strings) {
+            put_u32(out, uint32_t(str->size()));
+            out.write(str->data(), str->size());
+        }
+        std::string body_str = body.str();
+        out.write(body_str.data(), body_str.size());
+    }
+};
+
+struct HintsReader
+{
+    HintsReader(std::istream &in, const std::string &filename, Context *ctx) : in(in), filename(filename), ctx(ctx){};
+    std::istream &in;
+    std::string filename;
+    Context *ctx;
+
+    std::vector<std::string> strings;
+
+    uint8_t get_u8()
+    {
+        int c = in.get();
+        if (c == EOF)
+            log_error("unexpected end of file parsing hints '%s'\n", filename.c_str());
+        return uint8_t(c);
+    }
+    uint32_t get_u32()
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++)
+            value |= uint32_t(get_u8()) << (8 * i);
+        return value;
+    }
+    const std::string &get_str()
+    {
+        uint32_t idx = get_u32();
+        if (idx >= strings.size())
+            log_error("invalid string reference parsing hints '%s'\n", filename.c_str());
+        return strings.at(idx);
+    }
+
+    void operator()()
+    {
+        if (get_u32() != hints_magic)
+            log_error("'%s' is not a route hints file\n", filename.c_str());
+        uint32_t version = get_u32();
+        if (version != hints_version)
+            log_error("hints file '%s' has version %u, expected %u (regenerate it with this nextpnr build)\n",
+                      filename.c_str(), unsigned(version), unsigned(hints_version));
+        uint32_t nstrings = get_u32();
+        strings.resize(nstrings);
+        for (uint32_t i = 0; i < nstrings; i++) {
+            uint32_t len = get_u32();
+            strings.at(i).resize(len);
+            in.read(&strings.at(i)[0], len);
+            if (!in)
+                log_error("unexpected end of file parsing hints '%s'\n", filename.c_str());
+        }
+
+        // Hints are best-effort: anything that no longer resolves in the
+        // current netlist is dropped without comment and the net is left
+        // for the router, which validates and rips up stale arcs anyway
+        int applied = 0, dropped = 0;
+        uint32_t nnets = get_u32();
+        for (uint32_t i = 0; i < nnets; i++) {
+            const std::string &net_name = get_str();
+            auto fnd_net = ctx->nets.find(ctx->id(net_name));
+            NetInfo *ni = (fnd_net != ctx->nets.end()) ? fnd_net->second.get() : nullptr;
+            // Skip nets that already carry routing (globals, constraints)
+            if (ni != nullptr && !ni->wires.empty())
+                ni = nullptr;
+            // Applied bindings, so a net that fails partway can be ripped up
+            // and left entirely to the router
+            std::vector<std::pair<WireId, PipId>> bound;
+            bool failed = (ni == nullptr);
+            uint32_t nwires = get_u32();
+            for (uint32_t j = 0; j < nwires; j++) {
+                bool has_pip = (get_u8() != 0);
+                const std::string &name = get_str();
+                if (failed)
+                    continue;
+                if (has_pip) {
+                    PipId pip = ctx->getPipByNameStr(name);
+                    if (pip == PipId() || !ctx->checkPipAvail(pip) ||
+                        !ctx->checkWireAvail(ctx->getPipDstWire(pip))) {
+                        failed = true;
+                        continue;
+                    }
+                    ctx->bindPip(pip, ni, STRENGTH_WEAK);
+                    bound.emplace_back(ctx->getPipDstWire(pip), pip);
+                } else {
+                    WireId wire = ctx->getWireByNameStr(name);
+                    if (wire == WireId() || !ctx->checkWireAvail(wire)) {
+                        failed = true;
+                        continue;
+                    }
+                    ctx->bindWire(wire, ni, STRENGTH_WEAK);
+                    bound.emplace_back(wire, PipId());
+                }
+            }
+            if (failed) {
+                for (auto &b : bound) {
+                    if (b.second != PipId())
+                        ctx->unbindPip(b.second);
+                    else
+                        ctx->unbindWire(b.first);
+                }
+                dropped++;
+            } else if (!bound.empty()) {
+                applied++;
+            }
+        }
+
+        log_info("Applied route hints '%s': %d nets seeded, %d dropped\n", filename.c_str(), applied, dropped);
+    }
+};
+
+} // namespace
+
+bool write_route_hints(std::ostream &out, const std::string &filename, Context *ctx)
+{
+    try {
+        if (!out)
+            log_error("failed to open route hints file '%s' for writing\n", filename.c_str());
+        HintsWriter writer(ctx);
+        writer(out);
+        log_info("Wrote route hints '%s'\n", filename.c_str());
+        return true;
+    } catch (log_execution_error_exception) {
+        return false;
+    }
+}
+
+bool read_route_hints(std::istream &in, const std::string &filename, Context *ctx)
+{
+    try {
+        if (!in)
+            log_error("failed to open route hints file '%s'\n", filename.c_str());
+        HintsReader reader(in, filename, ctx);
+        reader();
+        return true;
+    } catch (log_execution_error_exception) {
+        return false;
+    }
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,39 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef ROUTE_HINTS_H
+#define ROUTE_HINTS_H
+
+#include <iostream>
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Routing hints for incremental flows: per-net pip trees from a previous run,
+// keyed by net name, applied as weak bindings just before routing so the
+// router starts from the old solution and only reworks what changed. Unlike a
+// checkpoint this is best-effort by design - any net whose name, source wire
+// or pips no longer resolve is silently left unrouted (a summary is printed),
+// so hints from a 95%-identical netlist are still worth applying.
+bool write_route_hints(std::ostream &out, const std::string &filename, Context *ctx);
+bool read_route_hints(std::istream &in, const std::string &filename, Context *ctx);
+
+NEXTPNR_NAMESPACE_END
+
+#endif /* ROUTE_HINTS_H */
@@ -17,11 +17,13 @@
  *
  */
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <queue>
 
 #include "log.h"
+#include "object_arena.h"
 #include "router1.h"
 #include "scope_lock.h"
 #include "timing.h"
@@ -103,9 +105,34 @@ struct Router1
     Context *ctx;
     const Router1Cfg &cfg;
 
-    std::priority_queue<arc_entry, std::vector<arc_entry>, arc_entry::Less> arc_queue;
-    dict<WireId, pool<arc_key>> wire_to_arcs;
-    dict<arc_key, pool<WireId>> arc_to_wires;
+    // Arcs awaiting (re-)routing, partitioned into criticality bands. A
+    // single priority queue pays O(log n) heap maintenance per entry, and a
+    // net ripup reinserts all of its arcs at once; here an insert is an
+    // append, bands are drained from most critical to least, and a band is
+    // only sorted when it is about to be drained and inserts have dirtied it
+    // since the last sort. Draining order matches the old global queue up to
+    // band granularity and depends on nothing but the entries themselves, so
+    // routing stays deterministic for a given seed.
+    static const int num_arc_bands = 8;
+    std::vector<arc_entry> arc_bands[num_arc_bands];
+    bool arc_band_dirty[num_arc_bands] = {};
+    // One node per (arc, wire) occupancy, sitting on two intrusive doubly
+    // linked lists: the wire's list of arcs and the arc's list of wires.
+    // Ripping up a wire (or rerouting an arc) then unlinks exactly its own
+    // memberships with pointer writes; the old pool-of-keys representation
+    // paid a hash lookup and set erase per membership, which is where deep
+    // ripup cascades on congested designs spend their time. The dicts below
+    // only hold list heads, and nodes are recycled through an arena.
+    struct arc_wire_link
+    {
+        arc_key arc;
+        WireId wire;
+        arc_wire_link *wire_prev, *wire_next; // other arcs on this wire
+        arc_wire_link *arc_prev, *arc_next;   // other wires on this arc
+    };
+    ObjectArena<arc_wire_link> link_arena;
+    dict<WireId, arc_wire_link *> wire_to_arcs;
+    dict<arc_key, arc_wire_link *> arc_to_wires;
     pool<arc_key> queued_arcs;
 
     std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> queue;
@@ -124,6 +151,9 @@ struct Router1
     Router1(Context *ctx, const Router1Cfg &cfg) : ctx(ctx), cfg(cfg), tmg(ctx)
     {
         timing_driven = ctx->setting<bool>("timing_driven");
+        // STA re-runs during routing; damp the per-arc criticality so arc
+        // priorities track real slack change rather than reroute noise
+        tmg.damped_criticality = true;
         tmg.setup();
         tmg.run();
     }
@@ -133,8 +163,8 @@ struct Router1
         if (queued_arcs.count(arc))
             return;
 
-        delay_t pri = ctx->estimateDelay(src_wire, dst_wire) *
-                      (100 * tmg.get_criticality(CellPortKey(arc.net_info->users.at(arc.user_idx))));
+        float crit = tmg.get_criticality(arc.net_info, arc.user_idx);
+        delay_t pri = ctx->estimateDelay(src_wire, dst_wire) * (100 * crit);
 
         arc_entry entry;
         entry.arc = arc;
@@ -147,7 +177,14 @@ struct Router1
                 ctx->nameOfWire(src_wire), ctx->nameOfWire(dst_wire), (int)entry.pri, entry.randtag);
 #endif
 
-        arc_queue.push(entry);
+        int band = int(crit * num_arc_bands);
+        if (band < 0)
+            band = 0;
+        if (band >= num_arc_bands)
+            band = num_arc_bands - 1;
+
+        arc_bands[band].push_back(entry);
+        arc_band_dirty[band] = true;
         queued_arcs.insert(arc);
     }
 
@@ -168,17 +205,131 @@ struct Router1
 
     arc_key arc_queue_pop()
     {
-        arc_entry entry = arc_queue.top();
+        for (int band = num_arc_bands - 1; band >= 0; band--) {
+            auto &entries = arc_bands[band];
+            if (entries.empty())
+                continue;
+
+            if (arc_band_dirty[band]) {
+                // sorted ascending so the band's best entry sits at the back
+                std::stable_sort(entries.begin(), entries.end(), arc_entry::Less());
+                arc_band_dirty[band] = false;
+            }
+
+            arc_entry entry = entries.back();
+            entries.pop_back();
 
 #if 0
-        if (ctx->debug)
-            log("[arc_queue_pop] %s (%d) [%d %d]\n", ctx->nameOf(entry.arc.net_info), entry.arc.user_idx,
-                (int)entry.pri, entry.randtag);
+            if (ctx->debug)
+                log("[arc_queue_pop] %s (%d) [%d %d]\n", ctx->nameOf(entry.arc.net_info), entry.arc.user_idx,
+                    (int)entry.pri, entry.randtag);
 #endif
 
-        arc_queue.pop();
-        queued_arcs.erase(entry.arc);
-        return entry.arc;
+            queued_arcs.erase(entry.arc);
+            return entry.arc;
+        }
+
+        NPNR_ASSERT_FALSE("arc_queue_pop called on empty queue");
+    }
+
+    bool arc_queue_empty() const { return queued_arcs.empty(); }
+
+    size_t arc_queue_size() const { return queued_arcs.size(); }
+
+    // Record that an arc occupies a wire: push a fresh membership node onto
+    // the front of both lists
+    void add_arc_wire(const arc_key &arc, WireId wire)
+    {
+        arc_wire_link *l = new (link_arena.alloc()) arc_wire_link;
+        l->arc = arc;
+        l->wire = wire;
+        arc_wire_link *&wire_head = wire_to_arcs[wire];
+        l->wire_prev = nullptr;
+        l->wire_next = wire_head;
+        if (wire_head != nullptr)
+            wire_head->wire_prev = l;
+        wire_head = l;
+        arc_wire_link *&arc_head = arc_to_wires[arc];
+        l->arc_prev = nullptr;
+        l->arc_next = arc_head;
+        if (arc_head != nullptr)
+            arc_head->arc_prev = l;
+        arc_head = l;
+    }
+
+    // Unlink a node from its arc's wire list; the head dict is only touched
+    // when the node is at the front. The caller handles the wire side
+    void unlink_from_arc(arc_wire_link *l)
+    {
+        if (l->arc_next != nullptr)
+            l->arc_next->arc_prev = l->arc_prev;
+        if (l->arc_prev != nullptr)
+            l->arc_prev->arc_next = l->arc_next;
+        else
+            arc_to_wires.at(l->arc) = l->arc_next;
+    }
+
+    // Unlink a node from its wire's arc list; returns true if this was the
+    // wire's last arc (i.e. the wire is no longer needed by any arc)
+    bool unlink_from_wire(arc_wire_link *l)
+    {
+        if (l->wire_next != nullptr)
+            l->wire_next->wire_prev = l->wire_prev;
+        if (l->wire_prev != nullptr)
+            l->wire_prev->wire_next = l->wire_next;
+        else
+            wire_to_arcs.at(l->wire) = l->wire_next;
+        return l->wire_prev == nullptr && l->wire_next == nullptr;
+    }
+
+    // Detach every arc from wire w, collecting the affected arcs so the
+    // caller can requeue them; used on ripup, where all of the wire's
+    // memberships go away at once
+    void take_wire_arcs(WireId w, std::vector<arc_key> &arcs)
+    {
+        auto it = wire_to_arcs.find(w);
+        if (it == wire_to_arcs.end())
+            return;
+        arc_wire_link *next = nullptr;
+        for (arc_wire_link *l = it->second; l != nullptr; l = next) {
+            next = l->wire_next;
+            unlink_from_arc(l);
+            arcs.push_back(l->arc);
+            link_arena.free(l);
+        }
+        it->second = nullptr;
+    }
+
+    // Drop all of an arc's wire memberships, unbinding wires this arc was
+    // the last user of; called when an arc is about to be rerouted
+    void release_arc_wires(const arc_key &arc)
+    {
+        auto it = arc_to_wires.find(arc);
+        if (it == arc_to_wires.end())
+            return;
+        arc_wire_link *next = nullptr;
+        for (arc_wire_link *l = it->second; l != nullptr; l = next) {
+            next = l->arc_next;
+            if (unlink_from_wire(l)) {
+                if (ctx->debug)
+                    log("  unbind %s\n", ctx->nameOfWire(l->wire));
+                ctx->unbindWire(l->wire);
+            }
+            link_arena.free(l);
+        }
+        it->second = nullptr;
+    }
+
+    // Debug-build check() helper: linear scan of a wire's membership list
+    bool wire_has_arc(WireId wire, const arc_key &arc) const
+    {
+        auto it = wire_to_arcs.find(wire);
+        if (it == wire_to_arcs.end())
+            return false;
+        for (arc_wire_link *l = it->second; l != nullptr; l = l->wire_next)
+            if (l->arc == arc)
+                return true;
+        return false;
     }
 
     void ripup_net(NetInfo *net)
@@ -196,11 +347,7 @@ struct Router1
 
         for (WireId w : wires) {
             std::vector<arc_key> arcs;
-            for (auto &it : wire_to_arcs[w]) {
-                arc_to_wires[it].erase(w);
-                arcs.push_back(it);
-            }
-            wire_to_arcs[w].clear();
+            take_wire_arcs(w, arcs);
 
             ctx->sorted_shuffle(arcs);
 
@@ -230,11 +377,7 @@ struct Router1
                 ripup_net(n);
         } else {
             std::vector<arc_key> arcs;
-            for (auto &it : wire_to_arcs[w]) {
-                arc_to_wires[it].erase(w);
-                arcs.push_back(it);
-            }
-            wire_to_arcs[w].clear();
+            take_wire_arcs(w, arcs);
 
             ctx->sorted_shuffle(arcs);
 
@@ -264,11 +407,7 @@ struct Router1
                 ripup_net(n);
         } else {
             std::vector<arc_key> arcs;
-            for (auto &it : wire_to_arcs[w]) {
-                arc_to_wires[it].erase(w);
-                arcs.push_back(it);
-            }
-            wire_to_arcs[w].clear();
+            take_wire_arcs(w, arcs);
 
             ctx->sorted_shuffle(arcs);
 
@@ -287,12 +426,11 @@ struct Router1
 
     bool skip_net(NetInfo *net_info)
     {
-#ifdef ARCH_ECP5
-        // ECP5 global nets currently appear part-unrouted due to arch database limitations
-        // Don't touch them in the router
-        if (net_info->is_global)
-            return true;
-#endif
+        // Separately-routed global nets appear part-unrouted to the general
+        // machinery; don't touch them in the router
+        if (Arch::capGlobalsRoutedSeparately)
+            if (net_info->is_global)
+                return true;
         if (net_info->driver.cell == nullptr)
             return true;
 
@@ -333,13 +471,16 @@ struct Router1
                     log("[check]   arc: %s %s\n", ctx->nameOfWire(src_wire), ctx->nameOfWire(dst_wire));
 #endif
 
-                    for (WireId wire : arc_to_wires[arc]) {
+                    auto arc_it = arc_to_wires.find(arc);
+                    arc_wire_link *head = (arc_it != arc_to_wires.end()) ? arc_it->second : nullptr;
+                    for (arc_wire_link *l = head; l != nullptr; l = l->arc_next) {
+                        WireId wire = l->wire;
 #if 0
                         if (ctx->debug)
                         log("[check]     wire: %s\n", ctx->nameOfWire(wire));
 #endif
                         valid_wires_for_net.insert(wire);
-                        log_assert(wire_to_arcs[wire].count(arc));
+                        log_assert(wire_has_arc(wire, arc));
                         log_assert(net_info->wires.count(wire));
                     }
                 }
@@ -352,8 +493,8 @@ struct Router1
         }
 
         for (auto &it : wire_to_arcs) {
-            for (auto &arc : it.second)
-                log_assert(valid_arcs.count(arc));
+            for (arc_wire_link *l = it.second; l != nullptr; l = l->wire_next)
+                log_assert(valid_arcs.count(l->arc));
         }
 
         for (auto &it : arc_to_wires) {
@@ -422,8 +563,7 @@ struct Router1
                     }
 
                     WireId cursor = dst_wire;
-                    wire_to_arcs[cursor].insert(arc);
-                    arc_to_wires[arc].insert(cursor);
+                    add_arc_wire(arc, cursor);
 
                     while (src_wire != cursor) {
                         auto it = net_info->wires.find(cursor);
@@ -434,8 +574,7 @@ struct Router1
 
                         NPNR_ASSERT(it->second.pip != PipId());
                         cursor = ctx->getPipSrcWire(it->second.pip);
-                        wire_to_arcs[cursor].insert(arc);
-                        arc_to_wires[arc].insert(cursor);
+                        add_arc_wire(arc, cursor);
                     }
                 }
                 // TODO: this matches the situation before supporting multiple cell->bel pins, but do we want to keep
@@ -469,7 +608,7 @@ struct Router1
         auto dst_wire = ctx->getNetinfoSinkWire(net_info, net_info->users[user_idx], arc.phys_idx);
         ripup_flag = false;
 
-        float crit = tmg.get_criticality(CellPortKey(net_info->users.at(user_idx)));
+        float crit = tmg.get_criticality(net_info, user_idx);
 
         if (ctx->debug) {
             log("Routing arc %d on net %s (%d arcs total):\n", user_idx, ctx->nameOf(net_info),
@@ -480,19 +619,7 @@ struct Router1
 
         // unbind wires that are currently used exclusively by this arc
 
-        pool<WireId> old_arc_wires;
-        old_arc_wires.swap(arc_to_wires[arc]);
-
-        for (WireId wire : old_arc_wires) {
-            auto &arc_wires = wire_to_arcs.at(wire);
-            NPNR_ASSERT(arc_wires.count(arc));
-            arc_wires.erase(arc);
-            if (arc_wires.empty()) {
-                if (ctx->debug)
-                    log("  unbind %s\n", ctx->nameOfWire(wire));
-                ctx->unbindWire(wire);
-            }
-        }
+        release_arc_wires(arc);
 
         // special case
 
@@ -503,8 +630,7 @@ struct Router1
             else {
                 ctx->bindWire(src_wire, net_info, STRENGTH_WEAK);
             }
-            arc_to_wires[arc].insert(src_wire);
-            wire_to_arcs[src_wire].insert(arc);
+            add_arc_wire(arc, src_wire);
             return true;
         }
 
@@ -731,8 +857,6 @@ struct Router1
 
         // bind resulting route (and maybe unroute other nets)
 
-        pool<WireId> unassign_wires = arc_to_wires[arc];
-
         WireId cursor = dst_wire;
         delay_t accumulated_path_delay = 0;
         delay_t last_path_delay_delta = 0;
@@ -777,8 +901,7 @@ struct Router1
                 }
             }
 
-            wire_to_arcs[cursor].insert(arc);
-            arc_to_wires[arc].insert(cursor);
+            add_arc_wire(arc, cursor);
 
             if (pip == PipId())
                 break;
@@ -806,9 +929,8 @@ struct Router1
             if (skip_net(ni))
                 continue;
             for (size_t i = 0; i < ni->users.size(); i++) {
-                auto &usr = ni->users.at(i);
                 ++arc_count;
-                delay_t slack = tmg.get_setup_slack(CellPortKey(usr));
+                delay_t slack = tmg.get_setup_slack(ni, i);
                 if (slack == std::numeric_limits<delay_t>::min())
                     continue;
                 if (slack < default_thresh)
@@ -826,8 +948,7 @@ struct Router1
             if (skip_net(ni))
                 continue;
             for (size_t i = 0; i < ni->users.size(); i++) {
-                auto &usr = ni->users.at(i);
-                delay_t slack = tmg.get_setup_slack(CellPortKey(usr));
+                delay_t slack = tmg.get_setup_slack(ni, i);
                 if (slack == std::numeric_limits<delay_t>::min())
                     continue;
                 slacks.push_back(slack);
@@ -840,6 +961,31 @@ struct Router1
                     (100.0 * failed_count) / arc_count, ctx->getDelayNS(thresh));
         return thresh;
     }
+
+    // Re-run the timing analysis against the routing achieved so far and
+    // redistribute the remaining slack onto the arc budgets. Criticalities
+    // read by later route_arc and arc_queue_insert calls then track actual
+    // arc delays rather than the pre-route state, so arcs that have gone
+    // negative tighten up and win contention for the fast resources instead
+    // of the router chasing stale targets
+    void refresh_timing()
+    {
+        if (!timing_driven)
+            return;
+        tmg.run();
+        for (auto &net : ctx->nets) {
+            NetInfo *ni = net.second.get();
+            if (skip_net(ni))
+                continue;
+            for (size_t i = 0; i < ni->users.size(); i++) {
+                auto &usr = ni->users.at(i);
+                delay_t slack = tmg.get_setup_slack(ni, i);
+                if (slack == std::numeric_limits<delay_t>::min())
+                    continue;
+                usr.budget = ctx->getNetinfoRouteDelay(ni, usr) + slack;
+            }
+        }
+    }
 };
 
 } // namespace
@@ -858,6 +1004,10 @@ Router1Cfg::Router1Cfg(Context *ctx)
     reuseBonus = wireRipupPenalty / 2;
 
     estimatePrecision = 100 * ctx->getRipupDelayPenalty();
+
+    // Interval (in processed arcs) between re-runs of the timing analysis
+    // against the achieved routing; 0 disables the refresh
+    timingRefreshIter = ctx->setting<int>("router1/timingRefreshIter", 10000);
 }
 
 bool router1(Context *ctx, const Router1Cfg &cfg)
@@ -876,7 +1026,7 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
         router.check();
 #endif
 
-        log_info("Routing %d arcs.\n", int(router.arc_queue.size()));
+        log_info("Routing %d arcs.\n", int(router.arc_queue_size()));
 
         int iter_cnt = 0;
         int last_arcs_with_ripup = 0;
@@ -889,12 +1039,12 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
         log_info("   IterCnt |  w/ripup   wo/ripup |  w/r  wo/r |      arcs| batch(sec) total(sec)|\n");
 
         auto prev_time = rstart;
-        while (!router.arc_queue.empty()) {
+        while (!router.arc_queue_empty()) {
             if (++iter_cnt % 1000 == 0) {
                 auto curr_time = std::chrono::high_resolution_clock::now();
                 log_info("%10d | %8d %10d | %4d %5d | %9d| %10.02f %10.02f|\n", iter_cnt, router.arcs_with_ripup,
                          router.arcs_without_ripup, router.arcs_with_ripup - last_arcs_with_ripup,
-                         router.arcs_without_ripup - last_arcs_without_ripup, int(router.arc_queue.size()),
+                         router.arcs_without_ripup - last_arcs_without_ripup, int(router.arc_queue_size()),
                          std::chrono::duration<float>(curr_time - prev_time).count(),
                          std::chrono::duration<float>(curr_time - rstart).count());
                 prev_time = curr_time;
@@ -906,6 +1056,9 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
 #endif
             }
 
+            if (cfg.timingRefreshIter > 0 && iter_cnt % cfg.timingRefreshIter == 0)
+                router.refresh_timing();
+
             if (ctx->debug)
                 log("-- %d --\n", iter_cnt);
 
@@ -920,7 +1073,7 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
                 return false;
             }
             // Timing driven ripup
-            if (timing_ripup && router.arc_queue.empty() && timing_fail_count < 50) {
+            if (timing_ripup && router.arc_queue_empty() && timing_fail_count < 50) {
                 ++timing_fail_count;
                 router.tmg.run();
                 delay_t wns = 0, tns = 0;
@@ -939,7 +1092,7 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
                         continue;
                     for (size_t i = 0; i < ni->users.size(); i++) {
                         auto &usr = ni->users.at(i);
-                        delay_t slack = router.tmg.get_setup_slack(CellPortKey(usr));
+                        delay_t slack = router.tmg.get_setup_slack(ni, i);
                         if (slack == std::numeric_limits<delay_t>::min())
                             continue;
                         if (slack < 0) {
@@ -956,7 +1109,7 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
                     }
                 }
                 log_info("    %d arcs ripped up due to negative slack WNS=%.02fns TNS=%.02fns.\n",
-                         int(router.arc_queue.size()), ctx->getDelayNS(wns), ctx->getDelayNS(tns));
+                         int(router.arc_queue_size()), ctx->getDelayNS(wns), ctx->getDelayNS(tns));
                 iter_cnt = 0;
                 router.wireScores.clear();
                 router.netScores.clear();
@@ -965,7 +1118,7 @@ bool router1(Context *ctx, const Router1Cfg &cfg)
         auto rend = std::chrono::high_resolution_clock::now();
         log_info("%10d | %8d %10d | %4d %5d | %9d| %10.02f %10.02f|\n", iter_cnt, router.arcs_with_ripup,
                  router.arcs_without_ripup, router.arcs_with_ripup - last_arcs_with_ripup,
-                 router.arcs_without_ripup - last_arcs_without_ripup, int(router.arc_queue.size()),
+                 router.arcs_without_ripup - last_arcs_without_ripup, int(router.arc_queue_size()),
                  std::chrono::duration<float>(rend - prev_time).count(),
                  std::chrono::duration<float>(rend - rstart).count());
         log_info("Routing complete.\n");
@@ -1000,10 +1153,9 @@ bool Context::checkRoutedDesign() const
     for (auto &net_it : ctx->nets) {
         NetInfo *net_info = net_it.second.get();
 
-#ifdef ARCH_ECP5
-        if (net_info->is_global)
-            continue;
-#endif
+        if (Arch::capGlobalsRoutedSeparately)
+            if (net_info->is_global)
+                continue;
 
         if (ctx->debug)
             log("checking net %s\n", ctx->nameOf(net_info));
@@ -36,6 +36,7 @@ struct Router1Cfg
     delay_t netRipupPenalty;
     delay_t reuseBonus;
     delay_t estimatePrecision;
+    int timingRefreshIter;
 };
 
 extern bool router1(Context *ctx, const Router1Cfg &cfg);
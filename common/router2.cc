@@ -29,16 +29,21 @@
 #include "router2.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <boost/container/flat_map.hpp>
 #include <chrono>
 #include <deque>
 #include <fstream>
+#include <memory>
 #include <queue>
 
 #include "log.h"
 #include "nextpnr.h"
 #include "router1.h"
 #include "scope_lock.h"
+#include "telemetry.h"
+#include "threadpool.h"
 #include "timing.h"
 #include "util.h"
 
@@ -68,6 +73,18 @@ struct Router2
         int total_route_us = 0;
         float max_crit = 0;
         int fail_count = 0;
+        // Bounding box of this net's overused wires in the last congestion
+        // update; invalid (x0 > x1) when the net had none. Steers the
+        // directional bounding box expansion in expand_net_bb
+        ArcBounds fail_bb;
+        // True for nets whose routing was entirely pre-bound by dedicated
+        // arch code (e.g. promoted globals routed over the clock network);
+        // the router leaves such nets completely alone
+        bool fixed_routing = false;
+        // Shadow count of bound (arc, wire) references across the whole
+        // route tree, maintained alongside the per-wire counts by
+        // bind/unbind_pip_internal and cross-checked by validate_route_tree
+        int bound_refs = 0;
     };
 
     struct WireScore
@@ -77,28 +94,41 @@ struct Router2
         float total() const { return cost + togo_cost; }
     };
 
+    // Per-wire state is split structure-of-arrays style: the fields the A*
+    // inner loops touch (congestion, history, visit data) live in dense
+    // parallel arrays indexed by wire_to_idx, so expansion traffic doesn't
+    // drag the colder fields through the cache with it
     struct PerWireData
     {
-        // nextpnr
-        WireId w;
-        // Historical congestion cost
-        int curr_cong = 0;
-        float hist_cong_cost = 1.0;
         // Wire is unavailable as locked to another arc
         bool unavailable = false;
         // This wire has to be used for this net
-        int reserved_net = -1;
+        int32_t reserved_net = -1;
         // The notional location of the wire, to guarantee thread safety
         int16_t x = 0, y = 0;
-        // Visit data
+    };
+
+    struct PerWireVisitData
+    {
         PipId pip_fwd, pip_bwd;
-        bool visited_fwd = false, visited_bwd = false;
+        // Epoch stamps instead of bool flags: a wire counts as visited when
+        // its stamp matches the searching thread's current epoch, so
+        // unvisiting between arcs is a single epoch bump rather than a walk
+        // over a dirty list. Epochs are drawn from a shared counter, so a
+        // stale stamp left by another thread can never alias a live one
+        uint32_t epoch_fwd = 0, epoch_bwd = 0;
     };
 
     Context *ctx;
     Router2Cfg cfg;
 
-    Router2(Context *ctx, const Router2Cfg &cfg) : ctx(ctx), cfg(cfg), tmg(ctx) { tmg.setup(); }
+    Router2(Context *ctx, const Router2Cfg &cfg) : ctx(ctx), cfg(cfg), tmg(ctx)
+    {
+        // STA re-runs every congestion iteration; damp the per-arc
+        // criticality so arc priorities don't oscillate with each reroute
+        tmg.damped_criticality = true;
+        tmg.setup();
+    }
 
     // Use 'udata' for fast net lookups and indexing
     std::vector<NetInfo *> nets_by_udata;
@@ -110,13 +140,11 @@ struct Router2
     void setup_nets()
     {
         // Populate per-net and per-arc structures at start of routing
-        nets.resize(ctx->nets.size());
-        nets_by_udata.resize(ctx->nets.size());
-        size_t i = 0;
-        for (auto &net : ctx->nets) {
-            NetInfo *ni = net.second.get();
-            ni->udata = i;
-            nets_by_udata.at(i) = ni;
+        ctx->refreshNetUdata();
+        nets_by_udata = ctx->net_by_udata;
+        nets.resize(nets_by_udata.size());
+        for (size_t i = 0; i < nets_by_udata.size(); i++) {
+            NetInfo *ni = nets_by_udata.at(i);
             nets.at(i).arcs.resize(ni->users.size());
 
             // Start net bounding box at overall min/max
@@ -176,29 +204,91 @@ struct Router2
             nets.at(i).bb.y0 = std::max(nets.at(i).bb.y0 - cfg.bb_margin_y, 0);
             nets.at(i).bb.x1 = std::min(nets.at(i).bb.x1 + cfg.bb_margin_x, ctx->getGridDimX());
             nets.at(i).bb.y1 = std::min(nets.at(i).bb.y1 + cfg.bb_margin_y, ctx->getGridDimY());
-            i++;
+
+            // Detect nets the arch has already routed over dedicated
+            // resources: global, every binding arch-locked and every sink
+            // wire reached. This replaces assuming so for all ECP5 globals;
+            // any arch that pre-routes a marked-global net gets the skip
+            if (ni->is_global && !ni->wires.empty()) {
+                bool fixed = true;
+                for (auto &w : ni->wires) {
+                    if (w.second.strength <= STRENGTH_STRONG) {
+                        fixed = false;
+                        break;
+                    }
+                }
+                for (size_t j = 0; fixed && j < ni->users.size(); j++) {
+                    for (auto &dst_wire : ctx->getNetinfoSinkWires(ni, ni->users.at(j))) {
+                        if (dst_wire == WireId() || ctx->getBoundWireNet(dst_wire) != ni) {
+                            fixed = false;
+                            break;
+                        }
+                    }
+                }
+                nets.at(i).fixed_routing = fixed;
+            }
         }
     }
 
     dict<WireId, int> wire_to_idx;
     std::vector<PerWireData> flat_wires;
+    // Wire handle per index; only needed when crossing back into arch land
+    std::vector<WireId> wire_ids;
+    // Wire-side term of the default base cost (wire delay plus epsilon),
+    // precomputed so the expansion loop only has to add the pip delay it
+    // already holds and convert to ns. Unused when cfg.get_base_cost is set
+    std::vector<delay_t> wire_base_delay;
+    // Historical congestion cost per wire
+    std::vector<float> wire_hist_cong;
+    // A* visit state per wire
+    std::vector<PerWireVisitData> wire_visit;
+    // Source of globally-unique visit epochs (see PerWireVisitData)
+    std::atomic<uint32_t> visit_epoch{0};
+    // Current congestion count per wire. Atomic so that threads routing
+    // spatially-overlapping nets can update it without a lock; relaxed
+    // ordering suffices as the counts are only heuristic inputs during a
+    // parallel pass and thread join makes them consistent afterwards
+    std::vector<std::atomic<int32_t>> wire_cong;
+    // Frozen copy of wire_cong used for scoring in the cross-region pass, so
+    // routing decisions don't depend on the interleaving of other threads
+    std::vector<int32_t> cong_snapshot;
+    // A* visit counters per wire, feeding the per-tile heatmap. Only
+    // allocated when a heatmap prefix is configured (see count_visit)
+    std::vector<std::atomic<uint32_t>> wire_visit_count;
+    // Per-tile overuse summary from the previous iteration, rebuilt by
+    // update_congestion and read by the corridor planner for long arcs
+    std::vector<float> tile_overuse;
+    int tile_w = 0, tile_h = 0;
 
     PerWireData &wire_data(WireId w) { return flat_wires[wire_to_idx.at(w)]; }
 
+    int32_t cong_at(int wire_idx) const { return wire_cong[wire_idx].load(std::memory_order_relaxed); }
+
     void setup_wires()
     {
         // Set up per-wire structures, so that MT parts don't have to do any memory allocation
         // This is possibly quite wasteful and not cache-optimal; further consideration necessary
+        // Count first and reserve exactly: on multi-million-wire devices the
+        // transient overshoot from vector doubling and dict rehashing during
+        // this fill is itself a significant chunk of peak RSS
+        size_t num_wires = 0;
+        for (auto wire : ctx->getWires()) {
+            (void)wire;
+            ++num_wires;
+        }
+        flat_wires.reserve(num_wires);
+        wire_ids.reserve(num_wires);
+        wire_base_delay.reserve(num_wires);
+        wire_to_idx.reserve(num_wires);
+        const delay_t delay_eps = ctx->getDelayEpsilon();
         for (auto wire : ctx->getWires()) {
             PerWireData pwd;
-            pwd.w = wire;
             NetInfo *bound = ctx->getBoundWireNet(wire);
             if (bound != nullptr) {
                 auto iter = bound->wires.find(wire);
                 if (iter != bound->wires.end()) {
                     auto &nd = nets.at(bound->udata);
                     nd.wires[wire] = std::make_pair(bound->wires.at(wire).pip, 0);
-                    pwd.curr_cong = 1;
                     if (bound->wires.at(wire).strength == STRENGTH_PLACER) {
                         pwd.reserved_net = bound->udata;
                     } else if (bound->wires.at(wire).strength > STRENGTH_PLACER) {
@@ -213,7 +303,24 @@ struct Router2
 
             wire_to_idx[wire] = int(flat_wires.size());
             flat_wires.push_back(pwd);
+            wire_ids.push_back(wire);
+            wire_base_delay.push_back(ctx->getWireDelay(wire).maxDelay() + delay_eps);
+        }
+
+        wire_hist_cong.assign(flat_wires.size(), 1.0f);
+        wire_visit.resize(flat_wires.size());
+        if (cfg.corridor_width > 0) {
+            tile_w = ctx->getGridDimX() + 1;
+            tile_h = ctx->getGridDimY() + 1;
+            tile_overuse.assign(size_t(tile_w) * tile_h, 0.0f);
         }
+        if (!cfg.heatmap.empty())
+            wire_visit_count = std::vector<std::atomic<uint32_t>>(flat_wires.size());
+        wire_cong = std::vector<std::atomic<int32_t>>(flat_wires.size());
+        // Pre-bound wires (from globals etc) start with a congestion count of 1
+        for (auto &nd : nets)
+            for (auto &w : nd.wires)
+                wire_cong[wire_to_idx.at(w.first)].store(1, std::memory_order_relaxed);
 
         for (auto &net_pair : ctx->nets) {
             auto *net = net_pair.second.get();
@@ -227,6 +334,30 @@ struct Router2
                 }
             }
         }
+
+        log_memory_usage();
+    }
+
+    // Log the heap footprint of the per-wire structures, which dominate
+    // router memory on large devices. Sizes are capacity-based estimates (the
+    // dict figure includes its hash table), so reservation overshoot shows up
+    void log_memory_usage()
+    {
+        auto mib = [](size_t bytes) { return double(bytes) / (1024.0 * 1024.0); };
+        size_t flat_b = flat_wires.capacity() * sizeof(PerWireData);
+        size_t ids_b = wire_ids.capacity() * sizeof(WireId) + wire_base_delay.capacity() * sizeof(delay_t);
+        size_t idx_b = wire_to_idx.size() * (sizeof(WireId) + sizeof(int) + 2 * sizeof(uint32_t));
+        size_t visit_b = wire_visit.capacity() * sizeof(PerWireVisitData);
+        size_t cong_b = wire_cong.size() * sizeof(std::atomic<int32_t>) + wire_hist_cong.capacity() * sizeof(float) +
+                        cong_snapshot.capacity() * sizeof(int32_t) +
+                        wire_visit_count.size() * sizeof(std::atomic<uint32_t>);
+        if (ctx->verbose) {
+            log_info("    router2 per-wire memory: wire data %.1f MiB, wire ids %.1f MiB, index %.1f MiB, "
+                     "visit %.1f MiB, congestion %.1f MiB\n",
+                     mib(flat_b), mib(ids_b), mib(idx_b), mib(visit_b), mib(cong_b));
+        }
+        log_info("    router2 per-wire structures: %d wires, ~%.1f MiB\n", int(flat_wires.size()),
+                 mib(flat_b + ids_b + idx_b + visit_b + cong_b));
     }
 
     struct QueuedWire
@@ -250,8 +381,64 @@ struct Router2
         };
     };
 
+    // Min-heap of QueuedWires that keeps its backing storage across clear()s,
+    // so the per-arc queue resets stop churning allocations. A 4-ary layout is
+    // used as it is shallower than a binary heap and sifts touch fewer cache
+    // lines. Wires are only ever pushed once per direction per search (the
+    // visit flag is set at push time), so no decrease-key is needed
+    struct WireHeap
+    {
+        std::vector<QueuedWire> data;
+        QueuedWire::Greater greater;
+
+        bool empty() const { return data.empty(); }
+        size_t size() const { return data.size(); }
+        void clear() { data.clear(); }
+        const QueuedWire &top() const { return data.front(); }
+
+        void push(QueuedWire q)
+        {
+            data.push_back(q);
+            size_t i = data.size() - 1;
+            while (i > 0) {
+                size_t parent = (i - 1) / 4;
+                if (!greater(data[parent], data[i]))
+                    break;
+                std::swap(data[parent], data[i]);
+                i = parent;
+            }
+        }
+
+        void pop()
+        {
+            data.front() = data.back();
+            data.pop_back();
+            size_t i = 0, n = data.size();
+            while (true) {
+                size_t first_child = 4 * i + 1;
+                if (first_child >= n)
+                    break;
+                size_t best = first_child, last_child = std::min(first_child + 4, n);
+                for (size_t c = first_child + 1; c < last_child; c++)
+                    if (greater(data[best], data[c]))
+                        best = c;
+                if (!greater(data[i], data[best]))
+                    break;
+                std::swap(data[i], data[best]);
+                i = best;
+            }
+        }
+    };
+
     bool hit_test_pip(ArcBounds &bb, Loc l) { return l.x >= bb.x0 && l.x <= bb.x1 && l.y >= bb.y0 && l.y <= bb.y1; }
 
+    float tile_overuse_at(int x, int y) const
+    {
+        if (tile_overuse.empty() || x < 0 || y < 0 || x >= tile_w || y >= tile_h)
+            return 0.0f;
+        return tile_overuse[size_t(y) * tile_w + x];
+    }
+
     double curr_cong_weight, hist_cong_weight, estimate_weight;
 
     struct ThreadContext
@@ -263,27 +450,198 @@ struct Router2
 
         std::vector<std::pair<size_t, size_t>> route_arcs;
 
-        std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> fwd_queue, bwd_queue;
-        // Special case where one net has multiple logical arcs to the same physical sink
-        pool<WireId> processed_sinks;
+        WireHeap fwd_queue, bwd_queue;
+        // Special case where one net has multiple logical arcs to the same physical sink;
+        // almost always a handful of entries, so keep them in-place
+        small_pool<WireId, 4> processed_sinks;
 
-        std::vector<int> dirty_wires;
+        // Epoch the current arc's visit stamps are tagged with; 0 is never
+        // handed out so default-initialised wires read as unvisited
+        uint32_t visit_epoch = 0;
 
         // Thread bounding box
         ArcBounds bb;
 
+        // Corridor restriction for long arcs (see plan_corridor): bitmap over
+        // the net bounding box, indexed [(y - bb.y0) * w + (x - bb.x0)]
+        bool corridor_active = false;
+        ArcBounds corridor_bb;
+        std::vector<uint8_t> corridor_mask;
+
+        // Bloom-style summary of the wires bound to the net currently being
+        // routed (the keys of its PerNetData::wires dict), two hashed bits
+        // per wire over a fixed bitmap. A clear bit proves the wire is not
+        // bound to this net, so the common miss case in score_wire_for_arc
+        // and the expansion loops skips the dict probe entirely; a set bit
+        // falls through to the real lookup, so a false positive only costs
+        // the probe that would have happened anyway. Rebuilt per net and
+        // appended to as arcs bind wires; unbinds leave stale bits, which
+        // errs on the same safe side
+        static constexpr size_t bound_filter_words = 1024; // 64 Kbit
+        std::vector<uint64_t> bound_filter;
+
+        void bound_filter_add(int wire_idx)
+        {
+            uint32_t b1 = (uint32_t(wire_idx) * 0x9E3779B9u) >> 16;
+            uint32_t b2 = (uint32_t(wire_idx) * 0x85EBCA6Bu) >> 16;
+            bound_filter[b1 >> 6] |= uint64_t(1) << (b1 & 63);
+            bound_filter[b2 >> 6] |= uint64_t(1) << (b2 & 63);
+        }
+        bool bound_filter_maybe(int wire_idx) const
+        {
+            uint32_t b1 = (uint32_t(wire_idx) * 0x9E3779B9u) >> 16;
+            if (!(bound_filter[b1 >> 6] & (uint64_t(1) << (b1 & 63))))
+                return false;
+            uint32_t b2 = (uint32_t(wire_idx) * 0x85EBCA6Bu) >> 16;
+            return (bound_filter[b2 >> 6] & (uint64_t(1) << (b2 & 63))) != 0;
+        }
+
         DeterministicRNG rng;
 
-        // Used to add existing routing to the heap
+        // Scratch buffer for batched downhill pip queries in the expansion
+        // loop, reused across wires to avoid per-wire allocation
+        std::vector<PipDownhillInfo> pips_dh;
+
+        // Used to add existing routing to the heap. The per-location wire
+        // sets live in a recycled bucket vector rather than as dict values,
+        // so resetting for the next net clears the used buckets in place
+        // instead of freeing and reallocating one pool per location
         pool<WireId> in_wire_by_loc;
-        dict<std::pair<int, int>, pool<WireId>> wire_by_loc;
+        dict<std::pair<int, int>, int32_t> wire_by_loc;
+        std::vector<pool<WireId>> loc_buckets;
+        int32_t loc_buckets_used = 0;
+
+        pool<WireId> &loc_bucket(std::pair<int, int> loc)
+        {
+            auto fnd = wire_by_loc.find(loc);
+            if (fnd != wire_by_loc.end())
+                return loc_buckets.at(fnd->second);
+            if (loc_buckets_used == int32_t(loc_buckets.size()))
+                loc_buckets.emplace_back();
+            wire_by_loc[loc] = loc_buckets_used;
+            return loc_buckets.at(loc_buckets_used++);
+        }
+
+        void clear_loc_buckets()
+        {
+            for (int32_t i = 0; i < loc_buckets_used; i++)
+                loc_buckets.at(i).clear();
+            loc_buckets_used = 0;
+            wire_by_loc.clear();
+        }
+
+        // Scratch for plan_corridor's tile-level A*, reused across arcs
+        std::vector<float> corridor_dist;
+        std::vector<int32_t> corridor_prev;
+        std::vector<std::pair<float, int32_t>> corridor_heap;
+
+        // Trunk wires check_arc_routing has verified uncongested for the net
+        // currently being routed, plus the scratch walk that is only
+        // committed when a check succeeds. All sinks of a high-fanout net
+        // share the trunk, so each check walks the unshared tail of its path
+        // instead of the whole tree once per sink
+        pool<int> checked_wires;
+        std::vector<int> check_scratch;
+
+        // Set for contexts routing nets that cross the spatial partitions.
+        // Visit state then lives in the thread-local maps below rather than
+        // the shared wire_visit entries, and congestion is scored against
+        // 'cong_snapshot' so results are independent of thread interleaving
+        bool cross_region = false;
+        dict<int, PipId> local_visited_fwd, local_visited_bwd;
     };
 
+    // Congestion count as seen when scoring for a given context: the frozen
+    // snapshot in the cross-region pass, the live count otherwise
+    int32_t cong_for_score(const ThreadContext *t, int wire_idx) const
+    {
+        if (t != nullptr && t->cross_region)
+            return cong_snapshot[wire_idx];
+        return cong_at(wire_idx);
+    }
+
     bool thread_test_wire(ThreadContext &t, PerWireData &w)
     {
         return w.x >= t.bb.x0 && w.x <= t.bb.x1 && w.y >= t.bb.y0 && w.y <= t.bb.y1;
     }
 
+    bool hit_test_corridor(const ThreadContext &t, Loc l) const
+    {
+        if (l.x < t.corridor_bb.x0 || l.x > t.corridor_bb.x1 || l.y < t.corridor_bb.y0 || l.y > t.corridor_bb.y1)
+            return false;
+        int w = (t.corridor_bb.x1 - t.corridor_bb.x0) + 1;
+        return t.corridor_mask[size_t(l.y - t.corridor_bb.y0) * w + (l.x - t.corridor_bb.x0)] != 0;
+    }
+
+    // Plan a coarse tile-level corridor for a long arc: A* over the tile grid
+    // inside the net bounding box, costed by the per-tile overuse summary
+    // from the previous iteration, then dilated by corridor_width tiles into
+    // a mask. Restricting detailed expansion to the corridor keeps
+    // corner-to-corner arcs from flooding wires across the whole box;
+    // route_arc retries unrestricted if the corridor proves too tight
+    bool plan_corridor(ThreadContext &t, PerNetData &nd, int src_idx, int dst_idx)
+    {
+        const auto &bb = nd.bb;
+        int w = (bb.x1 - bb.x0) + 1, h = (bb.y1 - bb.y0) + 1;
+        if (w <= 0 || h <= 0 || (int64_t(w) * h) > (512 * 512))
+            return false;
+        int sx = std::min(bb.x1, std::max(bb.x0, int(flat_wires.at(src_idx).x)));
+        int sy = std::min(bb.y1, std::max(bb.y0, int(flat_wires.at(src_idx).y)));
+        int dx = std::min(bb.x1, std::max(bb.x0, int(flat_wires.at(dst_idx).x)));
+        int dy = std::min(bb.y1, std::max(bb.y0, int(flat_wires.at(dst_idx).y)));
+        auto node = [&](int x, int y) { return (y - bb.y0) * w + (x - bb.x0); };
+        auto est = [&](int x, int y) { return float(std::abs(x - dx) + std::abs(y - dy)); };
+        // Scratch lives in the thread context so repeated plans reuse it
+        auto &dist = t.corridor_dist;
+        auto &prev = t.corridor_prev;
+        auto &heap = t.corridor_heap;
+        dist.assign(size_t(w) * h, std::numeric_limits<float>::max());
+        prev.assign(size_t(w) * h, -1);
+        heap.clear();
+        // Ties broken on node index, so the plan is deterministic
+        typedef std::pair<float, int32_t> QNode;
+        auto heap_cmp = std::greater<QNode>();
+        int src_node = node(sx, sy), dst_node = node(dx, dy);
+        dist.at(src_node) = 0;
+        heap.emplace_back(est(sx, sy), src_node);
+        while (!heap.empty()) {
+            int cn = heap.front().second;
+            std::pop_heap(heap.begin(), heap.end(), heap_cmp);
+            heap.pop_back();
+            if (cn == dst_node)
+                break;
+            int cx = bb.x0 + (cn % w), cy = bb.y0 + (cn / w);
+            const int dxs[4] = {1, -1, 0, 0}, dys[4] = {0, 0, 1, -1};
+            for (int dir = 0; dir < 4; dir++) {
+                int nx = cx + dxs[dir], ny = cy + dys[dir];
+                if (nx < bb.x0 || nx > bb.x1 || ny < bb.y0 || ny > bb.y1)
+                    continue;
+                int nn = node(nx, ny);
+                float next_cost = dist.at(cn) + 1.0f + std::min(tile_overuse_at(nx, ny), 8.0f);
+                if (next_cost < dist.at(nn)) {
+                    dist.at(nn) = next_cost;
+                    prev.at(nn) = cn;
+                    heap.emplace_back(next_cost + est(nx, ny), nn);
+                    std::push_heap(heap.begin(), heap.end(), heap_cmp);
+                }
+            }
+        }
+        if (prev.at(dst_node) == -1 && dst_node != src_node)
+            return false;
+        t.corridor_bb = bb;
+        t.corridor_mask.assign(size_t(w) * h, 0);
+        int wd = cfg.corridor_width;
+        for (int cn = dst_node; cn != -1; cn = prev.at(cn)) {
+            int cx = bb.x0 + (cn % w), cy = bb.y0 + (cn / w);
+            for (int yy = std::max(cy - wd, bb.y0); yy <= std::min(cy + wd, bb.y1); yy++)
+                for (int xx = std::max(cx - wd, bb.x0); xx <= std::min(cx + wd, bb.x1); xx++)
+                    t.corridor_mask[node(xx, yy)] = 1;
+            if (cn == src_node)
+                break;
+        }
+        return true;
+    }
+
     enum ArcRouteResult
     {
         ARC_SUCCESS,
@@ -307,13 +665,13 @@ struct Router2
 
     void bind_pip_internal(PerNetData &net, size_t user, int wire, PipId pip)
     {
-        auto &wd = flat_wires.at(wire);
-        auto found = net.wires.find(wd.w);
+        WireId w = wire_ids.at(wire);
+        auto found = net.wires.find(w);
         if (found == net.wires.end()) {
             // Not yet used for any arcs of this net, add to list
-            net.wires.emplace(wd.w, std::make_pair(pip, 1));
+            net.wires.emplace(w, std::make_pair(pip, 1));
             // Increase bound count of wire by 1
-            ++wd.curr_cong;
+            wire_cong[wire].fetch_add(1, std::memory_order_relaxed);
         } else {
             // Already used for at least one other arc of this net
             // Don't allow two uphill PIPs for the same net and wire
@@ -321,18 +679,44 @@ struct Router2
             // Increase the count of bound arcs
             ++found->second.second;
         }
+        ++net.bound_refs;
     }
 
     void unbind_pip_internal(PerNetData &net, size_t user, WireId wire)
     {
-        auto &wd = wire_data(wire);
-        auto &b = net.wires.at(wd.w);
+        auto &b = net.wires.at(wire);
+        // An over-unbind would silently decrement the shared congestion
+        // counter past this net's contribution; fail loudly instead
+        NPNR_ASSERT(b.second > 0);
         --b.second;
+        --net.bound_refs;
         if (b.second == 0) {
             // No remaining arcs of this net bound to this wire
-            --wd.curr_cong;
-            net.wires.erase(wd.w);
+            wire_cong[wire_to_idx.at(wire)].fetch_sub(1, std::memory_order_relaxed);
+            net.wires.erase(wire);
+        }
+    }
+
+    // Always-on incremental route tree validation, run after each reroute of
+    // a net. The old approach of validating whole-design invariants under
+    // ctx->debug made routing an order of magnitude slower, so corruption
+    // bugs only ever reproduced with validation off; these checks walk just
+    // the one net's tree and cost well under a percent of route time.
+    // Catches bind/unbind imbalance (per-wire counts vs the shadow
+    // reference count) and lost congestion updates: a net's own +1
+    // contribution must always be visible in the shared counter, even with
+    // other threads' nets updating it concurrently
+    void validate_route_tree(PerNetData &nd)
+    {
+        int refs = 0;
+        for (auto &w : nd.wires) {
+            // A count of zero is legal only for wires pre-bound at setup
+            // that no arc has claimed yet
+            NPNR_ASSERT(w.second.second >= 0);
+            refs += w.second.second;
+            NPNR_ASSERT(wire_cong[wire_to_idx.at(w.first)].load(std::memory_order_relaxed) >= 1);
         }
+        NPNR_ASSERT(refs == nd.bound_refs);
     }
 
     void ripup_arc(NetInfo *net, size_t user, size_t phys_pin)
@@ -351,16 +735,26 @@ struct Router2
         ad.routed = false;
     }
 
-    float score_wire_for_arc(NetInfo *net, size_t user, size_t phys_pin, WireId wire, PipId pip, float crit_weight)
+    // (Re)build t.bound_filter from the net's current bound-wire set; run
+    // once per net before its arcs are routed
+    void build_bound_filter(ThreadContext &t, PerNetData &nd)
+    {
+        t.bound_filter.assign(ThreadContext::bound_filter_words, 0);
+        for (auto &w : nd.wires)
+            t.bound_filter_add(wire_to_idx.at(w.first));
+    }
+
+    float score_wire_for_arc(ThreadContext &t, NetInfo *net, size_t user, size_t phys_pin, int wire_idx, WireId wire,
+                             PipId pip, delay_t pip_delay, float crit_weight)
     {
-        auto &wd = wire_data(wire);
         auto &nd = nets.at(net->udata);
-        float base_cost = cfg.get_base_cost(ctx, wire, pip, crit_weight);
-        int overuse = wd.curr_cong;
-        float hist_cost = 1.0f + crit_weight * (wd.hist_cong_cost - 1.0f);
+        float base_cost = cfg.get_base_cost ? cfg.get_base_cost(ctx, wire, pip, crit_weight)
+                                            : ctx->getDelayNS(pip_delay + wire_base_delay.at(wire_idx));
+        int overuse = cong_for_score(&t, wire_idx);
+        float hist_cost = 1.0f + crit_weight * (wire_hist_cong.at(wire_idx) - 1.0f);
         float bias_cost = 0;
         int source_uses = 0;
-        if (nd.wires.count(wire)) {
+        if (t.bound_filter_maybe(wire_idx) && nd.wires.count(wire)) {
             overuse -= 1;
             source_uses = nd.wires.at(wire).second;
         }
@@ -373,35 +767,134 @@ struct Router2
         return base_cost * hist_cost * present_cost / (1 + (source_uses * crit_weight)) + bias_cost;
     }
 
-    float get_togo_cost(NetInfo *net, size_t user, int wire, WireId src_sink, float crit_weight, bool bwd = false)
+    // Distance-binned delay lookahead, sampled from the actual routing graph
+    // at router startup (see build_lookahead). Arch estimateDelay is often a
+    // simple coordinate formula that badly underestimates long/span wire
+    // costs, which inflates the explored A* frontier; the sampled table gives
+    // a much tighter estimate for displacements it has seen
+    std::vector<delay_t> lookahead;
+    int lookahead_w = 0, lookahead_h = 0;
+    static delay_t lookahead_unset() { return std::numeric_limits<delay_t>::max(); }
+
+    void build_lookahead()
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        lookahead_w = ctx->getGridDimX() + 1;
+        lookahead_h = ctx->getGridDimY() + 1;
+        lookahead.assign(size_t(lookahead_w) * lookahead_h, lookahead_unset());
+        // Sample a spread of source wires; from each, a bounded Dijkstra over
+        // the pip graph records the cheapest delay seen per (|dx|, |dy|) bin
+        size_t stride = std::max<size_t>(1, flat_wires.size() / size_t(cfg.lookahead_sources));
+        std::vector<delay_t> dist(flat_wires.size(), lookahead_unset());
+        std::vector<int> touched;
+        std::vector<PipDownhillInfo> pips_dh;
+        for (size_t src = 0; src < flat_wires.size(); src += stride) {
+            auto &src_data = flat_wires.at(src);
+            // Min-heap of (delay, wire); ties broken on index for determinism
+            std::priority_queue<std::pair<delay_t, int>, std::vector<std::pair<delay_t, int>>,
+                                std::greater<std::pair<delay_t, int>>>
+                    queue;
+            dist.at(src) = 0;
+            touched.push_back(int(src));
+            queue.emplace(0, int(src));
+            int explored = 0;
+            while (!queue.empty() && explored < cfg.lookahead_explore) {
+                auto curr = queue.top();
+                queue.pop();
+                if (curr.first > dist.at(curr.second))
+                    continue; // stale entry
+                ++explored;
+                auto &wd = flat_wires.at(curr.second);
+                size_t bin = size_t(std::abs(wd.y - src_data.y)) * lookahead_w + std::abs(wd.x - src_data.x);
+                lookahead.at(bin) = std::min(lookahead.at(bin), curr.first);
+                ctx->getPipsDownhillInfo(wire_ids.at(curr.second), pips_dh);
+                for (const auto &dh : pips_dh) {
+                    if (dh.blocked)
+                        continue;
+                    int next = wire_to_idx.at(dh.dst);
+                    delay_t next_delay =
+                            curr.first + dh.delay.maxDelay() + ctx->getWireDelay(wire_ids.at(next)).maxDelay();
+                    if (next_delay < dist.at(next)) {
+                        if (dist.at(next) == lookahead_unset())
+                            touched.push_back(next);
+                        dist.at(next) = next_delay;
+                        queue.emplace(next_delay, next);
+                    }
+                }
+            }
+            for (int w : touched)
+                dist.at(w) = lookahead_unset();
+            touched.clear();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        if (ctx->verbose)
+            log_info("    lookahead sampling took %.02fs\n", std::chrono::duration<float>(end - start).count());
+    }
+
+    delay_t get_togo_estimate(int wire, int src_sink, bool bwd)
+    {
+        WireId w = wire_ids.at(wire), s = wire_ids.at(src_sink);
+        if (!lookahead.empty()) {
+            auto &wd = flat_wires.at(wire);
+            auto &sd = flat_wires.at(src_sink);
+            size_t bin = size_t(std::abs(wd.y - sd.y)) * lookahead_w + std::abs(wd.x - sd.x);
+            delay_t la = lookahead.at(bin);
+            if (la != lookahead_unset())
+                return std::max(la, ctx->estimateDelay(bwd ? s : w, bwd ? w : s));
+        }
+        return ctx->estimateDelay(bwd ? s : w, bwd ? w : s);
+    }
+
+    float get_togo_cost(NetInfo *net, size_t user, int wire, int src_sink, float crit_weight, bool bwd = false)
     {
         auto &nd = nets.at(net->udata);
-        auto &wd = flat_wires[wire];
         int source_uses = 0;
-        if (nd.wires.count(wd.w)) {
-            source_uses = nd.wires.at(wd.w).second;
+        auto fnd_wire = nd.wires.find(wire_ids.at(wire));
+        if (fnd_wire != nd.wires.end()) {
+            source_uses = fnd_wire->second.second;
         }
         // FIXME: timing/wirelength balance?
-        delay_t est_delay = ctx->estimateDelay(bwd ? src_sink : wd.w, bwd ? wd.w : src_sink);
+        delay_t est_delay = get_togo_estimate(wire, src_sink, bwd);
         return (ctx->getDelayNS(est_delay) / (1 + source_uses * crit_weight)) + cfg.ipin_cost_adder;
     }
 
-    bool check_arc_routing(NetInfo *net, size_t usr, size_t phys_pin)
+    bool check_arc_routing(NetInfo *net, size_t usr, size_t phys_pin, ThreadContext *t = nullptr)
     {
         auto &nd = nets.at(net->udata);
         auto &ad = nd.arcs.at(usr).at(phys_pin);
         WireId src_wire = nets.at(net->udata).src_wire;
         WireId cursor = ad.sink_wire;
+        if (t != nullptr)
+            t->check_scratch.clear();
         while (nd.wires.count(cursor)) {
-            auto &wd = wire_data(cursor);
-            if (wd.curr_cong != 1)
+            int idx = wire_to_idx.at(cursor);
+            // A wire a previous successful check walked through vouches for
+            // everything upstream of it: a bound wire's path to the source
+            // stays bound and its driving pips fixed while the net is being
+            // processed, and nothing else this thread routes in between can
+            // change the congestion of this net's wires
+            if (t != nullptr && t->checked_wires.count(idx)) {
+                for (int w : t->check_scratch)
+                    t->checked_wires.insert(w);
+                return true;
+            }
+            if (cong_for_score(t, idx) != 1)
                 return false;
+            if (t != nullptr)
+                t->check_scratch.push_back(idx);
             auto &uh = nd.wires.at(cursor).first;
             if (uh == PipId())
                 break;
             cursor = ctx->getPipSrcWire(uh);
         }
-        return (cursor == src_wire);
+        if (cursor != src_wire)
+            return false;
+        // Only a walk that reached the source clean marks its wires; a
+        // failed walk's prefix must not vouch for a congested trunk
+        if (t != nullptr)
+            for (int w : t->check_scratch)
+                t->checked_wires.insert(w);
+        return true;
     }
 
     void record_prerouted_net(NetInfo *net, size_t usr, size_t phys_pin)
@@ -491,8 +984,64 @@ struct Router2
         return did_something;
     }
 
+    // For high-fanout nets (typically clocks and other globals), reserve the
+    // dedicated cone downhill of the driver: a wire all of whose uphill pips
+    // come from wires already reserved for this net can never carry another
+    // net, so claiming it up front stops early iterations wasting effort
+    // routing ordinary nets through resources the global will inevitably
+    // take back. On most fabrics the cone ends as soon as the dedicated
+    // spine fans out into general routing, so the walk is naturally bounded
+    void reserve_driver_cone(NetInfo *net)
+    {
+        WireId src = ctx->getNetinfoSourceWire(net);
+        if (src == WireId())
+            return;
+        auto &sd = wire_data(src);
+        if (sd.reserved_net != -1 && sd.reserved_net != net->udata)
+            log_error("attempting to reserve wire '%s' for nets '%s' and '%s'\n", ctx->nameOfWire(src),
+                      ctx->nameOf(nets_by_udata.at(sd.reserved_net)), ctx->nameOf(net));
+        sd.reserved_net = net->udata;
+        std::queue<WireId> visit;
+        visit.push(src);
+        while (!visit.empty()) {
+            WireId w = visit.front();
+            visit.pop();
+            for (auto dh : ctx->getPipsDownhill(w)) {
+                WireId dst = ctx->getPipDstWire(dh);
+                auto &dd = wire_data(dst);
+                if (dd.unavailable || dd.reserved_net != -1)
+                    continue;
+                // Another net's driver sitting directly on the wire also
+                // disqualifies it
+                bool dedicated = true;
+                for (auto bp : ctx->getWireBelPins(dst))
+                    if (ctx->getBelPinType(bp.bel, bp.pin) != PORT_IN &&
+                        (net->driver.cell == nullptr || bp.bel != net->driver.cell->bel)) {
+                        dedicated = false;
+                        break;
+                    }
+                for (auto uh : ctx->getPipsUphill(dst)) {
+                    if (!dedicated)
+                        break;
+                    if (wire_data(ctx->getPipSrcWire(uh)).reserved_net != net->udata)
+                        dedicated = false;
+                }
+                if (!dedicated)
+                    continue;
+                dd.reserved_net = net->udata;
+                visit.push(dst);
+            }
+        }
+    }
+
     void find_all_reserved_wires()
     {
+        // Claim dedicated global/clock resources first so the iterative
+        // sink-chain pass below sees them as already taken
+        if (cfg.reserve_fanout_thresh > 0)
+            for (auto net : nets_by_udata)
+                if (int(net->users.size()) >= cfg.reserve_fanout_thresh)
+                    reserve_driver_cone(net);
         // Run iteratively, as reserving wires for one net might limit choices for another
         bool did_something = false;
         do {
@@ -509,13 +1058,16 @@ struct Router2
 
     void reset_wires(ThreadContext &t)
     {
-        for (auto w : t.dirty_wires) {
-            flat_wires[w].pip_fwd = PipId();
-            flat_wires[w].pip_bwd = PipId();
-            flat_wires[w].visited_fwd = false;
-            flat_wires[w].visited_bwd = false;
+        if (t.cross_region) {
+            t.local_visited_fwd.clear();
+            t.local_visited_bwd.clear();
+            return;
         }
-        t.dirty_wires.clear();
+        // O(1) unvisit: move to a fresh epoch, invalidating all stamps at
+        // once. The shared counter makes epochs unique across threads; the
+        // stamps themselves are only touched by the owning thread, as the
+        // spatial partitions keep each wire exclusive to one thread per pass
+        t.visit_epoch = visit_epoch.fetch_add(1, std::memory_order_relaxed) + 1;
     }
 
     // These nets have very-high-fanout pips and special rules must be followed (only working backwards) to avoid
@@ -539,49 +1091,91 @@ struct Router2
         if (!nd.wires.count(cursor))
             return;
         while (cursor != nd.src_wire) {
-            if (!t.in_wire_by_loc.count(cursor)) {
-                t.in_wire_by_loc.insert(cursor);
-                for (auto dh : ctx->getPipsDownhill(cursor)) {
-                    Loc dh_loc = ctx->getPipLocation(dh);
-                    t.wire_by_loc[std::make_pair(dh_loc.x, dh_loc.y)].insert(cursor);
-                }
+            // A wire already present was inserted by a walk that carried on
+            // to the source, so the rest of this path is present as well; a
+            // huge-fanout net then pays for its trunk once rather than once
+            // per sink
+            if (t.in_wire_by_loc.count(cursor))
+                break;
+            t.in_wire_by_loc.insert(cursor);
+            for (auto dh : ctx->getPipsDownhill(cursor)) {
+                Loc dh_loc = ctx->getPipLocation(dh);
+                t.loc_bucket(std::make_pair(dh_loc.x, dh_loc.y)).insert(cursor);
             }
             cursor = ctx->getPipSrcWire(nd.wires.at(cursor).first);
         }
     }
 
+    // Instrumentation only: bump the per-wire A* visit counter when the
+    // tile heatmap is enabled. The counters never feed routing decisions,
+    // so relaxed atomics are enough, and the empty() test is all the hot
+    // path pays when no heatmap was requested
+    inline void count_visit(int wire)
+    {
+        if (!wire_visit_count.empty())
+            wire_visit_count[wire].fetch_add(1, std::memory_order_relaxed);
+    }
+
     // Functions for marking wires as visited, and checking if they have already been visited
     void set_visited_fwd(ThreadContext &t, int wire, PipId pip)
     {
-        auto &wd = flat_wires.at(wire);
-        if (!wd.visited_fwd && !wd.visited_bwd)
-            t.dirty_wires.push_back(wire);
+        count_visit(wire);
+        if (t.cross_region) {
+            t.local_visited_fwd[wire] = pip;
+            return;
+        }
+        auto &wd = wire_visit.at(wire);
         wd.pip_fwd = pip;
-        wd.visited_fwd = true;
+        wd.epoch_fwd = t.visit_epoch;
     }
     void set_visited_bwd(ThreadContext &t, int wire, PipId pip)
     {
-        auto &wd = flat_wires.at(wire);
-        if (!wd.visited_fwd && !wd.visited_bwd)
-            t.dirty_wires.push_back(wire);
+        count_visit(wire);
+        if (t.cross_region) {
+            t.local_visited_bwd[wire] = pip;
+            return;
+        }
+        auto &wd = wire_visit.at(wire);
         wd.pip_bwd = pip;
-        wd.visited_bwd = true;
+        wd.epoch_bwd = t.visit_epoch;
     }
 
-    bool was_visited_fwd(int wire) { return flat_wires.at(wire).visited_fwd; }
-    bool was_visited_bwd(int wire) { return flat_wires.at(wire).visited_bwd; }
+    bool was_visited_fwd(ThreadContext &t, int wire)
+    {
+        if (t.cross_region)
+            return t.local_visited_fwd.count(wire);
+        return wire_visit.at(wire).epoch_fwd == t.visit_epoch;
+    }
+    bool was_visited_bwd(ThreadContext &t, int wire)
+    {
+        if (t.cross_region)
+            return t.local_visited_bwd.count(wire);
+        return wire_visit.at(wire).epoch_bwd == t.visit_epoch;
+    }
+    PipId visited_pip_fwd(ThreadContext &t, int wire)
+    {
+        if (t.cross_region)
+            return t.local_visited_fwd.at(wire);
+        return wire_visit.at(wire).pip_fwd;
+    }
+    PipId visited_pip_bwd(ThreadContext &t, int wire)
+    {
+        if (t.cross_region)
+            return t.local_visited_bwd.at(wire);
+        return wire_visit.at(wire).pip_bwd;
+    }
 
     float get_arc_crit(NetInfo *net, size_t i)
     {
         if (!timing_driven)
             return 0;
-        return tmg.get_criticality(CellPortKey(net->users.at(i)));
+        return tmg.get_criticality(net, i);
     }
 
     bool arc_failed_slack(NetInfo *net, size_t usr_idx)
     {
         return timing_driven_ripup &&
-               (tmg.get_setup_slack(CellPortKey(net->users.at(usr_idx))) < (2 * ctx->getDelayEpsilon()));
+               (tmg.get_setup_slack(net, usr_idx) < (2 * ctx->getDelayEpsilon()));
     }
 
     ArcRouteResult route_arc(ThreadContext &t, NetInfo *net, size_t i, size_t phys_pin, bool is_mt, bool is_bb = true)
@@ -620,17 +1214,18 @@ struct Router2
         // This records the point where forwards and backwards routing met
         int midpoint_wire = -1;
         int explored = 1;
+        const int start_mode = mode;
+
+        // Long arcs plan a coarse tile-level corridor first; detailed
+        // expansion below stays inside it unless the search comes up empty
+        t.corridor_active = is_bb && cfg.corridor_width > 0 &&
+                            ((ad.bb.x1 - ad.bb.x0) + (ad.bb.y1 - ad.bb.y0)) >= cfg.corridor_thresh &&
+                            plan_corridor(t, nd, src_wire_idx, dst_wire_idx);
 
         for (; mode < 2; mode++) {
-            // Clear out the queues
-            if (!t.fwd_queue.empty()) {
-                std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
-                t.fwd_queue.swap(new_queue);
-            }
-            if (!t.bwd_queue.empty()) {
-                std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
-                t.bwd_queue.swap(new_queue);
-            }
+            // Clear out the queues (retaining their storage for the next use)
+            t.fwd_queue.clear();
+            t.bwd_queue.clear();
             // Unvisit any previously visited wires
             reset_wires(t);
 
@@ -641,7 +1236,7 @@ struct Router2
                 WireScore base_score;
                 base_score.cost = wire_cost;
                 int wire_idx = wire_to_idx.at(wire);
-                base_score.togo_cost = get_togo_cost(net, i, wire_idx, dst_wire, false, crit_weight);
+                base_score.togo_cost = get_togo_cost(net, i, wire_idx, dst_wire_idx, false, crit_weight);
                 t.fwd_queue.push(QueuedWire(wire_idx, base_score));
                 set_visited_fwd(t, wire_idx, PipId());
             };
@@ -652,7 +1247,7 @@ struct Router2
                     auto fnd = t.wire_by_loc.find(std::make_pair(dst_data.x + dx, dst_data.y + dy));
                     if (fnd == t.wire_by_loc.end())
                         continue;
-                    for (WireId wire : fnd->second) {
+                    for (WireId wire : t.loc_buckets.at(fnd->second)) {
                         ROUTE_LOG_DBG("   seeding with %s\n", ctx->nameOfWire(wire));
                         seed_queue_fwd(wire);
                     }
@@ -671,7 +1266,7 @@ struct Router2
                 WireScore base_score;
                 base_score.cost = 0;
                 int wire_idx = wire_to_idx.at(wire);
-                base_score.togo_cost = get_togo_cost(net, i, wire_idx, src_wire, true, crit_weight);
+                base_score.togo_cost = get_togo_cost(net, i, wire_idx, src_wire_idx, true, crit_weight);
                 t.bwd_queue.push(QueuedWire(wire_idx, base_score));
                 set_visited_bwd(t, wire_idx, PipId());
             };
@@ -692,21 +1287,29 @@ struct Router2
                     auto curr = t.fwd_queue.top();
                     t.fwd_queue.pop();
                     ++explored;
-                    if (was_visited_bwd(curr.wire)) {
+                    if (was_visited_bwd(t, curr.wire)) {
                         // Meet in the middle; done
                         midpoint_wire = curr.wire;
                         break;
                     }
-                    auto &curr_data = flat_wires.at(curr.wire);
-                    for (PipId dh : ctx->getPipsDownhill(curr_data.w)) {
+                    WireId curr_w = wire_ids.at(curr.wire);
+                    ctx->getPipsDownhillInfo(curr_w, t.pips_dh);
+                    for (const auto &dh_info : t.pips_dh) {
+                        PipId dh = dh_info.pip;
                         // Skip pips outside of box in bounding-box mode
-                        if (is_bb && !hit_test_pip(nd.bb, ctx->getPipLocation(dh)))
+                        if (is_bb && !hit_test_pip(nd.bb, dh_info.loc))
+                            continue;
+                        if (t.corridor_active && !hit_test_corridor(t, dh_info.loc))
+                            continue;
+                        // Pips the arch has flagged unusable for every net
+                        // are dropped before the per-net availability query
+                        if (dh_info.blocked)
                             continue;
                         if (!ctx->checkPipAvailForNet(dh, net))
                             continue;
-                        WireId next = ctx->getPipDstWire(dh);
+                        WireId next = dh_info.dst;
                         int next_idx = wire_to_idx.at(next);
-                        if (was_visited_fwd(next_idx)) {
+                        if (was_visited_fwd(t, next_idx)) {
                             // Don't expand the same node twice.
                             continue;
                         }
@@ -717,15 +1320,18 @@ struct Router2
                         if (nwd.reserved_net != -1 && nwd.reserved_net != net->udata)
                             continue;
                         // Don't allow the same wire to be bound to the same net with a different driving pip
-                        auto fnd_wire = nd.wires.find(next);
-                        if (fnd_wire != nd.wires.end() && fnd_wire->second.first != dh)
-                            continue;
+                        if (t.bound_filter_maybe(next_idx)) {
+                            auto fnd_wire = nd.wires.find(next);
+                            if (fnd_wire != nd.wires.end() && fnd_wire->second.first != dh)
+                                continue;
+                        }
                         if (!thread_test_wire(t, nwd))
                             continue; // thread safety issue
                         WireScore next_score;
-                        next_score.cost = curr.score.cost + score_wire_for_arc(net, i, phys_pin, next, dh, crit_weight);
+                        next_score.cost = curr.score.cost + score_wire_for_arc(t, net, i, phys_pin, next_idx, next, dh,
+                                                                               dh_info.delay.maxDelay(), crit_weight);
                         next_score.togo_cost =
-                                cfg.estimate_weight * get_togo_cost(net, i, next_idx, dst_wire, false, crit_weight);
+                                cfg.estimate_weight * get_togo_cost(net, i, next_idx, dst_wire_idx, false, crit_weight);
                         set_visited_fwd(t, next_idx, dh);
                         t.fwd_queue.push(QueuedWire(next_idx, next_score, t.rng.rng()));
                     }
@@ -735,28 +1341,32 @@ struct Router2
                     auto curr = t.bwd_queue.top();
                     t.bwd_queue.pop();
                     ++explored;
-                    if (was_visited_fwd(curr.wire)) {
+                    if (was_visited_fwd(t, curr.wire)) {
                         // Meet in the middle; done
                         midpoint_wire = curr.wire;
                         break;
                     }
-                    auto &curr_data = flat_wires.at(curr.wire);
+                    WireId curr_w = wire_ids.at(curr.wire);
                     // Don't allow the same wire to be bound to the same net with a different driving pip
                     PipId bound_pip;
-                    auto fnd_wire = nd.wires.find(curr_data.w);
-                    if (fnd_wire != nd.wires.end())
-                        bound_pip = fnd_wire->second.first;
+                    if (t.bound_filter_maybe(curr.wire)) {
+                        auto fnd_wire = nd.wires.find(curr_w);
+                        if (fnd_wire != nd.wires.end())
+                            bound_pip = fnd_wire->second.first;
+                    }
 
-                    for (PipId uh : ctx->getPipsUphill(curr_data.w)) {
+                    for (PipId uh : ctx->getPipsUphill(curr_w)) {
                         if (bound_pip != PipId() && bound_pip != uh)
                             continue;
                         if (is_bb && !hit_test_pip(nd.bb, ctx->getPipLocation(uh)))
                             continue;
+                        if (t.corridor_active && !hit_test_corridor(t, ctx->getPipLocation(uh)))
+                            continue;
                         if (!ctx->checkPipAvailForNet(uh, net))
                             continue;
                         WireId next = ctx->getPipSrcWire(uh);
                         int next_idx = wire_to_idx.at(next);
-                        if (was_visited_bwd(next_idx)) {
+                        if (was_visited_bwd(t, next_idx)) {
                             // Don't expand the same node twice.
                             continue;
                         }
@@ -769,9 +1379,11 @@ struct Router2
                         if (!thread_test_wire(t, nwd))
                             continue; // thread safety issue
                         WireScore next_score;
-                        next_score.cost = curr.score.cost + score_wire_for_arc(net, i, phys_pin, next, uh, crit_weight);
+                        next_score.cost = curr.score.cost + score_wire_for_arc(t, net, i, phys_pin, next_idx, next, uh,
+                                                                               ctx->getPipDelay(uh).maxDelay(),
+                                                                               crit_weight);
                         next_score.togo_cost =
-                                cfg.estimate_weight * get_togo_cost(net, i, next_idx, src_wire, true, crit_weight);
+                                cfg.estimate_weight * get_togo_cost(net, i, next_idx, src_wire_idx, true, crit_weight);
                         set_visited_bwd(t, next_idx, uh);
                         t.bwd_queue.push(QueuedWire(next_idx, next_score, t.rng.rng()));
                     }
@@ -779,20 +1391,26 @@ struct Router2
             }
             if (midpoint_wire != -1)
                 break;
+            if (mode == 1 && t.corridor_active) {
+                // Corridor proved too tight; retry the search unrestricted
+                t.corridor_active = false;
+                mode = start_mode - 1;
+            }
         }
         ArcRouteResult result = ARC_SUCCESS;
         if (midpoint_wire != -1) {
             ROUTE_LOG_DBG("   Routed (explored %d wires): ", explored);
             int cursor_bwd = midpoint_wire;
-            while (was_visited_fwd(cursor_bwd)) {
-                PipId pip = flat_wires.at(cursor_bwd).pip_fwd;
+            while (was_visited_fwd(t, cursor_bwd)) {
+                PipId pip = visited_pip_fwd(t, cursor_bwd);
                 if (pip == PipId() && cursor_bwd != src_wire_idx)
                     break;
                 bind_pip_internal(nd, i, cursor_bwd, pip);
+                t.bound_filter_add(cursor_bwd);
                 if (ctx->debug && !is_mt) {
-                    auto &wd = flat_wires.at(cursor_bwd);
-                    ROUTE_LOG_DBG("      fwd wire: %s (curr %d hist %f share %d)\n", ctx->nameOfWire(wd.w),
-                                  wd.curr_cong - 1, wd.hist_cong_cost, nd.wires.at(wd.w).second);
+                    WireId w = wire_ids.at(cursor_bwd);
+                    ROUTE_LOG_DBG("      fwd wire: %s (curr %d hist %f share %d)\n", ctx->nameOfWire(w),
+                                  cong_at(cursor_bwd) - 1, wire_hist_cong.at(cursor_bwd), nd.wires.at(w).second);
                 }
                 if (pip == PipId()) {
                     break;
@@ -804,15 +1422,14 @@ struct Router2
 
             while (cursor_bwd != src_wire_idx) {
                 // Tack onto existing routing
-                WireId bwd_w = flat_wires.at(cursor_bwd).w;
+                WireId bwd_w = wire_ids.at(cursor_bwd);
                 if (!nd.wires.count(bwd_w))
                     break;
                 auto &bound = nd.wires.at(bwd_w);
                 PipId pip = bound.first;
                 if (ctx->debug && !is_mt) {
-                    auto &wd = flat_wires.at(cursor_bwd);
-                    ROUTE_LOG_DBG("      ext wire: %s (curr %d hist %f share %d)\n", ctx->nameOfWire(wd.w),
-                                  wd.curr_cong - 1, wd.hist_cong_cost, bound.second);
+                    ROUTE_LOG_DBG("      ext wire: %s (curr %d hist %f share %d)\n", ctx->nameOfWire(bwd_w),
+                                  cong_at(cursor_bwd) - 1, wire_hist_cong.at(cursor_bwd), bound.second);
                 }
                 bind_pip_internal(nd, i, cursor_bwd, pip);
                 if (pip == PipId())
@@ -823,8 +1440,8 @@ struct Router2
             NPNR_ASSERT(cursor_bwd == src_wire_idx);
 
             int cursor_fwd = midpoint_wire;
-            while (was_visited_bwd(cursor_fwd)) {
-                PipId pip = flat_wires.at(cursor_fwd).pip_bwd;
+            while (was_visited_bwd(t, cursor_fwd)) {
+                PipId pip = visited_pip_bwd(t, cursor_fwd);
                 if (pip == PipId()) {
                     break;
                 }
@@ -832,10 +1449,11 @@ struct Router2
                               ctx->getPipLocation(pip).y);
                 cursor_fwd = wire_to_idx.at(ctx->getPipDstWire(pip));
                 bind_pip_internal(nd, i, cursor_fwd, pip);
+                t.bound_filter_add(cursor_fwd);
                 if (ctx->debug && !is_mt) {
-                    auto &wd = flat_wires.at(cursor_fwd);
-                    ROUTE_LOG_DBG("      bwd wire: %s (curr %d hist %f share %d)\n", ctx->nameOfWire(wd.w),
-                                  wd.curr_cong - 1, wd.hist_cong_cost, nd.wires.at(wd.w).second);
+                    WireId w = wire_ids.at(cursor_fwd);
+                    ROUTE_LOG_DBG("      bwd wire: %s (curr %d hist %f share %d)\n", ctx->nameOfWire(w),
+                                  cong_at(cursor_fwd) - 1, wire_hist_cong.at(cursor_fwd), nd.wires.at(w).second);
                 }
             }
             NPNR_ASSERT(cursor_fwd == dst_wire_idx);
@@ -859,11 +1477,8 @@ struct Router2
 
     bool route_net(ThreadContext &t, NetInfo *net, bool is_mt)
     {
-
-#ifdef ARCH_ECP5
-        if (net->is_global)
+        if (nets.at(net->udata).fixed_routing)
             return true;
-#endif
 
         ROUTE_LOG_DBG("Routing net '%s'...\n", ctx->nameOf(net));
 
@@ -876,18 +1491,24 @@ struct Router2
         bool have_failures = false;
         t.processed_sinks.clear();
         t.route_arcs.clear();
-        t.wire_by_loc.clear();
+        t.clear_loc_buckets();
         t.in_wire_by_loc.clear();
+        t.checked_wires.clear();
         auto &nd = nets.at(net->udata);
         bool failed_slack = false;
-        for (size_t i = 0; i < net->users.size(); i++)
-            failed_slack |= arc_failed_slack(net, i);
+        if (!cfg.incremental_ripup)
+            for (size_t i = 0; i < net->users.size(); i++)
+                failed_slack |= arc_failed_slack(net, i);
         for (size_t i = 0; i < net->users.size(); i++) {
             auto &ad = nd.arcs.at(i);
+            // In incremental rip-up mode only the arcs that actually failed
+            // slack are ripped; passing arcs and the trunk they share are
+            // retained and re-seeded into the search
+            bool arc_slack_fail = failed_slack || (cfg.incremental_ripup && arc_failed_slack(net, i));
             for (size_t j = 0; j < ad.size(); j++) {
                 // Ripup failed arcs to start with
                 // Check if arc is already legally routed
-                if (!failed_slack && check_arc_routing(net, i, j)) {
+                if (!arc_slack_fail && check_arc_routing(net, i, j, &t)) {
                     update_wire_by_loc(t, net, i, j, true);
                     continue;
                 }
@@ -902,6 +1523,34 @@ struct Router2
                          [&](std::pair<size_t, size_t> a, std::pair<size_t, size_t> b) {
                              return get_arc_crit(net, a.first) > get_arc_crit(net, b.first);
                          });
+        // For high-fanout nets, approximate a Steiner topology through the
+        // existing trunk-reuse machinery: keep timing-critical arcs in
+        // criticality order at the front, then grow the tree outward by
+        // routing the remaining sinks closest-to-driver first. Each search
+        // then starts next to routing laid down by the previous arcs, and
+        // the nd.wires bonus in score_wire_for_arc shares the trunk instead
+        // of re-exploring it once per sink
+        if (int(t.route_arcs.size()) >= cfg.fanout_share_thresh && net->driver.cell->bel != BelId()) {
+            Loc drv_loc = ctx->getBelLocation(net->driver.cell->bel);
+            auto arc_dist = [&](const std::pair<size_t, size_t> &a) {
+                Loc usr_loc = ctx->getBelLocation(net->users.at(a.first).cell->bel);
+                return std::abs(usr_loc.x - drv_loc.x) + std::abs(usr_loc.y - drv_loc.y);
+            };
+            std::stable_sort(t.route_arcs.begin(), t.route_arcs.end(),
+                             [&](const std::pair<size_t, size_t> &a, const std::pair<size_t, size_t> &b) {
+                                 bool a_crit = get_arc_crit(net, a.first) > cfg.fanout_share_crit;
+                                 bool b_crit = get_arc_crit(net, b.first) > cfg.fanout_share_crit;
+                                 if (a_crit != b_crit)
+                                     return a_crit;
+                                 // Critical arcs keep their criticality order
+                                 if (a_crit)
+                                     return false;
+                                 return arc_dist(a) < arc_dist(b);
+                             });
+        }
+        // Summarise the surviving routing (retained arcs, pre-bound wires)
+        // before expansion starts consulting the filter
+        build_bound_filter(t, nd);
         for (auto a : t.route_arcs) {
             auto res1 = route_arc(t, net, a.first, a.second, is_mt, true);
             if (res1 == ARC_FATAL)
@@ -938,6 +1587,7 @@ struct Router2
             nets.at(net->udata).total_route_us +=
                     (std::chrono::duration_cast<std::chrono::microseconds>(rend - rstart).count());
         }
+        validate_route_tree(nd);
         return !have_failures;
     }
 #undef ROUTE_LOG_DBG
@@ -945,8 +1595,22 @@ struct Router2
     int total_wire_use = 0;
     int overused_wires = 0;
     int total_overuse = 0;
+    // Per-iteration worst slack and total overuse, for the convergence
+    // monitor in the main loop
+    std::vector<delay_t> slack_history;
+    std::vector<int> overuse_history;
     std::vector<int> route_queue;
+    // Nets whose route delays were already computed by do_route()'s
+    // pipelined serial tail; update_route_delays() skips them
+    pool<int> delays_prefetched;
     std::set<int> failed_nets;
+    // Worker cap for the current iteration; adapted between iterations from
+    // how much of the previous queue actually routed in parallel, so the
+    // low-net tail of the congestion loop stops paying full fork/join cost
+    int worker_limit = 1;
+    // Queue size and serially-routed net count from the previous do_route,
+    // the inputs to that adaptation
+    int last_total_nets = 0, last_serial_nets = 0;
 
     void update_congestion()
     {
@@ -954,49 +1618,171 @@ struct Router2
         overused_wires = 0;
         total_wire_use = 0;
         failed_nets.clear();
-        pool<WireId> already_updated;
-        for (size_t i = 0; i < nets.size(); i++) {
-            auto &nd = nets.at(i);
-            for (const auto &w : nd.wires) {
-                ++total_wire_use;
-                auto &wd = wire_data(w.first);
-                if (wd.curr_cong > 1) {
-                    if (already_updated.count(w.first)) {
-                        ++total_overuse;
-                    } else {
-                        if (curr_cong_weight > 0)
-                            wd.hist_cong_cost =
-                                    std::min(1e9, wd.hist_cong_cost + (wd.curr_cong - 1) * hist_cong_weight);
-                        already_updated.insert(w.first);
-                        ++overused_wires;
+        std::fill(tile_overuse.begin(), tile_overuse.end(), 0.0f);
+        // The per-net wire walks (and fail_bb updates, owned by their net)
+        // run chunked across the pool; each chunk reports its counters plus
+        // the overused wires and failed nets it saw, and the partials are
+        // folded in ascending chunk order so the merged lists are identical
+        // whatever the thread count. The once-per-wire history and heatmap
+        // updates are then applied serially from the merged list, in the
+        // same net order as the old single-threaded scan.
+        struct CongStats
+        {
+            int wire_use = 0;
+            std::vector<int> overused; // one entry per (net, wire) encounter
+            std::vector<int> failed;   // net indices, ascending
+        };
+        auto stats = ThreadPool::get().reduce_chunks(
+                nets.size(), 64, CongStats{},
+                [&](size_t begin, size_t end) {
+                    CongStats result;
+                    for (size_t i = begin; i < end; i++) {
+                        auto &nd = nets.at(i);
+                        nd.fail_bb = ArcBounds(std::numeric_limits<int>::max(), std::numeric_limits<int>::max(),
+                                               std::numeric_limits<int>::min(), std::numeric_limits<int>::min());
+                        bool net_failed = false;
+                        for (const auto &w : nd.wires) {
+                            ++result.wire_use;
+                            int wire_idx = wire_to_idx.at(w.first);
+                            if (cong_at(wire_idx) > 1) {
+                                result.overused.push_back(wire_idx);
+                                auto &fwd = flat_wires.at(wire_idx);
+                                nd.fail_bb.x0 = std::min<int>(nd.fail_bb.x0, fwd.x);
+                                nd.fail_bb.y0 = std::min<int>(nd.fail_bb.y0, fwd.y);
+                                nd.fail_bb.x1 = std::max<int>(nd.fail_bb.x1, fwd.x);
+                                nd.fail_bb.y1 = std::max<int>(nd.fail_bb.y1, fwd.y);
+                                net_failed = true;
+                            }
+                        }
+                        if (net_failed)
+                            result.failed.push_back(int(i));
                     }
-                    failed_nets.insert(i);
-                }
+                    return result;
+                },
+                [](CongStats a, CongStats b) {
+                    a.wire_use += b.wire_use;
+                    a.overused.insert(a.overused.end(), b.overused.begin(), b.overused.end());
+                    a.failed.insert(a.failed.end(), b.failed.begin(), b.failed.end());
+                    return a;
+                });
+        total_wire_use = stats.wire_use;
+        for (int n : stats.failed)
+            failed_nets.insert(n);
+        pool<int> already_updated;
+        for (int wire_idx : stats.overused) {
+            int32_t cong = cong_at(wire_idx);
+            if (!already_updated.insert(wire_idx).second) {
+                ++total_overuse;
+                continue;
             }
+            if (curr_cong_weight > 0)
+                wire_hist_cong.at(wire_idx) =
+                        std::min(1e9, wire_hist_cong.at(wire_idx) + (cong - 1) * hist_cong_weight);
+            ++overused_wires;
+            auto &pwd = flat_wires.at(wire_idx);
+            if (!tile_overuse.empty() && pwd.x < tile_w && pwd.y < tile_h)
+                tile_overuse[size_t(pwd.y) * tile_w + pwd.x] += float(cong - 1);
         }
         for (int n : failed_nets) {
             auto &net_data = nets.at(n);
             ++net_data.fail_count;
             if ((net_data.fail_count % 3) == 0) {
                 // Every three times a net fails to route, expand the bounding box to increase the search space
-#ifndef ARCH_MISTRAL
-                // This patch seems to make thing worse for CycloneV, as it slows down the resolution of TD congestion,
-                // disable it
-                net_data.bb.x0 = std::max(net_data.bb.x0 - 1, 0);
-                net_data.bb.y0 = std::max(net_data.bb.y0 - 1, 0);
-                net_data.bb.x1 = std::min(net_data.bb.x1 + 1, ctx->getGridDimX());
-                net_data.bb.y1 = std::min(net_data.bb.y1 + 1, ctx->getGridDimY());
-#endif
+                // (unless the arch has found this counterproductive)
+                if (Arch::capExpandBBOnRouteFail)
+                    expand_net_bb(net_data);
+            }
+        }
+    }
+
+    // Total overuse in the one-tile-wide heatmap strip (x0, y0)..(x1, y1),
+    // used to compare the spare capacity just outside each side of a box
+    float strip_overuse(int x0, int y0, int x1, int y1) const
+    {
+        float sum = 0;
+        for (int y = std::max(y0, 0); y <= std::min(y1, tile_h - 1); y++)
+            for (int x = std::max(x0, 0); x <= std::min(x1, tile_w - 1); x++)
+                sum += tile_overuse_at(x, y);
+        return sum;
+    }
+
+    // Grow a repeatedly-failing net's search box. The old policy expanded
+    // uniformly on all four sides, so stuck nets ballooned to whole-chip
+    // boxes that do_route() could only place in the serial cross-partition
+    // bins, serializing multi-threaded runs. Instead grow only toward the
+    // failure: the sides of the box the net's overused wires are pressed
+    // against. If the congestion is interior (no side pressed), grow the
+    // single side whose neighbouring strip in the congestion heatmap has the
+    // least overuse, i.e. the most spare capacity for a detour. do_route()
+    // re-bins every net from its bounding box each iteration, so a net
+    // expanded this way is re-partitioned automatically and usually stays
+    // parallel-routable instead of dropping straight into the serial bin
+    void expand_net_bb(PerNetData &net_data)
+    {
+        auto &bb = net_data.bb;
+        const auto &fb = net_data.fail_bb;
+        if (fb.x0 > fb.x1) {
+            // No overused wires recorded for this net (e.g. it failed on
+            // timing ripup rather than congestion): keep the old uniform
+            // expansion
+            bb.x0 = std::max(bb.x0 - 1, 0);
+            bb.y0 = std::max(bb.y0 - 1, 0);
+            bb.x1 = std::min(bb.x1 + 1, ctx->getGridDimX());
+            bb.y1 = std::min(bb.y1 + 1, ctx->getGridDimY());
+            return;
+        }
+        // A side is pressed if the failure hotspot comes within two tiles of
+        // it; sides already at the edge of the grid can't grow
+        const int near = 2;
+        bool can_grow[4] = {bb.x0 > 0, bb.x1 < ctx->getGridDimX(), bb.y0 > 0, bb.y1 < ctx->getGridDimY()};
+        bool pressed[4] = {can_grow[0] && fb.x0 <= bb.x0 + near, can_grow[1] && fb.x1 >= bb.x1 - near,
+                           can_grow[2] && fb.y0 <= bb.y0 + near, can_grow[3] && fb.y1 >= bb.y1 - near};
+        if (pressed[0] || pressed[1] || pressed[2] || pressed[3]) {
+            if (pressed[0])
+                bb.x0 = std::max(bb.x0 - 1, 0);
+            if (pressed[1])
+                bb.x1 = std::min(bb.x1 + 1, ctx->getGridDimX());
+            if (pressed[2])
+                bb.y0 = std::max(bb.y0 - 1, 0);
+            if (pressed[3])
+                bb.y1 = std::min(bb.y1 + 1, ctx->getGridDimY());
+            return;
+        }
+        // Interior congestion: pick the one growable side with the least
+        // congested strip just outside it
+        float best_over = std::numeric_limits<float>::max();
+        int best_side = -1;
+        for (int side = 0; side < 4; side++) {
+            if (!can_grow[side])
+                continue;
+            float over;
+            if (side == 0)
+                over = strip_overuse(bb.x0 - 1, bb.y0, bb.x0 - 1, bb.y1);
+            else if (side == 1)
+                over = strip_overuse(bb.x1 + 1, bb.y0, bb.x1 + 1, bb.y1);
+            else if (side == 2)
+                over = strip_overuse(bb.x0, bb.y0 - 1, bb.x1, bb.y0 - 1);
+            else
+                over = strip_overuse(bb.x0, bb.y1 + 1, bb.x1, bb.y1 + 1);
+            if (over < best_over) {
+                best_over = over;
+                best_side = side;
             }
         }
+        if (best_side == 0)
+            bb.x0 = std::max(bb.x0 - 1, 0);
+        else if (best_side == 1)
+            bb.x1 = std::min(bb.x1 + 1, ctx->getGridDimX());
+        else if (best_side == 2)
+            bb.y0 = std::max(bb.y0 - 1, 0);
+        else if (best_side == 3)
+            bb.y1 = std::min(bb.y1 + 1, ctx->getGridDimY());
     }
 
     bool bind_and_check(NetInfo *net, int usr_idx, int phys_pin)
     {
-#ifdef ARCH_ECP5
-        if (net->is_global)
+        if (nets.at(net->udata).fixed_routing)
             return true;
-#endif
         bool success = true;
         auto &nd = nets.at(net->udata);
         auto &ad = nd.arcs.at(usr_idx).at(phys_pin);
@@ -1064,8 +1850,7 @@ struct Router2
         if (success) {
             if (ctx->getBoundWireNet(src) == nullptr)
                 ctx->bindWire(src, net, STRENGTH_WEAK);
-            for (auto tb : to_bind)
-                ctx->bindPip(tb, net, STRENGTH_WEAK);
+            ctx->bindPips(to_bind, net, STRENGTH_WEAK);
         } else {
             ripup_arc(net, usr_idx, phys_pin);
             failed_nets.insert(net->udata);
@@ -1082,10 +1867,8 @@ struct Router2
         bool success = true;
         std::vector<WireId> net_wires;
         for (auto net : nets_by_udata) {
-#ifdef ARCH_ECP5
-            if (net->is_global)
+            if (nets.at(net->udata).fixed_routing)
                 continue;
-#endif
             // Ripup wires and pips used by the net in nextpnr's structures
             net_wires.clear();
             for (auto &w : net->wires) {
@@ -1125,9 +1908,9 @@ struct Router2
         dict<IdString, std::vector<int>> cong_by_type;
         size_t max_cong = 0;
         // Build histogram
-        for (auto &wd : flat_wires) {
-            size_t val = wd.curr_cong;
-            IdString type = ctx->getWireType(wd.w);
+        for (size_t i = 0; i < flat_wires.size(); i++) {
+            size_t val = cong_at(int(i));
+            IdString type = ctx->getWireType(wire_ids.at(i));
             max_cong = std::max(max_cong, val);
             if (cong_by_type[type].size() <= max_cong)
                 cong_by_type[type].resize(max_cong + 1);
@@ -1146,7 +1929,46 @@ struct Router2
         }
     }
 
+    // Per-tile view of where the router spends its effort: A* visit counts,
+    // accumulated historical congestion cost and current overuse, bucketed
+    // by the notional (x, y) location of each wire. One row per tile with
+    // any activity; the visit counters are reset after writing so each
+    // iteration's file covers that iteration only
+    void write_tile_heatmap(std::ostream &out)
+    {
+        int width = std::max(1, ctx->getGridDimX()), height = std::max(1, ctx->getGridDimY());
+        std::vector<uint64_t> visits(size_t(width) * height, 0);
+        std::vector<double> hist(size_t(width) * height, 0.0);
+        std::vector<int64_t> overuse(size_t(width) * height, 0);
+        for (size_t i = 0; i < flat_wires.size(); i++) {
+            auto &pwd = flat_wires.at(i);
+            int x = std::max(0, std::min(int(pwd.x), width - 1));
+            int y = std::max(0, std::min(int(pwd.y), height - 1));
+            size_t tile = size_t(y) * width + x;
+            if (!wire_visit_count.empty())
+                visits.at(tile) += wire_visit_count[i].load(std::memory_order_relaxed);
+            hist.at(tile) += double(wire_hist_cong.at(i) - 1.0f);
+            int32_t cong = cong_at(int(i));
+            if (cong > 1)
+                overuse.at(tile) += (cong - 1);
+        }
+        out << "x,y,visits,hist_cong,overuse" << std::endl;
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++) {
+                size_t tile = size_t(y) * width + x;
+                if (visits.at(tile) == 0 && hist.at(tile) == 0.0 && overuse.at(tile) == 0)
+                    continue;
+                out << x << "," << y << "," << visits.at(tile) << "," << hist.at(tile) << "," << overuse.at(tile)
+                    << std::endl;
+            }
+        for (auto &count : wire_visit_count)
+            count.store(0, std::memory_order_relaxed);
+    }
+
     int mid_x = 0, mid_y = 0;
+    // Quartile splitpoints, for the finer-grained 4x4 partition used by the
+    // work-stealing scheduler
+    int q1_x = 0, q3_x = 0, q1_y = 0, q3_y = 0;
 
     void partition_nets()
     {
@@ -1158,22 +1980,31 @@ struct Router2
             if (n.cy != -1)
                 ++cys[n.cy];
         }
-        // 4-way split for now
+        // Quartile and median splitpoints; the quartiles feed the finer 4x4
+        // bins used by the work-stealing scheduler
         int accum_x = 0, accum_y = 0;
-        int halfway = int(nets.size()) / 2;
+        int quarter = int(nets.size()) / 4, halfway = int(nets.size()) / 2, three_q = (3 * int(nets.size())) / 4;
         for (auto &p : cxs) {
+            if (accum_x < quarter && (accum_x + p.second) >= quarter)
+                q1_x = p.first;
             if (accum_x < halfway && (accum_x + p.second) >= halfway)
                 mid_x = p.first;
+            if (accum_x < three_q && (accum_x + p.second) >= three_q)
+                q3_x = p.first;
             accum_x += p.second;
         }
         for (auto &p : cys) {
+            if (accum_y < quarter && (accum_y + p.second) >= quarter)
+                q1_y = p.first;
             if (accum_y < halfway && (accum_y + p.second) >= halfway)
                 mid_y = p.first;
+            if (accum_y < three_q && (accum_y + p.second) >= three_q)
+                q3_y = p.first;
             accum_y += p.second;
         }
         if (ctx->verbose) {
-            log_info("    x splitpoint: %d\n", mid_x);
-            log_info("    y splitpoint: %d\n", mid_y);
+            log_info("    x splitpoints: %d %d %d\n", q1_x, mid_x, q3_x);
+            log_info("    y splitpoints: %d %d %d\n", q1_y, mid_y, q3_y);
         }
         std::vector<int> bins(5, 0);
         for (auto &n : nets) {
@@ -1204,8 +2035,11 @@ struct Router2
 
     void do_route()
     {
-        // Don't multithread if fewer than 200 nets (heuristic)
-        if (route_queue.size() < 200) {
+        last_total_nets = int(route_queue.size());
+        // Don't multithread if fewer than 200 nets (heuristic), or if the
+        // last iteration showed the queue can't feed even one worker
+        if (worker_limit == 1 || route_queue.size() < 200) {
+            last_serial_nets = last_total_nets;
             ThreadContext st;
             st.rng.rngseed(ctx->rng64());
             st.bb = ArcBounds(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
@@ -1214,103 +2048,190 @@ struct Router2
             }
             return;
         }
-        const int Nq = 4, Nv = 2, Nh = 2;
-        const int N = Nq + Nv + Nh;
+        // Bins are organised in phases of spatially-disjoint regions: a 4x4
+        // grid of cells, then the 2x2 quadrants, then vertical and horizontal
+        // halves, then a serial bin for nets crossing the median splits.
+        // Within a phase, idle workers claim the next unrouted bin, so a
+        // single congested region no longer leaves the other threads idle.
+        const int Nc = 16, Nq = 4, Nv = 2, Nh = 2;
+        const int N = Nc + Nq + Nv + Nh;
         std::vector<ThreadContext> tcs(N + 1);
         for (auto &th : tcs) {
             th.rng.rngseed(ctx->rng64());
         }
-        int le_x = mid_x;
-        int rs_x = mid_x;
-        int le_y = mid_y;
-        int rs_y = mid_y;
+        const int inf = std::numeric_limits<int>::max();
+        // Grid boundaries. As with the quadrant split, a net belongs to a
+        // cell if it lies strictly below the upper splitpoint, but the cell's
+        // routing bounding box extends up to and including it
+        const std::array<int, 4> xlo{0, q1_x, mid_x, q3_x}, xhi{q1_x - 1, mid_x - 1, q3_x - 1, inf};
+        const std::array<int, 4> xlo_bb{0, q1_x + 1, mid_x + 1, q3_x + 1}, xhi_bb{q1_x, mid_x, q3_x, inf};
+        const std::array<int, 4> ylo{0, q1_y, mid_y, q3_y}, yhi{q1_y - 1, mid_y - 1, q3_y - 1, inf};
+        const std::array<int, 4> ylo_bb{0, q1_y + 1, mid_y + 1, q3_y + 1}, yhi_bb{q1_y, mid_y, q3_y, inf};
         // Set up thread bounding boxes
-        tcs.at(0).bb = ArcBounds(0, 0, mid_x, mid_y);
-        tcs.at(1).bb = ArcBounds(mid_x + 1, 0, std::numeric_limits<int>::max(), le_y);
-        tcs.at(2).bb = ArcBounds(0, mid_y + 1, mid_x, std::numeric_limits<int>::max());
-        tcs.at(3).bb =
-                ArcBounds(mid_x + 1, mid_y + 1, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+        for (int cy = 0; cy < 4; cy++)
+            for (int cx = 0; cx < 4; cx++)
+                tcs.at(cy * 4 + cx).bb = ArcBounds(xlo_bb[cx], ylo_bb[cy], xhi_bb[cx], yhi_bb[cy]);
 
-        tcs.at(4).bb = ArcBounds(0, 0, std::numeric_limits<int>::max(), mid_y);
-        tcs.at(5).bb = ArcBounds(0, mid_y + 1, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+        tcs.at(Nc + 0).bb = ArcBounds(0, 0, mid_x, mid_y);
+        tcs.at(Nc + 1).bb = ArcBounds(mid_x + 1, 0, inf, mid_y);
+        tcs.at(Nc + 2).bb = ArcBounds(0, mid_y + 1, mid_x, inf);
+        tcs.at(Nc + 3).bb = ArcBounds(mid_x + 1, mid_y + 1, inf, inf);
 
-        tcs.at(6).bb = ArcBounds(0, 0, mid_x, std::numeric_limits<int>::max());
-        tcs.at(7).bb = ArcBounds(mid_x + 1, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+        tcs.at(Nc + Nq + 0).bb = ArcBounds(0, 0, inf, mid_y);
+        tcs.at(Nc + Nq + 1).bb = ArcBounds(0, mid_y + 1, inf, inf);
 
-        tcs.at(8).bb = ArcBounds(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+        tcs.at(Nc + Nq + Nv + 0).bb = ArcBounds(0, 0, mid_x, inf);
+        tcs.at(Nc + Nq + Nv + 1).bb = ArcBounds(mid_x + 1, 0, inf, inf);
 
+        tcs.at(N).bb = ArcBounds(0, 0, inf, inf);
+
+        auto fits = [](int v0, int v1, int lo, int hi) { return v0 >= lo && v1 <= hi; };
         for (auto n : route_queue) {
             auto &nd = nets.at(n);
             auto ni = nets_by_udata.at(n);
             int bin = N;
+            // 4x4 grid cells
+            int cell_x = -1, cell_y = -1;
+            for (int i = 0; i < 4; i++) {
+                if (fits(nd.bb.x0, nd.bb.x1, xlo[i], xhi[i]))
+                    cell_x = i;
+                if (fits(nd.bb.y0, nd.bb.y1, ylo[i], yhi[i]))
+                    cell_y = i;
+            }
+            if (cell_x != -1 && cell_y != -1)
+                bin = cell_y * 4 + cell_x;
             // Quadrants
-            if (nd.bb.x0 < le_x && nd.bb.x1 < le_x && nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = 0;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x && nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = 1;
-            else if (nd.bb.x0 < le_x && nd.bb.x1 < le_x && nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = 2;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x && nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = 3;
+            else if (nd.bb.x0 < mid_x && nd.bb.x1 < mid_x && nd.bb.y0 < mid_y && nd.bb.y1 < mid_y)
+                bin = Nc + 0;
+            else if (nd.bb.x0 >= mid_x && nd.bb.x1 >= mid_x && nd.bb.y0 < mid_y && nd.bb.y1 < mid_y)
+                bin = Nc + 1;
+            else if (nd.bb.x0 < mid_x && nd.bb.x1 < mid_x && nd.bb.y0 >= mid_y && nd.bb.y1 >= mid_y)
+                bin = Nc + 2;
+            else if (nd.bb.x0 >= mid_x && nd.bb.x1 >= mid_x && nd.bb.y0 >= mid_y && nd.bb.y1 >= mid_y)
+                bin = Nc + 3;
             // Vertical split
-            else if (nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = Nq + 0;
-            else if (nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = Nq + 1;
+            else if (nd.bb.y0 < mid_y && nd.bb.y1 < mid_y)
+                bin = Nc + Nq + 0;
+            else if (nd.bb.y0 >= mid_y && nd.bb.y1 >= mid_y)
+                bin = Nc + Nq + 1;
             // Horizontal split
-            else if (nd.bb.x0 < le_x && nd.bb.x1 < le_x)
-                bin = Nq + Nv + 0;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x)
-                bin = Nq + Nv + 1;
+            else if (nd.bb.x0 < mid_x && nd.bb.x1 < mid_x)
+                bin = Nc + Nq + Nv + 0;
+            else if (nd.bb.x0 >= mid_x && nd.bb.x1 >= mid_x)
+                bin = Nc + Nq + Nv + 1;
             tcs.at(bin).route_nets.push_back(ni);
         }
         if (ctx->verbose)
             log_info("%d/%d nets not multi-threadable\n", int(tcs.at(N).route_nets.size()), int(route_queue.size()));
-#ifdef NPNR_DISABLE_THREADS
-        // Singlethreaded routing - quadrants
-        for (int i = 0; i < Nq; i++) {
-            router_thread(tcs.at(i), /*is_mt=*/false);
-        }
+        // Route one phase of mutually-disjoint bins on the shared worker
+        // pool; idle workers steal the next unclaimed bin. Bins in a phase
+        // never overlap so the claim order doesn't affect results.
+        auto run_phase = [&](int bin_begin, int bin_end) {
+            auto &pool = ThreadPool::get();
+            if (pool.num_workers() == 1 || worker_limit == 1) {
+                for (int i = bin_begin; i < bin_end; i++)
+                    router_thread(tcs.at(i), /*is_mt=*/false);
+                return;
+            }
+            pool.run_chunks(
+                    size_t(bin_end - bin_begin), 1,
+                    [&](size_t begin, size_t end) {
+                        for (size_t bin = begin; bin < end; bin++)
+                            router_thread(tcs.at(bin_begin + int(bin)), /*is_mt=*/true);
+                    },
+                    worker_limit);
+        };
+        // 4x4 cells
+        run_phase(0, Nc);
+        // Quadrants
+        run_phase(Nc, Nc + Nq);
         // Vertical splits
-        for (int i = Nq; i < Nq + Nv; i++) {
-            router_thread(tcs.at(i), /*is_mt=*/false);
-        }
+        run_phase(Nc + Nq, Nc + Nq + Nv);
         // Horizontal splits
-        for (int i = Nq + Nv; i < Nq + Nv + Nh; i++) {
-            router_thread(tcs.at(i), /*is_mt=*/false);
-        }
-#else
-        // Multithreaded part of routing - quadrants
-        std::vector<boost::thread> threads;
-        for (int i = 0; i < Nq; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i), /*is_mt=*/true); });
-        }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-        // Vertical splits
-        for (int i = Nq; i < Nq + Nv; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i), /*is_mt=*/true); });
+        run_phase(Nc + Nq + Nv, N);
+        // Nets that cross the median splits can't be given a disjoint
+        // region, but they can still be routed concurrently: these contexts
+        // use thread-local visit state and score against a frozen congestion
+        // snapshot (see ThreadContext::cross_region), with the atomic
+        // congestion counters keeping the live counts consistent. Nets are
+        // distributed statically so each is always routed by the same
+        // context, keeping results independent of thread scheduling
+        auto &leftover = tcs.at(N).route_nets;
+        for (int i = 0; i < N; i++)
+            for (auto fail : tcs.at(i).failed_nets)
+                leftover.push_back(fail);
+        if (leftover.size() >= 30 && worker_limit > 1 && ThreadPool::get().num_workers() > 1) {
+            cong_snapshot.resize(wire_cong.size());
+            for (size_t i = 0; i < wire_cong.size(); i++)
+                cong_snapshot[i] = cong_at(int(i));
+            int num_contexts = std::max<int>(1, std::min<int>(worker_limit, int(leftover.size()) / 15));
+            std::vector<ThreadContext> xtcs(num_contexts);
+            for (int i = 0; i < num_contexts; i++) {
+                xtcs.at(i).rng.rngseed(ctx->rng64());
+                xtcs.at(i).bb = ArcBounds(0, 0, inf, inf);
+                xtcs.at(i).cross_region = true;
+            }
+            for (int i = 0; i < int(leftover.size()); i++)
+                xtcs.at(i % num_contexts).route_nets.push_back(leftover.at(i));
+            ThreadPool::get().run_chunks(size_t(num_contexts), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    router_thread(xtcs.at(i), /*is_mt=*/true);
+            });
+            // Nets that still failed (e.g. needing to escape their bounding
+            // box, which multithreaded routing can't do) get a serial retry
+            leftover.clear();
+            for (auto &xt : xtcs)
+                for (auto fail : xt.failed_nets)
+                    leftover.push_back(fail);
         }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-        // Horizontal splits
-        for (int i = Nq + Nv; i < Nq + Nv + Nh; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i), /*is_mt=*/true); });
+        // Whatever reaches this loop (median-crossing nets the cross-region
+        // pass didn't take, plus retries) is the work the extra threads
+        // couldn't help with
+        last_serial_nets = int(leftover.size());
+        // Rather than let the rest of the pool idle behind the tail, overlap
+        // it with the next stage of the iteration: one worker routes the
+        // tail nets in fixed order (it is the only router running, so the
+        // shared visit state is safe), while the others compute route delays
+        // for the nets whose routing is already final - everything not in
+        // the tail. update_route_delays() then only has the tail nets left
+        // to walk. The tail worker routes in multi-threaded mode so any
+        // fatal diagnostics are deferred; arcs that need to escape their
+        // bounding box fall through to the serial loop below as before
+        if (!leftover.empty() && worker_limit > 1 && ThreadPool::get().num_workers() > 1) {
+            pool<int> tail_nets;
+            for (auto ln : leftover)
+                tail_nets.insert(ln->udata);
+            std::vector<int> stable_nets;
+            for (int net : route_queue)
+                if (!tail_nets.count(net))
+                    stable_nets.push_back(net);
+            std::vector<NetInfo *> tail_failed;
+            std::atomic<size_t> cursor(0);
+            constexpr size_t chunk_size = 64;
+            auto &pool = ThreadPool::get();
+            pool.execute(
+                    [&](int worker) {
+                        if (worker == 0) {
+                            for (auto tn : leftover)
+                                if (!route_net(tcs.at(N), tn, true))
+                                    tail_failed.push_back(tn);
+                        }
+                        size_t begin;
+                        while ((begin = cursor.fetch_add(chunk_size)) < stable_nets.size()) {
+                            size_t end = std::min(begin + chunk_size, stable_nets.size());
+                            for (size_t i = begin; i < end; i++)
+                                update_net_route_delay(stable_nets.at(i));
+                        }
+                    },
+                    std::min(worker_limit, pool.num_workers()));
+            for (int net : stable_nets)
+                delays_prefetched.insert(net);
+            leftover.clear();
+            for (auto fail : tail_failed)
+                leftover.push_back(fail);
         }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-#endif
-        // Singlethreaded part of routing - nets that cross partitions
-        // or don't fit within bounding box
-        for (auto st_net : tcs.at(N).route_nets)
+        for (auto st_net : leftover)
             route_net(tcs.at(N), st_net, false);
-        // Failed nets
-        for (int i = 0; i < N; i++)
-            for (auto fail : tcs.at(i).failed_nets)
-                route_net(tcs.at(N), fail, false);
     }
 
     delay_t get_route_delay(int net, int usr_idx, int phys_idx)
@@ -1335,42 +2256,57 @@ struct Router2
         return delay;
     }
 
+    void update_net_route_delay(int net)
+    {
+        NetInfo *ni = nets_by_udata.at(net);
+        if (nets.at(net).fixed_routing)
+            return;
+        auto &nd = nets.at(net);
+        for (int i = 0; i < int(nd.arcs.size()); i++) {
+            delay_t arc_delay = 0;
+            for (int j = 0; j < int(nd.arcs.at(i).size()); j++)
+                arc_delay = std::max(arc_delay, get_route_delay(net, i, j));
+            tmg.set_route_delay(CellPortKey(ni->users.at(i)), DelayPair(arc_delay));
+        }
+    }
+
     void update_route_delays()
     {
         for (int net : route_queue) {
-            NetInfo *ni = nets_by_udata.at(net);
-#ifdef ARCH_ECP5
-            if (ni->is_global)
+            if (delays_prefetched.count(net))
                 continue;
-#endif
-            auto &nd = nets.at(net);
-            for (int i = 0; i < int(nd.arcs.size()); i++) {
-                delay_t arc_delay = 0;
-                for (int j = 0; j < int(nd.arcs.at(i).size()); j++)
-                    arc_delay = std::max(arc_delay, get_route_delay(net, i, j));
-                tmg.set_route_delay(CellPortKey(ni->users.at(i)), DelayPair(arc_delay));
-            }
+            update_net_route_delay(net);
         }
+        delays_prefetched.clear();
     }
 
-    void operator()()
+    // Main-loop state lifted out of operator() so the loop can also be
+    // driven one iteration at a time from the scripting API (see
+    // Router2Stepper); iter counts the iteration about to run
+    std::chrono::high_resolution_clock::time_point rstart;
+    std::unique_ptr<ScopeLock<Context>> lock;
+    int iter = 1;
+
+    void begin_routing()
     {
         log_info("Running router2...\n");
         log_info("Setting up routing resources...\n");
-        auto rstart = std::chrono::high_resolution_clock::now();
+        rstart = std::chrono::high_resolution_clock::now();
         setup_nets();
         setup_wires();
+        if (cfg.use_lookahead)
+            build_lookahead();
         find_all_reserved_wires();
         partition_nets();
         curr_cong_weight = cfg.init_curr_cong_weight;
         hist_cong_weight = cfg.hist_cong_weight;
-        ThreadContext st;
-        int iter = 1;
 
-        ScopeLock<Context> lock(ctx);
+        lock = std::make_unique<ScopeLock<Context>>(ctx);
 
         for (size_t i = 0; i < nets_by_udata.size(); i++)
             route_queue.push_back(i);
+        // First iteration routes the whole design; start with the full pool
+        worker_limit = ThreadPool::get().num_workers();
 
         timing_driven = ctx->setting<bool>("timing_driven");
         if (ctx->settings.count(ctx->id("router/tmg_ripup")))
@@ -1380,21 +2316,39 @@ struct Router2
         log_info("Running main router loop...\n");
         if (timing_driven)
             tmg.run(true);
-        do {
+    }
+
+    // One iteration of the main congestion-negotiation loop; returns true
+    // while failed arcs remain and another iteration is needed. The final
+    // iteration also binds the routing through the arch API
+    bool route_iteration()
+    {
+        {
             ctx->sorted_shuffle(route_queue);
 
-            if (timing_driven && int(route_queue.size()) >= 30) {
-                for (auto n : route_queue) {
-                    NetInfo *ni = nets_by_udata.at(n);
-                    auto &net = nets.at(n);
-                    net.max_crit = 0;
-                    for (auto &usr : ni->users) {
-                        float c = tmg.get_criticality(CellPortKey(usr));
-                        net.max_crit = std::max(net.max_crit, c);
+            // Order the queue so the most constrained nets route while wire
+            // choice is still cheap: timing criticality first, boosted by how
+            // often a net has already failed on congestion. In non-timing
+            // driven mode criticality is zero and the ordering degenerates to
+            // repeat offenders first
+            if (int(route_queue.size()) >= 30) {
+                if (timing_driven) {
+                    for (auto n : route_queue) {
+                        NetInfo *ni = nets_by_udata.at(n);
+                        auto &net = nets.at(n);
+                        net.max_crit = 0;
+                        for (size_t i = 0; i < ni->users.size(); i++) {
+                            float c = tmg.get_criticality(ni, i);
+                            net.max_crit = std::max(net.max_crit, c);
+                        }
                     }
                 }
+                auto order_prio = [&](int n) {
+                    auto &net = nets.at(n);
+                    return net.max_crit + cfg.fail_order_weight * std::min(net.fail_count, 10);
+                };
                 std::stable_sort(route_queue.begin(), route_queue.end(),
-                                 [&](int na, int nb) { return nets.at(na).max_crit > nets.at(nb).max_crit; });
+                                 [&](int na, int nb) { return order_prio(na) > order_prio(nb); });
             }
 
             do_route();
@@ -1409,20 +2363,69 @@ struct Router2
                     log_error("Failed to open wiretype heatmap %s for writing.\n", filename.c_str());
                 write_wiretype_heatmap(cong_map);
                 log_info("        wrote wiretype heatmap to %s.\n", filename.c_str());
+                std::string tile_filename(cfg.heatmap + "_tiles_" + std::to_string(iter) + ".csv");
+                std::ofstream tile_map(tile_filename);
+                if (!tile_map)
+                    log_error("Failed to open tile heatmap %s for writing.\n", tile_filename.c_str());
+                write_tile_heatmap(tile_map);
+                log_info("        wrote tile heatmap to %s.\n", tile_filename.c_str());
             }
             int tmgfail = 0;
             if (timing_driven)
                 tmg.run(false);
             if (timing_driven_ripup && iter < 500) {
+                delay_t worst_slack = std::numeric_limits<delay_t>::max();
+                std::vector<size_t> slack_failed;
                 for (size_t i = 0; i < nets_by_udata.size(); i++) {
                     NetInfo *ni = nets_by_udata.at(i);
                     for (size_t j = 0; j < ni->users.size(); j++) {
+                        worst_slack = std::min(worst_slack, tmg.get_setup_slack(ni, j));
                         if (arc_failed_slack(ni, j)) {
-                            failed_nets.insert(i);
+                            slack_failed.push_back(i);
                             ++tmgfail;
                         }
                     }
                 }
+                // Convergence monitor: when congestion is solved and only
+                // timing rip-up is keeping the loop alive, stop once the
+                // worst slack has effectively plateaued rather than paying
+                // many more iterations for the last fraction of a
+                // nanosecond. Inputs are iteration counts and slack values
+                // only - never wall clock - so the exit point is
+                // deterministic
+                bool converged = false;
+                if (tmgfail > 0 && overused_wires == 0 && cfg.convergence_window > 0) {
+                    slack_history.push_back(worst_slack);
+                    if (int(slack_history.size()) > cfg.convergence_window) {
+                        delay_t gain =
+                                worst_slack - slack_history.at(slack_history.size() - 1 - cfg.convergence_window);
+                        if (ctx->getDelayNS(gain) < cfg.convergence_slack_ns) {
+                            log_info("    timing converged: worst slack %.02fns improved %.03fns over last %d iters; "
+                                     "stopping timing-driven rip-up\n",
+                                     ctx->getDelayNS(worst_slack), ctx->getDelayNS(gain), cfg.convergence_window);
+                            timing_driven_ripup = false;
+                            tmgfail = 0;
+                            converged = true;
+                        }
+                    }
+                } else {
+                    slack_history.clear();
+                }
+                if (!converged)
+                    for (auto i : slack_failed)
+                        failed_nets.insert(i);
+            }
+            // Also surface when congestion itself has stopped decaying, so
+            // stuck runs are visible in the log without digging through the
+            // per-iteration counters
+            if (cfg.convergence_window > 0 && overused_wires > 0) {
+                overuse_history.push_back(total_overuse);
+                if (int(overuse_history.size()) > cfg.convergence_window) {
+                    int prev = overuse_history.at(overuse_history.size() - 1 - cfg.convergence_window);
+                    if (total_overuse * 100 > prev * 99)
+                        log_info("    convergence: overuse %d -> %d over last %d iters (<1%% decay)\n", prev,
+                                 total_overuse, cfg.convergence_window);
+                }
             }
             if (overused_wires == 0 && tmgfail == 0) {
                 // Try and actually bind nextpnr Arch API wires
@@ -1430,6 +2433,19 @@ struct Router2
             }
             for (auto cn : failed_nets)
                 route_queue.push_back(cn);
+            // Scale the worker cap for the next iteration to the work that
+            // can actually use it: the fraction of the last queue that routed
+            // in parallel, applied to the new queue, at ~250 nets per worker.
+            // All inputs are deterministic net counts (never wall-clock), so
+            // results stay reproducible for a given seed and --threads
+            if (int(route_queue.size()) < 200) {
+                worker_limit = 1;
+            } else {
+                float parallel_frac =
+                        (last_total_nets > 0) ? 1.0f - float(last_serial_nets) / float(last_total_nets) : 1.0f;
+                int useful = int(route_queue.size() * parallel_frac) / 250;
+                worker_limit = std::max(1, std::min(ThreadPool::get().num_workers(), useful));
+            }
             if (timing_driven_ripup)
                 log_info("    iter=%d wires=%d overused=%d overuse=%d tmgfail=%d archfail=%s\n", iter, total_wire_use,
                          overused_wires, total_overuse, tmgfail,
@@ -1438,10 +2454,30 @@ struct Router2
                 log_info("    iter=%d wires=%d overused=%d overuse=%d archfail=%s\n", iter, total_wire_use,
                          overused_wires, total_overuse,
                          (overused_wires > 0 || tmgfail > 0) ? "NA" : std::to_string(arch_fail).c_str());
+            if (telemetry_enabled(ctx)) {
+                std::vector<std::pair<const char *, double>> fields = {{"iter", double(iter)},
+                                                                       {"wires", double(total_wire_use)},
+                                                                       {"overused", double(overused_wires)},
+                                                                       {"overuse", double(total_overuse)}};
+                if (timing_driven) {
+                    delay_t worst = std::numeric_limits<delay_t>::max();
+                    for (auto ni : nets_by_udata)
+                        for (size_t j = 0; j < ni->users.size(); j++)
+                            worst = std::min(worst, tmg.get_setup_slack(ni, j));
+                    if (worst != std::numeric_limits<delay_t>::max())
+                        fields.emplace_back("worst_slack_ns", double(ctx->getDelayNS(worst)));
+                }
+                telemetry_record(ctx, "router2", fields);
+            }
             ++iter;
             if (curr_cong_weight < 1e9)
                 curr_cong_weight += cfg.curr_cong_mult;
-        } while (!failed_nets.empty());
+        }
+        return !failed_nets.empty();
+    }
+
+    void end_routing()
+    {
         if (cfg.perf_profile) {
             std::vector<std::pair<int, IdString>> nets_by_runtime;
             for (auto &n : nets_by_udata) {
@@ -1457,13 +2493,95 @@ struct Router2
         }
         auto rend = std::chrono::high_resolution_clock::now();
         log_info("Router2 time %.02fs\n", std::chrono::duration<float>(rend - rstart).count());
+        log_info("Design fingerprint: 0x%08x\n", ctx->fingerprint());
 
         log_info("Running router1 to check that route is legal...\n");
 
-        lock.unlock_early();
+        lock->unlock_early();
 
         router1(ctx, Router1Cfg(ctx));
     }
+
+    void operator()()
+    {
+        begin_routing();
+        while (route_iteration())
+            ;
+        end_routing();
+    }
+
+    // Estimate-only mode for parameter-sweep flows: instead of maze
+    // routing, build a per-tile routing supply/demand picture from the
+    // same per-net setup the real router uses and report how much of the
+    // grid looks overcommitted. Supply counts the wires in each tile;
+    // each net spreads a demand of its half-perimeter wirelength plus one
+    // unit per sink across its bounding box. Supply includes non-routing
+    // wires too, so the utilisation figures are a relative score for
+    // comparing sweep points on the same device, not an absolute
+    // wire-count prediction
+    void estimate()
+    {
+        log_info("Running router2 congestion estimator...\n");
+        auto rstart = std::chrono::high_resolution_clock::now();
+        setup_nets();
+        setup_wires();
+        int width = std::max(1, ctx->getGridDimX()), height = std::max(1, ctx->getGridDimY());
+        std::vector<double> supply(size_t(width) * height, 0.0), demand(size_t(width) * height, 0.0);
+        for (auto &pwd : flat_wires) {
+            int x = std::max(0, std::min(int(pwd.x), width - 1));
+            int y = std::max(0, std::min(int(pwd.y), height - 1));
+            supply.at(size_t(y) * width + x) += 1.0;
+        }
+        for (size_t i = 0; i < nets.size(); i++) {
+            auto &nd = nets.at(i);
+            NetInfo *ni = nets_by_udata.at(i);
+            if (nd.fixed_routing || ni->driver.cell == nullptr)
+                continue;
+            if (nd.bb.x0 > nd.bb.x1 || nd.bb.y0 > nd.bb.y1)
+                continue;
+            int x0 = std::max(0, std::min(nd.bb.x0, width - 1)), x1 = std::max(0, std::min(nd.bb.x1, width - 1));
+            int y0 = std::max(0, std::min(nd.bb.y0, height - 1)), y1 = std::max(0, std::min(nd.bb.y1, height - 1));
+            double net_demand = double(nd.hpwl) + double(ni->users.size());
+            double per_tile = net_demand / (double(x1 - x0 + 1) * double(y1 - y0 + 1));
+            for (int y = y0; y <= y1; y++)
+                for (int x = x0; x <= x1; x++)
+                    demand.at(size_t(y) * width + x) += per_tile;
+        }
+        double total_supply = 0, total_demand = 0, worst_util = 0;
+        int active_tiles = 0, hot_tiles = 0;
+        for (size_t t = 0; t < supply.size(); t++) {
+            total_supply += supply.at(t);
+            total_demand += demand.at(t);
+            if (supply.at(t) == 0)
+                continue;
+            ++active_tiles;
+            double util = demand.at(t) / supply.at(t);
+            worst_util = std::max(worst_util, util);
+            if (util > 1.0)
+                ++hot_tiles;
+        }
+        log_info("    estimated wire demand %.0f against supply %.0f over %d tiles\n", total_demand, total_supply,
+                 active_tiles);
+        log_info("    worst tile utilisation %.1f%%; %d tiles over 100%%\n", worst_util * 100.0, hot_tiles);
+        if (!cfg.heatmap.empty()) {
+            std::string filename(cfg.heatmap + "_estimate.csv");
+            std::ofstream est_map(filename);
+            if (!est_map)
+                log_error("Failed to open estimate heatmap %s for writing.\n", filename.c_str());
+            est_map << "x,y,supply,demand,util" << std::endl;
+            for (int y = 0; y < height; y++)
+                for (int x = 0; x < width; x++) {
+                    size_t tile = size_t(y) * width + x;
+                    if (supply.at(tile) == 0 && demand.at(tile) == 0)
+                        continue;
+                    est_map << x << "," << y << "," << supply.at(tile) << "," << demand.at(tile) << ","
+                            << (supply.at(tile) > 0 ? demand.at(tile) / supply.at(tile) : 0.0) << std::endl;
+                }
+            log_info("        wrote estimate heatmap to %s.\n", filename.c_str());
+        }
+        auto rend = std::chrono::high_resolution_clock::now();
+        log_info("Estimator time %.02fs\n", std::chrono::duration<float>(rend - rstart).count());
+    }
 };
 } // namespace
 
@@ -1474,6 +2592,69 @@ void router2(Context *ctx, const Router2Cfg &cfg)
     rt();
 }
 
+struct Router2State
+{
+    Router2State(Context *ctx, const Router2Cfg &cfg) : rt(ctx, cfg) { rt.ctx = ctx; }
+    Router2 rt;
+    bool begun = false, done = false, finished = false;
+};
+
+Router2Stepper::Router2Stepper(Context *ctx, const Router2Cfg &cfg) : state(new Router2State(ctx, cfg)) {}
+
+Router2Stepper::~Router2Stepper() {}
+
+bool Router2Stepper::step()
+{
+    if (state->finished || state->done)
+        return false;
+    if (!state->begun) {
+        state->rt.begin_routing();
+        state->begun = true;
+    }
+    if (!state->rt.route_iteration()) {
+        state->done = true;
+        return false;
+    }
+    return true;
+}
+
+void Router2Stepper::finish()
+{
+    if (state->finished)
+        return;
+    if (!state->begun) {
+        state->rt.begin_routing();
+        state->begun = true;
+    }
+    while (!state->done) {
+        if (!state->rt.route_iteration())
+            state->done = true;
+    }
+    state->rt.end_routing();
+    state->finished = true;
+}
+
+int Router2Stepper::iteration() const { return state->rt.iter - 1; }
+
+int Router2Stepper::overused_wires() const { return state->rt.overused_wires; }
+
+int Router2Stepper::total_overuse() const { return state->rt.total_overuse; }
+
+void Router2Stepper::write_tile_heatmap(const std::string &filename)
+{
+    std::ofstream tile_map(filename);
+    if (!tile_map)
+        log_error("Failed to open tile heatmap %s for writing.\n", filename.c_str());
+    state->rt.write_tile_heatmap(tile_map);
+}
+
+void router2_estimate(Context *ctx, const Router2Cfg &cfg)
+{
+    Router2 rt(ctx, cfg);
+    rt.ctx = ctx;
+    rt.estimate();
+}
+
 Router2Cfg::Router2Cfg(Context *ctx)
 {
     backwards_max_iter = ctx->setting<int>("router2/bwdMaxIter", 20);
@@ -1486,6 +2667,18 @@ Router2Cfg::Router2Cfg(Context *ctx)
     hist_cong_weight = ctx->setting<float>("router2/histCongWeight", 1.0f);
     curr_cong_mult = ctx->setting<float>("router2/currCongWeightMult", 2.0f);
     estimate_weight = ctx->setting<float>("router2/estimateWeight", 1.25f);
+    incremental_ripup = ctx->setting<bool>("router2/incrRipup", false);
+    fail_order_weight = ctx->setting<float>("router2/failOrderWeight", 0.1f);
+    corridor_width = ctx->setting<int>("router2/corridorWidth", 8);
+    corridor_thresh = ctx->setting<int>("router2/corridorThresh", 50);
+    fanout_share_thresh = ctx->setting<int>("router2/fanoutShareThresh", 16);
+    fanout_share_crit = ctx->setting<float>("router2/fanoutShareCrit", 0.8f);
+    use_lookahead = ctx->setting<bool>("router2/lookahead", false);
+    lookahead_sources = ctx->setting<int>("router2/lookaheadSources", 100);
+    lookahead_explore = ctx->setting<int>("router2/lookaheadExplore", 25000);
+    reserve_fanout_thresh = ctx->setting<int>("router2/reserveFanout", 128);
+    convergence_window = ctx->setting<int>("router2/convergenceWindow", 5);
+    convergence_slack_ns = ctx->setting<float>("router2/convergenceSlack", 0.01f);
     perf_profile = ctx->setting<bool>("router2/perfProfile", false);
     if (ctx->settings.count(ctx->id("router2/heatmap")))
         heatmap = ctx->settings.at(ctx->id("router2/heatmap")).as_string();
@@ -21,13 +21,6 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
-inline float default_base_cost(Context *ctx, WireId wire, PipId pip, float crit_weight)
-{
-    (void)crit_weight; // unused
-    return ctx->getDelayNS(ctx->getPipDelay(pip).maxDelay() + ctx->getWireDelay(wire).maxDelay() +
-                           ctx->getDelayEpsilon());
-}
-
 struct Router2Cfg
 {
     Router2Cfg(Context *ctx);
@@ -54,13 +47,103 @@ struct Router2Cfg
     // of choosing a less congestion/delay-optimal route
     float estimate_weight;
 
+    // In timing-driven rip-up mode, rip up only the arcs that failed slack
+    // rather than every arc of the net
+    bool incremental_ripup;
+
+    // Weight of a net's past congestion failures (relative to a criticality
+    // of 1.0) when ordering the route queue each iteration
+    float fail_order_weight;
+
+    // Corridor planning for long arcs: arcs whose bounding box half-perimeter
+    // is at least corridor_thresh tiles get a coarse tile-level path planned
+    // first (costed by the previous iteration's per-tile overuse), and
+    // detailed expansion is restricted to within corridor_width tiles of that
+    // path. 0 width disables. The search falls back to the full bounding box
+    // when the corridor proves too tight
+    int corridor_width;
+    int corridor_thresh;
+
+    // For nets with at least this many arcs to route, order non-critical
+    // sinks closest-to-driver first so the routing tree grows outward and
+    // later arcs share the trunk laid down by earlier ones
+    int fanout_share_thresh;
+    // Criticality above which an arc keeps its criticality-ordered slot
+    // instead of joining the tree-growth order
+    float fanout_share_crit;
+
+    // Build a distance-binned delay lookahead table by sampling the routing
+    // graph at startup, to tighten the A* estimate where the arch
+    // estimateDelay formula underestimates long-wire costs
+    bool use_lookahead;
+    // Approximate number of sample source wires, and the per-source
+    // exploration budget, for building the lookahead table
+    int lookahead_sources;
+    int lookahead_explore;
+
+    // Nets with at least this many users get the dedicated cone downhill of
+    // their driver reserved before the first iteration, keeping ordinary
+    // nets off resources a global will inevitably claim. 0 disables
+    int reserve_fanout_thresh;
+
+    // Convergence-based early exit: once congestion is solved and only
+    // timing-driven rip-up keeps the main loop iterating, stop when the
+    // worst slack has improved by less than convergence_slack_ns over the
+    // last convergence_window iterations. The same window is used to report
+    // overuse decay stalls. A window of 0 disables the monitor
+    int convergence_window;
+    float convergence_slack_ns;
+
     // Print additional performance profiling information
     bool perf_profile = false;
 
     std::string heatmap;
-    std::function<float(Context *ctx, WireId wire, PipId pip, float crit_weight)> get_base_cost = default_base_cost;
+    // Optional override for the base cost of reaching `wire` through `pip`.
+    // When unset the router reads a per-wire table precomputed at setup,
+    // equivalent to getDelayNS(getPipDelay(pip).maxDelay() +
+    // getWireDelay(wire).maxDelay() + getDelayEpsilon()), with no indirect
+    // call in the expansion loop. Install a hook only when the arch needs
+    // per-pip special cases; it is then invoked once per expansion
+    std::function<float(Context *ctx, WireId wire, PipId pip, float crit_weight)> get_base_cost;
 };
 
 void router2(Context *ctx, const Router2Cfg &cfg);
 
+// Iteration-granular driver around router2 for script-orchestrated flows
+// (surfaced as RouterStepper in the Python API): setup runs before the first
+// step, each step() routes one iteration of the main congestion loop, and
+// finish() drains any remaining iterations and runs the final router1
+// legality check. Scripts can inspect congestion between steps without
+// re-paying chipdb load or routing setup
+struct Router2State;
+
+struct Router2Stepper
+{
+    Router2Stepper(Context *ctx, const Router2Cfg &cfg);
+    ~Router2Stepper();
+
+    // Route one iteration; returns true while failed arcs remain. Once it
+    // has returned false the routing is complete and bound, and further
+    // calls are no-ops
+    bool step();
+    // Complete the route (if step() hasn't already) and run the router1
+    // legality check; idempotent
+    void finish();
+    // Number of completed iterations
+    int iteration() const;
+    // Congestion counters as of the last completed iteration
+    int overused_wires() const;
+    int total_overuse() const;
+    // Write the per-tile congestion CSV for the current state, in the same
+    // format as the --router2-heatmap tile files
+    void write_tile_heatmap(const std::string &filename);
+
+    std::unique_ptr<Router2State> state;
+};
+
+// Fast congestion/routability estimate for --estimate-only sweep flows:
+// reuses the router's net and wire setup to score per-tile wire demand
+// against supply without running detailed routing
+void router2_estimate(Context *ctx, const Router2Cfg &cfg);
+
 NEXTPNR_NAMESPACE_END
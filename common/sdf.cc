@@ -17,6 +17,7 @@
  *
  */
 
+#include <cstdio>
 #include "nextpnr.h"
 #include "util.h"
 
@@ -129,10 +130,15 @@ struct SDFWriter
 
     void write_delay(std::ostream &out, const MinMaxTyp &delay)
     {
+        // snprintf rather than ostream insertion: delay triples make up most
+        // of a large SDF and the stream number formatting machinery dominates
+        // the write time. %g matches the default ostream rendering of double
+        char buf[80];
         if (cvc_mode)
-            out << "(" << int(delay.min) << ":" << int(delay.typ) << ":" << int(delay.max) << ")";
+            snprintf(buf, sizeof(buf), "(%d:%d:%d)", int(delay.min), int(delay.typ), int(delay.max));
         else
-            out << "(" << delay.min << ":" << delay.typ << ":" << delay.max << ")";
+            snprintf(buf, sizeof(buf), "(%g:%g:%g)", delay.min, delay.typ, delay.max);
+        out << buf;
     }
 
     void write_port(std::ostream &out, const CellPort &port)
@@ -150,20 +156,22 @@ struct SDFWriter
 
     void write(std::ostream &out)
     {
-        out << "(DELAYFILE" << std::endl;
+        // '\n' rather than std::endl throughout: at gigabyte scale the
+        // per-line stream flush of endl costs more than the formatting
+        out << "(DELAYFILE" << "\n";
         // Headers and  metadata
-        out << "  (SDFVERSION " << format_name(sdfversion) << ")" << std::endl;
-        out << "  (DESIGN " << format_name(design) << ")" << std::endl;
-        out << "  (VENDOR " << format_name(vendor) << ")" << std::endl;
-        out << "  (PROGRAM " << format_name(program) << ")" << std::endl;
-        out << "  (DIVIDER " << (cvc_mode ? "." : "/") << ")" << std::endl;
-        out << "  (TIMESCALE 1ps)" << std::endl;
+        out << "  (SDFVERSION " << format_name(sdfversion) << ")" << "\n";
+        out << "  (DESIGN " << format_name(design) << ")" << "\n";
+        out << "  (VENDOR " << format_name(vendor) << ")" << "\n";
+        out << "  (PROGRAM " << format_name(program) << ")" << "\n";
+        out << "  (DIVIDER " << (cvc_mode ? "." : "/") << ")" << "\n";
+        out << "  (TIMESCALE 1ps)" << "\n";
         // Write interconnect delays, with the main design begin a "cell"
-        out << "  (CELL" << std::endl;
-        out << "    (CELLTYPE " << format_name(design) << ")" << std::endl;
-        out << "    (INSTANCE )" << std::endl;
-        out << "    (DELAY" << std::endl;
-        out << "      (ABSOLUTE" << std::endl;
+        out << "  (CELL" << "\n";
+        out << "    (CELLTYPE " << format_name(design) << ")" << "\n";
+        out << "    (INSTANCE )" << "\n";
+        out << "    (DELAY" << "\n";
+        out << "      (ABSOLUTE" << "\n";
         for (auto &ic : conn) {
             out << "        (INTERCONNECT ";
             write_port(out, ic.from);
@@ -171,31 +179,31 @@ struct SDFWriter
             write_port(out, ic.to);
             out << " ";
             write_delay(out, ic.delay);
-            out << ")" << std::endl;
+            out << ")" << "\n";
         }
-        out << "      )" << std::endl;
-        out << "    )" << std::endl;
-        out << "  )" << std::endl;
+        out << "      )" << "\n";
+        out << "    )" << "\n";
+        out << "  )" << "\n";
         // Write cells
         for (auto &cell : cells) {
-            out << "  (CELL" << std::endl;
-            out << "    (CELLTYPE " << format_name(cell.celltype) << ")" << std::endl;
-            out << "    (INSTANCE " << escape_name(cell.instance) << ")" << std::endl;
+            out << "  (CELL" << "\n";
+            out << "    (CELLTYPE " << format_name(cell.celltype) << ")" << "\n";
+            out << "    (INSTANCE " << escape_name(cell.instance) << ")" << "\n";
             // IOPATHs (combinational delay and clock-to-q)
             if (!cell.iopaths.empty()) {
-                out << "    (DELAY" << std::endl;
-                out << "      (ABSOLUTE" << std::endl;
+                out << "    (DELAY" << "\n";
+                out << "      (ABSOLUTE" << "\n";
                 for (auto &path : cell.iopaths) {
                     out << "        (IOPATH " << escape_name(path.from) << " " << escape_name(path.to) << " ";
                     write_delay(out, path.delay);
-                    out << ")" << std::endl;
+                    out << ")" << "\n";
                 }
-                out << "      )" << std::endl;
-                out << "    )" << std::endl;
+                out << "      )" << "\n";
+                out << "    )" << "\n";
             }
             // Timing Checks (setup/hold, period, width)
             if (!cell.checks.empty()) {
-                out << "    (TIMINGCHECK" << std::endl;
+                out << "    (TIMINGCHECK" << "\n";
                 for (auto &check : cell.checks) {
                     out << "      (" << timing_check_name(check.type) << " ";
                     write_portedge(out, check.from);
@@ -208,13 +216,13 @@ struct SDFWriter
                         write_delay(out, check.delay);
                     else
                         write_delay(out, check.delay.rise);
-                    out << ")" << std::endl;
+                    out << ")" << "\n";
                 }
-                out << "    )" << std::endl;
+                out << "    )" << "\n";
             }
-            out << "    )" << std::endl;
+            out << "    )" << "\n";
         }
-        out << ")" << std::endl;
+        out << ")" << "\n";
     }
 };
 
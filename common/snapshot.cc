@@ -0,0 +1,53 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "snapshot.h"
+
+#include <sstream>
+
+#include "binary_frontend.h"
+#include "checkpoint.h"
+#include "log.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// A snapshot is a binary netlist followed immediately by a checkpoint; both
+// formats embed their own counts so the checkpoint reader picks up exactly
+// where the netlist parser stopped
+FrozenSnapshot freeze_context(Context *ctx)
+{
+    std::ostringstream out(std::ios::binary);
+    if (!write_binary_netlist(out, "<snapshot>", ctx) || !write_checkpoint(out, "<snapshot>", ctx)) {
+        log_warning("failed to freeze design snapshot\n");
+        return FrozenSnapshot{};
+    }
+    return FrozenSnapshot{std::make_shared<const std::string>(out.str())};
+}
+
+bool thaw_snapshot(const FrozenSnapshot &snapshot, Context *ctx)
+{
+    if (!snapshot.valid())
+        return false;
+    std::istringstream in(*snapshot.data, std::ios::binary);
+    if (!parse_binary_netlist(in, "<snapshot>", ctx))
+        return false;
+    return read_checkpoint(in, "<snapshot>", ctx);
+}
+
+NEXTPNR_NAMESPACE_END
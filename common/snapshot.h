@@ -0,0 +1,59 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <memory>
+#include <string>
+
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Immutable capture of the design for concurrent analysis. The netlist
+// structures are full of raw cross-pointers (ports into cells, users into
+// nets), so there is no way to hand a running analysis thread a view of the
+// live Context while a pass keeps mutating it. Instead freeze_context()
+// serialises the design (netlist plus current placement and routing) to an
+// in-memory buffer using the binary netlist and checkpoint formats; the
+// mutator only pauses for the serialisation, then both sides go their own
+// way: the pass resumes mutating the live Context and any number of
+// analysis threads thaw the buffer into private Contexts they own outright,
+// with no locking against the mutator at all. The buffer is refcounted, so
+// a snapshot can be copied to several threads and dies with its last reader.
+struct FrozenSnapshot
+{
+    std::shared_ptr<const std::string> data;
+    bool valid() const { return bool(data); }
+};
+
+// Serialise the current design into a snapshot; returns an invalid snapshot
+// (and logs a warning) if serialisation fails. Must be called from the
+// thread that owns the Context, with no pass mutating it concurrently.
+FrozenSnapshot freeze_context(Context *ctx);
+
+// Deserialise a snapshot into ctx, which must be a freshly constructed
+// Context for the same architecture and device as the frozen one. Safe to
+// call from any thread; the snapshot itself is never modified.
+bool thaw_snapshot(const FrozenSnapshot &snapshot, Context *ctx);
+
+NEXTPNR_NAMESPACE_END
+
+#endif /* SNAPSHOT_H */
@@ -0,0 +1,75 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "telemetry.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#include "context.h"
+#include "log.h"
+#include "util.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// One telemetry stream per process, following the log.cc globals: the sink
+// outlives any particular pass and a flow only ever runs one design
+namespace {
+std::ofstream telemetry_file;
+bool telemetry_tried = false;
+std::chrono::steady_clock::time_point telemetry_start;
+} // namespace
+
+static bool telemetry_open(const Context *ctx)
+{
+    if (!telemetry_tried) {
+        telemetry_tried = true;
+        std::string filename = str_or_default(ctx->settings, ctx->id("telemetry"), "");
+        if (!filename.empty()) {
+            telemetry_file.open(filename, std::ios::out | std::ios::trunc);
+            if (!telemetry_file)
+                log_warning("failed to open telemetry file '%s' for writing\n", filename.c_str());
+            telemetry_start = std::chrono::steady_clock::now();
+        }
+    }
+    return telemetry_file.is_open();
+}
+
+bool telemetry_enabled(const Context *ctx) { return telemetry_open(ctx); }
+
+void telemetry_record(const Context *ctx, const char *phase,
+                      const std::vector<std::pair<const char *, double>> &fields)
+{
+    if (!telemetry_open(ctx))
+        return;
+    char buf[64];
+    float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - telemetry_start).count();
+    std::snprintf(buf, sizeof(buf), "%.2f", elapsed);
+    telemetry_file << "{\"phase\":\"" << phase << "\",\"t\":" << buf;
+    for (auto &field : fields) {
+        std::snprintf(buf, sizeof(buf), "%.10g", field.second);
+        telemetry_file << ",\"" << field.first << "\":" << buf;
+    }
+    // One flushed line per record so tail -f sees whole records promptly;
+    // at one record per pass iteration the flush cost is noise
+    telemetry_file << "}" << std::endl;
+}
+
+NEXTPNR_NAMESPACE_END
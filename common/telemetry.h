@@ -0,0 +1,48 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+struct Context;
+
+// Lightweight per-iteration flow telemetry for headless monitoring, enabled
+// with --telemetry <file>: passes append one JSON record per line with the
+// statistics they already compute (placer temperature/costs, router overuse,
+// worst slack), so a stuck farm run can be watched with tail -f instead of
+// attaching a debugger. Records carry the phase name, elapsed seconds and
+// the given numeric fields; everything is a no-op when the option is unset
+
+// Cheap check for gating any extra work a pass only does for telemetry
+bool telemetry_enabled(const Context *ctx);
+
+void telemetry_record(const Context *ctx, const char *phase,
+                      const std::vector<std::pair<const char *, double>> &fields);
+
+NEXTPNR_NAMESPACE_END
+
+#endif
@@ -0,0 +1,185 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "threadpool.h"
+
+#include <algorithm>
+
+#if defined(__linux__) && !defined(NPNR_DISABLE_THREADS)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "log.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+int configured_threads = 0;
+bool configured_pinning = false;
+bool pool_created = false;
+} // namespace
+
+ThreadPool &ThreadPool::get()
+{
+    static ThreadPool pool(configured_threads);
+    pool_created = true;
+    return pool;
+}
+
+void ThreadPool::configure(int n_threads)
+{
+    if (pool_created) {
+        log_warning("thread count can only be set before the thread pool is first used; ignoring\n");
+        return;
+    }
+    configured_threads = n_threads;
+}
+
+void ThreadPool::configure_pinning(bool pin)
+{
+    if (pool_created) {
+        log_warning("thread pinning can only be set before the thread pool is first used; ignoring\n");
+        return;
+    }
+#if defined(__linux__) || defined(NPNR_DISABLE_THREADS)
+    configured_pinning = pin;
+#else
+    if (pin)
+        log_warning("thread pinning is only supported on Linux; ignoring\n");
+#endif
+}
+
+ThreadPool::ThreadPool(int n_threads)
+{
+#ifdef NPNR_DISABLE_THREADS
+    num_workers_ = 1;
+#else
+    if (n_threads <= 0)
+        n_threads = std::max<int>(1, int(boost::thread::hardware_concurrency()));
+    num_workers_ = n_threads;
+    if (num_workers_ > 1) {
+        threads_.reserve(num_workers_);
+        for (int i = 0; i < num_workers_; i++)
+            threads_.emplace_back([this, i]() { worker_main(i); });
+#if defined(__linux__)
+        if (configured_pinning) {
+            // Round-robin over the online CPUs; worker i always lands on the
+            // same CPU so pinning never changes which worker runs which chunk,
+            // only where that worker's pages and cache lines live
+            int n_cpus = std::max<int>(1, int(boost::thread::hardware_concurrency()));
+            for (int i = 0; i < int(threads_.size()); i++) {
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+                CPU_SET(i % n_cpus, &cpus);
+                if (pthread_setaffinity_np(threads_.at(i).native_handle(), sizeof(cpu_set_t), &cpus) != 0)
+                    log_warning("failed to pin worker thread %d\n", i);
+            }
+        }
+#endif
+    }
+#endif
+}
+
+ThreadPool::~ThreadPool()
+{
+#ifndef NPNR_DISABLE_THREADS
+    {
+        std::unique_lock<std::mutex> lk(mutex_);
+        shutdown_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &t : threads_)
+        t.join();
+#endif
+}
+
+#ifndef NPNR_DISABLE_THREADS
+void ThreadPool::worker_main(int index)
+{
+    uint64_t last_generation = 0;
+    while (true) {
+        const std::function<void(int)> *job;
+        {
+            std::unique_lock<std::mutex> lk(mutex_);
+            start_cv_.wait(lk, [&]() { return shutdown_ || generation_ != last_generation; });
+            if (shutdown_)
+                return;
+            last_generation = generation_;
+            if (index >= active_)
+                continue; // not part of this job; running_ doesn't count us
+            job = job_;
+        }
+        (*job)(index);
+        {
+            std::unique_lock<std::mutex> lk(mutex_);
+            if (--running_ == 0)
+                done_cv_.notify_all();
+        }
+    }
+}
+#endif
+
+void ThreadPool::execute(const std::function<void(int)> &fn) { execute(fn, num_workers_); }
+
+void ThreadPool::execute(const std::function<void(int)> &fn, int n_active)
+{
+#ifndef NPNR_DISABLE_THREADS
+    n_active = std::max(1, std::min(n_active, num_workers_));
+    if (num_workers_ > 1 && n_active > 1) {
+        {
+            std::unique_lock<std::mutex> lk(mutex_);
+            job_ = &fn;
+            active_ = n_active;
+            running_ = n_active;
+            generation_++;
+        }
+        start_cv_.notify_all();
+        std::unique_lock<std::mutex> lk(mutex_);
+        done_cv_.wait(lk, [&]() { return running_ == 0; });
+        return;
+    }
+#endif
+    fn(0);
+}
+
+void ThreadPool::run_chunks(size_t count, size_t chunk_size, const std::function<void(size_t, size_t)> &fn,
+                            int max_workers)
+{
+    NPNR_ASSERT(chunk_size > 0);
+    if (count == 0)
+        return;
+    int workers = num_workers_;
+    if (max_workers > 0)
+        workers = std::min(workers, max_workers);
+    if (workers == 1 || count <= chunk_size) {
+        fn(0, count);
+        return;
+    }
+    std::atomic<size_t> cursor(0);
+    execute(
+            [&](int) {
+                size_t begin;
+                while ((begin = cursor.fetch_add(chunk_size)) < count)
+                    fn(begin, std::min(begin + chunk_size, count));
+            },
+            workers);
+}
+
+NEXTPNR_NAMESPACE_END
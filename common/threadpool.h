@@ -0,0 +1,147 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#ifndef NPNR_DISABLE_THREADS
+#include <boost/thread.hpp>
+#endif
+
+#include "deterministic_rng.h"
+#include "nextpnr_assertions.h"
+#include "nextpnr_namespaces.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Shared pool of worker threads for the parallel placer, router and timing
+// passes. The pool is created once, on first use, with the thread count
+// from --threads (defaulting to the hardware concurrency), so passes no
+// longer spawn and join their own threads; the helpers below encode the
+// patterns that keep parallel results deterministic: chunked loops that
+// only write state owned by their items, reductions combined in a fixed
+// order, and RNGs forked per chunk rather than per thread
+class ThreadPool
+{
+  public:
+    // Returns the global pool, creating it on first call
+    static ThreadPool &get();
+    // Sets the number of threads the pool will be created with; must be
+    // called before the first get(). Zero or less means one thread per
+    // hardware core
+    static void configure(int n_threads);
+    // Requests that workers be pinned round-robin to CPUs, like configure
+    // only honoured before the first get(). On multi-socket machines this
+    // stops the scheduler migrating a worker away from the memory node
+    // holding its scratch state, which the worker first-touched and so the
+    // OS placed locally. Only implemented on Linux; elsewhere the request
+    // is ignored with a warning
+    static void configure_pinning(bool pin);
+
+    int num_workers() const { return num_workers_; }
+
+    // Run fn(worker) once on every worker and wait for all of them to
+    // finish; the calling thread sleeps in the meantime. With a
+    // single-worker pool fn(0) runs inline. The second form runs the job on
+    // the first n_active workers only, for callers that have measured that
+    // their current workload cannot feed the whole pool
+    void execute(const std::function<void(int)> &fn);
+    void execute(const std::function<void(int)> &fn, int n_active);
+
+    // Chunked parallel loop over [0, count): idle workers claim the next
+    // chunk of chunk_size items from a shared cursor. fn must only write
+    // state owned by the items it is given; under that condition results
+    // cannot depend on which worker runs which chunk. max_workers caps the
+    // number of participating workers (0 means the whole pool); with a cap
+    // of one the loop runs inline on the calling thread
+    void run_chunks(size_t count, size_t chunk_size, const std::function<void(size_t, size_t)> &fn,
+                    int max_workers = 0);
+
+    // Ordered parallel reduction: map_fn(begin, end) produces one partial
+    // result per chunk, and the partials are combined in ascending chunk
+    // order on the calling thread. Non-commutative combines (float sums,
+    // min/max with tie-breaks) therefore give bit-identical results
+    // regardless of scheduling or thread count
+    template <typename T, typename MapFn, typename CombineFn>
+    T reduce_chunks(size_t count, size_t chunk_size, T init, const MapFn &map_fn, const CombineFn &combine_fn)
+    {
+        NPNR_ASSERT(chunk_size > 0);
+        size_t n_chunks = (count + chunk_size - 1) / chunk_size;
+        std::vector<T> partials(n_chunks, init);
+        run_chunks(n_chunks, 1, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; chunk++)
+                partials.at(chunk) = map_fn(chunk * chunk_size, std::min(count, (chunk + 1) * chunk_size));
+        });
+        T result = std::move(init);
+        for (auto &partial : partials)
+            result = combine_fn(std::move(result), std::move(partial));
+        return result;
+    }
+
+    // As run_chunks, but each chunk receives its own RNG forked
+    // deterministically from the parent state and the chunk index, so
+    // random decisions depend only on which chunk an item is in, never on
+    // thread interleaving or the worker count. The parent RNG is stepped
+    // once so successive calls fork differently
+    template <typename Fn> void run_chunks_rng(size_t count, size_t chunk_size, DeterministicRNG &rng, const Fn &fn)
+    {
+        NPNR_ASSERT(chunk_size > 0);
+        uint64_t base = rng.rng64();
+        size_t n_chunks = (count + chunk_size - 1) / chunk_size;
+        run_chunks(n_chunks, 1, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; chunk++) {
+                DeterministicRNG chunk_rng;
+                chunk_rng.rngseed(base + uint64_t(chunk) * 0x9E3779B97F4A7C15);
+                fn(chunk * chunk_size, std::min(count, (chunk + 1) * chunk_size), chunk_rng);
+            }
+        });
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+  private:
+    explicit ThreadPool(int n_threads);
+    ~ThreadPool();
+
+    int num_workers_;
+#ifndef NPNR_DISABLE_THREADS
+    void worker_main(int index);
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_, done_cv_;
+    const std::function<void(int)> *job_ = nullptr;
+    uint64_t generation_ = 0;
+    // workers with an index at or above this sit the current job out
+    int active_ = 0;
+    int running_ = 0;
+    bool shutdown_ = false;
+    std::vector<boost::thread> threads_;
+#endif
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
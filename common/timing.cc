@@ -20,11 +20,14 @@
 
 #include "timing.h"
 #include <algorithm>
+#include <atomic>
 #include <boost/range/adaptor/reversed.hpp>
+#include <cstdlib>
 #include <deque>
 #include <map>
 #include <utility>
 #include "log.h"
+#include "threadpool.h"
 #include "util.h"
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -34,19 +37,78 @@ void TimingAnalyser::setup()
     init_ports();
     get_cell_delays();
     topo_sort();
+    build_levels();
     setup_port_domains();
+    // Assign dense arc indices for the flat annotation arrays, one entry
+    // per net user
+    int32_t arc_base = 0;
+    for (auto &net : ctx->nets) {
+        NetInfo *ni = net.second.get();
+        ni->tmg_arc_base = arc_base;
+        arc_base += int32_t(ni->users.size());
+    }
+    arc_criticality.assign(arc_base, 0.0f);
+    arc_setup_slack.assign(arc_base, std::numeric_limits<delay_t>::max());
+    arcs_annotated = false;
+    // The graph itself changed; previous results are meaningless
+    times_dirty = true;
     run();
 }
 
 void TimingAnalyser::run(bool update_route_delays)
 {
-    reset_times();
     if (update_route_delays)
         get_route_delays();
+    // Incremental short-circuit: if no route delay changed since the last
+    // run, the whole timing graph is unchanged and the previous results
+    // still hold
+    if (!times_dirty)
+        return;
+    reset_times();
     walk_forward();
     walk_backward();
     compute_slack();
     compute_criticality();
+    refresh_arc_annotations();
+    times_dirty = false;
+}
+
+void TimingAnalyser::refresh_arc_annotations()
+{
+    const bool damped = damped_criticality && arcs_annotated;
+    const delay_t epsilon = ctx->getDelayEpsilon();
+    // Weight of the previous criticality in the exponential-decay blend
+    const float damping = 0.5f;
+    for (auto &net : ctx->nets) {
+        NetInfo *ni = net.second.get();
+        // nets created after setup() have no arc indices until the next
+        // setup(); their users keep going through the CellPortKey getters
+        if (ni->tmg_arc_base < 0)
+            continue;
+        for (size_t i = 0; i < ni->users.size(); i++) {
+            size_t idx = ni->tmg_arc_base + i;
+            auto fnd = ports.find(CellPortKey(ni->users.at(i)));
+            if (fnd == ports.end()) {
+                arc_criticality.at(idx) = 0.0f;
+                arc_setup_slack.at(idx) = std::numeric_limits<delay_t>::max();
+                continue;
+            }
+            delay_t new_slack = fnd->second.worst_setup_slack;
+            if (damped) {
+                delay_t old_slack = arc_setup_slack.at(idx);
+                // slack unchanged within the arch delay resolution: keep the
+                // previous annotation untouched
+                if (old_slack != std::numeric_limits<delay_t>::max() && std::abs(new_slack - old_slack) <= epsilon)
+                    continue;
+                arc_criticality.at(idx) =
+                        damping * arc_criticality.at(idx) + (1.0f - damping) * fnd->second.worst_crit;
+            } else {
+                arc_criticality.at(idx) = fnd->second.worst_crit;
+            }
+            arc_setup_slack.at(idx) = new_slack;
+        }
+    }
+    arcs_annotated = true;
 }
 
 void TimingAnalyser::init_ports()
@@ -72,21 +134,69 @@ void TimingAnalyser::init_ports()
 
 void TimingAnalyser::get_cell_delays()
 {
+    // Cell delay queries are independent and the arch getters are read-only,
+    // so for large designs the ports are processed by the shared worker
+    // pool, each chunk appending to its own arc buffer; the buffers are
+    // merged into the arena in chunk order afterwards, so the final layout
+    // matches the serial path
+    constexpr size_t chunk_size = 512;
+    if (ports.size() >= 10000 && ThreadPool::get().num_workers() > 1) {
+        std::vector<std::pair<const CellPortKey *, PerPort *>> flat_ports;
+        flat_ports.reserve(ports.size());
+        for (auto &port : ports)
+            flat_ports.emplace_back(&port.first, &port.second);
+        size_t n_chunks = (flat_ports.size() + chunk_size - 1) / chunk_size;
+        std::vector<std::vector<CellArc>> chunk_arcs(n_chunks);
+        ThreadPool::get().run_chunks(flat_ports.size(), chunk_size, [&](size_t begin, size_t end) {
+            auto &arcs = chunk_arcs.at(begin / chunk_size);
+            for (size_t j = begin; j < end; j++) {
+                size_t before = arcs.size();
+                PerPort &pd = *flat_ports.at(j).second;
+                get_port_cell_delays(*flat_ports.at(j).first, pd, arcs);
+                // chunk-local offset; rebased once the chunk's position in
+                // the arena is known
+                pd.arc_begin = int32_t(before);
+                pd.arc_count = int32_t(arcs.size() - before);
+            }
+        });
+        size_t total = 0;
+        for (auto &arcs : chunk_arcs)
+            total += arcs.size();
+        arc_storage.clear();
+        arc_storage.reserve(total);
+        for (size_t c = 0; c < n_chunks; c++) {
+            int32_t base = int32_t(arc_storage.size());
+            size_t port_end = std::min(flat_ports.size(), (c + 1) * chunk_size);
+            for (size_t j = c * chunk_size; j < port_end; j++)
+                flat_ports.at(j).second->arc_begin += base;
+            arc_storage.insert(arc_storage.end(), chunk_arcs.at(c).begin(), chunk_arcs.at(c).end());
+        }
+        return;
+    }
+    arc_storage.clear();
     for (auto &port : ports) {
-        CellInfo *ci = cell_info(port.first);
-        auto &pi = port_info(port.first);
-        auto &pd = port.second;
+        size_t before = arc_storage.size();
+        get_port_cell_delays(port.first, port.second, arc_storage);
+        port.second.arc_begin = int32_t(before);
+        port.second.arc_count = int32_t(arc_storage.size() - before);
+    }
+}
 
-        IdString name = port.first.port;
+void TimingAnalyser::get_port_cell_delays(const CellPortKey &key, PerPort &pd, std::vector<CellArc> &out)
+{
+    {
+        CellInfo *ci = cell_info(key);
+        auto &pi = port_info(key);
+
+        IdString name = key.port;
         // Ignore dangling ports altogether for timing purposes
         if (pd.net_port.net == IdString())
-            continue;
-        pd.cell_arcs.clear();
+            return;
         int clkInfoCount = 0;
         TimingPortClass cls = ctx->getPortTimingClass(ci, name, clkInfoCount);
         if (cls == TMG_STARTPOINT || cls == TMG_ENDPOINT || cls == TMG_CLOCK_INPUT || cls == TMG_GEN_CLOCK ||
             cls == TMG_IGNORE)
-            continue;
+            return;
         if (pi.type == PORT_IN) {
             // Input ports might have setup/hold relationships
             if (cls == TMG_REGISTER_INPUT) {
@@ -94,9 +204,9 @@ void TimingAnalyser::get_cell_delays()
                     auto info = ctx->getPortClockingInfo(ci, name, i);
                     if (!ci->ports.count(info.clock_port) || ci->ports.at(info.clock_port).net == nullptr)
                         continue;
-                    pd.cell_arcs.emplace_back(CellArc::SETUP, info.clock_port, DelayQuad(info.setup, info.setup),
+                    out.emplace_back(CellArc::SETUP, info.clock_port, DelayQuad(info.setup, info.setup),
                                               info.edge);
-                    pd.cell_arcs.emplace_back(CellArc::HOLD, info.clock_port, DelayQuad(info.hold, info.hold),
+                    out.emplace_back(CellArc::HOLD, info.clock_port, DelayQuad(info.hold, info.hold),
                                               info.edge);
                 }
             }
@@ -109,7 +219,7 @@ void TimingAnalyser::get_cell_delays()
                 DelayQuad delay;
                 bool is_path = ctx->getCellDelay(ci, name, other_port.first, delay);
                 if (is_path)
-                    pd.cell_arcs.emplace_back(CellArc::COMBINATIONAL, other_port.first, delay);
+                    out.emplace_back(CellArc::COMBINATIONAL, other_port.first, delay);
             }
         } else if (pi.type == PORT_OUT) {
             // Output ports might have clk-to-q relationships
@@ -118,7 +228,7 @@ void TimingAnalyser::get_cell_delays()
                     auto info = ctx->getPortClockingInfo(ci, name, i);
                     if (!ci->ports.count(info.clock_port) || ci->ports.at(info.clock_port).net == nullptr)
                         continue;
-                    pd.cell_arcs.emplace_back(CellArc::CLK_TO_Q, info.clock_port, info.clockToQ, info.edge);
+                    out.emplace_back(CellArc::CLK_TO_Q, info.clock_port, info.clockToQ, info.edge);
                 }
             }
             // Combinational delays through cell
@@ -130,7 +240,7 @@ void TimingAnalyser::get_cell_delays()
                 DelayQuad delay;
                 bool is_path = ctx->getCellDelay(ci, other_port.first, name, delay);
                 if (is_path)
-                    pd.cell_arcs.emplace_back(CellArc::COMBINATIONAL, other_port.first, delay);
+                    out.emplace_back(CellArc::COMBINATIONAL, other_port.first, delay);
             }
         }
     }
@@ -138,6 +248,42 @@ void TimingAnalyser::get_cell_delays()
 
 void TimingAnalyser::get_route_delays()
 {
+    // For large designs, compute the (independent, read-only) arc delays in
+    // parallel into per-chunk buffers, combined in chunk order, and do the
+    // stateful updates serially afterwards. The route delay cache is
+    // bypassed in this path as filling it is not thread safe; the
+    // parallelism more than makes up for it
+    if (ctx->nets.size() >= 5000 && ThreadPool::get().num_workers() > 1) {
+        std::vector<const NetInfo *> flat_nets;
+        flat_nets.reserve(ctx->nets.size());
+        for (auto &net : ctx->nets)
+            flat_nets.push_back(net.second.get());
+        typedef std::vector<std::pair<CellPortKey, delay_t>> DelayVec;
+        auto delays = ThreadPool::get().reduce_chunks(
+                flat_nets.size(), 64, DelayVec{},
+                [&](size_t begin, size_t end) {
+                    DelayVec result;
+                    for (size_t j = begin; j < end; j++) {
+                        const NetInfo *ni = flat_nets.at(j);
+                        if (ni->driver.cell == nullptr || ni->driver.cell->bel == BelId())
+                            continue;
+                        for (auto &usr : ni->users) {
+                            if (usr.cell->bel == BelId())
+                                continue;
+                            result.emplace_back(CellPortKey(usr),
+                                                ctx->getNetinfoRouteDelay(ni, usr, /*update_cache=*/false));
+                        }
+                    }
+                    return result;
+                },
+                [](DelayVec a, DelayVec b) {
+                    a.insert(a.end(), b.begin(), b.end());
+                    return a;
+                });
+        for (auto &delay : delays)
+            set_route_delay(delay.first, DelayPair(delay.second));
+        return;
+    }
     for (auto &net : ctx->nets) {
         NetInfo *ni = net.second.get();
         if (ni->driver.cell == nullptr || ni->driver.cell->bel == BelId())
@@ -145,12 +291,19 @@ void TimingAnalyser::get_route_delays()
         for (auto &usr : ni->users) {
             if (usr.cell->bel == BelId())
                 continue;
-            ports.at(CellPortKey(usr)).route_delay = DelayPair(ctx->getNetinfoRouteDelay(ni, usr));
+            set_route_delay(CellPortKey(usr), DelayPair(ctx->getNetinfoRouteDelay(ni, usr)));
         }
     }
 }
 
-void TimingAnalyser::set_route_delay(CellPortKey port, DelayPair value) { ports.at(port).route_delay = value; }
+void TimingAnalyser::set_route_delay(CellPortKey port, DelayPair value)
+{
+    auto &rd = ports.at(port).route_delay;
+    if (rd == value)
+        return;
+    rd = value;
+    times_dirty = true;
+}
 
 void TimingAnalyser::topo_sort()
 {
@@ -161,7 +314,7 @@ void TimingAnalyser::topo_sort()
         topo.node(port.first);
         if (pd.type == PORT_IN) {
             // inputs: combinational arcs through the cell are edges
-            for (auto &arc : pd.cell_arcs) {
+            for (auto &arc : cell_arcs(pd)) {
                 if (arc.type != CellArc::COMBINATIONAL)
                     continue;
                 topo.edge(port.first, CellPortKey(port.first.cell, arc.other_port));
@@ -191,6 +344,107 @@ void TimingAnalyser::topo_sort()
     std::swap(topological_order, topo.sorted);
 }
 
+void TimingAnalyser::build_levels()
+{
+    // Group ports into topological levels such that every propagation the
+    // walks perform crosses from a lower to a strictly higher level; all
+    // ports within one level can then be updated in parallel. The edge set
+    // is the union of the arcs used by the forward walk (input-port
+    // combinational arcs plus driver-to-user routing) and those used by the
+    // backward walk (output-port combinational arcs plus the same routing);
+    // the two arc sets differ for ports whose timing class suppresses arc
+    // creation. While here, the combinational arcs are transposed onto the
+    // ports that pull through them (see pull_arrival/pull_required)
+    level_order.clear();
+    have_levels = false;
+    // Assign every port a dense index (ports-dict insertion order, so
+    // deterministic); all adjacency used by the pull-based walks is then
+    // resolved to these indices once here, making the walks plain array
+    // sweeps with no key hashing
+    port_by_idx.clear();
+    port_by_idx.reserve(ports.size());
+    for (auto &port : ports) {
+        auto &pd = port.second;
+        pd.idx = int(port_by_idx.size());
+        port_by_idx.push_back(&pd);
+        pd.pull_fwd_arcs.clear();
+        pd.pull_bwd_arcs.clear();
+        pd.drv_idx = -1;
+        pd.user_idxs.clear();
+    }
+    std::vector<int> indegree(port_by_idx.size(), 0);
+    for (auto &port : ports) {
+        auto &pd = port.second;
+        if (pd.type == PORT_OUT) {
+            const NetInfo *pn = port_info(port.first).net;
+            if (pn != nullptr)
+                for (auto &usr : pn->users) {
+                    auto &usr_pd = ports.at(CellPortKey(usr));
+                    pd.user_idxs.push_back(usr_pd.idx);
+                    usr_pd.drv_idx = pd.idx;
+                    indegree.at(usr_pd.idx)++;
+                }
+            for (auto &fanin : cell_arcs(pd)) {
+                if (fanin.type != CellArc::COMBINATIONAL)
+                    continue;
+                CellPortKey src(port.first.cell, fanin.other_port);
+                ports.at(src).pull_bwd_arcs.emplace_back(pd.idx, fanin.value);
+                indegree.at(pd.idx)++;
+            }
+        } else if (pd.type == PORT_IN) {
+            for (auto &fanout : cell_arcs(pd)) {
+                if (fanout.type != CellArc::COMBINATIONAL)
+                    continue;
+                auto &dst_pd = ports.at(CellPortKey(port.first.cell, fanout.other_port));
+                dst_pd.pull_fwd_arcs.emplace_back(pd.idx, fanout.value);
+                indegree.at(dst_pd.idx)++;
+            }
+        }
+    }
+    // Kahn's algorithm over the indices, peeling off one level at a time. A
+    // fixed, ordered traversal keeps the level contents deterministic
+    std::vector<int> current, next;
+    for (int i = 0; i < int(port_by_idx.size()); i++)
+        if (indegree.at(i) == 0)
+            current.push_back(i);
+    size_t placed = 0;
+    while (!current.empty()) {
+        placed += current.size();
+        next.clear();
+        for (int i : current) {
+            auto &pd = *port_by_idx.at(i);
+            if (pd.type == PORT_OUT) {
+                for (int usr_idx : pd.user_idxs)
+                    if (--indegree.at(usr_idx) == 0)
+                        next.push_back(usr_idx);
+            } else if (pd.type == PORT_IN) {
+                // outgoing combinational edges: this port's own fanout arcs
+                // plus any fanin arcs the destination holds on us
+                for (auto &fanout : cell_arcs(pd)) {
+                    if (fanout.type != CellArc::COMBINATIONAL)
+                        continue;
+                    int dst_idx = ports.at(CellPortKey(pd.cell_port.cell, fanout.other_port)).idx;
+                    if (--indegree.at(dst_idx) == 0)
+                        next.push_back(dst_idx);
+                }
+                for (auto &fanout : pd.pull_bwd_arcs) {
+                    if (--indegree.at(fanout.other_idx) == 0)
+                        next.push_back(fanout.other_idx);
+                }
+            }
+        }
+        level_order.push_back(std::move(current));
+        current = std::move(next);
+        next.clear();
+    }
+    if (placed == ports.size()) {
+        have_levels = true;
+    } else {
+        // combinational loop somewhere; fall back to the in-order walks
+        level_order.clear();
+    }
+}
+
 void TimingAnalyser::setup_port_domains()
 {
     for (auto &d : domains) {
@@ -206,7 +460,7 @@ void TimingAnalyser::setup_port_domains()
             auto &pi = port_info(port);
             if (pi.type == PORT_OUT) {
                 if (first_iter) {
-                    for (auto &fanin : pd.cell_arcs) {
+                    for (auto &fanin : cell_arcs(pd)) {
                         if (fanin.type != CellArc::CLK_TO_Q)
                             continue;
                         // registered outputs are startpoints
@@ -222,7 +476,7 @@ void TimingAnalyser::setup_port_domains()
                         copy_domains(port, CellPortKey(usr), false);
             } else {
                 // copy domains from input to output
-                for (auto &fanout : pd.cell_arcs) {
+                for (auto &fanout : cell_arcs(pd)) {
                     if (fanout.type != CellArc::COMBINATIONAL)
                         continue;
                     copy_domains(port, CellPortKey(port.cell, fanout.other_port), false);
@@ -235,14 +489,14 @@ void TimingAnalyser::setup_port_domains()
             auto &pi = port_info(port);
             if (pi.type == PORT_OUT) {
                 // copy domains from output to input
-                for (auto &fanin : pd.cell_arcs) {
+                for (auto &fanin : cell_arcs(pd)) {
                     if (fanin.type != CellArc::COMBINATIONAL)
                         continue;
                     copy_domains(port, CellPortKey(port.cell, fanin.other_port), true);
                 }
             } else {
                 if (first_iter) {
-                    for (auto &fanout : pd.cell_arcs) {
+                    for (auto &fanout : cell_arcs(pd)) {
                         if (fanout.type != CellArc::SETUP)
                             continue;
                         // registered inputs are endpoints
@@ -291,7 +545,7 @@ void TimingAnalyser::setup_port_domains()
 void TimingAnalyser::reset_times()
 {
     for (auto &port : ports) {
-        auto do_reset = [&](dict<domain_id_t, ArrivReqTime> &times) {
+        auto do_reset = [&](FlatDomainMap<ArrivReqTime> &times) {
             for (auto &t : times) {
                 t.second.value = init_delay;
                 t.second.path_length = 0;
@@ -317,7 +571,19 @@ void TimingAnalyser::reset_times()
 void TimingAnalyser::set_arrival_time(CellPortKey target, domain_id_t domain, DelayPair arrival, int path_length,
                                       CellPortKey prev)
 {
-    auto &arr = ports.at(target).arrival.at(domain);
+    set_arrival_time(ports.at(target), domain, arrival, path_length, prev);
+}
+
+void TimingAnalyser::set_required_time(CellPortKey target, domain_id_t domain, DelayPair required, int path_length,
+                                       CellPortKey prev)
+{
+    set_required_time(ports.at(target), domain, required, path_length, prev);
+}
+
+void TimingAnalyser::set_arrival_time(PerPort &target, domain_id_t domain, DelayPair arrival, int path_length,
+                                      CellPortKey prev)
+{
+    auto &arr = target.arrival.at(domain);
     if (arrival.max_delay > arr.value.max_delay) {
         arr.value.max_delay = arrival.max_delay;
         arr.bwd_max = prev;
@@ -329,10 +595,10 @@ void TimingAnalyser::set_arrival_time(CellPortKey target, domain_id_t domain, De
     arr.path_length = std::max(arr.path_length, path_length);
 }
 
-void TimingAnalyser::set_required_time(CellPortKey target, domain_id_t domain, DelayPair required, int path_length,
+void TimingAnalyser::set_required_time(PerPort &target, domain_id_t domain, DelayPair required, int path_length,
                                        CellPortKey prev)
 {
-    auto &req = ports.at(target).required.at(domain);
+    auto &req = target.required.at(domain);
     if (required.min_delay < req.value.min_delay) {
         req.value.min_delay = required.min_delay;
         req.bwd_min = prev;
@@ -356,9 +622,9 @@ void TimingAnalyser::walk_forward()
             // TODO: clock routing delay, if analysis of that is enabled
             if (sp.second != IdString()) {
                 // clocked startpoints have a clock-to-out time
-                for (auto &fanin : pd.cell_arcs) {
+                for (auto &fanin : cell_arcs(pd)) {
                     if (fanin.type == CellArc::CLK_TO_Q && fanin.other_port == sp.second) {
-                        init_arrival = init_arrival + fanin.value.delayPair();
+                        init_arrival += fanin.value.delayPair();
                         break;
                     }
                 }
@@ -367,7 +633,15 @@ void TimingAnalyser::walk_forward()
             set_arrival_time(sp.first, dom_id, init_arrival, 1, clock_key);
         }
     }
-    // Walk forward in topological order
+    if (have_levels) {
+        // Pull-based propagation: each level's ports compute their own
+        // arrival times from already-final predecessors, so levels can be
+        // processed in parallel with results independent of thread count
+        for (auto &level : level_order)
+            process_level(level, /*backward=*/false);
+        return;
+    }
+    // Walk forward in topological order (fallback for combinational loops)
     for (auto p : topological_order) {
         auto &pd = ports.at(p);
         for (auto &arr : pd.arrival) {
@@ -383,7 +657,7 @@ void TimingAnalyser::walk_forward()
                     }
             } else if (pd.type == PORT_IN) {
                 // Input port; propagate delay through cell, adding combinational delay
-                for (auto &fanout : pd.cell_arcs) {
+                for (auto &fanout : cell_arcs(pd)) {
                     if (fanout.type != CellArc::COMBINATIONAL)
                         continue;
                     set_arrival_time(CellPortKey(p.cell, fanout.other_port), arr.first,
@@ -408,7 +682,7 @@ void TimingAnalyser::walk_backward()
             // TODO: clock routing delay, if analysis of that is enabled
             if (ep.second != IdString()) {
                 // Add setup/hold time, if this endpoint is clocked
-                for (auto &fanin : pd.cell_arcs) {
+                for (auto &fanin : cell_arcs(pd)) {
                     if (fanin.type == CellArc::SETUP && fanin.other_port == ep.second)
                         init_setuphold.min_delay -= fanin.value.maxDelay();
                     if (fanin.type == CellArc::HOLD && fanin.other_port == ep.second)
@@ -419,7 +693,14 @@ void TimingAnalyser::walk_backward()
             set_required_time(ep.first, dom_id, init_setuphold, 1, clock_key);
         }
     }
-    // Walk backwards in topological order
+    if (have_levels) {
+        // As for walk_forward, but pulling from successors level by level in
+        // descending order
+        for (auto it = level_order.rbegin(); it != level_order.rend(); ++it)
+            process_level(*it, /*backward=*/true);
+        return;
+    }
+    // Walk backwards in topological order (fallback for combinational loops)
     for (auto p : reversed_range(topological_order)) {
         auto &pd = ports.at(p);
         for (auto &req : pd.required) {
@@ -428,15 +709,15 @@ void TimingAnalyser::walk_backward()
                 NetInfo *net = port_info(p).net;
                 if (net != nullptr && net->driver.cell != nullptr)
                     set_required_time(CellPortKey(net->driver), req.first,
-                                      req.second.value - DelayPair(pd.route_delay.maxDelay()), req.second.path_length,
+                                      req.second.value - pd.route_delay.maxDelay(), req.second.path_length,
                                       p);
             } else if (pd.type == PORT_OUT) {
                 // Output port : propagate delay back through cell, subtracting combinational delay
-                for (auto &fanin : pd.cell_arcs) {
+                for (auto &fanin : cell_arcs(pd)) {
                     if (fanin.type != CellArc::COMBINATIONAL)
                         continue;
                     set_required_time(CellPortKey(p.cell, fanin.other_port), req.first,
-                                      req.second.value - DelayPair(fanin.value.maxDelay()), req.second.path_length + 1,
+                                      req.second.value - fanin.value.maxDelay(), req.second.path_length + 1,
                                       p);
                 }
             }
@@ -444,6 +725,75 @@ void TimingAnalyser::walk_backward()
     }
 }
 
+void TimingAnalyser::pull_arrival(PerPort &pd)
+{
+    if (pd.type == PORT_IN) {
+        // Input port: arrival comes from the net driver, adding route delay
+        if (pd.drv_idx >= 0) {
+            auto &drv_pd = *port_by_idx.at(pd.drv_idx);
+            for (auto &arr : drv_pd.arrival)
+                set_arrival_time(pd, arr.first, arr.second.value + pd.route_delay, arr.second.path_length,
+                                 drv_pd.cell_port);
+        }
+    } else if (pd.type == PORT_OUT) {
+        // Output port: arrival comes through the cell, adding combinational
+        // delay (transposed arcs; see build_levels). Any clock-to-out
+        // contribution was already merged by the startpoint initialisation
+        for (auto &fanin : pd.pull_fwd_arcs) {
+            auto &src_pd = *port_by_idx.at(fanin.other_idx);
+            for (auto &arr : src_pd.arrival)
+                set_arrival_time(pd, arr.first, arr.second.value + fanin.value.delayPair(),
+                                 arr.second.path_length + 1, src_pd.cell_port);
+        }
+    }
+}
+
+void TimingAnalyser::pull_required(PerPort &pd)
+{
+    if (pd.type == PORT_OUT) {
+        // Output port: required comes back from the net users, subtracting
+        // route delay
+        for (int usr_idx : pd.user_idxs) {
+            auto &usr_pd = *port_by_idx.at(usr_idx);
+            for (auto &req : usr_pd.required)
+                set_required_time(pd, req.first, req.second.value - usr_pd.route_delay.maxDelay(),
+                                  req.second.path_length, usr_pd.cell_port);
+        }
+    } else if (pd.type == PORT_IN) {
+        // Input port: required comes back through the cell, subtracting
+        // combinational delay (transposed arcs; see build_levels)
+        for (auto &fanout : pd.pull_bwd_arcs) {
+            auto &dst_pd = *port_by_idx.at(fanout.other_idx);
+            for (auto &req : dst_pd.required)
+                set_required_time(pd, req.first, req.second.value - fanout.value.maxDelay(),
+                                  req.second.path_length + 1, dst_pd.cell_port);
+        }
+    }
+}
+
+void TimingAnalyser::process_level(const std::vector<int> &level, bool backward)
+{
+    // Only wide levels are worth distributing; narrow ones are processed
+    // inline to avoid dispatch costs dominating
+    if (level.size() >= 2048 && ThreadPool::get().num_workers() > 1) {
+        ThreadPool::get().run_chunks(level.size(), 256, [&](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; j++) {
+                if (backward)
+                    pull_required(*port_by_idx.at(level.at(j)));
+                else
+                    pull_arrival(*port_by_idx.at(level.at(j)));
+            }
+        });
+        return;
+    }
+    for (int p : level) {
+        if (backward)
+            pull_required(*port_by_idx.at(p));
+        else
+            pull_arrival(*port_by_idx.at(p));
+    }
+}
+
 void TimingAnalyser::print_fmax()
 {
     // Temporary testing code for comparison only
@@ -466,45 +816,75 @@ void TimingAnalyser::print_fmax()
 
 void TimingAnalyser::compute_slack()
 {
-    for (auto &dp : domain_pairs) {
-        dp.worst_setup_slack = std::numeric_limits<delay_t>::max();
-        dp.worst_hold_slack = std::numeric_limits<delay_t>::max();
-    }
-    for (auto p : topological_order) {
-        auto &pd = ports.at(p);
-        for (auto &pdp : pd.domain_pairs) {
-            auto &dp = domain_pairs.at(pdp.first);
-            auto &arr = pd.arrival.at(dp.key.launch);
-            auto &req = pd.required.at(dp.key.capture);
-            pdp.second.setup_slack = 0 - (arr.value.maxDelay() - req.value.minDelay());
-            if (!setup_only)
-                pdp.second.hold_slack = arr.value.minDelay() - req.value.maxDelay();
-            pdp.second.max_path_length = arr.path_length + req.path_length;
-            if (dp.key.launch == dp.key.capture)
-                pd.worst_setup_slack = std::min(pd.worst_setup_slack, dp.period.minDelay() + pdp.second.setup_slack);
-            dp.worst_setup_slack = std::min(dp.worst_setup_slack, pdp.second.setup_slack);
-            if (!setup_only) {
-                pd.worst_hold_slack = std::min(pd.worst_hold_slack, pdp.second.hold_slack);
-                dp.worst_hold_slack = std::min(dp.worst_hold_slack, pdp.second.hold_slack);
-            }
-        }
+    // Per-port slacks and path lengths are owned by their port, so the scan
+    // runs chunked over the pool via the dense port index; the per-pair
+    // worst slacks are the only shared result and come from min-reducing
+    // per-chunk partials, which is exact whatever the chunk assignment, so
+    // the outcome matches the serial scan for any thread count
+    struct PairWorst
+    {
+        std::vector<delay_t> setup, hold;
+    };
+    PairWorst init;
+    init.setup.assign(domain_pairs.size(), std::numeric_limits<delay_t>::max());
+    init.hold.assign(domain_pairs.size(), std::numeric_limits<delay_t>::max());
+    auto worst = ThreadPool::get().reduce_chunks(
+            port_by_idx.size(), 256, init,
+            [&](size_t begin, size_t end) {
+                PairWorst result = init;
+                for (size_t i = begin; i < end; i++) {
+                    auto &pd = *port_by_idx.at(i);
+                    for (auto &pdp : pd.domain_pairs) {
+                        auto &dp = domain_pairs.at(pdp.first);
+                        auto &arr = pd.arrival.at(dp.key.launch);
+                        auto &req = pd.required.at(dp.key.capture);
+                        pdp.second.setup_slack = 0 - (arr.value.maxDelay() - req.value.minDelay());
+                        if (!setup_only)
+                            pdp.second.hold_slack = arr.value.minDelay() - req.value.maxDelay();
+                        pdp.second.max_path_length = arr.path_length + req.path_length;
+                        if (dp.key.launch == dp.key.capture)
+                            pd.worst_setup_slack =
+                                    std::min(pd.worst_setup_slack, dp.period.minDelay() + pdp.second.setup_slack);
+                        result.setup.at(pdp.first) = std::min(result.setup.at(pdp.first), pdp.second.setup_slack);
+                        if (!setup_only) {
+                            pd.worst_hold_slack = std::min(pd.worst_hold_slack, pdp.second.hold_slack);
+                            result.hold.at(pdp.first) = std::min(result.hold.at(pdp.first), pdp.second.hold_slack);
+                        }
+                    }
+                }
+                return result;
+            },
+            [](PairWorst a, PairWorst b) {
+                for (size_t i = 0; i < a.setup.size(); i++) {
+                    a.setup.at(i) = std::min(a.setup.at(i), b.setup.at(i));
+                    a.hold.at(i) = std::min(a.hold.at(i), b.hold.at(i));
+                }
+                return a;
+            });
+    for (size_t i = 0; i < domain_pairs.size(); i++) {
+        domain_pairs.at(i).worst_setup_slack = worst.setup.at(i);
+        domain_pairs.at(i).worst_hold_slack = worst.hold.at(i);
     }
 }
 
 void TimingAnalyser::compute_criticality()
 {
-    for (auto p : topological_order) {
-        auto &pd = ports.at(p);
-        for (auto &pdp : pd.domain_pairs) {
-            auto &dp = domain_pairs.at(pdp.first);
-            float crit =
-                    1.0f - (float(pdp.second.setup_slack) - float(dp.worst_setup_slack)) / float(-dp.worst_setup_slack);
-            crit = std::min(crit, 1.0f);
-            crit = std::max(crit, 0.0f);
-            pdp.second.criticality = crit;
-            pd.worst_crit = std::max(pd.worst_crit, crit);
+    // Pure per-port arithmetic against the already-final per-pair worst
+    // slacks; every write is owned by the port being visited
+    ThreadPool::get().run_chunks(port_by_idx.size(), 256, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            auto &pd = *port_by_idx.at(i);
+            for (auto &pdp : pd.domain_pairs) {
+                auto &dp = domain_pairs.at(pdp.first);
+                float crit = 1.0f -
+                             (float(pdp.second.setup_slack) - float(dp.worst_setup_slack)) / float(-dp.worst_setup_slack);
+                crit = std::min(crit, 1.0f);
+                crit = std::max(crit, 0.0f);
+                pdp.second.criticality = crit;
+                pd.worst_crit = std::max(pd.worst_crit, crit);
+            }
         }
-    }
+    });
 }
 
 std::vector<CellPortKey> TimingAnalyser::get_failing_eps(domain_id_t domain_pair, int count)
@@ -549,6 +929,156 @@ void TimingAnalyser::print_critical_path(CellPortKey endpoint, domain_id_t domai
     }
 }
 
+void TimingAnalyser::accumulate_worst_eps(domain_id_t domain_pair, int count, std::vector<PathEndpoint> &worst)
+{
+    auto &dp = domain_pairs.at(domain_pair);
+    auto &cap_d = domains.at(dp.key.capture);
+    for (auto &ep : cap_d.endpoints) {
+        auto &pd = ports.at(ep.first);
+        const auto *pdp = pd.domain_pairs.find(domain_pair);
+        if (pdp == nullptr)
+            continue;
+        // Add the domain pair period so that slacks are comparable across
+        // pairs; ties are broken by the rest of the tuple for determinism
+        PathEndpoint cand(dp.period.minDelay() + pdp->setup_slack, domain_pair, ep.first);
+        if (int(worst.size()) == count) {
+            if (!(cand < worst.front()))
+                continue;
+            std::pop_heap(worst.begin(), worst.end());
+            worst.back() = cand;
+        } else {
+            worst.push_back(cand);
+        }
+        std::push_heap(worst.begin(), worst.end());
+    }
+}
+
+CriticalPath TimingAnalyser::build_worst_path(CellPortKey endpoint, domain_id_t domain_pair)
+{
+    auto &dp = domain_pairs.at(domain_pair);
+    auto &launch = domains.at(dp.key.launch).key;
+    auto &capture = domains.at(dp.key.capture).key;
+
+    CriticalPath path;
+    path.clock_pair.start = ClockEvent{launch.is_async() ? ctx->id("$async$") : launch.clock, launch.edge};
+    path.clock_pair.end = ClockEvent{capture.is_async() ? ctx->id("$async$") : capture.clock, capture.edge};
+    path.period = dp.period.minDelay();
+
+    // Recover the max-delay traversal from the back-pointers, then reverse
+    // it into launch-to-capture order
+    std::vector<CellPortKey> chain;
+    CellPortKey cursor = endpoint;
+    while (cursor != CellPortKey()) {
+        chain.push_back(cursor);
+        auto &pd = ports.at(cursor);
+        if (!pd.arrival.count(dp.key.launch))
+            break;
+        cursor = pd.arrival.at(dp.key.launch).bwd_max;
+    }
+    std::reverse(chain.begin(), chain.end());
+
+    auto arrival_at = [&](const CellPortKey &key) -> delay_t {
+        const auto *arr = ports.at(key).arrival.find(dp.key.launch);
+        return (arr != nullptr) ? arr->value.maxDelay() : 0;
+    };
+
+    // Startpoint: a register clock-to-Q arc matching the launch domain, or
+    // a delayless source (top-level port etc) otherwise
+    auto &start_pd = ports.at(chain.front());
+    CriticalPath::Segment seg_start;
+    seg_start.type = CriticalPath::Segment::Type::SOURCE;
+    seg_start.net = IdString();
+    seg_start.from = std::make_pair(chain.front().cell, chain.front().port);
+    seg_start.to = seg_start.from;
+    seg_start.delay = arrival_at(chain.front());
+    seg_start.budget = 0;
+    for (auto &arc : cell_arcs(start_pd)) {
+        if (arc.type != CellArc::CLK_TO_Q || launch.is_async() || arc.edge != launch.edge)
+            continue;
+        const NetInfo *clk_net = get_net_or_empty(cell_info(chain.front()), arc.other_port);
+        if (clk_net == nullptr || clk_net->name != launch.clock)
+            continue;
+        seg_start.type = CriticalPath::Segment::Type::CLK_TO_Q;
+        seg_start.from = std::make_pair(chain.front().cell, arc.other_port);
+        break;
+    }
+    path.segments.push_back(seg_start);
+
+    // Interior ports alternate cell outputs and inputs: an output to input
+    // hop is a routing segment, an input to output hop through a cell is a
+    // logic segment. Delays come from the arrival time differences so the
+    // report always matches what the analysis actually saw
+    for (size_t i = 1; i < chain.size(); i++) {
+        auto &prev = chain.at(i - 1);
+        auto &curr = chain.at(i);
+        CriticalPath::Segment seg;
+        seg.from = std::make_pair(prev.cell, prev.port);
+        seg.to = std::make_pair(curr.cell, curr.port);
+        seg.delay = arrival_at(curr) - arrival_at(prev);
+        seg.net = IdString();
+        seg.budget = 0;
+        if (ports.at(prev).type == PORT_OUT) {
+            seg.type = CriticalPath::Segment::Type::ROUTING;
+            auto &sink_np = ports.at(curr).net_port;
+            if (sink_np.net != IdString() && !sink_np.is_driver()) {
+                seg.net = sink_np.net;
+                seg.budget = ctx->nets.at(sink_np.net)->users.at(sink_np.user_idx()).budget;
+            }
+        } else {
+            seg.type = CriticalPath::Segment::Type::LOGIC;
+        }
+        path.segments.push_back(seg);
+    }
+
+    // Setup time at the endpoint, for the capture domain
+    for (auto &arc : cell_arcs(ports.at(endpoint))) {
+        if (arc.type != CellArc::SETUP || capture.is_async() || arc.edge != capture.edge)
+            continue;
+        const NetInfo *clk_net = get_net_or_empty(cell_info(endpoint), arc.other_port);
+        if (clk_net == nullptr || clk_net->name != capture.clock)
+            continue;
+        CriticalPath::Segment seg_setup;
+        seg_setup.type = CriticalPath::Segment::Type::SETUP;
+        seg_setup.net = IdString();
+        seg_setup.from = std::make_pair(endpoint.cell, endpoint.port);
+        seg_setup.to = seg_setup.from;
+        seg_setup.delay = arc.value.maxDelay();
+        seg_setup.budget = 0;
+        path.segments.push_back(seg_setup);
+        break;
+    }
+
+    path.delay = 0;
+    for (auto &seg : path.segments)
+        path.delay += seg.delay;
+    return path;
+}
+
+std::vector<CriticalPath> TimingAnalyser::get_worst_paths(int count)
+{
+    std::vector<PathEndpoint> worst;
+    for (domain_id_t dp_id = 0; dp_id < domain_id_t(domain_pairs.size()); dp_id++)
+        accumulate_worst_eps(dp_id, count, worst);
+    std::sort(worst.begin(), worst.end());
+    std::vector<CriticalPath> result;
+    result.reserve(worst.size());
+    for (auto &ep : worst)
+        result.push_back(build_worst_path(std::get<2>(ep), std::get<1>(ep)));
+    return result;
+}
+
+std::vector<CriticalPath> TimingAnalyser::get_worst_paths(domain_id_t domain_pair, int count)
+{
+    std::vector<PathEndpoint> worst;
+    accumulate_worst_eps(domain_pair, count, worst);
+    std::sort(worst.begin(), worst.end());
+    std::vector<CriticalPath> result;
+    result.reserve(worst.size());
+    for (auto &ep : worst)
+        result.push_back(build_worst_path(std::get<2>(ep), domain_pair));
+    return result;
+}
+
 namespace {
 const char *edge_name(ClockEdge edge) { return (edge == FALLING_EDGE) ? "negedge" : "posedge"; }
 } // namespace
@@ -640,7 +1170,8 @@ struct Timing
         delay_t min_remaining_budget;
         bool false_startpoint = false;
         std::vector<delay_t> min_required;
-        dict<ClockEvent, delay_t> arrival_time;
+        // Rarely more than one or two clock domains reach a given net
+        small_dict<ClockEvent, delay_t, 2> arrival_time;
     };
 
     Timing(Context *ctx, bool net_delays, bool update, CriticalPathDataMap *crit_path = nullptr,
@@ -658,7 +1189,7 @@ struct Timing
         // First, compute the topological order of nets to walk through the circuit, assuming it is a _acyclic_ graph
         // TODO(eddieh): Handle the case where it is cyclic, e.g. combinatorial loops
         std::vector<NetInfo *> topological_order;
-        dict<const NetInfo *, dict<ClockEvent, TimingData>, hash_ptr_ops> net_data;
+        dict<const NetInfo *, small_dict<ClockEvent, TimingData, 2>, hash_ptr_ops> net_data;
         // In lieu of deleting edges from the graph, simply count the number of fanins to each output port
         dict<const PortInfo *, unsigned, hash_ptr_ops> port_fanin;
 
@@ -1383,10 +1914,9 @@ void timing_analysis(Context *ctx, bool print_histogram, bool print_fmax, bool p
                         auto cursor = sink_wire;
                         delay_t delay;
                         while (driver_wire != cursor) {
-#ifdef ARCH_ECP5
-                            if (net->is_global)
-                                break;
-#endif
+                            if (Arch::capGlobalsRoutedSeparately)
+                                if (net->is_global)
+                                    break;
                             auto it = net->wires.find(cursor);
                             assert(it != net->wires.end());
                             auto pip = it->second.pip;
@@ -1517,6 +2047,15 @@ void timing_analysis(Context *ctx, bool print_histogram, bool print_fmax, bool p
         results.xclock_paths = std::move(xclock_reports);
 
         results.detailed_net_timings = std::move(detailed_net_timings);
+
+        // Path enumeration for the JSON report: one analysis pass plus one
+        // back-pointer walk per path, rather than re-running STA per path
+        if (ctx->report_timing_paths > 0) {
+            TimingAnalyser tmg(ctx);
+            tmg.setup();
+            tmg.run();
+            results.worst_paths = tmg.get_worst_paths(ctx->report_timing_paths);
+        }
     }
 }
 
@@ -106,6 +106,21 @@ struct TimingAnalyser
 
     float get_criticality(CellPortKey port) const { return ports.at(port).worst_crit; }
     float get_setup_slack(CellPortKey port) const { return ports.at(port).worst_setup_slack; }
+
+    // Flat per-arc view of the same results, indexed by
+    // NetInfo::tmg_arc_base (assigned when setup() freezes the netlist)
+    // plus the user index. The arrays are refreshed at the end of every
+    // run(), so routers that walk net users can read them lock-free from
+    // worker threads instead of building a CellPortKey and paying a dict
+    // lookup per arc
+    float get_criticality(const NetInfo *net, size_t user_idx) const
+    {
+        return arc_criticality[net->tmg_arc_base + user_idx];
+    }
+    delay_t get_setup_slack(const NetInfo *net, size_t user_idx) const
+    {
+        return arc_setup_slack[net->tmg_arc_base + user_idx];
+    }
     float get_domain_setup_slack(CellPortKey port) const
     {
         delay_t slack = std::numeric_limits<delay_t>::max();
@@ -114,31 +129,79 @@ struct TimingAnalyser
         return slack;
     }
 
+    // Enumerate the `count` worst setup paths, either across all domain
+    // pairs or restricted to one, as report-ready CriticalPath structures.
+    // Endpoint selection is a single bounded-heap pass over the slack
+    // annotations of the last run() and each path is reconstructed by one
+    // walk of the back-pointers, so extracting the top-N paths costs far
+    // less than re-running the analysis per path. Results are ordered by
+    // ascending slack
+    std::vector<CriticalPath> get_worst_paths(int count);
+    std::vector<CriticalPath> get_worst_paths(domain_id_t domain_pair, int count);
+
     bool setup_only = false;
     bool verbose_mode = false;
     bool have_loops = false;
     bool updated_domains = false;
+    // When set, the flat per-arc annotations are updated with damping
+    // rather than copied verbatim: an arc whose setup slack moved by no
+    // more than the arch delay epsilon keeps its previous annotation, and
+    // one that did move blends the fresh criticality with the old value as
+    // an exponential decay. Routers that re-run STA every congestion
+    // iteration enable this so arc priorities track real change instead of
+    // oscillating with each reroute; reports and one-shot analyses leave it
+    // clear and see exact values.
+    bool damped_criticality = false;
 
   private:
+    // Incremental analysis state: set whenever a route delay actually
+    // changes, cleared after a full propagation. When no delay has changed
+    // since the previous run(), the forward/backward walks are skipped and
+    // the previous arrival/required/criticality data stays valid.
+    bool times_dirty = true;
+
+  public:
+
+  private:
+    struct PerPort;
+
     void init_ports();
     void get_cell_delays();
     void get_route_delays();
     void topo_sort();
+    void build_levels();
     void setup_port_domains();
 
     void reset_times();
 
     void walk_forward();
     void walk_backward();
+    // Pull-based per-port updates used by the level-parallel walks: the port
+    // being processed computes its own arrival/required time from its
+    // fanins/fanouts, so ports within a level never write to each other
+    void pull_arrival(PerPort &pd);
+    void pull_required(PerPort &pd);
+    void process_level(const std::vector<int> &level, bool backward);
 
     void compute_slack();
     void compute_criticality();
+    void refresh_arc_annotations();
 
     void print_fmax();
     // get the N most failing endpoints for a given domain pair
     std::vector<CellPortKey> get_failing_eps(domain_id_t domain_pair, int count);
     // print the critical path for an endpoint and domain pair
     void print_critical_path(CellPortKey endpoint, domain_id_t domain_pair);
+    // candidate endpoints for path enumeration: (period-adjusted setup
+    // slack; domain pair; endpoint), ordered so that tuple comparison gives
+    // a deterministic worst-first ranking
+    typedef std::tuple<delay_t, domain_id_t, CellPortKey> PathEndpoint;
+    // push the endpoints of one domain pair into a bounded max-heap that
+    // keeps only the `count` worst entries
+    void accumulate_worst_eps(domain_id_t domain_pair, int count, std::vector<PathEndpoint> &worst);
+    // rebuild the max-delay traversal reaching an endpoint from the
+    // bwd_max back-pointers as a report-ready segment list
+    CriticalPath build_worst_path(CellPortKey endpoint, domain_id_t domain_pair);
 
     const DelayPair init_delay{std::numeric_limits<delay_t>::max(), std::numeric_limits<delay_t>::lowest()};
 
@@ -147,6 +210,12 @@ struct TimingAnalyser
                           CellPortKey prev = CellPortKey());
     void set_required_time(CellPortKey target, domain_id_t domain, DelayPair required, int path_length,
                            CellPortKey prev = CellPortKey());
+    // Overloads on the resolved port data, used by the pull-based walks to
+    // avoid a key hash per propagation
+    void set_arrival_time(PerPort &target, domain_id_t domain, DelayPair arrival, int path_length,
+                          CellPortKey prev = CellPortKey());
+    void set_required_time(PerPort &target, domain_id_t domain, DelayPair required, int path_length,
+                           CellPortKey prev = CellPortKey());
 
     // To avoid storing the domain tag structure (which could get large when considering more complex constrained tag
     // cases), assign each domain an ID and use that instead
@@ -190,6 +259,74 @@ struct TimingAnalyser
                 : type(type), other_port(other_port), value(value), edge(edge){};
     };
 
+    // A combinational arc transposed for the pull-based walks, with the far
+    // end resolved to a dense port index so that propagation is array
+    // indexing rather than a CellPortKey hash per arc
+    struct PullArc
+    {
+        int other_idx;
+        DelayQuad value;
+        PullArc(int other_idx, DelayQuad value) : other_idx(other_idx), value(value){};
+    };
+
+    // Flat stand-in for a dict of per-domain data. A port only ever sees a
+    // handful of domains, so a small array sorted by domain id both uses
+    // less memory than a hash map and lets the walks process all domains of
+    // a port together from contiguous storage
+    template <typename T> struct FlatDomainMap
+    {
+        std::vector<std::pair<domain_id_t, T>> entries;
+
+        typedef typename std::vector<std::pair<domain_id_t, T>>::iterator iterator;
+        typedef typename std::vector<std::pair<domain_id_t, T>>::const_iterator const_iterator;
+        iterator begin() { return entries.begin(); }
+        iterator end() { return entries.end(); }
+        const_iterator begin() const { return entries.begin(); }
+        const_iterator end() const { return entries.end(); }
+        size_t size() const { return entries.size(); }
+
+        T *find(domain_id_t id)
+        {
+            for (auto &entry : entries)
+                if (entry.first == id)
+                    return &entry.second;
+            return nullptr;
+        }
+        const T *find(domain_id_t id) const
+        {
+            for (auto &entry : entries)
+                if (entry.first == id)
+                    return &entry.second;
+            return nullptr;
+        }
+        bool count(domain_id_t id) const { return find(id) != nullptr; }
+        T &at(domain_id_t id)
+        {
+            T *entry = find(id);
+            NPNR_ASSERT(entry != nullptr);
+            return *entry;
+        }
+        const T &at(domain_id_t id) const
+        {
+            const T *entry = find(id);
+            NPNR_ASSERT(entry != nullptr);
+            return *entry;
+        }
+        // mimics dict::emplace, but keeps entries sorted by id so that
+        // iteration order is canonical rather than insertion-dependent
+        std::pair<T *, bool> emplace(domain_id_t id, T &&value)
+        {
+            auto it = entries.begin();
+            while (it != entries.end() && it->first < id)
+                ++it;
+            if (it != entries.end() && it->first == id)
+                return std::make_pair(&it->second, false);
+            it = entries.insert(it, std::make_pair(id, std::move(value)));
+            return std::make_pair(&it->second, true);
+        }
+        T &operator[](domain_id_t id) { return *emplace(id, T{}).first; }
+    };
+
     // Timing data for every cell port
     struct PerPort
     {
@@ -197,11 +334,26 @@ struct TimingAnalyser
         NetPortKey net_port;
         PortType type;
         // per domain timings
-        dict<domain_id_t, ArrivReqTime> arrival;
-        dict<domain_id_t, ArrivReqTime> required;
-        dict<domain_id_t, PortDomainPairData> domain_pairs;
-        // cell timing arcs to (outputs)/from (inputs)  from this port
-        std::vector<CellArc> cell_arcs;
+        FlatDomainMap<ArrivReqTime> arrival;
+        FlatDomainMap<ArrivReqTime> required;
+        FlatDomainMap<PortDomainPairData> domain_pairs;
+        // cell timing arcs to (outputs)/from (inputs) from this port, held
+        // as a range in the shared arc_storage arena rather than a per-port
+        // vector so that setup() makes a handful of allocations instead of
+        // one per port
+        int32_t arc_begin = 0, arc_count = 0;
+        // combinational arcs transposed for the pull-based walks: on output
+        // ports, the input-port arcs walk_forward propagates through; on
+        // input ports, the output-port arcs walk_backward propagates
+        // through. The two sets differ for ports whose timing class
+        // suppresses arc creation, so both transposes are kept
+        std::vector<PullArc> pull_fwd_arcs, pull_bwd_arcs;
+        // dense-index view of this port and its routing neighbours, built in
+        // build_levels(): position in port_by_idx, the driving output port
+        // of an input (-1 when undriven) and the user ports of an output
+        int idx = -1;
+        int drv_idx = -1;
+        std::vector<int> user_idxs;
         // routing delay into this port (input ports only)
         DelayPair route_delay{0};
         // worst criticality and slack across domain pairs
@@ -229,6 +381,8 @@ struct TimingAnalyser
     CellInfo *cell_info(const CellPortKey &key);
     PortInfo &port_info(const CellPortKey &key);
 
+    void get_port_cell_delays(const CellPortKey &key, PerPort &pd, std::vector<CellArc> &out);
+
     domain_id_t domain_id(IdString cell, IdString clock_port, ClockEdge edge);
     domain_id_t domain_id(const NetInfo *net, ClockEdge edge);
     domain_id_t domain_pair_id(domain_id_t launch, domain_id_t capture);
@@ -236,12 +390,43 @@ struct TimingAnalyser
     void copy_domains(const CellPortKey &from, const CellPortKey &to, bool backwards);
 
     dict<CellPortKey, PerPort> ports;
+    // Every port's cell arcs, arena-allocated contiguously in port order by
+    // get_cell_delays(); PerPort::arc_begin/arc_count index into this
+    std::vector<CellArc> arc_storage;
+
+    struct CellArcRange
+    {
+        const CellArc *b, *e;
+        const CellArc *begin() const { return b; }
+        const CellArc *end() const { return e; }
+    };
+    CellArcRange cell_arcs(const PerPort &pd) const
+    {
+        return {arc_storage.data() + pd.arc_begin, arc_storage.data() + pd.arc_begin + pd.arc_count};
+    }
+    // Flat per-arc annotation store behind the (net, user_idx) getters;
+    // written only by refresh_arc_annotations() at the end of run()
+    std::vector<float> arc_criticality;
+    std::vector<delay_t> arc_setup_slack;
+    // Whether the arrays above hold results from a previous run(); until
+    // they do, damped updates have no history to blend with
+    bool arcs_annotated = false;
     dict<ClockDomainKey, domain_id_t> domain_to_id;
     dict<ClockDomainPairKey, domain_id_t> pair_to_id;
     std::vector<PerDomain> domains;
     std::vector<PerDomainPair> domain_pairs;
 
     std::vector<CellPortKey> topological_order;
+    // Dense index over ports (insertion order of the ports dict); the
+    // pull-based walks address ports through this instead of hashing keys
+    std::vector<PerPort *> port_by_idx;
+    // Port indices grouped into topological levels: every propagation
+    // performed by the walks crosses from a lower to a strictly higher
+    // level, so all ports within one level can be updated in parallel.
+    // Unset (and the walks fall back to in-order pushing) when combinational
+    // loops prevent a level assignment
+    std::vector<std::vector<int>> level_order;
+    bool have_levels = false;
 
     Context *ctx;
 };
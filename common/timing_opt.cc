@@ -31,6 +31,7 @@
 #include "timing_opt.h"
 #include <boost/range/adaptor/reversed.hpp>
 #include <queue>
+#include "fast_bels.h"
 #include "nextpnr.h"
 #include "timing.h"
 #include "util.h"
@@ -40,7 +41,8 @@ NEXTPNR_NAMESPACE_BEGIN
 class TimingOptimiser
 {
   public:
-    TimingOptimiser(Context *ctx, TimingOptCfg cfg) : ctx(ctx), cfg(cfg), tmg(ctx){};
+    TimingOptimiser(Context *ctx, TimingOptCfg cfg)
+            : ctx(ctx), cfg(cfg), tmg(ctx), fast_bels(ctx, /*check_bel_available=*/false, -1){};
     bool optimise()
     {
         log_info("Running timing-driven placement optimisation...\n");
@@ -48,6 +50,10 @@ class TimingOptimiser
         if (ctx->verbose)
             timing_analysis(ctx, false, true, false, false);
         tmg.setup();
+        // Index the bels for each optimisable cell type up front; the
+        // neighbourhood search then reads per-tile candidate lists instead
+        // of re-checking type validity of every bel in range on every pass
+        fast_bels.addCellTypes(cfg.cellTypes);
         for (int i = 0; i < 30; i++) {
             log_info("   Iteration %d...\n", i);
             tmg.run();
@@ -166,17 +172,24 @@ class TimingOptimiser
         Loc curr_loc = ctx->getBelLocation(curr);
         int found_count = 0;
         cell_neighbour_bels[cell->name] = pool<BelId>{};
+        // Per-tile bels that can host this cell type, indexed once per run
+        // in optimise() rather than filtered from scratch here every pass
+        FastBels::FastBelsData *type_bels;
+        fast_bels.getBelsForCellType(cell->type, &type_bels);
         for (int dy = -d; dy <= d; dy++) {
             for (int dx = -d; dx <= d; dx++) {
+                int nx = curr_loc.x + dx, ny = curr_loc.y + dy;
+                if (nx < 0 || nx >= int(type_bels->size()))
+                    continue;
+                if (ny < 0 || ny >= int(type_bels->at(nx).size()))
+                    continue;
                 // Go through all the Bels at this location
                 // First, find all bels of the correct type that are either unbound or bound normally
                 // Strongly bound bels are ignored
                 // FIXME: This means that we cannot touch carry chains or similar relatively constrained macros
                 std::vector<BelId> free_bels_at_loc;
                 std::vector<BelId> bound_bels_at_loc;
-                for (auto bel : ctx->getBelsByTile(curr_loc.x + dx, curr_loc.y + dy)) {
-                    if (!ctx->isValidBelForCellType(cell->type, bel))
-                        continue;
+                for (auto bel : type_bels->at(nx).at(ny)) {
                     CellInfo *bound = ctx->getBoundBelCell(bel);
                     if (bound == nullptr) {
                         free_bels_at_loc.push_back(bel);
@@ -235,9 +248,11 @@ class TimingOptimiser
     {
         std::vector<std::vector<PortRef *>> crit_paths;
         std::vector<std::pair<NetInfo *, int>> crit_nets;
-        std::vector<IdString> netnames;
-        std::transform(ctx->nets.begin(), ctx->nets.end(), std::back_inserter(netnames),
-                       [](const std::pair<IdString, std::unique_ptr<NetInfo>> &kv) { return kv.first; });
+        // The net set never changes while this pass runs, so the name list
+        // is built once and only reshuffled between passes
+        if (netnames.empty())
+            std::transform(ctx->nets.begin(), ctx->nets.end(), std::back_inserter(netnames),
+                           [](const std::pair<IdString, std::unique_ptr<NetInfo>> &kv) { return kv.first; });
         ctx->sorted_shuffle(netnames);
         for (auto net : netnames) {
             if (crit_nets.size() >= max_count)
@@ -570,9 +585,12 @@ class TimingOptimiser
     dict<BelId, pool<IdString>> bel_candidate_cells;
     // Map cell ports to net delay limit
     dict<std::pair<IdString, IdString>, delay_t> max_net_delay;
+    // Net names for critical path extraction, built once per run
+    std::vector<IdString> netnames;
     Context *ctx;
     TimingOptCfg cfg;
     TimingAnalyser tmg;
+    FastBels fast_bels;
 };
 
 bool timing_opt(Context *ctx, TimingOptCfg cfg) { return TimingOptimiser(ctx, cfg).optimise(); }
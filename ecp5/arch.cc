@@ -23,6 +23,7 @@
 #include <boost/range/adaptor/reversed.hpp>
 #include <cmath>
 #include <cstring>
+#include <queue>
 #include "embed.h"
 #include "gfx.h"
 #include "globals.h"
@@ -124,25 +125,26 @@ Arch::Arch(ArchArgs args) : args(args)
         id_to_y[y_id] = i;
     }
 
+    // The tile -> flat wire/pip index maps are exclusive prefix sums of the
+    // per-tile counts, so build them from the location data in O(tiles)
+    // rather than stepping the merged iterators over every wire and pip in
+    // the device; tiles without wires/pips keep -1, matching the iterator
+    // behaviour of never visiting them
     wire_tile_vecidx.resize(chip_info->num_tiles, -1);
+    pip_tile_vecidx.resize(chip_info->num_tiles, -1);
     int n_wires = 0;
-    for (auto e : getWires()) {
-        if (e.index == 0) {
-            wire_tile_vecidx.at(e.location.y * chip_info->width + e.location.x) = n_wires;
-        }
-        n_wires++;
+    int n_pips = 0;
+    for (int tile = 0; tile < chip_info->num_tiles; tile++) {
+        auto &loc = chip_info->locations[chip_info->location_type[tile]];
+        if (loc.wire_data.ssize() > 0)
+            wire_tile_vecidx.at(tile) = n_wires;
+        n_wires += loc.wire_data.ssize();
+        if (loc.pip_data.ssize() > 0)
+            pip_tile_vecidx.at(tile) = n_pips;
+        n_pips += loc.pip_data.ssize();
     }
     wire2net.resize(n_wires, nullptr);
     wire_fanout.resize(n_wires, 0);
-
-    pip_tile_vecidx.resize(chip_info->num_tiles, -1);
-    int n_pips = 0;
-    for (auto e : getPips()) {
-        if (e.index == 0) {
-            pip_tile_vecidx.at(e.location.y * chip_info->width + e.location.x) = n_pips;
-        }
-        n_pips++;
-    }
     pip2net.resize(n_pips, nullptr);
 
     lutperm_allowed.resize(chip_info->width * chip_info->height * 4);
@@ -295,19 +297,31 @@ WireId Arch::getWireByName(IdStringList name) const
 {
     if (name.size() != 3)
         return WireId();
+    auto it = wire_by_name.find(name);
+    if (it != wire_by_name.end())
+        return it->second;
+
     WireId ret;
     Location loc;
     loc.x = id_to_x.at(name[0]);
     loc.y = id_to_y.at(name[1]);
     ret.location = loc;
+    // Index every wire at this location on the first query that reaches it,
+    // so scripts resolving many names don't pay a linear strcmp scan per call
     const LocationTypePOD *loci = loc_info(ret);
     for (int i = 0; i < loci->wire_data.ssize(); i++) {
-        if (std::strcmp(loci->wire_data[i].name.get(), name[2].c_str(this)) == 0) {
-            ret.index = i;
-            return ret;
-        }
+        WireId curr;
+        curr.location = loc;
+        curr.index = i;
+        wire_by_name[getWireName(curr)] = curr;
+    }
+    it = wire_by_name.find(name);
+    if (it == wire_by_name.end()) {
+        // Cache the miss too, so repeated bad lookups stay cheap
+        wire_by_name[name] = WireId();
+        return WireId();
     }
-    return WireId();
+    return it->second;
 }
 
 // -----------------------------------------------------------------------
@@ -416,6 +430,39 @@ BelId Arch::get_pio_by_function_name(const std::string &name) const
     return BelId();
 }
 
+BelId Arch::get_cascade_neighbour(BelId bel, IdString src_pin, IdString dst_pin) const
+{
+    WireId src = getBelPinWire(bel, src_pin);
+    if (src == WireId())
+        return BelId();
+    // Dedicated cascade paths are at most a pip or two long; keeping the
+    // search radius tight means a pin that actually feeds general routing
+    // can never be mistaken for a cascade to some distant bel
+    std::queue<std::pair<WireId, int>> visit;
+    pool<WireId> seen;
+    visit.emplace(src, 0);
+    seen.insert(src);
+    while (!visit.empty()) {
+        WireId cursor = visit.front().first;
+        int depth = visit.front().second;
+        visit.pop();
+        for (auto bel_pin : getWireBelPins(cursor)) {
+            if (bel_pin.pin == dst_pin && bel_pin.bel != bel)
+                return bel_pin.bel;
+        }
+        if (depth >= 2)
+            continue;
+        for (auto pip : getPipsDownhill(cursor)) {
+            WireId dst = getPipDstWire(pip);
+            if (seen.count(dst))
+                continue;
+            seen.insert(dst);
+            visit.emplace(dst, depth + 1);
+        }
+    }
+    return BelId();
+}
+
 std::vector<IdString> Arch::getBelPins(BelId bel) const
 {
     std::vector<IdString> ret;
@@ -446,11 +446,20 @@ struct ArchRanges : BaseArchRanges
 
 struct Arch : BaseArch<ArchRanges>
 {
+    // Globals are routed by route_ecp5_globals and appear part-unrouted to
+    // the general machinery due to arch database limitations
+    static constexpr bool capGlobalsRoutedSeparately = true;
+    // Pip names don't currently round-trip through getPipByName
+    static constexpr bool capPipNameRoundtrip = false;
+
     const ChipInfoPOD *chip_info;
     const PackageInfoPOD *package_info;
     const SpeedGradePOD *speed_grade;
 
     mutable dict<IdStringList, PipId> pip_by_name;
+    // Lazy per-location wire name index, filled by getWireByName; misses are
+    // cached as WireId() so bad names don't rescan their location
+    mutable dict<IdStringList, WireId> wire_by_name;
 
     std::vector<CellInfo *> bel_to_cell;
     enum class LutPermRule
@@ -537,6 +546,7 @@ struct Arch : BaseArch<ArchRanges>
         NPNR_ASSERT(bel_to_cell.at(idx) == nullptr);
         bel_to_cell[idx] = cell;
         cell->bel = bel;
+        cell->loc = getBelLocation(bel);
         cell->belStrength = strength;
         if (getBelType(bel) == id_TRELLIS_SLICE) {
             lutperm_allowed.at(get_slice_index(bel.location.x, bel.location.y, getBelLocation(bel).z)) =
@@ -665,6 +675,7 @@ struct Arch : BaseArch<ArchRanges>
         NPNR_ASSERT(w2n_entry == nullptr);
         net->wires[wire].pip = PipId();
         net->wires[wire].strength = strength;
+        ++net->route_version;
         w2n_entry = net;
         this->refreshUiWire(wire);
     }
@@ -685,6 +696,7 @@ struct Arch : BaseArch<ArchRanges>
         }
 
         net_wires.erase(it);
+        ++w2n_entry->route_version;
         w2n_entry = nullptr;
         this->refreshUiWire(wire);
     }
@@ -706,6 +718,26 @@ struct Arch : BaseArch<ArchRanges>
         return range;
     }
 
+    // Tile-major alternative to getWires() for consumers that want to work
+    // through one tile's wires at a time with hot caches; visits the wires
+    // at (x, y) in the same order the global range does
+    WireRange getWiresByTile(int x, int y) const
+    {
+        WireRange range;
+        int tile = y * chip_info->width + x;
+        range.b.cursor_tile = tile;
+        range.b.cursor_index = 0;
+        range.b.chip = chip_info;
+        range.e.cursor_tile = tile;
+        range.e.cursor_index = chip_info->locations[chip_info->location_type[tile]].wire_data.ssize() - 1;
+        range.e.chip = chip_info;
+        if (range.e.cursor_index == -1)
+            ++range.e.cursor_index;
+        else
+            ++range.e;
+        return range;
+    }
+
     IdString get_wire_basename(WireId wire) const { return id(loc_info(wire)->wire_data[wire.index].name.get()); }
 
     WireId get_wire_by_loc_basename(Location loc, std::string basename) const
@@ -752,6 +784,30 @@ struct Arch : BaseArch<ArchRanges>
         w2n_entry = net;
         net->wires[dst].pip = pip;
         net->wires[dst].strength = strength;
+        ++net->route_version;
+    }
+
+    void bindPips(const std::vector<PipId> &pips, NetInfo *net, PlaceStrength strength) override
+    {
+        // Per-pip bookkeeping is plain vector stores, so commit the whole
+        // arc in one call rather than a virtual call per pip
+        net->wires.reserve(net->wires.size() + pips.size());
+        for (auto pip : pips) {
+            NPNR_ASSERT(pip != PipId());
+            wire_fanout[get_wire_vecidx(getPipSrcWire(pip))]++;
+
+            auto &p2n_entry = pip2net.at(get_pip_vecidx(pip));
+            NPNR_ASSERT(p2n_entry == nullptr);
+            p2n_entry = net;
+
+            WireId dst = this->getPipDstWire(pip);
+            auto &w2n_entry = wire2net.at(get_wire_vecidx(dst));
+            NPNR_ASSERT(w2n_entry == nullptr);
+            w2n_entry = net;
+            net->wires[dst].pip = pip;
+            net->wires[dst].strength = strength;
+        }
+        ++net->route_version;
     }
 
     void unbindPip(PipId pip) override
@@ -768,6 +824,7 @@ struct Arch : BaseArch<ArchRanges>
         w2n_entry = nullptr;
 
         p2n_entry->wires.erase(dst);
+        ++p2n_entry->route_version;
         p2n_entry = nullptr;
     }
     bool is_pip_blocked(PipId pip) const
@@ -811,6 +868,24 @@ struct Arch : BaseArch<ArchRanges>
         return range;
     }
 
+    // Tile-major counterpart of getWiresByTile() for pips
+    AllPipRange getPipsByTile(int x, int y) const
+    {
+        AllPipRange range;
+        int tile = y * chip_info->width + x;
+        range.b.cursor_tile = tile;
+        range.b.cursor_index = 0;
+        range.b.chip = chip_info;
+        range.e.cursor_tile = tile;
+        range.e.cursor_index = chip_info->locations[chip_info->location_type[tile]].pip_data.ssize() - 1;
+        range.e.chip = chip_info;
+        if (range.e.cursor_index == -1)
+            ++range.e.cursor_index;
+        else
+            ++range.e;
+        return range;
+    }
+
     WireId getPipSrcWire(PipId pip) const override
     {
         WireId wire;
@@ -853,6 +928,35 @@ struct Arch : BaseArch<ArchRanges>
         return range;
     }
 
+    void getPipsDownhillInfo(WireId wire, std::vector<PipDownhillInfo> &out) const override
+    {
+        NPNR_ASSERT(wire != WireId());
+        out.clear();
+        const auto &pips = loc_info(wire)->wire_data[wire.index].pips_downhill;
+        out.reserve(pips.size());
+        // All downhill pips share this wire as their source, so the fanout
+        // adder lookup is hoisted out of the loop
+        int fanout = wire_fanout[get_wire_vecidx(wire)];
+        for (const auto &ploc : pips) {
+            PipDownhillInfo info;
+            info.pip.index = ploc.index;
+            info.pip.location = wire.location + ploc.rel_loc;
+            const auto &pd = loc_info(info.pip)->pip_data[info.pip.index];
+            info.dst.index = pd.dst_idx;
+            info.dst.location = info.pip.location + pd.rel_dst_loc;
+            const auto &tmg = speed_grade->pip_classes[pd.timing_class];
+            info.delay = DelayQuad(tmg.min_base_delay + fanout * tmg.min_fanout_adder,
+                                   tmg.max_base_delay + fanout * tmg.max_fanout_adder);
+            info.loc.x = info.pip.location.x;
+            info.loc.y = info.pip.location.y;
+            info.loc.z = 0;
+            // Evaluated here, where pip_data is already in cache, so the
+            // router drops forbidden lutperm pips without a second lookup
+            info.blocked = is_pip_blocked(info.pip);
+            out.push_back(info);
+        }
+    }
+
     PipRange getPipsUphill(WireId wire) const override
     {
         PipRange range;
@@ -899,6 +1003,13 @@ struct Arch : BaseArch<ArchRanges>
 
     PortType getBelPinType(BelId bel, IdString pin) const override;
 
+    // Finds the bel whose dst_pin is fed from src_pin of bel over the
+    // dedicated cascade wires (DSP shift and carry chains), or BelId() if
+    // the chip has no such connection. Packing uses this to derive the
+    // relative placement of cascade-connected cells from the routing graph
+    // rather than from hardcoded tile offsets
+    BelId get_cascade_neighbour(BelId bel, IdString src_pin, IdString dst_pin) const;
+
     // -------------------------------------------------
 
     GroupId getGroupByName(IdStringList name) const override;
@@ -962,6 +1073,7 @@ struct Arch : BaseArch<ArchRanges>
     void assignArchInfo() override;
 
     void permute_luts();
+    void postPlaceFixup() override { permute_luts(); }
 
     std::vector<std::pair<std::string, std::string>> get_tiles_at_loc(int row, int col);
     std::string get_tile_by_type_loc(int row, int col, std::string type) const
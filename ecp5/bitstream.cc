@@ -27,7 +27,9 @@
 #include <streambuf>
 #include "config.h"
 #include "log.h"
+#include "lut_mapping_cache.h"
 #include "pio.h"
+#include "threadpool.h"
 #include "util.h"
 
 #define fmt_str(x) (static_cast<const std::ostringstream &>(std::ostringstream() << x).str())
@@ -164,6 +166,36 @@ std::vector<bool> parse_init_str(const Property &p, int length, const char *cell
     return result;
 }
 
+// As parse_init_str, but packing the bits into 64-bit words (bit i of the
+// value in word i / 64) rather than a vector<bool>, for the BRAM
+// initialisation path where the per-bit intermediate dominates
+static std::vector<uint64_t> parse_init_words(const Property &p, int length)
+{
+    std::vector<uint64_t> result((length + 63) / 64, 0);
+    if (p.is_string) {
+        std::string str = p.as_string();
+        NPNR_ASSERT(str.substr(0, 2) == "0x");
+        // Lattice style hex string
+        if (int(str.length()) > (2 + ((length + 3) / 4)))
+            log_error("hex string value too long, expected up to %d chars and found %d.\n", (2 + ((length + 3) / 4)),
+                      int(str.length()));
+        for (int i = 0; i < int(str.length()) - 2; i++) {
+            char c = str.at((str.size() - i) - 1);
+            uint64_t nibble = chtohex(c);
+            result.at((i * 4) / 64) |= nibble << ((i * 4) % 64);
+        }
+        if (length % 64 != 0)
+            result.back() &= (uint64_t(1) << (length % 64)) - 1;
+    } else {
+        std::vector<uint64_t> words = p.as_words64();
+        words.resize(result.size(), 0);
+        if (length % 64 != 0)
+            words.back() &= (uint64_t(1) << (length % 64)) - 1;
+        result = std::move(words);
+    }
+    return result;
+}
+
 inline uint16_t bit_reverse(uint16_t x, int size)
 {
     uint16_t y = 0;
@@ -522,7 +554,116 @@ static void set_pip(Context *ctx, ChipConfig &cc, PipId pip)
     cc.tiles[tile].add_arc(sink, source);
 }
 
-static unsigned permute_lut(Context *ctx, CellInfo *cell, pool<IdString> &used_phys_pins, int k, unsigned orig_init)
+static void set_config_pip(Context *ctx, ChipConfig &cc, PipId pip)
+{
+    std::string source = get_trellis_wirename(ctx, pip.location, ctx->getPipSrcWire(pip));
+    if (source.find("CLKI_PLL") != std::string::npos) {
+        // Special case - must set pip in all relevant tiles
+        for (auto equiv_pip : ctx->getPipsUphill(ctx->getPipDstWire(pip))) {
+            if (ctx->getPipSrcWire(equiv_pip) == ctx->getPipSrcWire(pip))
+                set_pip(ctx, cc, equiv_pip);
+        }
+    } else {
+        set_pip(ctx, cc, pip);
+    }
+}
+
+// Check the routing arcs in the emitted config against a second derivation
+// from the routed netlist itself (the pips recorded in NetInfo::wires). The
+// config was built from a chip-database walk (getPips/getBoundPipNet) through
+// the per-location routing cache, so agreement between the two catches stale
+// cache entries, dropped arcs or tile-name mix-ups at generation time instead
+// of in an external bitstream round trip. Only routing arcs are covered;
+// words and enums have no netlist-side counterpart to compare against. A user
+// base config that carries routing arcs of its own will be reported as
+// unexpected.
+static void verify_routing_config(Context *ctx, const ChipConfig &cc)
+{
+    ChipConfig expected;
+    for (auto &net : ctx->nets) {
+        NetInfo *ni = net.second.get();
+        for (auto &wire : ni->wires) {
+            PipId pip = wire.second.pip;
+            if (pip != PipId() && ctx->get_pip_class(pip) == 0)
+                set_config_pip(ctx, expected, pip);
+        }
+    }
+    fix_tile_names(ctx, expected);
+
+    // Per-tile arc order is an implementation detail of the walk, so compare
+    // the two sides as sorted multisets
+    auto arc_less = [](const ConfigArc &a, const ConfigArc &b) {
+        return a.sink != b.sink ? a.sink < b.sink : a.source < b.source;
+    };
+    struct TileCheck
+    {
+        const std::string *name;
+        const std::vector<ConfigArc> *expected;
+        const std::vector<ConfigArc> *actual;
+    };
+    static const std::vector<ConfigArc> no_arcs;
+    std::vector<TileCheck> checks;
+    size_t total_arcs = 0;
+    for (auto &tile : expected.tiles) {
+        auto fnd = cc.tiles.find(tile.first);
+        checks.push_back(TileCheck{&tile.first, &tile.second.carcs,
+                                   fnd != cc.tiles.end() ? &fnd->second.carcs : &no_arcs});
+        total_arcs += tile.second.carcs.size();
+    }
+    for (auto &tile : cc.tiles) {
+        if (!tile.second.carcs.empty() && !expected.tiles.count(tile.first))
+            checks.push_back(TileCheck{&tile.first, &no_arcs, &tile.second.carcs});
+    }
+    auto check_tiles = [&](size_t begin, size_t end) {
+        std::vector<std::string> result;
+        for (size_t i = begin; i < end; i++) {
+            std::vector<ConfigArc> exp = *checks.at(i).expected, act = *checks.at(i).actual;
+            std::sort(exp.begin(), exp.end(), arc_less);
+            std::sort(act.begin(), act.end(), arc_less);
+            auto e = exp.begin();
+            auto a = act.begin();
+            while (e != exp.end() || a != act.end()) {
+                if (a == act.end() || (e != exp.end() && arc_less(*e, *a))) {
+                    result.push_back(stringf("%s: missing arc %s <-- %s", checks.at(i).name->c_str(), e->sink.c_str(),
+                                             e->source.c_str()));
+                    ++e;
+                } else if (e == exp.end() || arc_less(*a, *e)) {
+                    result.push_back(stringf("%s: unexpected arc %s <-- %s", checks.at(i).name->c_str(),
+                                             a->sink.c_str(), a->source.c_str()));
+                    ++a;
+                } else {
+                    ++e;
+                    ++a;
+                }
+            }
+        }
+        return result;
+    };
+    // Tiles are checked in map (name) order and chunk results concatenated in
+    // chunk order, so the report is independent of the worker count
+    std::vector<std::string> mismatches;
+    if (checks.size() >= 512 && ThreadPool::get().num_workers() > 1) {
+        mismatches = ThreadPool::get().reduce_chunks(
+                checks.size(), 64, std::vector<std::string>{}, check_tiles,
+                [](std::vector<std::string> a, std::vector<std::string> b) {
+                    a.insert(a.end(), std::make_move_iterator(b.begin()), std::make_move_iterator(b.end()));
+                    return a;
+                });
+    } else {
+        mismatches = check_tiles(0, checks.size());
+    }
+    if (!mismatches.empty()) {
+        for (const auto &m : mismatches)
+            log_nonfatal_error("%s\n", m.c_str());
+        log_error("bitstream verification failed: %d routing arc mismatch(es) against the routed netlist\n",
+                  int(mismatches.size()));
+    }
+    log_info("Bitstream verification passed: %d routing arcs in %d tiles match the routed netlist.\n", int(total_arcs),
+             int(expected.tiles.size()));
+}
+
+static unsigned permute_lut(Context *ctx, LutMappingCache &lutperm_cache, CellInfo *cell,
+                            pool<IdString> &used_phys_pins, int k, unsigned orig_init)
 {
     std::array<std::vector<unsigned>, 4> phys_to_log;
     const std::array<IdString, 4> ports{k ? id_A1 : id_A0, k ? id_B1 : id_B0, k ? id_C1 : id_C0, k ? id_D1 : id_D0};
@@ -556,19 +697,11 @@ static unsigned permute_lut(Context *ctx, CellInfo *cell, pool<IdString> &used_p
             }
         }
     }
-    unsigned permuted_init = 0;
-    for (unsigned i = 0; i < 16; i++) {
-        unsigned log_idx = 0;
-        for (unsigned j = 0; j < 4; j++) {
-            if ((i >> j) & 0x1) {
-                for (auto log_pin : phys_to_log[j])
-                    log_idx |= (1 << log_pin);
-            }
-        }
-        if ((orig_init >> log_idx) & 0x1)
-            permuted_init |= (1 << i);
-    }
-    return permuted_init;
+    std::array<uint8_t, 8> phys_to_log_mask{};
+    for (unsigned j = 0; j < 4; j++)
+        for (auto log_pin : phys_to_log[j])
+            phys_to_log_mask[j] |= 1 << log_pin;
+    return unsigned(lutperm_cache.permuted_init(4, orig_init, phys_to_log_mask));
 }
 
 static std::vector<bool> parse_config_str(const Property &p, int length)
@@ -618,6 +751,18 @@ static std::vector<bool> parse_config_str(const Property &p, int length)
     return word;
 }
 
+// Routing config for one tile location, cached across write_bitstream calls
+// in the same process and validated against the exact set of bound pips at
+// that location, so multi-bitstream flows (variants differing in a few BELs)
+// only recompute the wirenames of locations whose routing actually changed.
+// Process-lifetime state: assumes write_bitstream is not called concurrently
+struct RoutingCacheEntry
+{
+    uint64_t pips_hash;
+    std::map<std::string, std::vector<ConfigArc>> tile_arcs;
+};
+static std::map<std::pair<int, int>, RoutingCacheEntry> routing_cache;
+
 std::string intstr_or_default(const dict<IdString, Property> &ct, const IdString &key, std::string def = "0")
 {
     auto found = ct.find(key);
@@ -700,21 +845,94 @@ void write_bitstream(Context *ctx, std::string base_config_file, std::string tex
             }
         }
     }
-    // Add all set, configurable pips to the config
+    // Add all set, configurable pips to the config. This is the bulk of the
+    // tile config work (two wirename lookups per bound pip), and each pip
+    // only reads the chip database. Pips are processed as per-location runs
+    // (getPips iterates location-major): each run's arcs are kept in
+    // routing_cache keyed by the run's exact pip set, so repeated
+    // write_bitstream calls only recompute locations whose routing changed,
+    // and cold runs are computed in parallel shards. Splicing the runs in
+    // iteration order keeps per-tile arc order identical to the serial walk.
+    std::vector<PipId> bound_pips;
     for (auto pip : ctx->getPips()) {
-        if (ctx->getBoundPipNet(pip) != nullptr) {
-            if (ctx->get_pip_class(pip) == 0) { // ignore fixed pips
-                std::string source = get_trellis_wirename(ctx, pip.location, ctx->getPipSrcWire(pip));
-                if (source.find("CLKI_PLL") != std::string::npos) {
-                    // Special case - must set pip in all relevant tiles
-                    for (auto equiv_pip : ctx->getPipsUphill(ctx->getPipDstWire(pip))) {
-                        if (ctx->getPipSrcWire(equiv_pip) == ctx->getPipSrcWire(pip))
-                            set_pip(ctx, cc, equiv_pip);
-                    }
-                } else {
-                    set_pip(ctx, cc, pip);
-                }
-            }
+        if (ctx->getBoundPipNet(pip) != nullptr && ctx->get_pip_class(pip) == 0) // ignore fixed pips
+            bound_pips.push_back(pip);
+    }
+    // The chip name is folded into the pip set hash so cache entries can
+    // never leak between different devices in one process
+    uint64_t chip_hash = 0xcbf29ce484222325ULL;
+    for (char c : ctx->get_full_chip_name())
+        chip_hash = (chip_hash ^ uint64_t(uint8_t(c))) * 0x100000001b3ULL;
+    struct PipRun
+    {
+        size_t begin, end;
+        uint64_t hash;
+    };
+    std::vector<PipRun> runs;
+    for (size_t i = 0; i < bound_pips.size();) {
+        size_t j = i;
+        uint64_t hash = chip_hash;
+        while (j < bound_pips.size() && bound_pips.at(j).location == bound_pips.at(i).location) {
+            hash = (hash ^ uint64_t(uint32_t(bound_pips.at(j).index))) * 0x100000001b3ULL;
+            j++;
+        }
+        runs.push_back(PipRun{i, j, hash});
+        i = j;
+    }
+    std::vector<const RoutingCacheEntry *> run_entries(runs.size(), nullptr);
+    std::vector<size_t> missing;
+    size_t missing_pips = 0;
+    for (size_t i = 0; i < runs.size(); i++) {
+        Location loc = bound_pips.at(runs.at(i).begin).location;
+        auto fnd = routing_cache.find(std::make_pair(int(loc.y), int(loc.x)));
+        if (fnd != routing_cache.end() && fnd->second.pips_hash == runs.at(i).hash) {
+            run_entries.at(i) = &fnd->second;
+        } else {
+            missing.push_back(i);
+            missing_pips += runs.at(i).end - runs.at(i).begin;
+        }
+    }
+    auto compute_run = [&](const PipRun &run) {
+        ChipConfig shard;
+        for (size_t i = run.begin; i < run.end; i++)
+            set_config_pip(ctx, shard, bound_pips.at(i));
+        std::map<std::string, std::vector<ConfigArc>> result;
+        for (auto &tile : shard.tiles)
+            result[tile.first] = std::move(tile.second.carcs);
+        return result;
+    };
+    typedef std::vector<std::pair<size_t, std::map<std::string, std::vector<ConfigArc>>>> RunResults;
+    RunResults computed;
+    if (missing_pips >= 20000 && ThreadPool::get().num_workers() > 1) {
+        computed = ThreadPool::get().reduce_chunks(
+                missing.size(), 64, RunResults{},
+                [&](size_t begin, size_t end) {
+                    RunResults result;
+                    for (size_t i = begin; i < end; i++)
+                        result.emplace_back(missing.at(i), compute_run(runs.at(missing.at(i))));
+                    return result;
+                },
+                [](RunResults a, RunResults b) {
+                    a.insert(a.end(), std::make_move_iterator(b.begin()), std::make_move_iterator(b.end()));
+                    return a;
+                });
+    } else {
+        for (size_t i : missing)
+            computed.emplace_back(i, compute_run(runs.at(i)));
+    }
+    for (auto &result : computed) {
+        const PipRun &run = runs.at(result.first);
+        Location loc = bound_pips.at(run.begin).location;
+        // std::map references are stable, so earlier hits stay valid
+        RoutingCacheEntry &entry = routing_cache[std::make_pair(int(loc.y), int(loc.x))];
+        entry.pips_hash = run.hash;
+        entry.tile_arcs = std::move(result.second);
+        run_entries.at(result.first) = &entry;
+    }
+    for (const RoutingCacheEntry *entry : run_entries) {
+        for (auto &tile : entry->tile_arcs) {
+            auto &arcs = cc.tiles[tile.first].carcs;
+            arcs.insert(arcs.end(), tile.second.begin(), tile.second.end());
         }
     }
     // Find bank voltages
@@ -829,6 +1047,9 @@ void write_bitstream(Context *ctx, std::string base_config_file, std::string tex
     }
 
     // Configure slices
+    // Memoizes init permutations; synthesized designs repeat a few distinct
+    // LUT functions and input orders across many slices
+    LutMappingCache lutperm_cache;
     for (auto &cell : ctx->cells) {
         CellInfo *ci = cell.second.get();
         if (ci->bel == BelId()) {
@@ -841,10 +1062,12 @@ void write_bitstream(Context *ctx, std::string base_config_file, std::string tex
             std::string slice = ctx->loc_info(bel)->bel_data[bel.index].name.get();
             int lut0_init = int_or_default(ci->params, ctx->id("LUT0_INITVAL"));
             int lut1_init = int_or_default(ci->params, ctx->id("LUT1_INITVAL"));
-            cc.tiles[tname].add_word(slice + ".K0.INIT",
-                                     int_to_bitvector(permute_lut(ctx, ci, used_phys_pins, 0, lut0_init), 16));
-            cc.tiles[tname].add_word(slice + ".K1.INIT",
-                                     int_to_bitvector(permute_lut(ctx, ci, used_phys_pins, 1, lut1_init), 16));
+            cc.tiles[tname].add_word(
+                    slice + ".K0.INIT",
+                    int_to_bitvector(permute_lut(ctx, lutperm_cache, ci, used_phys_pins, 0, lut0_init), 16));
+            cc.tiles[tname].add_word(
+                    slice + ".K1.INIT",
+                    int_to_bitvector(permute_lut(ctx, lutperm_cache, ci, used_phys_pins, 1, lut1_init), 16));
             cc.tiles[tname].add_enum(slice + ".MODE", str_or_default(ci->params, ctx->id("MODE"), "LOGIC"));
             cc.tiles[tname].add_enum(slice + ".GSR", str_or_default(ci->params, ctx->id("GSR"), "ENABLED"));
             cc.tiles[tname].add_enum(slice + ".REG0.SD", intstr_or_default(ci->params, ctx->id("REG0_SD"), "0"));
@@ -1195,12 +1418,14 @@ void write_bitstream(Context *ctx, std::string base_config_file, std::string tex
             for (int i = 0; i <= 0x3F; i++) {
                 IdString param = ctx->id("INITVAL_" +
                                          fmt_str(std::hex << std::uppercase << std::setw(2) << std::setfill('0') << i));
-                auto value = parse_init_str(get_or_default(ci->params, param, Property(0)), 320, ci->name.c_str(ctx));
+                if (!ci->params.count(param))
+                    continue;
+                auto value = parse_init_words(ci->params.at(param), 320);
                 for (int j = 0; j < 16; j++) {
                     // INIT parameter consists of 16 18-bit words with 2-bit padding
                     int ofs = 20 * j;
                     for (int k = 0; k < 18; k++) {
-                        if (value.at(ofs + k))
+                        if ((value.at((ofs + k) / 64) >> ((ofs + k) % 64)) & 1)
                             init_data.at(i * 32 + j * 2 + (k / 9)) |= (1 << (k % 9));
                     }
                 }
@@ -1305,20 +1530,20 @@ void write_bitstream(Context *ctx, std::string base_config_file, std::string tex
             tg.config.add_enum(dsp + ".MASKPAT_SOURCE",
                                str_or_default(ci->params, ctx->id("MASKPAT_SOURCE"), "STATIC"));
             tg.config.add_word(dsp + ".MASK01",
-                               parse_init_str(str_or_default(ci->params, ctx->id("MASK01"), "0x00000000000000"), 56,
+                               parse_init_str(get_or_default(ci->params, ctx->id("MASK01"), Property(0, 56)), 56,
                                               ci->name.c_str(ctx)));
             tg.config.add_enum(dsp + ".CLK0_DIV", str_or_default(ci->params, ctx->id("CLK0_DIV"), "ENABLED"));
             tg.config.add_enum(dsp + ".CLK1_DIV", str_or_default(ci->params, ctx->id("CLK1_DIV"), "ENABLED"));
             tg.config.add_enum(dsp + ".CLK2_DIV", str_or_default(ci->params, ctx->id("CLK2_DIV"), "ENABLED"));
             tg.config.add_enum(dsp + ".CLK3_DIV", str_or_default(ci->params, ctx->id("CLK3_DIV"), "ENABLED"));
             tg.config.add_word(dsp + ".MCPAT",
-                               parse_init_str(str_or_default(ci->params, ctx->id("MCPAT"), "0x00000000000000"), 56,
+                               parse_init_str(get_or_default(ci->params, ctx->id("MCPAT"), Property(0, 56)), 56,
                                               ci->name.c_str(ctx)));
             tg.config.add_word(dsp + ".MASKPAT",
-                               parse_init_str(str_or_default(ci->params, ctx->id("MASKPAT"), "0x00000000000000"), 56,
+                               parse_init_str(get_or_default(ci->params, ctx->id("MASKPAT"), Property(0, 56)), 56,
                                               ci->name.c_str(ctx)));
             tg.config.add_word(dsp + ".RNDPAT",
-                               parse_init_str(str_or_default(ci->params, ctx->id("RNDPAT"), "0x00000000000000"), 56,
+                               parse_init_str(get_or_default(ci->params, ctx->id("RNDPAT"), Property(0, 56)), 56,
                                               ci->name.c_str(ctx)));
             tg.config.add_enum(dsp + ".GSR", str_or_default(ci->params, ctx->id("GSR"), "ENABLED"));
             tg.config.add_enum(dsp + ".RESETMODE", str_or_default(ci->params, ctx->id("RESETMODE"), "SYNC"));
@@ -1598,9 +1823,16 @@ void write_bitstream(Context *ctx, std::string base_config_file, std::string tex
 
     // Fixup tile names
     fix_tile_names(ctx, cc);
+    if (bool_or_default(ctx->settings, ctx->id("arch.verify_bitstream")))
+        verify_routing_config(ctx, cc);
     // Configure chip
     if (!text_config_file.empty()) {
-        std::ofstream out_config(text_config_file);
+        // The textcfg serializer emits many small writes, so give the stream
+        // a large buffer (set before open, as required for it to take effect)
+        std::vector<char> write_buf(1 << 22);
+        std::ofstream out_config;
+        out_config.rdbuf()->pubsetbuf(write_buf.data(), write_buf.size());
+        out_config.open(text_config_file);
         out_config << cc;
     }
 }
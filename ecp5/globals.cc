@@ -22,6 +22,7 @@
 #include <iomanip>
 #include <queue>
 #include "cells.h"
+#include "design_utils.h"
 #include "log.h"
 #include "nextpnr.h"
 #include "place_common.h"
@@ -72,44 +73,54 @@ class Ecp5GlobalRouter
 
     std::vector<NetInfo *> get_clocks()
     {
-        dict<IdString, int> clockCount;
+        // Score every net by its clock-type fanout in a single pass; nets
+        // with no clock loads can never be promoted (the threshold below is
+        // 5) so they are not kept as candidates at all
+        std::vector<std::pair<NetInfo *, int>> candidates;
         for (auto &net : ctx->nets) {
             NetInfo *ni = net.second.get();
             if (ni->name == ctx->id("$PACKER_GND_NET") || ni->name == ctx->id("$PACKER_VCC_NET") ||
                 ni->driver.cell == nullptr)
                 continue;
-            clockCount[ni->name] = 0;
+            int count = 0;
             for (const auto &user : ni->users) {
                 if (is_clock_port(user)) {
-                    clockCount[ni->name]++;
+                    count++;
                     if (user.cell->type == id_DCUA)
-                        clockCount[ni->name] += 100;
+                        count += 100;
                     if (user.cell->type == id_IOLOGIC || user.cell->type == id_SIOLOGIC)
-                        clockCount[ni->name] += 10;
+                        count += 10;
                 }
             }
-            // log_info("clkcount %s: %d\n", ni->name.c_str(ctx),clockCount[ni->name]);
+            if (count > 0)
+                candidates.emplace_back(ni, count);
         }
         // DCCAs must always drive globals
         std::vector<NetInfo *> clocks;
+        pool<IdString> dcca_driven;
         for (auto &cell : ctx->cells) {
             CellInfo *ci = cell.second.get();
             if (ci->type == id_DCCA) {
                 NetInfo *glb = ci->ports.at(id_CLKO).net;
                 if (glb != nullptr) {
                     clocks.push_back(glb);
-                    clockCount.erase(glb->name);
+                    dcca_driven.insert(glb->name);
                 }
             }
         }
-        while (clocks.size() < 16) {
-            auto max = std::max_element(clockCount.begin(), clockCount.end(),
-                                        [](const decltype(clockCount)::value_type &a,
-                                           const decltype(clockCount)::value_type &b) { return a.second < b.second; });
-            if (max == clockCount.end() || max->second < 5)
+        // Sort candidates by fanout once rather than rescanning all nets per
+        // global; the stable sort keeps net iteration order for equal counts,
+        // matching the repeated max-element selection this replaces
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const std::pair<NetInfo *, int> &a, const std::pair<NetInfo *, int> &b) {
+                             return a.second > b.second;
+                         });
+        for (const auto &cand : candidates) {
+            if (clocks.size() >= 16 || cand.second < 5)
                 break;
-            clocks.push_back(ctx->nets.at(max->first).get());
-            clockCount.erase(max->first);
+            if (dcca_driven.count(cand.first->name))
+                continue;
+            clocks.push_back(cand.first);
         }
         return clocks;
     }
@@ -461,23 +472,17 @@ class Ecp5GlobalRouter
             glbnet->driver.cell = dcc.get();
             glbnet->driver.port = id_CLKO;
             dcc->ports[id_CLKO].net = glbnet.get();
-            std::vector<PortRef> keep_users;
-            for (auto user : net->users) {
-                if (dcs_cell != nullptr && user.cell != dcs_cell) {
-                    // DCS DCC insertion mode
-                    keep_users.push_back(user);
-                } else if (user.port == id_CLKFB) {
-                    keep_users.push_back(user);
-                } else if (net->driver.cell->type == id_EXTREFB && user.cell->type == id_DCUA) {
-                    keep_users.push_back(user);
-                } else if (is_logic_port(user)) {
-                    keep_users.push_back(user);
-                } else {
-                    glbnet->users.push_back(user);
-                    user.cell->ports.at(user.port).net = glbnet.get();
-                }
-            }
-            net->users = keep_users;
+            move_net_users(net, glbnet.get(), [&](const PortRef &user) {
+                if (dcs_cell != nullptr && user.cell != dcs_cell)
+                    return false; // DCS DCC insertion mode
+                if (user.port == id_CLKFB)
+                    return false;
+                if (net->driver.cell->type == id_EXTREFB && user.cell->type == id_DCUA)
+                    return false;
+                if (is_logic_port(user))
+                    return false;
+                return true;
+            });
 
             dcc->ports[id_CLKI].net = net;
             PortRef clki_pr;
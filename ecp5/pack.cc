@@ -26,6 +26,8 @@
 #include "design_utils.h"
 #include "globals.h"
 #include "log.h"
+#include "lut_mapping_cache.h"
+#include "threadpool.h"
 #include "timing.h"
 #include "util.h"
 NEXTPNR_NAMESPACE_BEGIN
@@ -182,30 +184,68 @@ class Ecp5Packer
             return fnd->second.net;
     }
 
+    // The control set of a flipflop; two FFs can share a slice iff these match
+    struct FFControlSet
+    {
+        std::string gsr, srmode, cemux, lsrmux, clkmux;
+        const NetInfo *clk, *ce, *lsr;
+
+        bool operator==(const FFControlSet &other) const
+        {
+            return gsr == other.gsr && srmode == other.srmode && cemux == other.cemux && lsrmux == other.lsrmux &&
+                   clkmux == other.clkmux && clk == other.clk && ce == other.ce && lsr == other.lsr;
+        }
+    };
+
+    FFControlSet get_ff_ctrlset(CellInfo *ff)
+    {
+        FFControlSet ctrl;
+        ctrl.gsr = str_or_default(ff->params, ctx->id("GSR"), "DISABLED");
+        ctrl.srmode = str_or_default(ff->params, ctx->id("SRMODE"), "LSR_OVER_CE");
+        ctrl.cemux = str_or_default(ff->params, ctx->id("CEMUX"), "1");
+        ctrl.lsrmux = str_or_default(ff->params, ctx->id("LSRMUX"), "LSR");
+        ctrl.clkmux = str_or_default(ff->params, ctx->id("CLKMUX"), "CLK");
+        ctrl.clk = net_or_nullptr(ff, ctx->id("CLK"));
+        ctrl.ce = net_or_nullptr(ff, ctx->id("CE"));
+        ctrl.lsr = net_or_nullptr(ff, ctx->id("LSR"));
+        return ctrl;
+    }
+
+    // Precompute the control sets of the FFs considered during LUT pairing,
+    // so the pairing scan compares two cached sets per candidate pair rather
+    // than re-reading five parameters and three nets of each FF. The per-FF
+    // classification only reads the netlist, so it is farmed out to worker
+    // threads; pairing itself stays serial as it is greedy and order-dependent
+    void classify_lutff_ffs()
+    {
+        std::vector<CellInfo *> ffs;
+        for (auto &pair : fflutPairs)
+            ffs.push_back(ctx->cells.at(pair.first).get());
+        std::vector<FFControlSet> ctrlsets(ffs.size());
+        if (int(ffs.size()) >= 10000 && ThreadPool::get().num_workers() > 1) {
+            // Make sure the IdStrings that get_ff_ctrlset looks up are
+            // interned before the parallel (read-only) phase
+            for (const char *s : {"GSR", "SRMODE", "CEMUX", "LSRMUX", "CLKMUX", "CLK", "CE", "LSR"})
+                ctx->id(s);
+            ThreadPool::get().run_chunks(ffs.size(), 512, [&](size_t begin, size_t end) {
+                for (size_t j = begin; j < end; j++)
+                    ctrlsets.at(j) = get_ff_ctrlset(ffs.at(j));
+            });
+        } else {
+            for (size_t j = 0; j < ffs.size(); j++)
+                ctrlsets.at(j) = get_ff_ctrlset(ffs.at(j));
+        }
+        for (size_t j = 0; j < ffs.size(); j++)
+            ff_ctrlsets[ffs.at(j)->name] = ctrlsets.at(j);
+    }
+
     // Return whether two FFs can be packed together in the same slice
     bool can_pack_ffs(CellInfo *ff0, CellInfo *ff1)
     {
-        if (str_or_default(ff0->params, ctx->id("GSR"), "DISABLED") !=
-            str_or_default(ff1->params, ctx->id("GSR"), "DISABLED"))
-            return false;
-        if (str_or_default(ff0->params, ctx->id("SRMODE"), "LSR_OVER_CE") !=
-            str_or_default(ff1->params, ctx->id("SRMODE"), "LSR_OVER_CE"))
-            return false;
-        if (str_or_default(ff0->params, ctx->id("CEMUX"), "1") != str_or_default(ff1->params, ctx->id("CEMUX"), "1"))
-            return false;
-        if (str_or_default(ff0->params, ctx->id("LSRMUX"), "LSR") !=
-            str_or_default(ff1->params, ctx->id("LSRMUX"), "LSR"))
-            return false;
-        if (str_or_default(ff0->params, ctx->id("CLKMUX"), "CLK") !=
-            str_or_default(ff1->params, ctx->id("CLKMUX"), "CLK"))
-            return false;
-        if (net_or_nullptr(ff0, ctx->id("CLK")) != net_or_nullptr(ff1, ctx->id("CLK")))
-            return false;
-        if (net_or_nullptr(ff0, ctx->id("CE")) != net_or_nullptr(ff1, ctx->id("CE")))
-            return false;
-        if (net_or_nullptr(ff0, ctx->id("LSR")) != net_or_nullptr(ff1, ctx->id("LSR")))
-            return false;
-        return true;
+        auto c0 = ff_ctrlsets.find(ff0->name), c1 = ff_ctrlsets.find(ff1->name);
+        if (c0 != ff_ctrlsets.end() && c1 != ff_ctrlsets.end())
+            return c0->second == c1->second;
+        return get_ff_ctrlset(ff0) == get_ff_ctrlset(ff1);
     }
 
     // Return whether or not an FF can be added to a tile (pairing checks must also be done using the fn above)
@@ -250,6 +290,9 @@ class Ecp5Packer
     {
         auto ff0 = lutffPairs.find(lut0), ff1 = lutffPairs.find(lut1);
         if (ff0 != lutffPairs.end() && ff1 != lutffPairs.end()) {
+            auto c0 = ff_ctrlsets.find(ff0->second), c1 = ff_ctrlsets.find(ff1->second);
+            if (c0 != ff_ctrlsets.end() && c1 != ff_ctrlsets.end())
+                return c0->second == c1->second;
             return can_pack_ffs(ctx->cells.at(ff0->second).get(), ctx->cells.at(ff1->second).get());
         } else {
             return true;
@@ -260,6 +303,7 @@ class Ecp5Packer
     void pair_luts()
     {
         log_info("Finding LUT-LUT pairs...\n");
+        classify_lutff_ffs();
         pool<IdString> procdLuts;
         for (auto &cell : ctx->cells) {
             CellInfo *ci = cell.second.get();
@@ -879,11 +923,8 @@ class Ecp5Packer
     {
         log_info("Packing carries...\n");
         // Find all chains (including single carry cells)
-        auto carry_chains = find_chains(
+        auto carry_chains = find_chains_indexed(
                 ctx, [](const Context *ctx, const CellInfo *cell) { return is_carry(ctx, cell); },
-                [](const Context *ctx, const CellInfo *cell) {
-                    return net_driven_by(ctx, cell->ports.at(ctx->id("CIN")).net, is_carry, ctx->id("COUT"));
-                },
                 [](const Context *ctx, const CellInfo *cell) {
                     return net_only_drives(ctx, cell->ports.at(ctx->id("COUT")).net, is_carry, ctx->id("CIN"), false);
                 },
@@ -1246,18 +1287,7 @@ class Ecp5Packer
 
     int make_init_with_const_input(int init, int input, bool value)
     {
-        int new_init = 0;
-        for (int i = 0; i < 16; i++) {
-            if (((i >> input) & 0x1) != value) {
-                int other_i = (i & (~(1 << input))) | (value << input);
-                if ((init >> other_i) & 0x1)
-                    new_init |= (1 << i);
-            } else {
-                if ((init >> i) & 0x1)
-                    new_init |= (1 << i);
-            }
-        }
-        return new_init;
+        return int(lut_cache.constant_input_init(4, uint64_t(unsigned(init)), input, value));
     }
 
     void set_lut_input_constant(CellInfo *cell, IdString input, bool value)
@@ -1460,159 +1490,151 @@ class Ecp5Packer
             c->params[n] = c->params[o];
             c->params.erase(o);
         };
-        for (auto &cell : ctx->cells) {
-            CellInfo *ci = cell.second.get();
-            // Convert 36-bit PDP RAMs to regular 18-bit DP ones that match the Bel
-            if (ci->type == ctx->id("PDPW16KD")) {
-                ci->params[ctx->id("DATA_WIDTH_A")] = 36; // force PDP mode
-                ci->params.erase(ctx->id("DATA_WIDTH_W"));
-                rename_bus(ci, "BE", "ADA", 4, 0, 0);
-                rename_bus(ci, "ADW", "ADA", 9, 0, 5);
-                rename_bus(ci, "ADR", "ADB", 14, 0, 0);
-                rename_bus(ci, "CSW", "CSA", 3, 0, 0);
-                rename_bus(ci, "CSR", "CSB", 3, 0, 0);
-                rename_bus(ci, "DI", "DIA", 18, 0, 0);
-                rename_bus(ci, "DI", "DIB", 18, 18, 0);
-                rename_bus(ci, "DO", "DOA", 18, 18, 0);
-                rename_bus(ci, "DO", "DOB", 18, 0, 0);
-                rename_port(ctx, ci, ctx->id("CLKW"), ctx->id("CLKA"));
-                rename_port(ctx, ci, ctx->id("CLKR"), ctx->id("CLKB"));
-                rename_port(ctx, ci, ctx->id("CEW"), ctx->id("CEA"));
-                rename_port(ctx, ci, ctx->id("CER"), ctx->id("CEB"));
-                rename_port(ctx, ci, ctx->id("OCER"), ctx->id("OCEB"));
-                rename_param(ci, "CLKWMUX", "CLKAMUX");
-                if (str_or_default(ci->params, ctx->id("CLKAMUX")) == "CLKW")
-                    ci->params[ctx->id("CLKAMUX")] = std::string("CLKA");
-                if (str_or_default(ci->params, ctx->id("CLKBMUX")) == "CLKR")
-                    ci->params[ctx->id("CLKBMUX")] = std::string("CLKB");
-                rename_param(ci, "CLKRMUX", "CLKRMUX");
-                rename_param(ci, "CSDECODE_W", "CSDECODE_A");
-                rename_param(ci, "CSDECODE_R", "CSDECODE_B");
-                std::string outreg = str_or_default(ci->params, ctx->id("REGMODE"), "NOREG");
-                ci->params[ctx->id("REGMODE_A")] = outreg;
-                ci->params[ctx->id("REGMODE_B")] = outreg;
-                ci->params.erase(ctx->id("REGMODE"));
-                rename_param(ci, "DATA_WIDTH_R", "DATA_WIDTH_B");
-                if (ci->ports.count(id_RST)) {
-                    autocreate_empty_port(ci, id_RSTA);
-                    autocreate_empty_port(ci, id_RSTB);
-                    NetInfo *rst = ci->ports.at(id_RST).net;
-                    connect_port(ctx, rst, ci, id_RSTA);
-                    connect_port(ctx, rst, ci, id_RSTB);
-                    disconnect_port(ctx, ci, id_RST);
-                    ci->ports.erase(id_RST);
-                }
-                ci->type = id_DP16KD;
+        // Convert 36-bit PDP RAMs to regular 18-bit DP ones that match the Bel
+        for (CellInfo *ci : ctx->cellsOfType(ctx->id("PDPW16KD"))) {
+            ci->params[ctx->id("DATA_WIDTH_A")] = 36; // force PDP mode
+            ci->params.erase(ctx->id("DATA_WIDTH_W"));
+            rename_bus(ci, "BE", "ADA", 4, 0, 0);
+            rename_bus(ci, "ADW", "ADA", 9, 0, 5);
+            rename_bus(ci, "ADR", "ADB", 14, 0, 0);
+            rename_bus(ci, "CSW", "CSA", 3, 0, 0);
+            rename_bus(ci, "CSR", "CSB", 3, 0, 0);
+            rename_bus(ci, "DI", "DIA", 18, 0, 0);
+            rename_bus(ci, "DI", "DIB", 18, 18, 0);
+            rename_bus(ci, "DO", "DOA", 18, 18, 0);
+            rename_bus(ci, "DO", "DOB", 18, 0, 0);
+            rename_port(ctx, ci, ctx->id("CLKW"), ctx->id("CLKA"));
+            rename_port(ctx, ci, ctx->id("CLKR"), ctx->id("CLKB"));
+            rename_port(ctx, ci, ctx->id("CEW"), ctx->id("CEA"));
+            rename_port(ctx, ci, ctx->id("CER"), ctx->id("CEB"));
+            rename_port(ctx, ci, ctx->id("OCER"), ctx->id("OCEB"));
+            rename_param(ci, "CLKWMUX", "CLKAMUX");
+            if (str_or_default(ci->params, ctx->id("CLKAMUX")) == "CLKW")
+                ci->params[ctx->id("CLKAMUX")] = std::string("CLKA");
+            if (str_or_default(ci->params, ctx->id("CLKBMUX")) == "CLKR")
+                ci->params[ctx->id("CLKBMUX")] = std::string("CLKB");
+            rename_param(ci, "CLKRMUX", "CLKRMUX");
+            rename_param(ci, "CSDECODE_W", "CSDECODE_A");
+            rename_param(ci, "CSDECODE_R", "CSDECODE_B");
+            std::string outreg = str_or_default(ci->params, ctx->id("REGMODE"), "NOREG");
+            ci->params[ctx->id("REGMODE_A")] = outreg;
+            ci->params[ctx->id("REGMODE_B")] = outreg;
+            ci->params.erase(ctx->id("REGMODE"));
+            rename_param(ci, "DATA_WIDTH_R", "DATA_WIDTH_B");
+            if (ci->ports.count(id_RST)) {
+                autocreate_empty_port(ci, id_RSTA);
+                autocreate_empty_port(ci, id_RSTB);
+                NetInfo *rst = ci->ports.at(id_RST).net;
+                connect_port(ctx, rst, ci, id_RSTA);
+                connect_port(ctx, rst, ci, id_RSTB);
+                disconnect_port(ctx, ci, id_RST);
+                ci->ports.erase(id_RST);
             }
+            ctx->retypeCell(*ci, id_DP16KD);
         }
-        for (auto &cell : ctx->cells) {
-            CellInfo *ci = cell.second.get();
-            if (ci->type == id_DP16KD) {
-                // Add ports, even if disconnected, to ensure correct tie-offs
-                for (int i = 0; i < 14; i++) {
-                    autocreate_empty_port(ci, ctx->id("ADA" + std::to_string(i)));
-                    autocreate_empty_port(ci, ctx->id("ADB" + std::to_string(i)));
-                }
-                for (int i = 0; i < 18; i++) {
-                    autocreate_empty_port(ci, ctx->id("DIA" + std::to_string(i)));
-                    autocreate_empty_port(ci, ctx->id("DIB" + std::to_string(i)));
-                }
-                for (int i = 0; i < 3; i++) {
-                    autocreate_empty_port(ci, ctx->id("CSA" + std::to_string(i)));
-                    autocreate_empty_port(ci, ctx->id("CSB" + std::to_string(i)));
-                }
-                for (int i = 0; i < 3; i++) {
-                    autocreate_empty_port(ci, ctx->id("CSA" + std::to_string(i)));
-                    autocreate_empty_port(ci, ctx->id("CSB" + std::to_string(i)));
-                }
+        for (CellInfo *ci : ctx->cellsOfType(id_DP16KD)) {
+            // Add ports, even if disconnected, to ensure correct tie-offs
+            for (int i = 0; i < 14; i++) {
+                autocreate_empty_port(ci, ctx->id("ADA" + std::to_string(i)));
+                autocreate_empty_port(ci, ctx->id("ADB" + std::to_string(i)));
+            }
+            for (int i = 0; i < 18; i++) {
+                autocreate_empty_port(ci, ctx->id("DIA" + std::to_string(i)));
+                autocreate_empty_port(ci, ctx->id("DIB" + std::to_string(i)));
+            }
+            for (int i = 0; i < 3; i++) {
+                autocreate_empty_port(ci, ctx->id("CSA" + std::to_string(i)));
+                autocreate_empty_port(ci, ctx->id("CSB" + std::to_string(i)));
+            }
+            for (int i = 0; i < 3; i++) {
+                autocreate_empty_port(ci, ctx->id("CSA" + std::to_string(i)));
+                autocreate_empty_port(ci, ctx->id("CSB" + std::to_string(i)));
+            }
 
-                autocreate_empty_port(ci, id_CLKA);
-                autocreate_empty_port(ci, id_CEA);
-                autocreate_empty_port(ci, id_OCEA);
-                autocreate_empty_port(ci, id_WEA);
-                autocreate_empty_port(ci, id_RSTA);
+            autocreate_empty_port(ci, id_CLKA);
+            autocreate_empty_port(ci, id_CEA);
+            autocreate_empty_port(ci, id_OCEA);
+            autocreate_empty_port(ci, id_WEA);
+            autocreate_empty_port(ci, id_RSTA);
 
-                autocreate_empty_port(ci, id_CLKB);
-                autocreate_empty_port(ci, id_CEB);
-                autocreate_empty_port(ci, id_OCEB);
-                autocreate_empty_port(ci, id_WEB);
-                autocreate_empty_port(ci, id_RSTB);
+            autocreate_empty_port(ci, id_CLKB);
+            autocreate_empty_port(ci, id_CEB);
+            autocreate_empty_port(ci, id_OCEB);
+            autocreate_empty_port(ci, id_WEB);
+            autocreate_empty_port(ci, id_RSTB);
 
-                ci->attrs[ctx->id("WID")] = wid++;
-            }
+            ci->attrs[ctx->id("WID")] = wid++;
         }
     }
 
     // Pack DSPs
     void pack_dsps()
     {
-        for (auto &cell : ctx->cells) {
-            CellInfo *ci = cell.second.get();
-            if (ci->type == id_MULT18X18D) {
-                // Add ports, even if disconnected, to ensure correct tie-offs
-                for (auto sig : {"CLK", "CE", "RST"})
-                    for (int i = 0; i < 4; i++)
-                        autocreate_empty_port(ci, ctx->id(sig + std::to_string(i)));
-                for (auto sig : {"SIGNED", "SOURCE"})
-                    for (auto c : {"A", "B"})
-                        autocreate_empty_port(ci, ctx->id(sig + std::string(c)));
-                for (auto port : {"A", "B", "C"})
-                    for (int i = 0; i < 18; i++)
-                        autocreate_empty_port(ci, ctx->id(port + std::to_string(i)));
-                for (auto port : {"SRIA", "SRIB"})
-                    for (int i = 0; i < 18; i++)
-                        autocreate_empty_port(ci, ctx->id(port + std::to_string(i)));
-            } else if (ci->type == id_ALU54B) {
-                for (auto sig : {"CLK", "CE", "RST"})
-                    for (int i = 0; i < 4; i++)
-                        autocreate_empty_port(ci, ctx->id(sig + std::to_string(i)));
-                autocreate_empty_port(ci, id_SIGNEDIA);
-                autocreate_empty_port(ci, id_SIGNEDIB);
-                autocreate_empty_port(ci, id_SIGNEDCIN);
-                for (auto port : {"A", "B", "MA", "MB"})
-                    for (int i = 0; i < 36; i++)
-                        autocreate_empty_port(ci, ctx->id(port + std::to_string(i)));
-                for (auto port : {"C", "CFB", "CIN"})
-                    for (int i = 0; i < 54; i++)
-                        autocreate_empty_port(ci, ctx->id(port + std::to_string(i)));
-                for (int i = 0; i < 11; i++)
-                    autocreate_empty_port(ci, ctx->id("OP" + std::to_string(i)));
-
-                // Find the MULT18X18Ds feeding this ALU54B's MA and MB inputs.
-                CellInfo *mult_a = nullptr;
-                CellInfo *mult_b = nullptr;
-                for (auto port : {id_MA0, id_MB0}) {
-                    CellInfo *mult = net_driven_by(
-                            ctx, ci->ports.at(port).net,
-                            [](const Context *ctx, const CellInfo *cell) { return cell->type == id_MULT18X18D; },
-                            id_P0);
-
-                    // We'll handle the mult not existing in check_alu below.
-                    if (mult == nullptr)
-                        break;
-
-                    // Set relative constraint depending on ALU port.
-                    if (port == id_MA0) {
-                        mult->constr_x = mult->constr_z = -3;
-                        mult_a = mult;
-                    } else if (port == id_MB0) {
-                        mult->constr_x = mult->constr_z = -2;
-                        mult_b = mult;
-                    }
-                    mult->constr_y = 0;
-                    mult->cluster = ci->name;
-                    ci->constr_x = 0;
-                    ci->constr_y = 0;
-                    ci->constr_z = 0;
-                    ci->cluster = ci->name;
-                    ci->constr_children.push_back(mult);
-                    log_info("DSP: Constraining MULT18X18D '%s' to ALU54B '%s' port %s\n", mult->name.c_str(ctx),
-                             cell.first.c_str(ctx), ctx->nameOf(port));
-                }
+        for (CellInfo *ci : ctx->cellsOfType(id_MULT18X18D)) {
+            // Add ports, even if disconnected, to ensure correct tie-offs
+            for (auto sig : {"CLK", "CE", "RST"})
+                for (int i = 0; i < 4; i++)
+                    autocreate_empty_port(ci, ctx->id(sig + std::to_string(i)));
+            for (auto sig : {"SIGNED", "SOURCE"})
+                for (auto c : {"A", "B"})
+                    autocreate_empty_port(ci, ctx->id(sig + std::string(c)));
+            for (auto port : {"A", "B", "C"})
+                for (int i = 0; i < 18; i++)
+                    autocreate_empty_port(ci, ctx->id(port + std::to_string(i)));
+            for (auto port : {"SRIA", "SRIB"})
+                for (int i = 0; i < 18; i++)
+                    autocreate_empty_port(ci, ctx->id(port + std::to_string(i)));
+        }
+        for (CellInfo *ci : ctx->cellsOfType(id_ALU54B)) {
+            for (auto sig : {"CLK", "CE", "RST"})
+                for (int i = 0; i < 4; i++)
+                    autocreate_empty_port(ci, ctx->id(sig + std::to_string(i)));
+            autocreate_empty_port(ci, id_SIGNEDIA);
+            autocreate_empty_port(ci, id_SIGNEDIB);
+            autocreate_empty_port(ci, id_SIGNEDCIN);
+            for (auto port : {"A", "B", "MA", "MB"})
+                for (int i = 0; i < 36; i++)
+                    autocreate_empty_port(ci, ctx->id(port + std::to_string(i)));
+            for (auto port : {"C", "CFB", "CIN"})
+                for (int i = 0; i < 54; i++)
+                    autocreate_empty_port(ci, ctx->id(port + std::to_string(i)));
+            for (int i = 0; i < 11; i++)
+                autocreate_empty_port(ci, ctx->id("OP" + std::to_string(i)));
+
+            // Find the MULT18X18Ds feeding this ALU54B's MA and MB inputs.
+            CellInfo *mult_a = nullptr;
+            CellInfo *mult_b = nullptr;
+            for (auto port : {id_MA0, id_MB0}) {
+                CellInfo *mult = net_driven_by(
+                        ctx, ci->ports.at(port).net,
+                        [](const Context *ctx, const CellInfo *cell) { return cell->type == id_MULT18X18D; },
+                        id_P0);
+
+                // We'll handle the mult not existing in check_alu below.
+                if (mult == nullptr)
+                    break;
 
-                // Check existance of, and connectivity to, each MULT.
-                check_alu(ci, mult_a, mult_b);
+                // Set relative constraint depending on ALU port.
+                if (port == id_MA0) {
+                    mult->constr_x = mult->constr_z = -3;
+                    mult_a = mult;
+                } else if (port == id_MB0) {
+                    mult->constr_x = mult->constr_z = -2;
+                    mult_b = mult;
+                }
+                mult->constr_y = 0;
+                mult->cluster = ci->name;
+                ci->constr_x = 0;
+                ci->constr_y = 0;
+                ci->constr_z = 0;
+                ci->cluster = ci->name;
+                ci->constr_children.push_back(mult);
+                log_info("DSP: Constraining MULT18X18D '%s' to ALU54B '%s' port %s\n", mult->name.c_str(ctx),
+                         ci->name.c_str(ctx), ctx->nameOf(port));
             }
+
+            // Check existance of, and connectivity to, each MULT.
+            check_alu(ci, mult_a, mult_b);
         }
     }
 
@@ -1707,132 +1729,268 @@ class Ecp5Packer
         }
     }
 
+    // Cluster cascade-connected DSP cells so the placer only explores
+    // placements the dedicated cascade wires can actually reach, instead of
+    // leaving the router to discover arc by arc that a cascade chain was
+    // scattered across the fabric. The relative placement of each link is
+    // derived from the routing graph via get_cascade_neighbour rather than
+    // from hardcoded tile offsets.
+    void pack_dsp_cascades()
+    {
+        // Recognised dedicated cascades: the SROA/SROB->SRIA/SRIB shift
+        // chains between MULT18X18Ds and the CO->CIN carry cascade between
+        // ALU54Bs. Matching on bit 0 of the bus is enough to identify the
+        // connection
+        struct CascadeRule
+        {
+            IdString cell_type, src_port, dst_port;
+        };
+        const CascadeRule rules[] = {
+                {id_MULT18X18D, id_SROA0, id_SRIA0},
+                {id_MULT18X18D, id_SROB0, id_SRIB0},
+                {id_ALU54B, id_CO0, id_CIN0},
+        };
+
+        // A cell is a chain link when its cascade input is driven by the
+        // cascade output of another cell of the same type. Both maps are
+        // functional (at most one neighbour each way), so chains are simple
+        // paths
+        dict<IdString, std::pair<CellInfo *, const CascadeRule *>> upstream_of;
+        dict<IdString, CellInfo *> downstream_of;
+        for (auto &rule : rules) {
+            for (CellInfo *ci : ctx->cellsOfType(rule.cell_type)) {
+                if (!ci->ports.count(rule.dst_port))
+                    continue;
+                NetInfo *net = ci->ports.at(rule.dst_port).net;
+                if (net == nullptr || net->driver.cell == nullptr)
+                    continue;
+                CellInfo *drv = net->driver.cell;
+                if (drv->type != rule.cell_type || net->driver.port != rule.src_port)
+                    continue;
+                auto fnd_up = upstream_of.find(ci->name);
+                if (fnd_up != upstream_of.end()) {
+                    if (fnd_up->second.first != drv)
+                        log_error("DSP '%s' has cascade inputs driven by both '%s' and '%s'\n", ci->name.c_str(ctx),
+                                  fnd_up->second.first->name.c_str(ctx), drv->name.c_str(ctx));
+                    continue;
+                }
+                auto fnd_down = downstream_of.find(drv->name);
+                if (fnd_down != downstream_of.end() && fnd_down->second != ci)
+                    log_error("DSP '%s' drives cascades into both '%s' and '%s'\n", drv->name.c_str(ctx),
+                              fnd_down->second->name.c_str(ctx), ci->name.c_str(ctx));
+                upstream_of[ci->name] = std::make_pair(drv, &rule);
+                downstream_of[drv->name] = ci;
+            }
+        }
+
+        for (auto &entry : downstream_of) {
+            CellInfo *head = ctx->cells.at(entry.first).get();
+            if (upstream_of.count(head->name))
+                continue; // not the start of a chain
+
+            std::vector<CellInfo *> chain;
+            chain.push_back(head);
+            while (downstream_of.count(chain.back()->name))
+                chain.push_back(downstream_of.at(chain.back()->name));
+
+            bool skip = false;
+            for (CellInfo *member : chain) {
+                // A fixed BEL means the user took charge of cascade
+                // placement; a cell belonging to a cluster it doesn't root
+                // (a MULT18 under its ALU54B) gets its adjacency from that
+                // cluster's own chain instead
+                if (member->attrs.count(ctx->id("BEL")) ||
+                    (member->cluster != ClusterId() && member->cluster != member->name))
+                    skip = true;
+            }
+            if (skip)
+                continue;
+
+            // Walk the cascade through the routing graph from an arbitrary
+            // seed bel to learn the relative placement of each link; any
+            // regular translation of that shape is then a legal placement
+            // for the chain
+            auto first_rule = upstream_of.at(chain.at(1)->name).second;
+            BelId seed;
+            for (auto bel : ctx->getBels()) {
+                if (ctx->getBelType(bel) != head->type)
+                    continue;
+                if (ctx->get_cascade_neighbour(bel, first_rule->src_port, first_rule->dst_port) == BelId())
+                    continue;
+                seed = bel;
+                break;
+            }
+            if (seed == BelId()) {
+                log_warning("no dedicated cascade wires found for DSP chain starting at '%s'; "
+                            "leaving it to general routing\n",
+                            head->name.c_str(ctx));
+                continue;
+            }
+
+            Loc base = ctx->getBelLocation(seed);
+            std::vector<Loc> offsets;
+            offsets.push_back(Loc(0, 0, 0));
+            BelId cursor = seed;
+            for (size_t i = 1; i < chain.size(); i++) {
+                auto rule = upstream_of.at(chain.at(i)->name).second;
+                cursor = ctx->get_cascade_neighbour(cursor, rule->src_port, rule->dst_port);
+                if (cursor == BelId())
+                    log_error("cascade chain of %d DSPs starting at '%s' does not fit the device\n", int(chain.size()),
+                              head->name.c_str(ctx));
+                Loc loc = ctx->getBelLocation(cursor);
+                offsets.push_back(Loc(loc.x - base.x, loc.y - base.y, loc.z - base.z));
+            }
+
+            CellInfo *root = chain.front();
+            if (root->cluster == ClusterId()) {
+                root->cluster = root->name;
+                root->constr_x = root->constr_y = root->constr_z = 0;
+            }
+            for (size_t i = 1; i < chain.size(); i++) {
+                CellInfo *member = chain.at(i);
+                Loc off = offsets.at(i);
+                // Re-parent the member's own cluster children (an ALU54B
+                // brings its two MULT18s) along with it
+                for (CellInfo *child : member->constr_children) {
+                    child->constr_x += off.x;
+                    child->constr_y += off.y;
+                    child->constr_z += off.z;
+                    child->cluster = root->name;
+                    root->constr_children.push_back(child);
+                }
+                member->constr_children.clear();
+                member->constr_x = off.x;
+                member->constr_y = off.y;
+                member->constr_z = off.z;
+                member->cluster = root->name;
+                root->constr_children.push_back(member);
+                log_info("DSP: Cascading %s '%s' at offset (%d, %d, %d) from '%s'\n", member->type.c_str(ctx),
+                         member->name.c_str(ctx), off.x, off.y, off.z, root->name.c_str(ctx));
+            }
+        }
+    }
+
     // "Pack" DCUs
     void pack_dcus()
     {
-        for (auto &cell : ctx->cells) {
-            CellInfo *ci = cell.second.get();
-            if (ci->type == id_DCUA) {
-                if (ci->attrs.count(ctx->id("LOC"))) {
-                    std::string loc = ci->attrs.at(ctx->id("LOC")).as_string();
-                    if (loc == "DCU0" &&
-                        (ctx->args.type == ArchArgs::LFE5UM_25F || ctx->args.type == ArchArgs::LFE5UM5G_25F))
-                        ci->attrs[ctx->id("BEL")] = std::string("X42/Y50/DCU");
-                    else if (loc == "DCU0" &&
-                             (ctx->args.type == ArchArgs::LFE5UM_45F || ctx->args.type == ArchArgs::LFE5UM5G_45F))
-                        ci->attrs[ctx->id("BEL")] = std::string("X42/Y71/DCU");
-                    else if (loc == "DCU1" &&
-                             (ctx->args.type == ArchArgs::LFE5UM_45F || ctx->args.type == ArchArgs::LFE5UM5G_45F))
-                        ci->attrs[ctx->id("BEL")] = std::string("X69/Y71/DCU");
-                    else if (loc == "DCU0" &&
-                             (ctx->args.type == ArchArgs::LFE5UM_85F || ctx->args.type == ArchArgs::LFE5UM5G_85F))
-                        ci->attrs[ctx->id("BEL")] = std::string("X46/Y95/DCU");
-                    else if (loc == "DCU1" &&
-                             (ctx->args.type == ArchArgs::LFE5UM_85F || ctx->args.type == ArchArgs::LFE5UM5G_85F))
-                        ci->attrs[ctx->id("BEL")] = std::string("X71/Y95/DCU");
-                    else
-                        log_error("no DCU location '%s' in device '%s'\n", loc.c_str(), ctx->getChipName().c_str());
-                }
-                if (!ci->attrs.count(ctx->id("BEL")))
-                    log_error("DCU must be constrained to a Bel!\n");
-                // Empty port auto-creation to generate correct tie-downs
-                BelId exemplar_bel;
-                for (auto bel : ctx->getBels()) {
-                    if (ctx->getBelType(bel) == id_DCUA) {
-                        exemplar_bel = bel;
-                        break;
-                    }
+        for (CellInfo *ci : ctx->cellsOfType(id_DCUA)) {
+            if (ci->attrs.count(ctx->id("LOC"))) {
+                std::string loc = ci->attrs.at(ctx->id("LOC")).as_string();
+                if (loc == "DCU0" &&
+                    (ctx->args.type == ArchArgs::LFE5UM_25F || ctx->args.type == ArchArgs::LFE5UM5G_25F))
+                    ci->attrs[ctx->id("BEL")] = std::string("X42/Y50/DCU");
+                else if (loc == "DCU0" &&
+                         (ctx->args.type == ArchArgs::LFE5UM_45F || ctx->args.type == ArchArgs::LFE5UM5G_45F))
+                    ci->attrs[ctx->id("BEL")] = std::string("X42/Y71/DCU");
+                else if (loc == "DCU1" &&
+                         (ctx->args.type == ArchArgs::LFE5UM_45F || ctx->args.type == ArchArgs::LFE5UM5G_45F))
+                    ci->attrs[ctx->id("BEL")] = std::string("X69/Y71/DCU");
+                else if (loc == "DCU0" &&
+                         (ctx->args.type == ArchArgs::LFE5UM_85F || ctx->args.type == ArchArgs::LFE5UM5G_85F))
+                    ci->attrs[ctx->id("BEL")] = std::string("X46/Y95/DCU");
+                else if (loc == "DCU1" &&
+                         (ctx->args.type == ArchArgs::LFE5UM_85F || ctx->args.type == ArchArgs::LFE5UM5G_85F))
+                    ci->attrs[ctx->id("BEL")] = std::string("X71/Y95/DCU");
+                else
+                    log_error("no DCU location '%s' in device '%s'\n", loc.c_str(), ctx->getChipName().c_str());
+            }
+            if (!ci->attrs.count(ctx->id("BEL")))
+                log_error("DCU must be constrained to a Bel!\n");
+            // Empty port auto-creation to generate correct tie-downs
+            BelId exemplar_bel;
+            for (auto bel : ctx->getBels()) {
+                if (ctx->getBelType(bel) == id_DCUA) {
+                    exemplar_bel = bel;
+                    break;
                 }
-                NPNR_ASSERT(exemplar_bel != BelId());
-                for (auto pin : ctx->getBelPins(exemplar_bel))
-                    if (ctx->getBelPinType(exemplar_bel, pin) == PORT_IN)
-                        autocreate_empty_port(ci, pin);
-                // Disconnect these ports if connected to constant to prevent routing failure
-                for (auto ndport : {id_D_TXBIT_CLKP_FROM_ND, id_D_TXBIT_CLKN_FROM_ND, id_D_SYNC_ND,
-                                    id_D_TXPLL_LOL_FROM_ND, id_CH0_HDINN, id_CH0_HDINP, id_CH1_HDINN, id_CH1_HDINP}) {
-                    const NetInfo *net = get_net_or_empty(ci, ndport);
-                    if (net == nullptr || net->driver.cell == nullptr)
-                        continue;
-                    IdString ct = net->driver.cell->type;
-                    if (ct == ctx->id("GND") || ct == ctx->id("VCC")) {
-                        disconnect_port(ctx, ci, ndport);
-                        ci->ports.erase(ndport);
-                    }
+            }
+            NPNR_ASSERT(exemplar_bel != BelId());
+            for (auto pin : ctx->getBelPins(exemplar_bel))
+                if (ctx->getBelPinType(exemplar_bel, pin) == PORT_IN)
+                    autocreate_empty_port(ci, pin);
+            // Disconnect these ports if connected to constant to prevent routing failure
+            for (auto ndport : {id_D_TXBIT_CLKP_FROM_ND, id_D_TXBIT_CLKN_FROM_ND, id_D_SYNC_ND,
+                                id_D_TXPLL_LOL_FROM_ND, id_CH0_HDINN, id_CH0_HDINP, id_CH1_HDINN, id_CH1_HDINP}) {
+                const NetInfo *net = get_net_or_empty(ci, ndport);
+                if (net == nullptr || net->driver.cell == nullptr)
+                    continue;
+                IdString ct = net->driver.cell->type;
+                if (ct == ctx->id("GND") || ct == ctx->id("VCC")) {
+                    disconnect_port(ctx, ci, ndport);
+                    ci->ports.erase(ndport);
                 }
             }
         }
-        for (auto &cell : ctx->cells) {
-            CellInfo *ci = cell.second.get();
-            if (ci->type == id_EXTREFB) {
-                const NetInfo *refo = net_or_nullptr(ci, id_REFCLKO);
-                CellInfo *dcu = nullptr;
-                std::string loc_bel = std::string("NONE");
-                std::string dcu_bel = std::string("NONE");
-                if (ci->attrs.count(ctx->id("LOC"))) {
-                    std::string loc = ci->attrs.at(ctx->id("LOC")).as_string();
-                    if (loc == "EXTREF0" &&
-                        (ctx->args.type == ArchArgs::LFE5UM_25F || ctx->args.type == ArchArgs::LFE5UM5G_25F))
-                        loc_bel = std::string("X42/Y50/EXTREF");
-                    else if (loc == "EXTREF0" &&
-                             (ctx->args.type == ArchArgs::LFE5UM_45F || ctx->args.type == ArchArgs::LFE5UM5G_45F))
-                        loc_bel = std::string("X42/Y71/EXTREF");
-                    else if (loc == "EXTREF1" &&
-                             (ctx->args.type == ArchArgs::LFE5UM_45F || ctx->args.type == ArchArgs::LFE5UM5G_45F))
-                        loc_bel = std::string("X69/Y71/EXTREF");
-                    else if (loc == "EXTREF0" &&
-                             (ctx->args.type == ArchArgs::LFE5UM_85F || ctx->args.type == ArchArgs::LFE5UM5G_85F))
-                        loc_bel = std::string("X46/Y95/EXTREF");
-                    else if (loc == "EXTREF1" &&
-                             (ctx->args.type == ArchArgs::LFE5UM_85F || ctx->args.type == ArchArgs::LFE5UM5G_85F))
-                        loc_bel = std::string("X71/Y95/EXTREF");
-                }
-                if (refo == nullptr)
-                    log_error("EXTREFB REFCLKO must not be unconnected\n");
-                for (auto user : refo->users) {
-                    if (user.cell->type != id_DCUA)
-                        continue;
-                    if (dcu != nullptr && dcu != user.cell)
-                        log_error("EXTREFB REFCLKO must only drive a single DCUA\n");
-                    dcu = user.cell;
-                }
-                if (dcu != nullptr) {
-                    if (!dcu->attrs.count(ctx->id("BEL")))
-                        log_error("DCU must be constrained to a Bel!\n");
-                    dcu_bel = dcu->attrs.at(ctx->id("BEL")).as_string();
-                    NPNR_ASSERT(dcu_bel.substr(dcu_bel.length() - 3) == "DCU");
-                    dcu_bel.replace(dcu_bel.length() - 3, 3, "EXTREF");
-                }
-                if (dcu_bel != loc_bel) {
-                    if (dcu_bel == "NONE" && loc_bel == "NONE") {
-                        log_error("EXTREFB has neither a LOC or a directly associated DCUA\n");
-                    } else if (dcu_bel == "NONE") {
-                        ci->attrs[ctx->id("BEL")] = loc_bel;
-                        dcu_bel = loc_bel;
-                    } else if (loc_bel == "NONE") {
-                        ci->attrs[ctx->id("BEL")] = dcu_bel;
-                    } else {
-                        log_error("EXTREFB has conflicting LOC '%s' and associated DCUA '%s'\n", loc_bel.c_str(),
-                                  dcu_bel.c_str());
-                    }
-                } else {
-                    if (dcu_bel == "NONE")
-                        log_error("EXTREFB has no LOC or associated DCUA\n");
+        for (CellInfo *ci : ctx->cellsOfType(id_EXTREFB)) {
+            const NetInfo *refo = net_or_nullptr(ci, id_REFCLKO);
+            CellInfo *dcu = nullptr;
+            std::string loc_bel = std::string("NONE");
+            std::string dcu_bel = std::string("NONE");
+            if (ci->attrs.count(ctx->id("LOC"))) {
+                std::string loc = ci->attrs.at(ctx->id("LOC")).as_string();
+                if (loc == "EXTREF0" &&
+                    (ctx->args.type == ArchArgs::LFE5UM_25F || ctx->args.type == ArchArgs::LFE5UM5G_25F))
+                    loc_bel = std::string("X42/Y50/EXTREF");
+                else if (loc == "EXTREF0" &&
+                         (ctx->args.type == ArchArgs::LFE5UM_45F || ctx->args.type == ArchArgs::LFE5UM5G_45F))
+                    loc_bel = std::string("X42/Y71/EXTREF");
+                else if (loc == "EXTREF1" &&
+                         (ctx->args.type == ArchArgs::LFE5UM_45F || ctx->args.type == ArchArgs::LFE5UM5G_45F))
+                    loc_bel = std::string("X69/Y71/EXTREF");
+                else if (loc == "EXTREF0" &&
+                         (ctx->args.type == ArchArgs::LFE5UM_85F || ctx->args.type == ArchArgs::LFE5UM5G_85F))
+                    loc_bel = std::string("X46/Y95/EXTREF");
+                else if (loc == "EXTREF1" &&
+                         (ctx->args.type == ArchArgs::LFE5UM_85F || ctx->args.type == ArchArgs::LFE5UM5G_85F))
+                    loc_bel = std::string("X71/Y95/EXTREF");
+            }
+            if (refo == nullptr)
+                log_error("EXTREFB REFCLKO must not be unconnected\n");
+            for (auto user : refo->users) {
+                if (user.cell->type != id_DCUA)
+                    continue;
+                if (dcu != nullptr && dcu != user.cell)
+                    log_error("EXTREFB REFCLKO must only drive a single DCUA\n");
+                dcu = user.cell;
+            }
+            if (dcu != nullptr) {
+                if (!dcu->attrs.count(ctx->id("BEL")))
+                    log_error("DCU must be constrained to a Bel!\n");
+                dcu_bel = dcu->attrs.at(ctx->id("BEL")).as_string();
+                NPNR_ASSERT(dcu_bel.substr(dcu_bel.length() - 3) == "DCU");
+                dcu_bel.replace(dcu_bel.length() - 3, 3, "EXTREF");
+            }
+            if (dcu_bel != loc_bel) {
+                if (dcu_bel == "NONE" && loc_bel == "NONE") {
+                    log_error("EXTREFB has neither a LOC or a directly associated DCUA\n");
+                } else if (dcu_bel == "NONE") {
+                    ci->attrs[ctx->id("BEL")] = loc_bel;
+                    dcu_bel = loc_bel;
+                } else if (loc_bel == "NONE") {
                     ci->attrs[ctx->id("BEL")] = dcu_bel;
+                } else {
+                    log_error("EXTREFB has conflicting LOC '%s' and associated DCUA '%s'\n", loc_bel.c_str(),
+                              dcu_bel.c_str());
                 }
-            } else if (ci->type == id_PCSCLKDIV) {
-                const NetInfo *clki = net_or_nullptr(ci, id_CLKI);
-                if (clki != nullptr && clki->driver.cell != nullptr && clki->driver.cell->type == id_DCUA) {
-                    CellInfo *dcu = clki->driver.cell;
-                    if (!dcu->attrs.count(ctx->id("BEL")))
-                        log_error("DCU must be constrained to a Bel!\n");
-                    BelId bel = ctx->getBelByNameStr(dcu->attrs.at(ctx->id("BEL")).as_string());
-                    if (bel == BelId())
-                        log_error("Invalid DCU bel '%s'\n", dcu->attrs.at(ctx->id("BEL")).c_str());
-                    Loc loc = ctx->getBelLocation(bel);
-                    // DCU0 -> CLKDIV z=0; DCU1 -> CLKDIV z=1
-                    ci->constr_abs_z = true;
-                    ci->constr_z = (loc.x >= 69) ? 1 : 0;
-                }
+            } else {
+                if (dcu_bel == "NONE")
+                    log_error("EXTREFB has no LOC or associated DCUA\n");
+                ci->attrs[ctx->id("BEL")] = dcu_bel;
+            }
+        }
+        for (CellInfo *ci : ctx->cellsOfType(id_PCSCLKDIV)) {
+            const NetInfo *clki = net_or_nullptr(ci, id_CLKI);
+            if (clki != nullptr && clki->driver.cell != nullptr && clki->driver.cell->type == id_DCUA) {
+                CellInfo *dcu = clki->driver.cell;
+                if (!dcu->attrs.count(ctx->id("BEL")))
+                    log_error("DCU must be constrained to a Bel!\n");
+                BelId bel = ctx->getBelByNameStr(dcu->attrs.at(ctx->id("BEL")).as_string());
+                if (bel == BelId())
+                    log_error("Invalid DCU bel '%s'\n", dcu->attrs.at(ctx->id("BEL")).c_str());
+                Loc loc = ctx->getBelLocation(bel);
+                // DCU0 -> CLKDIV z=0; DCU1 -> CLKDIV z=1
+                ci->constr_abs_z = true;
+                ci->constr_z = (loc.x >= 69) ? 1 : 0;
             }
         }
     }
@@ -1840,17 +1998,18 @@ class Ecp5Packer
     // Miscellaneous packer tasks
     void pack_misc()
     {
-        for (auto &cell : ctx->cells) {
-            CellInfo *ci = cell.second.get();
-            if (ci->type == id_USRMCLK) {
-                rename_port(ctx, ci, ctx->id("USRMCLKI"), id_PADDO);
-                rename_port(ctx, ci, ctx->id("USRMCLKTS"), id_PADDT);
-                rename_port(ctx, ci, ctx->id("USRMCLKO"), id_PADDI);
-            } else if (ci->type == id_GSR || ci->type == ctx->id("SGSR")) {
+        for (CellInfo *ci : ctx->cellsOfType(id_USRMCLK)) {
+            rename_port(ctx, ci, ctx->id("USRMCLKI"), id_PADDO);
+            rename_port(ctx, ci, ctx->id("USRMCLKTS"), id_PADDT);
+            rename_port(ctx, ci, ctx->id("USRMCLKO"), id_PADDI);
+        }
+        for (auto gsr_type : {id_GSR, ctx->id("SGSR")}) {
+            for (CellInfo *ci : ctx->cellsOfType(gsr_type)) {
                 ci->params[ctx->id("MODE")] = std::string("ACTIVE_LOW");
                 ci->params[ctx->id("SYNCMODE")] =
                         ci->type == ctx->id("SGSR") ? std::string("SYNC") : std::string("ASYNC");
-                ci->type = id_GSR;
+                if (ci->type != id_GSR)
+                    ctx->retypeCell(*ci, id_GSR);
                 for (BelId bel : ctx->getBels()) {
                     if (ctx->getBelType(bel) != id_GSR)
                         continue;
@@ -1869,15 +2028,13 @@ class Ecp5Packer
             if (ctx->getBelType(bel) == id_EHXPLLL && ctx->checkBelAvail(bel))
                 available_plls.insert(bel);
         }
-        for (auto &cell : ctx->cells) {
-            CellInfo *ci = cell.second.get();
-            if (ci->type == id_EHXPLLL && ci->attrs.count(ctx->id("BEL")))
+        for (CellInfo *ci : ctx->cellsOfType(id_EHXPLLL)) {
+            if (ci->attrs.count(ctx->id("BEL")))
                 available_plls.erase(ctx->getBelByNameStr(ci->attrs.at(ctx->id("BEL")).as_string()));
         }
         // Place PLL connected to fixed drivers such as IO close to their source
-        for (auto &cell : ctx->cells) {
-            CellInfo *ci = cell.second.get();
-            if (ci->type == id_EHXPLLL && !ci->attrs.count(ctx->id("BEL"))) {
+        for (CellInfo *ci : ctx->cellsOfType(id_EHXPLLL)) {
+            if (!ci->attrs.count(ctx->id("BEL"))) {
                 const NetInfo *drivernet = net_or_nullptr(ci, id_CLKI);
                 if (drivernet == nullptr || drivernet->driver.cell == nullptr)
                     continue;
@@ -1903,9 +2060,8 @@ class Ecp5Packer
             }
         }
         // Place PLLs driven by logic, etc, randomly
-        for (auto &cell : ctx->cells) {
-            CellInfo *ci = cell.second.get();
-            if (ci->type == id_EHXPLLL && !ci->attrs.count(ctx->id("BEL"))) {
+        for (CellInfo *ci : ctx->cellsOfType(id_EHXPLLL)) {
+            if (!ci->attrs.count(ctx->id("BEL"))) {
                 if (available_plls.empty())
                     log_error("failed to place PLL '%s'\n", ci->name.c_str(ctx));
                 BelId next_pll = *(available_plls.begin());
@@ -2070,62 +2226,59 @@ class Ecp5Packer
     // Pack DQSBUFs
     void pack_dqsbuf()
     {
-        for (auto &cell : ctx->cells) {
-            CellInfo *ci = cell.second.get();
-            if (ci->type == id_DQSBUFM) {
-                CellInfo *pio = net_driven_by(ctx, ci->ports.at(ctx->id("DQSI")).net, is_trellis_io, id_O);
-                if (pio == nullptr || ci->ports.at(ctx->id("DQSI")).net->users.size() > 1)
-                    log_error("DQSBUFM '%s' DQSI input must be connected only to a top level input\n",
-                              ci->name.c_str(ctx));
-                if (!pio->attrs.count(ctx->id("BEL")))
-                    log_error("DQSBUFM can only be used with a pin-constrained PIO connected to its DQSI input"
-                              "(while processing '%s').\n",
-                              ci->name.c_str(ctx));
-                BelId pio_bel = ctx->getBelByNameStr(pio->attrs.at(ctx->id("BEL")).as_string());
-                NPNR_ASSERT(pio_bel != BelId());
-                Loc pio_loc = ctx->getBelLocation(pio_bel);
-                if (pio_loc.z != 0)
-                    log_error("PIO '%s' does not appear to be a DQS site (expecting an 'A' pin).\n",
-                              ctx->nameOfBel(pio_bel));
-                pio_loc.z = 8;
-                BelId dqsbuf = ctx->getBelByLocation(pio_loc);
-                if (dqsbuf == BelId() || ctx->getBelType(dqsbuf) != id_DQSBUFM)
-                    log_error("PIO '%s' does not appear to be a DQS site (didn't find a DQSBUFM).\n",
-                              ctx->nameOfBel(pio_bel));
-                ci->attrs[ctx->id("BEL")] = ctx->getBelName(dqsbuf).str(ctx);
-                bool got_dqsg =
-                        ctx->get_pio_dqs_group(pio_bel, dqsbuf_dqsg[ci->name].first, dqsbuf_dqsg[ci->name].second);
-                NPNR_ASSERT(got_dqsg);
-                log_info("Constrained DQSBUFM '%s' to %cDQS%d\n", ci->name.c_str(ctx),
-                         dqsbuf_dqsg[ci->name].first ? 'R' : 'L', dqsbuf_dqsg[ci->name].second);
-
-                // Set all special ports, if used as 'globals' that the router won't touch
-                for (auto port : {id_DQSR90, id_RDPNTR0, id_RDPNTR1, id_RDPNTR2, id_WRPNTR0, id_WRPNTR1, id_WRPNTR2,
-                                  id_DQSW270, id_DQSW}) {
-                    if (!ci->ports.count(port))
-                        continue;
-                    NetInfo *pn = ci->ports.at(port).net;
-                    if (pn == nullptr)
-                        continue;
-                    for (auto &usr : pn->users) {
-                        if (usr.port != port ||
-                            (usr.cell->type != ctx->id("ODDRX2DQA") && usr.cell->type != ctx->id("ODDRX2DQSB") &&
-                             usr.cell->type != ctx->id("TSHX2DQSA") && usr.cell->type != ctx->id("IDDRX2DQA") &&
-                             usr.cell->type != ctx->id("TSHX2DQA") && usr.cell->type != id_IOLOGIC))
-                            log_error("Port '%s' of DQSBUFM '%s' cannot drive port '%s' of cell '%s'.\n",
-                                      port.c_str(ctx), ci->name.c_str(ctx), usr.port.c_str(ctx),
-                                      usr.cell->name.c_str(ctx));
-                    }
-                    pn->attrs[ctx->id("ECP5_IS_GLOBAL")] = 1;
-                }
+        for (CellInfo *ci : ctx->cellsOfType(id_DQSBUFM)) {
+            CellInfo *pio = net_driven_by(ctx, ci->ports.at(ctx->id("DQSI")).net, is_trellis_io, id_O);
+            if (pio == nullptr || ci->ports.at(ctx->id("DQSI")).net->users.size() > 1)
+                log_error("DQSBUFM '%s' DQSI input must be connected only to a top level input\n",
+                          ci->name.c_str(ctx));
+            if (!pio->attrs.count(ctx->id("BEL")))
+                log_error("DQSBUFM can only be used with a pin-constrained PIO connected to its DQSI input"
+                          "(while processing '%s').\n",
+                          ci->name.c_str(ctx));
+            BelId pio_bel = ctx->getBelByNameStr(pio->attrs.at(ctx->id("BEL")).as_string());
+            NPNR_ASSERT(pio_bel != BelId());
+            Loc pio_loc = ctx->getBelLocation(pio_bel);
+            if (pio_loc.z != 0)
+                log_error("PIO '%s' does not appear to be a DQS site (expecting an 'A' pin).\n",
+                          ctx->nameOfBel(pio_bel));
+            pio_loc.z = 8;
+            BelId dqsbuf = ctx->getBelByLocation(pio_loc);
+            if (dqsbuf == BelId() || ctx->getBelType(dqsbuf) != id_DQSBUFM)
+                log_error("PIO '%s' does not appear to be a DQS site (didn't find a DQSBUFM).\n",
+                          ctx->nameOfBel(pio_bel));
+            ci->attrs[ctx->id("BEL")] = ctx->getBelName(dqsbuf).str(ctx);
+            bool got_dqsg =
+                    ctx->get_pio_dqs_group(pio_bel, dqsbuf_dqsg[ci->name].first, dqsbuf_dqsg[ci->name].second);
+            NPNR_ASSERT(got_dqsg);
+            log_info("Constrained DQSBUFM '%s' to %cDQS%d\n", ci->name.c_str(ctx),
+                     dqsbuf_dqsg[ci->name].first ? 'R' : 'L', dqsbuf_dqsg[ci->name].second);
+
+            // Set all special ports, if used as 'globals' that the router won't touch
+            for (auto port : {id_DQSR90, id_RDPNTR0, id_RDPNTR1, id_RDPNTR2, id_WRPNTR0, id_WRPNTR1, id_WRPNTR2,
+                              id_DQSW270, id_DQSW}) {
+                if (!ci->ports.count(port))
+                    continue;
+                NetInfo *pn = ci->ports.at(port).net;
+                if (pn == nullptr)
+                    continue;
+                for (auto &usr : pn->users) {
+                    if (usr.port != port ||
+                        (usr.cell->type != ctx->id("ODDRX2DQA") && usr.cell->type != ctx->id("ODDRX2DQSB") &&
+                         usr.cell->type != ctx->id("TSHX2DQSA") && usr.cell->type != ctx->id("IDDRX2DQA") &&
+                         usr.cell->type != ctx->id("TSHX2DQA") && usr.cell->type != id_IOLOGIC))
+                        log_error("Port '%s' of DQSBUFM '%s' cannot drive port '%s' of cell '%s'.\n",
+                                  port.c_str(ctx), ci->name.c_str(ctx), usr.port.c_str(ctx),
+                                  usr.cell->name.c_str(ctx));
+                }
+                pn->attrs[ctx->id("ECP5_IS_GLOBAL")] = 1;
+            }
 
-                for (auto zport :
-                     {id_RDMOVE, id_RDDIRECTION, id_WRMOVE, id_WRDIRECTION, id_READ0, id_READ1, id_READCLKSEL0,
-                      id_READCLKSEL1, id_READCLKSEL2, id_DYNDELAY0, id_DYNDELAY1, id_DYNDELAY2, id_DYNDELAY3,
-                      id_DYNDELAY4, id_DYNDELAY5, id_DYNDELAY6, id_DYNDELAY7}) {
-                    if (net_or_nullptr(ci, zport) == nullptr)
-                        tie_zero(ci, zport);
-                }
+            for (auto zport :
+                 {id_RDMOVE, id_RDDIRECTION, id_WRMOVE, id_WRDIRECTION, id_READ0, id_READ1, id_READCLKSEL0,
+                  id_READCLKSEL1, id_READCLKSEL2, id_DYNDELAY0, id_DYNDELAY1, id_DYNDELAY2, id_DYNDELAY3,
+                  id_DYNDELAY4, id_DYNDELAY5, id_DYNDELAY6, id_DYNDELAY7}) {
+                if (net_or_nullptr(ci, zport) == nullptr)
+                    tie_zero(ci, zport);
             }
         }
     }
@@ -3174,6 +3327,7 @@ class Ecp5Packer
         pack_iologic();
         pack_ebr();
         pack_dsps();
+        pack_dsp_cascades();
         pack_dcus();
         pack_misc();
         pack_constants();
@@ -3197,6 +3351,10 @@ class Ecp5Packer
     pool<IdString> packed_cells;
     std::vector<std::unique_ptr<CellInfo>> new_cells;
 
+    // Memoizes the constant-input INIT rewrites; constant folding visits the
+    // same few LUT functions over and over in a typical synthesized design
+    LutMappingCache lut_cache;
+
     struct SliceUsage
     {
         bool lut0_used = false, lut1_used = false;
@@ -3206,6 +3364,7 @@ class Ecp5Packer
     };
 
     dict<IdString, SliceUsage> sliceUsage;
+    dict<IdString, FFControlSet> ff_ctrlsets;
     dict<IdString, IdString> lutffPairs;
     dict<IdString, IdString> fflutPairs;
     dict<IdString, IdString> lutPairs;
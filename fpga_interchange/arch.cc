@@ -258,6 +258,24 @@ Arch::Arch(ArchArgs args) : args(args), disallow_site_routing(false)
         }
     }
 
+    // Flatten the per-bel pin lists into sorted (pin constid, slot) pairs so
+    // bel pin resolution is a binary search rather than a chipdb walk
+    tile_type_bel_pin_index.resize(chip_info->tile_types.size());
+    tile_type_index = 0;
+    for (const TileTypeInfoPOD &tile_type : chip_info->tile_types) {
+        auto &type_pins = tile_type_bel_pin_index[tile_type_index++];
+        type_pins.resize(tile_type.bel_data.size());
+        for (int bel = 0; bel < tile_type.bel_data.ssize(); ++bel) {
+            const BelInfoPOD &bel_data = tile_type.bel_data[bel];
+            const int32_t *ports = bel_data.ports.get();
+            auto &pins = type_pins[bel];
+            pins.reserve(bel_data.num_bel_wires);
+            for (int i = 0; i < bel_data.num_bel_wires; ++i)
+                pins.emplace_back(ports[i], i);
+            std::sort(pins.begin(), pins.end());
+        }
+    }
+
     // Map lut cell types to their LutCellPOD
     wire_lut = nullptr;
     for (const LutCellPOD &lut_cell : chip_info->cell_map->lut_cells) {
@@ -287,7 +305,8 @@ void Arch::init()
     lookahead.init(getCtx(), getCtx());
 #endif
     dedicated_interconnect.init(getCtx());
-    cell_parameters.init(getCtx());
+    // cell_parameters loads itself lazily on first lookup; macro templates
+    // are likewise resolved per type on demand in expand_macros
 
     for (size_t tile_type = 0; tile_type < chip_info->tile_types.size(); ++tile_type) {
         pseudo_pip_data.init_tile_type(getCtx(), tile_type);
@@ -811,6 +830,11 @@ bool Arch::place()
         log_error("FPGA interchange architecture does not support placer '%s'\n", placer.c_str());
     }
 
+    if (arch_args.place_drc) {
+        if (!site_routing_drc())
+            log_error("Placement failed end-of-placement site routing DRC\n");
+    }
+
     getCtx()->attrs[getCtx()->id("step")] = std::string("place");
     archInfoToAttributes();
 
@@ -845,6 +869,11 @@ static void prepare_sites_for_routing(Context *ctx)
     // pins to ensure a routeable pin choice.
     ctx->site_routing_cache.clear();
 
+    // Warm the cache from the persistent per-chipdb file. Solutions in it
+    // were computed in this unconstrained phase (post pin blocking), so
+    // unlike the entries just cleared they are valid for any design.
+    ctx->site_routing_cache.load(ctx->args.chipdb + ".siteroute.cache", ctx->get_chipdb_hash());
+
     // Clear the LUT mapping cache
     ctx->site_lut_mapping_cache.clear();
 
@@ -951,6 +980,10 @@ bool Arch::route()
 
     getCtx()->check();
 
+    // Persist the unconstrained-phase site routing solutions for the next
+    // run against this chipdb.
+    getCtx()->site_routing_cache.save(getCtx()->args.chipdb + ".siteroute.cache", getCtx()->get_chipdb_hash());
+
     return result;
 }
 
@@ -1050,12 +1083,23 @@ void Arch::write_physical_netlist(const std::string &filename) const
 
 void Arch::parse_xdc(const std::string &filename)
 {
-    TclInterp interp(getCtx());
-    auto result = Tcl_EvalFile(interp.interp, filename.c_str());
-    if (result != TCL_OK) {
-        log_error("Error in %s:%d => %s\n", filename.c_str(), Tcl_GetErrorLine(interp.interp),
-                  Tcl_GetStringResult(interp.interp));
+    // Plain pin-constraint files compile to an IR once and replay from the
+    // cache on later loads; anything using real Tcl goes to the interpreter
+    auto cached = xdc_ir_cache.find(filename);
+    if (cached == xdc_ir_cache.end()) {
+        std::vector<XdcCommand> ir;
+        if (!xdc_compile(getCtx(), filename, ir)) {
+            TclInterp interp(getCtx());
+            auto result = Tcl_EvalFile(interp.interp, filename.c_str());
+            if (result != TCL_OK) {
+                log_error("Error in %s:%d => %s\n", filename.c_str(), Tcl_GetErrorLine(interp.interp),
+                          Tcl_GetStringResult(interp.interp));
+            }
+            return;
+        }
+        cached = xdc_ir_cache.emplace(filename, std::move(ir)).first;
     }
+    xdc_apply(getCtx(), cached->second, filename);
 }
 
 std::string Arch::get_part() const
@@ -1604,6 +1648,7 @@ void Arch::unassign_wire(WireId wire)
     }
 
     net_wires.erase(it);
+    ++net->route_version;
 #ifdef DEBUG_BINDING
     if (getCtx()->verbose) {
         log_info("Removing %s from net %s in unassign_wire\n", nameOfWire(wire), net->name.c_str(this));
@@ -1642,6 +1687,7 @@ void Arch::unbindPip(PipId pip)
 #endif
     wire_iter->second = nullptr;
     NPNR_ASSERT(net->wires.erase(dst) == 1);
+    ++net->route_version;
 
     refreshUiPip(pip);
     refreshUiWire(dst);
@@ -1674,6 +1720,7 @@ void Arch::bindPip(PipId pip, NetInfo *net, PlaceStrength strength)
         auto result = net->wires.emplace(dst, PipMap{pip, strength});
         NPNR_ASSERT(result.second);
     }
+    ++net->route_version;
 
     refreshUiPip(pip);
     refreshUiWire(dst);
@@ -1691,6 +1738,7 @@ void Arch::bindWire(WireId wire, NetInfo *net, PlaceStrength strength)
     auto &pip_map = net->wires[wire];
     pip_map.pip = PipId();
     pip_map.strength = strength;
+    ++net->route_version;
     refreshUiWire(wire);
 }
 
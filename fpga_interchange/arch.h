@@ -23,8 +23,10 @@
 #ifndef FPGA_INTERCHANGE_ARCH_H
 #define FPGA_INTERCHANGE_ARCH_H
 
+#include <algorithm>
 #include <boost/iostreams/device/mapped_file.hpp>
 #include <iostream>
+#include <limits>
 #include <regex>
 
 #include "PhysicalNetlist.capnp.h"
@@ -42,6 +44,7 @@
 #include "site_lut_mapping_cache.h"
 #include "site_router.h"
 #include "site_routing_cache.h"
+#include "xdc.h"
 
 NEXTPNR_NAMESPACE_BEGIN
 
@@ -52,6 +55,7 @@ struct ArchArgs
     bool rebuild_lookahead;
     bool dont_write_lookahead;
     bool disable_lut_mapping_cache;
+    bool place_drc;
 };
 
 struct ArchRanges
@@ -295,6 +299,7 @@ struct Arch : ArchAPI<ArchRanges>
         tile_status.boundcells[bel.index] = cell;
 
         cell->bel = bel;
+        cell->loc = getBelLocation(bel);
         cell->belStrength = strength;
 
         refreshUiBel(bel);
@@ -408,13 +413,11 @@ struct Arch : ArchAPI<ArchRanges>
     int get_bel_pin_index(BelId bel, IdString pin) const
     {
         NPNR_ASSERT(bel != BelId());
-        int num_bel_wires = bel_info(chip_info, bel).num_bel_wires;
-        const int32_t *ports = bel_info(chip_info, bel).ports.get();
-        for (int i = 0; i < num_bel_wires; i++) {
-            if (ports[i] == pin.index) {
-                return i;
-            }
-        }
+        const auto &pins = tile_type_bel_pin_index.at(chip_info->tiles[bel.tile].type).at(bel.index);
+        auto it = std::lower_bound(pins.begin(), pins.end(),
+                                   std::make_pair(int32_t(pin.index), std::numeric_limits<int32_t>::min()));
+        if (it != pins.end() && it->first == pin.index)
+            return it->second;
 
         return -1;
     }
@@ -593,6 +596,13 @@ struct Arch : ArchAPI<ArchRanges>
 
     void bindPip(PipId pip, NetInfo *net, PlaceStrength strength) final;
 
+    void bindPips(const std::vector<PipId> &pips, NetInfo *net, PlaceStrength strength) final
+    {
+        net->wires.reserve(net->wires.size() + pips.size());
+        for (auto pip : pips)
+            bindPip(pip, net, strength);
+    }
+
     void unbindPip(PipId pip) final;
 
     bool checkPipAvail(PipId pip) const final;
@@ -670,6 +680,19 @@ struct Arch : ArchAPI<ArchRanges>
         return range;
     }
 
+    void getPipsDownhillInfo(WireId wire, std::vector<PipDownhillInfo> &out) const final
+    {
+        out.clear();
+        for (PipId pip : getPipsDownhill(wire)) {
+            PipDownhillInfo info;
+            info.pip = pip;
+            info.dst = getPipDstWire(pip);
+            info.delay = getPipDelay(pip);
+            info.loc = getPipLocation(pip);
+            out.push_back(info);
+        }
+    }
+
     UphillPipRange getPipsUphill(WireId wire) const final
     {
         UphillPipRange range;
@@ -735,6 +758,7 @@ struct Arch : ArchAPI<ArchRanges>
     bool pack() final;
     bool place() final;
     bool route() final;
+    void postPlaceFixup() final {}
     // -------------------------------------------------
 
     std::vector<GraphicElement> getDecalGraphics(DecalId decal) const final;
@@ -895,6 +919,28 @@ struct Arch : ArchAPI<ArchRanges>
         return routing_status;
     }
 
+    bool isSwapLocationValid(CellInfo *cell, BelId newBel, CellInfo *other_cell, BelId oldBel) final
+    {
+        // Site routing legality can't be answered structurally, so apply the
+        // swap, query both locations and revert
+        PlaceStrength cell_str = cell->belStrength;
+        PlaceStrength other_str = (other_cell != nullptr) ? other_cell->belStrength : STRENGTH_WEAK;
+        unbindBel(oldBel);
+        if (other_cell != nullptr)
+            unbindBel(newBel);
+        bindBel(newBel, cell, cell_str);
+        if (other_cell != nullptr)
+            bindBel(oldBel, other_cell, other_str);
+        bool valid = isBelLocationValid(newBel) && isBelLocationValid(oldBel);
+        unbindBel(newBel);
+        if (other_cell != nullptr)
+            unbindBel(oldBel);
+        bindBel(oldBel, cell, cell_str);
+        if (other_cell != nullptr)
+            bindBel(newBel, other_cell, other_str);
+        return valid;
+    }
+
     CellInfo *getClusterRootCell(ClusterId cluster) const override;
     ArcBounds getClusterBounds(ClusterId cluster) const override;
     Loc getClusterOffset(const CellInfo *cell) const override;
@@ -903,6 +949,22 @@ struct Arch : ArchAPI<ArchRanges>
                                   std::vector<std::pair<CellInfo *, BelId>> &) const;
     bool macro_cluster_placement(const Context *, const Cluster &, const ClusterPOD &, CellInfo *, BelId,
                                  std::vector<std::pair<CellInfo *, BelId>> &) const;
+    // Lazily-built per-cluster lookup tables over the chipdb placement
+    // lists, so checking one candidate root bel is a pair of dict lookups
+    // rather than a rescan of every physical placement. The placers probe
+    // many candidate bels per cluster through getClusterPlacement, so these
+    // dominate cluster feasibility time on chain/BRAM heavy designs
+    struct MacroClusterLookup
+    {
+        dict<IdString, uint32_t> site_type_idx;
+        std::vector<dict<IdString, uint32_t>> bel_to_placement;
+    };
+    const MacroClusterLookup &macro_cluster_lookup_for(uint32_t cluster_index, const ClusterPOD &cluster) const;
+    mutable dict<uint32_t, MacroClusterLookup> macro_cluster_lookup;
+    // Cell pin -> bel pins expansion of a cell_bel_map entry, built on first
+    // use instead of once per candidate placement
+    const dict<IdString, std::vector<IdString>> &cell_bel_pins_for(int32_t mapping) const;
+    mutable dict<int32_t, dict<IdString, std::vector<IdString>>> cell_bel_pins_cache;
     bool getClusterPlacement(ClusterId cluster, BelId root_bel,
                              std::vector<std::pair<CellInfo *, BelId>> &placement) const override;
 
@@ -925,6 +987,10 @@ struct Arch : ArchAPI<ArchRanges>
     void write_physical_netlist(const std::string &filename) const;
     void parse_xdc(const std::string &filename);
 
+    // Compiled constraint IR per XDC file; see xdc.cc. Files beyond the
+    // simple set_property subset are not cached and re-run through Tcl
+    dict<std::string, std::vector<XdcCommand>> xdc_ir_cache;
+
     pool<IdString> io_port_types;
     pool<BelId> pads;
 
@@ -1135,6 +1201,12 @@ struct Arch : ArchAPI<ArchRanges>
     std::vector<std::vector<LutElement>> lut_elements;
     dict<IdString, const LutCellPOD *> lut_cells;
 
+    // Per tile type, per bel: (pin constid, pin slot) sorted by constid, so
+    // get_bel_pin_index is a binary search over contiguous pairs instead of
+    // a linear walk of the chipdb ports list; the site router resolves bel
+    // pins to wires constantly and the walk shows up in placement profiles
+    std::vector<std::vector<std::vector<std::pair<int32_t, int32_t>>>> tile_type_bel_pin_index;
+
     // Of the LUT cells, which is used for wires?
     // Note: May be null in arch's without wire LUT types.  Assumption is
     // that these arch's don't need wire LUT's because the LUT share is simple
@@ -1151,6 +1223,8 @@ struct Arch : ArchAPI<ArchRanges>
     Lookahead lookahead;
     mutable RouteNodeStorage node_storage;
     mutable SiteRoutingCache site_routing_cache;
+    // See SiteReachability; keyed by (tile type, site in tile)
+    mutable dict<std::pair<int32_t, int32_t>, SiteReachability> site_reachability_cache;
     mutable SiteLutMappingCache site_lut_mapping_cache;
     bool disallow_site_routing;
     CellParameters cell_parameters;
@@ -1173,6 +1247,11 @@ struct Arch : ArchAPI<ArchRanges>
 
     void explain_bel_status(BelId bel) const;
 
+    // End-of-placement DRC: re-validate the routing of every occupied site,
+    // split across worker threads, and report every failing site in one
+    // pass. Returns true if all occupied sites pass.
+    bool site_routing_drc() const;
+
     const DefaultCellConnsPOD *get_default_conns(IdString cell_type) const;
     void pack_default_conns();
 
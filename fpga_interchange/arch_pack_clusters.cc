@@ -191,6 +191,19 @@ CellInfo *Arch::getClusterRootCell(ClusterId cluster) const
     return clusters.at(cluster).root;
 }
 
+const dict<IdString, std::vector<IdString>> &Arch::cell_bel_pins_for(int32_t mapping) const
+{
+    auto fnd = cell_bel_pins_cache.find(mapping);
+    if (fnd != cell_bel_pins_cache.end())
+        return fnd->second;
+
+    dict<IdString, std::vector<IdString>> &entry = cell_bel_pins_cache[mapping];
+    const CellBelMapPOD &cell_pin_map = chip_info->cell_map->cell_bel_map[mapping];
+    for (const auto &pin_map : cell_pin_map.common_pins)
+        entry[IdString(pin_map.cell_pin)].push_back(IdString(pin_map.bel_pin));
+    return entry;
+}
+
 bool Arch::normal_cluster_placement(const Context *ctx, const Cluster &packed_cluster, const ClusterPOD &cluster_data,
                                     CellInfo *root_cell, BelId root_bel,
                                     std::vector<std::pair<CellInfo *, BelId>> &placement) const
@@ -218,19 +231,11 @@ bool Arch::normal_cluster_placement(const Context *ctx, const Cluster &packed_cl
                 return false;
         }
 
-        // Build a cell to bell mapping required to find BELs connected to the cluster ports.
-        dict<IdString, std::vector<IdString>> cell_bel_pins;
-
+        // Cell to bel pin mapping required to find BELs connected to the cluster ports.
         int32_t mapping = bel_info(chip_info, next_bel).pin_map[get_cell_type_index(cluster_node->type)];
         NPNR_ASSERT(mapping >= 0);
 
-        const CellBelMapPOD &cell_pin_map = chip_info->cell_map->cell_bel_map[mapping];
-        for (const auto &pin_map : cell_pin_map.common_pins) {
-            IdString cell_pin(pin_map.cell_pin);
-            IdString bel_pin(pin_map.bel_pin);
-
-            cell_bel_pins[cell_pin].push_back(bel_pin);
-        }
+        const dict<IdString, std::vector<IdString>> &cell_bel_pins = cell_bel_pins_for(mapping);
 
         placement.emplace_back(cluster_node, next_bel);
 
@@ -290,57 +295,28 @@ BelId check_and_return(int32_t tile, IdString name)
 
 void add_to_cache(int32_t tile, IdString name, BelId t) { tileAndBelNameToBelIdCache[tile][name] = t; }
 
-bool find_site_idx(const Context *ctx, const ClusterPOD &cluster, BelId root_bel, uint32_t &idx)
+const Arch::MacroClusterLookup &Arch::macro_cluster_lookup_for(uint32_t cluster_index, const ClusterPOD &cluster) const
 {
-    bool found = false;
-    const auto &site_inst = ctx->get_site_inst(root_bel);
-    IdString site_type(site_inst.site_type);
-
-    if (ctx->debug) {
-        log_info("%s\n", ctx->get_site_name(root_bel));
-        log_info("Root_bel site_type: %s\n", site_type.c_str(ctx));
-        log_info("Allowed site_types:\n");
-    }
-    for (const auto &site : cluster.physical_placements) {
-        IdString name(site.site_type);
-        if (ctx->debug)
-            log_info("\t%s\n", name.c_str(ctx));
+    auto fnd = macro_cluster_lookup.find(cluster_index);
+    if (fnd != macro_cluster_lookup.end())
+        return fnd->second;
 
-        if (name == site_type) {
-            found = true;
-            break;
+    MacroClusterLookup &lookup = macro_cluster_lookup[cluster_index];
+    uint32_t idx = 0;
+    for (const auto &site : cluster.physical_placements) {
+        // emplace keeps the first occurrence, matching the first-match
+        // linear scans this table replaces
+        lookup.site_type_idx.emplace(IdString(site.site_type), idx);
+        lookup.bel_to_placement.emplace_back();
+        uint32_t placement_idx = 0;
+        for (const auto &place : site.places) {
+            for (const auto bel : place.bels)
+                lookup.bel_to_placement.back().emplace(IdString(bel), placement_idx);
+            placement_idx++;
         }
         idx++;
     }
-    return found;
-}
-
-bool find_placement_idx(const Context *ctx, const ClusterPOD &cluster, BelId root_bel, uint32_t idx,
-                        uint32_t &placement_idx)
-{
-    bool found = false;
-    const auto &bel_data = bel_info(ctx->chip_info, root_bel);
-    IdString root_bel_name(bel_data.name);
-    if (ctx->debug) {
-        log_info("Root_bel name: %s\n", root_bel_name.c_str(ctx));
-        log_info("Allowed root_bels:\n");
-    }
-    for (const auto &place : cluster.physical_placements[idx].places) {
-        for (const auto bel : place.bels) {
-            IdString name(bel);
-            if (ctx->debug)
-                log_info("\t%s\n", name.c_str(ctx));
-
-            if (name == root_bel_name) {
-                found = true;
-                break;
-            }
-        }
-        if (found)
-            break;
-        placement_idx++;
-    }
-    return found;
+    return lookup;
 }
 
 dict<uint32_t, BelId> idx_bel_mapping(const Context *ctx, BelId root_bel, const ClusterPOD &cluster, uint32_t idx,
@@ -379,16 +355,28 @@ bool Arch::macro_cluster_placement(const Context *ctx, const Cluster &packed_clu
                                    CellInfo *root_cell, BelId root_bel,
                                    std::vector<std::pair<CellInfo *, BelId>> &placement) const
 {
-    // Check root_bel site_type
     const auto &cluster = cluster_info(chip_info, packed_cluster.index);
-    uint32_t idx = 0;
-    if (!find_site_idx(ctx, cluster, root_bel, idx))
+    const MacroClusterLookup &lookup = macro_cluster_lookup_for(packed_cluster.index, cluster);
+
+    // Check root_bel site_type
+    IdString site_type(ctx->get_site_inst(root_bel).site_type);
+    auto site_fnd = lookup.site_type_idx.find(site_type);
+    if (ctx->debug)
+        log_info("Root_bel %s site_type: %s (%s)\n", ctx->get_site_name(root_bel), site_type.c_str(ctx),
+                 site_fnd != lookup.site_type_idx.end() ? "allowed" : "not allowed");
+    if (site_fnd == lookup.site_type_idx.end())
         return false;
+    uint32_t idx = site_fnd->second;
 
-    // Check if root_bel name
-    uint32_t placement_idx = 0;
-    if (!find_placement_idx(ctx, cluster, root_bel, idx, placement_idx))
+    // Check root_bel name
+    IdString root_bel_name(bel_info(ctx->chip_info, root_bel).name);
+    auto place_fnd = lookup.bel_to_placement.at(idx).find(root_bel_name);
+    if (ctx->debug)
+        log_info("Root_bel name: %s (%s)\n", root_bel_name.c_str(ctx),
+                 place_fnd != lookup.bel_to_placement.at(idx).end() ? "allowed" : "not allowed");
+    if (place_fnd == lookup.bel_to_placement.at(idx).end())
         return false;
+    uint32_t placement_idx = place_fnd->second;
 
     // Map cells to bels
     dict<uint32_t, BelId> idx_bel_map = idx_bel_mapping(ctx, root_bel, cluster, idx, placement_idx);
@@ -112,6 +112,8 @@ struct ArchNetInfo
     virtual ~ArchNetInfo();
 
     SiteExpansionLoop *loop = nullptr;
+
+    bool is_global = false;
 };
 
 struct ArchCellInfo
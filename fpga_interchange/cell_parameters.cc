@@ -41,14 +41,20 @@ CellParameters::CellParameters()
 {
 }
 
-void CellParameters::init(const Context *ctx)
+// Parameter definitions are only consulted during packing (single-threaded),
+// and many runs never consult them at all, so the table is built on the
+// first lookup instead of at Arch::init
+void CellParameters::ensure_loaded(const Context *ctx) const
 {
+    if (loaded)
+        return;
     for (const CellParameterPOD &cell_parameter : ctx->chip_info->cell_map->cell_parameters) {
         IdString cell_type(cell_parameter.cell_type);
         IdString parameter(cell_parameter.parameter);
         auto result = parameters.emplace(std::make_pair(cell_type, parameter), &cell_parameter);
         NPNR_ASSERT(result.second);
     }
+    loaded = true;
 }
 
 static bool parse_int(const std::string &data, int64_t *result)
@@ -65,6 +71,7 @@ static bool parse_int(const std::string &data, int64_t *result)
 DynamicBitarray<> CellParameters::parse_int_like(const Context *ctx, IdString cell_type, IdString parameter,
                                                  const Property &property) const
 {
+    ensure_loaded(ctx);
     const CellParameterPOD *definition = parameters.at(std::make_pair(cell_type, parameter));
     DeviceResources::Device::ParameterFormat format;
     format = static_cast<DeviceResources::Device::ParameterFormat>(definition->format);
@@ -180,6 +187,7 @@ DynamicBitarray<> CellParameters::parse_int_like(const Context *ctx, IdString ce
 bool CellParameters::compare_property(const Context *ctx, IdString cell_type, IdString parameter,
                                       const Property &property, IdString value_to_compare) const
 {
+    ensure_loaded(ctx);
     const CellParameterPOD *definition = parameters.at(std::make_pair(cell_type, parameter));
     DeviceResources::Device::ParameterFormat format;
     format = static_cast<DeviceResources::Device::ParameterFormat>(definition->format);
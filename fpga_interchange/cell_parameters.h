@@ -35,13 +35,17 @@ struct Context;
 struct CellParameters
 {
     CellParameters();
-    void init(const Context *ctx);
     DynamicBitarray<> parse_int_like(const Context *ctx, IdString cell_type, IdString parameter,
                                      const Property &property) const;
     bool compare_property(const Context *ctx, IdString cell_type, IdString parameter, const Property &property,
                           IdString value_to_compare) const;
 
-    dict<std::pair<IdString, IdString>, const CellParameterPOD *> parameters;
+    // Populated lazily on the first lookup rather than at Arch::init; many
+    // runs never query a cell parameter, and building the table eagerly
+    // faults in the whole cell_parameters section of the mmap'd chipdb
+    mutable dict<std::pair<IdString, IdString>, const CellParameterPOD *> parameters;
+    mutable bool loaded = false;
+    void ensure_loaded(const Context *ctx) const;
 
     std::regex verilog_binary_re;
     std::regex verilog_hex_re;
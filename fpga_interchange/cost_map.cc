@@ -20,6 +20,10 @@
 
 #include "cost_map.h"
 
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <fstream>
+
 #include "context.h"
 #include "log.h"
 
@@ -96,8 +100,8 @@ delay_t CostMap::get_delay(const Context *ctx, WireId src_wire, WireId dst_wire)
     int32_t off_x = delay_matrix.offset.first + (dst_x - src_x);
     int32_t off_y = delay_matrix.offset.second + (dst_y - src_y);
 
-    int32_t x_dim = delay_matrix.data.shape()[0];
-    int32_t y_dim = delay_matrix.data.shape()[1];
+    int32_t x_dim = delay_matrix.x_dim;
+    int32_t y_dim = delay_matrix.y_dim;
     NPNR_ASSERT(x_dim > 0);
     NPNR_ASSERT(y_dim > 0);
 
@@ -106,7 +110,7 @@ delay_t CostMap::get_delay(const Context *ctx, WireId src_wire, WireId dst_wire)
     int32_t closest_y = std::min(std::max(off_y, 0), y_dim - 1);
 
     // Get the cost entry from the cost map at the deltas values
-    auto cost = delay_matrix.data[closest_x][closest_y];
+    auto cost = delay_matrix.at(closest_x, closest_y);
     NPNR_ASSERT(cost >= 0);
 
     // Get the base penalty corresponding to the current segment.
@@ -161,6 +165,8 @@ void CostMap::set_cost_map(const Context *ctx, const TypeWirePair &wire_pair,
         delay_matrix.data[off_x][off_y] = delay_pair.second;
     }
 
+    delay_matrix.x_dim = x_dim;
+    delay_matrix.y_dim = y_dim;
     delay_matrix.penalty = get_penalty(delay_matrix.data);
     fill_holes(ctx, wire_pair, delay_matrix.data, delay_matrix.penalty);
 
@@ -345,6 +351,11 @@ delay_t CostMap::get_penalty(const boost::multi_array<delay_t, 2> &matrix) const
 
 void CostMap::from_reader(lookahead_storage::CostMap::Reader reader)
 {
+    if (!cost_map_.empty()) {
+        // Already populated from the shared cache; the capnp lookahead is
+        // then only read for the site wire costs.
+        return;
+    }
     for (auto cost_entry : reader.getCostMap()) {
         TypeWirePair key(cost_entry.getKey());
 
@@ -367,11 +378,219 @@ void CostMap::from_reader(lookahead_storage::CostMap::Reader reader)
 
         entry.penalty = cost_entry.getPenalty();
 
+        entry.x_dim = cost_entry.getXDim();
+        entry.y_dim = cost_entry.getYDim();
         entry.offset.first = cost_entry.getXOffset();
         entry.offset.second = cost_entry.getYOffset();
     }
 }
 
+// On-disk layout of the shared cost map cache: a fixed header (magic,
+// version, chipdb hash), a table of SharedCostMapEntry records, then the
+// 8-byte-aligned matrix blobs the records point at. The file is written once
+// via temp-file-and-rename, so concurrent jobs either see a complete cache
+// or none, and is mapped read-only thereafter. Host byte order throughout -
+// this is a per-host cache, not an interchange format.
+namespace {
+constexpr uint32_t kSharedCostMapMagic = 0x4d435053; // 'SPCM'
+constexpr uint32_t kSharedCostMapVersion = 1;
+
+struct SharedCostMapHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t hash_length;
+    uint32_t entry_count;
+};
+
+struct SharedCostMapEntry
+{
+    int32_t src_type, src_index;
+    int32_t dst_type, dst_index;
+    int32_t x_dim, y_dim;
+    int32_t x_offset, y_offset;
+    int32_t penalty;
+    int32_t base_delay;
+    uint32_t compressed;
+    uint32_t padding;
+    uint64_t data_offset;
+};
+
+size_t align8(size_t offset) { return (offset + 7) & ~size_t(7); }
+} // namespace
+
+bool CostMap::open_shared(const std::string &filename, const std::string &chipdb_hash)
+{
+    NPNR_ASSERT(cost_map_.empty());
+    try {
+        shared_file_.open(filename.c_str());
+    } catch (std::ios_base::failure &fail) {
+        return false;
+    }
+    if (!shared_file_.is_open())
+        return false;
+
+    const char *data = shared_file_.data();
+    size_t size = shared_file_.size();
+    if (size < sizeof(SharedCostMapHeader)) {
+        shared_file_.close();
+        return false;
+    }
+
+    SharedCostMapHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != kSharedCostMapMagic || header.version != kSharedCostMapVersion ||
+        sizeof(header) + header.hash_length > size ||
+        chipdb_hash.compare(0, std::string::npos, data + sizeof(header), header.hash_length) != 0) {
+        // Stale or foreign cache; caller falls back to the capnp lookahead
+        shared_file_.close();
+        return false;
+    }
+
+    size_t table_offset = align8(sizeof(header) + header.hash_length);
+    if (table_offset + header.entry_count * sizeof(SharedCostMapEntry) > size) {
+        shared_file_.close();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header.entry_count; ++i) {
+        SharedCostMapEntry shared_entry;
+        memcpy(&shared_entry, data + table_offset + i * sizeof(SharedCostMapEntry), sizeof(shared_entry));
+
+        TypeWirePair key;
+        key.src.type = shared_entry.src_type;
+        key.src.index = shared_entry.src_index;
+        key.dst.type = shared_entry.dst_type;
+        key.dst.index = shared_entry.dst_index;
+
+        size_t num_elements = size_t(shared_entry.x_dim) * shared_entry.y_dim;
+        size_t element_size = shared_entry.compressed ? sizeof(uint16_t) : sizeof(delay_t);
+        if (shared_entry.data_offset + num_elements * element_size > size) {
+            shared_file_.close();
+            cost_map_.clear();
+            return false;
+        }
+
+        auto result = cost_map_.emplace(key, CostMapEntry());
+        NPNR_ASSERT(result.second);
+
+        CostMapEntry &entry = result.first->second;
+        if (shared_entry.compressed) {
+            entry.compressed16 = reinterpret_cast<const uint16_t *>(data + shared_entry.data_offset);
+        } else {
+            entry.raw = reinterpret_cast<const delay_t *>(data + shared_entry.data_offset);
+        }
+        entry.base_delay = shared_entry.base_delay;
+        entry.x_dim = shared_entry.x_dim;
+        entry.y_dim = shared_entry.y_dim;
+        entry.offset.first = shared_entry.x_offset;
+        entry.offset.second = shared_entry.y_offset;
+        entry.penalty = shared_entry.penalty;
+    }
+
+    return true;
+}
+
+void CostMap::close_shared()
+{
+    cost_map_.clear();
+    if (shared_file_.is_open())
+        shared_file_.close();
+}
+
+void CostMap::write_shared(const std::string &filename, const std::string &chipdb_hash) const
+{
+    SharedCostMapHeader header;
+    header.magic = kSharedCostMapMagic;
+    header.version = kSharedCostMapVersion;
+    header.hash_length = chipdb_hash.size();
+    header.entry_count = cost_map_.size();
+
+    size_t table_offset = align8(sizeof(header) + header.hash_length);
+
+    // First pass: lay the file out, deciding per matrix whether the delay
+    // range fits 16-bit deltas from the matrix minimum.
+    std::vector<SharedCostMapEntry> table;
+    table.reserve(cost_map_.size());
+    size_t data_offset = align8(table_offset + cost_map_.size() * sizeof(SharedCostMapEntry));
+    for (const auto &cost_pair : cost_map_) {
+        const CostMapEntry &entry = cost_pair.second;
+        size_t num_elements = size_t(entry.x_dim) * entry.y_dim;
+
+        delay_t min_delay = std::numeric_limits<delay_t>::max();
+        delay_t max_delay = std::numeric_limits<delay_t>::min();
+        for (size_t i = 0; i < num_elements; ++i) {
+            delay_t value = entry.at(i / entry.y_dim, i % entry.y_dim);
+            min_delay = std::min(min_delay, value);
+            max_delay = std::max(max_delay, value);
+        }
+
+        SharedCostMapEntry shared_entry;
+        shared_entry.src_type = cost_pair.first.src.type;
+        shared_entry.src_index = cost_pair.first.src.index;
+        shared_entry.dst_type = cost_pair.first.dst.type;
+        shared_entry.dst_index = cost_pair.first.dst.index;
+        shared_entry.x_dim = entry.x_dim;
+        shared_entry.y_dim = entry.y_dim;
+        shared_entry.x_offset = entry.offset.first;
+        shared_entry.y_offset = entry.offset.second;
+        shared_entry.penalty = entry.penalty;
+        shared_entry.base_delay = min_delay;
+        shared_entry.compressed = (int64_t(max_delay) - min_delay) <= std::numeric_limits<uint16_t>::max();
+        shared_entry.padding = 0;
+        shared_entry.data_offset = data_offset;
+
+        data_offset = align8(data_offset +
+                             num_elements * (shared_entry.compressed ? sizeof(uint16_t) : sizeof(delay_t)));
+        table.push_back(shared_entry);
+    }
+
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    {
+        std::ofstream out(temp.string(), std::ios_base::out | std::ios_base::binary);
+
+        auto pad_to = [&](size_t target) {
+            static const char zeros[8] = {};
+            size_t position = out.tellp();
+            NPNR_ASSERT(position <= target);
+            out.write(zeros, target - position);
+        };
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(chipdb_hash.data(), chipdb_hash.size());
+        pad_to(table_offset);
+        out.write(reinterpret_cast<const char *>(table.data()), table.size() * sizeof(SharedCostMapEntry));
+
+        size_t table_index = 0;
+        for (const auto &cost_pair : cost_map_) {
+            const CostMapEntry &entry = cost_pair.second;
+            const SharedCostMapEntry &shared_entry = table.at(table_index++);
+            size_t num_elements = size_t(entry.x_dim) * entry.y_dim;
+
+            pad_to(shared_entry.data_offset);
+            if (shared_entry.compressed) {
+                std::vector<uint16_t> deltas(num_elements);
+                for (size_t i = 0; i < num_elements; ++i)
+                    deltas[i] = entry.at(i / entry.y_dim, i % entry.y_dim) - shared_entry.base_delay;
+                out.write(reinterpret_cast<const char *>(deltas.data()), deltas.size() * sizeof(uint16_t));
+            } else {
+                std::vector<delay_t> values(num_elements);
+                for (size_t i = 0; i < num_elements; ++i)
+                    values[i] = entry.at(i / entry.y_dim, i % entry.y_dim);
+                out.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(delay_t));
+            }
+        }
+
+        out.close();
+        if (!out) {
+            boost::filesystem::remove(temp);
+            log_warning("Failed to write shared cost map cache to %s\n", temp.c_str());
+            return;
+        }
+    }
+    boost::filesystem::rename(temp, filename);
+}
+
 void CostMap::to_builder(lookahead_storage::CostMap::Builder builder) const
 {
     auto cost_map = builder.initCostMap(cost_map_.size());
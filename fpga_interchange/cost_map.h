@@ -21,8 +21,10 @@
 #ifndef COST_MAP_H
 #define COST_MAP_H
 
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/multi_array.hpp>
 #include <mutex>
+#include <string>
 
 #include "lookahead.capnp.h"
 #include "nextpnr_namespaces.h"
@@ -43,16 +45,49 @@ class CostMap
     void from_reader(lookahead_storage::CostMap::Reader reader);
     void to_builder(lookahead_storage::CostMap::Builder builder) const;
 
+    // Shared cost map cache. write_shared() dumps the matrices into a flat
+    // cache file next to the chipdb; open_shared() maps that file read-only,
+    // so concurrent jobs against the same chipdb share one page-cache copy
+    // of the cost data instead of each deserialising a private heap copy.
+    // Matrices whose delay range fits in 16 bits are stored as deltas from
+    // the matrix minimum at half the footprint. The cache is validated
+    // against the chipdb hash and rebuilt if stale.
+    bool open_shared(const std::string &filename, const std::string &chipdb_hash);
+    void write_shared(const std::string &filename, const std::string &chipdb_hash) const;
+    // Drop mapped entries again (e.g. the capnp lookahead turned out stale
+    // and the map is about to be rebuilt)
+    void close_shared();
+
   private:
     struct CostMapEntry
     {
+        // Owned storage, used when the map was built or deserialised in
+        // this process
         boost::multi_array<delay_t, 2> data;
+        // Read-only views into the shared cache mapping. When compressed16
+        // is set the matrix is stored as 16-bit deltas from base_delay;
+        // otherwise raw points at full-width values.
+        const delay_t *raw = nullptr;
+        const uint16_t *compressed16 = nullptr;
+        delay_t base_delay = 0;
+        int32_t x_dim = 0, y_dim = 0;
         std::pair<int32_t, int32_t> offset;
         delay_t penalty;
+
+        delay_t at(int32_t x, int32_t y) const
+        {
+            size_t index = size_t(x) * y_dim + y;
+            if (compressed16 != nullptr)
+                return base_delay + compressed16[index];
+            if (raw != nullptr)
+                return raw[index];
+            return data.origin()[index];
+        }
     };
 
     std::mutex cost_map_mutex_;
     dict<TypeWirePair, CostMapEntry> cost_map_;
+    boost::iostreams::mapped_file_source shared_file_;
 
     void fill_holes(const Context *ctx, const TypeWirePair &wire_pair, boost::multi_array<delay_t, 2> &matrix,
                     delay_t delay_penality);
@@ -318,11 +318,20 @@ bool DedicatedInterconnect::is_driver_on_net_valid(BelId driver_bel, const CellI
                 }
 
                 // Do detailed routing check to ensure driver can reach sink.
-                //
-                // FIXME: This might be too slow, but it handles a case on
-                // SLICEL.COUT -> SLICEL.CIN has delta_y = {1, 2}, but the
-                // delta_y=2 case is rare.
-                if (!check_routing(driver_bel, driver_bel_pin, sink_bel, sink_bel_pin, /*site_only=*/false)) {
+                // The type+delta match above can have false positives, e.g.
+                // SLICEL.COUT -> SLICEL.CIN has delta_y = {1, 2} but only one
+                // delta is real for a given pair of tiles. The exact routes
+                // recorded during discovery answer the common accept case in
+                // one lookup; fall back to a routing graph walk on a miss,
+                // because discovery from this location may have aborted early
+                // and discarded pairs that are individually routable.
+                DedicatedRoute route;
+                route.src_bel = driver_bel;
+                route.src_bel_pin = driver_bel_pin;
+                route.dst_bel = sink_bel;
+                route.dst_bel_pin = sink_bel_pin;
+                if (!routes.count(route) &&
+                    !check_routing(driver_bel, driver_bel_pin, sink_bel, sink_bel_pin, /*site_only=*/false)) {
                     if (ctx->debug) {
                         log_info("BEL %s is not valid because pin %s cannot be reach %s/%s (via detailed check)\n",
                                  ctx->nameOfBel(driver_bel), driver_bel_pin.c_str(ctx), ctx->nameOfBel(sink_bel),
@@ -397,12 +406,16 @@ bool DedicatedInterconnect::is_sink_on_net_valid(BelId bel, const CellInfo *cell
             return false;
         }
 
-        // Do detailed routing check to ensure driver can reach sink.
-        //
-        // FIXME: This might be too slow, but it handles a case on
-        // SLICEL.COUT -> SLICEL.CIN has delta_y = {1, 2}, but the
-        // delta_y=2 case is rare.
-        if (!check_routing(driver_bel, driver_type_bel_pin.type_bel_pin.bel_pin, bel, bel_pin, /*site_only=*/false)) {
+        // Do detailed routing check to ensure driver can reach sink; as in
+        // is_driver_on_net_valid, the exact route index handles the common
+        // accept case in one lookup and a miss falls back to a full walk.
+        DedicatedRoute route;
+        route.src_bel = driver_bel;
+        route.src_bel_pin = driver_type_bel_pin.type_bel_pin.bel_pin;
+        route.dst_bel = bel;
+        route.dst_bel_pin = bel_pin;
+        if (!routes.count(route) &&
+            !check_routing(driver_bel, driver_type_bel_pin.type_bel_pin.bel_pin, bel, bel_pin, /*site_only=*/false)) {
             if (ctx->debug) {
                 log_info("BEL %s is not valid because pin %s cannot be driven by %s/%s (via detailed check)\n",
                          ctx->nameOfBel(bel), bel_pin.c_str(ctx), ctx->nameOfBel(driver_bel),
@@ -630,6 +643,7 @@ void DedicatedInterconnect::expand_sink_bel(BelId sink_bel, IdString sink_pin, W
 
     Loc sink_loc = ctx->getBelLocation(sink_bel);
     pool<DeltaTileTypeBelPin> srcs;
+    pool<DedicatedRoute> route_pairs;
 
     while (!nodes_to_expand.empty()) {
         WireNode node_to_expand = nodes_to_expand.back();
@@ -734,6 +748,13 @@ void DedicatedInterconnect::expand_sink_bel(BelId sink_bel, IdString sink_pin, W
                     delta_type_bel_pin.type_bel_pin.bel_index = src_bel.index;
                     delta_type_bel_pin.type_bel_pin.bel_pin = bel_pin.pin;
                     srcs.emplace(delta_type_bel_pin);
+
+                    DedicatedRoute route;
+                    route.src_bel = src_bel;
+                    route.src_bel_pin = bel_pin.pin;
+                    route.dst_bel = sink_bel;
+                    route.dst_bel_pin = sink_pin;
+                    route_pairs.emplace(route);
                 }
             }
         }
@@ -752,6 +773,12 @@ void DedicatedInterconnect::expand_sink_bel(BelId sink_bel, IdString sink_pin, W
             result.first->second.emplace(src);
         }
     }
+
+    // Only commit exact routes once the expansion has completed; an early
+    // return above discards them along with the type+delta patterns.
+    for (const auto &route : route_pairs) {
+        routes.emplace(route);
+    }
 }
 
 void DedicatedInterconnect::expand_source_bel(BelId src_bel, IdString src_pin, WireId src_wire)
@@ -775,6 +802,7 @@ void DedicatedInterconnect::expand_source_bel(BelId src_bel, IdString src_pin, W
 
     Loc src_loc = ctx->getBelLocation(src_bel);
     pool<DeltaTileTypeBelPin> dsts;
+    pool<DedicatedRoute> route_pairs;
 
     while (!nodes_to_expand.empty()) {
         WireNode node_to_expand = nodes_to_expand.back();
@@ -879,6 +907,13 @@ void DedicatedInterconnect::expand_source_bel(BelId src_bel, IdString src_pin, W
                     delta_type_bel_pin.type_bel_pin.bel_index = sink_bel.index;
                     delta_type_bel_pin.type_bel_pin.bel_pin = bel_pin.pin;
                     dsts.emplace(delta_type_bel_pin);
+
+                    DedicatedRoute route;
+                    route.src_bel = src_bel;
+                    route.src_bel_pin = src_pin;
+                    route.dst_bel = sink_bel;
+                    route.dst_bel_pin = bel_pin.pin;
+                    route_pairs.emplace(route);
                 }
             }
         }
@@ -897,6 +932,10 @@ void DedicatedInterconnect::expand_source_bel(BelId src_bel, IdString src_pin, W
             result.first->second.emplace(dst);
         }
     }
+
+    for (const auto &route : route_pairs) {
+        routes.emplace(route);
+    }
 }
 
 NEXTPNR_NAMESPACE_END
@@ -78,6 +78,27 @@ struct DeltaTileTypeBelPin
     unsigned int hash() const { return mkhash(mkhash(delta_x, delta_y), type_bel_pin.hash()); }
 };
 
+// An exact (source bel pin, sink bel pin) pair reachable over dedicated
+// interconnect, recorded per device location rather than per tile type.
+struct DedicatedRoute
+{
+    BelId src_bel;
+    IdString src_bel_pin;
+    BelId dst_bel;
+    IdString dst_bel_pin;
+
+    bool operator==(const DedicatedRoute &other) const
+    {
+        return src_bel == other.src_bel && src_bel_pin == other.src_bel_pin && dst_bel == other.dst_bel &&
+               dst_bel_pin == other.dst_bel_pin;
+    }
+    bool operator!=(const DedicatedRoute &other) const { return !(*this == other); }
+    unsigned int hash() const
+    {
+        return mkhash(mkhash(src_bel.hash(), src_bel_pin.hash()), mkhash(dst_bel.hash(), dst_bel_pin.hash()));
+    }
+};
+
 struct Context;
 
 // This class models dedicated interconnect present in the given fabric.
@@ -100,6 +121,13 @@ struct DedicatedInterconnect
     dict<TileTypeBelPin, pool<DeltaTileTypeBelPin>> sinks;
     dict<TileTypeBelPin, pool<DeltaTileTypeBelPin>> sources;
 
+    // Exact per-location routes backing the type+delta tables above. The
+    // discovery expansions already visit every bel pin on the device, so the
+    // concrete pairs they reach are recorded here and placement probes that
+    // pass the type+delta check become a single hash lookup instead of
+    // re-walking the routing graph for each probe.
+    pool<DedicatedRoute> routes;
+
     void init(const Context *ctx);
 
     // Is this BEL placed in a location that is valid based on dedicated
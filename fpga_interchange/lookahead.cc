@@ -26,6 +26,7 @@
 #include <capnp/serialize.h>
 #include <kj/filesystem.h>
 #include <kj/std/iostream.h>
+#include <fstream>
 #include <queue>
 #include <sstream>
 #include <zlib.h>
@@ -885,10 +886,28 @@ void Lookahead::build_lookahead(const Context *ctx, DeterministicRNG *rng)
     }
 
     // Expand backwards from each input site wire to find the cheapest
-    // non-site wire.
+    // non-site wire. Each entry only writes its own cost vector, so under
+    // TBB the wire types are expanded in parallel; per-task RNG copies
+    // follow the same convention as expand_tile_type_parallel below.
+#if defined(NEXTPNR_USE_TBB) // Run parallely
+    {
+        std::vector<std::pair<TypeWireId, std::vector<InputSiteWireCost>> *> input_wire_entries;
+        input_wire_entries.reserve(input_site_wires.size());
+        for (auto &input_pair : input_site_wires) {
+            input_wire_entries.push_back(&input_pair);
+        }
+        tbb::parallel_for_each(input_wire_entries,
+                               [&](std::pair<TypeWireId, std::vector<InputSiteWireCost>> *input_pair) {
+                                   DeterministicRNG rng_copy = *rng;
+                                   expand_input_type(ctx, &rng_copy, tiles_of_type[input_pair->first.type],
+                                                     input_pair->first, &input_pair->second);
+                               });
+    }
+#else
     for (auto &input_pair : input_site_wires) {
         expand_input_type(ctx, rng, tiles_of_type[input_pair.first.type], input_pair.first, &input_pair.second);
     }
+#endif
 
     if (ctx->verbose) {
         log_info("Expanding output site wires\n");
@@ -896,6 +915,42 @@ void Lookahead::build_lookahead(const Context *ctx, DeterministicRNG *rng)
 
     // Expand forward from each output site wire to find the cheapest
     // non-site wire.
+#if defined(NEXTPNR_USE_TBB) // Run parallely
+    {
+        struct OutputExpandJob
+        {
+            TypeWireId wire;
+            OutputSiteWireCost *cost;
+        };
+        std::vector<OutputExpandJob> output_jobs;
+        output_jobs.reserve(output_site_wires.size() + input_site_ports.size());
+        for (auto &output_pair : output_site_wires) {
+            output_pair.second.cost = std::numeric_limits<delay_t>::max();
+            output_jobs.push_back(OutputExpandJob{output_pair.first, &output_pair.second});
+        }
+        for (TypeWireId input_site_port : input_site_ports) {
+            output_jobs.push_back(OutputExpandJob{input_site_port, nullptr});
+        }
+
+        // Each task expands into its own site-to-site shard, min-merged
+        // into the shared map afterwards, so no lock is held during
+        // expansion and the merge order cannot change the result.
+        std::mutex site_to_site_mutex;
+        tbb::parallel_for_each(output_jobs, [&](const OutputExpandJob &job) {
+            DeterministicRNG rng_copy = *rng;
+            dict<TypeWirePair, delay_t> site_to_site_shard;
+            expand_output_type(ctx, &rng_copy, tiles_of_type[job.wire.type], job.wire, job.cost, &site_to_site_shard);
+
+            std::lock_guard<std::mutex> guard(site_to_site_mutex);
+            for (const auto &cost_pair : site_to_site_shard) {
+                auto result = site_to_site_cost.emplace(cost_pair.first, cost_pair.second);
+                if (!result.second && result.first->second > cost_pair.second) {
+                    result.first->second = cost_pair.second;
+                }
+            }
+        });
+    }
+#else
     for (auto &output_pair : output_site_wires) {
         output_pair.second.cost = std::numeric_limits<delay_t>::max();
         expand_output_type(ctx, rng, tiles_of_type[output_pair.first.type], output_pair.first, &output_pair.second,
@@ -904,6 +959,7 @@ void Lookahead::build_lookahead(const Context *ctx, DeterministicRNG *rng)
     for (TypeWireId input_site_port : input_site_ports) {
         expand_output_type(ctx, rng, tiles_of_type[input_site_port.type], input_site_port, nullptr, &site_to_site_cost);
     }
+#endif
 
     if (ctx->verbose) {
         log_info("Expanding all wire types\n");
@@ -1010,62 +1066,81 @@ void Lookahead::build_lookahead(const Context *ctx, DeterministicRNG *rng)
 
 constexpr static bool kUseGzipForLookahead = false;
 
-static void write_message(::capnp::MallocMessageBuilder &message, const std::string &filename)
+// kj output stream that writes through zlib, so the serialised message can
+// be streamed straight into the compressed file.
+class GzOutputStream : public kj::OutputStream
 {
-    kj::Array<capnp::word> words = messageToFlatArray(message);
-    kj::ArrayPtr<kj::byte> bytes = words.asBytes();
-
-    boost::filesystem::path temp = boost::filesystem::unique_path();
-    log_info("Writing tempfile to %s\n", temp.c_str());
-
-    if (kUseGzipForLookahead) {
-        gzFile file = gzopen(temp.c_str(), "w");
-        NPNR_ASSERT(file != Z_NULL);
+  public:
+    explicit GzOutputStream(gzFile file) : file(file) {}
 
+    void write(const void *buffer, size_t size) override
+    {
+        if (!error_str.empty()) {
+            return;
+        }
         size_t bytes_written = 0;
-        int result;
-        while (bytes_written < bytes.size()) {
-            size_t bytes_remaining = bytes.size() - bytes_written;
-            size_t bytes_to_write = bytes_remaining;
+        while (bytes_written < size) {
+            size_t bytes_to_write = size - bytes_written;
             if (bytes_to_write >= std::numeric_limits<int>::max()) {
                 bytes_to_write = std::numeric_limits<int>::max();
             }
-            result = gzwrite(file, &bytes[0] + bytes_written, bytes_to_write);
-            if (result < 0) {
-                break;
+            int result = gzwrite(file, static_cast<const char *>(buffer) + bytes_written, bytes_to_write);
+            if (result <= 0) {
+                int error;
+                error_str.assign(gzerror(file, &error));
+                if (error_str.empty()) {
+                    error_str = "short write";
+                }
+                return;
             }
 
             bytes_written += result;
         }
+    }
 
-        int error;
-        std::string error_str;
-        if (result < 0) {
-            error_str.assign(gzerror(file, &error));
-        }
+    std::string error_str;
+
+  private:
+    gzFile file;
+};
+
+static void write_message(::capnp::MallocMessageBuilder &message, const std::string &filename)
+{
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    log_info("Writing tempfile to %s\n", temp.c_str());
+
+    // The message is streamed out segment by segment rather than being
+    // flattened first, so the serialisation is never materialised in memory
+    // alongside the builder. The wire format is unchanged (this is the same
+    // framing messageToFlatArray produces), keeping the mmap read path.
+    if (kUseGzipForLookahead) {
+        gzFile file = gzopen(temp.c_str(), "w");
+        NPNR_ASSERT(file != Z_NULL);
+
+        GzOutputStream stream(file);
+        capnp::writeMessage(stream, message);
+
+        std::string error_str = stream.error_str;
         NPNR_ASSERT(gzclose(file) == Z_OK);
-        if (bytes_written != bytes.size()) {
+
+        if (!error_str.empty()) {
             // Remove failed writes before reporting error.
             boost::filesystem::remove(temp);
-        }
-
-        if (result < 0) {
             log_error("Failed to write lookahead, error from gzip %s\n", error_str.c_str());
         } else {
-            if (bytes_written != bytes.size()) {
-                log_error("Failed to write lookahead, wrote %d bytes, had %zu bytes\n", result, bytes.size());
-            } else {
-                // Written, move file into place
-                boost::filesystem::rename(temp, filename);
-            }
+            // Written, move file into place
+            boost::filesystem::rename(temp, filename);
         }
     } else {
         {
-            kj::Own<kj::Filesystem> fs = kj::newDiskFilesystem();
-
-            auto path = kj::Path::parse(temp);
-            auto file = fs->getCurrent().openFile(path, kj::WriteMode::CREATE);
-            file->writeAll(bytes);
+            std::ofstream out(temp.string(), std::ios_base::out | std::ios_base::binary);
+            kj::std::StdOutputStream ostream(out);
+            capnp::writeMessage(ostream, message);
+            out.close();
+            if (!out) {
+                boost::filesystem::remove(temp);
+                log_error("Failed to write lookahead to %s\n", temp.c_str());
+            }
         }
 
         boost::filesystem::rename(temp, filename);
@@ -1149,13 +1224,27 @@ void Lookahead::init(const Context *ctx, DeterministicRNG *rng)
     }
 
     std::string chipdb_hash = ctx->get_chipdb_hash();
+    std::string shared_filename = ctx->args.chipdb + ".lookahead.shared";
+
+    // Map the shared cost map cache first when present: the matrices (the
+    // bulk of the lookahead) are then read in place from one per-host copy,
+    // and read_lookahead() below only deserialises the site wire costs.
+    bool have_shared = !ctx->args.rebuild_lookahead && cost_map.open_shared(shared_filename, chipdb_hash);
 
     if (ctx->args.rebuild_lookahead || !read_lookahead(chipdb_hash, lookahead_filename)) {
+        if (have_shared) {
+            cost_map.close_shared();
+            have_shared = false;
+        }
         build_lookahead(ctx, rng);
         if (!ctx->args.dont_write_lookahead) {
             write_lookahead(chipdb_hash, lookahead_filename);
         }
     }
+
+    if (!have_shared && !ctx->args.dont_write_lookahead) {
+        cost_map.write_shared(shared_filename, chipdb_hash);
+    }
 }
 
 static bool safe_add_i32(int32_t a, int32_t b, int32_t *out)
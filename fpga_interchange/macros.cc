@@ -48,6 +48,105 @@ static IdString derived_name(Context *ctx, IdString base_name, IdString suffix)
     return ctx->id(stringf("%s/%s", base_name.c_str(ctx), suffix.c_str(ctx)));
 }
 
+namespace {
+
+// A macro type's internal netlist, resolved from the chipdb PODs once per
+// type: names interned, instance references turned into indices and
+// constant parameter values converted up front. Stamping an instance is
+// then indexed work rather than per-instance string building and linear
+// chipdb scans
+struct MacroTemplate
+{
+    struct Inst
+    {
+        IdString name, type;
+        std::vector<std::pair<IdString, Property>> params;
+    };
+
+    struct NetPort
+    {
+        int inst; // index into insts
+        IdString port;
+        PortType dir;
+    };
+
+    struct Net
+    {
+        IdString name;
+        // pre-expansion primitive port this net aliases, if any
+        IdString top_port;
+        std::vector<NetPort> ports;
+    };
+
+    struct ParamRule
+    {
+        const MacroParamMapRulePOD *rule;
+        IdString prim_param, inst_param;
+        int inst; // index into insts
+    };
+
+    bool resolved = false;
+    // is_macro is false for primitive types that expand to nothing
+    bool is_macro = false;
+    const MacroExpansionPOD *exp = nullptr;
+    std::vector<Inst> insts;
+    std::vector<Net> nets;
+    std::vector<ParamRule> param_rules;
+};
+
+} // namespace
+
+static void build_macro_template(Context *ctx, const ChipInfoPOD *chip, IdString cell_type, MacroTemplate &templ)
+{
+    templ.resolved = true;
+    templ.exp = lookup_macro_rules(chip, cell_type);
+    const MacroPOD *macro = lookup_macro(chip, templ.exp ? IdString(templ.exp->macro_name) : cell_type);
+    if (macro == nullptr)
+        return;
+    templ.is_macro = true;
+
+    dict<IdString, int> inst_idx;
+    for (const auto &inst : macro->cell_insts) {
+        MacroTemplate::Inst ti;
+        ti.name = IdString(inst.name);
+        ti.type = IdString(inst.type);
+        for (const auto &param : inst.parameters)
+            ti.params.emplace_back(IdString(param.key), Property(IdString(param.value).str(ctx)));
+        inst_idx[ti.name] = int(templ.insts.size());
+        templ.insts.push_back(std::move(ti));
+    }
+
+    for (const auto &net_data : macro->nets) {
+        MacroTemplate::Net tn;
+        tn.name = IdString(net_data.name);
+        for (const auto &net_port : net_data.ports) {
+            if (net_port.instance == 0) {
+                // TODO: case of multiple top level ports on the same net?
+                NPNR_ASSERT(tn.top_port == IdString());
+                tn.top_port = IdString(net_port.port);
+                continue;
+            }
+            MacroTemplate::NetPort tp;
+            tp.inst = inst_idx.at(IdString(net_port.instance));
+            tp.port = IdString(net_port.port);
+            tp.dir = PortType(net_port.dir);
+            tn.ports.push_back(tp);
+        }
+        templ.nets.push_back(std::move(tn));
+    }
+
+    if (templ.exp != nullptr) {
+        for (const auto &param_rule : templ.exp->param_rules) {
+            MacroTemplate::ParamRule tr;
+            tr.rule = &param_rule;
+            tr.prim_param = IdString(param_rule.prim_param);
+            tr.inst_param = IdString(param_rule.inst_param);
+            tr.inst = inst_idx.at(IdString(param_rule.inst_name));
+            templ.param_rules.push_back(tr);
+        }
+    }
+}
+
 void Arch::expand_macros()
 {
     log_info("Expand macros\n");
@@ -59,101 +158,98 @@ void Arch::expand_macros()
 
     std::vector<CellInfo *> next_cells;
 
+    // Pre-resolved expansion templates, built once per primitive type
+    dict<IdString, MacroTemplate> templates;
+    // Cells stamped out for the instance being expanded, aligned with
+    // MacroTemplate::insts
+    std::vector<CellInfo *> inst_cells;
+
     bool first_iter = false;
     do {
         // Expand cells
         for (auto cell : cells) {
             // TODO: consult exception map
-            const MacroExpansionPOD *exp = lookup_macro_rules(chip_info, cell->type);
+            MacroTemplate &templ = templates[cell->type];
+            if (!templ.resolved)
+                build_macro_template(ctx, chip_info, cell->type, templ);
 
             // Block infinite expansion loop due to a macro being expanded in the same primitive.
             // E.g.: OBUFTDS expands into the following cells, with an infinite loop being generated:
             //          - 2 OBUFTDS
             //          - 1 INV
-            if (exp && first_iter)
+            if (templ.exp && first_iter)
                 continue;
 
-            const MacroPOD *macro = lookup_macro(chip_info, exp ? IdString(exp->macro_name) : cell->type);
-            if (macro == nullptr)
+            if (!templ.is_macro)
                 continue;
 
             // Get the ultimate root of this macro expansion
             IdString parent = (cell->macro_parent == IdString()) ? cell->name : cell->macro_parent;
             // Create child instances
-            for (const auto &inst : macro->cell_insts) {
-                CellInfo *inst_cell =
-                        ctx->createCell(derived_name(ctx, cell->name, IdString(inst.name)), IdString(inst.type));
-                for (const auto &param : inst.parameters) {
-                    inst_cell->params[IdString(param.key)] = IdString(param.value).str(ctx);
-                }
+            inst_cells.clear();
+            for (const auto &inst : templ.insts) {
+                CellInfo *inst_cell = ctx->createCell(derived_name(ctx, cell->name, inst.name), inst.type);
+                for (const auto &param : inst.params)
+                    inst_cell->params[param.first] = param.second;
                 inst_cell->macro_parent = parent;
+                inst_cells.push_back(inst_cell);
                 next_cells.push_back(inst_cell);
             }
             // Create and connect nets
-            for (const auto &net_data : macro->nets) {
+            for (const auto &net_data : templ.nets) {
                 NetInfo *net = nullptr;
                 // If there is a top level port, use that as the net
-                for (const auto &net_port : net_data.ports) {
-                    if (net_port.instance != 0)
-                        continue;
-                    // TODO: case of multiple top level ports on the same net?
-                    NPNR_ASSERT(net == nullptr);
+                if (net_data.top_port != IdString()) {
                     // Use the corresponding pre-expansion port net
-                    net = get_net_or_empty(cell, IdString(net_port.port));
+                    net = get_net_or_empty(cell, net_data.top_port);
                     // Disconnect the original port pre-expansion
-                    disconnect_port(ctx, cell, IdString(net_port.port));
+                    disconnect_port(ctx, cell, net_data.top_port);
                 }
                 // If not on a top level port, create a new net
                 if (net == nullptr)
-                    net = ctx->createNet(derived_name(ctx, cell->name, IdString(net_data.name)));
+                    net = ctx->createNet(derived_name(ctx, cell->name, net_data.name));
                 // Create and connect instance ports
                 for (const auto &net_port : net_data.ports) {
-                    if (net_port.instance == 0)
-                        continue;
-                    IdString port_name(net_port.port);
-                    CellInfo *inst_cell =
-                            ctx->cells.at(derived_name(ctx, cell->name, IdString(net_port.instance))).get();
-                    inst_cell->ports[port_name].name = port_name;
-                    inst_cell->ports[port_name].type = PortType(net_port.dir);
-                    connect_port(ctx, net, inst_cell, port_name);
+                    CellInfo *inst_cell = inst_cells.at(net_port.inst);
+                    inst_cell->ports[net_port.port].name = net_port.port;
+                    inst_cell->ports[net_port.port].type = net_port.dir;
+                    connect_port(ctx, net, inst_cell, net_port.port);
                 }
             }
 
-            if (exp != nullptr) {
-                // Convert parameters, according to the exception rules
-                for (const auto &param_rule : exp->param_rules) {
-                    IdString prim_param(param_rule.prim_param);
-                    if (!cell->params.count(prim_param))
-                        continue;
-                    const auto &prim_param_val = cell->params.at(prim_param);
-                    IdString inst_name = derived_name(ctx, cell->name, IdString(param_rule.inst_name));
-                    CellInfo *inst_cell = ctx->cells.at(inst_name).get();
-                    IdString inst_param(param_rule.inst_param);
-                    if (param_rule.rule_type == PARAM_MAP_COPY) {
-                        inst_cell->params[inst_param] = prim_param_val;
-                    } else if (param_rule.rule_type == PARAM_MAP_SLICE) {
-                        auto prim_bits = cell_parameters.parse_int_like(ctx, cell->type, prim_param, prim_param_val);
-                        Property value(0, param_rule.slice_bits.ssize());
-                        for (int i = 0; i < param_rule.slice_bits.ssize(); i++) {
-                            size_t bit = param_rule.slice_bits[i];
-                            if (bit >= prim_bits.size())
-                                continue;
-                            value.str.at(i) = prim_bits.get(bit) ? Property::S1 : Property::S0;
-                        }
-                        inst_cell->params[inst_param] = value;
-                    } else if (param_rule.rule_type == PARAM_MAP_TABLE) {
-                        const std::string &prim_str = prim_param_val.as_string();
-                        IdString prim_id = ctx->id(prim_str);
-                        for (auto &tbl_entry : param_rule.map_table) {
-                            if (IdString(tbl_entry.key) == prim_id) {
-                                inst_cell->params[inst_param] = IdString(tbl_entry.value).str(ctx);
-                                break;
-                            }
+            // Convert parameters, according to the exception rules
+            for (const auto &param_rule : templ.param_rules) {
+                if (!cell->params.count(param_rule.prim_param))
+                    continue;
+                const auto &prim_param_val = cell->params.at(param_rule.prim_param);
+                CellInfo *inst_cell = inst_cells.at(param_rule.inst);
+                IdString inst_param = param_rule.inst_param;
+                const MacroParamMapRulePOD &rule = *param_rule.rule;
+                if (rule.rule_type == PARAM_MAP_COPY) {
+                    inst_cell->params[inst_param] = prim_param_val;
+                } else if (rule.rule_type == PARAM_MAP_SLICE) {
+                    auto prim_bits =
+                            cell_parameters.parse_int_like(ctx, cell->type, param_rule.prim_param, prim_param_val);
+                    Property value(0, rule.slice_bits.ssize());
+                    for (int i = 0; i < rule.slice_bits.ssize(); i++) {
+                        size_t bit = rule.slice_bits[i];
+                        if (bit >= prim_bits.size())
+                            continue;
+                        value.str.rw().at(i) = prim_bits.get(bit) ? Property::S1 : Property::S0;
+                    }
+                    inst_cell->params[inst_param] = value;
+                } else if (rule.rule_type == PARAM_MAP_TABLE) {
+                    const std::string &prim_str = prim_param_val.as_string();
+                    IdString prim_id = ctx->id(prim_str);
+                    for (auto &tbl_entry : rule.map_table) {
+                        if (IdString(tbl_entry.key) == prim_id) {
+                            inst_cell->params[inst_param] = IdString(tbl_entry.value).str(ctx);
+                            break;
                         }
-                        if (!inst_cell->params.count(inst_param))
-                            log_error("Unsupported value '%s' for property '%s' of cell %s:%s\n", prim_str.c_str(),
-                                      ctx->nameOf(prim_param), ctx->nameOf(cell), ctx->nameOf(cell->type));
                     }
+                    if (!inst_cell->params.count(inst_param))
+                        log_error("Unsupported value '%s' for property '%s' of cell %s:%s\n", prim_str.c_str(),
+                                  ctx->nameOf(param_rule.prim_param), ctx->nameOf(cell), ctx->nameOf(cell->type));
                 }
             }
 
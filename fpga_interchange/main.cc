@@ -58,6 +58,7 @@ po::options_description FpgaInterchangeCommandHandler::getArchOptions()
     specific.add_options()("rebuild-lookahead", "Ignore lookahead cache and rebuild");
     specific.add_options()("dont-write-lookahead", "Don't write the lookahead file");
     specific.add_options()("disable-lut-mapping-cache", "Disable caching of LUT mapping solutions in site router");
+    specific.add_options()("place-drc", "Re-validate all occupied sites in parallel after placement");
 
     return specific;
 }
@@ -78,6 +79,7 @@ std::unique_ptr<Context> FpgaInterchangeCommandHandler::createContext(dict<std::
     chipArgs.rebuild_lookahead = vm.count("rebuild_lookahead") != 0;
     chipArgs.dont_write_lookahead = vm.count("dont_write_lookahead") != 0;
     chipArgs.disable_lut_mapping_cache = vm.count("disable-lut-mapping-cache") != 0;
+    chipArgs.place_drc = vm.count("place-drc") != 0;
 
     if (!vm.count("chipdb")) {
         log_error("chip database binary must be provided\n");
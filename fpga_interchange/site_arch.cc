@@ -275,6 +275,60 @@ SiteArch::SiteArch(const SiteInformation *site_info) : ctx(site_info->ctx), site
         }
     }
 
+    // Precompute the merged downhill pip adjacency for every wire the site
+    // router can visit, in the same order the downhill iterator used to
+    // produce it, so getPipsDownhill is a plain array walk from here on.
+    site_wire_downhill.resize(tile_type.wire_data.size());
+    for (size_t wire_index = 0; wire_index < tile_type.wire_data.size(); ++wire_index) {
+        const auto &wire_data = tile_type.wire_data[wire_index];
+        if (wire_data.site != site_info->site) {
+            continue;
+        }
+
+        PipsDownhillSlice &slice = site_wire_downhill[wire_index];
+        slice.offset = int32_t(pips_downhill_storage.size());
+        for (int32_t pip_index : wire_data.pips_downhill) {
+            pip.index = pip_index;
+            pips_downhill_storage.push_back(SitePip::make(site_info, pip));
+        }
+        slice.length = int32_t(pips_downhill_storage.size()) - slice.offset;
+    }
+
+    port_sink_downhill.resize(output_site_ports.size());
+    for (size_t i = 0; i < output_site_ports.size(); ++i) {
+        std::vector<SitePip> &pips = port_sink_downhill[i];
+        pips.reserve(input_site_ports.size() + out_of_site_sinks.size());
+        for (PipId input_port : input_site_ports) {
+            pips.push_back(SitePip::make(site_info, output_site_ports[i], input_port));
+        }
+        for (const SiteWire &sink : out_of_site_sinks) {
+            pips.push_back(SitePip::make(site_info, output_site_ports[i], sink));
+        }
+    }
+
+    // Key the out of site source lists off the net drivers rather than
+    // out_of_site_sources, so that the synthesized VCC driver (which is not
+    // part of that list) gets an entry too.
+    for (auto &net_pair : nets) {
+        const SiteWire &driver = net_pair.second.driver;
+        if (driver.type != SiteWire::OUT_OF_SITE_SOURCE) {
+            continue;
+        }
+
+        out_of_site_source_wires.push_back(driver);
+        out_of_site_source_downhill.emplace_back();
+        std::vector<SitePip> &pips = out_of_site_source_downhill.back();
+        pips.reserve(input_site_ports.size());
+        for (PipId input_port : input_site_ports) {
+            pips.push_back(SitePip::make(site_info, driver, input_port));
+        }
+    }
+
+    port_source_downhill.reserve(input_site_ports.size());
+    for (PipId input_port : input_site_ports) {
+        port_source_downhill.push_back(SitePip::make(site_info, input_port));
+    }
+
     blocking_net.name = ctx->id("$nextpnr_blocked_net");
     blocking_site_net.net = &blocking_net;
 }
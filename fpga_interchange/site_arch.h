@@ -263,6 +263,47 @@ struct SiteArch
     // A site port that is present in this dictionary is blocked for all those nets except any in the attached pool
     dict<PipId, pool<NetInfo *, hash_ptr_ops>> blocked_site_ports;
 
+    // Merged downhill pip adjacency, precomputed at construction.  Site
+    // routing expansion visits the same handful of wires many times per
+    // checkSiteRouting call, so getPipsDownhill hands out a plain pointer
+    // range instead of re-running the chipdb / site port merge per visit.
+    struct PipsDownhillSlice
+    {
+        int32_t offset = 0;
+        int32_t length = 0;
+    };
+    std::vector<SitePip> pips_downhill_storage;
+    // Indexed by tile wire index; only wires in this site have entries.
+    std::vector<PipsDownhillSlice> site_wire_downhill;
+    // Indexed parallel to output_site_ports / out_of_site_source_wires /
+    // input_site_ports respectively.
+    std::vector<std::vector<SitePip>> port_sink_downhill;
+    std::vector<SiteWire> out_of_site_source_wires;
+    std::vector<std::vector<SitePip>> out_of_site_source_downhill;
+    std::vector<SitePip> port_source_downhill;
+
+    // The site port and out of site lists hold at most a handful of entries,
+    // so a linear scan beats any indexed lookup.
+    static size_t port_list_index(const std::vector<PipId> &ports, PipId pip)
+    {
+        for (size_t i = 0; i < ports.size(); ++i) {
+            if (ports[i] == pip) {
+                return i;
+            }
+        }
+        NPNR_ASSERT_FALSE("pip is not a site port of this site");
+    }
+
+    static size_t wire_list_index(const std::vector<SiteWire> &wires, const SiteWire &wire)
+    {
+        for (size_t i = 0; i < wires.size(); ++i) {
+            if (wires[i] == wire) {
+                return i;
+            }
+        }
+        NPNR_ASSERT_FALSE("wire is not an out of site wire of this site");
+    }
+
     SiteArch(const SiteInformation *site_info);
 
     inline SiteWire getPipSrcWire(const SitePip &site_pip) const NPNR_ALWAYS_INLINE;
@@ -334,160 +375,16 @@ struct SiteArch
     SyntheticType pip_synthetic_type(const SitePip &pip) const NPNR_ALWAYS_INLINE;
 };
 
-struct SitePipDownhillIterator
-{
-    enum DownhillIteratorState
-    {
-        // Initial state
-        BEGIN = 0,
-        // Iterating over normal pips.
-        NORMAL_PIPS = 1,
-        // Iterating off all site port sources.
-        PORT_SINK_TO_PORT_SRC = 2,
-        // Iterating over out of site sinks.
-        OUT_OF_SITE_SINKS = 3,
-        // Iterating off all site port sources.
-        OUT_OF_SITE_SOURCE_TO_PORT_SRC = 4,
-        SITE_PORT = 5,
-        END = 6,
-        NUMBER_STATES = 7,
-    };
-
-    DownhillIteratorState state = BEGIN;
-    const SiteArch *site_arch;
-    SiteWire site_wire;
-    const RelSlice<int32_t> *pips_downhill;
-    size_t cursor;
-
-    bool advance_in_state() NPNR_ALWAYS_INLINE
-    {
-        switch (state) {
-        case BEGIN:
-            return false;
-        case NORMAL_PIPS:
-            ++cursor;
-            return (cursor < pips_downhill->size());
-        case PORT_SINK_TO_PORT_SRC:
-            ++cursor;
-            return (cursor < site_arch->input_site_ports.size());
-        case OUT_OF_SITE_SINKS:
-            ++cursor;
-            return (cursor < site_arch->out_of_site_sinks.size());
-        case OUT_OF_SITE_SOURCE_TO_PORT_SRC:
-            ++cursor;
-            return (cursor < site_arch->input_site_ports.size());
-        case SITE_PORT:
-            ++cursor;
-            return false;
-        default:
-            // Unreachable!
-            NPNR_ASSERT(false);
-        }
-    }
-
-    bool check_first() const NPNR_ALWAYS_INLINE
-    {
-        switch (state) {
-        case BEGIN:
-            return false;
-        case NORMAL_PIPS:
-            return (cursor < pips_downhill->size());
-        case PORT_SINK_TO_PORT_SRC:
-            return (cursor < site_arch->input_site_ports.size());
-        case OUT_OF_SITE_SINKS:
-            return (cursor < site_arch->out_of_site_sinks.size());
-        case OUT_OF_SITE_SOURCE_TO_PORT_SRC:
-            return (cursor < site_arch->input_site_ports.size());
-        case SITE_PORT:
-            return true;
-        case END:
-            return true;
-        default:
-            // Unreachable!
-            NPNR_ASSERT(false);
-        }
-    }
-
-    const std::array<std::array<DownhillIteratorState, NUMBER_STATES>, SiteWire::NUMBER_SITE_WIRE_TYPES>
-    get_state_table() const
-    {
-        std::array<std::array<DownhillIteratorState, NUMBER_STATES>, SiteWire::NUMBER_SITE_WIRE_TYPES> state_table;
-        for (size_t j = 0; j < SiteWire::NUMBER_SITE_WIRE_TYPES; ++j) {
-            for (size_t i = 0; i < NUMBER_STATES; ++i) {
-                state_table[j][i] = NUMBER_STATES;
-            }
-        }
-
-        state_table[SiteWire::SITE_WIRE][BEGIN] = NORMAL_PIPS;
-        state_table[SiteWire::SITE_WIRE][NORMAL_PIPS] = END;
-
-        state_table[SiteWire::OUT_OF_SITE_SOURCE][BEGIN] = OUT_OF_SITE_SOURCE_TO_PORT_SRC;
-        state_table[SiteWire::OUT_OF_SITE_SOURCE][OUT_OF_SITE_SOURCE_TO_PORT_SRC] = END;
-
-        state_table[SiteWire::OUT_OF_SITE_SINK][BEGIN] = END;
-
-        state_table[SiteWire::SITE_PORT_SINK][BEGIN] = PORT_SINK_TO_PORT_SRC;
-        state_table[SiteWire::SITE_PORT_SINK][PORT_SINK_TO_PORT_SRC] = OUT_OF_SITE_SINKS;
-        state_table[SiteWire::SITE_PORT_SINK][OUT_OF_SITE_SINKS] = END;
-
-        state_table[SiteWire::SITE_PORT_SOURCE][BEGIN] = SITE_PORT;
-        state_table[SiteWire::SITE_PORT_SOURCE][SITE_PORT] = END;
-
-        return state_table;
-    }
-
-    void advance_state() NPNR_ALWAYS_INLINE
-    {
-        state = get_state_table().at(site_wire.type).at(state);
-        cursor = 0;
-        NPNR_ASSERT(state >= BEGIN && state <= END);
-    }
-
-    void operator++() NPNR_ALWAYS_INLINE
-    {
-        NPNR_ASSERT(state != END);
-        while (state != END) {
-            if (advance_in_state()) {
-                break;
-            } else {
-                advance_state();
-                if (check_first()) {
-                    break;
-                }
-            }
-        }
-    }
-
-    bool operator!=(const SitePipDownhillIterator &other) const
-    {
-        return state != other.state || cursor != other.cursor;
-    }
-
-    inline SitePip operator*() const NPNR_ALWAYS_INLINE;
-};
-
+// Downhill site pips are precomputed per wire when the SiteArch is
+// constructed, so the downhill range is just a walk over a contiguous array.
 struct SitePipDownhillRange
 {
-    const SiteArch *site_arch;
-    SiteWire site_wire;
-
-    SitePipDownhillRange(const SiteArch *site_arch, const SiteWire &site_wire)
-            : site_arch(site_arch), site_wire(site_wire)
-    {
-    }
+    const SitePip *b, *e;
 
-    inline const RelSlice<int32_t> *init_pip_range() const NPNR_ALWAYS_INLINE;
+    SitePipDownhillRange(const SitePip *b, const SitePip *e) : b(b), e(e) {}
 
-    inline SitePipDownhillIterator begin() const NPNR_ALWAYS_INLINE;
-
-    SitePipDownhillIterator end() const NPNR_ALWAYS_INLINE
-    {
-        SitePipDownhillIterator e;
-        e.state = SitePipDownhillIterator::END;
-        e.cursor = 0;
-
-        return e;
-    }
+    const SitePip *begin() const NPNR_ALWAYS_INLINE { return b; }
+    const SitePip *end() const NPNR_ALWAYS_INLINE { return e; }
 };
 
 struct SitePipUphillIterator
@@ -672,7 +569,33 @@ struct SitePipUphillRange
 
 inline SitePipDownhillRange SiteArch::getPipsDownhill(const SiteWire &site_wire) const
 {
-    return SitePipDownhillRange(this, site_wire);
+    switch (site_wire.type) {
+    case SiteWire::SITE_WIRE: {
+        NPNR_ASSERT(site_wire.wire.tile == site_info->tile);
+        const PipsDownhillSlice &slice = site_wire_downhill.at(site_wire.wire.index);
+        const SitePip *base = pips_downhill_storage.data() + slice.offset;
+        return SitePipDownhillRange(base, base + slice.length);
+    }
+    case SiteWire::OUT_OF_SITE_SOURCE: {
+        const std::vector<SitePip> &pips =
+                out_of_site_source_downhill.at(wire_list_index(out_of_site_source_wires, site_wire));
+        return SitePipDownhillRange(pips.data(), pips.data() + pips.size());
+    }
+    case SiteWire::OUT_OF_SITE_SINK:
+        // Sinks have no downhill pips!
+        return SitePipDownhillRange(nullptr, nullptr);
+    case SiteWire::SITE_PORT_SINK: {
+        const std::vector<SitePip> &pips = port_sink_downhill.at(port_list_index(output_site_ports, site_wire.pip));
+        return SitePipDownhillRange(pips.data(), pips.data() + pips.size());
+    }
+    case SiteWire::SITE_PORT_SOURCE: {
+        const SitePip *pip = &port_source_downhill.at(port_list_index(input_site_ports, site_wire.pip));
+        return SitePipDownhillRange(pip, pip + 1);
+    }
+    default:
+        // Unreachable!
+        NPNR_ASSERT(false);
+    }
 }
 
 inline SitePipUphillRange SiteArch::getPipsUphill(const SiteWire &site_wire) const
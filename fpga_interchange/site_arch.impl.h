@@ -216,54 +216,6 @@ inline SyntheticType SiteArch::pip_synthetic_type(const SitePip &pip) const
     return SyntheticType(bel_data.synthetic);
 }
 
-inline SitePip SitePipDownhillIterator::operator*() const
-{
-    switch (state) {
-    case NORMAL_PIPS: {
-        PipId pip;
-        pip.tile = site_arch->site_info->tile;
-        pip.index = (*pips_downhill)[cursor];
-        return SitePip::make(site_arch->site_info, pip);
-    }
-    case PORT_SINK_TO_PORT_SRC:
-        return SitePip::make(site_arch->site_info, site_wire.pip, site_arch->input_site_ports.at(cursor));
-    case OUT_OF_SITE_SINKS:
-        return SitePip::make(site_arch->site_info, site_wire.pip, site_arch->out_of_site_sinks.at(cursor));
-    case OUT_OF_SITE_SOURCE_TO_PORT_SRC:
-        return SitePip::make(site_arch->site_info, site_wire, site_arch->input_site_ports.at(cursor));
-    case SITE_PORT:
-        return SitePip::make(site_arch->site_info, site_wire.pip);
-    default:
-        // Unreachable!
-        NPNR_ASSERT(false);
-    }
-}
-
-inline const RelSlice<int32_t> *SitePipDownhillRange::init_pip_range() const
-{
-    NPNR_ASSERT(site_wire.type == SiteWire::SITE_WIRE);
-    NPNR_ASSERT(site_wire.wire.tile == site_arch->site_info->tile);
-    return &site_arch->ctx->chip_info->tile_types[site_arch->site_info->tile_type]
-                    .wire_data[site_wire.wire.index]
-                    .pips_downhill;
-}
-
-inline SitePipDownhillIterator SitePipDownhillRange::begin() const
-{
-    SitePipDownhillIterator b;
-    b.state = SitePipDownhillIterator::BEGIN;
-    b.site_arch = site_arch;
-    b.site_wire = site_wire;
-    b.cursor = 0;
-    if (site_wire.type == SiteWire::SITE_WIRE) {
-        b.pips_downhill = init_pip_range();
-    }
-
-    ++b;
-
-    return b;
-}
-
 inline bool SiteArch::isInverting(const SitePip &site_pip) const
 {
     if (site_pip.type != SitePip::SITE_PIP) {
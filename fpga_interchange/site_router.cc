@@ -26,6 +26,7 @@
 
 #include "site_arch.h"
 #include "site_arch.impl.h"
+#include "threadpool.h"
 
 #include <queue>
 
@@ -699,9 +700,137 @@ static bool find_solution_via_backtrack(SiteArch *ctx, std::vector<PossibleSolut
     NPNR_ASSERT(false);
 }
 
+static const SiteReachability &get_site_reachability(const SiteArch *ctx)
+{
+    const SiteInformation *site_info = ctx->site_info;
+    const Context *c = site_info->ctx;
+    auto key = std::make_pair(site_info->tile_type, int32_t(site_info->site));
+    auto fnd = c->site_reachability_cache.find(key);
+    if (fnd != c->site_reachability_cache.end())
+        return fnd->second;
+
+    SiteReachability &reach = c->site_reachability_cache[key];
+    const auto &tile_type = c->chip_info->tile_types[site_info->tile_type];
+
+    reach.wire_to_idx.resize(tile_type.wire_data.size(), -1);
+    for (size_t i = 0; i < tile_type.wire_data.size(); ++i) {
+        if (tile_type.wire_data[i].site == site_info->site)
+            reach.wire_to_idx[i] = reach.num_wires++;
+    }
+
+    std::vector<std::vector<int32_t>> edges(reach.num_wires);
+    std::vector<int32_t> out_port_origins, in_port_entries;
+    for (size_t i = 0; i < tile_type.pip_data.size(); ++i) {
+        const auto &pip_data = tile_type.pip_data[i];
+        if (pip_data.site != site_info->site)
+            continue;
+        int32_t src = pip_data.src_index >= 0 ? reach.wire_to_idx.at(pip_data.src_index) : -1;
+        int32_t dst = pip_data.dst_index >= 0 ? reach.wire_to_idx.at(pip_data.dst_index) : -1;
+        const auto &bel_data = tile_type.bel_data[pip_data.bel];
+        if (bel_data.category == BEL_CATEGORY_SITE_PORT) {
+            // One side of a site port is the routing graph wire; the site
+            // side marks where routing can leave or enter the site
+            if (src != -1)
+                out_port_origins.push_back(src);
+            if (dst != -1)
+                in_port_entries.push_back(dst);
+        } else if (src != -1 && dst != -1) {
+            edges.at(src).push_back(dst);
+        }
+    }
+
+    reach.reachable.resize(size_t(reach.num_wires) * reach.num_wires, false);
+    std::vector<int32_t> bfs_queue;
+    for (int32_t src = 0; src < reach.num_wires; ++src) {
+        auto row = reach.reachable.begin() + size_t(src) * reach.num_wires;
+        bfs_queue.clear();
+        bfs_queue.push_back(src);
+        row[src] = true;
+        while (!bfs_queue.empty()) {
+            int32_t cursor = bfs_queue.back();
+            bfs_queue.pop_back();
+            for (int32_t next : edges.at(cursor)) {
+                if (!row[next]) {
+                    row[next] = true;
+                    bfs_queue.push_back(next);
+                }
+            }
+        }
+    }
+
+    reach.reaches_out_port.resize(reach.num_wires, false);
+    reach.reachable_from_in_port.resize(reach.num_wires, false);
+    for (int32_t w = 0; w < reach.num_wires; ++w) {
+        for (int32_t origin : out_port_origins) {
+            if (reach.reachable.at(size_t(w) * reach.num_wires + origin)) {
+                reach.reaches_out_port[w] = true;
+                break;
+            }
+        }
+    }
+    for (int32_t entry : in_port_entries) {
+        for (int32_t w = 0; w < reach.num_wires; ++w) {
+            if (reach.reachable.at(size_t(entry) * reach.num_wires + w))
+                reach.reachable_from_in_port[w] = true;
+        }
+    }
+
+    return reach;
+}
+
+// Cheap static feasibility screen ahead of any expansion: most infeasible
+// probes fail because some sink pin simply cannot be reached from its driver
+// within the site, which the reachability table answers with one lookup. The
+// table over-approximates (every site pip present), so it never rejects a
+// routable configuration
+static bool site_statically_routable(const SiteArch *ctx, bool explain)
+{
+    const SiteReachability &reach = get_site_reachability(ctx);
+    // -1 (not a wire of this site) makes no claim and leaves the decision to
+    // the full search
+    auto wire_idx = [&](const SiteWire &w) -> int32_t {
+        if (w.wire.tile != ctx->site_info->tile)
+            return -1;
+        return reach.wire_to_idx.at(w.wire.index);
+    };
+    for (auto &net_pair : ctx->nets) {
+        if (net_pair.first->driver.cell == nullptr)
+            continue;
+        const SiteNetInfo &net = net_pair.second;
+        const SiteWire &src = net.driver;
+        int32_t src_idx = src.type == SiteWire::SITE_WIRE ? wire_idx(src) : -1;
+        for (const SiteWire &user : net.users) {
+            bool ok = true;
+            int32_t user_idx = user.type == SiteWire::SITE_WIRE ? wire_idx(user) : -1;
+            if (src.type == SiteWire::SITE_WIRE && src_idx != -1) {
+                if (user.type == SiteWire::SITE_WIRE && user_idx != -1)
+                    ok = reach.reachable.at(size_t(src_idx) * reach.num_wires + user_idx);
+                else if (user.type == SiteWire::OUT_OF_SITE_SINK)
+                    ok = reach.reaches_out_port.at(src_idx);
+            } else if (src.type == SiteWire::OUT_OF_SITE_SOURCE && user_idx != -1) {
+                ok = reach.reachable_from_in_port.at(user_idx);
+            }
+            if (!ok) {
+                if (verbose_site_router(ctx) || explain) {
+                    log_info("Sink %s on net %s is statically unreachable, site is unroutable!\n",
+                             ctx->nameOfWire(user), ctx->nameOfNet(&net));
+                }
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 static bool route_site(SiteArch *ctx, SiteRoutingCache *site_routing_cache, RouteNodeStorage *node_storage,
-                       bool explain, bool cache_disabled = false)
+                       bool explain, bool cache_disabled = false, bool use_net_loop = true)
 {
+    // The static reachability pre-filter populates a lazy cache shared on
+    // the Arch, so only the serial path consults it; the full expansion
+    // below reaches the same verdict without it
+    if (use_net_loop && !site_statically_routable(ctx, explain))
+        return false;
+
     // Overview:
     // - Starting from each site net source, expand the site routing graph
     //   and record all reachable sinks.
@@ -712,16 +841,25 @@ static bool route_site(SiteArch *ctx, SiteRoutingCache *site_routing_cache, Rout
     //
     std::vector<SiteExpansionLoop *> expansions;
     expansions.reserve(ctx->nets.size());
+    // Nets span sites, so the expansion loop cached on the net is shared
+    // state; concurrent validation uses throwaway loops bound to the
+    // caller's node storage instead
+    std::vector<std::unique_ptr<SiteExpansionLoop>> local_loops;
 
     for (auto &net_pair : ctx->nets) {
         if (net_pair.first->driver.cell == nullptr)
             continue;
         SiteNetInfo *net = &net_pair.second;
 
-        if (net->net->loop == nullptr) {
-            net->net->loop = new SiteExpansionLoop(node_storage);
+        if (use_net_loop) {
+            if (net->net->loop == nullptr) {
+                net->net->loop = new SiteExpansionLoop(node_storage);
+            }
+            expansions.push_back(net->net->loop);
+        } else {
+            local_loops.emplace_back(new SiteExpansionLoop(node_storage));
+            expansions.push_back(local_loops.back().get());
         }
-        expansions.push_back(net->net->loop);
 
         SiteExpansionLoop *router = expansions.back();
         if (!router->expand_net(ctx, site_routing_cache, net, cache_disabled)) {
@@ -1048,10 +1186,11 @@ static void apply_routing(Context *ctx, const SiteArch &site_arch, pool<std::pai
     }
 }
 
-static bool map_luts_in_site(const SiteInformation &site_info, pool<std::pair<IdString, IdString>> *blocked_wires)
+static bool map_luts_in_site(const SiteInformation &site_info, pool<std::pair<IdString, IdString>> *blocked_wires,
+                             bool use_cache = true)
 {
     const Context *ctx = site_info.ctx;
-    bool enable_cache = !ctx->arch_args.disable_lut_mapping_cache;
+    bool enable_cache = use_cache && !ctx->arch_args.disable_lut_mapping_cache;
 
     // Create a site LUT mapping key
     SiteLutMappingKey key = SiteLutMappingKey::create(site_info);
@@ -1277,11 +1416,6 @@ static void check_downhill_pips(Context *ctx, const SiteArch *site_arch, std::ve
 
 bool SiteRouter::checkSiteRouting(const Context *ctx, const TileStatus &tile_status) const
 {
-    // Overview:
-    //  - Make sure all cells in site satisfy the constraints.
-    //  - Ensure that the LUT equation elements in the site are legal
-    //  - Check that the site is routable.
-
     // Because site routing checks are expensive, cache them.
     // SiteRouter::bindBel/unbindBel should correctly invalid the cache by
     // setting dirty=true.
@@ -1291,15 +1425,25 @@ bool SiteRouter::checkSiteRouting(const Context *ctx, const TileStatus &tile_sta
     }
 
     dirty = false;
+    site_ok = check_site_routing(ctx, tile_status, &ctx->site_routing_cache, &ctx->node_storage,
+                                 /*concurrent=*/false);
+    return site_ok;
+}
+
+bool SiteRouter::check_site_routing(const Context *ctx, const TileStatus &tile_status,
+                                    SiteRoutingCache *site_routing_cache, RouteNodeStorage *node_storage,
+                                    bool concurrent) const
+{
+    // Overview:
+    //  - Make sure all cells in site satisfy the constraints.
+    //  - Ensure that the LUT equation elements in the site are legal
+    //  - Check that the site is routable.
 
     // Empty sites are trivially correct.
     if (cells_in_site.size() == 0) {
-        site_ok = true;
-        return site_ok;
+        return true;
     }
 
-    site_ok = false;
-
     // Make sure all cells in this site belong!
     auto iter = cells_in_site.begin();
     NPNR_ASSERT((*iter)->bel != BelId());
@@ -1324,24 +1468,21 @@ bool SiteRouter::checkSiteRouting(const Context *ctx, const TileStatus &tile_sta
                 log_info("Sanity check failed, cell_type %s at %s has an invalid constraints, so site is not good\n",
                          cell->type.c_str(ctx), ctx->nameOfBel(cell->bel));
             }
-            site_ok = false;
-            return site_ok;
+            return false;
         }
     }
 
     SiteInformation site_info(ctx, tile, site, cells_in_site);
     pool<std::pair<IdString, IdString>> blocked_wires;
-    if (!map_luts_in_site(site_info, &blocked_wires)) {
-        site_ok = false;
-        return site_ok;
+    if (!map_luts_in_site(site_info, &blocked_wires, /*use_cache=*/!concurrent)) {
+        return false;
     }
 
     // Push from cell pins to the first WireId from each cell pin.
     //
     // If a site wire conflict occurs here, the site is trivially unroutable.
     if (!check_initial_wires(ctx, &site_info)) {
-        site_ok = false;
-        return site_ok;
+        return false;
     }
 
     // Construct a model of the site routing that is suitable for routing
@@ -1358,19 +1499,20 @@ bool SiteRouter::checkSiteRouting(const Context *ctx, const TileStatus &tile_sta
 
     // Do a detailed routing check to see if the site has at least 1 valid
     // routing solution.
-    site_ok = route_site(&site_arch, &ctx->site_routing_cache, &ctx->node_storage, /*explain=*/false);
+    bool routable = route_site(&site_arch, site_routing_cache, node_storage, /*explain=*/false,
+                               /*cache_disabled=*/false, /*use_net_loop=*/!concurrent);
     if (verbose_site_router(ctx)) {
-        if (site_ok) {
+        if (routable) {
             log_info("Site %s is routable\n", ctx->get_site_name(tile, site));
         } else {
             log_info("Site %s is not routable\n", ctx->get_site_name(tile, site));
         }
     }
 
-    if (site_ok) {
+    if (routable) {
         check_routing(site_arch);
     }
-    return site_ok;
+    return routable;
 }
 
 void SiteRouter::bindSiteRouting(Context *ctx)
@@ -1449,6 +1591,53 @@ void SiteRouter::explain(const Context *ctx) const
     }
 }
 
+bool Arch::site_routing_drc() const
+{
+    std::vector<std::pair<int32_t, const SiteRouter *>> occupied;
+    std::vector<const TileStatus *> occupied_tiles;
+    for (auto &tile_pair : tileStatus) {
+        for (auto &site : tile_pair.second.sites) {
+            if (site.cells_in_site.empty())
+                continue;
+            occupied.emplace_back(tile_pair.first, &site);
+            occupied_tiles.push_back(&tile_pair.second);
+        }
+    }
+
+    log_info("Validating site routing for %zu occupied sites.\n", occupied.size());
+
+    // Sites are independent by construction, so each chunk of sites can be
+    // validated by any worker; the only shared state the check touches is
+    // the routing scratch, so every chunk gets its own and the LUT mapping
+    // cache is bypassed
+    std::vector<size_t> failed = ThreadPool::get().reduce_chunks(
+            occupied.size(), 8, std::vector<size_t>{},
+            [&](size_t begin, size_t end) {
+                SiteRoutingCache routing_cache;
+                RouteNodeStorage node_storage;
+                std::vector<size_t> chunk_failed;
+                for (size_t i = begin; i < end; i++) {
+                    const SiteRouter &site = *occupied.at(i).second;
+                    if (!site.check_site_routing(getCtx(), *occupied_tiles.at(i), &routing_cache, &node_storage,
+                                                 /*concurrent=*/true))
+                        chunk_failed.push_back(i);
+                }
+                return chunk_failed;
+            },
+            [](std::vector<size_t> acc, std::vector<size_t> chunk) {
+                acc.insert(acc.end(), chunk.begin(), chunk.end());
+                return acc;
+            });
+
+    for (size_t i : failed)
+        log_warning("Site %s failed end-of-placement routing DRC\n",
+                    get_site_name(occupied.at(i).first, occupied.at(i).second->site));
+    if (!failed.empty())
+        log_warning("%zu of %zu occupied sites failed end-of-placement routing DRC\n", failed.size(), occupied.size());
+
+    return failed.empty();
+}
+
 ArchNetInfo::~ArchNetInfo() { delete loop; }
 
 Arch::~Arch()
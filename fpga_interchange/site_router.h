@@ -33,6 +33,23 @@ NEXTPNR_NAMESPACE_BEGIN
 
 struct Context;
 struct TileStatus;
+class SiteRoutingCache;
+
+// Static intra-site reachability for one site of a tile type, computed with
+// every site pip treated as present. Placement only ever removes pips, so a
+// sink that is unreachable here can never be routed and a probe can be
+// rejected with a table lookup before any graph expansion. Built lazily per
+// (tile type, site in tile) and cached on the Arch
+struct SiteReachability
+{
+    // Tile-type wire index -> dense index over this site's wires, -1 outside
+    std::vector<int32_t> wire_to_idx;
+    int32_t num_wires = 0;
+    // reachable.at(src * num_wires + dst), reflexive
+    std::vector<bool> reachable;
+    // Wire can reach an output site port / is reachable from an input port
+    std::vector<bool> reaches_out_port, reachable_from_in_port;
+};
 
 struct SiteRouter
 {
@@ -49,6 +66,12 @@ struct SiteRouter
     void bindBel(CellInfo *cell);
     void unbindBel(CellInfo *cell);
     bool checkSiteRouting(const Context *ctx, const TileStatus &tile_status) const;
+    // As checkSiteRouting, but bypassing the per-site result cache and using
+    // caller-supplied routing scratch. With concurrent set the check is safe
+    // to run from a worker thread: the shared LUT mapping cache and the
+    // expansion loops cached on nets (which span sites) are left untouched
+    bool check_site_routing(const Context *ctx, const TileStatus &tile_status, SiteRoutingCache *site_routing_cache,
+                            RouteNodeStorage *node_storage, bool concurrent) const;
     void bindSiteRouting(Context *ctx);
     void explain(const Context *ctx) const;
 };
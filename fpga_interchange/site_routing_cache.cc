@@ -20,7 +20,11 @@
 
 #include "site_routing_cache.h"
 
+#include <boost/filesystem.hpp>
+#include <fstream>
+
 #include "context.h"
+#include "log.h"
 #include "site_arch.impl.h"
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -206,4 +210,181 @@ void SiteRoutingCache::add_solutions(const SiteArch *ctx, const SiteNetInfo &net
 
 void SiteRoutingCache::clear() { cache_.clear(); }
 
+// On-disk format of the persistent cache: magic, version, chipdb hash, then
+// the key/solution pairs with SiteWire/SitePip flattened to their type and
+// tile/index fields. Net pointers are design-local and deliberately not
+// stored - get_solution() rewrites them on every retrieval anyway. Host byte
+// order; this is a per-host cache, not an interchange format.
+namespace {
+constexpr uint32_t kSiteRoutingCacheMagic = 0x48435253; // 'SRCH'
+constexpr uint32_t kSiteRoutingCacheVersion = 1;
+
+void put_i32(std::ostream &out, int32_t value) { out.write(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+int32_t get_i32(std::istream &in)
+{
+    int32_t value = 0;
+    in.read(reinterpret_cast<char *>(&value), sizeof(value));
+    return value;
+}
+
+void put_site_wire(std::ostream &out, const SiteWire &wire)
+{
+    put_i32(out, wire.type);
+    put_i32(out, wire.wire.tile);
+    put_i32(out, wire.wire.index);
+    put_i32(out, wire.pip.tile);
+    put_i32(out, wire.pip.index);
+}
+
+SiteWire get_site_wire(std::istream &in)
+{
+    SiteWire wire;
+    wire.type = SiteWire::Type(get_i32(in));
+    wire.wire.tile = get_i32(in);
+    wire.wire.index = get_i32(in);
+    wire.pip.tile = get_i32(in);
+    wire.pip.index = get_i32(in);
+    wire.net = nullptr;
+    return wire;
+}
+
+void put_site_pip(std::ostream &out, const SitePip &pip)
+{
+    put_i32(out, pip.type);
+    put_i32(out, pip.pip.tile);
+    put_i32(out, pip.pip.index);
+    put_site_wire(out, pip.wire);
+    put_i32(out, pip.other_pip.tile);
+    put_i32(out, pip.other_pip.index);
+}
+
+SitePip get_site_pip(std::istream &in)
+{
+    SitePip pip;
+    pip.type = SitePip::Type(get_i32(in));
+    pip.pip.tile = get_i32(in);
+    pip.pip.index = get_i32(in);
+    pip.wire = get_site_wire(in);
+    pip.other_pip.tile = get_i32(in);
+    pip.other_pip.index = get_i32(in);
+    return pip;
+}
+} // namespace
+
+bool SiteRoutingCache::load(const std::string &filename, const std::string &chipdb_hash)
+{
+    std::ifstream in(filename, std::ios_base::in | std::ios_base::binary);
+    if (!in)
+        return false;
+
+    if (uint32_t(get_i32(in)) != kSiteRoutingCacheMagic || uint32_t(get_i32(in)) != kSiteRoutingCacheVersion)
+        return false;
+
+    std::string hash(size_t(get_i32(in)), '\0');
+    in.read(&hash[0], hash.size());
+    if (!in || hash != chipdb_hash) {
+        // Stale cache from another chipdb revision
+        return false;
+    }
+
+    int32_t entry_count = get_i32(in);
+    for (int32_t i = 0; i < entry_count; ++i) {
+        SiteRoutingKey key;
+        key.tile_type = get_i32(in);
+        key.site = get_i32(in);
+        key.net_type = PhysicalNetlist::PhysNetlist::NetType(get_i32(in));
+        key.driver_type = SiteWire::Type(get_i32(in));
+        key.driver_index = get_i32(in);
+
+        int32_t num_users = get_i32(in);
+        key.user_types.reserve(num_users);
+        key.user_indicies.reserve(num_users);
+        for (int32_t j = 0; j < num_users; ++j) {
+            key.user_types.push_back(SiteWire::Type(get_i32(in)));
+            key.user_indicies.push_back(get_i32(in));
+        }
+
+        SiteRoutingSolution solution;
+        int32_t num_offsets = get_i32(in);
+        solution.solution_offsets.reserve(num_offsets);
+        for (int32_t j = 0; j < num_offsets; ++j)
+            solution.solution_offsets.push_back(get_i32(in));
+
+        int32_t num_pips = get_i32(in);
+        solution.solution_storage.reserve(num_pips);
+        for (int32_t j = 0; j < num_pips; ++j)
+            solution.solution_storage.push_back(get_site_pip(in));
+
+        int32_t num_sinks = get_i32(in);
+        solution.solution_sinks.reserve(num_sinks);
+        for (int32_t j = 0; j < num_sinks; ++j)
+            solution.solution_sinks.push_back(get_site_wire(in));
+
+        solution.inverted.resize(num_sinks);
+        in.read(reinterpret_cast<char *>(solution.inverted.data()), num_sinks);
+        solution.can_invert.resize(num_sinks);
+        in.read(reinterpret_cast<char *>(solution.can_invert.data()), num_sinks);
+
+        if (!in) {
+            // Truncated cache; drop everything rather than trust it
+            cache_.clear();
+            return false;
+        }
+
+        cache_[key] = solution;
+    }
+
+    return true;
+}
+
+void SiteRoutingCache::save(const std::string &filename, const std::string &chipdb_hash) const
+{
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    {
+        std::ofstream out(temp.string(), std::ios_base::out | std::ios_base::binary);
+
+        put_i32(out, kSiteRoutingCacheMagic);
+        put_i32(out, kSiteRoutingCacheVersion);
+        put_i32(out, chipdb_hash.size());
+        out.write(chipdb_hash.data(), chipdb_hash.size());
+
+        put_i32(out, cache_.size());
+        for (const auto &entry : cache_) {
+            const SiteRoutingKey &key = entry.first;
+            put_i32(out, key.tile_type);
+            put_i32(out, key.site);
+            put_i32(out, int32_t(key.net_type));
+            put_i32(out, int32_t(key.driver_type));
+            put_i32(out, key.driver_index);
+            put_i32(out, key.user_types.size());
+            for (size_t j = 0; j < key.user_types.size(); ++j) {
+                put_i32(out, int32_t(key.user_types.at(j)));
+                put_i32(out, key.user_indicies.at(j));
+            }
+
+            const SiteRoutingSolution &solution = entry.second;
+            put_i32(out, solution.solution_offsets.size());
+            for (size_t offset : solution.solution_offsets)
+                put_i32(out, offset);
+            put_i32(out, solution.solution_storage.size());
+            for (const SitePip &pip : solution.solution_storage)
+                put_site_pip(out, pip);
+            put_i32(out, solution.solution_sinks.size());
+            for (const SiteWire &wire : solution.solution_sinks)
+                put_site_wire(out, wire);
+            out.write(reinterpret_cast<const char *>(solution.inverted.data()), solution.inverted.size());
+            out.write(reinterpret_cast<const char *>(solution.can_invert.data()), solution.can_invert.size());
+        }
+
+        out.close();
+        if (!out) {
+            boost::filesystem::remove(temp);
+            log_warning("Failed to write site routing cache to %s\n", temp.c_str());
+            return;
+        }
+    }
+    boost::filesystem::rename(temp, filename);
+}
+
 NEXTPNR_NAMESPACE_END
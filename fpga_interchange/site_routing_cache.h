@@ -123,6 +123,15 @@ class SiteRoutingCache
     void add_solutions(const SiteArch *ctx, const SiteNetInfo &net, const SiteRoutingSolution &solution);
     void clear();
 
+    // Persistent cross-run cache. The key is a design-independent signature
+    // of the net within its site (tile type, site, net type, canonicalised
+    // driver/sink wire indices), so solutions from a previous run against
+    // the same chipdb are valid for any design; load() warms the cache from
+    // the per-chipdb file, save() writes it back. Validated against the
+    // chipdb hash, and every retrieved solution is still verify()-checked.
+    bool load(const std::string &filename, const std::string &chipdb_hash);
+    void save(const std::string &filename, const std::string &chipdb_hash) const;
+
   private:
     dict<SiteRoutingKey, SiteRoutingSolution> cache_;
 };
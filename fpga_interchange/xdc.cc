@@ -20,6 +20,8 @@
 
 #include "xdc.h"
 
+#include <cctype>
+#include <fstream>
 #include <string>
 
 #include "context.h"
@@ -227,4 +229,122 @@ TclInterp::TclInterp(Context *ctx)
 
 TclInterp::~TclInterp() { Tcl_DeleteInterp(interp); }
 
+// Fast path for machine-generated pin-constraint files, which are thousands
+// of lines of nothing but "set_property <prop> <value> [get_ports <name>]".
+// Such files compile once into an XdcCommand list that parse_xdc caches and
+// replays without a Tcl interpreter; a single line beyond this subset makes
+// compilation fail and the whole file go through full Tcl, so scripted
+// constraints keep their semantics.
+
+namespace {
+
+struct xdc_token
+{
+    std::string text;
+    // 'w' bare word, 'b' [...] group (text is the content), 'g' {...} group
+    char kind;
+};
+
+// Split one line into tokens. '[' and '{' are only special at the start of
+// a token and group to their matching close (with nesting, so indexed names
+// like dout[3] inside a group survive intact); '#' starts a comment.
+// Returns false on anything that needs real Tcl (unbalanced groups, line
+// continuations, substitutions)
+bool tokenize_xdc_line(const std::string &line, std::vector<xdc_token> &tokens)
+{
+    size_t i = 0;
+    while (i < line.size()) {
+        if (isspace((unsigned char)line[i])) {
+            i++;
+            continue;
+        }
+        if (line[i] == '#')
+            break;
+        xdc_token token;
+        if (line[i] == '[' || line[i] == '{') {
+            char open = line[i], close = (open == '[') ? ']' : '}';
+            token.kind = (open == '[') ? 'b' : 'g';
+            size_t start = i + 1;
+            int depth = 0;
+            for (; i < line.size(); i++) {
+                if (line[i] == open)
+                    depth++;
+                else if (line[i] == close && --depth == 0)
+                    break;
+            }
+            if (i >= line.size())
+                return false;
+            token.text = line.substr(start, i - start);
+            i++;
+        } else {
+            token.kind = 'w';
+            while (i < line.size() && !isspace((unsigned char)line[i]))
+                token.text += line[i++];
+            // substitutions, separators and continuations need the interpreter
+            if (token.text.find_first_of("$;\"") != std::string::npos || token.text.back() == '\\')
+                return false;
+        }
+        tokens.push_back(token);
+    }
+    return true;
+}
+
+} // namespace
+
+bool xdc_compile(Context *ctx, const std::string &filename, std::vector<XdcCommand> &out)
+{
+    std::ifstream in(filename);
+    if (!in)
+        log_error("Failed to open XDC file '%s'\n", filename.c_str());
+    std::string line;
+    while (std::getline(in, line)) {
+        std::vector<xdc_token> tokens;
+        if (!tokenize_xdc_line(line, tokens))
+            return false;
+        if (tokens.empty())
+            continue;
+        // set_property <property> <value> [get_ports|get_cells <name>]
+        if (tokens.size() != 4 || tokens[0].kind != 'w' || tokens[0].text != "set_property")
+            return false;
+        if (tokens[1].kind != 'w' || tokens[2].kind == 'b' || tokens[3].kind != 'b')
+            return false;
+        std::vector<xdc_token> obj;
+        if (!tokenize_xdc_line(tokens[3].text, obj))
+            return false;
+        if (obj.size() != 2 || obj[0].kind != 'w' || obj[1].kind == 'b')
+            return false;
+        XdcCommand cmd;
+        if (obj[0].text == "get_ports")
+            cmd.is_port = true;
+        else if (obj[0].text == "get_cells")
+            cmd.is_port = false;
+        else
+            return false;
+        cmd.object = ctx->id(obj[1].text);
+        cmd.property = ctx->id(tokens[1].text);
+        cmd.value = tokens[2].text;
+        out.push_back(cmd);
+    }
+    return true;
+}
+
+void xdc_apply(Context *ctx, const std::vector<XdcCommand> &commands, const std::string &filename)
+{
+    for (auto &cmd : commands) {
+        if (cmd.is_port) {
+            auto iter = ctx->ports.find(cmd.object);
+            if (iter == ctx->ports.end())
+                log_error("Error in %s => Could not find port %s\n", filename.c_str(), cmd.object.c_str(ctx));
+            NPNR_ASSERT(iter->second.net != nullptr);
+            CellInfo *cell = ctx->port_cells.at(cmd.object);
+            cell->attrs[cmd.property] = Property(cmd.value);
+        } else {
+            auto iter = ctx->cells.find(cmd.object);
+            if (iter == ctx->cells.end())
+                log_error("Error in %s => Could not find cell %s\n", filename.c_str(), cmd.object.c_str(ctx));
+            iter->second->attrs[cmd.property] = Property(cmd.value);
+        }
+    }
+}
+
 NEXTPNR_NAMESPACE_END
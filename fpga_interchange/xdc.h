@@ -20,6 +20,10 @@
 #ifndef XDC_H
 #define XDC_H
 
+#include <string>
+#include <vector>
+
+#include "idstring.h"
 #include "nextpnr_namespaces.h"
 
 struct Tcl_Interp;
@@ -36,6 +40,26 @@ struct TclInterp
     Tcl_Interp *interp;
 };
 
+// One compiled XDC constraint: a set_property on a named port or cell.
+// Object names are resolved to IdStrings at compile time; the port/cell
+// lookup itself happens on each apply so the IR stays valid across netlist
+// reloads.
+struct XdcCommand
+{
+    bool is_port;
+    IdString object;
+    IdString property;
+    std::string value;
+};
+
+// Compile an XDC file into a command list, returning false if it uses
+// anything beyond the simple set_property subset (the caller then falls
+// back to full Tcl evaluation)
+bool xdc_compile(Context *ctx, const std::string &filename, std::vector<XdcCommand> &out);
+
+// Replay a compiled command list against the current netlist
+void xdc_apply(Context *ctx, const std::vector<XdcCommand> &commands, const std::string &filename);
+
 NEXTPNR_NAMESPACE_END
 
 #endif
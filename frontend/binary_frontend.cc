@@ -0,0 +1,503 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "binary_frontend.h"
+#include <sstream>
+#include <unordered_map>
+#include "log.h"
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+
+// File layout: header (magic, version), string table, body. All multi-byte
+// values are little-endian. Everything name-like in the body is a 32-bit
+// index into the string table, so each unique string is interned exactly
+// once on load.
+static const uint32_t bnl_magic = 0x4C4E5042; // "BPNL"
+// Version 2: body entries are stored in dict insertion order (v1 stored
+// iteration order, which reversed the dicts on every save/load cycle)
+static const uint32_t bnl_version = 2;
+static const uint32_t bnl_no_ref = 0xFFFFFFFF; // null cell/net reference
+
+struct BinaryNetlistWriter
+{
+    BinaryNetlistWriter(Context *ctx) : ctx(ctx){};
+    Context *ctx;
+
+    // The body is buffered so the string table, which is only complete once
+    // the whole design has been walked, can be written before it
+    std::ostringstream body;
+    std::vector<const std::string *> strings;
+    std::unordered_map<std::string, uint32_t> string_idx;
+
+    void put_u8(std::ostream &out, uint8_t value) { out.put(char(value)); }
+    void put_u32(std::ostream &out, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            out.put(char((value >> (8 * i)) & 0xFF));
+    }
+    void put_u64(std::ostream &out, uint64_t value)
+    {
+        for (int i = 0; i < 8; i++)
+            out.put(char((value >> (8 * i)) & 0xFF));
+    }
+
+    // hashlib dicts iterate in reverse insertion order, but the reader
+    // re-inserts entries in file order; writing straight from iteration
+    // would therefore reverse every dict per save/load cycle. Since dict
+    // order is iteration order for the whole flow (and with it RNG-coupled
+    // placer/router behaviour), a load must reproduce it exactly: walk each
+    // dict once to collect entry pointers, then emit them flipped so the
+    // file carries insertion order
+    template <typename K, typename V, typename Fn> void foreach_in_order(const dict<K, V> &values, Fn fn)
+    {
+        std::vector<const std::pair<K, V> *> order;
+        order.reserve(values.size());
+        for (auto &pair : values)
+            order.push_back(&pair);
+        for (auto it = order.rbegin(); it != order.rend(); ++it)
+            fn(**it);
+    }
+
+    void put_str(const std::string &value)
+    {
+        auto fnd = string_idx.find(value);
+        if (fnd == string_idx.end()) {
+            fnd = string_idx.emplace(value, uint32_t(strings.size())).first;
+            strings.push_back(&fnd->first);
+        }
+        put_u32(body, fnd->second);
+    }
+    void put_id(IdString id) { put_str(id.str(ctx)); }
+    void put_prop(const Property &value)
+    {
+        put_u8(body, value.is_string ? 1 : 0);
+        put_str(value.str);
+        put_u64(body, uint64_t(value.intval));
+    }
+    void put_id_dict(const dict<IdString, IdString> &values)
+    {
+        put_u32(body, uint32_t(values.size()));
+        foreach_in_order(values, [&](const std::pair<IdString, IdString> &pair) {
+            put_id(pair.first);
+            put_id(pair.second);
+        });
+    }
+    void put_prop_dict(const dict<IdString, Property> &values)
+    {
+        put_u32(body, uint32_t(values.size()));
+        foreach_in_order(values, [&](const std::pair<IdString, Property> &pair) {
+            put_id(pair.first);
+            put_prop(pair.second);
+        });
+    }
+    void put_portref(const PortRef &port)
+    {
+        if (port.cell == nullptr) {
+            put_u32(body, bnl_no_ref);
+        } else {
+            put_str(port.cell->name.str(ctx));
+            put_id(port.port);
+        }
+    }
+
+    void write_body()
+    {
+        // Replay table for the IdString database: every interned name, in
+        // index order. Raw IdString indices leak into behaviour (the JSON
+        // writer emits them as net numbers, passes sort by name index), so
+        // a load must leave the database exactly as it was at write time;
+        // interning lazily in reference order would renumber everything
+        int n_ids = ctx->idstring_db->size();
+        put_u32(body, uint32_t(n_ids));
+        for (int i = 0; i < n_ids; i++)
+            put_str(ctx->idstring_db->str(i));
+
+        put_id(ctx->top_module);
+        put_prop_dict(ctx->attrs);
+        // Settings are replayed selectively on load (see reader), so design
+        // attributes promoted to settings by the frontend survive the round
+        // trip without clobbering the loading run's command line
+        put_prop_dict(ctx->settings);
+
+        put_u32(body, uint32_t(ctx->cells.size()));
+        foreach_in_order(ctx->cells, [&](const std::pair<IdString, std::unique_ptr<CellInfo>> &cell) {
+            CellInfo *ci = cell.second.get();
+            put_id(ci->name);
+            put_id(ci->type);
+            put_id(ci->hierpath);
+            put_u32(body, uint32_t(ci->ports.size()));
+            foreach_in_order(ci->ports, [&](const std::pair<IdString, PortInfo> &port) {
+                put_id(port.second.name);
+                put_u8(body, uint8_t(port.second.type));
+            });
+            put_prop_dict(ci->attrs);
+            put_prop_dict(ci->params);
+        });
+
+        put_u32(body, uint32_t(ctx->nets.size()));
+        foreach_in_order(ctx->nets, [&](const std::pair<IdString, std::unique_ptr<NetInfo>> &net) {
+            NetInfo *ni = net.second.get();
+            put_id(ni->name);
+            put_id(ni->hierpath);
+            put_prop_dict(ni->attrs);
+            put_portref(ni->driver);
+            put_u32(body, uint32_t(ni->users.size()));
+            for (auto &usr : ni->users)
+                put_portref(usr);
+            put_u32(body, uint32_t(ni->aliases.size()));
+            for (auto alias : ni->aliases)
+                put_id(alias);
+        });
+
+        put_id_dict(ctx->net_aliases);
+
+        put_u32(body, uint32_t(ctx->ports.size()));
+        foreach_in_order(ctx->ports, [&](const std::pair<IdString, PortInfo> &port) {
+            put_id(port.second.name);
+            put_u8(body, uint8_t(port.second.type));
+            if (port.second.net == nullptr)
+                put_u32(body, bnl_no_ref);
+            else
+                put_str(port.second.net->name.str(ctx));
+        });
+
+        put_u32(body, uint32_t(ctx->hierarchy.size()));
+        foreach_in_order(ctx->hierarchy, [&](const std::pair<IdString, HierarchicalCell> &hier) {
+            put_id(hier.first);
+            const HierarchicalCell &hc = hier.second;
+            put_id(hc.name);
+            put_id(hc.type);
+            put_id(hc.parent);
+            put_id(hc.fullpath);
+            put_id_dict(hc.leaf_cells);
+            put_id_dict(hc.nets);
+            put_id_dict(hc.leaf_cells_by_gname);
+            put_id_dict(hc.nets_by_gname);
+            put_u32(body, uint32_t(hc.ports.size()));
+            foreach_in_order(hc.ports, [&](const std::pair<IdString, HierarchicalPort> &port) {
+                put_id(port.second.name);
+                put_u8(body, uint8_t(port.second.dir));
+                put_u32(body, uint32_t(port.second.nets.size()));
+                for (auto net : port.second.nets)
+                    put_id(net);
+                put_u32(body, uint32_t(port.second.offset));
+                put_u8(body, port.second.upto ? 1 : 0);
+            });
+            put_id_dict(hc.hier_cells);
+        });
+    }
+
+    void operator()(std::ostream &out)
+    {
+        write_body();
+        put_u32(out, bnl_magic);
+        put_u32(out, bnl_version);
+        put_u32(out, uint32_t(strings.size()));
+        for (auto str : strings) {
+            put_u32(out, uint32_t(str->size()));
+            out.write(str->data(), str->size());
+        }
+        std::string body_str = body.str();
+        out.write(body_str.data(), body_str.size());
+    }
+};
+
+struct BinaryNetlistReader
+{
+    BinaryNetlistReader(std::istream &in, const std::string &filename, Context *ctx)
+            : in(in), filename(filename), ctx(ctx){};
+    std::istream &in;
+    std::string filename;
+    Context *ctx;
+
+    std::vector<std::string> strings;
+    // Lazily interned IdString per string table entry, so each unique name
+    // hits the IdString database once no matter how often it is referenced
+    std::vector<IdString> ids;
+
+    uint8_t get_u8()
+    {
+        int c = in.get();
+        if (c == EOF)
+            log_error("unexpected end of file parsing binary netlist '%s'\n", filename.c_str());
+        return uint8_t(c);
+    }
+    uint32_t get_u32()
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++)
+            value |= uint32_t(get_u8()) << (8 * i);
+        return value;
+    }
+    uint64_t get_u64()
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; i++)
+            value |= uint64_t(get_u8()) << (8 * i);
+        return value;
+    }
+
+    uint32_t get_ref()
+    {
+        uint32_t idx = get_u32();
+        if (idx != bnl_no_ref && idx >= strings.size())
+            log_error("invalid string reference parsing binary netlist '%s'\n", filename.c_str());
+        return idx;
+    }
+    const std::string &get_str() { return strings.at(get_ref()); }
+    IdString get_id()
+    {
+        uint32_t idx = get_ref();
+        if (ids.at(idx) == IdString() && !strings.at(idx).empty())
+            ids.at(idx) = ctx->id(strings.at(idx));
+        return ids.at(idx);
+    }
+    Property get_prop()
+    {
+        Property value;
+        value.is_string = (get_u8() != 0);
+        value.str = get_str();
+        value.intval = int64_t(get_u64());
+        return value;
+    }
+    void get_id_dict(dict<IdString, IdString> &values)
+    {
+        uint32_t count = get_u32();
+        for (uint32_t i = 0; i < count; i++) {
+            IdString key = get_id();
+            values[key] = get_id();
+        }
+    }
+    void get_prop_dict(dict<IdString, Property> &values)
+    {
+        uint32_t count = get_u32();
+        for (uint32_t i = 0; i < count; i++) {
+            IdString key = get_id();
+            values[key] = get_prop();
+        }
+    }
+    NetInfo *get_net_ref()
+    {
+        uint32_t idx = get_ref();
+        if (idx == bnl_no_ref)
+            return nullptr;
+        return ctx->nets.at(ctx->id(strings.at(idx))).get();
+    }
+    void get_portref(NetInfo *ni, PortRef &port)
+    {
+        uint32_t idx = get_ref();
+        if (idx == bnl_no_ref) {
+            port.cell = nullptr;
+            return;
+        }
+        port.cell = ctx->cells.at(ctx->id(strings.at(idx))).get();
+        port.port = get_id();
+        port.cell->ports.at(port.port).net = ni;
+    }
+
+    void operator()()
+    {
+        if (get_u32() != bnl_magic)
+            log_error("'%s' is not a binary netlist file\n", filename.c_str());
+        uint32_t version = get_u32();
+        if (version != bnl_version)
+            log_error("binary netlist '%s' has version %u, expected %u (regenerate it with this nextpnr build)\n",
+                      filename.c_str(), unsigned(version), unsigned(bnl_version));
+        uint32_t nstrings = get_u32();
+        strings.resize(nstrings);
+        ids.resize(nstrings);
+        for (uint32_t i = 0; i < nstrings; i++) {
+            uint32_t len = get_u32();
+            strings.at(i).resize(len);
+            in.read(&strings.at(i)[0], len);
+            if (!in)
+                log_error("unexpected end of file parsing binary netlist '%s'\n", filename.c_str());
+        }
+
+        // Replay the writer's IdString database so indices come out
+        // identical. This only works if everything interned so far is a
+        // prefix of the writer's table, which holds when the loading run
+        // matches the writing one up to the load point (the --pack-cache
+        // contract); anything else would silently renumber names, so fail
+        // loudly instead
+        uint32_t n_ids = get_u32();
+        for (uint32_t i = 0; i < n_ids; i++) {
+            const std::string &name = get_str();
+            IdString id = name.empty() ? IdString() : ctx->id(name);
+            if (id.index != int(i))
+                log_error("binary netlist '%s' cannot replay IdString table ('%s' is #%d, expected #%u); it was "
+                          "written by a flow with different settings, regenerate it\n",
+                          filename.c_str(), name.c_str(), id.index, unsigned(i));
+        }
+
+        ctx->top_module = get_id();
+        get_prop_dict(ctx->attrs);
+        // Settings already present (e.g. from the command line) win over the
+        // snapshot; only design-derived settings are filled in, appended in
+        // saved order so dict iteration matches the writing run
+        uint32_t nsettings = get_u32();
+        for (uint32_t i = 0; i < nsettings; i++) {
+            IdString name = get_id();
+            Property value = get_prop();
+            if (!ctx->settings.count(name))
+                ctx->settings[name] = value;
+        }
+
+        uint32_t ncells = get_u32();
+        for (uint32_t i = 0; i < ncells; i++) {
+            IdString name = get_id();
+            CellInfo *ci = ctx->createCell(name, get_id());
+            ci->hierpath = get_id();
+            uint32_t nports = get_u32();
+            for (uint32_t j = 0; j < nports; j++) {
+                IdString port_name = get_id();
+                PortInfo &pi = ci->ports[port_name];
+                pi.name = port_name;
+                pi.net = nullptr;
+                pi.type = PortType(get_u8());
+            }
+            get_prop_dict(ci->attrs);
+            get_prop_dict(ci->params);
+        }
+
+        uint32_t nnets = get_u32();
+        for (uint32_t i = 0; i < nnets; i++) {
+            IdString name = get_id();
+            NetInfo *ni = ctx->createNet(name);
+            ni->hierpath = get_id();
+            get_prop_dict(ni->attrs);
+            get_portref(ni, ni->driver);
+            uint32_t nusers = get_u32();
+            ni->users.resize(nusers);
+            for (uint32_t j = 0; j < nusers; j++)
+                get_portref(ni, ni->users.at(j));
+            uint32_t naliases = get_u32();
+            ni->aliases.reserve(naliases);
+            for (uint32_t j = 0; j < naliases; j++)
+                ni->aliases.push_back(get_id());
+        }
+
+        get_id_dict(ctx->net_aliases);
+
+        uint32_t nports = get_u32();
+        for (uint32_t i = 0; i < nports; i++) {
+            IdString name = get_id();
+            PortInfo &pi = ctx->ports[name];
+            pi.name = name;
+            pi.type = PortType(get_u8());
+            pi.net = get_net_ref();
+            // Top-level ports are backed by an IO buffer cell of the same name
+            auto fnd_cell = ctx->cells.find(name);
+            if (fnd_cell != ctx->cells.end())
+                ctx->port_cells[name] = fnd_cell->second.get();
+        }
+
+        uint32_t nhier = get_u32();
+        for (uint32_t i = 0; i < nhier; i++) {
+            IdString path = get_id();
+            HierarchicalCell &hc = ctx->hierarchy[path];
+            hc.name = get_id();
+            hc.type = get_id();
+            hc.parent = get_id();
+            hc.fullpath = get_id();
+            get_id_dict(hc.leaf_cells);
+            get_id_dict(hc.nets);
+            get_id_dict(hc.leaf_cells_by_gname);
+            get_id_dict(hc.nets_by_gname);
+            uint32_t nhports = get_u32();
+            for (uint32_t j = 0; j < nhports; j++) {
+                IdString port_name = get_id();
+                HierarchicalPort &hp = hc.ports[port_name];
+                hp.name = port_name;
+                hp.dir = PortType(get_u8());
+                uint32_t nhnets = get_u32();
+                hp.nets.reserve(nhnets);
+                for (uint32_t k = 0; k < nhnets; k++)
+                    hp.nets.push_back(get_id());
+                hp.offset = int(get_u32());
+                hp.upto = (get_u8() != 0);
+            }
+            get_id_dict(hc.hier_cells);
+        }
+
+        // Probe by string rather than ctx->id("synth"): interning a name
+        // the writer never used would diverge from the replayed table
+        bool is_synth = false;
+        for (auto &setting : ctx->settings)
+            if (setting.first.str(ctx) == "synth")
+                is_synth = true;
+        if (is_synth)
+            ctx->attributesToArchInfo();
+        ctx->design_loaded = true;
+    }
+};
+
+} // namespace
+
+bool parse_binary_netlist(std::istream &in, const std::string &filename, Context *ctx)
+{
+    try {
+        if (!in)
+            log_error("failed to open binary netlist file '%s'\n", filename.c_str());
+        BinaryNetlistReader reader(in, filename, ctx);
+        reader();
+        log_info("Loaded binary netlist '%s': %d cells, %d nets\n", filename.c_str(), int(ctx->cells.size()),
+                 int(ctx->nets.size()));
+        return true;
+    } catch (log_execution_error_exception) {
+        return false;
+    }
+}
+
+bool binary_netlist_version_ok(std::istream &in)
+{
+    uint8_t hdr[8];
+    in.read(reinterpret_cast<char *>(hdr), sizeof(hdr));
+    bool ok = bool(in);
+    if (ok) {
+        uint32_t magic = 0, version = 0;
+        for (int i = 0; i < 4; i++) {
+            magic |= uint32_t(hdr[i]) << (8 * i);
+            version |= uint32_t(hdr[4 + i]) << (8 * i);
+        }
+        ok = (magic == bnl_magic && version == bnl_version);
+    }
+    in.clear();
+    in.seekg(0, std::ios::beg);
+    return ok;
+}
+
+bool write_binary_netlist(std::ostream &out, const std::string &filename, Context *ctx)
+{
+    try {
+        if (!out)
+            log_error("failed to open binary netlist file '%s' for writing\n", filename.c_str());
+        BinaryNetlistWriter writer(ctx);
+        writer(out);
+        log_info("Wrote binary netlist '%s'\n", filename.c_str());
+        return true;
+    } catch (log_execution_error_exception) {
+        return false;
+    }
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,37 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2021  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// A compact binary snapshot of the elaborated netlist, as produced by the
+// JSON frontend. Loading it skips tokenising and bit-vector expansion
+// entirely, so repeated runs on the same design (seed sweeps, option
+// sweeps) don't pay the JSON parse cost every time. The format is tied to
+// the netlist data structures and makes no cross-version compatibility
+// promises; regenerate the snapshot after upgrading nextpnr.
+bool parse_binary_netlist(std::istream &in, const std::string &filename, Context *ctx);
+bool write_binary_netlist(std::ostream &out, const std::string &filename, Context *ctx);
+// True if the stream starts with a current-version binary netlist header;
+// rewinds the stream either way. Lets cache lookups treat a snapshot left
+// behind by an older build as a miss instead of a load error
+bool binary_netlist_version_ok(std::istream &in);
+
+NEXTPNR_NAMESPACE_END
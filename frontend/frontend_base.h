@@ -69,15 +69,17 @@
  *       gets the type of a cell
  *
  *   void foreach_attr(const {ModuleDataType|CellDataType|ModulePortDataType|NetnameDataType} &obj, Func) const;
- *       calls Func(const std::string &name, const Property &value);
- *       for each attribute on a module, cell, module port or net
+ *       calls Func(const std::string &name, Property value);
+ *       for each attribute on a module, cell, module port or net.
+ *       Implementations may pass a temporary; Func takes the value by value
+ *       so the importer can move it straight into the netlist dicts
  *
  *   void foreach_param(const CellDataType &obj, Func) const;
- *       calls Func(const std::string &name, const Property &value);
+ *       calls Func(const std::string &name, Property value);
  *       for each parameter of a cell
  *
  *   void foreach_setting(const ModuleDataType &obj, Func) const;
- *       calls Func(const std::string &name, const Property &value);
+ *       calls Func(const std::string &name, Property value);
  *       for each module-level setting
  *
  *   void foreach_port_dir(const CellDataType &cell, Func) const;
@@ -278,11 +280,12 @@ template <typename FrontendType> struct GenericFrontend
             impl.foreach_port(data,
                               [&](const std::string &name, const mod_port_dat_t &) { m.port_to_bus[ctx->id(name)]; });
             // Import module-level attributes
-            impl.foreach_attr(
-                    data, [&](const std::string &name, const Property &value) { ctx->attrs[ctx->id(name)] = value; });
+            impl.foreach_attr(data, [&](const std::string &name, Property value) {
+                ctx->attrs[ctx->id(name)] = std::move(value);
+            });
             // Import settings
-            impl.foreach_setting(data, [&](const std::string &name, const Property &value) {
-                ctx->settings[ctx->id(name)] = value;
+            impl.foreach_setting(data, [&](const std::string &name, Property value) {
+                ctx->settings[ctx->id(name)] = std::move(value);
             });
         }
         import_module_netnames(m, data);
@@ -427,8 +430,8 @@ template <typename FrontendType> struct GenericFrontend
                 int mapped_bit = m.net_by_idx(net_bit);
                 if (mapped_bit != -1) {
                     NetInfo *ni = net_flatindex.at(mapped_bit);
-                    impl.foreach_attr(nn, [&](const std::string &name, const Property &value) {
-                        ni->attrs[ctx->id(name)] = value;
+                    impl.foreach_attr(nn, [&](const std::string &name, Property value) {
+                        ni->attrs[ctx->id(name)] = std::move(value);
                     });
                 }
             }
@@ -444,34 +447,69 @@ template <typename FrontendType> struct GenericFrontend
         return ni;
     }
 
+    // Leaf cell types repeat thousands of times in a large design, but their
+    // port shapes are fixed per type; cache the interned port directions and
+    // per-bit port names so repeat instances skip the string formatting and
+    // interning entirely. Bit names are re-derived if a port's width ever
+    // differs from the cached instance (e.g. width-parameterised boxes)
+    struct LeafTypeShape
+    {
+        dict<IdString, PortType> port_dirs;
+        dict<IdString, std::vector<IdString>> port_bits;
+    };
+    dict<IdString, LeafTypeShape> leaf_type_shapes;
+
+    const std::vector<IdString> &get_port_bit_names(LeafTypeShape &shape, const std::string &name, IdString name_id,
+                                                    int width)
+    {
+        auto &bits = shape.port_bits[name_id];
+        if (int(bits.size()) != width) {
+            bits.clear();
+            bits.reserve(width);
+            for (int i = 0; i < width; i++)
+                bits.push_back(ctx->id(get_bit_name(name, i, width)));
+        }
+        return bits;
+    }
+
     // Import a leaf cell - (white|black)box
     void import_leaf_cell(HierModuleState &m, const std::string &name, const cell_dat_t &cd)
     {
         IdString inst_name = unique_name(m.prefix, name, false);
         ctx->hierarchy[m.path].leaf_cells_by_gname[inst_name] = ctx->id(name);
         ctx->hierarchy[m.path].leaf_cells[ctx->id(name)] = inst_name;
-        CellInfo *ci = ctx->createCell(inst_name, ctx->id(impl.get_cell_type(cd)));
+        IdString type = ctx->id(impl.get_cell_type(cd));
+        CellInfo *ci = ctx->createCell(inst_name, type);
         ci->hierpath = m.path;
-        // Import port directions
-        dict<IdString, PortType> port_dirs;
-        impl.foreach_port_dir(cd, [&](const std::string &port, PortType dir) { port_dirs[ctx->id(port)] = dir; });
+        // Import port directions, unless already cached for this cell type
+        auto fnd_shape = leaf_type_shapes.find(type);
+        if (fnd_shape == leaf_type_shapes.end()) {
+            auto &new_shape = leaf_type_shapes[type];
+            impl.foreach_port_dir(cd,
+                                  [&](const std::string &port, PortType dir) { new_shape.port_dirs[ctx->id(port)] = dir; });
+            fnd_shape = leaf_type_shapes.find(type);
+        }
+        LeafTypeShape &shape = fnd_shape->second;
         // Import port connectivity
         impl.foreach_port_conn(cd, [&](const std::string &name, const bitvector_t &bits) {
-            if (!port_dirs.count(ctx->id(name)))
+            IdString name_id = ctx->id(name);
+            if (!shape.port_dirs.count(name_id))
                 log_error("Failed to get direction for port '%s' of cell '%s'\n", name.c_str(), inst_name.c_str(ctx));
-            PortType dir = port_dirs.at(ctx->id(name));
+            PortType dir = shape.port_dirs.at(name_id);
             int width = impl.get_vector_length(bits);
+            const auto &bit_names = get_port_bit_names(shape, name, name_id, width);
             for (int i = 0; i < width; i++) {
-                std::string port_bit_name = get_bit_name(name, i, width);
-                IdString port_bit_ids = ctx->id(port_bit_name);
-                // Create cell port
-                ci->ports[port_bit_ids].name = port_bit_ids;
-                ci->ports[port_bit_ids].type = dir;
+                IdString port_bit_ids = bit_names.at(i);
+                // Create cell port; one dict insert rather than a lookup
+                // per field
+                auto &port = ci->ports[port_bit_ids];
+                port.name = port_bit_ids;
+                port.type = dir;
                 // Resolve connectivity
                 NetInfo *net;
                 if (impl.is_vector_bit_constant(bits, i)) {
                     // Create a constant driver if one is needed
-                    net = create_constant_net(m, inst_name.str(ctx) + "." + port_bit_name + "$const",
+                    net = create_constant_net(m, inst_name.str(ctx) + "." + port_bit_ids.str(ctx) + "$const",
                                               impl.get_vector_bit_constval(bits, i));
                 } else {
                     // Otherwise, lookup (creating if needed) the net with this index
@@ -483,15 +521,15 @@ template <typename FrontendType> struct GenericFrontend
                 if (dir == PORT_OUT && net->driver.cell != nullptr)
                     log_error("Net '%s' is multiply driven by cell ports %s.%s and %s.%s\n", ctx->nameOf(net),
                               ctx->nameOf(net->driver.cell), ctx->nameOf(net->driver.port), ctx->nameOf(inst_name),
-                              port_bit_name.c_str());
+                              port_bit_ids.c_str(ctx));
                 connect_port(ctx, net, ci, port_bit_ids);
             }
         });
         // Import attributes and parameters
-        impl.foreach_attr(cd,
-                          [&](const std::string &name, const Property &value) { ci->attrs[ctx->id(name)] = value; });
-        impl.foreach_param(cd,
-                           [&](const std::string &name, const Property &value) { ci->params[ctx->id(name)] = value; });
+        impl.foreach_attr(
+                cd, [&](const std::string &name, Property value) { ci->attrs[ctx->id(name)] = std::move(value); });
+        impl.foreach_param(
+                cd, [&](const std::string &name, Property value) { ci->params[ctx->id(name)] = std::move(value); });
     }
 
     // Import a submodule cell
@@ -614,8 +652,8 @@ template <typename FrontendType> struct GenericFrontend
         pinfo.name = name_id;
         pinfo.net = net;
         pinfo.type = dir;
-        ctx->ports[pinfo.name] = pinfo;
-        ctx->port_cells[pinfo.name] = iobuf;
+        ctx->ports[name_id] = std::move(pinfo);
+        ctx->port_cells[name_id] = iobuf;
 
         return iobuf;
     }
@@ -20,6 +20,7 @@
 #include "json_frontend.h"
 #include "frontend_base.h"
 #include "json11.hpp"
+#include "json_stream_frontend.h"
 #include "log.h"
 #include "nextpnr.h"
 
@@ -183,10 +184,19 @@ struct JsonFrontendImpl
 
 bool parse_json(std::istream &in, const std::string &filename, Context *ctx)
 {
+    if (!in)
+        log_error("Failed to open JSON file '%s'.\n", filename.c_str());
+    // Fast path: stream the known Yosys schema straight into a compact
+    // netlist model, avoiding both the full file buffer and the JSON DOM.
+    // Input using JSON constructs beyond that schema (or malformed input)
+    // falls through to the general DOM parser below, which also produces
+    // the proper error messages.
+    if (parse_json_stream(in, filename, ctx))
+        return true;
+    in.clear();
+    in.seekg(0, std::ios::beg);
     Json root;
     {
-        if (!in)
-            log_error("Failed to open JSON file '%s'.\n", filename.c_str());
         std::string json_str((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
         std::string error;
         root = Json::parse(json_str, error, JsonParse::COMMENTS);
@@ -197,6 +207,17 @@ bool parse_json(std::istream &in, const std::string &filename, Context *ctx)
             log_error("JSON file '%s' doesn't look like a netlist (doesn't contain \"modules\" key)\n",
                       filename.c_str());
     }
+    // Pre-size the IdString intern tables from the symbol table: the port,
+    // cell and netname maps bound the number of distinct names the import
+    // can create (cells count twice, for the instance name and the type)
+    size_t symbol_count = 0;
+    for (const auto &mod : root.object_items()) {
+        symbol_count += 1;
+        symbol_count += mod.second["ports"].object_items().size();
+        symbol_count += 2 * mod.second["cells"].object_items().size();
+        symbol_count += mod.second["netnames"].object_items().size();
+    }
+    ctx->idstring_db->reserve(int(symbol_count));
     GenericFrontend<JsonFrontendImpl>(ctx, JsonFrontendImpl(root), /*split_io=*/true)();
     return true;
 }
@@ -0,0 +1,566 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2019  gatecat <gatecat@ds0.me>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "json_stream_frontend.h"
+#include "frontend_base.h"
+#include "log.h"
+#include "nextpnr.h"
+
+#include <cstdlib>
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+
+// Thrown on any construct outside the expected Yosys schema (or malformed
+// JSON); the caller then falls back to the DOM parser, which either handles
+// the input or produces the proper error message
+struct schema_mismatch
+{
+};
+
+// Compact netlist model built by the streaming parser. Bit vector entries
+// are signal indices when non-negative, or the negated character code of a
+// constant bit ('0', '1', 'x', 'z') when negative. Properties are parsed
+// eagerly so no JSON values are retained.
+typedef std::vector<int32_t> SBitVector;
+typedef std::vector<std::pair<std::string, Property>> SPropList;
+
+struct SPort
+{
+    PortType dir = PORT_IN;
+    SBitVector bits;
+    int offset = 0;
+    bool upto = false;
+    SPropList attrs;
+};
+
+struct SCell
+{
+    std::string type;
+    std::vector<std::pair<std::string, PortType>> port_dirs;
+    std::vector<std::pair<std::string, SBitVector>> connections;
+    SPropList attrs, params;
+};
+
+struct SNetname
+{
+    SBitVector bits;
+    int offset = 0;
+    bool upto = false;
+    SPropList attrs;
+};
+
+struct SModule
+{
+    std::vector<std::pair<std::string, SPort>> ports;
+    std::vector<std::pair<std::string, SCell>> cells;
+    std::vector<std::pair<std::string, SNetname>> netnames;
+    SPropList attrs, settings;
+};
+
+struct SNetlist
+{
+    std::vector<std::pair<std::string, SModule>> modules;
+};
+
+struct StreamParser
+{
+    explicit StreamParser(std::istream &in) : buf(in.rdbuf()) {}
+    std::streambuf *buf;
+
+    int peek() { return buf->sgetc(); }
+    int get() { return buf->sbumpc(); }
+    void error() { throw schema_mismatch(); }
+
+    // Skips whitespace and //- and /**/-style comments (the DOM parser is
+    // invoked with comment support enabled, so match it)
+    void skip_ws()
+    {
+        while (true) {
+            int c = peek();
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                get();
+            } else if (c == '/') {
+                get();
+                int c2 = get();
+                if (c2 == '/') {
+                    while (true) {
+                        int c3 = get();
+                        if (c3 == EOF || c3 == '\n')
+                            break;
+                    }
+                } else if (c2 == '*') {
+                    int prev = 0;
+                    while (true) {
+                        int c3 = get();
+                        if (c3 == EOF)
+                            error();
+                        if (prev == '*' && c3 == '/')
+                            break;
+                        prev = c3;
+                    }
+                } else {
+                    error();
+                }
+            } else {
+                break;
+            }
+        }
+    }
+
+    int next() { return (skip_ws(), peek()); }
+    void expect(char want)
+    {
+        skip_ws();
+        if (get() != want)
+            error();
+    }
+    bool accept(char want)
+    {
+        skip_ws();
+        if (peek() != want)
+            return false;
+        get();
+        return true;
+    }
+    void expect_literal(const char *lit)
+    {
+        for (const char *p = lit; *p; p++)
+            if (get() != *p)
+                error();
+    }
+
+    uint32_t parse_hex4()
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) {
+            int c = get();
+            if (c >= '0' && c <= '9')
+                value = (value << 4) | (c - '0');
+            else if (c >= 'a' && c <= 'f')
+                value = (value << 4) | (c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                value = (value << 4) | (c - 'A' + 10);
+            else
+                error();
+        }
+        return value;
+    }
+
+    void encode_utf8(uint32_t cp, std::string &out)
+    {
+        if (cp < 0x80) {
+            out += char(cp);
+        } else if (cp < 0x800) {
+            out += char(0xC0 | (cp >> 6));
+            out += char(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += char(0xE0 | (cp >> 12));
+            out += char(0x80 | ((cp >> 6) & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        } else {
+            out += char(0xF0 | (cp >> 18));
+            out += char(0x80 | ((cp >> 12) & 0x3F));
+            out += char(0x80 | ((cp >> 6) & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        }
+    }
+
+    std::string parse_string()
+    {
+        expect('"');
+        std::string out;
+        while (true) {
+            int c = get();
+            if (c == EOF)
+                error();
+            if (c == '"')
+                break;
+            if (c == '\\') {
+                int e = get();
+                switch (e) {
+                case '"':
+                case '\\':
+                case '/':
+                    out += char(e);
+                    break;
+                case 'b':
+                    out += '\b';
+                    break;
+                case 'f':
+                    out += '\f';
+                    break;
+                case 'n':
+                    out += '\n';
+                    break;
+                case 'r':
+                    out += '\r';
+                    break;
+                case 't':
+                    out += '\t';
+                    break;
+                case 'u': {
+                    uint32_t cp = parse_hex4();
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        // High surrogate; must be followed by a low one
+                        if (get() != '\\' || get() != 'u')
+                            error();
+                        uint32_t lo = parse_hex4();
+                        if (lo < 0xDC00 || lo > 0xDFFF)
+                            error();
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    }
+                    encode_utf8(cp, out);
+                    break;
+                }
+                default:
+                    error();
+                }
+            } else {
+                out += char(c);
+            }
+        }
+        return out;
+    }
+
+    double parse_number()
+    {
+        skip_ws();
+        std::string tok;
+        while (true) {
+            int c = peek();
+            if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+                tok += char(get());
+            } else {
+                break;
+            }
+        }
+        if (tok.empty())
+            error();
+        char *end = nullptr;
+        double value = std::strtod(tok.c_str(), &end);
+        if (end != tok.c_str() + tok.size())
+            error();
+        return value;
+    }
+
+    // Parses a number that the DOM path would have surfaced as a 32-bit int
+    int parse_int()
+    {
+        double value = parse_number();
+        int ivalue = int(value);
+        if (double(ivalue) != value)
+            error();
+        return ivalue;
+    }
+
+    // Skip over an arbitrary well-formed value without retaining it
+    void skip_value()
+    {
+        int c = next();
+        if (c == '"') {
+            parse_string();
+        } else if (c == '{') {
+            parse_object([&](const std::string &) { skip_value(); });
+        } else if (c == '[') {
+            expect('[');
+            if (accept(']'))
+                return;
+            do {
+                skip_value();
+            } while (accept(','));
+            expect(']');
+        } else if (c == 't') {
+            expect_literal("true");
+        } else if (c == 'f') {
+            expect_literal("false");
+        } else if (c == 'n') {
+            expect_literal("null");
+        } else {
+            parse_number();
+        }
+    }
+
+    // Parse an object, calling on_key(key) with the stream positioned at the
+    // value, which on_key must fully consume
+    template <typename TFunc> void parse_object(TFunc on_key)
+    {
+        expect('{');
+        if (accept('}'))
+            return;
+        do {
+            std::string key = parse_string();
+            expect(':');
+            on_key(key);
+        } while (accept(','));
+        expect('}');
+    }
+
+    Property parse_property()
+    {
+        if (next() == '"')
+            return Property::from_string(parse_string());
+        return Property(parse_int(), 32);
+    }
+
+    void parse_prop_dict(SPropList &out)
+    {
+        parse_object([&](const std::string &key) { out.emplace_back(key, parse_property()); });
+    }
+
+    PortType parse_port_dir()
+    {
+        std::string dir = (skip_ws(), parse_string());
+        if (dir == "input")
+            return PORT_IN;
+        else if (dir == "inout")
+            return PORT_INOUT;
+        else if (dir == "output")
+            return PORT_OUT;
+        error();
+        return PORT_IN; // unreachable
+    }
+
+    void parse_bits(SBitVector &bits)
+    {
+        expect('[');
+        if (accept(']'))
+            return;
+        do {
+            if (next() == '"') {
+                std::string constval = parse_string();
+                if (constval.size() != 1)
+                    error();
+                bits.push_back(-int32_t(constval.at(0)));
+            } else {
+                int signal = parse_int();
+                if (signal < 0)
+                    error();
+                bits.push_back(signal);
+            }
+        } while (accept(','));
+        expect(']');
+    }
+
+    void parse_module(SModule &mod)
+    {
+        parse_object([&](const std::string &key) {
+            if (key == "ports") {
+                parse_object([&](const std::string &name) {
+                    mod.ports.emplace_back(name, SPort());
+                    SPort &port = mod.ports.back().second;
+                    parse_object([&](const std::string &field) {
+                        if (field == "direction")
+                            port.dir = parse_port_dir();
+                        else if (field == "bits")
+                            parse_bits(port.bits);
+                        else if (field == "offset")
+                            port.offset = parse_int();
+                        else if (field == "upto")
+                            port.upto = (parse_int() != 0);
+                        else if (field == "attributes")
+                            parse_prop_dict(port.attrs);
+                        else
+                            skip_value();
+                    });
+                });
+            } else if (key == "cells") {
+                parse_object([&](const std::string &name) {
+                    mod.cells.emplace_back(name, SCell());
+                    SCell &cell = mod.cells.back().second;
+                    parse_object([&](const std::string &field) {
+                        if (field == "type") {
+                            skip_ws();
+                            cell.type = parse_string();
+                        } else if (field == "port_directions") {
+                            parse_object([&](const std::string &port) {
+                                cell.port_dirs.emplace_back(port, parse_port_dir());
+                            });
+                        } else if (field == "connections") {
+                            parse_object([&](const std::string &port) {
+                                cell.connections.emplace_back(port, SBitVector());
+                                parse_bits(cell.connections.back().second);
+                            });
+                        } else if (field == "attributes") {
+                            parse_prop_dict(cell.attrs);
+                        } else if (field == "parameters") {
+                            parse_prop_dict(cell.params);
+                        } else {
+                            skip_value();
+                        }
+                    });
+                });
+            } else if (key == "netnames") {
+                parse_object([&](const std::string &name) {
+                    mod.netnames.emplace_back(name, SNetname());
+                    SNetname &net = mod.netnames.back().second;
+                    parse_object([&](const std::string &field) {
+                        if (field == "bits")
+                            parse_bits(net.bits);
+                        else if (field == "offset")
+                            net.offset = parse_int();
+                        else if (field == "upto")
+                            net.upto = (parse_int() != 0);
+                        else if (field == "attributes")
+                            parse_prop_dict(net.attrs);
+                        else
+                            skip_value();
+                    });
+                });
+            } else if (key == "attributes") {
+                parse_prop_dict(mod.attrs);
+            } else if (key == "settings") {
+                parse_prop_dict(mod.settings);
+            } else {
+                skip_value();
+            }
+        });
+    }
+
+    void parse_netlist(SNetlist &netlist)
+    {
+        bool seen_modules = false;
+        parse_object([&](const std::string &key) {
+            if (key == "modules") {
+                seen_modules = true;
+                parse_object([&](const std::string &name) {
+                    netlist.modules.emplace_back(name, SModule());
+                    parse_module(netlist.modules.back().second);
+                });
+            } else {
+                skip_value();
+            }
+        });
+        if (!seen_modules)
+            error();
+        if (next() != EOF)
+            error();
+    }
+};
+
+struct JsonStreamFrontendImpl
+{
+    // See specification in frontend_base.h
+    JsonStreamFrontendImpl(SNetlist &netlist) : netlist(netlist){};
+    SNetlist &netlist;
+    typedef const SModule &ModuleDataType;
+    typedef const SPort &ModulePortDataType;
+    typedef const SCell &CellDataType;
+    typedef const SNetname &NetnameDataType;
+    typedef const SBitVector &BitVectorDataType;
+
+    template <typename TFunc> void foreach_module(TFunc Func) const
+    {
+        for (const auto &mod : netlist.modules)
+            Func(mod.first, mod.second);
+    }
+
+    template <typename TFunc> void foreach_port(ModuleDataType &mod, TFunc Func) const
+    {
+        for (const auto &port : mod.ports)
+            Func(port.first, port.second);
+    }
+
+    template <typename TFunc> void foreach_cell(ModuleDataType &mod, TFunc Func) const
+    {
+        for (const auto &cell : mod.cells)
+            Func(cell.first, cell.second);
+    }
+
+    template <typename TFunc> void foreach_netname(ModuleDataType &mod, TFunc Func) const
+    {
+        for (const auto &netname : mod.netnames)
+            Func(netname.first, netname.second);
+    }
+
+    PortType get_port_dir(ModulePortDataType &port) const { return port.dir; }
+
+    int get_array_offset(ModulePortDataType &port) const { return port.offset; }
+    int get_array_offset(NetnameDataType &net) const { return net.offset; }
+
+    bool is_array_upto(ModulePortDataType &port) const { return port.upto; }
+    bool is_array_upto(NetnameDataType &net) const { return net.upto; }
+
+    BitVectorDataType &get_port_bits(ModulePortDataType &port) const { return port.bits; }
+
+    const std::string &get_cell_type(CellDataType &cell) const { return cell.type; }
+
+    template <typename TObj, typename TFunc> void foreach_attr(const TObj &obj, TFunc Func) const
+    {
+        for (const auto &attr : obj.attrs)
+            Func(attr.first, attr.second);
+    }
+
+    template <typename TFunc> void foreach_param(CellDataType &cell, TFunc Func) const
+    {
+        for (const auto &param : cell.params)
+            Func(param.first, param.second);
+    }
+
+    template <typename TFunc> void foreach_setting(ModuleDataType &mod, TFunc Func) const
+    {
+        for (const auto &setting : mod.settings)
+            Func(setting.first, setting.second);
+    }
+
+    template <typename TFunc> void foreach_port_dir(CellDataType &cell, TFunc Func) const
+    {
+        for (const auto &pdir : cell.port_dirs)
+            Func(pdir.first, pdir.second);
+    }
+
+    template <typename TFunc> void foreach_port_conn(CellDataType &cell, TFunc Func) const
+    {
+        for (const auto &pconn : cell.connections)
+            Func(pconn.first, pconn.second);
+    }
+
+    BitVectorDataType &get_net_bits(NetnameDataType &net) const { return net.bits; }
+
+    int get_vector_length(BitVectorDataType &bits) const { return int(bits.size()); }
+
+    bool is_vector_bit_constant(BitVectorDataType &bits, int i) const { return bits.at(i) < 0; }
+
+    char get_vector_bit_constval(BitVectorDataType &bits, int i) const { return char(-bits.at(i)); }
+
+    int get_vector_bit_signal(BitVectorDataType &bits, int i) const
+    {
+        NPNR_ASSERT(bits.at(i) >= 0);
+        return bits.at(i);
+    }
+};
+
+} // namespace
+
+bool parse_json_stream(std::istream &in, const std::string &filename, Context *ctx)
+{
+    if (!in)
+        log_error("Failed to open JSON file '%s'.\n", filename.c_str());
+    SNetlist netlist;
+    try {
+        StreamParser(in).parse_netlist(netlist);
+    } catch (schema_mismatch &) {
+        return false;
+    }
+    GenericFrontend<JsonStreamFrontendImpl>(ctx, JsonStreamFrontendImpl(netlist), /*split_io=*/true)();
+    return true;
+}
+
+NEXTPNR_NAMESPACE_END
@@ -196,6 +196,15 @@ struct Arch : ArchAPI<ArchRanges>
     void setLutK(int K);
     void setDelayScaling(double scale, double offset);
 
+    // Binary routing graph export/import for offline analysis tooling: a
+    // flat CSR dump of the wires (type, location), the per-wire downhill
+    // offsets, and the pips in downhill order (type, endpoints, delay,
+    // location), in native byte order. Exporting serialises wire and pip
+    // chunks on worker threads; importing rebuilds the graph through
+    // addWire/addPip so a dump can stand in for the usual Python setup.
+    void writeRoutingGraph(const std::string &filename) const;
+    void readRoutingGraph(const std::string &filename);
+
     void addCellTimingClock(IdString cell, IdString port);
     void addCellTimingDelay(IdString cell, IdString fromPort, IdString toPort, delay_t delay);
     void addCellTimingSetupHold(IdString cell, IdString port, IdString clock, delay_t setup, delay_t hold);
@@ -264,6 +273,7 @@ struct Arch : ArchAPI<ArchRanges>
     const std::map<IdString, std::string> &getPipAttrs(PipId pip) const override;
     uint32_t getPipChecksum(PipId pip) const override;
     void bindPip(PipId pip, NetInfo *net, PlaceStrength strength) override;
+    void bindPips(const std::vector<PipId> &pips, NetInfo *net, PlaceStrength strength) override;
     void unbindPip(PipId pip) override;
     bool checkPipAvail(PipId pip) const override;
     bool checkPipAvailForNet(PipId pip, NetInfo *net) const override;
@@ -276,6 +286,7 @@ struct Arch : ArchAPI<ArchRanges>
     WireId getPipDstWire(PipId pip) const override;
     DelayQuad getPipDelay(PipId pip) const override;
     const std::vector<PipId> &getPipsDownhill(WireId wire) const override;
+    void getPipsDownhillInfo(WireId wire, std::vector<PipDownhillInfo> &out) const override;
     const std::vector<PipId> &getPipsUphill(WireId wire) const override;
 
     GroupId getGroupByName(IdStringList name) const override;
@@ -302,6 +313,7 @@ struct Arch : ArchAPI<ArchRanges>
     bool pack() override;
     bool place() override;
     bool route() override;
+    void postPlaceFixup() override {}
 
     std::vector<IdString> getCellTypes() const override
     {
@@ -348,6 +360,7 @@ struct Arch : ArchAPI<ArchRanges>
 
     bool isValidBelForCellType(IdString cell_type, BelId bel) const override { return cell_type == getBelType(bel); }
     bool isBelLocationValid(BelId bel) const override;
+    bool isSwapLocationValid(CellInfo *cell, BelId newBel, CellInfo *other_cell, BelId oldBel) override;
 
     // TODO
     CellInfo *getClusterRootCell(ClusterId cluster) const override { NPNR_ASSERT_FALSE("unimplemented"); }
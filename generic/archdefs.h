@@ -37,6 +37,7 @@ typedef IdString ClusterId;
 
 struct ArchNetInfo
 {
+    bool is_global = false;
 };
 
 struct NetInfo;
@@ -33,7 +33,7 @@ class GenericCommandHandler : public CommandHandler
     GenericCommandHandler(int argc, char **argv);
     virtual ~GenericCommandHandler(){};
     std::unique_ptr<Context> createContext(dict<std::string, Property> &values) override;
-    void setupArchContext(Context *ctx) override{};
+    void setupArchContext(Context *ctx) override;
     void customBitstream(Context *ctx) override;
 
   protected:
@@ -47,10 +47,23 @@ po::options_description GenericCommandHandler::getArchOptions()
     po::options_description specific("Architecture specific options");
     specific.add_options()("generic", "set device type to generic");
     specific.add_options()("no-iobs", "disable automatic IO buffer insertion");
+    specific.add_options()("import-graph", po::value<std::string>(),
+                           "binary routing graph file to load before the netlist");
+    specific.add_options()("export-graph", po::value<std::string>(), "write the routing graph to a binary file");
     return specific;
 }
 
-void GenericCommandHandler::customBitstream(Context *ctx) {}
+void GenericCommandHandler::setupArchContext(Context *ctx)
+{
+    if (vm.count("import-graph"))
+        ctx->readRoutingGraph(vm["import-graph"].as<std::string>());
+}
+
+void GenericCommandHandler::customBitstream(Context *ctx)
+{
+    if (vm.count("export-graph"))
+        ctx->writeRoutingGraph(vm["export-graph"].as<std::string>());
+}
 
 std::unique_ptr<Context> GenericCommandHandler::createContext(dict<std::string, Property> &values)
 {
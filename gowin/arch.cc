@@ -261,6 +261,21 @@ void Arch::addCellTimingClockToOut(IdString cell, IdString port, IdString clock,
 
 // TODO represent wires more intelligently.
 IdString Arch::wireToGlobal(int &row, int &col, const DatabasePOD *db, IdString &wire)
+{
+    auto key = std::make_pair(wire.index, std::make_pair(row, col));
+    auto cached = wire_to_global.find(key);
+    if (cached != wire_to_global.end()) {
+        row = cached->second.row;
+        col = cached->second.col;
+        wire = cached->second.wire;
+        return cached->second.name;
+    }
+    IdString name = wireToGlobalUncached(row, col, db, wire);
+    wire_to_global[key] = GlobalWireResult{name, wire, row, col};
+    return name;
+}
+
+IdString Arch::wireToGlobalUncached(int &row, int &col, const DatabasePOD *db, IdString &wire)
 {
     const std::string &wirename = wire.str(this);
     char buf[32];
@@ -759,6 +774,19 @@ Arch::Arch(ArchArgs args) : args(args)
 
     // setup db
     char buf[32];
+    // Reserve the wire/pip tables up front: the pip count is known exactly
+    // from the database, and rehashing these tables mid-construction rewalks
+    // every entry already added
+    size_t total_pips = 0;
+    for (int i = 0; i < db->rows * db->cols; i++) {
+        const TilePOD *tile = db->grid[i].get();
+        total_pips += tile->num_pips + tile->num_clock_pips;
+    }
+    pips.reserve(total_pips);
+    pip_ids.reserve(total_pips);
+    wires.reserve(total_pips / 2);
+    wire_ids.reserve(total_pips / 2);
+    wire_to_global.reserve(total_pips);
     // The reverse order of the enumeration simplifies the creation
     // of MUX2_LUT8s: they need the existence of the wire on the right.
     for (int i = db->rows * db->cols - 1; i >= 0; --i) {
@@ -988,6 +1016,7 @@ void Arch::bindBel(BelId bel, CellInfo *cell, PlaceStrength strength)
 {
     bels.at(bel).bound_cell = cell;
     cell->bel = bel;
+    cell->loc = getBelLocation(bel);
     cell->belStrength = strength;
     refreshUiBel(bel);
 }
@@ -1052,6 +1081,7 @@ void Arch::bindWire(WireId wire, NetInfo *net, PlaceStrength strength)
     wires.at(wire).bound_net = net;
     net->wires[wire].pip = PipId();
     net->wires[wire].strength = strength;
+    ++net->route_version;
     refreshUiWire(wire);
 }
 
@@ -1066,6 +1096,7 @@ void Arch::unbindWire(WireId wire)
     }
 
     net_wires.erase(wire);
+    ++wires.at(wire).bound_net->route_version;
     wires.at(wire).bound_net = nullptr;
     refreshUiWire(wire);
 }
@@ -1102,6 +1133,7 @@ void Arch::bindPip(PipId pip, NetInfo *net, PlaceStrength strength)
     wires.at(wire).bound_net = net;
     net->wires[wire].pip = pip;
     net->wires[wire].strength = strength;
+    ++net->route_version;
     refreshUiPip(pip);
     refreshUiWire(wire);
 }
@@ -1110,6 +1142,7 @@ void Arch::unbindPip(PipId pip)
 {
     WireId wire = pips.at(pip).dstWire;
     wires.at(wire).bound_net->wires.erase(wire);
+    ++wires.at(wire).bound_net->route_version;
     pips.at(pip).bound_net = nullptr;
     wires.at(wire).bound_net = nullptr;
     refreshUiPip(pip);
@@ -335,6 +335,17 @@ struct Arch : BaseArch<ArchRanges>
     void addCellTimingClockToOut(IdString cell, IdString port, IdString clock, DelayQuad clktoq);
 
     IdString wireToGlobal(int &row, int &col, const DatabasePOD *db, IdString &wire);
+    // Memoized wireToGlobal results: chipdb setup resolves the same
+    // (wire, row, col) triple several times across the wire and pip passes,
+    // and every miss pays string formatting plus IdString interning
+    struct GlobalWireResult
+    {
+        IdString name;
+        IdString wire;
+        int row, col;
+    };
+    dict<std::pair<int, std::pair<int, int>>, GlobalWireResult> wire_to_global;
+    IdString wireToGlobalUncached(int &row, int &col, const DatabasePOD *db, IdString &wire);
     DelayQuad getWireTypeDelay(IdString wire);
     void read_cst(std::istream &in);
     void addMuxBels(const DatabasePOD *db, int row, int col);
@@ -28,6 +28,32 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
+// Typed cell buckets shared by the pack stages: one classification pass
+// over the netlist sorts cells into per-kind vectors of direct CellInfo
+// pointers, so each stage walks only the cells it can pack instead of
+// re-scanning every cell and re-fetching names from the cell dict.
+// Consumed cells are recorded in packed_cells but only erased from the
+// netlist after the last stage, which keeps bucket pointers valid
+// throughout; stages that can race for the same cell (LUT-FF packing vs
+// plain FF packing) skip entries already consumed.
+struct PackState
+{
+    std::vector<CellInfo *> iobs, wideluts, alus, luts, ffs;
+    pool<IdString> packed_cells;
+    pool<IdString> delete_nets;
+    std::vector<std::unique_ptr<CellInfo>> new_cells;
+
+    bool consumed(const CellInfo *ci) const { return packed_cells.count(ci->name); }
+    // move the cells a stage created into the netlist; buckets only cover
+    // the original cells, so later stages never re-scan these
+    void flush_new_cells(Context *ctx)
+    {
+        for (auto &ncell : new_cells)
+            ctx->cells[ncell->name] = std::move(ncell);
+        new_cells.clear();
+    }
+};
+
 static void make_dummy_alu(Context *ctx, int alu_idx, CellInfo *ci, CellInfo *packed_head,
                            std::vector<std::unique_ptr<CellInfo>> &new_cells)
 {
@@ -49,41 +75,34 @@ static void make_dummy_alu(Context *ctx, int alu_idx, CellInfo *ci, CellInfo *pa
 }
 
 // replace ALU with LUT
-static void pack_alus(Context *ctx)
+static void pack_alus(Context *ctx, PackState &st)
 {
     log_info("Packing ALUs..\n");
 
-    // cell name, CIN net name
-    pool<std::pair<IdString, IdString>> alu_heads;
+    // head cell, CIN net
+    std::vector<std::pair<CellInfo *, NetInfo *>> alu_heads;
 
     // collect heads
-    for (auto &cell : ctx->cells) {
-        CellInfo *ci = cell.second.get();
-        if (is_alu(ctx, ci)) {
-            NetInfo *cin = ci->ports.at(id_CIN).net;
-            CellInfo *cin_ci = cin->driver.cell;
-
-            if (cin == nullptr || cin_ci == nullptr) {
-                log_error("CIN disconnected at ALU:%s\n", ctx->nameOf(ci));
-                continue;
-            }
+    for (auto ci : st.alus) {
+        NetInfo *cin = ci->ports.at(id_CIN).net;
+        CellInfo *cin_ci = cin->driver.cell;
 
-            if (!is_alu(ctx, cin_ci) || cin->users.size() > 1) {
-                if (ctx->verbose) {
-                    log_info("ALU head found %s. CIN net is %s\n", ctx->nameOf(ci), ctx->nameOf(cin));
-                }
-                alu_heads.insert(std::make_pair(ci->name, cin->name));
+        if (cin == nullptr || cin_ci == nullptr) {
+            log_error("CIN disconnected at ALU:%s\n", ctx->nameOf(ci));
+            continue;
+        }
+
+        if (!is_alu(ctx, cin_ci) || cin->users.size() > 1) {
+            if (ctx->verbose) {
+                log_info("ALU head found %s. CIN net is %s\n", ctx->nameOf(ci), ctx->nameOf(cin));
             }
+            alu_heads.emplace_back(ci, cin);
         }
     }
 
-    pool<IdString> packed_cells;
-    pool<IdString> delete_nets;
-    std::vector<std::unique_ptr<CellInfo>> new_cells;
-
     for (auto &head : alu_heads) {
-        CellInfo *ci = ctx->cells[head.first].get();
-        IdString cin_netId = head.second;
+        CellInfo *ci = head.first;
+        IdString cin_netId = head.second->name;
         if (ctx->verbose) {
             log_info("cell '%s' is of type '%s'\n", ctx->nameOf(ci), ci->type.c_str(ctx));
         }
@@ -120,7 +139,7 @@ static void pack_alus(Context *ctx)
                 return;
             }
             // remove cell
-            packed_cells.insert(ci->name);
+            st.packed_cells.insert(ci->name);
 
             // CIN/COUT are hardwired, delete
             disconnect_port(ctx, ci, id_CIN);
@@ -175,7 +194,7 @@ static void pack_alus(Context *ctx)
                 replace_port(ci, id_I3, packed.get(), id_D);
             }
 
-            new_cells.push_back(std::move(packed));
+            st.new_cells.push_back(std::move(packed));
 
             if (cout != nullptr && cout->users.size() > 0) {
                 // if COUT used by logic
@@ -199,8 +218,8 @@ static void pack_alus(Context *ctx)
                     packed_tail->constr_y = 0;
                     ++alu_idx;
                     packed_head->constr_children.push_back(packed_tail.get());
-                    new_cells.push_back(std::move(packed_tail));
-                    make_dummy_alu(ctx, alu_idx, ci, packed_head.get(), new_cells);
+                    st.new_cells.push_back(std::move(packed_tail));
+                    make_dummy_alu(ctx, alu_idx, ci, packed_head.get(), st.new_cells);
                     break;
                 }
                 // next ALU
@@ -216,31 +235,21 @@ static void pack_alus(Context *ctx)
                 if (ctx->verbose) {
                     log_info("cell is the ALU tail. Index is %d\n", alu_idx);
                 }
-                make_dummy_alu(ctx, alu_idx, ci, packed_head.get(), new_cells);
+                make_dummy_alu(ctx, alu_idx, ci, packed_head.get(), st.new_cells);
                 break;
             }
         } while (1);
 
         // add head to the cluster
         packed_head->cluster = packed_head->name;
-        new_cells.push_back(std::move(packed_head));
+        st.new_cells.push_back(std::move(packed_head));
     }
 
-    // actual delete, erase and move cells/nets
-    for (auto pcell : packed_cells) {
-        ctx->cells.erase(pcell);
-    }
-    for (auto dnet : delete_nets) {
-        ctx->nets.erase(dnet);
-    }
-    for (auto &ncell : new_cells) {
-        ctx->cells[ncell->name] = std::move(ncell);
-    }
+    st.flush_new_cells(ctx);
 }
 
 // pack MUX2_LUT5
-static void pack_mux2_lut5(Context *ctx, CellInfo *ci, pool<IdString> &packed_cells, pool<IdString> &delete_nets,
-                           std::vector<std::unique_ptr<CellInfo>> &new_cells)
+static void pack_mux2_lut5(Context *ctx, CellInfo *ci, PackState &st)
 {
 
     if (bool_or_default(ci->attrs, ctx->id("SINGLE_INPUT_MUX"))) {
@@ -279,9 +288,9 @@ static void pack_mux2_lut5(Context *ctx, CellInfo *ci, pool<IdString> &packed_ce
         replace_port(ci, id_I1, packed.get(), id_I1);
 
         // remove cells
-        packed_cells.insert(ci->name);
+        st.packed_cells.insert(ci->name);
         // new MUX cell
-        new_cells.push_back(std::move(packed));
+        st.new_cells.push_back(std::move(packed));
     } else {
         // find the muxed LUTs
         NetInfo *i0 = ci->ports.at(id_I0).net;
@@ -326,17 +335,15 @@ static void pack_mux2_lut5(Context *ctx, CellInfo *ci, pool<IdString> &packed_ce
         replace_port(ci, id_I1, packed.get(), id_I1);
 
         // remove cells
-        packed_cells.insert(ci->name);
+        st.packed_cells.insert(ci->name);
         // new MUX cell
-        new_cells.push_back(std::move(packed));
+        st.new_cells.push_back(std::move(packed));
     }
 }
 
 // Common MUX2 packing routine
 static void pack_mux2_lut(Context *ctx, CellInfo *ci, bool (*pred)(const BaseCtx *, const CellInfo *),
-                          char const type_suffix, IdString const type_id, int const x[2], int const z[2],
-                          pool<IdString> &packed_cells, pool<IdString> &delete_nets,
-                          std::vector<std::unique_ptr<CellInfo>> &new_cells)
+                          char const type_suffix, IdString const type_id, int const x[2], int const z[2], PackState &st)
 {
     // find the muxed LUTs
     NetInfo *i0 = ci->ports.at(id_I0).net;
@@ -400,189 +407,144 @@ static void pack_mux2_lut(Context *ctx, CellInfo *ci, bool (*pred)(const BaseCtx
     replace_port(ci, id_I1, packed.get(), id_I1);
 
     // remove cells
-    packed_cells.insert(ci->name);
+    st.packed_cells.insert(ci->name);
     // new MUX cell
-    new_cells.push_back(std::move(packed));
+    st.new_cells.push_back(std::move(packed));
 }
 
 // pack MUX2_LUT6
-static void pack_mux2_lut6(Context *ctx, CellInfo *ci, pool<IdString> &packed_cells, pool<IdString> &delete_nets,
-                           std::vector<std::unique_ptr<CellInfo>> &new_cells)
+static void pack_mux2_lut6(Context *ctx, CellInfo *ci, PackState &st)
 {
     static int x[] = {0, 0};
     static int z[] = {+1, -1};
-    pack_mux2_lut(ctx, ci, is_gw_mux2_lut5, '6', id_GW_MUX2_LUT6, x, z, packed_cells, delete_nets, new_cells);
+    pack_mux2_lut(ctx, ci, is_gw_mux2_lut5, '6', id_GW_MUX2_LUT6, x, z, st);
 }
 
 // pack MUX2_LUT7
-static void pack_mux2_lut7(Context *ctx, CellInfo *ci, pool<IdString> &packed_cells, pool<IdString> &delete_nets,
-                           std::vector<std::unique_ptr<CellInfo>> &new_cells)
+static void pack_mux2_lut7(Context *ctx, CellInfo *ci, PackState &st)
 {
     static int x[] = {0, 0};
     static int z[] = {+2, -2};
-    pack_mux2_lut(ctx, ci, is_gw_mux2_lut6, '7', id_GW_MUX2_LUT7, x, z, packed_cells, delete_nets, new_cells);
+    pack_mux2_lut(ctx, ci, is_gw_mux2_lut6, '7', id_GW_MUX2_LUT7, x, z, st);
 }
 
 // pack MUX2_LUT8
-static void pack_mux2_lut8(Context *ctx, CellInfo *ci, pool<IdString> &packed_cells, pool<IdString> &delete_nets,
-                           std::vector<std::unique_ptr<CellInfo>> &new_cells)
+static void pack_mux2_lut8(Context *ctx, CellInfo *ci, PackState &st)
 {
     static int x[] = {1, 0};
     static int z[] = {-4, -4};
-    pack_mux2_lut(ctx, ci, is_gw_mux2_lut7, '8', id_GW_MUX2_LUT8, x, z, packed_cells, delete_nets, new_cells);
+    pack_mux2_lut(ctx, ci, is_gw_mux2_lut7, '8', id_GW_MUX2_LUT8, x, z, st);
 }
 
 // Pack wide LUTs
-static void pack_wideluts(Context *ctx)
+static void pack_wideluts(Context *ctx, PackState &st)
 {
     log_info("Packing wide LUTs..\n");
 
-    pool<IdString> packed_cells;
-    pool<IdString> delete_nets;
-    std::vector<std::unique_ptr<CellInfo>> new_cells;
-
-    pool<IdString> mux2lut6;
-    pool<IdString> mux2lut7;
-    pool<IdString> mux2lut8;
+    std::vector<CellInfo *> mux2lut6, mux2lut7, mux2lut8;
 
     // do MUX2_LUT5 and collect LUT6/7/8
     log_info("Packing LUT5s..\n");
-    for (auto &cell : ctx->cells) {
-        CellInfo *ci = cell.second.get();
+    for (auto ci : st.wideluts) {
         if (ctx->verbose) {
             log_info("cell '%s' is of type '%s'\n", ctx->nameOf(ci), ci->type.c_str(ctx));
         }
-        if (is_widelut(ctx, ci)) {
-            if (is_mux2_lut5(ctx, ci)) {
-                pack_mux2_lut5(ctx, ci, packed_cells, delete_nets, new_cells);
-            } else {
-                if (is_mux2_lut6(ctx, ci)) {
-                    mux2lut6.insert(ci->name);
-                } else {
-                    if (is_mux2_lut7(ctx, ci)) {
-                        mux2lut7.insert(ci->name);
-                    } else {
-                        if (is_mux2_lut8(ctx, ci)) {
-                            mux2lut8.insert(ci->name);
-                        }
-                    }
-                }
-            }
+        if (is_mux2_lut5(ctx, ci)) {
+            pack_mux2_lut5(ctx, ci, st);
+        } else if (is_mux2_lut6(ctx, ci)) {
+            mux2lut6.push_back(ci);
+        } else if (is_mux2_lut7(ctx, ci)) {
+            mux2lut7.push_back(ci);
+        } else if (is_mux2_lut8(ctx, ci)) {
+            mux2lut8.push_back(ci);
         }
     }
     // do MUX_LUT6
     log_info("Packing LUT6s..\n");
-    for (auto &cell_name : mux2lut6) {
-        pack_mux2_lut6(ctx, ctx->cells[cell_name].get(), packed_cells, delete_nets, new_cells);
+    for (auto ci : mux2lut6) {
+        pack_mux2_lut6(ctx, ci, st);
     }
 
     // do MUX_LUT7
     log_info("Packing LUT7s..\n");
-    for (auto &cell_name : mux2lut7) {
-        pack_mux2_lut7(ctx, ctx->cells[cell_name].get(), packed_cells, delete_nets, new_cells);
+    for (auto ci : mux2lut7) {
+        pack_mux2_lut7(ctx, ci, st);
     }
 
     // do MUX_LUT8
     log_info("Packing LUT8s..\n");
-    for (auto &cell_name : mux2lut8) {
-        pack_mux2_lut8(ctx, ctx->cells[cell_name].get(), packed_cells, delete_nets, new_cells);
+    for (auto ci : mux2lut8) {
+        pack_mux2_lut8(ctx, ci, st);
     }
 
-    // actual delete, erase and move cells/nets
-    for (auto pcell : packed_cells) {
-        ctx->cells.erase(pcell);
-    }
-    for (auto dnet : delete_nets) {
-        ctx->nets.erase(dnet);
-    }
-    for (auto &ncell : new_cells) {
-        ctx->cells[ncell->name] = std::move(ncell);
-    }
+    st.flush_new_cells(ctx);
 }
 
 // Pack LUTs and LUT-FF pairs
-static void pack_lut_lutffs(Context *ctx)
+static void pack_lut_lutffs(Context *ctx, PackState &st)
 {
     log_info("Packing LUT-FFs..\n");
 
-    pool<IdString> packed_cells;
-    std::vector<std::unique_ptr<CellInfo>> new_cells;
-    for (auto &cell : ctx->cells) {
-        CellInfo *ci = cell.second.get();
+    for (auto ci : st.luts) {
         if (ctx->verbose)
             log_info("cell '%s' is of type '%s'\n", ctx->nameOf(ci), ci->type.c_str(ctx));
-        if (is_lut(ctx, ci)) {
-            std::unique_ptr<CellInfo> packed = create_generic_cell(ctx, ctx->id("SLICE"), ci->name.str(ctx) + "_LC");
-            for (auto &attr : ci->attrs)
-                packed->attrs[attr.first] = attr.second;
-            packed_cells.insert(ci->name);
+        std::unique_ptr<CellInfo> packed = create_generic_cell(ctx, ctx->id("SLICE"), ci->name.str(ctx) + "_LC");
+        for (auto &attr : ci->attrs)
+            packed->attrs[attr.first] = attr.second;
+        st.packed_cells.insert(ci->name);
+        if (ctx->verbose)
+            log_info("packed cell %s into %s\n", ctx->nameOf(ci), ctx->nameOf(packed.get()));
+        // See if we can pack into a DFF
+        // TODO: LUT cascade
+        NetInfo *o = ci->ports.at(ctx->id("F")).net;
+        CellInfo *dff = net_only_drives(ctx, o, is_ff, ctx->id("D"), true);
+        auto lut_bel = ci->attrs.find(ctx->id("BEL"));
+        bool packed_dff = false;
+        if (dff) {
             if (ctx->verbose)
-                log_info("packed cell %s into %s\n", ctx->nameOf(ci), ctx->nameOf(packed.get()));
-            // See if we can pack into a DFF
-            // TODO: LUT cascade
-            NetInfo *o = ci->ports.at(ctx->id("F")).net;
-            CellInfo *dff = net_only_drives(ctx, o, is_ff, ctx->id("D"), true);
-            auto lut_bel = ci->attrs.find(ctx->id("BEL"));
-            bool packed_dff = false;
-            if (dff) {
+                log_info("found attached dff %s\n", ctx->nameOf(dff));
+            auto dff_bel = dff->attrs.find(ctx->id("BEL"));
+            if (lut_bel != ci->attrs.end() && dff_bel != dff->attrs.end() && lut_bel->second != dff_bel->second) {
+                // Locations don't match, can't pack
+            } else {
+                lut_to_lc(ctx, ci, packed.get(), false);
+                dff_to_lc(ctx, dff, packed.get(), false);
+                ctx->nets.erase(o->name);
+                if (dff_bel != dff->attrs.end())
+                    packed->attrs[ctx->id("BEL")] = dff_bel->second;
+                st.packed_cells.insert(dff->name);
                 if (ctx->verbose)
-                    log_info("found attached dff %s\n", ctx->nameOf(dff));
-                auto dff_bel = dff->attrs.find(ctx->id("BEL"));
-                if (lut_bel != ci->attrs.end() && dff_bel != dff->attrs.end() && lut_bel->second != dff_bel->second) {
-                    // Locations don't match, can't pack
-                } else {
-                    lut_to_lc(ctx, ci, packed.get(), false);
-                    dff_to_lc(ctx, dff, packed.get(), false);
-                    ctx->nets.erase(o->name);
-                    if (dff_bel != dff->attrs.end())
-                        packed->attrs[ctx->id("BEL")] = dff_bel->second;
-                    packed_cells.insert(dff->name);
-                    if (ctx->verbose)
-                        log_info("packed cell %s into %s\n", ctx->nameOf(dff), ctx->nameOf(packed.get()));
-                    packed_dff = true;
-                }
+                    log_info("packed cell %s into %s\n", ctx->nameOf(dff), ctx->nameOf(packed.get()));
+                packed_dff = true;
             }
-            if (!packed_dff) {
-                lut_to_lc(ctx, ci, packed.get(), true);
-            }
-            new_cells.push_back(std::move(packed));
         }
+        if (!packed_dff) {
+            lut_to_lc(ctx, ci, packed.get(), true);
+        }
+        st.new_cells.push_back(std::move(packed));
     }
-    for (auto pcell : packed_cells) {
-        ctx->cells.erase(pcell);
-    }
-    for (auto &ncell : new_cells) {
-        ctx->cells[ncell->name] = std::move(ncell);
-    }
+    st.flush_new_cells(ctx);
 }
 
 // Pack FFs not packed as LUTFFs
-static void pack_nonlut_ffs(Context *ctx)
+static void pack_nonlut_ffs(Context *ctx, PackState &st)
 {
     log_info("Packing non-LUT FFs..\n");
 
-    pool<IdString> packed_cells;
-    std::vector<std::unique_ptr<CellInfo>> new_cells;
-
-    for (auto &cell : ctx->cells) {
-        CellInfo *ci = cell.second.get();
-        if (is_ff(ctx, ci)) {
-            std::unique_ptr<CellInfo> packed = create_generic_cell(ctx, ctx->id("SLICE"), ci->name.str(ctx) + "_DFFLC");
-            for (auto &attr : ci->attrs)
-                packed->attrs[attr.first] = attr.second;
-            if (ctx->verbose)
-                log_info("packed cell %s into %s\n", ctx->nameOf(ci), ctx->nameOf(packed.get()));
-            packed_cells.insert(ci->name);
-            dff_to_lc(ctx, ci, packed.get(), true);
-            new_cells.push_back(std::move(packed));
-        }
-    }
-    for (auto pcell : packed_cells) {
-        ctx->cells.erase(pcell);
-    }
-    for (auto &ncell : new_cells) {
-        ctx->cells[ncell->name] = std::move(ncell);
+    for (auto ci : st.ffs) {
+        // skip FFs the LUT-FF stage already absorbed
+        if (st.consumed(ci))
+            continue;
+        std::unique_ptr<CellInfo> packed = create_generic_cell(ctx, ctx->id("SLICE"), ci->name.str(ctx) + "_DFFLC");
+        for (auto &attr : ci->attrs)
+            packed->attrs[attr.first] = attr.second;
+        if (ctx->verbose)
+            log_info("packed cell %s into %s\n", ctx->nameOf(ci), ctx->nameOf(packed.get()));
+        st.packed_cells.insert(ci->name);
+        dff_to_lc(ctx, ci, packed.get(), true);
+        st.new_cells.push_back(std::move(packed));
     }
+    st.flush_new_cells(ctx);
 }
 
 // Merge a net into a constant net
@@ -681,74 +643,59 @@ static bool is_gowin_iob(const Context *ctx, const CellInfo *cell)
 }
 
 // Pack IO buffers
-static void pack_io(Context *ctx)
+static void pack_io(Context *ctx, PackState &st)
 {
-    pool<IdString> packed_cells;
-    pool<IdString> delete_nets;
-
-    std::vector<std::unique_ptr<CellInfo>> new_cells;
     log_info("Packing IOs..\n");
 
-    for (auto &cell : ctx->cells) {
-        CellInfo *ci = cell.second.get();
-        if (is_gowin_iob(ctx, ci)) {
-            CellInfo *iob = nullptr;
-            switch (ci->type.index) {
-            case ID_IBUF:
-                iob = net_driven_by(ctx, ci->ports.at(id_I).net, is_nextpnr_iob, id_O);
-                break;
-            case ID_OBUF:
-                iob = net_only_drives(ctx, ci->ports.at(id_O).net, is_nextpnr_iob, id_I);
-                break;
-            case ID_IOBUF:
-                iob = net_driven_by(ctx, ci->ports.at(id_IO).net, is_nextpnr_iob, id_O);
-                break;
-            case ID_TBUF:
-                iob = net_only_drives(ctx, ci->ports.at(id_O).net, is_nextpnr_iob, id_I);
-                break;
-            default:
-                break;
-            }
-            if (iob != nullptr) {
-                // delete the $nexpnr_[io]buf
-                for (auto &p : iob->ports) {
-                    IdString netname = p.second.net->name;
-                    disconnect_port(ctx, iob, p.first);
-                    delete_nets.insert(netname);
-                }
-                packed_cells.insert(iob->name);
+    for (auto ci : st.iobs) {
+        CellInfo *iob = nullptr;
+        switch (ci->type.index) {
+        case ID_IBUF:
+            iob = net_driven_by(ctx, ci->ports.at(id_I).net, is_nextpnr_iob, id_O);
+            break;
+        case ID_OBUF:
+            iob = net_only_drives(ctx, ci->ports.at(id_O).net, is_nextpnr_iob, id_I);
+            break;
+        case ID_IOBUF:
+            iob = net_driven_by(ctx, ci->ports.at(id_IO).net, is_nextpnr_iob, id_O);
+            break;
+        case ID_TBUF:
+            iob = net_only_drives(ctx, ci->ports.at(id_O).net, is_nextpnr_iob, id_I);
+            break;
+        default:
+            break;
+        }
+        if (iob != nullptr) {
+            // delete the $nexpnr_[io]buf
+            for (auto &p : iob->ports) {
+                IdString netname = p.second.net->name;
+                disconnect_port(ctx, iob, p.first);
+                st.delete_nets.insert(netname);
             }
-            // Create a IOB buffer
-            std::unique_ptr<CellInfo> ice_cell = create_generic_cell(ctx, id_IOB, ci->name.str(ctx) + "$iob");
-            gwio_to_iob(ctx, ci, ice_cell.get(), packed_cells);
-            new_cells.push_back(std::move(ice_cell));
-            auto gwiob = new_cells.back().get();
-
-            packed_cells.insert(ci->name);
-            if (iob != nullptr) {
-                // in Gowin .CST port attributes take precedence over cell attributes.
-                // first copy cell attrs related to IO
-                for (auto &attr : ci->attrs) {
-                    if (attr.first == IdString(ID_BEL) || attr.first.str(ctx)[0] == '&') {
-                        gwiob->setAttr(attr.first, attr.second);
-                    }
-                }
-                // rewrite attributes from the port
-                for (auto &attr : iob->attrs) {
+            st.packed_cells.insert(iob->name);
+        }
+        // Create a IOB buffer
+        std::unique_ptr<CellInfo> ice_cell = create_generic_cell(ctx, id_IOB, ci->name.str(ctx) + "$iob");
+        gwio_to_iob(ctx, ci, ice_cell.get(), st.packed_cells);
+        st.new_cells.push_back(std::move(ice_cell));
+        auto gwiob = st.new_cells.back().get();
+
+        st.packed_cells.insert(ci->name);
+        if (iob != nullptr) {
+            // in Gowin .CST port attributes take precedence over cell attributes.
+            // first copy cell attrs related to IO
+            for (auto &attr : ci->attrs) {
+                if (attr.first == IdString(ID_BEL) || attr.first.str(ctx)[0] == '&') {
                     gwiob->setAttr(attr.first, attr.second);
                 }
             }
+            // rewrite attributes from the port
+            for (auto &attr : iob->attrs) {
+                gwiob->setAttr(attr.first, attr.second);
+            }
         }
     }
-    for (auto pcell : packed_cells) {
-        ctx->cells.erase(pcell);
-    }
-    for (auto dnet : delete_nets) {
-        ctx->nets.erase(dnet);
-    }
-    for (auto &ncell : new_cells) {
-        ctx->cells[ncell->name] = std::move(ncell);
-    }
+    st.flush_new_cells(ctx);
 }
 
 // Main pack function
@@ -758,11 +705,34 @@ bool Arch::pack()
     try {
         log_break();
         pack_constants(ctx);
-        pack_io(ctx);
-        pack_wideluts(ctx);
-        pack_alus(ctx);
-        pack_lut_lutffs(ctx);
-        pack_nonlut_ffs(ctx);
+        // One classification pass feeds all the remaining stages; stage
+        // order is unchanged, only the per-stage netlist re-scans are gone
+        PackState st;
+        for (auto &cell : ctx->cells) {
+            CellInfo *ci = cell.second.get();
+            if (is_gowin_iob(ctx, ci))
+                st.iobs.push_back(ci);
+            else if (is_widelut(ctx, ci))
+                st.wideluts.push_back(ci);
+            else if (is_alu(ctx, ci))
+                st.alus.push_back(ci);
+            else if (is_lut(ctx, ci))
+                st.luts.push_back(ci);
+            else if (is_ff(ctx, ci))
+                st.ffs.push_back(ci);
+        }
+        pack_io(ctx, st);
+        pack_wideluts(ctx, st);
+        pack_alus(ctx, st);
+        pack_lut_lutffs(ctx, st);
+        pack_nonlut_ffs(ctx, st);
+        // consumed cells stayed in the netlist so bucket pointers remained
+        // valid across stages; drop them (and the nets IO packing emptied)
+        // in one sweep now that no stage will look at them again
+        for (auto pcell : st.packed_cells)
+            ctx->cells.erase(pcell);
+        for (auto dnet : st.delete_nets)
+            ctx->nets.erase(dnet);
         ctx->settings[ctx->id("pack")] = 1;
         ctx->assignArchInfo();
         log_info("Checksum: 0x%08x\n", ctx->checksum());
@@ -82,6 +82,7 @@ FPGAViewWidget::~FPGAViewWidget() {}
 void FPGAViewWidget::newContext(Context *ctx)
 {
     ctx_ = ctx;
+    decalCache_.valid = false;
     {
         QMutexLocker lock(&rendererArgsLock_);
 
@@ -372,6 +373,9 @@ void FPGAViewWidget::enableDisableDecals(bool bels, bool wires, bool pips, bool
     displayWire_ = wires;
     displayPip_ = pips;
     displayGroup_ = groups;
+    // The cached decal copy only covers the displayed element classes, so
+    // changing the set of classes requires a rebuild from scratch
+    decalCache_.valid = false;
 }
 
 void FPGAViewWidget::renderLines(void)
@@ -380,10 +384,6 @@ void FPGAViewWidget::renderLines(void)
         return;
 
     // Data from Context needed to render all decals.
-    std::vector<std::pair<DecalXY, BelId>> belDecals;
-    std::vector<std::pair<DecalXY, WireId>> wireDecals;
-    std::vector<std::pair<DecalXY, PipId>> pipDecals;
-    std::vector<std::pair<DecalXY, GroupId>> groupDecals;
     bool decalsChanged = false;
     {
         // Take the UI/Normal mutex on the Context, copy over all we need as
@@ -391,55 +391,88 @@ void FPGAViewWidget::renderLines(void)
         std::lock_guard<std::mutex> lock_ui(ctx_->ui_mutex);
         std::lock_guard<std::mutex> lock(ctx_->mutex);
 
-        // For now, collapse any decal changes into change of all decals.
-        // TODO(q3k): fix this
-        if (ctx_->allUiReload) {
-            ctx_->allUiReload = false;
-            decalsChanged = true;
-        }
-        if (ctx_->frameUiReload) {
-            ctx_->frameUiReload = false;
-            decalsChanged = true;
-        }
-        if (ctx_->belUiReload.size() > 0) {
+        // A full reload (or a decal cache that isn't populated yet) rebuilds
+        // the local decal copy from scratch; otherwise only the elements
+        // named in the per-element reload sets are re-queried, so a placer
+        // that (un)binds a handful of bels between frames no longer pays for
+        // a whole-design walk under the Context mutex.
+        bool fullReload = ctx_->allUiReload || ctx_->frameUiReload || !decalCache_.valid;
+        ctx_->allUiReload = false;
+        ctx_->frameUiReload = false;
+
+        if (fullReload) {
             ctx_->belUiReload.clear();
-            decalsChanged = true;
-        }
-        if (ctx_->wireUiReload.size() > 0) {
             ctx_->wireUiReload.clear();
-            decalsChanged = true;
-        }
-        if (ctx_->pipUiReload.size() > 0) {
             ctx_->pipUiReload.clear();
-            decalsChanged = true;
-        }
-        if (ctx_->groupUiReload.size() > 0) {
             ctx_->groupUiReload.clear();
             decalsChanged = true;
-        }
 
-        // Local copy of decals, taken as fast as possible to not block the P&R.
-        if (decalsChanged) {
+            decalCache_.bels.clear();
+            decalCache_.belIndex.clear();
+            decalCache_.wires.clear();
+            decalCache_.wireIndex.clear();
+            decalCache_.pips.clear();
+            decalCache_.pipIndex.clear();
+            decalCache_.groups.clear();
+            decalCache_.groupIndex.clear();
             if (displayBel_) {
                 for (auto bel : ctx_->getBels()) {
-                    belDecals.push_back({ctx_->getBelDecal(bel), bel});
+                    decalCache_.belIndex[bel] = decalCache_.bels.size();
+                    decalCache_.bels.push_back({ctx_->getBelDecal(bel), bel});
                 }
             }
             if (displayWire_) {
                 for (auto wire : ctx_->getWires()) {
-                    wireDecals.push_back({ctx_->getWireDecal(wire), wire});
+                    decalCache_.wireIndex[wire] = decalCache_.wires.size();
+                    decalCache_.wires.push_back({ctx_->getWireDecal(wire), wire});
                 }
             }
             if (displayPip_) {
                 for (auto pip : ctx_->getPips()) {
-                    pipDecals.push_back({ctx_->getPipDecal(pip), pip});
+                    decalCache_.pipIndex[pip] = decalCache_.pips.size();
+                    decalCache_.pips.push_back({ctx_->getPipDecal(pip), pip});
                 }
             }
             if (displayGroup_) {
                 for (auto group : ctx_->getGroups()) {
-                    groupDecals.push_back({ctx_->getGroupDecal(group), group});
+                    decalCache_.groupIndex[group] = decalCache_.groups.size();
+                    decalCache_.groups.push_back({ctx_->getGroupDecal(group), group});
                 }
             }
+            decalCache_.valid = true;
+        } else {
+            for (auto bel : ctx_->belUiReload) {
+                auto it = decalCache_.belIndex.find(bel);
+                if (it != decalCache_.belIndex.end()) {
+                    decalCache_.bels.at(it->second).first = ctx_->getBelDecal(bel);
+                    decalsChanged = true;
+                }
+            }
+            ctx_->belUiReload.clear();
+            for (auto wire : ctx_->wireUiReload) {
+                auto it = decalCache_.wireIndex.find(wire);
+                if (it != decalCache_.wireIndex.end()) {
+                    decalCache_.wires.at(it->second).first = ctx_->getWireDecal(wire);
+                    decalsChanged = true;
+                }
+            }
+            ctx_->wireUiReload.clear();
+            for (auto pip : ctx_->pipUiReload) {
+                auto it = decalCache_.pipIndex.find(pip);
+                if (it != decalCache_.pipIndex.end()) {
+                    decalCache_.pips.at(it->second).first = ctx_->getPipDecal(pip);
+                    decalsChanged = true;
+                }
+            }
+            ctx_->pipUiReload.clear();
+            for (auto group : ctx_->groupUiReload) {
+                auto it = decalCache_.groupIndex.find(group);
+                if (it != decalCache_.groupIndex.end()) {
+                    decalCache_.groups.at(it->second).first = ctx_->getGroupDecal(group);
+                    decalsChanged = true;
+                }
+            }
+            ctx_->groupUiReload.clear();
         }
     }
 
@@ -480,25 +513,25 @@ void FPGAViewWidget::renderLines(void)
 
         // Draw Bels.
         if (displayBel_) {
-            for (auto const &decal : belDecals) {
+            for (auto const &decal : decalCache_.bels) {
                 renderArchDecal(data->gfxByStyle, data->bbGlobal, decal.first);
             }
         }
         // Draw Wires.
         if (displayWire_) {
-            for (auto const &decal : wireDecals) {
+            for (auto const &decal : decalCache_.wires) {
                 renderArchDecal(data->gfxByStyle, data->bbGlobal, decal.first);
             }
         }
         // Draw Pips.
         if (displayPip_) {
-            for (auto const &decal : pipDecals) {
+            for (auto const &decal : decalCache_.pips) {
                 renderArchDecal(data->gfxByStyle, data->bbGlobal, decal.first);
             }
         }
         // Draw Groups.
         if (displayGroup_) {
-            for (auto const &decal : groupDecals) {
+            for (auto const &decal : decalCache_.groups) {
                 renderArchDecal(data->gfxByStyle, data->bbGlobal, decal.first);
             }
         }
@@ -518,19 +551,19 @@ void FPGAViewWidget::renderLines(void)
 
         // Populate picking quadtree.
         data->qt = std::unique_ptr<PickQuadTree>(new PickQuadTree(bb));
-        for (auto const &decal : belDecals) {
+        for (auto const &decal : decalCache_.bels) {
             populateQuadTree(data.get(), decal.first,
                              PickedElement::fromBel(decal.second, decal.first.x, decal.first.y));
         }
-        for (auto const &decal : wireDecals) {
+        for (auto const &decal : decalCache_.wires) {
             populateQuadTree(data.get(), decal.first,
                              PickedElement::fromWire(decal.second, decal.first.x, decal.first.y));
         }
-        for (auto const &decal : pipDecals) {
+        for (auto const &decal : decalCache_.pips) {
             populateQuadTree(data.get(), decal.first,
                              PickedElement::fromPip(decal.second, decal.first.x, decal.first.y));
         }
-        for (auto const &decal : groupDecals) {
+        for (auto const &decal : decalCache_.groups) {
             populateQuadTree(data.get(), decal.first,
                              PickedElement::fromGroup(decal.second, decal.first.x, decal.first.y));
         }
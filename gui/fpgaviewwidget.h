@@ -296,6 +296,25 @@ class FPGAViewWidget : public QOpenGLWidget, protected QOpenGLFunctions
     std::unique_ptr<RendererData> rendererData_;
     QMutex rendererDataLock_;
 
+    // Persistent copy of every displayed element's decal, patched in place
+    // from the per-element UI reload sets. A handful of bind/unbind events
+    // between frames then only costs a handful of decal queries under the
+    // Context mutex instead of a whole-design walk that stalls the P&R
+    // worker. Only touched from the renderer thread.
+    struct DecalCache
+    {
+        std::vector<std::pair<DecalXY, BelId>> bels;
+        std::vector<std::pair<DecalXY, WireId>> wires;
+        std::vector<std::pair<DecalXY, PipId>> pips;
+        std::vector<std::pair<DecalXY, GroupId>> groups;
+        dict<BelId, size_t> belIndex;
+        dict<WireId, size_t> wireIndex;
+        dict<PipId, size_t> pipIndex;
+        dict<GroupId, size_t> groupIndex;
+        bool valid = false;
+    };
+    DecalCache decalCache_;
+
     void clampZoom();
     void zoomToBB(const PickQuadTree::BoundingBox &bb, float margin, bool clamp);
     void zoom(int level);
@@ -53,85 +53,100 @@ std::vector<QString> IdList::alphaNumSplit(const QString &str)
     return res;
 }
 
-void IdList::updateElements(Context *ctx, std::vector<IdStringList> elements)
+SortKey SortKey::forName(const QString &name)
+{
+    SortKey key;
+    for (const auto &part : IdList::alphaNumSplit(name)) {
+        Part p;
+        p.number = part.toInt(&p.is_number);
+        p.text = part;
+        key.parts.push_back(p);
+    }
+    return key;
+}
+
+bool SortKey::operator<(const SortKey &other) const
+{
+    for (size_t i = 0; i < parts.size() && i < other.parts.size(); i++) {
+        auto &part_a = parts.at(i);
+        auto &part_b = other.parts.at(i);
+
+        // If both parts are numbers, compare numerically.
+        // If they're equal, continue to next part.
+        if (part_a.is_number && part_b.is_number) {
+            if (part_a.number != part_b.number) {
+                return part_a.number < part_b.number;
+            } else {
+                continue;
+            }
+        }
+
+        // For different alpha/nonalpha types, make numeric parts appear
+        // first.
+        if (part_a.is_number != part_b.is_number) {
+            return part_a.is_number;
+        }
+
+        // Both parts are text, compare lexically.
+        // If they're equal, continue to next part.
+        if (part_a.text == part_b.text) {
+            continue;
+        }
+        return part_a.text < part_b.text;
+    }
+
+    // One string is equal to or a subset of the other, compare length.
+    return parts.size() < other.parts.size();
+}
+
+bool IdList::updateNeeded(Context *ctx, const std::vector<IdStringList> &elements)
 {
-    bool changed = false;
+    if (elements.size() != managed_.size())
+        return true;
+    for (const auto &elem : elements)
+        if (!managed_.count(elem))
+            return true;
+    return false;
+}
 
-    // For any elements that are not yet in managed_, created them.
+void IdList::updateElements(Context *ctx, std::vector<IdStringList> elements)
+{
+    // For any elements that are not yet in managed_, create them; the item
+    // constructor appends them to children_, forming an unsorted suffix.
     pool<IdStringList> element_set;
+    int added = 0;
     for (auto elem : elements) {
         element_set.insert(elem);
         auto existing = managed_.find(elem);
         if (existing == managed_.end()) {
             auto item = new IdStringItem(ctx, elem, this, child_type_);
             managed_.emplace(elem, std::unique_ptr<IdStringItem>(item));
-            changed = true;
+            added++;
         }
     }
 
-    // For any elements that are in managed_ but not in new, delete them.
+    // For any elements that are in managed_ but not in new, delete them;
+    // the item destructor removes them from children_.
     auto it = managed_.begin();
     while (it != managed_.end()) {
         if (element_set.count(it->first) != 0) {
             ++it;
         } else {
             it = managed_.erase(it);
-            changed = true;
         }
     }
 
-    // Return early if there are no changes.
-    if (!changed)
-        return;
-
-    // Rebuild children list.
-    children_.clear();
-    for (auto &pair : managed_) {
-        if (element_set.count(pair.first) != 0) {
-            children_.push_back(pair.second.get());
-        }
-    }
-
-    // Sort new children
-    std::sort(children_.begin(), children_.end(), [&](const Item *a, const Item *b) {
-        auto parts_a = alphaNumSplit(a->name());
-        auto parts_b = alphaNumSplit(b->name());
-
-        for (size_t i = 0; i < parts_a.size() && i < parts_b.size(); i++) {
-            auto &part_a = parts_a.at(i);
-            auto &part_b = parts_b.at(i);
-
-            bool a_is_number, b_is_number;
-            int a_number = part_a.toInt(&a_is_number);
-            int b_number = part_b.toInt(&b_is_number);
-
-            // If both parts are numbers, compare numerically.
-            // If they're equal, continue to next part.
-            if (a_is_number && b_is_number) {
-                if (a_number != b_number) {
-                    return a_number < b_number;
-                } else {
-                    continue;
-                }
-            }
-
-            // For different alpha/nonalpha types, make numeric parts appear
-            // first.
-            if (a_is_number != b_is_number) {
-                return a_is_number;
-            }
-
-            // If both parts are numbers, compare lexically.
-            // If they're equal, continue to next part.
-            if (part_a == part_b) {
-                continue;
-            }
-            return part_a < part_b;
-        }
-
-        // One string is equal to or a subset of the other, compare length.
-        return parts_a.size() < parts_b.size();
-    });
+    // The surviving children are still in sorted order and the additions
+    // are a contiguous suffix; sorting just that suffix by the cached
+    // collation keys and merging it in applies the delta without
+    // re-sorting the (potentially huge) existing list.
+    auto key_less = [](const Item *a, const Item *b) {
+        return static_cast<const IdStringItem *>(a)->sortKey() < static_cast<const IdStringItem *>(b)->sortKey();
+    };
+
+    auto suffix = children_.begin() + (children_.size() - added);
+    std::sort(suffix, children_.end(), key_less);
+    std::inplace_merge(children_.begin(), suffix, children_.end(), key_less);
 }
 
 void IdList::search(QList<Item *> &results, QString text, int limit)
@@ -162,6 +177,11 @@ void Model::updateElements(std::vector<IdStringList> elements)
     if (!ctx_)
         return;
 
+    // Progress updates during long passes usually change nothing; skip the
+    // view reset (which drops scroll position and selection) in that case
+    if (!root_->updateNeeded(ctx_, elements))
+        return;
+
     beginResetModel();
     root_->updateElements(ctx_, elements);
     endResetModel();
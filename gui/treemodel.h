@@ -105,6 +105,9 @@ class Item
     virtual boost::optional<Item *> getById(IdStringList id) { return boost::none; }
     virtual void search(QList<Item *> &results, QString text, int limit) {}
     virtual void updateElements(Context *ctx, std::vector<IdStringList> elements) {}
+    // Whether updateElements with this element list would change anything;
+    // lets the model skip a full view reset for no-op progress updates
+    virtual bool updateNeeded(Context *ctx, const std::vector<IdStringList> &elements) { return true; }
 
     virtual ~Item()
     {
@@ -114,19 +117,41 @@ class Item
     }
 };
 
+// Pre-computed collation key for the "smart" alphanumeric ordering of list
+// children: the name split into runs of digits and non-digits, with the
+// numeric runs parsed up front. Comparing keys replaces re-splitting and
+// re-parsing both names on every comparison of a sort
+struct SortKey
+{
+    struct Part
+    {
+        bool is_number;
+        int number;
+        QString text;
+    };
+    std::vector<Part> parts;
+
+    static SortKey forName(const QString &name);
+
+    bool operator<(const SortKey &other) const;
+};
+
 // IdString is an Item that corresponds to a real element in Arch.
 class IdStringItem : public Item
 {
   private:
     IdStringList id_;
     ElementType type_;
+    SortKey sort_key_;
 
   public:
     IdStringItem(Context *ctx, IdStringList str, Item *parent, ElementType type)
-            : Item(QString(str.str(ctx).c_str()), parent), id_(str), type_(type)
+            : Item(QString(str.str(ctx).c_str()), parent), id_(str), type_(type), sort_key_(SortKey::forName(name()))
     {
     }
 
+    const SortKey &sortKey() const { return sort_key_; }
+
     virtual IdStringList id() const override { return id_; }
 
     virtual ElementType type() const override { return type_; }
@@ -156,9 +181,14 @@ class IdList : public Item
     // getById finds a child for the given IdString.
     virtual boost::optional<Item *> getById(IdStringList id) override { return managed_.at(id).get(); }
 
-    // (Re-)create children from a list of IdStrings.
+    // Apply the delta between the current children and a list of IdStrings:
+    // new names become fresh items merged into the sorted children, names
+    // that disappeared are dropped. Unchanged children keep their order, so
+    // no full re-sort happens.
     virtual void updateElements(Context *ctx, std::vector<IdStringList> elements) override;
 
+    virtual bool updateNeeded(Context *ctx, const std::vector<IdStringList> &elements) override;
+
     // Find children that contain the given text.
     virtual void search(QList<Item *> &results, QString text, int limit) override;
 };
@@ -123,6 +123,8 @@ Arch::Arch(ArchArgs args) : args(args)
 
     bel_carry.resize(chip_info->bel_data.size());
     bel_to_cell.resize(chip_info->bel_data.size());
+    logic_tile_version.resize(chip_info->width * chip_info->height, 0);
+    logic_tile_valid_cache.resize(chip_info->width * chip_info->height, std::make_pair(-1, false));
     wire_to_net.resize(chip_info->wire_data.size());
     pip_to_net.resize(chip_info->pip_data.size());
     switches_locked.resize(chip_info->num_switches);
@@ -700,6 +702,7 @@ bool Arch::place()
         tocfg.cellTypes.insert(id_ICESTORM_LC);
         retVal = timing_opt(getCtx(), tocfg);
     }
+    permute_luts();
     getCtx()->settings[getCtx()->id("place")] = 1;
     archInfoToAttributes();
     return retVal;
@@ -1211,6 +1214,8 @@ void Arch::assignArchInfo()
         CellInfo *ci = cell.second.get();
         assignCellInfo(ci);
     }
+    // Control set data feeding the legality check may have changed
+    std::fill(logic_tile_valid_cache.begin(), logic_tile_valid_cache.end(), std::make_pair(-1, false));
 }
 
 void Arch::assignCellInfo(CellInfo *cell)
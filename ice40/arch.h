@@ -337,9 +337,20 @@ struct AllPipRange
 
 struct PipIterator
 {
-    const int *cursor = nullptr;
+    const int *cursor = nullptr, *last = nullptr;
+    // Base of the pip record array, used to prefetch the next record while
+    // the caller is still looking at the current one; this hides the
+    // latency of pulling successive PipInfoPODs out of the chipdb blob
+    const PipInfoPOD *pip_data = nullptr;
 
-    void operator++() { cursor++; }
+    void operator++()
+    {
+        cursor++;
+#if defined(__GNUC__) || defined(__clang__)
+        if (cursor < last)
+            __builtin_prefetch(&pip_data[cursor[1]]);
+#endif
+    }
     bool operator!=(const PipIterator &other) const { return cursor != other.cursor; }
 
     PipId operator*() const
@@ -411,6 +422,21 @@ struct Arch : BaseArch<ArchRanges>
     std::vector<NetInfo *> pip_to_net;
     std::vector<WireId> switches_locked;
 
+    // Per-tile version counter, bumped whenever a logic bel in the tile is
+    // (un)bound, and a cached isBelLocationValid result tagged with the
+    // version it was computed at. Logic tile legality only depends on the
+    // cells bound within the tile, so while the version is unchanged a
+    // repeated validity check is a single integer compare instead of a full
+    // control-set scan over up to 8 LCs.
+    std::vector<int> logic_tile_version;
+    mutable std::vector<std::pair<int, bool>> logic_tile_valid_cache;
+
+    int logic_tile_index(BelId bel) const
+    {
+        auto &data = chip_info->bel_data[bel.index];
+        return data.y * chip_info->width + data.x;
+    }
+
     // fast access to  X and Y IdStrings for building object names
     std::vector<IdString> x_ids, y_ids;
     // inverse of the above for name->object mapping
@@ -455,7 +481,10 @@ struct Arch : BaseArch<ArchRanges>
         bel_to_cell[bel.index] = cell;
         bel_carry[bel.index] = (cell->type == id_ICESTORM_LC && cell->lcInfo.carryEnable);
         cell->bel = bel;
+        cell->loc = getBelLocation(bel);
         cell->belStrength = strength;
+        if (getBelType(bel) == id_ICESTORM_LC)
+            logic_tile_version[logic_tile_index(bel)]++;
         refreshUiBel(bel);
     }
 
@@ -467,6 +496,8 @@ struct Arch : BaseArch<ArchRanges>
         bel_to_cell[bel.index]->belStrength = STRENGTH_NONE;
         bel_to_cell[bel.index] = nullptr;
         bel_carry[bel.index] = false;
+        if (getBelType(bel) == id_ICESTORM_LC)
+            logic_tile_version[logic_tile_index(bel)]++;
         refreshUiBel(bel);
     }
 
@@ -547,6 +578,7 @@ struct Arch : BaseArch<ArchRanges>
         wire_to_net[wire.index] = net;
         net->wires[wire].pip = PipId();
         net->wires[wire].strength = strength;
+        ++net->route_version;
         refreshUiWire(wire);
     }
 
@@ -566,6 +598,7 @@ struct Arch : BaseArch<ArchRanges>
         }
 
         net_wires.erase(it);
+        ++wire_to_net[wire.index]->route_version;
         wire_to_net[wire.index] = nullptr;
         refreshUiWire(wire);
     }
@@ -628,10 +661,37 @@ struct Arch : BaseArch<ArchRanges>
         wire_to_net[dst.index] = net;
         net->wires[dst].pip = pip;
         net->wires[dst].strength = strength;
+        ++net->route_version;
         refreshUiPip(pip);
         refreshUiWire(dst);
     }
 
+    void bindPips(const std::vector<PipId> &pips, NetInfo *net, PlaceStrength strength) override
+    {
+        // All the per-pip bookkeeping here is plain array stores, so commit
+        // the whole arc in one call rather than a virtual call per pip
+        net->wires.reserve(net->wires.size() + pips.size());
+        for (auto pip : pips) {
+            NPNR_ASSERT(pip != PipId());
+            NPNR_ASSERT(pip_to_net[pip.index] == nullptr);
+            NPNR_ASSERT(switches_locked[chip_info->pip_data[pip.index].switch_index] == WireId());
+
+            WireId dst;
+            dst.index = chip_info->pip_data[pip.index].dst;
+            NPNR_ASSERT(wire_to_net[dst.index] == nullptr);
+
+            pip_to_net[pip.index] = net;
+            switches_locked[chip_info->pip_data[pip.index].switch_index] = dst;
+
+            wire_to_net[dst.index] = net;
+            net->wires[dst].pip = pip;
+            net->wires[dst].strength = strength;
+            refreshUiPip(pip);
+            refreshUiWire(dst);
+        }
+        ++net->route_version;
+    }
+
     void unbindPip(PipId pip) override
     {
         NPNR_ASSERT(pip != PipId());
@@ -643,6 +703,7 @@ struct Arch : BaseArch<ArchRanges>
         NPNR_ASSERT(wire_to_net[dst.index] != nullptr);
         wire_to_net[dst.index] = nullptr;
         pip_to_net[pip.index]->wires.erase(dst);
+        ++pip_to_net[pip.index]->route_version;
 
         pip_to_net[pip.index] = nullptr;
         switches_locked[chip_info->pip_data[pip.index].switch_index] = WireId();
@@ -756,15 +817,47 @@ struct Arch : BaseArch<ArchRanges>
         NPNR_ASSERT(wire != WireId());
         range.b.cursor = chip_info->wire_data[wire.index].pips_downhill.get();
         range.e.cursor = range.b.cursor + chip_info->wire_data[wire.index].pips_downhill.size();
+        range.b.last = range.e.cursor - 1;
+        range.b.pip_data = chip_info->pip_data.get();
+#if defined(__GNUC__) || defined(__clang__)
+        if (range.b.cursor != range.e.cursor)
+            __builtin_prefetch(&range.b.pip_data[range.b.cursor[0]]);
+#endif
         return range;
     }
 
+    void getPipsDownhillInfo(WireId wire, std::vector<PipDownhillInfo> &out) const override
+    {
+        NPNR_ASSERT(wire != WireId());
+        out.clear();
+        const auto &pips = chip_info->wire_data[wire.index].pips_downhill;
+        out.reserve(pips.size());
+        for (size_t i = 0; i < pips.size(); i++) {
+#if defined(__GNUC__) || defined(__clang__)
+            if (i + 1 < pips.size())
+                __builtin_prefetch(&chip_info->pip_data[pips[i + 1]]);
+#endif
+            int32_t pip_idx = pips[i];
+            const auto &pd = chip_info->pip_data[pip_idx];
+            PipDownhillInfo info;
+            info.pip.index = pip_idx;
+            info.dst.index = pd.dst;
+            info.delay = DelayQuad(fast_part ? pd.fast_delay : pd.slow_delay);
+            info.loc.x = pd.x;
+            info.loc.y = pd.y;
+            info.loc.z = 0;
+            out.push_back(info);
+        }
+    }
+
     PipRange getPipsUphill(WireId wire) const override
     {
         PipRange range;
         NPNR_ASSERT(wire != WireId());
         range.b.cursor = chip_info->wire_data[wire.index].pips_uphill.get();
         range.e.cursor = range.b.cursor + chip_info->wire_data[wire.index].pips_uphill.size();
+        range.b.last = range.e.cursor - 1;
+        range.b.pip_data = chip_info->pip_data.get();
         return range;
     }
 
@@ -800,6 +893,11 @@ struct Arch : BaseArch<ArchRanges>
     bool place() override;
     bool route() override;
 
+    // Reassign equivalent LUT inputs after placement so the most critical
+    // nets land on the fastest pins, rewriting LUT_INIT to match
+    void permute_luts();
+    void postPlaceFixup() override { permute_luts(); }
+
     // -------------------------------------------------
 
     std::vector<GraphicElement> getDecalGraphics(DecalId decal) const override;
@@ -832,6 +930,10 @@ struct Arch : BaseArch<ArchRanges>
     // Return true whether all Bels at a given location are valid
     bool isBelLocationValid(BelId bel) const override;
 
+    // Mutation-free probe for the logic-cell common case (implemented in
+    // arch_place.cc); other cell types fall back to the bind-and-revert base
+    bool isSwapLocationValid(CellInfo *cell, BelId newBel, CellInfo *other_cell, BelId oldBel) override;
+
     // Helper function for above
     bool logic_cells_compatible(const CellInfo **it, const size_t size) const;
 
@@ -20,7 +20,9 @@
  */
 
 #include "cells.h"
+#include "design_utils.h"
 #include "nextpnr.h"
+#include "timing.h"
 #include "util.h"
 
 #include <boost/range/iterator_range.hpp>
@@ -85,6 +87,15 @@ static inline bool _io_pintype_need_clk_en(unsigned pin_type)
 bool Arch::isBelLocationValid(BelId bel) const
 {
     if (getBelType(bel) == id_ICESTORM_LC) {
+        // Logic tile legality only depends on the cells bound in the tile,
+        // so the last result can be reused until the next (un)bind there -
+        // this makes the repeated checks a swap or chain move generates for
+        // the same tile a single integer compare
+        int tile = logic_tile_index(bel);
+        auto &cached = logic_tile_valid_cache[tile];
+        int version = logic_tile_version[tile];
+        if (cached.first == version)
+            return cached.second;
         std::array<const CellInfo *, 8> bel_cells;
         size_t num_cells = 0;
         Loc bel_loc = getBelLocation(bel);
@@ -93,7 +104,9 @@ bool Arch::isBelLocationValid(BelId bel) const
             if (ci_other != nullptr)
                 bel_cells[num_cells++] = ci_other;
         }
-        return logic_cells_compatible(bel_cells.data(), num_cells);
+        bool result = logic_cells_compatible(bel_cells.data(), num_cells);
+        cached = std::make_pair(version, result);
+        return result;
     } else {
         CellInfo *cell = getBoundBelCell(bel);
         if (cell == nullptr)
@@ -195,4 +208,123 @@ bool Arch::isBelLocationValid(BelId bel) const
     }
 }
 
+bool Arch::isSwapLocationValid(CellInfo *cell, BelId newBel, CellInfo *other_cell, BelId oldBel)
+{
+    if (cell->type == id_ICESTORM_LC && getBelType(newBel) == id_ICESTORM_LC &&
+        (other_cell == nullptr || other_cell->type == id_ICESTORM_LC)) {
+        // Logic tile legality depends only on the cells in the affected
+        // tiles, so the swap is checked against hypothetical tile contents
+        // without touching any bind state: rejected SA moves stay free
+        auto tile_compatible = [&](BelId check_bel) {
+            std::array<const CellInfo *, 8> bel_cells;
+            size_t num_cells = 0;
+            Loc loc = getBelLocation(check_bel);
+            for (auto bel : getBelsByTile(loc.x, loc.y)) {
+                const CellInfo *ci;
+                if (bel == newBel)
+                    ci = cell;
+                else if (bel == oldBel)
+                    ci = other_cell;
+                else
+                    ci = getBoundBelCell(bel);
+                if (ci != nullptr)
+                    bel_cells[num_cells++] = ci;
+            }
+            return logic_cells_compatible(bel_cells.data(), num_cells);
+        };
+        if (!tile_compatible(newBel))
+            return false;
+        if (logic_tile_index(oldBel) != logic_tile_index(newBel) && !tile_compatible(oldBel))
+            return false;
+        return true;
+    }
+    return BaseArch::isSwapLocationValid(cell, newBel, other_cell, oldBel);
+}
+
+void Arch::permute_luts()
+{
+    TimingAnalyser tmg(getCtx());
+    tmg.setup();
+
+    const std::array<IdString, 4> port_names{id_I0, id_I1, id_I2, id_I3};
+
+    // Rank the physical pins by their LUT propagation delay from the cell
+    // timing database, slowest first, so the least critical input can be
+    // assigned to the slowest pin. The ranking is per-device, not per-cell
+    std::array<std::pair<delay_t, int>, 4> pin_order;
+    bool have_delays = false;
+    for (auto &cell : cells) {
+        if (cell.second->type != id_ICESTORM_LC)
+            continue;
+        for (int i = 0; i < 4; i++) {
+            DelayQuad dlut;
+            delay_t max_delay = 0;
+            if (get_cell_delay_internal(cell.second.get(), port_names.at(i), id_O, dlut))
+                max_delay = dlut.maxDelay();
+            pin_order.at(i) = std::make_pair(max_delay, i);
+        }
+        have_delays = true;
+        break;
+    }
+    if (!have_delays)
+        return;
+    std::stable_sort(pin_order.begin(), pin_order.end(),
+                     [](const std::pair<delay_t, int> &a, const std::pair<delay_t, int> &b) { return a.first > b.first; });
+
+    auto proc_lut = [&](CellInfo *ci) {
+        std::vector<std::pair<float, int>> inputs;
+        std::vector<NetInfo *> orig_nets;
+
+        for (int i = 0; i < 4; i++) {
+            if (!ci->ports.count(port_names.at(i))) {
+                ci->ports[port_names.at(i)].name = port_names.at(i);
+                ci->ports[port_names.at(i)].type = PORT_IN;
+            }
+            auto &port = ci->ports.at(port_names.at(i));
+            float crit = (port.net == nullptr) ? 0 : tmg.get_criticality(CellPortKey(ci->name, port_names.at(i)));
+            orig_nets.push_back(port.net);
+            inputs.emplace_back(crit, i);
+        }
+        // Least critical first, paired with pins slowest first
+        std::sort(inputs.begin(), inputs.end());
+        std::array<int, 4> new_to_old;
+        for (int i = 0; i < 4; i++) {
+            int phys = pin_order.at(i).second;
+            new_to_old.at(phys) = inputs.at(i).second;
+            IdString p = port_names.at(phys);
+            disconnect_port(getCtx(), ci, p);
+            ci->ports.at(p).net = nullptr;
+            if (orig_nets.at(inputs.at(i).second) != nullptr)
+                connect_port(getCtx(), orig_nets.at(inputs.at(i).second), ci, p);
+        }
+        // Rewrite function
+        int old_init = int_or_default(ci->params, id("LUT_INIT"), 0);
+        int new_init = 0;
+        for (int i = 0; i < 16; i++) {
+            int old_index = 0;
+            for (int k = 0; k < 4; k++) {
+                if (i & (1 << k))
+                    old_index |= (1 << new_to_old.at(k));
+            }
+            if (old_init & (1 << old_index))
+                new_init |= (1 << i);
+        }
+        ci->params[id("LUT_INIT")] = Property(new_init, 16);
+    };
+
+    for (auto &cell : cells) {
+        CellInfo *ci = cell.second.get();
+        if (ci->type != id_ICESTORM_LC)
+            continue;
+        // Carry-mode cells use I1/I2 as adder operands and chained cells
+        // connect through I3/CIN, so only free-standing logic is permutable
+        if (ci->lcInfo.carryEnable || ci->cluster != ClusterId())
+            continue;
+        // Avoid permuting locked LUTs (e.g. from an OOC submodule)
+        if (ci->belStrength > STRENGTH_STRONG)
+            continue;
+        proc_lut(ci);
+    }
+}
+
 NEXTPNR_NAMESPACE_END
@@ -19,10 +19,13 @@
  *
  */
 #include "bitstream.h"
+#include <array>
 #include <cctype>
+#include <fstream>
 #include <vector>
 #include "cells.h"
 #include "log.h"
+#include "lut_mapping_cache.h"
 #include "util.h"
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -251,36 +254,26 @@ static BelPin get_one_bel_pin(const Context *ctx, WireId wire)
     return *pins.begin();
 }
 
-// Permute LUT init value given map (LUT input -> ext input)
-unsigned permute_lut(unsigned orig_init, const dict<int, int> &input_permute)
-{
-    unsigned new_init = 0;
-
-    for (int i = 0; i < 16; i++) {
-        int permute_address = 0;
-        for (int j = 0; j < 4; j++) {
-            if ((i >> j) & 0x1)
-                permute_address |= (1 << input_permute.at(j));
-        }
-        if ((orig_init >> i) & 0x1) {
-            new_init |= (1 << permute_address);
-        }
-    }
-
-    return new_init;
-}
-
-void write_asc(const Context *ctx, std::ostream &out)
+// Everything except the SB_IO/IoCtrl configuration and the text
+// serialization: pips, logic cells, hard IP, RAM power-up and the global
+// column buffers. This is the expensive part of ASC generation and is
+// identical across per-board IO variants of the same routed design
+static void build_base_config(const Context *ctx, chipconfig_t &config,
+                              std::vector<std::tuple<int, int, int>> &extra_bits, pool<Loc> &sb_io_used_by_pll_out,
+                              pool<Loc> &sb_io_used_by_pll_pad)
 {
 
     static const std::vector<int> lut_perm = {
             4, 14, 15, 5, 6, 16, 17, 7, 3, 13, 12, 2, 1, 11, 10, 0,
     };
 
+    // Memoizes init permutations; synthesized designs repeat a few distinct
+    // LUT functions and input orders across many cells
+    LutMappingCache lutperm_cache;
+
     // [y][x][row][col]
     const ChipInfoPOD &ci = *ctx->chip_info;
     const BitstreamInfoPOD &bi = *ci.bits_info;
-    chipconfig_t config;
     config.resize(ci.height);
     for (int y = 0; y < ci.height; y++) {
         config.at(y).resize(ci.width);
@@ -292,36 +285,6 @@ void write_asc(const Context *ctx, std::ostream &out)
         }
     }
 
-    std::vector<std::tuple<int, int, int>> extra_bits;
-
-    out << ".comment from next-pnr" << std::endl;
-
-    switch (ctx->args.type) {
-    case ArchArgs::LP384:
-        out << ".device 384" << std::endl;
-        break;
-    case ArchArgs::HX1K:
-    case ArchArgs::LP1K:
-        out << ".device 1k" << std::endl;
-        break;
-    case ArchArgs::HX4K:
-    case ArchArgs::LP4K:
-    case ArchArgs::HX8K:
-    case ArchArgs::LP8K:
-        out << ".device 8k" << std::endl;
-        break;
-    case ArchArgs::UP3K:
-    case ArchArgs::UP5K:
-        out << ".device 5k" << std::endl;
-        break;
-    case ArchArgs::U1K:
-    case ArchArgs::U2K:
-    case ArchArgs::U4K:
-        out << ".device u4k" << std::endl;
-        break;
-    default:
-        NPNR_ASSERT_FALSE("unsupported device type\n");
-    }
     // Set pips
     for (auto pip : ctx->getPips()) {
         if (ctx->pip_to_net[pip.index] != nullptr) {
@@ -387,9 +350,6 @@ void write_asc(const Context *ctx, std::ostream &out)
     }
 
     // Scan for PLL and collects the affected SB_IOs
-    pool<Loc> sb_io_used_by_pll_out;
-    pool<Loc> sb_io_used_by_pll_pad;
-
     for (auto &cell : ctx->cells) {
         if (cell.second->type != ctx->id("ICESTORM_PLL"))
             continue;
@@ -487,7 +447,11 @@ void write_asc(const Context *ctx, std::ostream &out)
                     unused.erase(input_perm[i]);
                 }
             }
-            lut_init = permute_lut(lut_init, input_perm);
+            // Permute the init value given the map (LUT input -> ext input)
+            std::array<uint8_t, 8> phys_to_log{};
+            for (int i = 0; i < 4; i++)
+                phys_to_log[input_perm.at(i)] = 1 << i;
+            lut_init = unsigned(lutperm_cache.permuted_init(4, lut_init, phys_to_log));
             for (int i = 0; i < 16; i++) {
                 if ((lut_init >> i) & 0x1)
                     lc.at(lut_perm.at(i)) = true;
@@ -510,95 +474,8 @@ void write_asc(const Context *ctx, std::ostream &out)
                 set_config(ti, config.at(y).at(x), "CarryInSet", carry_set);
             }
         } else if (cell.second->type == ctx->id("SB_IO")) {
-            const BelInfoPOD &beli = ci.bel_data[bel.index];
-            int x = beli.x, y = beli.y, z = beli.z;
-            const TileInfoPOD &ti = bi.tiles_nonrouting[TILE_IO];
-            unsigned pin_type = get_param_or_def(ctx, cell.second.get(), ctx->id("PIN_TYPE"));
-            bool neg_trigger = get_param_or_def(ctx, cell.second.get(), ctx->id("NEG_TRIGGER"));
-            bool pullup = get_param_or_def(ctx, cell.second.get(), ctx->id("PULLUP"));
-            bool lvds = cell.second->ioInfo.lvds;
-            bool used_by_pll_out = sb_io_used_by_pll_out.count(Loc(x, y, z)) > 0;
-            bool used_by_pll_pad = sb_io_used_by_pll_pad.count(Loc(x, y, z)) > 0;
-
-            for (int i = used_by_pll_out ? 2 : 0; i < 6; i++) {
-                bool val = (pin_type >> i) & 0x01;
-                set_config(ti, config.at(y).at(x), "IOB_" + std::to_string(z) + ".PINTYPE_" + std::to_string(i), val);
-            }
-            set_config(ti, config.at(y).at(x), "NegClk", neg_trigger);
-
-            bool input_en = false;
-            if ((ctx->wire_to_net[ctx->getBelPinWire(bel, id_D_IN_0).index] != nullptr) ||
-                (ctx->wire_to_net[ctx->getBelPinWire(bel, id_D_IN_1).index] != nullptr)) {
-                input_en = true;
-            }
-            input_en = (input_en & !used_by_pll_out) | used_by_pll_pad;
-            input_en |= cell.second->ioInfo.global;
-
-            if (!lvds) {
-                auto ieren = get_ieren(bi, x, y, z);
-                int iex, iey, iez;
-                std::tie(iex, iey, iez) = ieren;
-                NPNR_ASSERT(iez != -1);
-
-                if (ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K) {
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), !input_en);
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
-                } else {
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), input_en);
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
-                }
-
-                if (ctx->args.type == ArchArgs::UP5K || ctx->args.type == ArchArgs::UP3K) {
-                    std::string pullup_resistor = "100K";
-                    if (cell.second->attrs.count(ctx->id("PULLUP_RESISTOR")))
-                        pullup_resistor = cell.second->attrs.at(ctx->id("PULLUP_RESISTOR")).as_string();
-                    NPNR_ASSERT(pullup_resistor == "100K" || pullup_resistor == "10K" || pullup_resistor == "6P8K" ||
-                                pullup_resistor == "3P3K");
-                    if (iez == 0) {
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_39",
-                                   (!pullup) || (pullup_resistor != "100K"));
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_36", pullup && pullup_resistor == "3P3K");
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_37", pullup && pullup_resistor == "6P8K");
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_38", pullup && pullup_resistor == "10K");
-                    } else if (iez == 1) {
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_35",
-                                   (!pullup) || (pullup_resistor != "100K"));
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_32", pullup && pullup_resistor == "3P3K");
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_33", pullup && pullup_resistor == "6P8K");
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_34", pullup && pullup_resistor == "10K");
-                    }
-                }
-            } else {
-                NPNR_ASSERT(z == 0);
-                // Only enable the actual LVDS buffer if input is used for something
-                set_config(ti, config.at(y).at(x), "IoCtrl.LVDS", input_en);
-
-                // Set both IO config
-                for (int cz = 0; cz < 2; cz++) {
-                    auto ieren = get_ieren(bi, x, y, cz);
-                    int iex, iey, iez;
-                    std::tie(iex, iey, iez) = ieren;
-                    NPNR_ASSERT(iez != -1);
-
-                    pullup &= !input_en; /* If input is used, force disable pullups */
-
-                    if (ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K) {
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), true);
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
-                    } else {
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), false);
-                        set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
-                    }
-
-                    if (ctx->args.type == ArchArgs::UP5K || ctx->args.type == ArchArgs::UP3K) {
-                        if (iez == 0) {
-                            set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_39", !pullup);
-                        } else if (iez == 1) {
-                            set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_35", !pullup);
-                        }
-                    }
-                }
-            }
+            // Configured in apply_io_config, which batch mode re-runs per
+            // variant on top of the shared base
         } else if (cell.second->type == ctx->id("SB_GB")) {
             if (cell.second->gbInfo.forPadIn) {
                 Loc gb_loc = ctx->getBelLocation(bel);
@@ -748,36 +625,9 @@ void write_asc(const Context *ctx, std::ostream &out)
             NPNR_ASSERT(false);
         }
     }
-    // Set config bits in unused IO and RAM
+    // Set config bits in unused RAM (unused IO is handled in apply_io_config)
     for (auto bel : ctx->getBels()) {
-        if (ctx->bel_to_cell[bel.index] == nullptr && ctx->getBelType(bel) == id_SB_IO) {
-            const TileInfoPOD &ti = bi.tiles_nonrouting[TILE_IO];
-            const BelInfoPOD &beli = ci.bel_data[bel.index];
-            int x = beli.x, y = beli.y, z = beli.z;
-            if (sb_io_used_by_pll_out.count(Loc(x, y, z))) {
-                continue;
-            }
-
-            auto ieren = get_ieren(bi, x, y, z);
-            int iex, iey, iez;
-            std::tie(iex, iey, iez) = ieren;
-            if (iez != -1) {
-                // If IO is in LVDS pair, it will be configured by the other pair
-                if (z == 1) {
-                    BelId lvds0 = ctx->getBelByLocation(Loc{x, y, 0});
-                    const CellInfo *lvds0cell = ctx->getBoundBelCell(lvds0);
-                    if (lvds0cell != nullptr && lvds0cell->ioInfo.lvds)
-                        continue;
-                }
-                if (ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K) {
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), true);
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), false);
-                } else {
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), false);
-                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), false);
-                }
-            }
-        } else if (ctx->bel_to_cell[bel.index] == nullptr && ctx->getBelType(bel) == id_ICESTORM_RAM) {
+        if (ctx->bel_to_cell[bel.index] == nullptr && ctx->getBelType(bel) == id_ICESTORM_RAM) {
             const BelInfoPOD &beli = ci.bel_data[bel.index];
             int x = beli.x, y = beli.y;
             const TileInfoPOD &ti = bi.tiles_nonrouting[TILE_RAMB];
@@ -849,6 +699,176 @@ void write_asc(const Context *ctx, std::ostream &out)
             }
         }
     }
+}
+
+// SB_IO and IoCtrl configuration: the only part of the config that differs
+// between per-board IO variants of the same routed design, re-run on a copy
+// of the base config for each write_asc_batch variant
+static void apply_io_config(const Context *ctx, chipconfig_t &config, const pool<Loc> &sb_io_used_by_pll_out,
+                            const pool<Loc> &sb_io_used_by_pll_pad)
+{
+    const ChipInfoPOD &ci = *ctx->chip_info;
+    const BitstreamInfoPOD &bi = *ci.bits_info;
+    for (auto &cell : ctx->cells) {
+        BelId bel = cell.second->bel;
+        if (cell.second->type != ctx->id("SB_IO") || bel == BelId())
+            continue;
+        const BelInfoPOD &beli = ci.bel_data[bel.index];
+        int x = beli.x, y = beli.y, z = beli.z;
+        const TileInfoPOD &ti = bi.tiles_nonrouting[TILE_IO];
+        unsigned pin_type = get_param_or_def(ctx, cell.second.get(), ctx->id("PIN_TYPE"));
+        bool neg_trigger = get_param_or_def(ctx, cell.second.get(), ctx->id("NEG_TRIGGER"));
+        bool pullup = get_param_or_def(ctx, cell.second.get(), ctx->id("PULLUP"));
+        bool lvds = cell.second->ioInfo.lvds;
+        bool used_by_pll_out = sb_io_used_by_pll_out.count(Loc(x, y, z)) > 0;
+        bool used_by_pll_pad = sb_io_used_by_pll_pad.count(Loc(x, y, z)) > 0;
+
+        for (int i = used_by_pll_out ? 2 : 0; i < 6; i++) {
+            bool val = (pin_type >> i) & 0x01;
+            set_config(ti, config.at(y).at(x), "IOB_" + std::to_string(z) + ".PINTYPE_" + std::to_string(i), val);
+        }
+        set_config(ti, config.at(y).at(x), "NegClk", neg_trigger);
+
+        bool input_en = false;
+        if ((ctx->wire_to_net[ctx->getBelPinWire(bel, id_D_IN_0).index] != nullptr) ||
+            (ctx->wire_to_net[ctx->getBelPinWire(bel, id_D_IN_1).index] != nullptr)) {
+            input_en = true;
+        }
+        input_en = (input_en & !used_by_pll_out) | used_by_pll_pad;
+        input_en |= cell.second->ioInfo.global;
+
+        if (!lvds) {
+            auto ieren = get_ieren(bi, x, y, z);
+            int iex, iey, iez;
+            std::tie(iex, iey, iez) = ieren;
+            NPNR_ASSERT(iez != -1);
+
+            if (ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K) {
+                set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), !input_en);
+                set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
+            } else {
+                set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), input_en);
+                set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
+            }
+
+            if (ctx->args.type == ArchArgs::UP5K || ctx->args.type == ArchArgs::UP3K) {
+                std::string pullup_resistor = "100K";
+                if (cell.second->attrs.count(ctx->id("PULLUP_RESISTOR")))
+                    pullup_resistor = cell.second->attrs.at(ctx->id("PULLUP_RESISTOR")).as_string();
+                NPNR_ASSERT(pullup_resistor == "100K" || pullup_resistor == "10K" || pullup_resistor == "6P8K" ||
+                            pullup_resistor == "3P3K");
+                if (iez == 0) {
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_39", (!pullup) || (pullup_resistor != "100K"));
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_36", pullup && pullup_resistor == "3P3K");
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_37", pullup && pullup_resistor == "6P8K");
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_38", pullup && pullup_resistor == "10K");
+                } else if (iez == 1) {
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_35", (!pullup) || (pullup_resistor != "100K"));
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_32", pullup && pullup_resistor == "3P3K");
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_33", pullup && pullup_resistor == "6P8K");
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_34", pullup && pullup_resistor == "10K");
+                }
+            }
+        } else {
+            NPNR_ASSERT(z == 0);
+            // Only enable the actual LVDS buffer if input is used for something
+            set_config(ti, config.at(y).at(x), "IoCtrl.LVDS", input_en);
+
+            // Set both IO config
+            for (int cz = 0; cz < 2; cz++) {
+                auto ieren = get_ieren(bi, x, y, cz);
+                int iex, iey, iez;
+                std::tie(iex, iey, iez) = ieren;
+                NPNR_ASSERT(iez != -1);
+
+                pullup &= !input_en; /* If input is used, force disable pullups */
+
+                if (ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K) {
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), true);
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
+                } else {
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), false);
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), !pullup);
+                }
+
+                if (ctx->args.type == ArchArgs::UP5K || ctx->args.type == ArchArgs::UP3K) {
+                    if (iez == 0) {
+                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_39", !pullup);
+                    } else if (iez == 1) {
+                        set_config(ti, config.at(iey).at(iex), "IoCtrl.cf_bit_35", !pullup);
+                    }
+                }
+            }
+        }
+    }
+
+    // Set config bits in unused IO
+    for (auto bel : ctx->getBels()) {
+        if (ctx->bel_to_cell[bel.index] == nullptr && ctx->getBelType(bel) == id_SB_IO) {
+            const TileInfoPOD &ti = bi.tiles_nonrouting[TILE_IO];
+            const BelInfoPOD &beli = ci.bel_data[bel.index];
+            int x = beli.x, y = beli.y, z = beli.z;
+            if (sb_io_used_by_pll_out.count(Loc(x, y, z))) {
+                continue;
+            }
+
+            auto ieren = get_ieren(bi, x, y, z);
+            int iex, iey, iez;
+            std::tie(iex, iey, iez) = ieren;
+            if (iez != -1) {
+                // If IO is in LVDS pair, it will be configured by the other pair
+                if (z == 1) {
+                    BelId lvds0 = ctx->getBelByLocation(Loc{x, y, 0});
+                    const CellInfo *lvds0cell = ctx->getBoundBelCell(lvds0);
+                    if (lvds0cell != nullptr && lvds0cell->ioInfo.lvds)
+                        continue;
+                }
+                if (ctx->args.type == ArchArgs::LP1K || ctx->args.type == ArchArgs::HX1K) {
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), true);
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), false);
+                } else {
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.IE_" + std::to_string(iez), false);
+                    set_config(ti, config.at(iey).at(iex), "IoCtrl.REN_" + std::to_string(iez), false);
+                }
+            }
+        }
+    }
+}
+
+// Serialize a computed configuration as ASC text
+static void write_asc_body(const Context *ctx, const chipconfig_t &config,
+                           const std::vector<std::tuple<int, int, int>> &extra_bits, std::ostream &out)
+{
+    const ChipInfoPOD &ci = *ctx->chip_info;
+
+    out << ".comment from next-pnr" << std::endl;
+
+    switch (ctx->args.type) {
+    case ArchArgs::LP384:
+        out << ".device 384" << std::endl;
+        break;
+    case ArchArgs::HX1K:
+    case ArchArgs::LP1K:
+        out << ".device 1k" << std::endl;
+        break;
+    case ArchArgs::HX4K:
+    case ArchArgs::LP4K:
+    case ArchArgs::HX8K:
+    case ArchArgs::LP8K:
+        out << ".device 8k" << std::endl;
+        break;
+    case ArchArgs::UP3K:
+    case ArchArgs::UP5K:
+        out << ".device 5k" << std::endl;
+        break;
+    case ArchArgs::U1K:
+    case ArchArgs::U2K:
+    case ArchArgs::U4K:
+        out << ".device u4k" << std::endl;
+        break;
+    default:
+        NPNR_ASSERT_FALSE("unsupported device type\n");
+    }
 
     // Write config out
     for (int y = 0; y < ci.height; y++) {
@@ -910,6 +930,70 @@ void write_asc(const Context *ctx, std::ostream &out)
     }
 }
 
+void write_asc(const Context *ctx, std::ostream &out)
+{
+    chipconfig_t config;
+    std::vector<std::tuple<int, int, int>> extra_bits;
+    pool<Loc> sb_io_used_by_pll_out, sb_io_used_by_pll_pad;
+    build_base_config(ctx, config, extra_bits, sb_io_used_by_pll_out, sb_io_used_by_pll_pad);
+    apply_io_config(ctx, config, sb_io_used_by_pll_out, sb_io_used_by_pll_pad);
+    write_asc_body(ctx, config, extra_bits, out);
+}
+
+void write_asc_batch(Context *ctx, const std::vector<AscVariant> &variants)
+{
+    // The logic/routing configuration is shared between all variants; only
+    // the SB_IO/IoCtrl bits are recomputed, on a copy of the base config,
+    // after applying each variant's overrides
+    chipconfig_t base_config;
+    std::vector<std::tuple<int, int, int>> extra_bits;
+    pool<Loc> sb_io_used_by_pll_out, sb_io_used_by_pll_pad;
+    build_base_config(ctx, base_config, extra_bits, sb_io_used_by_pll_out, sb_io_used_by_pll_pad);
+
+    for (const auto &variant : variants) {
+        // Apply the variant's IO overrides, remembering the original values
+        // so the design is left untouched for the next variant
+        std::vector<std::tuple<CellInfo *, IdString, bool, bool, Property>> saved;
+        auto apply_overrides = [&](const dict<IdString, dict<IdString, Property>> &overrides, bool is_attr) {
+            for (const auto &cell_entry : overrides) {
+                auto fnd = ctx->cells.find(cell_entry.first);
+                if (fnd == ctx->cells.end())
+                    log_error("No cell named '%s' in design (in ASC variant '%s')\n", cell_entry.first.c_str(ctx),
+                              variant.filename.c_str());
+                CellInfo *ci = fnd->second.get();
+                if (ci->type != ctx->id("SB_IO"))
+                    log_error("Cell '%s' is not an SB_IO (in ASC variant '%s')\n", cell_entry.first.c_str(ctx),
+                              variant.filename.c_str());
+                auto &table = is_attr ? ci->attrs : ci->params;
+                for (const auto &kv : cell_entry.second) {
+                    bool had = table.count(kv.first);
+                    saved.emplace_back(ci, kv.first, is_attr, had, had ? table.at(kv.first) : Property());
+                    table[kv.first] = kv.second;
+                }
+            }
+        };
+        apply_overrides(variant.io_params, /*is_attr=*/false);
+        apply_overrides(variant.io_attrs, /*is_attr=*/true);
+
+        chipconfig_t config = base_config;
+        apply_io_config(ctx, config, sb_io_used_by_pll_out, sb_io_used_by_pll_pad);
+
+        std::ofstream out(variant.filename);
+        if (!out)
+            log_error("Failed to open output ASC file %s.\n", variant.filename.c_str());
+        write_asc_body(ctx, config, extra_bits, out);
+        log_info("Wrote ASC variant %s.\n", variant.filename.c_str());
+
+        for (const auto &s : saved) {
+            auto &table = std::get<2>(s) ? std::get<0>(s)->attrs : std::get<0>(s)->params;
+            if (std::get<3>(s))
+                table[std::get<1>(s)] = std::get<4>(s);
+            else
+                table.erase(std::get<1>(s));
+        }
+    }
+}
+
 void read_config(Context *ctx, std::istream &in, chipconfig_t &config)
 {
     constexpr size_t line_buf_size = 65536;
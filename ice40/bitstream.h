@@ -29,6 +29,20 @@ NEXTPNR_NAMESPACE_BEGIN
 void write_asc(const Context *ctx, std::ostream &out);
 bool read_asc(Context *ctx, std::istream &in);
 
+// A per-board variant for write_asc_batch: an output file plus SB_IO
+// parameter/attribute overrides (keyed by cell name) applied on top of the
+// shared routed design
+struct AscVariant
+{
+    std::string filename;
+    dict<IdString, dict<IdString, Property>> io_params;
+    dict<IdString, dict<IdString, Property>> io_attrs;
+};
+
+// Emit one ASC file per variant, computing the logic/routing configuration
+// once and re-applying only the SB_IO/IoCtrl configuration per variant
+void write_asc_batch(Context *ctx, const std::vector<AscVariant> &variants);
+
 NEXTPNR_NAMESPACE_END
 
 #endif
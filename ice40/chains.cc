@@ -228,20 +228,8 @@ class ChainConstrainer
 
     void process_carries()
     {
-        std::vector<CellChain> carry_chains = find_chains(
+        std::vector<CellChain> carry_chains = find_chains_indexed(
                 ctx, [](const Context *ctx, const CellInfo *cell) { return is_lc(ctx, cell); },
-                [](const Context *ctx, const
-
-                   CellInfo *cell) {
-                    CellInfo *carry_prev =
-                            net_driven_by(ctx, cell->ports.at(ctx->id("CIN")).net, is_lc, ctx->id("COUT"));
-                    if (carry_prev != nullptr)
-                        return carry_prev;
-                    CellInfo *i3_prev = net_driven_by(ctx, cell->ports.at(ctx->id("I3")).net, is_lc, ctx->id("COUT"));
-                    if (i3_prev != nullptr)
-                        return i3_prev;
-                    return (CellInfo *)nullptr;
-                },
                 [](const Context *ctx, const CellInfo *cell) {
                     CellInfo *carry_next =
                             net_only_drives(ctx, cell->ports.at(ctx->id("COUT")).net, is_lc, ctx->id("CIN"), false);
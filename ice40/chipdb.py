@@ -1152,23 +1152,30 @@ wireinfo = list()
 pipinfo = list()
 pipcache = dict()
 
+# Allocate pip records grouped by source wire, so that each wire's downhill
+# pip list is a contiguous ascending run of PipInfoPOD records. The router
+# walks downhill lists far more often than uphill ones, and this lets it
+# stream through the blob instead of pointer-chasing scattered records.
+for wire in range(num_wires):
+    if wire in wire_downhill:
+        for dst in sorted(wire_downhill[wire]):
+            pipcache[(wire, dst)] = len(pipinfo)
+            pi = dict()
+            pi["src"] = wire
+            pi["dst"] = dst
+            pi["fast_delay"] = pipdelay(wire, dst, fast_timings)
+            pi["slow_delay"] = pipdelay(wire, dst, slow_timings)
+            pi["x"] = pip_xy[(wire, dst)][0]
+            pi["y"] = pip_xy[(wire, dst)][1]
+            pi["switch_mask"] = pip_xy[(wire, dst)][2]
+            pi["switch_index"] = pip_xy[(wire, dst)][3]
+            pi["flags"] = pip_xy[(wire, dst)][4]
+            pipinfo.append(pi)
+
 for wire in range(num_wires):
     if wire in wire_uphill:
         pips = list()
-        for src in wire_uphill[wire]:
-            if (src, wire) not in pipcache:
-                pipcache[(src, wire)] = len(pipinfo)
-                pi = dict()
-                pi["src"] = src
-                pi["dst"] = wire
-                pi["fast_delay"] = pipdelay(src, wire, fast_timings)
-                pi["slow_delay"] = pipdelay(src, wire, slow_timings)
-                pi["x"] = pip_xy[(src, wire)][0]
-                pi["y"] = pip_xy[(src, wire)][1]
-                pi["switch_mask"] = pip_xy[(src, wire)][2]
-                pi["switch_index"] = pip_xy[(src, wire)][3]
-                pi["flags"] = pip_xy[(src, wire)][4]
-                pipinfo.append(pi)
+        for src in sorted(wire_uphill[wire]):
             pips.append(pipcache[(src, wire)])
         num_uphill = len(pips)
         list_uphill = "wire%d_uppips" % wire
@@ -1181,20 +1188,7 @@ for wire in range(num_wires):
 
     if wire in wire_downhill:
         pips = list()
-        for dst in wire_downhill[wire]:
-            if (wire, dst) not in pipcache:
-                pipcache[(wire, dst)] = len(pipinfo)
-                pi = dict()
-                pi["src"] = wire
-                pi["dst"] = dst
-                pi["fast_delay"] = pipdelay(wire, dst, fast_timings)
-                pi["slow_delay"] = pipdelay(wire, dst, slow_timings)
-                pi["x"] = pip_xy[(wire, dst)][0]
-                pi["y"] = pip_xy[(wire, dst)][1]
-                pi["switch_mask"] = pip_xy[(wire, dst)][2]
-                pi["switch_index"] = pip_xy[(wire, dst)][3]
-                pi["flags"] = pip_xy[(wire, dst)][4]
-                pipinfo.append(pi)
+        for dst in sorted(wire_downhill[wire]):
             pips.append(pipcache[(wire, dst)])
         num_downhill = len(pips)
         list_downhill = "wire%d_downpips" % wire
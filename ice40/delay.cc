@@ -190,7 +190,6 @@ delay_t Arch::estimateDelay(WireId src, WireId dst) const
 
 delay_t Arch::predictDelay(BelId src_bel, IdString src_pin, BelId dst_bel, IdString dst_pin) const
 {
-    NPNR_UNUSED(dst_pin);
     auto driver_loc = getBelLocation(src_bel);
     auto sink_loc = getBelLocation(dst_bel);
 
@@ -200,6 +199,15 @@ delay_t Arch::predictDelay(BelId src_bel, IdString src_pin, BelId dst_bel, IdStr
         return 250;
     }
 
+    // Resolve the bel pins to their wires so the prediction picks up the
+    // tmfuzz-fitted per-wire-type deltas and matches the estimate the router
+    // is steered by; pins without a wire fall back to the distance-only
+    // model below.
+    WireId src_wire = getBelPinWire(src_bel, src_pin);
+    WireId dst_wire = getBelPinWire(dst_bel, dst_pin);
+    if (src_wire != WireId() && dst_wire != WireId())
+        return estimateDelay(src_wire, dst_wire);
+
     int dx = abs(sink_loc.x - driver_loc.x);
     int dy = abs(sink_loc.y - driver_loc.y);
 
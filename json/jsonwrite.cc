@@ -32,27 +32,119 @@ NEXTPNR_NAMESPACE_BEGIN
 
 namespace JsonWriter {
 
-std::string get_string(std::string str)
+// Streaming writer: output is accumulated in one pre-sized buffer with direct
+// appends and hand-rolled integer formatting, and flushed to the stream in
+// large chunks. The previous ostream/stringf path spent most of its time
+// building per-value temporary strings (Property::to_string plus an escaped
+// copy for every parameter) and in stream formatting, which dominated the
+// write time of large post-route netlists.
+struct Writer
 {
-    std::string newstr = "\"";
-    for (char c : str) {
-        if (c == '\\')
-            newstr += c;
-        newstr += c;
+    std::ostream &f;
+    std::string buf;
+    size_t chunk;
+
+    Writer(std::ostream &f, size_t reserve_hint) : f(f)
+    {
+        chunk = std::min<size_t>(std::max<size_t>(reserve_hint, size_t(1) << 20), size_t(64) << 20);
+        buf.reserve(chunk);
+    }
+    ~Writer() { flush(); }
+
+    void flush()
+    {
+        if (!buf.empty()) {
+            f.write(buf.data(), std::streamsize(buf.size()));
+            buf.clear();
+        }
+    }
+    // Called between top-level entries so the buffer never grows far past the
+    // chunk size on huge designs
+    void maybe_flush()
+    {
+        if (buf.size() >= chunk)
+            flush();
+    }
+
+    void put(char c) { buf.push_back(c); }
+    void put(const char *s) { buf.append(s); }
+    void put(const std::string &s) { buf.append(s); }
+
+    // itoa fast path for net indices and dummy bit numbers
+    void put_int(int64_t val)
+    {
+        char tmp[24];
+        char *p = tmp + sizeof(tmp);
+        bool neg = val < 0;
+        uint64_t v = neg ? ~uint64_t(val) + 1 : uint64_t(val);
+        do {
+            *--p = char('0' + (v % 10));
+            v /= 10;
+        } while (v != 0);
+        if (neg)
+            *--p = '-';
+        buf.append(p, size_t(tmp + sizeof(tmp) - p));
     }
-    return newstr + "\"";
-}
 
-std::string get_name(IdString name, Context *ctx) { return get_string(name.c_str(ctx)); }
+    // Quoted string; as before, literal backslashes are doubled and
+    // everything else passes through untouched
+    void put_quoted(const char *s, size_t len)
+    {
+        buf.push_back('"');
+        for (size_t i = 0; i < len; i++) {
+            if (s[i] == '\\')
+                buf.push_back('\\');
+            buf.push_back(s[i]);
+        }
+        buf.push_back('"');
+    }
+    void put_quoted(const std::string &s) { put_quoted(s.data(), s.size()); }
+    void put_name(IdString name, Context *ctx) { put_quoted(name.str(ctx)); }
+
+    // Property value in Yosys JSON form, appended without the intermediate
+    // Property::to_string and escaping temporaries
+    void put_property(const Property &prop)
+    {
+        buf.push_back('"');
+        if (prop.is_string) {
+            // Track whether the literal matches /^[01xz]* *$/ while
+            // escaping, and add the disambiguating trailing space if so
+            // (same rule as Property::to_string)
+            int state = 0;
+            for (char c : prop.str) {
+                if (state == 0) {
+                    if (c == '0' || c == '1' || c == 'x' || c == 'z')
+                        state = 0;
+                    else if (c == ' ')
+                        state = 1;
+                    else
+                        state = 2;
+                } else if (state == 1 && c != ' ')
+                    state = 2;
+                if (c == '\\')
+                    buf.push_back(c);
+                buf.push_back(c);
+            }
+            if (state < 2)
+                buf.push_back(' ');
+        } else {
+            // Numeric values are stored LSB-first as [01xz]; emit MSB-first
+            for (auto it = prop.str.rbegin(); it != prop.str.rend(); ++it)
+                buf.push_back(*it);
+        }
+        buf.push_back('"');
+    }
+};
 
-void write_parameters(std::ostream &f, Context *ctx, const dict<IdString, Property> &parameters,
-                      bool for_module = false)
+void write_parameters(Writer &w, Context *ctx, const dict<IdString, Property> &parameters, bool for_module = false)
 {
     bool first = true;
     for (auto &param : parameters) {
-        f << stringf("%s\n", first ? "" : ",");
-        f << stringf("        %s%s: ", for_module ? "" : "    ", get_name(param.first, ctx).c_str());
-        f << get_string(param.second.to_string());
+        w.put(first ? "\n" : ",\n");
+        w.put(for_module ? "        " : "            ");
+        w.put_name(param.first, ctx);
+        w.put(": ");
+        w.put_property(param.second);
         first = false;
     }
 }
@@ -94,122 +186,150 @@ std::vector<PortGroup> group_ports(Context *ctx, const dict<IdString, PortInfo>
     return groups;
 }
 
-std::string format_port_bits(const PortGroup &port, int &dummy_idx)
+void write_port_bits(Writer &w, const PortGroup &port, int &dummy_idx)
 {
-    std::stringstream s;
-    s << "[ ";
+    w.put("[ ");
     bool first = true;
     if (port.bits.size() != 1 || port.bits.at(0) != -1) // skip single disconnected ports
         for (auto bit : port.bits) {
             if (!first)
-                s << ", ";
+                w.put(", ");
             if (bit == -1)
-                s << (++dummy_idx);
+                w.put_int(++dummy_idx);
             else
-                s << bit;
+                w.put_int(bit);
             first = false;
         }
-    s << " ]";
-    return s.str();
+    w.put(" ]");
 }
 
-void write_module(std::ostream &f, Context *ctx)
+void write_module(Writer &w, Context *ctx)
 {
     auto val = ctx->attrs.find(ctx->id("module"));
-    int dummy_idx = int(ctx->idstring_idx_to_str->size()) + 1000;
-    if (val != ctx->attrs.end())
-        f << stringf("    %s: {\n", get_string(val->second.as_string()).c_str());
-    else
-        f << stringf("    %s: {\n", get_string("top").c_str());
-    f << stringf("      \"settings\": {");
-    write_parameters(f, ctx, ctx->settings, true);
-    f << stringf("\n      },\n");
-    f << stringf("      \"attributes\": {");
-    write_parameters(f, ctx, ctx->attrs, true);
-    f << stringf("\n      },\n");
-    f << stringf("      \"ports\": {");
+    int dummy_idx = ctx->idstring_db->size() + 1000;
+    w.put("    ");
+    w.put_quoted(val != ctx->attrs.end() ? val->second.as_string() : "top");
+    w.put(": {\n");
+    w.put("      \"settings\": {");
+    write_parameters(w, ctx, ctx->settings, true);
+    w.put("\n      },\n");
+    w.put("      \"attributes\": {");
+    write_parameters(w, ctx, ctx->attrs, true);
+    w.put("\n      },\n");
+    w.put("      \"ports\": {");
 
     auto ports = group_ports(ctx, ctx->ports);
     bool first = true;
     for (auto &port : ports) {
-        f << stringf("%s\n", first ? "" : ",");
-        f << stringf("        %s: {\n", get_string(port.name).c_str());
-        f << stringf("          \"direction\": \"%s\",\n", port.dir == PORT_IN      ? "input"
-                                                           : port.dir == PORT_INOUT ? "inout"
-                                                                                    : "output");
-        f << stringf("          \"bits\": %s\n", format_port_bits(port, dummy_idx).c_str());
-        f << stringf("        }");
+        w.put(first ? "\n" : ",\n");
+        w.put("        ");
+        w.put_quoted(port.name);
+        w.put(": {\n");
+        w.put("          \"direction\": \"");
+        w.put(port.dir == PORT_IN ? "input" : port.dir == PORT_INOUT ? "inout" : "output");
+        w.put("\",\n");
+        w.put("          \"bits\": ");
+        write_port_bits(w, port, dummy_idx);
+        w.put("\n");
+        w.put("        }");
         first = false;
     }
-    f << stringf("\n      },\n");
+    w.put("\n      },\n");
 
-    f << stringf("      \"cells\": {");
+    w.put("      \"cells\": {");
     first = true;
     for (auto &pair : ctx->cells) {
         auto &c = pair.second;
         auto cell_ports = group_ports(ctx, c->ports, true);
-        f << stringf("%s\n", first ? "" : ",");
-        f << stringf("        %s: {\n", get_name(c->name, ctx).c_str());
-        f << stringf("          \"hide_name\": %s,\n", c->name.c_str(ctx)[0] == '$' ? "1" : "0");
-        f << stringf("          \"type\": %s,\n", get_name(c->type, ctx).c_str());
-        f << stringf("          \"parameters\": {");
-        write_parameters(f, ctx, c->params);
-        f << stringf("\n          },\n");
-        f << stringf("          \"attributes\": {");
-        write_parameters(f, ctx, c->attrs);
-        f << stringf("\n          },\n");
-        f << stringf("          \"port_directions\": {");
+        w.put(first ? "\n" : ",\n");
+        w.put("        ");
+        w.put_name(c->name, ctx);
+        w.put(": {\n");
+        w.put("          \"hide_name\": ");
+        w.put(c->name.c_str(ctx)[0] == '$' ? "1" : "0");
+        w.put(",\n");
+        w.put("          \"type\": ");
+        w.put_name(c->type, ctx);
+        w.put(",\n");
+        w.put("          \"parameters\": {");
+        write_parameters(w, ctx, c->params);
+        w.put("\n          },\n");
+        w.put("          \"attributes\": {");
+        write_parameters(w, ctx, c->attrs);
+        w.put("\n          },\n");
+        w.put("          \"port_directions\": {");
         bool first2 = true;
         for (auto &pg : cell_ports) {
-            std::string direction = (pg.dir == PORT_IN) ? "input" : (pg.dir == PORT_OUT) ? "output" : "inout";
-            f << stringf("%s\n", first2 ? "" : ",");
-            f << stringf("            %s: \"%s\"", get_string(pg.name).c_str(), direction.c_str());
+            w.put(first2 ? "\n" : ",\n");
+            w.put("            ");
+            w.put_quoted(pg.name);
+            w.put(": \"");
+            w.put(pg.dir == PORT_IN ? "input" : pg.dir == PORT_OUT ? "output" : "inout");
+            w.put('"');
             first2 = false;
         }
-        f << stringf("\n          },\n");
-        f << stringf("          \"connections\": {");
+        w.put("\n          },\n");
+        w.put("          \"connections\": {");
         first2 = true;
         for (auto &pg : cell_ports) {
-            f << stringf("%s\n", first2 ? "" : ",");
-            f << stringf("            %s: %s", get_string(pg.name).c_str(), format_port_bits(pg, dummy_idx).c_str());
+            w.put(first2 ? "\n" : ",\n");
+            w.put("            ");
+            w.put_quoted(pg.name);
+            w.put(": ");
+            write_port_bits(w, pg, dummy_idx);
             first2 = false;
         }
-        f << stringf("\n          }\n");
+        w.put("\n          }\n");
 
-        f << stringf("        }");
+        w.put("        }");
         first = false;
+        w.maybe_flush();
     }
 
-    f << stringf("\n      },\n");
+    w.put("\n      },\n");
 
-    f << stringf("      \"netnames\": {");
+    w.put("      \"netnames\": {");
     first = true;
     for (auto &pair : ctx->nets) {
-        auto &w = pair.second;
-        f << stringf("%s\n", first ? "" : ",");
-        f << stringf("        %s: {\n", get_name(w->name, ctx).c_str());
-        f << stringf("          \"hide_name\": %s,\n", w->name.c_str(ctx)[0] == '$' ? "1" : "0");
-        f << stringf("          \"bits\": [ %d ] ,\n", pair.first.index);
-        f << stringf("          \"attributes\": {");
-        write_parameters(f, ctx, w->attrs);
-        f << stringf("\n          }\n");
-        f << stringf("        }");
+        auto &net = pair.second;
+        w.put(first ? "\n" : ",\n");
+        w.put("        ");
+        w.put_name(net->name, ctx);
+        w.put(": {\n");
+        w.put("          \"hide_name\": ");
+        w.put(net->name.c_str(ctx)[0] == '$' ? "1" : "0");
+        w.put(",\n");
+        w.put("          \"bits\": [ ");
+        w.put_int(pair.first.index);
+        w.put(" ] ,\n");
+        w.put("          \"attributes\": {");
+        write_parameters(w, ctx, net->attrs);
+        w.put("\n          }\n");
+        w.put("        }");
         first = false;
+        w.maybe_flush();
     }
 
-    f << stringf("\n      }\n");
-    f << stringf("    }");
+    w.put("\n      }\n");
+    w.put("    }");
 }
 
 void write_context(std::ostream &f, Context *ctx)
 {
-    f << stringf("{\n");
-    f << stringf("  \"creator\": %s,\n",
-                 get_string("Next Generation Place and Route (Version " GIT_DESCRIBE_STR ")").c_str());
-    f << stringf("  \"modules\": {\n");
-    write_module(f, ctx);
-    f << stringf("\n  }");
-    f << stringf("\n}\n");
+    // Pre-size the output buffer from the netlist counts: a few hundred
+    // bytes per cell and per net is a good estimate of the formatted
+    // footprint, capped so pathological designs don't reserve unbounded
+    // memory (the buffer is flushed in chunks anyway)
+    size_t reserve_hint = 512 * ctx->cells.size() + 192 * ctx->nets.size() + 4096;
+    Writer w(f, reserve_hint);
+    w.put("{\n");
+    w.put("  \"creator\": ");
+    w.put_quoted("Next Generation Place and Route (Version " GIT_DESCRIBE_STR ")");
+    w.put(",\n");
+    w.put("  \"modules\": {\n");
+    write_module(w, ctx);
+    w.put("\n  }");
+    w.put("\n}\n");
 }
 
 }; // End Namespace JsonWriter
@@ -320,19 +320,31 @@ WireId Arch::getWireByName(IdStringList name) const
 {
     if (name.size() != 3)
         return WireId();
+    auto it = wire_by_name.find(name);
+    if (it != wire_by_name.end())
+        return it->second;
+
     WireId ret;
     Location loc;
     loc.x = id_to_x.at(name[0]);
     loc.y = id_to_y.at(name[1]);
     ret.location = loc;
+    // Index every wire at this location on the first query that reaches it,
+    // so scripts resolving many names don't pay a linear strcmp scan per call
     const TileTypePOD *loci = tile_info(ret);
     for (int i = 0; i < loci->num_wires; i++) {
-        if (std::strcmp(loci->wire_data[i].name.get(), name[2].c_str(this)) == 0) {
-            ret.index = i;
-            return ret;
-        }
+        WireId curr;
+        curr.location = loc;
+        curr.index = i;
+        wire_by_name[getWireName(curr)] = curr;
     }
-    return WireId();
+    it = wire_by_name.find(name);
+    if (it == wire_by_name.end()) {
+        // Cache the miss too, so repeated bad lookups stay cheap
+        wire_by_name[name] = WireId();
+        return WireId();
+    }
+    return it->second;
 }
 
 // ---------------------------------------------------------------
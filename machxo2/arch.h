@@ -404,6 +404,9 @@ struct Arch : BaseArch<ArchRanges>
     const PackageInfoPOD *package_info;
 
     mutable dict<IdStringList, PipId> pip_by_name;
+    // Lazy per-location wire name index, filled by getWireByName; misses are
+    // cached as WireId() so bad names don't rescan their location
+    mutable dict<IdStringList, WireId> wire_by_name;
 
     // fast access to  X and Y IdStrings for building object names
     std::vector<IdString> x_ids, y_ids;
@@ -114,6 +114,7 @@ typedef IdString ClusterId;
 
 struct ArchNetInfo
 {
+    bool is_global = false;
 };
 
 struct NetInfo;
@@ -131,20 +131,66 @@ static std::string get_trellis_wirename(Context *ctx, Location loc, WireId wire)
     return rel_prefix + "_" + basename;
 }
 
-static void set_pip(Context *ctx, ChipConfig &cc, PipId pip)
+// Resolves config tiles once and hands out stable TileConfig pointers, so the
+// pip and cell loops below don't redo full tile-name map lookups (or, for
+// get_tile_by_type, whole-chip scans) for every feature they write.
+struct TileLookup
 {
-    std::string tile = ctx->get_pip_tilename(pip);
-    std::string tile_type = ctx->chip_info->tiletype_names[ctx->tile_info(pip)->pips_data[pip.index].tile_type].get();
+    Context *ctx;
+    ChipConfig &cc;
+    // (location, tile type index) -> TileConfig, filled on first use
+    std::vector<std::vector<std::pair<int, TileConfig *>>> loc_tiles;
+    std::map<std::string, TileConfig *> type_tiles;
+
+    TileLookup(Context *ctx, ChipConfig &cc)
+            : ctx(ctx), cc(cc), loc_tiles(ctx->chip_info->height * ctx->chip_info->width)
+    {
+    }
+
+    // Entries in cc.tiles are stable once created (std::map), so caching
+    // pointers to them is safe even as more tiles are added.
+    TileConfig &tile_at(Location loc, int type_idx)
+    {
+        auto &cached = loc_tiles.at(loc.y * ctx->chip_info->width + loc.x);
+        for (auto &entry : cached)
+            if (entry.first == type_idx)
+                return *entry.second;
+        auto &tileloc = ctx->chip_info->tile_info[loc.y * ctx->chip_info->width + loc.x];
+        for (int i = 0; i < tileloc.num_tiles; i++) {
+            if (tileloc.tile_names[i].type_idx == type_idx) {
+                TileConfig *tc = &cc.tiles[tileloc.tile_names[i].name.get()];
+                cached.emplace_back(type_idx, tc);
+                return *tc;
+            }
+        }
+        NPNR_ASSERT_FALSE("failed to find tile for config write");
+    }
+
+    TileConfig &tile_by_type(const std::string &type)
+    {
+        auto found = type_tiles.find(type);
+        if (found != type_tiles.end())
+            return *found->second;
+        TileConfig *tc = &cc.tiles[ctx->get_tile_by_type(type)];
+        type_tiles.emplace(type, tc);
+        return *tc;
+    }
+};
+
+static void set_pip(Context *ctx, TileLookup &tiles, PipId pip)
+{
+    int tile_type_idx = ctx->tile_info(pip)->pips_data[pip.index].tile_type;
     std::string source = get_trellis_wirename(ctx, pip.location, ctx->getPipSrcWire(pip));
     std::string sink = get_trellis_wirename(ctx, pip.location, ctx->getPipDstWire(pip));
-    cc.tiles[tile].add_arc(sink, source);
+    tiles.tile_at(pip.location, tile_type_idx).add_arc(sink, source);
 
     // Special case pips whose config bits are spread across tiles.
     if (source == "G_PCLKCIBVIQT0" && sink == "G_VPRXCLKI0") {
+        std::string tile_type = ctx->chip_info->tiletype_names[tile_type_idx].get();
         if (tile_type == "CENTER7") {
-            cc.tiles[ctx->get_tile_by_type("CENTER8")].add_arc(sink, source);
+            tiles.tile_by_type("CENTER8").add_arc(sink, source);
         } else if (tile_type == "CENTER8") {
-            cc.tiles[ctx->get_tile_by_type("CENTER7")].add_arc(sink, source);
+            tiles.tile_by_type("CENTER7").add_arc(sink, source);
         } else {
             NPNR_ASSERT_FALSE("Tile does not contain special-cased pip");
         }
@@ -207,11 +253,13 @@ void write_bitstream(Context *ctx, std::string text_config_file)
 
     cc.metadata.push_back("Part: " + ctx->get_full_chip_name());
 
+    TileLookup tiles(ctx, cc);
+
     // Add all set, configurable pips to the config
     for (auto pip : ctx->getPips()) {
         if (ctx->getBoundPipNet(pip) != nullptr) {
             if (ctx->get_pip_class(pip) == 0) { // ignore fixed pips
-                set_pip(ctx, cc, pip);
+                set_pip(ctx, tiles, pip);
             }
         }
     }
@@ -228,7 +276,7 @@ void write_bitstream(Context *ctx, std::string text_config_file)
         }
         BelId bel = ci->bel;
         if (ci->type == id_FACADE_SLICE) {
-            std::string tname = ctx->get_tile_by_type_and_loc(bel.location.y, bel.location.x, "PLC");
+            TileConfig &tile = cc.tiles[ctx->get_tile_by_type_and_loc(bel.location.y, bel.location.x, "PLC")];
             std::string slice = ctx->tile_info(bel)->bel_data[bel.index].name.get();
 
             NPNR_ASSERT(slice.substr(0, 5) == "SLICE");
@@ -237,26 +285,24 @@ void write_bitstream(Context *ctx, std::string text_config_file)
 
             int lut0_init = int_or_default(ci->params, ctx->id("LUT0_INITVAL"));
             int lut1_init = int_or_default(ci->params, ctx->id("LUT1_INITVAL"));
-            cc.tiles[tname].add_word(slice + ".K0.INIT", int_to_bitvector(lut0_init, 16));
-            cc.tiles[tname].add_word(slice + ".K1.INIT", int_to_bitvector(lut1_init, 16));
-            cc.tiles[tname].add_enum(slice + ".MODE", str_or_default(ci->params, ctx->id("MODE"), "LOGIC"));
-            cc.tiles[tname].add_enum(slice + ".GSR", str_or_default(ci->params, ctx->id("GSR"), "ENABLED"));
-            cc.tiles[tname].add_enum("LSR" + std::to_string(int_index) + ".SRMODE",
-                                     str_or_default(ci->params, ctx->id("SRMODE"), "LSR_OVER_CE"));
-            cc.tiles[tname].add_enum(slice + ".CEMUX", intstr_or_default(ci->params, ctx->id("CEMUX"), "1"));
-            cc.tiles[tname].add_enum("CLK" + std::to_string(int_index) + ".CLKMUX",
-                                     intstr_or_default(ci->params, ctx->id("CLKMUX"), "0"));
-            cc.tiles[tname].add_enum("LSR" + std::to_string(int_index) + ".LSRMUX",
-                                     str_or_default(ci->params, ctx->id("LSRMUX"), "LSR"));
-            cc.tiles[tname].add_enum("LSR" + std::to_string(int_index) + ".LSRONMUX",
-                                     intstr_or_default(ci->params, ctx->id("LSRONMUX"), "LSRMUX"));
-            cc.tiles[tname].add_enum(slice + ".REGMODE", str_or_default(ci->params, ctx->id("REGMODE"), "FF"));
-            cc.tiles[tname].add_enum(slice + ".REG0.SD", intstr_or_default(ci->params, ctx->id("REG0_SD"), "0"));
-            cc.tiles[tname].add_enum(slice + ".REG1.SD", intstr_or_default(ci->params, ctx->id("REG1_SD"), "0"));
-            cc.tiles[tname].add_enum(slice + ".REG0.REGSET",
-                                     str_or_default(ci->params, ctx->id("REG0_REGSET"), "RESET"));
-            cc.tiles[tname].add_enum(slice + ".REG1.REGSET",
-                                     str_or_default(ci->params, ctx->id("REG1_REGSET"), "RESET"));
+            tile.add_word(slice + ".K0.INIT", int_to_bitvector(lut0_init, 16));
+            tile.add_word(slice + ".K1.INIT", int_to_bitvector(lut1_init, 16));
+            tile.add_enum(slice + ".MODE", str_or_default(ci->params, ctx->id("MODE"), "LOGIC"));
+            tile.add_enum(slice + ".GSR", str_or_default(ci->params, ctx->id("GSR"), "ENABLED"));
+            tile.add_enum("LSR" + std::to_string(int_index) + ".SRMODE",
+                          str_or_default(ci->params, ctx->id("SRMODE"), "LSR_OVER_CE"));
+            tile.add_enum(slice + ".CEMUX", intstr_or_default(ci->params, ctx->id("CEMUX"), "1"));
+            tile.add_enum("CLK" + std::to_string(int_index) + ".CLKMUX",
+                          intstr_or_default(ci->params, ctx->id("CLKMUX"), "0"));
+            tile.add_enum("LSR" + std::to_string(int_index) + ".LSRMUX",
+                          str_or_default(ci->params, ctx->id("LSRMUX"), "LSR"));
+            tile.add_enum("LSR" + std::to_string(int_index) + ".LSRONMUX",
+                          intstr_or_default(ci->params, ctx->id("LSRONMUX"), "LSRMUX"));
+            tile.add_enum(slice + ".REGMODE", str_or_default(ci->params, ctx->id("REGMODE"), "FF"));
+            tile.add_enum(slice + ".REG0.SD", intstr_or_default(ci->params, ctx->id("REG0_SD"), "0"));
+            tile.add_enum(slice + ".REG1.SD", intstr_or_default(ci->params, ctx->id("REG1_SD"), "0"));
+            tile.add_enum(slice + ".REG0.REGSET", str_or_default(ci->params, ctx->id("REG0_REGSET"), "RESET"));
+            tile.add_enum(slice + ".REG1.REGSET", str_or_default(ci->params, ctx->id("REG1_REGSET"), "RESET"));
         } else if (ci->type == ctx->id("FACADE_IO")) {
             std::string pio = ctx->tile_info(bel)->bel_data[bel.index].name.get();
             std::string iotype = str_or_default(ci->attrs, ctx->id("IO_TYPE"), "LVCMOS33");
@@ -265,8 +311,9 @@ void write_bitstream(Context *ctx, std::string text_config_file)
             cc.tiles[pic_tile].add_enum(pio + ".BASE_TYPE", dir + "_" + iotype);
         } else if (ci->type == ctx->id("OSCH")) {
             std::string freq = str_or_default(ci->params, ctx->id("NOM_FREQ"), "2.08");
-            cc.tiles[ctx->get_tile_by_type("CFG1")].add_enum("OSCH.MODE", "OSCH");
-            cc.tiles[ctx->get_tile_by_type("CFG1")].add_enum("OSCH.NOM_FREQ", freq);
+            TileConfig &cfg1 = tiles.tile_by_type("CFG1");
+            cfg1.add_enum("OSCH.MODE", "OSCH");
+            cfg1.add_enum("OSCH.NOM_FREQ", freq);
         }
     }
 
@@ -147,10 +147,10 @@ bool Arch::isBelLocationValid(BelId bel) const
     auto &data = bel_data(bel);
     if (data.type.in(id_MISTRAL_COMB, id_MISTRAL_MCOMB)) {
         return is_alm_legal(data.lab_data.lab, data.lab_data.alm) && check_lab_input_count(data.lab_data.lab) &&
-               check_mlab_groups(data.lab_data.lab);
+               labs.at(data.lab_data.lab).mlab_legal;
     } else if (data.type == id_MISTRAL_FF) {
         return is_alm_legal(data.lab_data.lab, data.lab_data.alm) && check_lab_input_count(data.lab_data.lab) &&
-               is_lab_ctrlset_legal(data.lab_data.lab) && check_mlab_groups(data.lab_data.lab);
+               labs.at(data.lab_data.lab).ctrlset_legal && labs.at(data.lab_data.lab).mlab_legal;
     }
     return true;
 }
@@ -160,6 +160,14 @@ void Arch::update_bel(BelId bel)
     auto &data = bel_data(bel);
     if (data.type.in(id_MISTRAL_COMB, id_MISTRAL_MCOMB, id_MISTRAL_FF)) {
         update_alm_input_count(data.lab_data.lab, data.lab_data.alm);
+        // Refresh the cached LAB-wide legality results; recomputing once per
+        // bind/unbind is far cheaper than once per placer probe, as probes
+        // greatly outnumber actual placement changes
+        auto &lab = labs.at(data.lab_data.lab);
+        if (data.type == id_MISTRAL_FF)
+            lab.ctrlset_legal = is_lab_ctrlset_legal(data.lab_data.lab);
+        if (lab.is_mlab)
+            lab.mlab_legal = check_mlab_groups(data.lab_data.lab);
     }
 }
 
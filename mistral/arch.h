@@ -67,6 +67,11 @@ struct LABInfo
     WireId sclr_wire, sload_wire;
     // TODO: LAB configuration (control set etc)
     std::array<bool, 2> aclr_used;
+    // Cached LAB-wide legality results, refreshed by update_bel on
+    // bind/unbind so placer probes read a flag instead of re-running the
+    // control-set worker over the whole LAB for every candidate
+    bool ctrlset_legal = true;
+    bool mlab_legal = true;
 };
 
 struct PinInfo
@@ -285,6 +290,10 @@ enum CellPinStyle
 
 struct Arch : BaseArch<ArchRanges>
 {
+    // Expanding the box of failing nets slows down the resolution of
+    // timing-driven congestion on CycloneV, so it is disabled
+    static constexpr bool capExpandBBOnRouteFail = false;
+
     ArchArgs args;
     mistral::CycloneV *cyclonev;
 
@@ -341,6 +350,7 @@ struct Arch : BaseArch<ArchRanges>
         NPNR_ASSERT(data.bound == nullptr);
         data.bound = cell;
         cell->bel = bel;
+        cell->loc = getBelLocation(bel);
         cell->belStrength = strength;
         update_bel(bel);
     }
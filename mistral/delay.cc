@@ -16,6 +16,8 @@
  *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#include <array>
+
 #include "nextpnr.h"
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -207,36 +209,38 @@ bool Arch::getCellDelay(const CellInfo *cell, IdString fromPort, IdString toPort
     return false;
 }
 
+namespace {
+// Pip delay depends only on the destination rnode type, so the router's
+// innermost delay query is one load from this table rather than a branch
+// chain. The values are guesswork based on average of (interconnect delay /
+// number of pips)
+std::array<DelayQuad, 128> make_pip_type_delays()
+{
+    std::array<DelayQuad, 128> delays;
+    delays.fill(DelayQuad{308});
+    delays[size_t(CycloneV::rnode_type_t::H14)] = DelayQuad{254};
+    delays[size_t(CycloneV::rnode_type_t::H3)] = DelayQuad{214};
+    delays[size_t(CycloneV::rnode_type_t::H6)] = DelayQuad{298};
+    delays[size_t(CycloneV::rnode_type_t::V2)] = DelayQuad{210};
+    delays[size_t(CycloneV::rnode_type_t::V4)] = DelayQuad{262};
+    delays[size_t(CycloneV::rnode_type_t::DCMUX)] = DelayQuad{0};
+    delays[size_t(CycloneV::rnode_type_t::GIN)] = DelayQuad{83}; // need to check with Sarayan
+    delays[size_t(CycloneV::rnode_type_t::GOUT)] = DelayQuad{123};
+    delays[size_t(CycloneV::rnode_type_t::TCLK)] = DelayQuad{46};
+    return delays;
+}
+const std::array<DelayQuad, 128> pip_type_delays = make_pip_type_delays();
+} // namespace
+
 DelayQuad Arch::getPipDelay(PipId pip) const
 {
-    WireId src = getPipSrcWire(pip), dst = getPipDstWire(pip);
-    if ((src.is_nextpnr_created() && dst.is_nextpnr_created()) || dst.is_nextpnr_created())
+    // Wires created by nextpnr have rnode type >= 128; the original
+    // condition also tested the source wire, but it reduced to this
+    unsigned dst_type = unsigned(CycloneV::rn2t(pip.dst));
+    if (dst_type >= 128)
         return DelayQuad{20};
 
-    // This is guesswork based on average of (interconnect delay / number of pips)
-    auto dst_type = CycloneV::rn2t(dst.node);
-
-    switch (dst_type) {
-    case CycloneV::rnode_type_t::H14:
-        return DelayQuad{254};
-    case CycloneV::rnode_type_t::H3:
-        return DelayQuad{214};
-    case CycloneV::rnode_type_t::H6:
-        return DelayQuad{298};
-    case CycloneV::rnode_type_t::V2:
-        return DelayQuad{210};
-    case CycloneV::rnode_type_t::V4:
-        return DelayQuad{262};
-    case CycloneV::rnode_type_t::DCMUX:
-        return DelayQuad{0};
-    case CycloneV::rnode_type_t::GIN:
-        return DelayQuad{83}; // need to check with Sarayan
-    case CycloneV::rnode_type_t::GOUT:
-        return DelayQuad{123};
-    case CycloneV::rnode_type_t::TCLK:
-        return DelayQuad{46};
-    }
-    return DelayQuad{308};
+    return pip_type_delays[dst_type];
 }
 
 delay_t Arch::predictDelay(BelId src_bel, IdString src_pin, BelId dst_bel, IdString dst_pin) const
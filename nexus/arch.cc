@@ -172,6 +172,16 @@ Arch::Arch(ArchArgs args) : args(args)
     if (!speed_grade)
         log_error("Unknown speed grade '%s'.\n", speed.c_str());
 
+    // Precompile the per-cell-type propagation delay tables (see arch.h)
+    cell_prop_delays.resize(speed_grade->cell_types.ssize());
+    for (int i = 0; i < speed_grade->cell_types.ssize(); i++) {
+        const auto &ct = speed_grade->cell_types[i];
+        auto &tbl = cell_prop_delays.at(i);
+        tbl.reserve(ct.prop_delays.size());
+        for (const auto &pd : ct.prop_delays)
+            tbl[(uint64_t(uint32_t(pd.to_port)) << 32) | uint32_t(pd.from_port)] = &pd;
+    }
+
     BaseArch::init_cell_types();
     BaseArch::init_bel_buckets();
 
@@ -919,14 +929,11 @@ int Arch::get_cell_timing_idx(IdString cell_type, IdString cell_variant) const
 bool Arch::lookup_cell_delay(int type_idx, IdString from_port, IdString to_port, DelayQuad &delay) const
 {
     NPNR_ASSERT(type_idx != -1);
-    const auto &ct = speed_grade->cell_types[type_idx];
-    int dly_idx = db_binary_search(
-            ct.prop_delays.get(), ct.prop_delays.size(),
-            [](const CellPropDelayPOD &pd) { return std::make_pair(pd.to_port, pd.from_port); },
-            std::make_pair(to_port.index, from_port.index));
-    if (dly_idx == -1)
+    const auto &tbl = cell_prop_delays.at(type_idx);
+    auto fnd = tbl.find((uint64_t(uint32_t(to_port.index)) << 32) | uint32_t(from_port.index));
+    if (fnd == tbl.end())
         return false;
-    delay = DelayQuad(ct.prop_delays[dly_idx].min_delay, ct.prop_delays[dly_idx].max_delay);
+    delay = DelayQuad(fnd->second->min_delay, fnd->second->max_delay);
     return true;
 }
 
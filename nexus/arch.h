@@ -891,6 +891,13 @@ struct Arch : BaseArch<ArchRanges>
     const ChipInfoPOD *chip_info;
     const SpeedGradePOD *speed_grade;
 
+    // Precompiled propagation delay tables: per speed-grade cell type, a
+    // flat map from packed (to_port, from_port) name indices to the delay
+    // entry. Built once at startup so the hot lookup_cell_delay path (a
+    // cell's tmg_index already resolves its timing table) is a single hash
+    // probe rather than a binary search per STA query
+    std::vector<dict<uint64_t, const CellPropDelayPOD *>> cell_prop_delays;
+
     int package_idx;
 
     // Binding states
@@ -956,6 +963,7 @@ struct Arch : BaseArch<ArchRanges>
         NPNR_ASSERT(tileStatus[bel.tile].boundcells[bel.index] == nullptr);
         tileStatus[bel.tile].boundcells[bel.index] = cell;
         cell->bel = bel;
+        cell->loc = getBelLocation(bel);
         cell->belStrength = strength;
         refreshUiBel(bel);
 
@@ -1145,6 +1153,7 @@ struct Arch : BaseArch<ArchRanges>
         NPNR_ASSERT(w2n_entry == nullptr);
         net->wires[wire].pip = PipId();
         net->wires[wire].strength = strength;
+        ++net->route_version;
         w2n_entry = net;
         this->refreshUiWire(wire);
     }
@@ -1164,6 +1173,7 @@ struct Arch : BaseArch<ArchRanges>
         }
 
         net_wires.erase(it);
+        ++w2n_entry->route_version;
         w2n_entry = nullptr;
         this->refreshUiWire(wire);
     }
@@ -1268,6 +1278,7 @@ struct Arch : BaseArch<ArchRanges>
         w2n_entry = net;
         net->wires[dst].pip = pip;
         net->wires[dst].strength = strength;
+        ++net->route_version;
     }
 
     void unbindPip(PipId pip) override
@@ -1283,6 +1294,7 @@ struct Arch : BaseArch<ArchRanges>
         w2n_entry = nullptr;
 
         p2n_entry->wires.erase(dst);
+        ++p2n_entry->route_version;
         p2n_entry = nullptr;
     }
 
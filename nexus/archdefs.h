@@ -141,8 +141,8 @@ struct DecalId
 
 struct ArchNetInfo
 {
-    bool is_global;
-    bool is_clock, is_reset;
+    bool is_global = false;
+    bool is_clock = false, is_reset = false;
 };
 
 struct NetInfo;
@@ -18,6 +18,7 @@
  *
  */
 
+#include "buffered_text_writer.h"
 #include "log.h"
 #include "nextpnr.h"
 #include "util.h"
@@ -30,7 +31,9 @@ namespace {
 struct NexusFasmWriter
 {
     const Context *ctx;
-    std::ostream &out;
+    // Buffers the many short feature lines rather than formatting and
+    // flushing the underlying stream once per line
+    BufferedTextWriter out;
     std::vector<std::string> fasm_ctx;
     bool is_lifcl_17;
 
@@ -56,14 +59,16 @@ struct NexusFasmWriter
     void blank()
     {
         if (!last_was_blank)
-            out << std::endl;
+            out.newline();
         last_was_blank = true;
     }
     // Write out all prefices from the stack, interspersed with .
     void write_prefix()
     {
-        for (auto &x : fasm_ctx)
-            out << x << ".";
+        for (auto &x : fasm_ctx) {
+            out.put(x);
+            out.put('.');
+        }
         last_was_blank = false;
     }
     // Write a single config bit; if value is true
@@ -71,26 +76,42 @@ struct NexusFasmWriter
     {
         if (value) {
             write_prefix();
-            out << name << std::endl;
+            out.put(name);
+            out.newline();
         }
     }
     // Write a FASM attribute
     void write_attribute(const std::string &key, const std::string &value, bool str = true)
     {
         std::string qu = str ? "\"" : "";
-        out << "{ " << key << "=" << qu << value << qu << " }" << std::endl;
+        out.put("{ ");
+        out.put(key);
+        out.put('=');
+        out.put(qu);
+        out.put(value);
+        out.put(qu);
+        out.put(" }");
+        out.newline();
         last_was_blank = false;
     }
     // Write a FASM comment
-    void write_comment(const std::string &cmt) { out << "# " << cmt << std::endl; }
+    void write_comment(const std::string &cmt)
+    {
+        out.put("# ");
+        out.put(cmt);
+        out.newline();
+    }
     // Write a FASM bitvector; optionally inverting the values in the process
     void write_vector(const std::string &name, const std::vector<bool> &value, bool invert = false)
     {
         write_prefix();
-        out << name << " = " << int(value.size()) << "'b";
+        out.put(name);
+        out.put(" = ");
+        out.put_uint(value.size());
+        out.put("'b");
         for (auto bit : boost::adaptors::reverse(value))
-            out << ((bit ^ invert) ? '1' : '0');
-        out << std::endl;
+            out.put((bit ^ invert) ? '1' : '0');
+        out.newline();
     }
     // Write a FASM bitvector given an integer value
     void write_int_vector(const std::string &name, uint64_t value, int width, bool invert = false)
@@ -181,6 +202,27 @@ struct NexusFasmWriter
         }
         return escaped;
     }
+    // Interned names for the pip hot path: tile names keyed by (location,
+    // tile type) and escaped wire names keyed by IdString, since both repeat
+    // thousands of times across nets. std::map so references handed out stay
+    // valid as the caches grow
+    std::map<std::pair<int, int>, std::string> tile_name_cache;
+    std::map<IdString, std::string> escaped_name_cache;
+    const std::string &interned_tile_name(int loc, const PhysicalTileInfoPOD &tile)
+    {
+        auto key = std::make_pair(loc, int(tile.tiletype));
+        auto fnd = tile_name_cache.find(key);
+        if (fnd == tile_name_cache.end())
+            fnd = tile_name_cache.emplace(key, tile_name(loc, tile)).first;
+        return fnd->second;
+    }
+    const std::string &escaped_wire_name(IdString name)
+    {
+        auto fnd = escaped_name_cache.find(name);
+        if (fnd == escaped_name_cache.end())
+            fnd = escaped_name_cache.emplace(name, escape_name(name.str(ctx))).first;
+        return fnd->second;
+    }
     // Push a tile name onto the prefix stack
     void push_tile(int loc, IdString tile_type) { push(tile_name(loc, tile_by_type_and_loc(loc, tile_type))); }
     void push_tile(int loc) { push(tile_name(loc, tile_at_loc(loc))); }
@@ -209,12 +251,18 @@ struct NexusFasmWriter
         auto &pd = ctx->pip_data(pip);
         if ((pd.flags & PIP_FIXED_CONN) || (pd.flags & PIP_LUT_PERM))
             return;
-        std::string tile = tile_name(pip.tile, tile_by_type_and_loc(pip.tile, IdString(pd.tile_type)));
-        std::string source_wire = escape_name(ctx->pip_src_wire_name(pip).str(ctx));
-        if (source_wire == "LOCAL_VCC")
-            source_wire = "G__VCC";
-        std::string dest_wire = escape_name(ctx->pip_dst_wire_name(pip).str(ctx));
-        out << stringf("%s.PIP.%s.%s", tile.c_str(), dest_wire.c_str(), source_wire.c_str()) << std::endl;
+        const std::string &tile = interned_tile_name(pip.tile, tile_by_type_and_loc(pip.tile, IdString(pd.tile_type)));
+        static const std::string global_vcc = "G__VCC";
+        const std::string *source_wire = &escaped_wire_name(ctx->pip_src_wire_name(pip));
+        if (*source_wire == "LOCAL_VCC")
+            source_wire = &global_vcc;
+        const std::string &dest_wire = escaped_wire_name(ctx->pip_dst_wire_name(pip));
+        out.put(tile);
+        out.put(".PIP.");
+        out.put(dest_wire);
+        out.put('.');
+        out.put(*source_wire);
+        out.newline();
     }
     // Write out all the pips corresponding to a net
     void write_net(const NetInfo *net)
@@ -22,6 +22,7 @@
 #include "nextpnr.h"
 #include "util.h"
 
+#include <array>
 #include <queue>
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -70,9 +71,28 @@ struct NexusGlobalRouter
         return true;
     }
 
+    // Uphill pips of the global distribution network that pass the filters
+    // above, memoized per wire the first time the search visits it. The
+    // DCC->spine->row tap topology is fixed by the chipdb, so the
+    // string-based filters need only run once per wire for the whole flow
+    // rather than once per visit per net ([0] strict, [1] relaxed sinks)
+    std::array<dict<WireId, std::vector<PipId>>, 2> global_uphill_cache;
+
+    const std::vector<PipId> &global_uphill_pips(WireId wire, bool relaxed)
+    {
+        auto &cache = global_uphill_cache[relaxed ? 1 : 0];
+        auto fnd = cache.find(wire);
+        if (fnd != cache.end())
+            return fnd->second;
+        std::vector<PipId> &pips = cache[wire];
+        for (PipId pip : ctx->getPipsUphill(wire))
+            if ((relaxed || global_pip_filter(pip)) && routeability_pip_filter(pip))
+                pips.push_back(pip);
+        return pips;
+    }
+
     // Dedicated backwards BFS routing for global networks
-    template <typename Tfilt>
-    bool backwards_bfs_route(NetInfo *net, size_t user_idx, int iter_limit, bool strict, Tfilt pip_filter)
+    bool backwards_bfs_route(NetInfo *net, size_t user_idx, int iter_limit, bool strict, bool relaxed)
     {
         // Queue of wires to visit
         std::queue<WireId> visit;
@@ -103,12 +123,13 @@ struct NexusGlobalRouter
         backtrace[dst] = PipId();
 
         int iter = 0;
+        WireId found;
 
         while (!visit.empty() && (iter++ < iter_limit)) {
             WireId cursor = visit.front();
             visit.pop();
-            // Search uphill pips
-            for (PipId pip : ctx->getPipsUphill(cursor)) {
+            // Search uphill pips (pre-filtered per wire, see above)
+            for (PipId pip : global_uphill_pips(cursor, relaxed)) {
                 // Skip pip if unavailable, and not because it's already used for this net
                 if (!ctx->checkPipAvail(pip) && ctx->getBoundPipNet(pip) != net)
                     continue;
@@ -119,15 +140,16 @@ struct NexusGlobalRouter
                 // Skip already visited wires
                 if (backtrace.count(prev))
                     continue;
-                // Apply our custom pip filter
-                if (!pip_filter(pip))
-                    continue;
                 // Add to the queue
                 visit.push(prev);
                 backtrace[prev] = pip;
-                // Check if we are done yet
-                if (prev == src)
+                // Check if we are done yet: the source, or any wire this
+                // net's earlier sinks already bound - the rest of the path
+                // to the source exists and needn't be re-searched
+                if (prev == src || ctx->getBoundWireNet(prev) == net) {
+                    found = prev;
                     goto done;
+                }
             }
             if (false) {
             done:
@@ -135,8 +157,8 @@ struct NexusGlobalRouter
             }
         }
 
-        if (backtrace.count(src)) {
-            WireId cursor = src;
+        if (found != WireId()) {
+            WireId cursor = found;
             std::vector<PipId> pips;
             // Create a list of pips on the routed path
             while (true) {
@@ -179,9 +201,7 @@ struct NexusGlobalRouter
     void route_clk_net(NetInfo *net)
     {
         for (size_t i = 0; i < net->users.size(); i++)
-            backwards_bfs_route(net, i, 1000000, true, [&](PipId pip) {
-                return (is_relaxed_sink(net->users.at(i)) || global_pip_filter(pip)) && routeability_pip_filter(pip);
-            });
+            backwards_bfs_route(net, i, 1000000, true, is_relaxed_sink(net->users.at(i)));
         log_info("    routed net '%s' using global resources\n", ctx->nameOf(net));
     }
 
@@ -350,18 +350,13 @@ struct NexusPacker
             return PINMUX_SIG;
     }
 
-    void uninvert_port(CellInfo *cell, IdString port)
+    void uninvert_port(CellInfo *cell, IdString port, PortRewireBatch &batch)
     {
         // Rewire a port so it is driven by the input to an inverter
         NetInfo *net = get_net_or_empty(cell, port);
         NPNR_ASSERT(net != nullptr && net->driver.cell != nullptr && net->driver.cell->type == id_INV);
         CellInfo *inv = net->driver.cell;
-        disconnect_port(ctx, cell, port);
-
-        NetInfo *inv_a = get_net_or_empty(inv, id_A);
-        if (inv_a != nullptr) {
-            connect_port(ctx, inv_a, cell, port);
-        }
+        batch.reconnect(cell, port, get_net_or_empty(inv, id_A));
     }
 
     void trim_design()
@@ -421,7 +416,7 @@ struct NexusPacker
 
     NetInfo *gnd_net = nullptr, *vcc_net = nullptr, *dedi_vcc_net = nullptr;
 
-    void process_inv_constants(CellInfo *cell)
+    void process_inv_constants(CellInfo *cell, PortRewireBatch &batch)
     {
         // Automatically create any extra inputs needed; so we can set them accordingly
         autocreate_ports(cell);
@@ -443,7 +438,7 @@ struct NexusPacker
             if (req_mux == PINMUX_INV) {
                 // Pin is inverted. If there is a hard inverter; then use it
                 if (pin_style & PINOPT_INV) {
-                    uninvert_port(cell, port_name);
+                    uninvert_port(cell, port_name, batch);
                     ctx->set_cell_pinmux(cell, port_name, PINMUX_INV);
                 }
             } else if (req_mux == PINMUX_0 || req_mux == PINMUX_1) {
@@ -453,12 +448,11 @@ struct NexusPacker
 
                     if ((cell->type == id_OXIDE_COMB) && (req_mux == PINMUX_1)) {
                         // We need to add a connection to the dedicated Vcc resource that can feed these cell ports
-                        disconnect_port(ctx, cell, port_name);
-                        connect_port(ctx, dedi_vcc_net, cell, port_name);
+                        batch.reconnect(cell, port_name, dedi_vcc_net);
                         continue;
                     }
 
-                    disconnect_port(ctx, cell, port_name);
+                    batch.disconnect(cell, port_name);
                     ctx->set_cell_pinmux(cell, port_name, req_mux);
                 } else if (port.second.net == nullptr) {
                     // If the port is disconnected; and there is no hard constant
@@ -658,14 +652,18 @@ struct NexusPacker
         vcc_net = get_const_net(id_VHI);
         gnd_net = get_const_net(id_VLO);
         dedi_vcc_net = get_const_net(id_VCC_DRV);
+        // Batch up the port rewires; tying pins off one at a time scans the
+        // high-fanout constant nets' user lists once per pin
+        PortRewireBatch batch(ctx);
         // Iterate through cells
         for (auto &cell : ctx->cells) {
             CellInfo *ci = cell.second.get();
             // Skip certain cells at this point
             if (ci->type != id_LUT4 && ci->type != id_INV && ci->type != id_VHI && ci->type != id_VLO &&
                 ci->type != id_VCC_DRV)
-                process_inv_constants(ci);
+                process_inv_constants(ci, batch);
         }
+        batch.commit();
         // Remove superfluous inverters and constant drivers
         trim_design();
     }
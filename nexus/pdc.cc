@@ -21,6 +21,7 @@
 #include "log.h"
 #include "nextpnr.h"
 
+#include <algorithm>
 #include <iterator>
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -94,6 +95,65 @@ struct TCLValue
     std::vector<TCLEntity> list; // list of entities
 };
 
+// Compiled index over one class of design objects (ports, cells or nets),
+// built lazily the first time a wildcard pattern needs resolving. Exact
+// names keep using the design's hash maps; patterns binary-search the
+// sorted name list on their literal prefix, so only candidates sharing the
+// prefix are glob-matched rather than every object in the design. This
+// keeps SDC-style files with thousands of get_ports/get_cells patterns
+// linear in the number of matches instead of quadratic in design size
+struct PDCObjectIndex
+{
+    bool built = false;
+    // (name, object) pairs sorted by name; for nets, aliases map to the
+    // canonical net
+    std::vector<std::pair<std::string, IdString>> names;
+
+    void add(const std::string &name, IdString id) { names.emplace_back(name, id); }
+    void finalise()
+    {
+        std::sort(names.begin(), names.end());
+        built = true;
+    }
+
+    // Glob match supporting '*' (any run) and '?' (any one character)
+    static bool glob_match(const std::string &pattern, const std::string &str)
+    {
+        size_t p = 0, s = 0, star_p = std::string::npos, star_s = 0;
+        while (s < str.size()) {
+            if (p < pattern.size() && (pattern.at(p) == '?' || pattern.at(p) == str.at(s))) {
+                p++, s++;
+            } else if (p < pattern.size() && pattern.at(p) == '*') {
+                star_p = p++;
+                star_s = s;
+            } else if (star_p != std::string::npos) {
+                p = star_p + 1;
+                s = ++star_s;
+            } else {
+                return false;
+            }
+        }
+        while (p < pattern.size() && pattern.at(p) == '*')
+            p++;
+        return p == pattern.size();
+    }
+
+    std::vector<IdString> match(const std::string &pattern) const
+    {
+        NPNR_ASSERT(built);
+        std::vector<IdString> result;
+        std::string prefix = pattern.substr(0, pattern.find_first_of("*?"));
+        auto it = std::lower_bound(names.begin(), names.end(), std::make_pair(prefix, IdString()));
+        for (; it != names.end(); ++it) {
+            if (it->first.compare(0, prefix.size(), prefix) != 0)
+                break;
+            if (glob_match(pattern, it->first))
+                result.push_back(it->second);
+        }
+        return result;
+    }
+};
+
 struct PDCParser
 {
     std::string buf;
@@ -101,8 +161,45 @@ struct PDCParser
     int lineno = 1;
     Context *ctx;
 
+    PDCObjectIndex ports_index, cells_index, nets_index;
+
     PDCParser(const std::string &buf, Context *ctx) : buf(buf), ctx(ctx){};
 
+    static bool is_pattern(const std::string &s) { return s.find_first_of("*?") != std::string::npos; }
+
+    PDCObjectIndex &get_ports_index()
+    {
+        if (!ports_index.built) {
+            for (auto &port : ctx->ports)
+                ports_index.add(port.first.str(ctx), port.first);
+            ports_index.finalise();
+        }
+        return ports_index;
+    }
+
+    PDCObjectIndex &get_cells_index()
+    {
+        if (!cells_index.built) {
+            for (auto &cell : ctx->cells)
+                cells_index.add(cell.first.str(ctx), cell.first);
+            cells_index.finalise();
+        }
+        return cells_index;
+    }
+
+    PDCObjectIndex &get_nets_index()
+    {
+        if (!nets_index.built) {
+            for (auto &net : ctx->nets)
+                nets_index.add(net.first.str(ctx), net.first);
+            for (auto &alias : ctx->net_aliases)
+                if (!ctx->nets.count(alias.first))
+                    nets_index.add(alias.first.str(ctx), alias.second);
+            nets_index.finalise();
+        }
+        return nets_index;
+    }
+
     inline bool eof() const { return pos == int(buf.size()); }
 
     inline char peek() const { return buf.at(pos); }
@@ -268,6 +365,14 @@ struct PDCParser
             std::string s = arg.str;
             if (s.at(0) == '-')
                 log_error("unsupported argument '%s' to get_nets (line %d)\n", s.c_str(), lineno);
+            if (is_pattern(s)) {
+                auto matches = get_nets_index().match(s);
+                if (matches.empty())
+                    log_warning("get_nets argument '%s' matched no objects.\n", s.c_str());
+                for (auto m : matches)
+                    nets.emplace_back(TCLEntity::ENTITY_NET, m);
+                continue;
+            }
             IdString id = ctx->id(s);
             if (ctx->nets.count(id) || ctx->net_aliases.count(id))
                 nets.emplace_back(TCLEntity::ENTITY_NET, ctx->net_aliases.count(id) ? ctx->net_aliases.at(id) : id);
@@ -287,6 +392,14 @@ struct PDCParser
             std::string s = arg.str;
             if (s.at(0) == '-')
                 log_error("unsupported argument '%s' to get_ports (line %d)\n", s.c_str(), lineno);
+            if (is_pattern(s)) {
+                auto matches = get_ports_index().match(s);
+                if (matches.empty())
+                    log_warning("get_ports argument '%s' matched no objects.\n", s.c_str());
+                for (auto m : matches)
+                    ports.emplace_back(TCLEntity::ENTITY_PORT, m);
+                continue;
+            }
             IdString id = ctx->id(s);
             if (ctx->ports.count(id))
                 ports.emplace_back(TCLEntity::ENTITY_PORT, id);
@@ -304,6 +417,14 @@ struct PDCParser
             std::string s = arg.str;
             if (s.at(0) == '-')
                 log_error("unsupported argument '%s' to get_cells (line %d)\n", s.c_str(), lineno);
+            if (is_pattern(s)) {
+                auto matches = get_cells_index().match(s);
+                if (matches.empty())
+                    log_warning("get_cells argument '%s' matched no objects.\n", s.c_str());
+                for (auto m : matches)
+                    cells.emplace_back(TCLEntity::ENTITY_CELL, m);
+                continue;
+            }
             IdString id = ctx->id(s);
             if (ctx->cells.count(id))
                 cells.emplace_back(TCLEntity::ENTITY_CELL, id);